@@ -0,0 +1,28 @@
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include <stdint.h>
+#include "compiler_abstraction.h"
+#include "nrf.h"
+#include "nrf_assert.h"
+#include "app_error.h"
+
+// Interrupts are played by signals in nrf_balloc_stress. A critical region blocks the signals,
+// like masking interrupts, and the priority of the running context is tracked by the handlers.
+#define _PRIO_APP_HIGH      2
+#define _PRIO_APP_LOW       6
+#define _PRIO_APP_LOWEST    7
+#define _PRIO_THREAD        15
+
+#define APP_IRQ_PRIORITY_HIGH   _PRIO_APP_HIGH
+#define APP_IRQ_PRIORITY_LOW    _PRIO_APP_LOW
+#define APP_IRQ_PRIORITY_THREAD _PRIO_THREAD
+
+void app_util_critical_region_enter(uint8_t * p_nested);
+void app_util_critical_region_exit(uint8_t nested);
+uint8_t current_int_priority_get(void);
+
+#define CRITICAL_REGION_ENTER()     app_util_critical_region_enter(NULL)
+#define CRITICAL_REGION_EXIT()      app_util_critical_region_exit(0)
+
+#endif // APP_UTIL_PLATFORM_H__
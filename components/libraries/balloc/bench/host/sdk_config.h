@@ -0,0 +1,27 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of the block allocator used by nrf_balloc_stress. The cache and
+// the debug checks can be set from the command line.
+
+#define NRF_BALLOC_ENABLED 1
+#define NRF_BALLOC_CLI_CMDS 0
+
+#ifndef NRF_BALLOC_CONFIG_DEBUG_ENABLED
+#define NRF_BALLOC_CONFIG_DEBUG_ENABLED 0
+#endif
+
+#define NRF_BALLOC_CONFIG_HEAD_GUARD_WORDS 1
+#define NRF_BALLOC_CONFIG_TAIL_GUARD_WORDS 1
+#define NRF_BALLOC_CONFIG_BASIC_CHECKS_ENABLED 1
+#define NRF_BALLOC_CONFIG_DOUBLE_FREE_CHECK_ENABLED 1
+#define NRF_BALLOC_CONFIG_DATA_TRASHING_CHECK_ENABLED 1
+#define NRF_BALLOC_CONFIG_LOG_ENABLED 0
+#define NRF_BALLOC_CONFIG_LOG_LEVEL 3
+#define NRF_BALLOC_CONFIG_INITIAL_LOG_LEVEL 3
+#define NRF_BALLOC_CONFIG_INFO_COLOR 0
+#define NRF_BALLOC_CONFIG_DEBUG_COLOR 0
+
+#define NRF_LOG_ENABLED 0
+
+#endif // SDK_CONFIG_H
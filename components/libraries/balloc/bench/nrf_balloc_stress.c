@@ -0,0 +1,546 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Stress test and benchmark of the block allocator with interrupts of two priorities.
+ *
+ * Build it on host from this directory, with or without the caches and the debug checks:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I$L/util -I$L/log -I$L/log/src -I$L/strerror \
+ *      [-DNRF_BALLOC_CONFIG_CACHE_SIZE=4] [-DNRF_BALLOC_CONFIG_DEBUG_ENABLED=1] \
+ *      nrf_balloc_stress.c ../nrf_balloc.c $L/bench_host/bench.c -o nrf_balloc_stress
+ *
+ * Usage: nrf_balloc_stress [thread operations] [interrupt period in us]
+ *
+ * First, the thread allocates and frees blocks alone, one by one and with nrf_balloc_alloc_n and
+ * nrf_balloc_free_n, and the number of critical regions and the time per block are printed.
+ *
+ * Then the thread, a low priority interrupt and a high priority interrupt that can preempt it
+ * allocate and free blocks with all functions at the same time. The interrupts are played by two
+ * timer signals. The low priority interrupt also hands blocks over to the thread, which frees
+ * them, like the logger does with log entries. Each block is filled with a pattern of its owner
+ * and checked when freed, and a block must never be given to two owners.
+ *
+ * Last, blocks allocated at one priority level are freed at two others, and that level must still
+ * be able to allocate the whole pool. In the end, all blocks must be back in the pool or in the
+ * caches.
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "sdk_common.h"
+#include "nrf_balloc.h"
+#include "bench.h"
+
+
+#define POOL_SIZE           64
+#define ELEMENT_WORDS       8
+#define HELD_MAX            16
+#define BATCH_MAX           8
+#define MAILBOX_SIZE        16
+#define IRQ_OPERATIONS      4
+#define BENCH_ROUNDS        1000000
+#define PATTERN_STEP        0x9E3779B1
+
+typedef enum
+{
+    CONTEXT_THREAD,
+    CONTEXT_LOW,
+    CONTEXT_HIGH,
+    CONTEXT_COUNT
+} context_t;
+
+typedef struct
+{
+    uint32_t * p_held[HELD_MAX];
+    uint32_t   held;
+    uint32_t   tag;
+    uint32_t   random;
+    uint64_t   blocks;
+    uint64_t   shortages;
+} owner_t;
+
+NRF_BALLOC_DEF(m_pool, ELEMENT_WORDS * sizeof(uint32_t), POOL_SIZE);
+
+static volatile uint8_t  m_priority = APP_IRQ_PRIORITY_THREAD;
+static uint32_t          m_critical_nesting;
+static sigset_t          m_critical_saved_mask;
+static uint64_t          m_critical_regions;
+
+static owner_t           m_owners[CONTEXT_COUNT];
+static uint8_t           m_taken[POOL_SIZE];
+static uint32_t *        m_mailbox[MAILBOX_SIZE];
+static uint32_t          m_mailbox_count;
+static uint64_t          m_handed_over;
+
+
+void app_util_critical_region_enter(uint8_t * p_nested)
+{
+    sigset_t set;
+    sigset_t saved_mask;
+
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set, SIGALRM);
+    (void)sigaddset(&set, SIGPROF);
+    (void)sigprocmask(SIG_BLOCK, &set, &saved_mask);
+    if (m_critical_nesting++ == 0)
+    {
+        m_critical_saved_mask = saved_mask;
+        m_critical_regions++;
+    }
+}
+
+
+void app_util_critical_region_exit(uint8_t nested)
+{
+    if (--m_critical_nesting == 0)
+    {
+        (void)sigprocmask(SIG_SETMASK, &m_critical_saved_mask, NULL);
+    }
+}
+
+
+uint8_t current_int_priority_get(void)
+{
+    return m_priority;
+}
+
+
+static void error(char const * p_what)
+{
+    bench_error_record(p_what);
+}
+
+
+static uint32_t random_next(owner_t * p_owner)
+{
+    p_owner->random = p_owner->random * 1103515245 + 12345;
+    return p_owner->random >> 8;
+}
+
+
+static uint32_t block_idx(void const * p_element)
+{
+    return ((size_t)p_element - (size_t)m_pool.p_memory_begin) / m_pool.block_size;
+}
+
+
+// Marks a block as owned and fills it with a pattern of the owner.
+static void element_take(owner_t * p_owner, uint32_t * p_element)
+{
+    uint32_t const idx = block_idx(p_element);
+
+    if ((idx >= POOL_SIZE) || (((size_t)p_element % sizeof(uint32_t)) != 0))
+    {
+        error("invalid element");
+        return;
+    }
+    if (__atomic_exchange_n(&m_taken[idx], 1, __ATOMIC_SEQ_CST) != 0)
+    {
+        error("element given twice");
+    }
+
+    uint32_t const tag = p_owner->tag++;
+    for (uint32_t i = 0; i < ELEMENT_WORDS; i++)
+    {
+        p_element[i] = tag + i * PATTERN_STEP;
+    }
+    p_owner->p_held[p_owner->held++] = p_element;
+    p_owner->blocks++;
+}
+
+
+// Checks the pattern of a block and marks it as not owned, just before it is freed.
+static void element_release(uint32_t * p_element)
+{
+    for (uint32_t i = 1; i < ELEMENT_WORDS; i++)
+    {
+        if (p_element[i] != p_element[0] + i * PATTERN_STEP)
+        {
+            error("element corrupted");
+            break;
+        }
+    }
+    __atomic_store_n(&m_taken[block_idx(p_element)], 0, __ATOMIC_SEQ_CST);
+}
+
+
+// Takes the element at a random position out of the held elements.
+static uint32_t * element_pick(owner_t * p_owner)
+{
+    uint32_t const pos       = random_next(p_owner) % p_owner->held;
+    uint32_t *     p_element = p_owner->p_held[pos];
+
+    p_owner->p_held[pos] = p_owner->p_held[--(p_owner->held)];
+    return p_element;
+}
+
+
+// Allocates or frees blocks with one of the functions of the allocator.
+static void owner_step(owner_t * p_owner)
+{
+    uint32_t * p_elements[BATCH_MAX];
+    uint32_t   r     = random_next(p_owner);
+    uint32_t   count = 1 + ((r >> 2) % BATCH_MAX);
+
+    switch (r % 4)
+    {
+        case 0:
+            if (p_owner->held < HELD_MAX)
+            {
+                p_elements[0] = nrf_balloc_alloc(&m_pool);
+                if (p_elements[0] == NULL)
+                {
+                    p_owner->shortages++;
+                    break;
+                }
+                element_take(p_owner, p_elements[0]);
+            }
+            break;
+
+        case 1:
+            count = MIN(count, HELD_MAX - p_owner->held);
+            uint32_t allocated = nrf_balloc_alloc_n(&m_pool, (void **)p_elements, count);
+            if (allocated < count)
+            {
+                p_owner->shortages++;
+            }
+            for (uint32_t i = 0; i < allocated; i++)
+            {
+                element_take(p_owner, p_elements[i]);
+            }
+            break;
+
+        case 2:
+            if (p_owner->held > 0)
+            {
+                p_elements[0] = element_pick(p_owner);
+                element_release(p_elements[0]);
+                nrf_balloc_free(&m_pool, p_elements[0]);
+            }
+            break;
+
+        default:
+            count = MIN(count, p_owner->held);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                p_elements[i] = element_pick(p_owner);
+                element_release(p_elements[i]);
+            }
+            nrf_balloc_free_n(&m_pool, (void * const *)p_elements, count);
+            break;
+    }
+}
+
+
+static void irq_low_handler(int signal)
+{
+    uint8_t const priority = m_priority;
+    owner_t *     p_owner  = &m_owners[CONTEXT_LOW];
+
+    m_priority = APP_IRQ_PRIORITY_LOW;
+    for (uint32_t i = 0; i < IRQ_OPERATIONS; i++)
+    {
+        owner_step(p_owner);
+    }
+
+    // Hand a block over to the thread, which will free it.
+    if (p_owner->held > 0)
+    {
+        CRITICAL_REGION_ENTER();
+        if (m_mailbox_count < MAILBOX_SIZE)
+        {
+            m_mailbox[m_mailbox_count++] = element_pick(p_owner);
+            m_handed_over++;
+        }
+        CRITICAL_REGION_EXIT();
+    }
+    m_priority = priority;
+}
+
+
+static void irq_high_handler(int signal)
+{
+    uint8_t const priority = m_priority;
+
+    m_priority = APP_IRQ_PRIORITY_HIGH;
+    for (uint32_t i = 0; i < IRQ_OPERATIONS; i++)
+    {
+        owner_step(&m_owners[CONTEXT_HIGH]);
+    }
+    m_priority = priority;
+}
+
+
+// Frees the blocks handed over by the low priority interrupt.
+static void mailbox_empty(void)
+{
+    uint32_t * p_elements[MAILBOX_SIZE];
+    uint32_t   count;
+
+    CRITICAL_REGION_ENTER();
+    count = m_mailbox_count;
+    memcpy(p_elements, m_mailbox, count * sizeof(p_elements[0]));
+    m_mailbox_count = 0;
+    CRITICAL_REGION_EXIT();
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        element_release(p_elements[i]);
+        nrf_balloc_free(&m_pool, p_elements[i]);
+    }
+}
+
+
+// Frees the whole pool at other priority levels than the one that allocated it, which must then
+// be able to allocate the whole pool again, from the caches of the other levels.
+static void reclaim_check(void)
+{
+    uint32_t * p_elements[POOL_SIZE];
+    uint32_t   count;
+
+    for (uint32_t round = 0; round < 2; round++)
+    {
+        m_priority = APP_IRQ_PRIORITY_HIGH;
+        for (count = 0; count < POOL_SIZE; count++)
+        {
+            p_elements[count] = nrf_balloc_alloc(&m_pool);
+            if (p_elements[count] == NULL)
+            {
+                error("free blocks left in the caches of other levels");
+                break;
+            }
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            m_priority = (i % 2) ? APP_IRQ_PRIORITY_LOW : APP_IRQ_PRIORITY_THREAD;
+            nrf_balloc_free(&m_pool, p_elements[i]);
+        }
+    }
+    m_priority = APP_IRQ_PRIORITY_THREAD;
+
+    printf("reclaim: %u/%u blocks allocated at one level\n", count, POOL_SIZE);
+}
+
+
+static void timers_set(uint32_t period_us)
+{
+    struct itimerval timer =
+    {
+        .it_interval = {.tv_usec = period_us},
+        .it_value    = {.tv_usec = period_us},
+    };
+    (void)setitimer(ITIMER_REAL, &timer, NULL);
+
+    // The high priority interrupt comes at another, unrelated rate.
+    timer.it_interval.tv_usec = (period_us * 7) / 5;
+    timer.it_value.tv_usec    = (period_us * 7) / 5;
+    (void)setitimer(ITIMER_PROF, &timer, NULL);
+}
+
+
+static void bench_print(char const * p_name, uint64_t start, uint64_t blocks)
+{
+    uint64_t const elapsed = bench_now_ns() - start;
+
+    printf("%-28s %6.3f critical regions/block %8.1f ns/block\n",
+           p_name, (double)m_critical_regions / blocks, (double)elapsed / blocks);
+}
+
+
+// Allocates and frees blocks in the thread alone.
+static void bench(void)
+{
+    void *   p_elements[BATCH_MAX];
+    uint64_t start;
+
+    m_critical_regions = 0;
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+    {
+        p_elements[0] = nrf_balloc_alloc(&m_pool);
+        nrf_balloc_free(&m_pool, p_elements[0]);
+    }
+    bench_print("alloc/free", start, BENCH_ROUNDS);
+
+    m_critical_regions = 0;
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_ROUNDS / BATCH_MAX; i++)
+    {
+        for (uint32_t j = 0; j < BATCH_MAX; j++)
+        {
+            p_elements[j] = nrf_balloc_alloc(&m_pool);
+        }
+        for (uint32_t j = 0; j < BATCH_MAX; j++)
+        {
+            nrf_balloc_free(&m_pool, p_elements[j]);
+        }
+    }
+    bench_print("alloc/free, " STRINGIFY(BATCH_MAX) " blocks", start, BENCH_ROUNDS);
+
+    m_critical_regions = 0;
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_ROUNDS / BATCH_MAX; i++)
+    {
+        if (nrf_balloc_alloc_n(&m_pool, p_elements, BATCH_MAX) != BATCH_MAX)
+        {
+            error("pool ran out in the benchmark");
+        }
+        nrf_balloc_free_n(&m_pool, p_elements, BATCH_MAX);
+    }
+    bench_print("alloc_n/free_n, " STRINGIFY(BATCH_MAX) " blocks", start, BENCH_ROUNDS);
+}
+
+
+// Checks that every block is either in the pool or in one of the caches, exactly once.
+static bool pool_check(void)
+{
+    uint8_t  found[POOL_SIZE] = {0};
+    uint32_t cached           = 0;
+
+    for (uint8_t * p_idx = m_pool.p_stack_base; p_idx < m_pool.p_cb->p_stack_pointer; p_idx++)
+    {
+        found[*p_idx]++;
+    }
+#if NRF_BALLOC_CONFIG_CACHE_SIZE
+    for (uint32_t level = 0; level < NRF_BALLOC_CACHE_LEVELS; level++)
+    {
+        for (uint32_t i = 0; i < m_pool.p_cache[level].count; i++)
+        {
+            found[m_pool.p_cache[level].idx[i]]++;
+        }
+        cached += m_pool.p_cache[level].count;
+    }
+#endif
+    for (uint32_t i = 0; i < POOL_SIZE; i++)
+    {
+        if (found[i] != 1)
+        {
+            printf("FAILED: block %u is free %u times\n", i, found[i]);
+            return false;
+        }
+    }
+    if ((nrf_balloc_utilization_get(&m_pool) != cached) ||
+        (nrf_balloc_max_utilization_get(&m_pool) > POOL_SIZE))
+    {
+        printf("FAILED: invalid utilization %u, %u blocks in caches\n",
+               nrf_balloc_utilization_get(&m_pool), cached);
+        return false;
+    }
+    return true;
+}
+
+
+int main(int argc, char ** argv)
+{
+    struct sigaction action = {0};
+
+    uint64_t const operations    = (argc > 1) ? strtoull(argv[1], NULL, 0) : 5000000;
+    uint32_t const irq_period_us = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 20;
+
+    // The high priority interrupt preempts the low priority one, but not the other way round.
+    (void)sigemptyset(&action.sa_mask);
+    action.sa_handler = irq_low_handler;
+    (void)sigaction(SIGALRM, &action, NULL);
+    (void)sigaddset(&action.sa_mask, SIGALRM);
+    action.sa_handler = irq_high_handler;
+    (void)sigaction(SIGPROF, &action, NULL);
+
+    APP_ERROR_CHECK(nrf_balloc_init(&m_pool));
+    printf("cache size %u, debug checks %u\n",
+           NRF_BALLOC_CONFIG_CACHE_SIZE, NRF_BALLOC_CONFIG_DEBUG_ENABLED);
+
+    bench();
+
+    for (uint32_t i = 0; i < CONTEXT_COUNT; i++)
+    {
+        m_owners[i].random = 1 + i;
+        m_owners[i].tag    = i << 28;
+    }
+
+    timers_set(irq_period_us);
+    for (uint64_t i = 0; i < operations; i++)
+    {
+        owner_step(&m_owners[CONTEXT_THREAD]);
+        mailbox_empty();
+    }
+    timers_set(0);
+
+    // The blocks that are left are freed by the thread.
+    mailbox_empty();
+    for (uint32_t i = 0; i < CONTEXT_COUNT; i++)
+    {
+        while (m_owners[i].held > 0)
+        {
+            uint32_t * p_element = element_pick(&m_owners[i]);
+            element_release(p_element);
+            nrf_balloc_free(&m_pool, p_element);
+        }
+    }
+
+    uint64_t blocks = 0;
+    for (uint32_t i = 0; i < CONTEXT_COUNT; i++)
+    {
+        blocks += m_owners[i].blocks;
+    }
+    printf("stress: %llu blocks (thread %llu, low %llu, high %llu), %llu handed over, "
+           "max utilization %u/%u\n",
+           (unsigned long long)blocks,
+           (unsigned long long)m_owners[CONTEXT_THREAD].blocks,
+           (unsigned long long)m_owners[CONTEXT_LOW].blocks,
+           (unsigned long long)m_owners[CONTEXT_HIGH].blocks,
+           (unsigned long long)m_handed_over,
+           nrf_balloc_max_utilization_get(&m_pool), POOL_SIZE);
+
+    reclaim_check();
+
+    if (bench_failed())
+    {
+        return 1;
+    }
+    if (!pool_check())
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -284,55 +284,35 @@ ret_code_t nrf_balloc_init(nrf_balloc_t const * p_pool)
 
     p_pool->p_cb->max_utilization = 0;
 
+#if NRF_BALLOC_CONFIG_CACHE_SIZE
+    memset(p_pool->p_cache, 0, NRF_BALLOC_CACHE_LEVELS * sizeof(nrf_balloc_cache_t));
+#endif
+
     return NRF_SUCCESS;
 }
 
-void * nrf_balloc_alloc(nrf_balloc_t const * p_pool)
+/**@brief  Update the maximum utilization statistics. Must be called in a critical region.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ */
+static void nrf_balloc_max_utilization_update(nrf_balloc_t const * p_pool)
 {
-    ASSERT(p_pool != NULL);
-
-    void * p_block = NULL;
-
-    CRITICAL_REGION_ENTER();
-
-    if (p_pool->p_cb->p_stack_pointer > p_pool->p_stack_base)
+    uint8_t utilization = p_pool->p_stack_limit - p_pool->p_cb->p_stack_pointer;
+    if (p_pool->p_cb->max_utilization < utilization)
     {
-        // Allocate block.
-        p_block = nrf_balloc_idx2block(p_pool, *--(p_pool->p_cb->p_stack_pointer));
-
-        // Update utilization statistics.
-        uint8_t utilization = p_pool->p_stack_limit - p_pool->p_cb->p_stack_pointer;
-        if (p_pool->p_cb->max_utilization < utilization)
-        {
-            p_pool->p_cb->max_utilization = utilization;
-        }
-    }
-
-    CRITICAL_REGION_EXIT();
-
-#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
-    if (p_block != NULL)
-    {
-        p_block = nrf_balloc_block_unwrap(p_pool, p_block);
+        p_pool->p_cb->max_utilization = utilization;
     }
-#endif
-
-    NRF_LOG_INST_DEBUG(p_pool->p_log, "Allocating element: 0x%08X", p_block);
-
-    return p_block;
 }
 
-void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element)
-{
-    ASSERT(p_pool != NULL);
-    ASSERT(p_element != NULL)
-
-    NRF_LOG_INST_DEBUG(p_pool->p_log, "Freeing element: 0x%08X", p_element);
-
 #if NRF_BALLOC_CONFIG_DEBUG_ENABLED
-    void * p_block = nrf_balloc_element_wrap(p_pool, p_element);
-
-    // These checks could be done outside critical region as they use only pool configuration data.
+/**@brief  Check if an element can be freed. Checks done here do not depend on the pool state.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_element   Element to be freed.
+ * @param[in]   p_block     Pointer to the beginning of the block.
+ */
+static void nrf_balloc_free_check(nrf_balloc_t const * p_pool, void * p_element, void * p_block)
+{
     if (NRF_BALLOC_DEBUG_BASIC_CHECKS_GET(p_pool->debug_flags))
     {
         uint8_t pool_size  = p_pool->p_stack_limit - p_pool->p_stack_base;
@@ -355,18 +335,46 @@ void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element)
             APP_ERROR_CHECK_BOOL(false);
         }
     }
-#else
-    void * p_block = p_element;
-#endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
+}
 
-    CRITICAL_REGION_ENTER();
+/**@brief  Check if an element can be returned to the pool. Must be called in a critical region.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_element   Element to be freed.
+ * @param[in]   p_block     Pointer to the beginning of the block.
+ */
+static void nrf_balloc_free_state_check(nrf_balloc_t const * p_pool,
+                                        void               * p_element,
+                                        void               * p_block)
+{
+    uint8_t free_count = p_pool->p_cb->p_stack_pointer - p_pool->p_stack_base;
+
+#if NRF_BALLOC_CONFIG_CACHE_SIZE
+    for (uint8_t level = 0; level < NRF_BALLOC_CACHE_LEVELS; level++)
+    {
+        nrf_balloc_cache_t const * p_cache = &p_pool->p_cache[level];
+
+        free_count += p_cache->count;
+
+        if (NRF_BALLOC_DEBUG_DOUBLE_FREE_CHECK_GET(p_pool->debug_flags))
+        {
+            for (uint8_t i = 0; i < p_cache->count; i++)
+            {
+                if (nrf_balloc_idx2block(p_pool, p_cache->idx[i]) == p_block)
+                {
+                    NRF_LOG_INST_ERROR(p_pool->p_log,
+                                       "Attempted to double-free an element (0x%08X).", p_element);
+                    APP_ERROR_CHECK_BOOL(false);
+                }
+            }
+        }
+    }
+#endif // NRF_BALLOC_CONFIG_CACHE_SIZE
 
-#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
-    // These checks have to be done in critical region as they use p_pool->p_stack_pointer.
     if (NRF_BALLOC_DEBUG_BASIC_CHECKS_GET(p_pool->debug_flags))
     {
         // Check for allocated/free ballance.
-        if (p_pool->p_cb->p_stack_pointer >= p_pool->p_stack_limit)
+        if (free_count >= (p_pool->p_stack_limit - p_pool->p_stack_base))
         {
             NRF_LOG_INST_ERROR(p_pool->p_log,
                                "Attempted to free an element (0x%08X) while the pool is full.",
@@ -388,10 +396,283 @@ void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element)
             }
         }
     }
+}
+#endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
+
+/**@brief  Calculate pointer to the block of an element being freed, and validate it.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_element   Element to be freed.
+ *
+ * @return      Pointer to the beginning of the block.
+ */
+static void * nrf_balloc_free_prepare(nrf_balloc_t const * p_pool, void * p_element)
+{
+    ASSERT(p_element != NULL)
+
+    NRF_LOG_INST_DEBUG(p_pool->p_log, "Freeing element: 0x%08X", p_element);
+
+#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
+    void * p_block = nrf_balloc_element_wrap(p_pool, p_element);
+
+    // These checks could be done outside critical region as they use only pool configuration data.
+    nrf_balloc_free_check(p_pool, p_element, p_block);
+
+    return p_block;
+#else
+    UNUSED_PARAMETER(p_pool);
+    return p_element;
+#endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
+}
+
+#if NRF_BALLOC_CONFIG_CACHE_SIZE
+/**@brief  Get the cache of the current interrupt priority level.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ *
+ * @return      Pointer to the cache or NULL if the current priority level has no cache.
+ */
+static nrf_balloc_cache_t * nrf_balloc_cache_get(nrf_balloc_t const * p_pool)
+{
+    uint8_t level = current_int_priority_get();
+
+    if (level == APP_IRQ_PRIORITY_THREAD)
+    {
+        level = NRF_BALLOC_CACHE_LEVELS - 1;
+    }
+    else if (level >= NRF_BALLOC_CACHE_LEVELS - 1)
+    {
+        // Fault handlers and priorities not used by the application.
+        return NULL;
+    }
+
+    return &p_pool->p_cache[level];
+}
+
+/**@brief  Return the blocks kept by the caches of the other priority levels to the pool. Must be
+ *         called in a critical region.
+ *
+ * A level that was preempted while it used its cache has marked it busy, its blocks are left
+ * there. The other levels cannot be running, so their caches are not in use.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_cache     Pointer to the cache of the caller.
+ */
+static void nrf_balloc_caches_reclaim(nrf_balloc_t const * p_pool, nrf_balloc_cache_t const * p_cache)
+{
+    for (uint8_t level = 0; level < NRF_BALLOC_CACHE_LEVELS; level++)
+    {
+        nrf_balloc_cache_t * p_other = &p_pool->p_cache[level];
+
+        if ((p_other == p_cache) || p_other->busy)
+        {
+            continue;
+        }
+
+        for (uint8_t i = 0; i < p_other->count; i++)
+        {
+            *(p_pool->p_cb->p_stack_pointer)++ = p_other->idx[i];
+        }
+        p_other->count = 0;
+    }
+}
+
+/**@brief  Refill an empty cache from the pool, or from the caches of the other priority levels
+ *         if the pool is empty.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_cache     Pointer to the cache.
+ */
+static void nrf_balloc_cache_refill(nrf_balloc_t const * p_pool, nrf_balloc_cache_t * p_cache)
+{
+    uint8_t count = 0;
+
+    CRITICAL_REGION_ENTER();
+
+    if (p_pool->p_cb->p_stack_pointer == p_pool->p_stack_base)
+    {
+        nrf_balloc_caches_reclaim(p_pool, p_cache);
+    }
+
+    while ((count < NRF_BALLOC_CONFIG_CACHE_BATCH) &&
+           (p_pool->p_cb->p_stack_pointer > p_pool->p_stack_base))
+    {
+        p_cache->idx[count++] = *--(p_pool->p_cb->p_stack_pointer);
+    }
+
+    nrf_balloc_max_utilization_update(p_pool);
+
+    CRITICAL_REGION_EXIT();
+
+    p_cache->count = count;
+}
+
+/**@brief  Return the oldest blocks of a full cache to the pool.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_cache     Pointer to the cache.
+ */
+static void nrf_balloc_cache_drain(nrf_balloc_t const * p_pool, nrf_balloc_cache_t * p_cache)
+{
+    CRITICAL_REGION_ENTER();
+
+    for (uint8_t i = 0; i < NRF_BALLOC_CONFIG_CACHE_BATCH; i++)
+    {
+        *(p_pool->p_cb->p_stack_pointer)++ = p_cache->idx[i];
+    }
+
+    // The cache is updated in the critical region, so that a block is never seen both in the pool
+    // and in the cache by the debug checks of a preempting context.
+    p_cache->count -= NRF_BALLOC_CONFIG_CACHE_BATCH;
+    memmove(&p_cache->idx[0], &p_cache->idx[NRF_BALLOC_CONFIG_CACHE_BATCH], p_cache->count);
+
+    CRITICAL_REGION_EXIT();
+}
+#endif // NRF_BALLOC_CONFIG_CACHE_SIZE
+
+void * nrf_balloc_alloc(nrf_balloc_t const * p_pool)
+{
+    ASSERT(p_pool != NULL);
+
+    void * p_block = NULL;
+
+#if NRF_BALLOC_CONFIG_CACHE_SIZE
+    nrf_balloc_cache_t * p_cache = nrf_balloc_cache_get(p_pool);
+
+    if (p_cache == NULL)
+    {
+        (void)nrf_balloc_alloc_n(p_pool, &p_block, 1);
+        return p_block;
+    }
+
+    // A preempting context does not take back the blocks of the cache while it is busy.
+    p_cache->busy = true;
+    __DMB();
+
+    if (p_cache->count == 0)
+    {
+        nrf_balloc_cache_refill(p_pool, p_cache);
+    }
+
+    if (p_cache->count > 0)
+    {
+        p_block = nrf_balloc_idx2block(p_pool, p_cache->idx[--(p_cache->count)]);
+#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
+        p_block = nrf_balloc_block_unwrap(p_pool, p_block);
+#endif
+    }
+
+    __DMB();
+    p_cache->busy = false;
+
+    NRF_LOG_INST_DEBUG(p_pool->p_log, "Allocating element: 0x%08X", p_block);
+#else
+    (void)nrf_balloc_alloc_n(p_pool, &p_block, 1);
+#endif // NRF_BALLOC_CONFIG_CACHE_SIZE
+
+    return p_block;
+}
+
+void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element)
+{
+    ASSERT(p_pool != NULL);
+
+#if NRF_BALLOC_CONFIG_CACHE_SIZE
+    nrf_balloc_cache_t * p_cache = nrf_balloc_cache_get(p_pool);
+
+    if (p_cache != NULL)
+    {
+        void * p_block = nrf_balloc_free_prepare(p_pool, p_element);
+
+        p_cache->busy = true;
+        __DMB();
+
+        if (p_cache->count == NRF_BALLOC_CONFIG_CACHE_SIZE)
+        {
+            nrf_balloc_cache_drain(p_pool, p_cache);
+        }
+
+#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
+        // These checks have to be done in critical region as they use the pool and the caches.
+        CRITICAL_REGION_ENTER();
+        nrf_balloc_free_state_check(p_pool, p_element, p_block);
+#endif
+
+        p_cache->idx[p_cache->count] = nrf_balloc_block2idx(p_pool, p_block);
+        p_cache->count++;
+
+#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
+        CRITICAL_REGION_EXIT();
+#endif
+
+        __DMB();
+        p_cache->busy = false;
+        return;
+    }
+#endif // NRF_BALLOC_CONFIG_CACHE_SIZE
+
+    nrf_balloc_free_n(p_pool, &p_element, 1);
+}
+
+uint8_t nrf_balloc_alloc_n(nrf_balloc_t const * p_pool, void ** pp_elements, uint8_t count)
+{
+    ASSERT(p_pool != NULL);
+    ASSERT((pp_elements != NULL) || (count == 0));
+
+    uint8_t allocated = 0;
+
+    CRITICAL_REGION_ENTER();
+
+    while ((allocated < count) && (p_pool->p_cb->p_stack_pointer > p_pool->p_stack_base))
+    {
+        // Allocate block.
+        pp_elements[allocated++] = nrf_balloc_idx2block(p_pool,
+                                                        *--(p_pool->p_cb->p_stack_pointer));
+    }
+
+    // Update utilization statistics.
+    nrf_balloc_max_utilization_update(p_pool);
+
+    CRITICAL_REGION_EXIT();
+
+    for (uint8_t i = 0; i < allocated; i++)
+    {
+#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
+        pp_elements[i] = nrf_balloc_block_unwrap(p_pool, pp_elements[i]);
+#endif
+        NRF_LOG_INST_DEBUG(p_pool->p_log, "Allocating element: 0x%08X", pp_elements[i]);
+    }
+
+    return allocated;
+}
+
+void nrf_balloc_free_n(nrf_balloc_t const * p_pool, void * const * pp_elements, uint8_t count)
+{
+    ASSERT(p_pool != NULL);
+    ASSERT((pp_elements != NULL) || (count == 0));
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        (void)nrf_balloc_free_prepare(p_pool, pp_elements[i]);
+    }
+
+    CRITICAL_REGION_ENTER();
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
+        uint32_t head_words = NRF_BALLOC_DEBUG_HEAD_GUARD_WORDS_GET(p_pool->debug_flags);
+        void   * p_block    = (uint32_t *)pp_elements[i] - head_words;
+
+        // These checks have to be done in critical region as they use p_pool->p_stack_pointer.
+        nrf_balloc_free_state_check(p_pool, pp_elements[i], p_block);
+#else
+        void   * p_block    = pp_elements[i];
 #endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
 
-    // Free the element.
-    *(p_pool->p_cb->p_stack_pointer)++ = nrf_balloc_block2idx(p_pool, p_block);
+        // Free the element.
+        *(p_pool->p_cb->p_stack_pointer)++ = nrf_balloc_block2idx(p_pool, p_block);
+    }
 
     CRITICAL_REGION_EXIT();
 }
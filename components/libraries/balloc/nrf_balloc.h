@@ -100,6 +100,54 @@ extern "C" {
     #define NRF_BALLOC_DEFAULT_DEBUG_FLAGS   0
 #endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
 
+/**@brief Number of free blocks that each interrupt priority level can keep for itself.
+ *
+ * When non-zero, @ref nrf_balloc_alloc and @ref nrf_balloc_free first use a small cache that
+ * belongs to the interrupt priority of the caller (thread mode has its own cache). The cache is
+ * refilled from the pool and drained back to the pool in batches of
+ * @ref NRF_BALLOC_CONFIG_CACHE_BATCH blocks, so most allocations and releases do not enter a
+ * critical region.
+ *
+ * A block freed at another priority level than the one it was allocated at goes to the cache of
+ * the level that frees it, as when the logger allocates in an interrupt and frees in thread
+ * mode. When a cache and the pool are both empty, @ref nrf_balloc_alloc therefore takes back the
+ * blocks kept by the caches of the other levels, so that an allocation fails only when no free
+ * block is left. The cache of a level that is preempted while it uses it is not taken back.
+ * The caches of all levels together must hold fewer blocks than the pool.
+ *
+ * @note The caches rely on contexts of the same priority never preempting each other. Do not
+ *       enable them if the pools are used from several threads of a preemptive RTOS.
+ * @note Blocks kept in a cache are reported as used by @ref nrf_balloc_utilization_get.
+ */
+#ifndef NRF_BALLOC_CONFIG_CACHE_SIZE
+#define NRF_BALLOC_CONFIG_CACHE_SIZE 0
+#endif
+
+/**@brief Number of blocks moved between a cache and the pool at once. */
+#ifndef NRF_BALLOC_CONFIG_CACHE_BATCH
+#define NRF_BALLOC_CONFIG_CACHE_BATCH ((NRF_BALLOC_CONFIG_CACHE_SIZE + 1) / 2)
+#endif
+
+#if NRF_BALLOC_CONFIG_CACHE_SIZE
+#if (NRF_BALLOC_CONFIG_CACHE_BATCH < 1) || \
+    (NRF_BALLOC_CONFIG_CACHE_BATCH > NRF_BALLOC_CONFIG_CACHE_SIZE)
+#error "NRF_BALLOC_CONFIG_CACHE_BATCH must be between 1 and NRF_BALLOC_CONFIG_CACHE_SIZE."
+#endif
+
+/**@brief Number of caches in a pool: one for each application interrupt priority and one for
+ *        thread mode.
+ */
+#define NRF_BALLOC_CACHE_LEVELS (_PRIO_APP_LOWEST + 2)
+
+/**@brief Free blocks kept by one interrupt priority level. */
+typedef struct
+{
+    uint8_t       count;                              //!< Number of blocks in the cache.
+    uint8_t       idx[NRF_BALLOC_CONFIG_CACHE_SIZE];  //!< Indexes of the cached blocks.
+    volatile bool busy;                               //!< Set while the level uses the cache.
+} nrf_balloc_cache_t;
+#endif // NRF_BALLOC_CONFIG_CACHE_SIZE
+
 /**@brief Block memory allocator control block.*/
 typedef struct
 {
@@ -130,6 +178,9 @@ typedef struct
                                          * Debug flag should be created by @ref NRF_BALLOC_DEBUG.
                                          */
 #endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
+#if NRF_BALLOC_CONFIG_CACHE_SIZE
+    nrf_balloc_cache_t * p_cache;       //!< Caches of free blocks, one for each priority level.
+#endif
     uint16_t          block_size;       //!< Size of the allocated block (including debug overhead).
                                         /**<
                                          * Single block contains user element with header and tail
@@ -183,6 +234,15 @@ typedef struct
 #define __NRF_BALLOC_ASSIGN_POOL_NAME(_name)
 #endif
 
+#if NRF_BALLOC_CONFIG_CACHE_SIZE
+#define __NRF_BALLOC_CACHE_DEF(_name, _pool_size)                                           \
+    STATIC_ASSERT(NRF_BALLOC_CONFIG_CACHE_SIZE * NRF_BALLOC_CACHE_LEVELS < (_pool_size));   \
+    static nrf_balloc_cache_t CONCAT_2(_name,_nrf_balloc_cache)[NRF_BALLOC_CACHE_LEVELS];
+#define __NRF_BALLOC_ASSIGN_CACHE(_name)    .p_cache = CONCAT_2(_name,_nrf_balloc_cache),
+#else
+#define __NRF_BALLOC_CACHE_DEF(_name, _pool_size)
+#define __NRF_BALLOC_ASSIGN_CACHE(_name)
+#endif
 
 /**@brief Create a block allocator instance with custom debug flags.
  *
@@ -199,6 +259,7 @@ typedef struct
     static uint32_t             CONCAT_2(_name,_nrf_balloc_pool_mem)                            \
         [NRF_BALLOC_BLOCK_SIZE(_element_size, _debug_flags) * (_pool_size) / sizeof(uint32_t)]; \
     static nrf_balloc_cb_t      CONCAT_2(_name,_nrf_balloc_cb);                                 \
+    __NRF_BALLOC_CACHE_DEF(_name, _pool_size)                                                   \
     NRF_LOG_INSTANCE_REGISTER(NRF_BALLOC_LOG_NAME, _name,                                       \
                               NRF_BALLOC_CONFIG_INFO_COLOR,                                     \
                               NRF_BALLOC_CONFIG_DEBUG_COLOR,                                    \
@@ -216,6 +277,7 @@ typedef struct
             NRF_LOG_INSTANCE_PTR_INIT(p_log, NRF_BALLOC_LOG_NAME, _name)                        \
             __NRF_BALLOC_ASSIGN_POOL_NAME(_name)                                                \
             __NRF_BALLOC_ASSIGN_DEBUG_FLAGS(_debug_flags)                                       \
+            __NRF_BALLOC_ASSIGN_CACHE(_name)                                                    \
         }
 
 /**@brief Create a block allocator instance.
@@ -311,6 +373,30 @@ void * nrf_balloc_alloc(nrf_balloc_t const * p_pool);
  */
 void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element);
 
+/**@brief Function for allocating several elements from the pool at once.
+ *
+ * All elements are taken from the pool in a single critical region. The caches enabled by
+ * @ref NRF_BALLOC_CONFIG_CACHE_SIZE are not used.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool from which the elements will be allocated.
+ * @param[out]  pp_elements Array that is filled with the allocated elements.
+ * @param[in]   count       Number of elements to allocate.
+ *
+ * @return      Number of allocated elements. It is less than @p count if the pool ran out.
+ */
+uint8_t nrf_balloc_alloc_n(nrf_balloc_t const * p_pool, void ** pp_elements, uint8_t count);
+
+/**@brief Function for freeing several elements back to the pool at once.
+ *
+ * All elements are returned to the pool in a single critical region. The caches enabled by
+ * @ref NRF_BALLOC_CONFIG_CACHE_SIZE are not used.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   pp_elements Elements to be freed.
+ * @param[in]   count       Number of elements to free.
+ */
+void nrf_balloc_free_n(nrf_balloc_t const * p_pool, void * const * pp_elements, uint8_t count);
+
 /**@brief Function for getting maximum memory pool utilization.
  *
  * @param[in]   p_pool Pointer to the memory pool instance.
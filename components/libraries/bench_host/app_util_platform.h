@@ -0,0 +1,22 @@
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include <stdint.h>
+#include "compiler_abstraction.h"
+#include "nrf.h"
+#include "nrf_assert.h"
+#include "app_error.h"
+
+// Most benches call their simulated interrupts from the thread, so there is nothing to mask.
+// Benches which play interrupts with signals provide their own app_util_platform.h in host/.
+#define CRITICAL_REGION_ENTER()
+#define CRITICAL_REGION_EXIT()
+#define CRITICAL_SECTION_ENTER()
+#define CRITICAL_SECTION_EXIT()
+
+#define APP_IRQ_PRIORITY_LOW    0
+
+static inline void app_util_critical_region_enter(uint8_t * p_nested) { (void)p_nested; }
+static inline void app_util_critical_region_exit(uint8_t nested)      { (void)nested; }
+
+#endif // APP_UTIL_PLATFORM_H__
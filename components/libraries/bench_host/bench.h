@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef BENCH_H__
+#define BENCH_H__
+
+/* Harness shared by the host benchmarks and stress tests in the bench directories of the libraries.
+ *
+ * The host replacements of the platform headers are kept next to it. A bench adds this directory
+ * to the include path after its own host directory, which holds its sdk_config.h and overrides
+ * any of the shared headers, and builds bench.c along with its sources:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host ... $L/bench_host/bench.c
+ *
+ * bench.c also provides app_error_handler(), app_error_handler_bare() and assert_nrf_callback(),
+ * which print the error and exit.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Record a failed check. The first one is kept to be reported by @ref bench_failed. */
+void bench_error_record(char const * p_error);
+
+/**@brief Number of failed checks recorded so far. */
+uint64_t bench_error_count(void);
+
+/**@brief Print the number of failed checks and the first one, if any.
+ *
+ * @retval true  If checks failed.
+ * @retval false If all checks passed.
+ */
+bool bench_failed(void);
+
+/**@brief Pseudo-random number from a linear congruential generator, 24 bits wide. */
+uint32_t bench_random(void);
+
+/**@brief Host monotonic time in nanoseconds. */
+uint64_t bench_now_ns(void);
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            bench_error_record(#cond);                                      \
+        }                                                                   \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_H__
@@ -0,0 +1,15 @@
+#ifndef COMPILER_ABSTRACTION_H__
+#define COMPILER_ABSTRACTION_H__
+
+#define __INLINE            inline
+#define __STATIC_INLINE     static inline
+#define __WEAK              __attribute__((weak))
+#define __ALIGN(n)          __attribute__((aligned(n)))
+#define __PACKED            __attribute__((packed))
+#define __UNUSED            __attribute__((unused))
+#define GET_SP()            0
+
+#define ANON_UNIONS_ENABLE  struct semicolon_swallower
+#define ANON_UNIONS_DISABLE struct semicolon_swallower
+
+#endif // COMPILER_ABSTRACTION_H__
@@ -0,0 +1,28 @@
+#ifndef NRF_H__
+#define NRF_H__
+
+#include <stdint.h>
+
+// Host replacement of the CMSIS intrinsics used by the libraries.
+#define __REV(x)        __builtin_bswap32(x)
+#define __DMB()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DSB()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __SEV()
+#define __USAT(x, n)    ((uint32_t)(x) > ((1UL << (n)) - 1) ? ((1UL << (n)) - 1) : (uint32_t)(x))
+
+static inline uint32_t __CLZ(uint32_t value)
+{
+    return (value == 0) ? 32 : (uint32_t)__builtin_clz(value);
+}
+
+// Device definitions of the nRF52832 which the libraries depend on. The device itself, for example
+// NRF52832_XXAA, is selected on the command line, as in the SDK makefiles.
+typedef int IRQn_Type;
+
+#define RTC1_IRQn                   17
+#define RTC_COUNTER_COUNTER_Msk     (0xFFFFFFUL)
+
+#define UART_PRESENT
+#define UARTE_PRESENT
+
+#endif // NRF_H__
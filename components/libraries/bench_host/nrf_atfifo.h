@@ -0,0 +1,92 @@
+#ifndef NRF_ATFIFO_H__
+#define NRF_ATFIFO_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nordic_common.h"
+#include "sdk_errors.h"
+
+// Host replacement of the atomic FIFO, which is implemented in Cortex-M assembly.
+// The benches put and get the items in a single context, so a plain ring buffer is enough.
+
+typedef struct
+{
+    uint8_t  * p_buf;
+    uint16_t   item_size;
+    uint16_t   item_cnt;
+    uint16_t   rd;
+    uint16_t   wr;
+    uint16_t   used;    // Allocated or stored items.
+} nrf_atfifo_t;
+
+typedef struct
+{
+    uint16_t wr;
+} nrf_atfifo_item_put_t;
+
+typedef struct
+{
+    uint16_t rd;
+} nrf_atfifo_item_get_t;
+
+#define NRF_ATFIFO_DEF(fifo_id, storage_type, cnt)                                      \
+    static storage_type CONCAT_2(fifo_id, _data)[(cnt)];                                \
+    static nrf_atfifo_t CONCAT_2(fifo_id, _inst) =                                      \
+    {                                                                                   \
+        .p_buf     = (uint8_t *)CONCAT_2(fifo_id, _data),                               \
+        .item_size = sizeof(storage_type),                                              \
+        .item_cnt  = (cnt),                                                             \
+    };                                                                                  \
+    static nrf_atfifo_t * const fifo_id = &CONCAT_2(fifo_id, _inst)
+
+#define NRF_ATFIFO_INIT(fifo_id) nrf_atfifo_clear(fifo_id)
+
+static inline ret_code_t nrf_atfifo_clear(nrf_atfifo_t * const p_fifo)
+{
+    p_fifo->rd   = 0;
+    p_fifo->wr   = 0;
+    p_fifo->used = 0;
+    return NRF_SUCCESS;
+}
+
+static inline void * nrf_atfifo_item_alloc(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_put_t * p_context)
+{
+    if (p_fifo->used == p_fifo->item_cnt)
+    {
+        return NULL;
+    }
+
+    p_context->wr = p_fifo->wr;
+    p_fifo->wr    = (p_fifo->wr + 1) % p_fifo->item_cnt;
+    p_fifo->used++;
+
+    return p_fifo->p_buf + ((uint32_t)p_context->wr * p_fifo->item_size);
+}
+
+static inline bool nrf_atfifo_item_put(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_put_t * p_context)
+{
+    (void)p_fifo;
+    (void)p_context;
+    return true;
+}
+
+static inline void * nrf_atfifo_item_get(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_get_t * p_context)
+{
+    if (p_fifo->rd == p_fifo->wr && p_fifo->used != p_fifo->item_cnt)
+    {
+        return NULL;
+    }
+
+    p_context->rd = p_fifo->rd;
+    return p_fifo->p_buf + ((uint32_t)p_context->rd * p_fifo->item_size);
+}
+
+static inline bool nrf_atfifo_item_free(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_get_t * p_context)
+{
+    (void)p_context;
+    p_fifo->rd = (p_fifo->rd + 1) % p_fifo->item_cnt;
+    p_fifo->used--;
+    return true;
+}
+
+#endif // NRF_ATFIFO_H__
@@ -0,0 +1,29 @@
+#ifndef NRF_SECTION_H__
+#define NRF_SECTION_H__
+
+#include "nordic_common.h"
+
+// Host replacement of the section variables. The GNU linker only defines the __start_ and
+// __stop_ symbols of sections whose names are valid C identifiers, so the leading dot used
+// by the nRF linker scripts is dropped.
+
+#define NRF_SECTION_START_ADDR(section_name)    &CONCAT_2(__start_, section_name)
+#define NRF_SECTION_END_ADDR(section_name)      &CONCAT_2(__stop_, section_name)
+#define NRF_SECTION_LENGTH(section_name)                        \
+    ((size_t)NRF_SECTION_END_ADDR(section_name) -               \
+     (size_t)NRF_SECTION_START_ADDR(section_name))
+
+#define NRF_SECTION_DEF(section_name, data_type)                \
+    extern data_type * CONCAT_2(__start_, section_name);        \
+    extern void      * CONCAT_2(__stop_,  section_name)
+
+#define NRF_SECTION_ITEM_REGISTER(section_name, section_var)    \
+    section_var __attribute__ ((section(STRINGIFY(section_name)))) __attribute__((used))
+
+#define NRF_SECTION_ITEM_GET(section_name, data_type, i)        \
+    ((data_type*)NRF_SECTION_START_ADDR(section_name) + (i))
+
+#define NRF_SECTION_ITEM_COUNT(section_name, data_type)         \
+    NRF_SECTION_LENGTH(section_name) / sizeof(data_type)
+
+#endif // NRF_SECTION_H__
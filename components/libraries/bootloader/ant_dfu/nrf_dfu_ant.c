@@ -389,6 +389,7 @@ static void handle_response(nrf_dfu_response_t * p_res, void * p_context)
 
         // Packet Notification time, send a CRC response.
         m_pkt_notify.remaining = m_pkt_notify.limit;
+        nrf_dfu_req_handler_write_crc_update(p_res);
         p_res->request = NRF_DFU_OP_CRC_GET;
         uint32_t offset = p_res->write.offset;
         uint32_t crc = p_res->write.crc;
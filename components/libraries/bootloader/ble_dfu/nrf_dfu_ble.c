@@ -405,6 +405,8 @@ static void ble_dfu_req_handler_callback(nrf_dfu_response_t * p_res, void * p_co
         /* Reply with a CRC message and reset the packet counter. */
         m_pkt_notif_target_cnt = m_pkt_notif_target;
 
+        nrf_dfu_req_handler_write_crc_update(p_res);
+
         p_res->request = NRF_DFU_OP_CRC_GET;
     }
 
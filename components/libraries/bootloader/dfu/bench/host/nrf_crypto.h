@@ -0,0 +1,7 @@
+#ifndef NRF_CRYPTO_H__
+#define NRF_CRYPTO_H__
+
+// Host stand-in for nrf_crypto. Signatures and hashes are checked by the validation, which is
+// simulated by the bench.
+
+#endif // NRF_CRYPTO_H__
@@ -0,0 +1,10 @@
+#ifndef NRF_MBR_H__
+#define NRF_MBR_H__
+
+// Host stand-in for the MBR definitions used by the DFU types.
+
+#define MBR_SIZE                (0x1000)
+#define MBR_PAGE_SIZE_IN_WORDS  (1024)
+#define MBR_PARAM_PAGE_ADDR     (0x10001018)
+
+#endif // NRF_MBR_H__
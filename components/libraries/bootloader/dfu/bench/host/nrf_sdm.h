@@ -0,0 +1,8 @@
+#ifndef NRF_SDM_H__
+#define NRF_SDM_H__
+
+// Host stand-in for the SoftDevice information used by the bootloader info.
+
+#define SOFTDEVICE_INFO_STRUCT_OFFSET (0x2000)
+
+#endif // NRF_SDM_H__
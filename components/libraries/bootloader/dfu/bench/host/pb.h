@@ -0,0 +1,20 @@
+#ifndef PB_H_INCLUDED
+#define PB_H_INCLUDED
+
+// Host stand-in for the nanopb types used by the init command structures. Init commands are not
+// decoded on host.
+
+#include <stdint.h>
+
+#define PB_PROTO_HEADER_VERSION 30
+
+typedef uint_least16_t pb_size_t;
+
+typedef struct
+{
+    uint32_t tag;
+} pb_field_t;
+
+#define PB_BYTES_ARRAY_T(n) struct { pb_size_t size; uint8_t bytes[n]; }
+
+#endif // PB_H_INCLUDED
@@ -0,0 +1,8 @@
+#ifndef PB_COMMON_H_INCLUDED
+#define PB_COMMON_H_INCLUDED
+
+// Host stand-in for nanopb, see pb.h.
+
+#include "pb.h"
+
+#endif // PB_COMMON_H_INCLUDED
@@ -0,0 +1,23 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of the DFU request handler and flash module used by
+// nrf_dfu_bench.
+
+#define NRF_FSTORAGE_ENABLED 1
+#define NRF_FSTORAGE_PARAM_CHECK_DISABLED 0
+
+#ifndef NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+#define NRF_DFU_FLASH_WRITE_BUFFER_SIZE 4096
+#endif
+#define NRF_DFU_FLASH_WRITE_BUFFERS 2
+
+#define CRC32_ENABLED 1
+
+// Only the object requests are handled on host.
+#define NRF_DFU_PROTOCOL_REDUCED 1
+#define NRF_DFU_SAVE_PROGRESS_IN_FLASH 0
+
+#define NRF_LOG_ENABLED 0
+
+#endif // SDK_CONFIG_H
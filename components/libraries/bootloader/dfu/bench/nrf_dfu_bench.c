@@ -0,0 +1,1056 @@
+/**
+ * Copyright (c) 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* Test and benchmark of DFU data object transfers through the request handler and the flash
+ * module, on simulated transports and flash.
+ *
+ * Build it on host from this directory:
+ *   L=../../..; cc -O2 -DNRF52832_XXAA -DNRF52_SERIES -DBLE_STACK_SUPPORT_REQD -Ihost \
+ *      -I$L/bench_host -I.. -I../.. -I$L/fstorage -I$L/crc32 -I$L/scheduler -I$L/util -I$L/log \
+ *      -I$L/log/src -I$L/strerror nrf_dfu_bench.c ../nrf_dfu_req_handler.c \
+ *      ../nrf_dfu_handling_error.c ../nrf_dfu_flash.c $L/fstorage/nrf_fstorage.c \
+ *      $L/bench_host/bench.c -o nrf_dfu_bench
+ * Add -DNRF_DFU_FLASH_WRITE_BUFFER_SIZE=0 to store each write directly. crc32.c is built by the
+ * bench, so that the time of the CRCs computed by the request handler is simulated.
+ *
+ * Usage: nrf_dfu_bench [kilobytes]
+ *
+ * A firmware image is sent in 4 kB data objects, as by nrfutil: create, write requests, then CRC
+ * check and execute. The requests are handled by nrf_dfu_req_handler through a simulated
+ * scheduler. The settings are kept in RAM and the validation is simulated: the init command is
+ * valid, for an image of the size sent. The write buffers are 2 of 4 kB, or of 256 bytes with the
+ * NVMC; the writes which do not fit in them are stored directly.
+ *
+ * The bench implements nrf_fstorage_nvmc on a simulated nRF52832 flash: 41 us per word, 85 ms per
+ * page. Operations complete immediately, like the NVMC, halting the CPU and the transport, or
+ * are queued, four at most, and complete later, like with the SoftDevice. The transports are:
+ * - uart:    64-byte writes at 1 Mbaud, 3 buffers, NVMC,
+ * - usb:     512-byte writes at 1 MB/s, 3 buffers, NVMC,
+ * - ble:     244-byte writes at 100 kB/s, 17 buffers, SoftDevice,
+ * - ble-prn: as ble, with a packet receipt notification every 8 writes.
+ * A transport buffer is held from the reception of a write until the request handler frees it,
+ * and the transport stalls while all of them are held. A write which cannot be queued is
+ * dropped by the request handler. The peer sends the object again when its CRC, or the CRC of a
+ * packet receipt notification, does not match the image, three times at most. Writes which
+ * arrive while the page is erased fill the SoftDevice queue, so without the write buffers the
+ * ble transfers are expected to be aborted.
+ *
+ * For each transport, the effective rate, the rate measured by the request handler, longest halt
+ * of the NVMC on a write, flash operations, writes stored directly, dropped writes, objects sent
+ * again and host time per byte are printed. The CRCs are checked against the image, as well as
+ * the image in flash when it is activated and the executed objects at the end. Transport buffers
+ * are overwritten when freed, so that data used after that is detected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdk_common.h"
+#include "nrf_dfu_req_handler.h"
+#include "nrf_dfu_settings.h"
+#include "nrf_dfu_validation.h"
+#include "nrf_dfu_flash.h"
+#include "nrf_dfu_types.h"
+#include "nrf_fstorage.h"
+#include "nrf_fstorage_nvmc.h"
+#include "app_scheduler.h"
+#include "crc32.h"
+#include "bench.h"
+
+
+#define FLASH_SIZE          (BOOTLOADER_SETTINGS_ADDRESS + BOOTLOADER_SETTINGS_PAGE_SIZE)
+#define FIRMWARE_START      0x20000
+#define IMAGE_SIZE_MAX      (BOOTLOADER_SETTINGS_ADDRESS - FIRMWARE_START)
+#define OBJECT_SIZE         CODE_PAGE_SIZE
+#define WORD_NS             41000
+#define PAGE_ERASE_NS       85000000
+#define NVMC_OP_NS          5000        // Call overhead of an operation.
+#define SD_OP_NS            250000      // Flash request, timeslot and SoC event of an operation.
+#define SD_QUEUE_SIZE       4           // NRF_FSTORAGE_SD_QUEUE_SIZE.
+#define REQUEST_NS          30000       // Scheduling and handling of a request.
+#define CRC_NS_PER_BYTE     125
+#define TRANSPORT_BUFFERS   17
+#define PAYLOAD_MAX         512
+#define SCHED_SIZE          (TRANSPORT_BUFFERS + 2)
+#define OBJECT_RETRIES      3           // Times the peer sends an object again before aborting.
+#define INIT_COMMAND_SIZE   141         // Signed init command.
+
+typedef struct
+{
+    char const * p_name;
+    uint32_t     payload;       // Bytes per write request.
+    uint32_t     packet_ns;     // Transport time of a write request.
+    uint32_t     buffers;
+    uint32_t     rtt_ns;        // Round trip of a control request and its response.
+    uint32_t     prn;           // Writes per packet receipt notification, 0 for none.
+    bool         softdevice;
+} transport_t;
+
+typedef struct
+{
+    nrf_dfu_request_t         req;
+    app_sched_event_handler_t handler;
+} sched_event_t;
+
+typedef struct
+{
+    nrf_fstorage_t const * p_fs;
+    nrf_fstorage_evt_id_t  id;
+    uint32_t               addr;
+    void const *           p_src;
+    uint32_t               len;
+    void *                 p_param;
+} flash_op_t;
+
+static transport_t const m_transports[] =
+{
+    { "uart",     64,  690000,  3,  1000000, 0, false },
+    { "usb",     512,  520000,  3,  1000000, 0, false },
+    { "ble",     244, 2440000, 17, 15000000, 0, true  },
+    { "ble-prn", 244, 2440000, 17, 15000000, 8, true  },
+};
+
+static uint32_t             m_flash[FLASH_SIZE / sizeof(uint32_t)];
+static uint8_t              m_image[IMAGE_SIZE_MAX];
+static uint32_t             m_image_size;
+static uint64_t             m_now;              // Simulated time in nanoseconds.
+static transport_t const *  mp_transport;
+
+// Simulated flash.
+static nrf_fstorage_info_t  m_flash_info =
+{
+    .erase_unit   = CODE_PAGE_SIZE,
+    .program_unit = sizeof(uint32_t),
+    .rmap         = true,
+    .wmap         = false,
+};
+static flash_op_t           m_flash_ops[SD_QUEUE_SIZE];
+static uint32_t             m_flash_op_head;
+static uint32_t             m_flash_op_count;
+static uint64_t             m_flash_done;       // End of the operation in progress.
+
+// Transport, peer and scheduler.
+static uint32_t             m_buffers[TRANSPORT_BUFFERS][PAYLOAD_MAX / sizeof(uint32_t)];
+static bool                 m_buffer_used[TRANSPORT_BUFFERS];
+static sched_event_t        m_sched[SCHED_SIZE];
+static uint32_t             m_sched_head;
+static uint32_t             m_sched_count;
+static uint64_t             m_cpu_free;         // End of the request being handled.
+static uint64_t             m_link_free;        // End of the transmission in progress.
+static nrf_dfu_request_t    m_in_transit;       // Request being transmitted.
+static bool                 m_in_transit_set;
+static nrf_dfu_response_t   m_response;         // Response being transmitted.
+static uint64_t             m_response_at;      // Arrival of the response to the peer.
+static uint32_t             m_prn_count;        // Writes answered since the last notification.
+static bool                 m_command;          // The peer sends the init command.
+static bool                 m_sending;          // The peer sends the writes of the object.
+static bool                 m_resend;           // A notification did not match, the object is sent again.
+static uint32_t             m_object_offset;    // Offset of the object being sent.
+static uint32_t             m_object_sent;      // Bytes of it sent.
+static uint32_t             m_object_retries;
+static bool                 m_aborted;
+static bool                 m_completed;
+
+// Statistics.
+static uint32_t             m_flash_operations;
+static uint32_t             m_direct_writes;    // Writes stored from the transport buffer.
+static uint32_t             m_drops;
+static uint32_t             m_objects_resent;
+static uint64_t             m_write_halt_max;
+
+// Settings of the request handler, kept in RAM.
+nrf_dfu_settings_t          s_dfu_settings;
+
+
+// The CRC module is built here, so that the time of the CRCs computed by the request handler is
+// added to the request being handled. The bench checks use crc32_compute_host.
+#define crc32_compute crc32_compute_host
+#include "crc32.c"
+#undef crc32_compute
+
+uint32_t crc32_compute(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc)
+{
+    m_cpu_free += (uint64_t)size * CRC_NS_PER_BYTE;
+    return crc32_compute_host(p_data, size, p_crc);
+}
+
+
+static uint64_t flash_op_ns(flash_op_t const * p_op)
+{
+    uint64_t const op_ns = mp_transport->softdevice ? SD_OP_NS : NVMC_OP_NS;
+
+    if (p_op->id == NRF_FSTORAGE_EVT_WRITE_RESULT)
+    {
+        return op_ns + (uint64_t)(p_op->len / sizeof(uint32_t)) * WORD_NS;
+    }
+    return op_ns + (uint64_t)p_op->len * PAGE_ERASE_NS;
+}
+
+
+static void flash_op_execute(flash_op_t const * p_op)
+{
+    m_flash_operations++;
+    if (p_op->id == NRF_FSTORAGE_EVT_WRITE_RESULT)
+    {
+        uint32_t const * p_src = p_op->p_src;
+        for (uint32_t i = 0; i < p_op->len / sizeof(uint32_t); i++)
+        {
+            m_flash[p_op->addr / sizeof(uint32_t) + i] &= p_src[i];
+        }
+    }
+    else
+    {
+        memset(&m_flash[p_op->addr / sizeof(uint32_t)], 0xFF, p_op->len * CODE_PAGE_SIZE);
+    }
+
+    nrf_fstorage_evt_t evt =
+    {
+        .result  = NRF_SUCCESS,
+        .id      = p_op->id,
+        .addr    = p_op->addr,
+        .p_src   = p_op->p_src,
+        .len     = p_op->len,
+        .p_param = p_op->p_param,
+    };
+    p_op->p_fs->evt_handler(&evt);
+}
+
+
+// The CPU and the transport are halted while the NVMC writes or erases.
+static void flash_halt(uint64_t duration)
+{
+    m_now += duration;
+    if (m_cpu_free > m_now - duration)
+    {
+        m_cpu_free += duration;
+    }
+    if (m_link_free > m_now - duration)
+    {
+        m_link_free += duration;
+    }
+}
+
+
+static ret_code_t flash_op_start(flash_op_t const * p_op)
+{
+    if (!mp_transport->softdevice)
+    {
+        uint64_t const duration = flash_op_ns(p_op);
+
+        if (p_op->id == NRF_FSTORAGE_EVT_WRITE_RESULT)
+        {
+            m_write_halt_max = MAX(m_write_halt_max, duration);
+        }
+        flash_halt(duration);
+        flash_op_execute(p_op);
+        return NRF_SUCCESS;
+    }
+
+    if (m_flash_op_count == SD_QUEUE_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    if (m_flash_op_count == 0)
+    {
+        m_flash_done = m_now + flash_op_ns(p_op);
+    }
+    m_flash_ops[(m_flash_op_head + m_flash_op_count++) % SD_QUEUE_SIZE] = *p_op;
+    return NRF_SUCCESS;
+}
+
+
+static void flash_op_complete(void)
+{
+    flash_op_t const op = m_flash_ops[m_flash_op_head];
+
+    m_flash_op_head = (m_flash_op_head + 1) % SD_QUEUE_SIZE;
+    m_flash_op_count--;
+    if (m_flash_op_count != 0)
+    {
+        m_flash_done = m_now + flash_op_ns(&m_flash_ops[m_flash_op_head]);
+    }
+    flash_op_execute(&op);
+}
+
+
+static ret_code_t sim_init(nrf_fstorage_t * p_fs, void * p_param)
+{
+    p_fs->p_flash_info = &m_flash_info;
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t sim_uninit(nrf_fstorage_t * p_fs, void * p_param)
+{
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t sim_read(nrf_fstorage_t const * p_fs, uint32_t src, void * p_dest, uint32_t len)
+{
+    memcpy(p_dest, (uint8_t *)m_flash + src, len);
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t sim_write(nrf_fstorage_t const * p_fs,
+                            uint32_t               dest,
+                            void           const * p_src,
+                            uint32_t               len,
+                            void                 * p_param)
+{
+    flash_op_t const op =
+    {
+        .p_fs    = p_fs,
+        .id      = NRF_FSTORAGE_EVT_WRITE_RESULT,
+        .addr    = dest,
+        .p_src   = p_src,
+        .len     = len,
+        .p_param = p_param,
+    };
+    ret_code_t const rc = flash_op_start(&op);
+
+    if (   (rc == NRF_SUCCESS)
+        && ((uint8_t const *)p_src >= (uint8_t const *)m_buffers)
+        && ((uint8_t const *)p_src <  (uint8_t const *)m_buffers + sizeof(m_buffers)))
+    {
+        m_direct_writes++;
+    }
+    return rc;
+}
+
+
+static ret_code_t sim_erase(nrf_fstorage_t const * p_fs,
+                            uint32_t               page_addr,
+                            uint32_t               len,
+                            void                 * p_param)
+{
+    flash_op_t const op =
+    {
+        .p_fs    = p_fs,
+        .id      = NRF_FSTORAGE_EVT_ERASE_RESULT,
+        .addr    = page_addr,
+        .len     = len,
+        .p_param = p_param,
+    };
+    return flash_op_start(&op);
+}
+
+
+static uint8_t const * sim_rmap(nrf_fstorage_t const * p_fs, uint32_t addr)
+{
+    return (uint8_t const *)m_flash + addr;
+}
+
+
+static uint8_t * sim_wmap(nrf_fstorage_t const * p_fs, uint32_t addr)
+{
+    return NULL;
+}
+
+
+static bool sim_is_busy(nrf_fstorage_t const * p_fs)
+{
+    return (m_flash_op_count != 0);
+}
+
+
+nrf_fstorage_api_t nrf_fstorage_nvmc =
+{
+    .init    = sim_init,
+    .uninit  = sim_uninit,
+    .read    = sim_read,
+    .write   = sim_write,
+    .erase   = sim_erase,
+    .rmap    = sim_rmap,
+    .wmap    = sim_wmap,
+    .is_busy = sim_is_busy,
+};
+
+
+// The backend only selects the size of the write buffers, the transport selects the timing.
+nrf_fstorage_api_t nrf_fstorage_sd =
+{
+    .init    = sim_init,
+    .uninit  = sim_uninit,
+    .read    = sim_read,
+    .write   = sim_write,
+    .erase   = sim_erase,
+    .rmap    = sim_rmap,
+    .wmap    = sim_wmap,
+    .is_busy = sim_is_busy,
+};
+
+
+static void payload_free(void * p_buf)
+{
+    uint32_t idx = ((uint32_t *)p_buf - m_buffers[0]) / ARRAY_SIZE(m_buffers[0]);
+
+    CHECK((idx < mp_transport->buffers) && m_buffer_used[idx]);
+    m_buffer_used[idx] = false;
+
+    // Data used after this is wrong.
+    memset(p_buf, 0xA5, sizeof(m_buffers[0]));
+}
+
+
+static int buffer_alloc(void)
+{
+    for (uint32_t i = 0; i < mp_transport->buffers; i++)
+    {
+        if (!m_buffer_used[i])
+        {
+            m_buffer_used[i] = true;
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+
+ret_code_t nrf_dfu_settings_write_and_backup(nrf_dfu_flash_callback_t callback)
+{
+    if (callback != NULL)
+    {
+        callback(NULL);
+    }
+    return NRF_SUCCESS;
+}
+
+
+void nrf_dfu_validation_init(void)
+{
+}
+
+
+nrf_dfu_result_t nrf_dfu_validation_init_cmd_create(uint32_t size)
+{
+    UNUSED_PARAMETER(size);
+    return NRF_DFU_RES_CODE_SUCCESS;
+}
+
+
+nrf_dfu_result_t nrf_dfu_validation_init_cmd_append(uint8_t const * p_data, uint32_t length)
+{
+    UNUSED_PARAMETER(p_data);
+    UNUSED_PARAMETER(length);
+    return NRF_DFU_RES_CODE_SUCCESS;
+}
+
+
+bool nrf_dfu_validation_init_cmd_present(void)
+{
+    return true;
+}
+
+
+nrf_dfu_result_t nrf_dfu_validation_init_cmd_execute(uint32_t * p_dst_data_addr,
+                                                     uint32_t * p_data_len)
+{
+    *p_dst_data_addr = FIRMWARE_START;
+    *p_data_len      = m_image_size;
+    return NRF_DFU_RES_CODE_SUCCESS;
+}
+
+
+// The whole image is in flash once the last object is executed.
+nrf_dfu_result_t nrf_dfu_validation_activation_prepare(uint32_t data_addr, uint32_t data_len)
+{
+    CHECK((data_addr == FIRMWARE_START) && (data_len == m_image_size));
+    CHECK(!nrf_fstorage_is_busy(NULL));
+    CHECK(memcmp((uint8_t *)m_flash + data_addr, m_image, data_len) == 0);
+    return NRF_DFU_RES_CODE_SUCCESS;
+}
+
+
+uint32_t app_sched_event_put(void const *              p_event_data,
+                             uint16_t                  event_size,
+                             app_sched_event_handler_t handler)
+{
+    if (m_sched_count == SCHED_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    sched_event_t * p_event = &m_sched[(m_sched_head + m_sched_count++) % SCHED_SIZE];
+
+    CHECK(event_size == sizeof(p_event->req));
+    memcpy(&p_event->req, p_event_data, sizeof(p_event->req));
+    p_event->handler = handler;
+    return NRF_SUCCESS;
+}
+
+
+static void sched_execute(void)
+{
+    sched_event_t event = m_sched[m_sched_head];
+
+    m_sched_head = (m_sched_head + 1) % SCHED_SIZE;
+    m_sched_count--;
+    m_cpu_free = MAX(m_cpu_free, m_now) + REQUEST_NS;
+    event.handler(&event.req, sizeof(event.req));
+}
+
+
+static uint32_t timestamp_get(void)
+{
+    return (uint32_t)(m_now / 1000);
+}
+
+
+static void dfu_observer(nrf_dfu_evt_type_t notification)
+{
+    if (notification == NRF_DFU_EVT_DFU_COMPLETED)
+    {
+        m_completed = true;
+    }
+}
+
+
+// As the transports, which answer write requests only with packet receipt notifications.
+static void response_send(nrf_dfu_response_t * p_res, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if (p_res->request != NRF_DFU_OP_OBJECT_WRITE)
+    {
+        m_response    = *p_res;
+        m_response_at = MAX(m_cpu_free, m_now) + mp_transport->rtt_ns / 2;
+        return;
+    }
+
+    // The offset of a write which was not stored is not set.
+    if ((p_res->result != NRF_DFU_RES_CODE_SUCCESS) || (p_res->write.offset == 0))
+    {
+        m_drops++;
+    }
+
+    if ((mp_transport->prn == 0) || (++m_prn_count < mp_transport->prn))
+    {
+        return;
+    }
+    m_prn_count = 0;
+
+    nrf_dfu_req_handler_write_crc_update(p_res);
+
+    // The peer checks the notification when it is sent. Writes of an object sent again are
+    // handled after the ones it stopped sending.
+    if (   m_sending
+        && (p_res->write.crc != crc32_compute_host(m_image, p_res->write.offset, NULL)))
+    {
+        m_resend = true;
+    }
+}
+
+
+static void control_send(nrf_dfu_op_t request)
+{
+    m_in_transit = (nrf_dfu_request_t)
+    {
+        .request           = request,
+        .callback.response = response_send,
+    };
+    if ((request == NRF_DFU_OP_OBJECT_CREATE) && m_command)
+    {
+        m_in_transit.create.object_type = NRF_DFU_OBJ_TYPE_COMMAND;
+        m_in_transit.create.object_size = INIT_COMMAND_SIZE;
+    }
+    else if (request == NRF_DFU_OP_OBJECT_CREATE)
+    {
+        m_in_transit.create.object_type = NRF_DFU_OBJ_TYPE_DATA;
+        m_in_transit.create.object_size = MIN(OBJECT_SIZE, m_image_size - m_object_offset);
+    }
+    m_in_transit_set = true;
+    m_link_free      = MAX(m_link_free, m_now) + mp_transport->rtt_ns / 2;
+}
+
+
+// Sends the next write of the object, if a transport buffer is free.
+static void write_send(void)
+{
+    int const idx = buffer_alloc();
+    if (idx < 0)
+    {
+        return;
+    }
+
+    uint32_t const end = MIN(m_object_offset + OBJECT_SIZE, m_image_size);
+    uint32_t const len = MIN(mp_transport->payload, end - m_object_offset - m_object_sent);
+
+    memcpy(m_buffers[idx], &m_image[m_object_offset + m_object_sent], len);
+    m_object_sent += len;
+
+    m_in_transit = (nrf_dfu_request_t)
+    {
+        .request           = NRF_DFU_OP_OBJECT_WRITE,
+        .callback.response = response_send,
+        .callback.write    = payload_free,
+        .write.p_data      = (uint8_t const *)m_buffers[idx],
+        .write.len         = (uint16_t)len,
+    };
+    m_in_transit_set = true;
+    m_link_free      = MAX(m_link_free, m_now) + mp_transport->packet_ns;
+}
+
+
+// The object is sent again after an erase or CRC error, a few times.
+static void object_resend(void)
+{
+    m_sending = false;
+    if (m_object_retries++ == OBJECT_RETRIES)
+    {
+        m_aborted = true;
+        return;
+    }
+    m_objects_resent++;
+    m_object_sent = 0;
+    control_send(NRF_DFU_OP_OBJECT_CREATE);
+}
+
+
+// The peer sends the writes of the object back to back, then the CRC check.
+static void object_send(void)
+{
+    uint32_t const end = MIN(m_object_offset + OBJECT_SIZE, m_image_size);
+
+    if (m_resend)
+    {
+        m_resend = false;
+        object_resend();
+    }
+    else if (m_object_offset + m_object_sent < end)
+    {
+        write_send();
+    }
+    else
+    {
+        m_sending = false;
+        control_send(NRF_DFU_OP_CRC_GET);
+    }
+}
+
+
+static void on_response(void)
+{
+    uint32_t const end = MIN(m_object_offset + OBJECT_SIZE, m_image_size);
+
+    m_response_at = UINT64_MAX;
+    if (m_response.result != NRF_DFU_RES_CODE_SUCCESS)
+    {
+        object_resend();
+        return;
+    }
+
+    // The content of the init command is not sent, its validation is simulated.
+    if (m_command)
+    {
+        m_command = (m_response.request == NRF_DFU_OP_OBJECT_CREATE);
+        control_send(m_command ? NRF_DFU_OP_OBJECT_EXECUTE : NRF_DFU_OP_OBJECT_CREATE);
+        return;
+    }
+
+    switch (m_response.request)
+    {
+        case NRF_DFU_OP_OBJECT_CREATE:
+            m_object_sent = 0;
+            m_sending     = true;
+            break;
+
+        case NRF_DFU_OP_CRC_GET:
+            if (   (m_response.crc.offset == end)
+                && (m_response.crc.crc == crc32_compute_host(m_image, end, NULL)))
+            {
+                control_send(NRF_DFU_OP_OBJECT_EXECUTE);
+            }
+            else
+            {
+                object_resend();
+            }
+            break;
+
+        case NRF_DFU_OP_OBJECT_EXECUTE:
+            m_object_offset  = end;
+            m_object_retries = 0;
+            if (m_object_offset < m_image_size)
+            {
+                control_send(NRF_DFU_OP_OBJECT_CREATE);
+            }
+            break;
+
+        default:
+            bench_error_record("unexpected response");
+            break;
+    }
+}
+
+
+// Advances the simulation to its next event. Returns false when the image is sent.
+static bool sim_step(void)
+{
+    uint64_t next = UINT64_MAX;
+
+    if (m_aborted)
+    {
+        // The transfer is over, the flash operations in progress complete.
+        m_in_transit_set = false;
+        m_sending        = false;
+        m_response_at    = UINT64_MAX;
+        m_sched_count    = 0;
+    }
+    if (m_in_transit_set)
+    {
+        next = m_link_free;
+    }
+    if (m_response_at < next)
+    {
+        next = m_response_at;
+    }
+    if (mp_transport->softdevice && (m_flash_op_count != 0) && (m_flash_done < next))
+    {
+        next = m_flash_done;
+    }
+    if ((m_sched_count != 0) && (MAX(m_cpu_free, m_now) < next))
+    {
+        next = MAX(m_cpu_free, m_now);
+    }
+    if (next == UINT64_MAX)
+    {
+        return false;
+    }
+    m_now = next;
+
+    if (m_in_transit_set && (m_link_free == m_now))
+    {
+        m_in_transit_set = false;
+        CHECK(nrf_dfu_req_handler_on_req(&m_in_transit) == NRF_SUCCESS);
+    }
+    else if (m_response_at == m_now)
+    {
+        on_response();
+    }
+    else if (mp_transport->softdevice && (m_flash_op_count != 0) && (m_flash_done == m_now))
+    {
+        flash_op_complete();
+    }
+    else
+    {
+        sched_execute();
+    }
+
+    // A write waiting for a transport buffer is sent once one is freed.
+    if (m_sending && !m_in_transit_set)
+    {
+        object_send();
+    }
+    return true;
+}
+
+
+static void sim_reset(transport_t const * p_transport)
+{
+    mp_transport       = p_transport;
+    m_now              = 0;
+    m_cpu_free         = 0;
+    m_link_free        = 0;
+    m_response_at      = UINT64_MAX;
+    m_in_transit_set   = false;
+    m_sched_count      = 0;
+    m_prn_count        = 0;
+    m_command          = true;
+    m_sending          = false;
+    m_resend           = false;
+    m_object_offset    = 0;
+    m_object_sent      = 0;
+    m_object_retries   = 0;
+    m_aborted          = false;
+    m_completed        = false;
+    m_flash_operations = 0;
+    m_direct_writes    = 0;
+    m_drops            = 0;
+    m_objects_resent   = 0;
+    m_write_halt_max   = 0;
+    memset(m_buffer_used, 0, sizeof(m_buffer_used));
+    memset(&s_dfu_settings, 0, sizeof(s_dfu_settings));
+
+    APP_ERROR_CHECK(nrf_dfu_req_handler_init(dfu_observer));
+    nrf_dfu_req_handler_timestamp_func_set(timestamp_get, 1000000);
+
+    // The SoftDevice backend uses larger write buffers.
+    APP_ERROR_CHECK(nrf_dfu_flash_init(p_transport->softdevice));
+
+    // Flash content left by a previous image.
+    for (uint32_t i = FIRMWARE_START / sizeof(uint32_t); i < ARRAY_SIZE(m_flash); i++)
+    {
+        m_flash[i] = bench_random();
+    }
+}
+
+
+static void run(transport_t const * p_transport)
+{
+    sim_reset(p_transport);
+
+    uint64_t const start = bench_now_ns();
+
+    control_send(NRF_DFU_OP_OBJECT_CREATE);
+    while (sim_step())
+    {
+    }
+
+    uint64_t const host_ns     = bench_now_ns() - start;
+    uint32_t const offset_last = s_dfu_settings.progress.firmware_image_offset_last;
+
+    // Executed objects are in flash.
+    CHECK(s_dfu_settings.progress.firmware_image_crc_last == crc32_compute_host(m_image, offset_last, NULL));
+    CHECK(memcmp((uint8_t *)m_flash + FIRMWARE_START, m_image, offset_last) == 0);
+    CHECK(!nrf_fstorage_is_busy(NULL));
+    for (uint32_t i = 0; i < mp_transport->buffers; i++)
+    {
+        CHECK(!m_buffer_used[i]);
+    }
+
+    // Writes are dropped only when nrf_fstorage is out of memory.
+    CHECK(m_aborted || (offset_last == m_image_size));
+    CHECK(m_completed == (offset_last == m_image_size));
+    CHECK(!m_aborted || (NRF_DFU_FLASH_WRITE_BUFFER_SIZE == 0));
+    CHECK((m_drops == 0) || mp_transport->softdevice);
+
+    if (m_aborted)
+    {
+        printf("%-7s aborted at %u bytes: %u direct writes, %u dropped, %u objects resent\n",
+               p_transport->p_name,
+               offset_last,
+               m_direct_writes,
+               m_drops,
+               m_objects_resent);
+        return;
+    }
+
+    CHECK(nrf_dfu_req_handler_data_rate_get() != 0);
+    printf("%-7s %6.1f kB/s (%6.1f measured)  %6.2f ms halt  %5u flash ops  %5u direct  %4u dropped  %3u objects resent  %6.1f ns/B\n",
+           p_transport->p_name,
+           (double)m_image_size * 1e6 / m_now,
+           (double)nrf_dfu_req_handler_data_rate_get() / 1e3,
+           (double)m_write_halt_max / 1e6,
+           m_flash_operations,
+           m_direct_writes,
+           m_drops,
+           m_objects_resent,
+           (double)host_ns / m_image_size);
+}
+
+
+#if NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+// As a transport with a packet receipt notification for each write.
+static void response_record(nrf_dfu_response_t * p_res, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if (p_res->request == NRF_DFU_OP_OBJECT_WRITE)
+    {
+        nrf_dfu_req_handler_write_crc_update(p_res);
+    }
+    m_response = *p_res;
+}
+
+
+static nrf_dfu_response_t const * request_check(nrf_dfu_request_t * p_req)
+{
+    p_req->callback.response = response_record;
+    memset(&m_response, 0, sizeof(m_response));
+
+    CHECK(nrf_dfu_req_handler_on_req(p_req) == NRF_SUCCESS);
+    while (m_sched_count != 0)
+    {
+        sched_execute();
+    }
+
+    CHECK(m_response.request == p_req->request);
+    return &m_response;
+}
+
+
+static nrf_dfu_result_t create_check(void)
+{
+    nrf_dfu_request_t req =
+    {
+        .request            = NRF_DFU_OP_OBJECT_CREATE,
+        .create.object_type = NRF_DFU_OBJ_TYPE_DATA,
+        .create.object_size = OBJECT_SIZE,
+    };
+
+    return request_check(&req)->result;
+}
+
+
+// The CRC of the data written to the first object, or 0 if it was not stored.
+static void crc_check(uint8_t const * p_data, uint32_t len)
+{
+    nrf_dfu_request_t          req   = { .request = NRF_DFU_OP_CRC_GET };
+    nrf_dfu_response_t const * p_res = request_check(&req);
+
+    CHECK(p_res->result == NRF_DFU_RES_CODE_SUCCESS);
+    CHECK(p_res->crc.offset == len);
+    CHECK(p_res->crc.crc == crc32_compute_host(p_data, len, NULL));
+}
+
+
+// Writes the first object, checking the notification of each write.
+static void object_write_check(uint8_t const * p_data)
+{
+    uint32_t len;
+
+    for (uint32_t offset = 0; offset < OBJECT_SIZE; offset += len)
+    {
+        int const idx = buffer_alloc();
+
+        len = MIN(mp_transport->payload, OBJECT_SIZE - offset);
+        memcpy(m_buffers[idx], p_data + offset, len);
+
+        nrf_dfu_request_t req =
+        {
+            .request        = NRF_DFU_OP_OBJECT_WRITE,
+            .callback.write = payload_free,
+            .write.p_data   = (uint8_t const *)m_buffers[idx],
+            .write.len      = (uint16_t)len,
+        };
+        nrf_dfu_response_t const * p_res = request_check(&req);
+
+        CHECK(p_res->write.offset == offset + len);
+        CHECK(p_res->write.crc == crc32_compute_host(p_data, offset + len, NULL));
+        CHECK(!m_buffer_used[idx]);
+    }
+}
+
+
+/* The first object is sent again while the write buffers of the previous attempts are being
+ * stored, with the SoftDevice. Their data is not used for the CRCs and is overwritten once the
+ * page is erased again. When both buffers are being stored, a write is stored directly, and
+ * dropped if nrf_fstorage is out of memory.
+ */
+static void retry_check(void)
+{
+    static uint8_t other[OBJECT_SIZE];
+
+    for (uint32_t i = 0; i < OBJECT_SIZE; i++)
+    {
+        other[i] = (uint8_t)~m_image[i];
+    }
+    sim_reset(&m_transports[2]);
+
+    // First attempt, with other data. The erase is done and the buffer is being stored.
+    CHECK(create_check() == NRF_DFU_RES_CODE_SUCCESS);
+    flash_op_complete();
+    object_write_check(other);
+
+    // Second attempt: the buffer of the first one is not used for the CRC.
+    CHECK(create_check() == NRF_DFU_RES_CODE_SUCCESS);
+    object_write_check(m_image);
+    crc_check(m_image, OBJECT_SIZE);
+
+    // Third attempt: both buffers and nrf_fstorage are full, the write is dropped.
+    CHECK(create_check() == NRF_DFU_RES_CODE_SUCCESS);
+    CHECK(m_flash_op_count == SD_QUEUE_SIZE);
+
+    int const idx = buffer_alloc();
+    nrf_dfu_request_t req =
+    {
+        .request        = NRF_DFU_OP_OBJECT_WRITE,
+        .callback.write = payload_free,
+        .write.p_data   = (uint8_t const *)m_buffers[idx],
+        .write.len      = (uint16_t)mp_transport->payload,
+    };
+    CHECK(request_check(&req)->write.offset == 0);
+    CHECK(!m_buffer_used[idx]);
+    crc_check(m_image, 0);
+
+    // Fourth attempt: the page cannot be erased.
+    CHECK(create_check() == NRF_DFU_RES_CODE_INVALID_OBJECT);
+
+    // Last attempt, once the flash operations are done.
+    while (m_flash_op_count != 0)
+    {
+        flash_op_complete();
+    }
+    CHECK(create_check() == NRF_DFU_RES_CODE_SUCCESS);
+    object_write_check(m_image);
+    crc_check(m_image, OBJECT_SIZE);
+    while (m_flash_op_count != 0)
+    {
+        flash_op_complete();
+    }
+
+    req = (nrf_dfu_request_t){ .request = NRF_DFU_OP_OBJECT_EXECUTE };
+    CHECK(request_check(&req)->result == NRF_DFU_RES_CODE_SUCCESS);
+    CHECK(s_dfu_settings.progress.firmware_image_crc_last == crc32_compute_host(m_image, OBJECT_SIZE, NULL));
+    CHECK(memcmp((uint8_t *)m_flash + FIRMWARE_START, m_image, OBJECT_SIZE) == 0);
+    CHECK(!nrf_fstorage_is_busy(NULL));
+
+    printf("retry: first object sent 5 times, %u flash ops\n", m_flash_operations);
+}
+#endif
+
+
+int main(int argc, char ** argv)
+{
+    uint32_t const kilobytes = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200;
+
+    m_image_size = MIN(kilobytes * 1024, IMAGE_SIZE_MAX);
+    for (uint32_t i = 0; i < m_image_size; i++)
+    {
+        m_image[i] = (uint8_t)bench_random();
+    }
+
+    printf("%u bytes, %s\n", m_image_size,
+           NRF_DFU_FLASH_WRITE_BUFFER_SIZE ? "buffered" : "direct");
+    for (uint32_t i = 0; i < ARRAY_SIZE(m_transports); i++)
+    {
+        run(&m_transports[i]);
+    }
+#if NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+    retry_check();
+#endif
+
+    if (bench_failed())
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
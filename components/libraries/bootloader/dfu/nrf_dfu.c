@@ -42,6 +42,7 @@
 #include "nrf_dfu_utils.h"
 #include "nrf_dfu_transport.h"
 #include "nrf_dfu_req_handler.h"
+#include "nrf_bootloader_dfu_timers.h"
 #include "nrf_log.h"
 
 static nrf_dfu_observer_t m_user_observer;                          //<! Observer callback set by the user.
@@ -94,6 +95,12 @@ uint32_t nrf_dfu_init(nrf_dfu_observer_t observer)
     }
 
     ret_val = nrf_dfu_req_handler_init(dfu_observer);
+    if (ret_val == NRF_SUCCESS)
+    {
+        // Time stamps for the data rate log.
+        nrf_dfu_req_handler_timestamp_func_set(nrf_bootloader_dfu_timer_counter_get,
+                                               NRF_BOOTLOADER_MS_TO_TICKS(1000));
+    }
 
     return ret_val;
 }
@@ -45,6 +45,19 @@
 #include "nrf_fstorage_sd.h"
 #include "nrf_fstorage_nvmc.h"
 
+#ifndef NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+#define NRF_DFU_FLASH_WRITE_BUFFER_SIZE 0
+#endif
+
+#ifndef NRF_DFU_FLASH_WRITE_BUFFERS
+#define NRF_DFU_FLASH_WRITE_BUFFERS 2
+#endif
+
+/* The NVMC halts the CPU for about 41 us per word on nRF52832, so 256 bytes for about 2.6 ms. */
+#ifndef NRF_DFU_FLASH_NVMC_WRITE_BUFFER_SIZE
+#define NRF_DFU_FLASH_NVMC_WRITE_BUFFER_SIZE 256
+#endif
+
 
 #define NRF_LOG_MODULE_NAME nrf_dfu_flash
 #include "nrf_log.h"
@@ -63,6 +76,38 @@ NRF_FSTORAGE_DEF(nrf_fstorage_t m_fs) =
 
 static uint32_t m_flash_operations_pending;
 
+#if NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+/* Buffers filled from the start of a page do not straddle pages. */
+STATIC_ASSERT((NRF_DFU_FLASH_WRITE_BUFFER_SIZE % sizeof(uint32_t)) == 0);
+STATIC_ASSERT((CODE_PAGE_SIZE % NRF_DFU_FLASH_WRITE_BUFFER_SIZE) == 0);
+STATIC_ASSERT((NRF_DFU_FLASH_NVMC_WRITE_BUFFER_SIZE % sizeof(uint32_t)) == 0);
+STATIC_ASSERT((CODE_PAGE_SIZE % NRF_DFU_FLASH_NVMC_WRITE_BUFFER_SIZE) == 0);
+STATIC_ASSERT(NRF_DFU_FLASH_WRITE_BUFFERS > 0);
+
+typedef enum
+{
+    WRITE_BUFFER_FREE,
+    WRITE_BUFFER_FILLING,   /**< Gathering data. */
+    WRITE_BUFFER_READY,     /**< To be stored, nrf_fstorage was out of memory. */
+    WRITE_BUFFER_STORING,   /**< Being stored. */
+} write_buffer_state_t;
+
+typedef struct
+{
+    uint32_t                        data[NRF_DFU_FLASH_WRITE_BUFFER_SIZE / sizeof(uint32_t)];
+    uint32_t                        addr;   /**< Flash address of the data, word-aligned. */
+    uint32_t                        start;  /**< Flash address of the first byte gathered. */
+    uint32_t                        len;    /**< Number of bytes gathered, including the padding before the first one. */
+    write_buffer_state_t volatile   state;
+    bool                            discarded;  /**< Data of a previous transfer, still being stored. */
+} write_buffer_t;
+
+static write_buffer_t   m_write_buffers[NRF_DFU_FLASH_WRITE_BUFFERS];
+static write_buffer_t * mp_write_buffer;        /**< Buffer being filled, NULL if none. */
+static uint32_t         m_write_buffer_next;    /**< Index of the next buffer to fill. The buffers are filled in turn. */
+static uint32_t         m_write_buffer_size;    /**< Number of bytes used in each buffer, smaller with the NVMC. */
+#endif
+
 void dfu_fstorage_evt_handler(nrf_fstorage_evt_t * p_evt)
 {
     if (NRF_LOG_ENABLED && (m_flash_operations_pending > 0))
@@ -110,6 +155,12 @@ ret_code_t nrf_dfu_flash_init(bool sd_irq_initialized)
         p_api_impl = &nrf_fstorage_nvmc;
     }
 
+#if NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+    m_write_buffer_size = (p_api_impl == &nrf_fstorage_nvmc)
+                          ? MIN(NRF_DFU_FLASH_WRITE_BUFFER_SIZE, NRF_DFU_FLASH_NVMC_WRITE_BUFFER_SIZE)
+                          : NRF_DFU_FLASH_WRITE_BUFFER_SIZE;
+#endif
+
     return nrf_fstorage_init(&m_fs, p_api_impl, NULL);
 }
 
@@ -165,3 +216,226 @@ ret_code_t nrf_dfu_flash_erase(uint32_t                 page_addr,
 
     return rc;
 }
+
+
+#if NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+static void write_buffer_stored(void * p_buf)
+{
+    /* p_buf is the data of the buffer, which is its first member. */
+    ((write_buffer_t *)p_buf)->state = WRITE_BUFFER_FREE;
+}
+
+
+/* Store the buffers which are ready, stop at the first failure. */
+static ret_code_t write_buffers_store(void)
+{
+    for (uint32_t i = 0; i < NRF_DFU_FLASH_WRITE_BUFFERS; i++)
+    {
+        write_buffer_t * p_buffer = &m_write_buffers[i];
+        uint32_t const   len      = ALIGN_NUM(sizeof(uint32_t), p_buffer->len);
+
+        if (p_buffer->state != WRITE_BUFFER_READY)
+        {
+            continue;
+        }
+
+        /* Pad the last word with the value of erased flash. */
+        memset((uint8_t *)p_buffer->data + p_buffer->len, 0xFF, len - p_buffer->len);
+
+        /* The state is set first, since the NVMC backend completes the operation before returning. */
+        p_buffer->state = WRITE_BUFFER_STORING;
+        ret_code_t rc = nrf_dfu_flash_store(p_buffer->addr, p_buffer->data, len, write_buffer_stored);
+        if (rc != NRF_SUCCESS)
+        {
+            p_buffer->state = WRITE_BUFFER_READY;
+            return rc;
+        }
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+static void write_buffer_close(void)
+{
+    if (mp_write_buffer != NULL)
+    {
+        mp_write_buffer->state = WRITE_BUFFER_READY;
+        mp_write_buffer        = NULL;
+    }
+}
+
+
+/* Whether the data fits in the buffer being filled and the free buffers after it. */
+static bool write_buffers_room(uint32_t dest, uint32_t len)
+{
+    uint32_t room = 0;
+
+    if (mp_write_buffer != NULL)
+    {
+        room = m_write_buffer_size - mp_write_buffer->len;
+    }
+    else
+    {
+        len += dest % sizeof(uint32_t);
+    }
+
+    for (uint32_t i = 0; (i < NRF_DFU_FLASH_WRITE_BUFFERS) && (room < len); i++)
+    {
+        if (m_write_buffers[(m_write_buffer_next + i) % NRF_DFU_FLASH_WRITE_BUFFERS].state !=
+            WRITE_BUFFER_FREE)
+        {
+            break;
+        }
+        room += m_write_buffer_size;
+    }
+
+    return (room >= len);
+}
+
+
+static void write_buffer_open(uint32_t dest)
+{
+    mp_write_buffer      = &m_write_buffers[m_write_buffer_next];
+    m_write_buffer_next  = (m_write_buffer_next + 1) % NRF_DFU_FLASH_WRITE_BUFFERS;
+
+    /* Data which does not start on a word boundary is preceded by the value of erased flash. */
+    mp_write_buffer->addr  = dest & ~(sizeof(uint32_t) - 1);
+    mp_write_buffer->start = dest;
+    mp_write_buffer->len   = dest % sizeof(uint32_t);
+    mp_write_buffer->state     = WRITE_BUFFER_FILLING;
+    mp_write_buffer->discarded = false;
+    memset(mp_write_buffer->data, 0xFF, mp_write_buffer->len);
+}
+#endif
+
+
+ret_code_t nrf_dfu_flash_store_buffered(uint32_t                   dest,
+                                        void               const * p_src,
+                                        uint32_t                   len,
+                                        nrf_dfu_flash_callback_t   callback)
+{
+#if NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+    uint8_t const * p_data = p_src;
+
+    /* Retry the buffers nrf_fstorage had no room for. */
+    (void) write_buffers_store();
+
+    if (   (mp_write_buffer != NULL)
+        && (dest != mp_write_buffer->addr + mp_write_buffer->len))
+    {
+        write_buffer_close();
+    }
+
+    if (!write_buffers_room(dest, len))
+    {
+        NRF_LOG_DEBUG("No room in the write buffers.");
+        write_buffer_close();
+        (void) write_buffers_store();
+        return NRF_ERROR_RESOURCES;
+    }
+
+    while (len > 0)
+    {
+        if (mp_write_buffer == NULL)
+        {
+            write_buffer_open(dest);
+        }
+
+        uint32_t const chunk = MIN(len, m_write_buffer_size - mp_write_buffer->len);
+
+        memcpy((uint8_t *)mp_write_buffer->data + mp_write_buffer->len, p_data, chunk);
+        mp_write_buffer->len += chunk;
+        dest                 += chunk;
+        p_data               += chunk;
+        len                  -= chunk;
+
+        if (mp_write_buffer->len == m_write_buffer_size)
+        {
+            write_buffer_close();
+        }
+    }
+
+    /* Full buffers which cannot be stored now are stored on the next call. */
+    (void) write_buffers_store();
+
+    if (callback != NULL)
+    {
+        callback((void *)p_src);
+    }
+
+    return NRF_SUCCESS;
+#else
+    UNUSED_PARAMETER(dest);
+    UNUSED_PARAMETER(p_src);
+    UNUSED_PARAMETER(len);
+    UNUSED_PARAMETER(callback);
+    return NRF_ERROR_RESOURCES;
+#endif
+}
+
+
+uint8_t const * nrf_dfu_flash_data_get(uint32_t addr, uint32_t * p_len)
+{
+    uint32_t next = UINT32_MAX;
+
+#if NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+    /* A buffer is freed only once its data is in flash. A discarded buffer may be stored after the
+     * flash has been erased for new data, so its data is never returned. */
+    for (uint32_t i = 0; i < NRF_DFU_FLASH_WRITE_BUFFERS; i++)
+    {
+        write_buffer_t const * p_buffer = &m_write_buffers[i];
+        uint32_t const         end      = p_buffer->addr + p_buffer->len;
+
+        if ((p_buffer->state == WRITE_BUFFER_FREE) || p_buffer->discarded)
+        {
+            continue;
+        }
+
+        if ((addr >= p_buffer->start) && (addr < end))
+        {
+            *p_len = end - addr;
+            return (uint8_t const *)p_buffer->data + (addr - p_buffer->addr);
+        }
+
+        if ((p_buffer->start > addr) && (p_buffer->start < next))
+        {
+            next = p_buffer->start;
+        }
+    }
+#endif
+
+    *p_len = next - addr;
+    return nrf_fstorage_rmap(&m_fs, addr);
+}
+
+
+ret_code_t nrf_dfu_flash_buffers_flush(void)
+{
+#if NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+    write_buffer_close();
+    return write_buffers_store();
+#else
+    return NRF_SUCCESS;
+#endif
+}
+
+
+void nrf_dfu_flash_buffers_discard(void)
+{
+#if NRF_DFU_FLASH_WRITE_BUFFER_SIZE
+    write_buffer_close();
+    for (uint32_t i = 0; i < NRF_DFU_FLASH_WRITE_BUFFERS; i++)
+    {
+        if (m_write_buffers[i].state == WRITE_BUFFER_READY)
+        {
+            m_write_buffers[i].state = WRITE_BUFFER_FREE;
+        }
+        else
+        {
+            /* The buffers being stored are freed when the operation completes. */
+            m_write_buffers[i].discarded = true;
+        }
+    }
+#endif
+}
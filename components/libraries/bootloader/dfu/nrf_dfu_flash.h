@@ -102,6 +102,65 @@ ret_code_t nrf_dfu_flash_store(uint32_t                     dest,
                                nrf_dfu_flash_callback_t     callback);
 
 
+/**@brief Function for storing data to flash through the write buffers.
+ *
+ * Data is copied to the write buffers, and @p callback is called before this function returns.
+ * Data that follows the data stored before is gathered in the same buffer, and a buffer is
+ * stored once it is full, so consecutive data is written in operations of one buffer, with up to
+ * NRF_DFU_FLASH_WRITE_BUFFERS of them in progress. Call @ref nrf_dfu_flash_buffers_flush to store
+ * the rest of the data.
+ *
+ * The buffers are NRF_DFU_FLASH_WRITE_BUFFER_SIZE bytes. When the SoftDevice is not enabled,
+ * storing a buffer halts the CPU until the whole buffer is written, so only
+ * NRF_DFU_FLASH_NVMC_WRITE_BUFFER_SIZE bytes of each buffer are used.
+ *
+ * @param[in]  dest      The address where the data should be stored.
+ * @param[in]  p_src     Pointer to the address where the data should be copied from.
+ *                       This address can be in flash or RAM.
+ * @param[in]  len       The number of bytes to be copied from @p p_src to @p dest.
+ * @param[in]  callback  Callback function.
+ *
+ * @retval  NRF_SUCCESS             If the data was copied to the write buffers.
+ * @retval  NRF_ERROR_RESOURCES     If the data does not fit in the free write buffers, or
+ *                                  NRF_DFU_FLASH_WRITE_BUFFER_SIZE is 0, which is the default.
+ *                                  The data gathered before is being stored. Store the data
+ *                                  with @ref nrf_dfu_flash_store instead. @p callback is not
+ *                                  called.
+ */
+ret_code_t nrf_dfu_flash_store_buffered(uint32_t                     dest,
+                                        void                 const * p_src,
+                                        uint32_t                     len,
+                                        nrf_dfu_flash_callback_t     callback);
+
+
+/**@brief Function for getting the data written to flash, including the data gathered by
+ *        @ref nrf_dfu_flash_store_buffered that is not stored yet.
+ *
+ * @param[in]  addr   Flash address.
+ * @param[out] p_len  Number of bytes from @p addr that can be read at the returned address.
+ *
+ * @return  Pointer to the data in a write buffer or in flash.
+ */
+uint8_t const * nrf_dfu_flash_data_get(uint32_t addr, uint32_t * p_len);
+
+
+/**@brief Function for storing the data gathered by @ref nrf_dfu_flash_store_buffered.
+ *
+ * @retval  NRF_SUCCESS         If all the write buffers are stored or being stored.
+ * @retval  NRF_ERROR_NO_MEM    If nrf_fstorage is out of memory. Call the function again later.
+ */
+ret_code_t nrf_dfu_flash_buffers_flush(void);
+
+
+/**@brief Function for dropping the data gathered by @ref nrf_dfu_flash_store_buffered that is not
+ *        being stored yet.
+ *
+ * The data being stored is still written to flash, but it is no longer returned by
+ * @ref nrf_dfu_flash_data_get.
+ */
+void nrf_dfu_flash_buffers_discard(void);
+
+
 /**@brief Function for erasing data from flash.
  *
  * This functions is asynchronous when the SoftDevice is enabled and synchronous when
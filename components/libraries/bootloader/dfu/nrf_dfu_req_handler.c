@@ -75,6 +75,14 @@ STATIC_ASSERT(DFU_SIGNED_COMMAND_SIZE <= INIT_COMMAND_MAX_SIZE);
 
 static uint32_t m_firmware_start_addr;          /**< Start address of the current firmware image. */
 static uint32_t m_firmware_size_req;            /**< The size of the entire firmware image. Defined by the init command. */
+static uint32_t m_crc_offset;                   /**< Offset in the firmware image up to which its CRC is computed. */
+
+static nrf_dfu_timestamp_func_t m_timestamp_func;   /**< Time stamp function, or NULL. */
+static uint32_t                 m_ticks_per_s;      /**< Ticks per second of the time stamp function. */
+static bool                     m_data_started;     /**< Whether a data object was created in this DFU process. */
+static uint32_t                 m_data_start;       /**< Time stamp of the creation of the first data object. */
+static uint32_t                 m_data_ticks;       /**< Ticks from the first data object creation to the last execution. */
+static uint32_t                 m_data_bytes;       /**< Number of bytes in the data objects executed. */
 
 static nrf_dfu_observer_t m_observer;
 
@@ -89,6 +97,42 @@ static void on_dfu_complete(nrf_fstorage_evt_t * p_evt)
 }
 
 
+/**@brief Function for adding the firmware image data received since the last call to its CRC.
+ *
+ * @details Data written through the flash write buffers is added to the CRC only when the CRC is
+ *          needed, from the write buffers or from flash.
+ */
+static void data_crc_update(void)
+{
+    uint32_t const offset = s_dfu_settings.progress.firmware_image_offset;
+
+    while (m_crc_offset < offset)
+    {
+        uint32_t const  addr = m_firmware_start_addr + s_dfu_settings.write_offset - (offset - m_crc_offset);
+        uint32_t        len;
+        uint8_t const * p_data = nrf_dfu_flash_data_get(addr, &len);
+
+        len = MIN(len, offset - m_crc_offset);
+        s_dfu_settings.progress.firmware_image_crc =
+            crc32_compute(p_data, len, &s_dfu_settings.progress.firmware_image_crc);
+        m_crc_offset += len;
+    }
+}
+
+
+/**@brief Function for measuring the data rate when a data object is executed. */
+static void data_rate_update(uint32_t object_size)
+{
+    if (m_data_started)
+    {
+        m_data_bytes += object_size;
+        m_data_ticks  = m_timestamp_func() - m_data_start;
+
+        NRF_LOG_INFO("Data rate: %d bytes/s.", nrf_dfu_req_handler_data_rate_get());
+    }
+}
+
+
 static nrf_dfu_result_t ext_err_code_handle(nrf_dfu_result_t ret_val)
 {
     if (ret_val < NRF_DFU_RES_CODE_EXT_ERROR)
@@ -264,6 +308,10 @@ static void on_cmd_obj_create_request(nrf_dfu_request_t * p_req, nrf_dfu_respons
 
     m_observer(NRF_DFU_EVT_DFU_STARTED);
 
+    m_data_started = false;
+    m_data_bytes   = 0;
+    m_data_ticks   = 0;
+
     nrf_dfu_result_t ret_val = nrf_dfu_validation_init_cmd_create(p_req->create.object_size);
     p_res->result = ext_err_code_handle(ret_val);
 }
@@ -308,6 +356,7 @@ static void on_cmd_obj_execute_request(nrf_dfu_request_t const * p_req, nrf_dfu_
 
     if (p_res->result == NRF_DFU_RES_CODE_SUCCESS)
     {
+        data_crc_update();
         if (nrf_dfu_settings_write_and_backup(NULL) == NRF_SUCCESS)
         {
             /* Setting DFU to initialized */
@@ -383,6 +432,8 @@ static void on_data_obj_select_request(nrf_dfu_request_t * p_req, nrf_dfu_respon
 {
     NRF_LOG_DEBUG("Handle NRF_DFU_OP_OBJECT_SELECT (data)");
 
+    data_crc_update();
+
     p_res->select.crc    = s_dfu_settings.progress.firmware_image_crc;
     p_res->select.offset = s_dfu_settings.progress.firmware_image_offset;
 
@@ -447,6 +498,16 @@ static void on_data_obj_create_request(nrf_dfu_request_t * p_req, nrf_dfu_respon
     s_dfu_settings.progress.firmware_image_crc    = s_dfu_settings.progress.firmware_image_crc_last;
     s_dfu_settings.progress.firmware_image_offset = s_dfu_settings.progress.firmware_image_offset_last;
     s_dfu_settings.write_offset                   = s_dfu_settings.progress.firmware_image_offset_last;
+    m_crc_offset                                  = s_dfu_settings.progress.firmware_image_offset_last;
+
+    /* Data of a previous attempt at this object must not be written after the erase. */
+    nrf_dfu_flash_buffers_discard();
+
+    if (!m_data_started && (m_timestamp_func != NULL))
+    {
+        m_data_started = true;
+        m_data_start   = m_timestamp_func();
+    }
 
     /* Erase the page we're at. */
     if (nrf_dfu_flash_erase((m_firmware_start_addr + s_dfu_settings.progress.firmware_image_offset),
@@ -487,16 +548,33 @@ static void on_data_obj_write_request(nrf_dfu_request_t * p_req, nrf_dfu_respons
     }
 
     uint32_t const write_addr = m_firmware_start_addr + s_dfu_settings.write_offset;
-    /* CRC must be calculated before handing off the data to fstorage because the data is
-     * freed on write completion.
-     */
-    uint32_t const next_crc =
-        crc32_compute(p_req->write.p_data, p_req->write.len, &s_dfu_settings.progress.firmware_image_crc);
 
     ASSERT(p_req->callback.write);
 
+    /* With the write buffers enabled, consecutive packets are gathered in larger writes, so that
+     * the transport buffer is released right away and several writes are in progress. The data
+     * is added to the CRC only when the CRC is needed.
+     */
     ret_code_t ret =
-        nrf_dfu_flash_store(write_addr, p_req->write.p_data, p_req->write.len, p_req->callback.write);
+        nrf_dfu_flash_store_buffered(write_addr, p_req->write.p_data, p_req->write.len, p_req->callback.write);
+
+    if (ret == NRF_ERROR_RESOURCES)
+    {
+        /* CRC must be calculated before handing off the data to fstorage because the data is
+         * freed on write completion.
+         */
+        data_crc_update();
+
+        uint32_t const next_crc =
+            crc32_compute(p_req->write.p_data, p_req->write.len, &s_dfu_settings.progress.firmware_image_crc);
+
+        ret = nrf_dfu_flash_store(write_addr, p_req->write.p_data, p_req->write.len, p_req->callback.write);
+        if (ret == NRF_SUCCESS)
+        {
+            s_dfu_settings.progress.firmware_image_crc  = next_crc;
+            m_crc_offset                               += p_req->write.len;
+        }
+    }
 
     if (ret != NRF_SUCCESS)
     {
@@ -508,13 +586,13 @@ static void on_data_obj_write_request(nrf_dfu_request_t * p_req, nrf_dfu_respons
         return;
     }
 
-    /* Update the CRC of the firmware image. */
     s_dfu_settings.write_offset                   += p_req->write.len;
     s_dfu_settings.progress.firmware_image_offset += p_req->write.len;
-    s_dfu_settings.progress.firmware_image_crc     = next_crc;
 
     /* This is only used when the PRN is triggered and the 'write' message
      * is answered with a CRC message and these field are copied into the response.
+     * The CRC is up to date here only if the data was not buffered; the transports call
+     * nrf_dfu_req_handler_write_crc_update() to update it.
      */
     p_res->write.crc    = s_dfu_settings.progress.firmware_image_crc;
     p_res->write.offset = s_dfu_settings.progress.firmware_image_offset;
@@ -524,6 +602,9 @@ static void on_data_obj_write_request(nrf_dfu_request_t * p_req, nrf_dfu_respons
 static void on_data_obj_crc_request(nrf_dfu_request_t * p_req, nrf_dfu_response_t * p_res)
 {
     NRF_LOG_DEBUG("Handle NRF_DFU_OP_CRC_GET (data)");
+
+    data_crc_update();
+
     NRF_LOG_DEBUG("Offset:%d, CRC:0x%08x",
                  s_dfu_settings.progress.firmware_image_offset,
                  s_dfu_settings.progress.firmware_image_crc);
@@ -541,7 +622,7 @@ static void on_data_obj_execute_request_sched(void * p_evt, uint16_t event_lengt
     nrf_dfu_request_t * p_req = (nrf_dfu_request_t *)(p_evt);
 
     /* Wait for all buffers to be written in flash. */
-    if (nrf_fstorage_is_busy(NULL))
+    if ((nrf_dfu_flash_buffers_flush() != NRF_SUCCESS) || nrf_fstorage_is_busy(NULL))
     {
         ret = app_sched_event_put(p_req, sizeof(nrf_dfu_request_t), on_data_obj_execute_request_sched);
         if (ret != NRF_SUCCESS)
@@ -611,6 +692,9 @@ static bool on_data_obj_execute_request(nrf_dfu_request_t * p_req, nrf_dfu_respo
         return true;
     }
 
+    data_rate_update(data_object_size);
+    data_crc_update();
+
     /* Update the offset and crc values for the last object written. */
     s_dfu_settings.progress.data_object_size           = 0;
     s_dfu_settings.progress.firmware_image_crc_last    = s_dfu_settings.progress.firmware_image_crc;
@@ -855,7 +939,8 @@ ret_code_t nrf_dfu_req_handler_init(nrf_dfu_observer_t observer)
         }
     }
 
-    m_observer = observer;
+    m_observer   = observer;
+    m_crc_offset = s_dfu_settings.progress.firmware_image_offset;
 
     /* Initialize extended error handling with "No error" as the most recent error. */
     result = ext_error_set(NRF_DFU_EXT_ERROR_NO_ERROR);
@@ -863,3 +948,36 @@ ret_code_t nrf_dfu_req_handler_init(nrf_dfu_observer_t observer)
 
     return NRF_SUCCESS;
 }
+
+
+void nrf_dfu_req_handler_write_crc_update(nrf_dfu_response_t * p_res)
+{
+    ASSERT(p_res);
+
+    /* The offset of a write which was not stored is not set. */
+    if (p_res->write.offset == s_dfu_settings.progress.firmware_image_offset)
+    {
+        data_crc_update();
+        p_res->write.crc = s_dfu_settings.progress.firmware_image_crc;
+    }
+}
+
+
+void nrf_dfu_req_handler_timestamp_func_set(nrf_dfu_timestamp_func_t timestamp_func,
+                                            uint32_t                 ticks_per_s)
+{
+    m_ticks_per_s    = ticks_per_s;
+    m_timestamp_func = timestamp_func;
+    m_data_started   = false;
+}
+
+
+uint32_t nrf_dfu_req_handler_data_rate_get(void)
+{
+    if (m_data_ticks == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(((uint64_t)m_data_bytes * m_ticks_per_s) / m_data_ticks);
+}
@@ -175,7 +175,7 @@ typedef struct
 typedef struct
 {
     uint32_t offset;                    //!< Used only when packet receipt notification is used.
-    uint32_t crc;                       //!< Used only when packet receipt notification is used.
+    uint32_t crc;                       //!< Used only when packet receipt notification is used. Set by @ref nrf_dfu_req_handler_write_crc_update.
 } nrf_dfu_response_write_t;
 
 /**
@@ -285,6 +285,9 @@ typedef struct
 
 typedef void (*nrf_dfu_response_callback_t)(nrf_dfu_response_t * p_res, void * p_context);
 
+/**@brief Time stamp function type, see @ref nrf_dfu_req_handler_timestamp_func_set. */
+typedef uint32_t (*nrf_dfu_timestamp_func_t)(void);
+
 /**
  *@brief DFU request.
  */
@@ -334,6 +337,36 @@ ret_code_t nrf_dfu_req_handler_init(nrf_dfu_observer_t observer);
 ret_code_t nrf_dfu_req_handler_on_req(nrf_dfu_request_t * p_req);
 
 
+/**@brief  Function for setting the CRC of a response to a data object write request.
+ *
+ * The CRC of the firmware image is computed only when it is needed, over the data gathered in
+ * the flash write buffers or stored in flash. The transports call this function in the response
+ * callback, for the write responses they answer with a packet receipt notification.
+ *
+ * @param[in,out] p_res  Response to an @ref NRF_DFU_OP_OBJECT_WRITE request.
+ */
+void nrf_dfu_req_handler_write_crc_update(nrf_dfu_response_t * p_res);
+
+
+/**@brief  Function for setting the time stamp function used to measure the data rate.
+ *
+ * @param[in] timestamp_func  Function returning a free-running tick counter, or NULL.
+ * @param[in] ticks_per_s     Number of ticks per second of the counter.
+ */
+void nrf_dfu_req_handler_timestamp_func_set(nrf_dfu_timestamp_func_t timestamp_func,
+                                            uint32_t                 ticks_per_s);
+
+
+/**@brief  Function for getting the rate of the firmware image transfer.
+ *
+ * The rate is measured from the creation of the first data object to the execution of the
+ * last one, in the current DFU process.
+ *
+ * @return Bytes per second, or 0 if no data object is executed yet or no time stamp function is set.
+ */
+uint32_t nrf_dfu_req_handler_data_rate_get(void);
+
+
 ANON_UNIONS_DISABLE;
 
 #ifdef __cplusplus
@@ -173,6 +173,8 @@ void dfu_req_handler_rsp_clbk(nrf_dfu_response_t * p_res, void * p_context)
             /* Reply with a CRC message and reset the packet counter. */
             p_transport->pkt_notif_target_count = p_transport->pkt_notif_target;
 
+            nrf_dfu_req_handler_write_crc_update(p_res);
+
             p_res->request    = NRF_DFU_OP_CRC_GET;
             p_res->crc.offset = p_res->write.offset;
             p_res->crc.crc    = p_res->write.crc;
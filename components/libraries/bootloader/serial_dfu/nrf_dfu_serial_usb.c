@@ -159,10 +159,11 @@ static ret_code_t rsp_send(uint8_t const * p_data, uint32_t length)
 static void on_rx_complete(nrf_dfu_serial_t * p_transport, uint8_t * p_data, uint8_t len)
 {
     ret_code_t ret_code;
+    uint32_t   consumed;
 
-    for (uint32_t i = 0; i < len; i++)
+    for (uint32_t i = 0; i < len; i += consumed)
     {
-        ret_code = slip_decode_add_byte(&m_slip, p_data[i]);
+        ret_code = slip_decode_buf(&m_slip, &p_data[i], len - i, &consumed);
         if (ret_code != NRF_SUCCESS)
         {
             continue;
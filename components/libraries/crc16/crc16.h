@@ -56,6 +56,19 @@
 extern "C" {
 #endif
 
+/**@anchor CRC16_ENGINES
+ * @name CRC-16 engines
+ * @brief Implementations of @ref crc16_compute, selected with CRC16_ENGINE in sdk_config.h.
+ *
+ * @details The engines trade code size for speed. They give the same results.
+ * @{
+ */
+#define CRC16_ENGINE_BITWISE     0   //!< One bit per iteration. No table. This is the default.
+#define CRC16_ENGINE_TABLE       1   //!< One byte per iteration, using a 512 bytes table.
+#define CRC16_ENGINE_SLICE_BY_4  2   //!< One word per iteration, using 2 kB of tables.
+#define CRC16_ENGINE_SLICE_BY_8  3   //!< Two words per iteration, using 4 kB of tables.
+/** @} */
+
 /**@brief Function for calculating CRC-16 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
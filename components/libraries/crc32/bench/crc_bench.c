@@ -0,0 +1,243 @@
+/**
+ * Copyright (c) 2013 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Benchmark and cross-check of the CRC-32 and CRC-16 engines.
+ *
+ * Build it on host from this directory. Each engine is compiled from the module sources
+ * under its own name:
+ *   L=../..; for e in 0 1 2 3; do
+ *       cc -O2 -Ihost -I$L/bench_host -I.. -I$L/util -c ../crc32.c \
+ *          -DCRC32_ENGINE=$e -Dcrc32_compute=crc32_compute_$e -o crc32_$e.o
+ *       cc -O2 -Ihost -I$L/bench_host -I$L/crc16 -I$L/util -c $L/crc16/crc16.c \
+ *          -DCRC16_ENGINE=$e -Dcrc16_compute=crc16_compute_$e -o crc16_$e.o
+ *   done
+ *   cc -O2 -I$L/bench_host -I.. -I$L/crc16 crc_bench.c crc32_?.o crc16_?.o $L/bench_host/bench.c \
+ *      -o crc_bench
+ *
+ * Usage: crc_bench [minimum time per measurement in ms]
+ *
+ * Every engine is first checked against the bitwise engine on data of random size, alignment
+ * and block split, then the throughput of each engine is measured on buffers from 16 B to 1 MB.
+ * The exit status is non-zero if any check fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "crc32.h"
+#include "crc16.h"
+#include "bench.h"
+
+
+#define ENGINE_COUNT        4
+#define MAX_SIZE            (1024 * 1024)
+#define CHECK_ROUNDS        20000
+#define CHECK_MAX_SIZE      1024
+
+uint32_t crc32_compute_0(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+uint32_t crc32_compute_1(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+uint32_t crc32_compute_2(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+uint32_t crc32_compute_3(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+uint16_t crc16_compute_0(uint8_t const * p_data, uint32_t size, uint16_t const * p_crc);
+uint16_t crc16_compute_1(uint8_t const * p_data, uint32_t size, uint16_t const * p_crc);
+uint16_t crc16_compute_2(uint8_t const * p_data, uint32_t size, uint16_t const * p_crc);
+uint16_t crc16_compute_3(uint8_t const * p_data, uint32_t size, uint16_t const * p_crc);
+
+typedef uint32_t (*crc32_fn_t)(uint8_t const *, uint32_t, uint32_t const *);
+typedef uint16_t (*crc16_fn_t)(uint8_t const *, uint32_t, uint16_t const *);
+
+static const char * const m_engine_name[ENGINE_COUNT] =
+{
+    [CRC32_ENGINE_BITWISE]    = "bitwise",
+    [CRC32_ENGINE_TABLE]      = "table",
+    [CRC32_ENGINE_SLICE_BY_4] = "slice-by-4",
+    [CRC32_ENGINE_SLICE_BY_8] = "slice-by-8",
+};
+
+static const crc32_fn_t m_crc32[ENGINE_COUNT] =
+{
+    crc32_compute_0, crc32_compute_1, crc32_compute_2, crc32_compute_3,
+};
+
+static const crc16_fn_t m_crc16[ENGINE_COUNT] =
+{
+    crc16_compute_0, crc16_compute_1, crc16_compute_2, crc16_compute_3,
+};
+
+// Word-aligned, with room for misaligning the start of the data.
+static uint32_t m_buf[(MAX_SIZE + 8) / sizeof(uint32_t)];
+static uint32_t volatile m_sink;
+
+
+// Compute the CRC of the data in up to three blocks, to exercise the p_crc chaining.
+static uint32_t crc32_split(crc32_fn_t fn, uint8_t const * p_data, uint32_t size, uint32_t cut1, uint32_t cut2)
+{
+    uint32_t crc = fn(p_data, cut1, NULL);
+    crc = fn(p_data + cut1, cut2 - cut1, &crc);
+    return fn(p_data + cut2, size - cut2, &crc);
+}
+
+
+static uint16_t crc16_split(crc16_fn_t fn, uint8_t const * p_data, uint32_t size, uint32_t cut1, uint32_t cut2)
+{
+    uint16_t crc = fn(p_data, cut1, NULL);
+    crc = fn(p_data + cut1, cut2 - cut1, &crc);
+    return fn(p_data + cut2, size - cut2, &crc);
+}
+
+
+static uint32_t check(void)
+{
+    static uint8_t const check_str[] = "123456789";
+    uint8_t  const * const p_buf  = (uint8_t const *)m_buf;
+    uint32_t               errors = 0;
+
+    // Standard check values of CRC-32 and of CRC-16/CCITT-FALSE.
+    for (uint32_t e = 0; e < ENGINE_COUNT; e++)
+    {
+        if (m_crc32[e](check_str, 9, NULL) != 0xCBF43926)
+        {
+            printf("crc32 %s: wrong check value\n", m_engine_name[e]);
+            errors++;
+        }
+        if (m_crc16[e](check_str, 9, NULL) != 0x29B1)
+        {
+            printf("crc16 %s: wrong check value\n", m_engine_name[e]);
+            errors++;
+        }
+    }
+
+    for (uint32_t round = 0; round < CHECK_ROUNDS; round++)
+    {
+        uint32_t const offset = (uint32_t)rand() % 8;
+        uint32_t const size   = (uint32_t)rand() % (CHECK_MAX_SIZE + 1);
+        uint32_t       cut1   = (size > 0) ? (uint32_t)rand() % (size + 1) : 0;
+        uint32_t       cut2   = (size > 0) ? (uint32_t)rand() % (size + 1) : 0;
+
+        if (cut1 > cut2)
+        {
+            uint32_t const tmp = cut1;
+            cut1 = cut2;
+            cut2 = tmp;
+        }
+
+        uint32_t const ref32 = m_crc32[0](p_buf + offset, size, NULL);
+        uint16_t const ref16 = m_crc16[0](p_buf + offset, size, NULL);
+
+        for (uint32_t e = 0; e < ENGINE_COUNT; e++)
+        {
+            if (crc32_split(m_crc32[e], p_buf + offset, size, cut1, cut2) != ref32)
+            {
+                printf("crc32 %s: mismatch, offset %u size %u blocks %u/%u/%u\n",
+                       m_engine_name[e], offset, size, cut1, cut2 - cut1, size - cut2);
+                errors++;
+            }
+            if (crc16_split(m_crc16[e], p_buf + offset, size, cut1, cut2) != ref16)
+            {
+                printf("crc16 %s: mismatch, offset %u size %u blocks %u/%u/%u\n",
+                       m_engine_name[e], offset, size, cut1, cut2 - cut1, size - cut2);
+                errors++;
+            }
+        }
+    }
+
+    return errors;
+}
+
+
+// Returns the throughput in MB/s.
+static double measure(uint32_t engine, bool crc32, uint32_t size, uint64_t min_ns)
+{
+    uint8_t const * const p_buf = (uint8_t const *)m_buf;
+    uint64_t              bytes = 0;
+    uint64_t              start = bench_now_ns();
+    uint64_t              elapsed;
+
+    do
+    {
+        // Repeat small sizes so that the clock is not read after every call.
+        for (uint32_t done = 0; done < 256 * 1024; done += size)
+        {
+            m_sink += crc32 ? m_crc32[engine](p_buf, size, NULL) : m_crc16[engine](p_buf, size, NULL);
+            bytes  += size;
+        }
+        elapsed = bench_now_ns() - start;
+    } while (elapsed < min_ns);
+
+    return ((double)bytes / 1e6) / ((double)elapsed / 1e9);
+}
+
+
+int main(int argc, char ** argv)
+{
+    uint64_t const min_ns = ((argc > 1) ? strtoull(argv[1], NULL, 0) : 100) * 1000000ULL;
+
+    srand(1);
+    for (uint32_t i = 0; i < sizeof(m_buf) / sizeof(m_buf[0]); i++)
+    {
+        m_buf[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    }
+
+    uint32_t const errors = check();
+    printf("cross-check: %u rounds, %u errors\n", CHECK_ROUNDS, errors);
+
+    for (uint32_t crc = 0; crc < 2; crc++)
+    {
+        printf("\n--- %s throughput, MB/s ---\n%10s", (crc == 0) ? "crc32" : "crc16", "size");
+        for (uint32_t e = 0; e < ENGINE_COUNT; e++)
+        {
+            printf("%12s", m_engine_name[e]);
+        }
+        printf("\n");
+
+        for (uint32_t size = 16; size <= MAX_SIZE; size *= 4)
+        {
+            printf("%10u", size);
+            for (uint32_t e = 0; e < ENGINE_COUNT; e++)
+            {
+                printf("%12.1f", measure(e, (crc == 0), size, min_ns));
+            }
+            printf("\n");
+        }
+    }
+
+    return (errors == 0) ? 0 : 1;
+}
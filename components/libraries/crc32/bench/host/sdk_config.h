@@ -0,0 +1,10 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of the CRC modules used by crc_bench.
+// The engines are selected on the command line.
+
+#define CRC16_ENABLED 1
+#define CRC32_ENABLED 1
+
+#endif // SDK_CONFIG_H
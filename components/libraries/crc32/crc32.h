@@ -55,6 +55,19 @@
 extern "C" {
 #endif
 
+/**@anchor CRC32_ENGINES
+ * @name CRC-32 engines
+ * @brief Implementations of @ref crc32_compute, selected with CRC32_ENGINE in sdk_config.h.
+ *
+ * @details The engines trade code size for speed. They give the same results.
+ * @{
+ */
+#define CRC32_ENGINE_BITWISE     0   //!< One bit per iteration. No table. This is the default.
+#define CRC32_ENGINE_TABLE       1   //!< One byte per iteration, using a 1 kB table.
+#define CRC32_ENGINE_SLICE_BY_4  2   //!< One word per iteration, using 4 kB of tables.
+#define CRC32_ENGINE_SLICE_BY_8  3   //!< Two words per iteration, using 8 kB of tables.
+/** @} */
+
 /**@brief Function for calculating CRC-32 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
@@ -0,0 +1,638 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Benchmark of fds on the RAM implementation of fstorage.
+ *
+ * Build it on host from this directory:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I$L/fstorage -I$L/util -I$L/atomic -I$L/experimental_section_vars \
+ *      -I$L/log -I$L/log/src -I$L/strerror ../fds.c $L/fstorage/nrf_fstorage.c \
+ *      $L/fstorage/nrf_fstorage_ram.c $L/atomic/nrf_atomic.c fds_bench.c -o fds_bench
+ *
+ * Add -DFDS_RECORD_INDEX_SIZE=<records>, -DFDS_GC_STEP_WORDS=<words> and -DFDS_GC_AUTO_THRESHOLD=<percent>
+ * to compare the fds configurations.
+ *
+ * Usage: fds_bench [records] [operations] [record size in words] [idle time between operations in us] [file]
+ *
+ * The store is filled with the given number of records, then a mixed workload of updates, finds, deletes and
+ * writes is run on it. Flash operations are deferred and charged nRF52 NVMC timings on a simulated clock;
+ * the application is idle for the given time between operations, so that background garbage collection can
+ * make progress. If a file is given, the flash content is kept in it across runs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "sdk_config.h"
+#include "fds.h"
+#include "fds_internal_defs.h"
+#include "nrf_fstorage_ram.h"
+
+
+#define BENCH_PAGE_SIZE         (FDS_VIRTUAL_PAGE_SIZE * sizeof(uint32_t))
+#define BENCH_FLASH_SIZE        (FDS_VIRTUAL_PAGES * BENCH_PAGE_SIZE)
+#define BENCH_FILES             8
+#define BENCH_MAX_RECORDS       8192
+#define BENCH_MAX_RECORD_WORDS  256
+
+// nRF52832 NVMC timings.
+#define BENCH_WRITE_WORD_NS     41000
+#define BENCH_ERASE_PAGE_NS     85000000
+#define BENCH_OP_NS             10000
+
+
+typedef enum
+{
+    BENCH_OP_WRITE,
+    BENCH_OP_UPDATE,
+    BENCH_OP_DELETE,
+    BENCH_OP_FIND,
+    BENCH_OP_ITERATE,
+    BENCH_OP_CNT
+} bench_op_t;
+
+static char const * const m_op_names[BENCH_OP_CNT] =
+{
+    "write", "update", "delete", "find+read", "find_in_file"
+};
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t sim_ns;            // Simulated time from the call to the event.
+    uint64_t sim_max_ns;
+    uint64_t cpu_ns;            // Host time spent in the call and in the flash emulation.
+} bench_op_stat_t;
+
+
+static uint32_t         m_records;
+static uint32_t         m_record_words;
+static uint64_t         m_idle_ns;
+
+static uint32_t         m_version[BENCH_MAX_RECORDS];   // Expected data of each record; 0 if deleted.
+static uint32_t         m_data[BENCH_MAX_RECORD_WORDS];
+static uint32_t         m_erase_count[FDS_VIRTUAL_PAGES];
+static bench_op_stat_t  m_op_stat[BENCH_OP_CNT];
+
+static fds_evt_id_t     m_wait_id;
+static bool volatile    m_wait_done;
+static ret_code_t       m_wait_result;
+static uint32_t         m_gc_events;
+static uint32_t         m_no_space;
+static uint32_t         m_errors;
+static uint64_t         m_user_bytes;
+static uint64_t         m_sim_base_ns;      // Simulated time spent idle.
+static uint32_t         m_rand = 1;
+
+
+static uint32_t bench_rand(void)
+{
+    m_rand = m_rand * 1103515245 + 12345;
+    return (m_rand >> 8);
+}
+
+
+static uint64_t cpu_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+static uint64_t sim_time_ns(void)
+{
+    nrf_fstorage_ram_stat_t stat;
+    nrf_fstorage_ram_stat_get(&stat);
+    return stat.time_ns + m_sim_base_ns;
+}
+
+
+static void fds_evt_handler(fds_evt_t const * p_evt)
+{
+    if (p_evt->id == FDS_EVT_GC)
+    {
+        m_gc_events++;
+    }
+
+    if (p_evt->id == m_wait_id)
+    {
+        m_wait_done   = true;
+        m_wait_result = p_evt->result;
+    }
+}
+
+
+static void wait_prepare(fds_evt_id_t id)
+{
+    m_wait_id   = id;
+    m_wait_done = false;
+}
+
+
+// Run the flash until the awaited event is received.
+static ret_code_t wait_event(void)
+{
+    while (!m_wait_done)
+    {
+        if (!nrf_fstorage_ram_process())
+        {
+            printf("fds stalled waiting for event %d\n", m_wait_id);
+            exit(1);
+        }
+    }
+
+    return m_wait_result;
+}
+
+
+// Let the application be idle; background operations run meanwhile.
+static void idle(void)
+{
+    uint64_t const end = sim_time_ns() + m_idle_ns;
+
+    while (sim_time_ns() < end)
+    {
+        if (!nrf_fstorage_ram_process())
+        {
+            m_sim_base_ns += end - sim_time_ns();
+            break;
+        }
+    }
+}
+
+
+static void record_prepare(fds_record_t * p_record, uint32_t index, uint32_t version)
+{
+    for (uint32_t i = 0; i < m_record_words; i++)
+    {
+        m_data[i] = version ^ (index << 16) ^ i;
+    }
+
+    p_record->file_id           = 1 + (index % BENCH_FILES);
+    p_record->key               = 1 + (index / BENCH_FILES);
+    p_record->data.p_data       = m_data;
+    p_record->data.length_words = m_record_words;
+}
+
+
+static bool record_find(uint32_t index, fds_record_desc_t * p_desc)
+{
+    fds_find_token_t token = {0};
+
+    return (fds_record_find(1 + (index % BENCH_FILES), 1 + (index / BENCH_FILES), p_desc, &token) == FDS_SUCCESS);
+}
+
+
+// Run a write or an update. Run garbage collection in the foreground if flash is full.
+static ret_code_t record_store(bench_op_t op, fds_record_desc_t * p_desc, uint32_t index, uint32_t version)
+{
+    fds_record_t record;
+    ret_code_t   ret;
+
+    record_prepare(&record, index, version);
+
+    for (int retry = 0; retry < 2; retry++)
+    {
+        wait_prepare((op == BENCH_OP_WRITE) ? FDS_EVT_WRITE : FDS_EVT_UPDATE);
+
+        ret = (op == BENCH_OP_WRITE) ? fds_record_write(p_desc, &record) : fds_record_update(p_desc, &record);
+        if (ret == FDS_SUCCESS)
+        {
+            ret = wait_event();
+        }
+
+        if (ret != FDS_ERR_NO_SPACE_IN_FLASH)
+        {
+            break;
+        }
+
+        m_no_space++;
+
+        wait_prepare(FDS_EVT_GC);
+        if (fds_gc() == FDS_SUCCESS)
+        {
+            (void) wait_event();
+        }
+    }
+
+    if (ret == FDS_SUCCESS)
+    {
+        m_user_bytes += (m_record_words + 3) * sizeof(uint32_t);
+    }
+
+    return ret;
+}
+
+
+static bool record_verify(fds_record_desc_t * p_desc, uint32_t index)
+{
+    fds_flash_record_t flash_record;
+    fds_record_t       record;
+    bool               ok;
+
+    if (fds_record_open(p_desc, &flash_record) != FDS_SUCCESS)
+    {
+        return false;
+    }
+
+    record_prepare(&record, index, m_version[index]);
+
+    ok =    (flash_record.p_header->length_words == m_record_words)
+         && (memcmp(flash_record.p_data, m_data, m_record_words * sizeof(uint32_t)) == 0);
+
+    (void) fds_record_close(p_desc);
+
+    return ok;
+}
+
+
+static void op_run(bench_op_t op, uint32_t index)
+{
+    fds_record_desc_t desc     = {0};
+    uint64_t const    sim_start = sim_time_ns();
+    uint64_t const    cpu_start = cpu_time_ns();
+    bool              ok        = true;
+
+    switch (op)
+    {
+        case BENCH_OP_WRITE:
+            ok = (record_store(op, &desc, index, m_version[index] + 1) == FDS_SUCCESS);
+            if (ok)
+            {
+                m_version[index]++;
+            }
+            break;
+
+        case BENCH_OP_UPDATE:
+            ok = record_find(index, &desc)
+              && (record_store(op, &desc, index, m_version[index] + 1) == FDS_SUCCESS);
+            if (ok)
+            {
+                m_version[index]++;
+            }
+            break;
+
+        case BENCH_OP_DELETE:
+            wait_prepare(FDS_EVT_DEL_RECORD);
+            ok = record_find(index, &desc)
+              && (fds_record_delete(&desc) == FDS_SUCCESS)
+              && (wait_event() == FDS_SUCCESS);
+            if (ok)
+            {
+                m_version[index] = 0;
+            }
+            break;
+
+        case BENCH_OP_FIND:
+            ok = record_find(index, &desc) && record_verify(&desc, index);
+            break;
+
+        case BENCH_OP_ITERATE:
+        {
+            fds_find_token_t token    = {0};
+            uint16_t const   file_id  = 1 + (index % BENCH_FILES);
+            uint32_t         expected = 0;
+            uint32_t         found    = 0;
+
+            for (uint32_t i = index % BENCH_FILES; i < m_records; i += BENCH_FILES)
+            {
+                expected += (m_version[i] != 0);
+            }
+
+            while (fds_record_find_in_file(file_id, &desc, &token) == FDS_SUCCESS)
+            {
+                found++;
+            }
+
+            ok = (found == expected);
+        } break;
+
+        default:
+            break;
+    }
+
+    bench_op_stat_t * const p_stat = &m_op_stat[op];
+    uint64_t          const sim_ns = sim_time_ns() - sim_start;
+
+    p_stat->count++;
+    p_stat->sim_ns += sim_ns;
+    p_stat->cpu_ns += cpu_time_ns() - cpu_start;
+    if (sim_ns > p_stat->sim_max_ns)
+    {
+        p_stat->sim_max_ns = sim_ns;
+    }
+
+    if (!ok)
+    {
+        if (m_errors++ < 10)
+        {
+            printf("%s of record %u failed\n", m_op_names[op], index);
+        }
+    }
+}
+
+
+static void * flash_map(char const * p_path, bool * p_fresh)
+{
+    void * p_mem;
+    int    fd = -1;
+    int    flags = MAP_32BIT;
+
+    if (p_path != NULL)
+    {
+        fd = open(p_path, O_RDWR | O_CREAT, 0644);
+        if ((fd < 0) || (ftruncate(fd, BENCH_FLASH_SIZE) != 0))
+        {
+            perror(p_path);
+            exit(1);
+        }
+        flags |= MAP_SHARED;
+    }
+    else
+    {
+        flags |= MAP_PRIVATE | MAP_ANONYMOUS;
+    }
+
+    // fstorage addresses are 32-bit, the memory must be mapped in the low 4 GB.
+    p_mem = mmap(NULL, BENCH_FLASH_SIZE, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (p_mem == MAP_FAILED)
+    {
+        perror("mmap");
+        exit(1);
+    }
+
+    // A new file reads as zeroes; erase it.
+    *p_fresh = true;
+    for (uint32_t i = 0; i < BENCH_FLASH_SIZE; i++)
+    {
+        if (((uint8_t *)p_mem)[i] != 0)
+        {
+            *p_fresh = false;
+            break;
+        }
+    }
+    if (*p_fresh)
+    {
+        memset(p_mem, 0xFF, BENCH_FLASH_SIZE);
+    }
+
+    return p_mem;
+}
+
+
+static void stat_print(uint64_t sim_ns, uint64_t cpu_ns, uint32_t ops)
+{
+    nrf_fstorage_ram_stat_t flash;
+    fds_stat_t              fds;
+    uint32_t                erase_min = UINT32_MAX;
+    uint32_t                erase_max = 0;
+    uint64_t                busy_ns   = 0;
+
+    nrf_fstorage_ram_stat_get(&flash);
+    (void) fds_stat(&fds);
+
+    printf("%-13s %8s %12s %12s %12s\n", "operation", "count", "avg us", "max us", "cpu ns");
+    for (int op = 0; op < BENCH_OP_CNT; op++)
+    {
+        bench_op_stat_t const * p_stat = &m_op_stat[op];
+        if (p_stat->count == 0)
+        {
+            continue;
+        }
+        printf("%-13s %8u %12.1f %12.1f %12.0f\n", m_op_names[op], p_stat->count,
+               p_stat->sim_ns / 1000.0 / p_stat->count, p_stat->sim_max_ns / 1000.0,
+               (double)p_stat->cpu_ns / p_stat->count);
+        busy_ns += p_stat->sim_ns;
+    }
+
+    for (uint32_t i = 0; i < FDS_VIRTUAL_PAGES; i++)
+    {
+        erase_min = (m_erase_count[i] < erase_min) ? m_erase_count[i] : erase_min;
+        erase_max = (m_erase_count[i] > erase_max) ? m_erase_count[i] : erase_max;
+    }
+
+    printf("throughput    %.1f ops/s in operations, %.1f ops/s with idle time (simulated), %.0f ops/s (host)\n",
+           busy_ns ? ops * 1e9 / busy_ns : 0.0, ops * 1e9 / sim_ns, ops * 1e9 / cpu_ns);
+    printf("flash         %u writes, %u bytes written, %u page erases, %u words rewritten\n",
+           flash.writes, flash.bytes_written, flash.erases, flash.words_rewritten);
+    printf("wear          %u..%u erases per page, %.2f on average\n",
+           erase_min, erase_max, (double)flash.erases / FDS_VIRTUAL_PAGES);
+    printf("gc            %u runs, %u writes out of space, amplification %.2f (flash bytes / record bytes)\n",
+           m_gc_events, m_no_space, m_user_bytes ? (double)flash.bytes_written / m_user_bytes : 0.0);
+    printf("store         %u valid, %u dirty records, %u words used, %u freeable\n",
+           fds.valid_records, fds.dirty_records, fds.words_used, fds.freeable_words);
+}
+
+
+static void stat_clear(void)
+{
+    nrf_fstorage_ram_stat_clear();
+    memset(m_op_stat, 0x00, sizeof(m_op_stat));
+    m_gc_events   = 0;
+    m_no_space    = 0;
+    m_user_bytes  = 0;
+    m_sim_base_ns = 0;
+}
+
+
+int main(int argc, char * argv[])
+{
+    uint32_t                  ops   = 5000;
+    char const              * p_path = NULL;
+    bool                      fresh;
+    nrf_fstorage_ram_config_t config = {0};
+
+    m_records      = 1000;
+    m_record_words = 6;
+    m_idle_ns      = 2000000;
+
+    if (argc > 1) m_records      = strtoul(argv[1], NULL, 0);
+    if (argc > 2) ops            = strtoul(argv[2], NULL, 0);
+    if (argc > 3) m_record_words = strtoul(argv[3], NULL, 0);
+    if (argc > 4) m_idle_ns      = strtoull(argv[4], NULL, 0) * 1000;
+    if (argc > 5) p_path         = argv[5];
+
+    if ((m_records == 0) || (m_records > BENCH_MAX_RECORDS) ||
+        (m_record_words == 0) || (m_record_words > BENCH_MAX_RECORD_WORDS))
+    {
+        printf("usage: %s [records] [operations] [record size in words] [idle us] [file]\n", argv[0]);
+        return 1;
+    }
+
+    config.p_mem                 = flash_map(p_path, &fresh);
+    config.size                  = BENCH_FLASH_SIZE;
+    config.deferred              = true;
+    config.latency.op_ns         = BENCH_OP_NS;
+    config.latency.write_word_ns = BENCH_WRITE_WORD_NS;
+    config.latency.erase_page_ns = BENCH_ERASE_PAGE_NS;
+    config.p_erase_count         = m_erase_count;
+
+    if (nrf_fstorage_ram_config_set(&config) != NRF_SUCCESS)
+    {
+        printf("cannot use the flash memory at %p\n", config.p_mem);
+        return 1;
+    }
+
+    printf("fds: %u pages of %u bytes, record index %u, gc step %u words, gc auto threshold %u%%\n",
+           FDS_VIRTUAL_PAGES, (unsigned)BENCH_PAGE_SIZE, FDS_RECORD_INDEX_SIZE, FDS_GC_STEP_WORDS,
+           FDS_GC_AUTO_THRESHOLD);
+    printf("workload: %u records of %u words, %u operations, %u us idle\n",
+           m_records, m_record_words, ops, (unsigned)(m_idle_ns / 1000));
+
+    (void) fds_register(fds_evt_handler);
+
+    wait_prepare(FDS_EVT_INIT);
+    if ((fds_init() != FDS_SUCCESS) || (wait_event() != FDS_SUCCESS))
+    {
+        printf("fds_init failed\n");
+        return 1;
+    }
+
+    // Fill the store, or pick up the records kept in the file.
+    uint64_t cpu_start = cpu_time_ns();
+
+    for (uint32_t i = 0; i < m_records; i++)
+    {
+        fds_record_desc_t desc;
+
+        if (!fresh && record_find(i, &desc))
+        {
+            fds_flash_record_t flash_record;
+            if (fds_record_open(&desc, &flash_record) == FDS_SUCCESS)
+            {
+                m_version[i] = ((uint32_t const *)flash_record.p_data)[0] ^ (i << 16);
+                (void) fds_record_close(&desc);
+            }
+            continue;
+        }
+
+        op_run(BENCH_OP_WRITE, i);
+        idle();
+    }
+
+    printf("\n--- fill ---\n");
+    stat_print(sim_time_ns(), cpu_time_ns() - cpu_start, m_records);
+
+    stat_clear();
+    cpu_start = cpu_time_ns();
+
+    for (uint32_t n = 0; n < ops; n++)
+    {
+        uint32_t const index = bench_rand() % m_records;
+        uint32_t const pick  = bench_rand() % 100;
+
+        if (m_version[index] == 0)
+        {
+            op_run(BENCH_OP_WRITE, index);
+        }
+        else if (pick < 50)
+        {
+            op_run(BENCH_OP_UPDATE, index);
+        }
+        else if (pick < 80)
+        {
+            op_run(BENCH_OP_FIND, index);
+        }
+        else if (pick < 95)
+        {
+            op_run(BENCH_OP_DELETE, index);
+        }
+        else
+        {
+            op_run(BENCH_OP_ITERATE, index);
+        }
+
+        idle();
+    }
+
+    printf("\n--- mixed: 50%% update, 30%% find+read, 15%% delete, 5%% find_in_file, writes of deleted ---\n");
+    stat_print(sim_time_ns(), cpu_time_ns() - cpu_start, ops);
+
+    // Check every record once more.
+    for (uint32_t i = 0; i < m_records; i++)
+    {
+        fds_record_desc_t desc;
+        bool const        found = record_find(i, &desc);
+
+        if ((found != (m_version[i] != 0)) || (found && !record_verify(&desc, i)))
+        {
+            if (m_errors++ < 10)
+            {
+                printf("record %u does not match\n", i);
+            }
+        }
+    }
+
+    // Check the searches by record key alone, which go across files.
+    for (uint32_t first = 0; first < m_records; first += BENCH_FILES)
+    {
+        fds_find_token_t  token    = {0};
+        fds_record_desc_t desc;
+        uint16_t const    key      = 1 + (first / BENCH_FILES);
+        uint32_t          expected = 0;
+        uint32_t          found    = 0;
+
+        for (uint32_t i = first; (i < first + BENCH_FILES) && (i < m_records); i++)
+        {
+            expected += (m_version[i] != 0);
+        }
+
+        while (fds_record_find_by_key(key, &desc, &token) == FDS_SUCCESS)
+        {
+            found++;
+        }
+
+        if (found != expected)
+        {
+            if (m_errors++ < 10)
+            {
+                printf("key %u: %u records found, %u expected\n", key, found, expected);
+            }
+        }
+    }
+
+    printf("\n%u errors\n", m_errors);
+
+    return (m_errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of fds used by fds_bench.
+
+#define NRF_FSTORAGE_ENABLED 1
+#define NRF_FSTORAGE_PARAM_CHECK_DISABLED 0
+
+#define FDS_ENABLED 1
+#ifndef FDS_VIRTUAL_PAGES
+#define FDS_VIRTUAL_PAGES 16
+#endif
+#define FDS_VIRTUAL_PAGE_SIZE 1024
+#define FDS_VIRTUAL_PAGES_RESERVED 0
+#define FDS_BACKEND 3
+#define FDS_OP_QUEUE_SIZE 8
+#define FDS_CRC_CHECK_ON_READ 0
+#define FDS_CRC_CHECK_ON_WRITE 0
+#define FDS_MAX_USERS 4
+
+#define NRF_ATOMIC_USE_BUILD_IN 1
+
+#define NRF_LOG_ENABLED 0
+
+#endif // SDK_CONFIG_H
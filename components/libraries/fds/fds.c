@@ -54,6 +54,8 @@
 #include "nrf_fstorage_sd.h"
 #elif (FDS_BACKEND == NRF_FSTORAGE_NVMC)
 #include "nrf_fstorage_nvmc.h"
+#elif (FDS_BACKEND == NRF_FSTORAGE_RAM)
+#include "nrf_fstorage_ram.h"
 #else
 #error Invalid FDS backend.
 #endif
@@ -99,6 +101,20 @@ static fds_swap_page_t      m_swap_page;
 // Garbage collection data.
 static fds_gc_data_t        m_gc;
 
+#if (FDS_RECORD_INDEX_SIZE > 0)
+// RAM index of valid records, sorted by file ID, record key and record ID.
+// Two views hold the positions of the entries in other orders, for the searches which do not give
+// a file ID. If some records could not be indexed, searches fall back to scanning flash.
+static struct
+{
+    fds_index_entry_t entries[FDS_RECORD_INDEX_SIZE];
+    uint16_t          by_id[FDS_RECORD_INDEX_SIZE];     // Sorted by record ID.
+    uint16_t          by_key[FDS_RECORD_INDEX_SIZE];    // Sorted by record key and record ID.
+    uint32_t          count;
+    bool volatile     overflow;
+} m_index;
+#endif
+
 
 static void event_send(fds_evt_t const * const p_evt)
 {
@@ -151,7 +167,8 @@ static void event_prepare(fds_op_t const * const p_op, fds_evt_t * const p_evt)
             break;
 
         case FDS_OP_GC:
-            p_evt->id = FDS_EVT_GC;
+            p_evt->id         = FDS_EVT_GC;
+            p_evt->gc.is_auto = p_op->gc.is_auto;
             break;
 
         default:
@@ -276,15 +293,16 @@ static ret_code_t page_from_record(uint16_t * const p_page, uint32_t const * con
 // Scan a page to determine how many words have been written to it.
 // This information is used to set the page write offset during initialization.
 // Additionally, this function updates the latest record ID as it proceeds.
-// If an invalid record header is found, the can_gc argument is set to true.
+// The space taken up by invalid records is returned in the freeable_words argument.
 static void page_scan(uint32_t const *       p_addr,
                       uint16_t       * const words_written,
-                      bool           * const can_gc)
+                      uint16_t       * const freeable_words)
 {
     uint32_t const * const p_page_end = p_addr + FDS_PAGE_SIZE;
 
-    p_addr         += FDS_PAGE_TAG_SIZE;
-    *words_written  = FDS_PAGE_TAG_SIZE;
+    p_addr          += FDS_PAGE_TAG_SIZE;
+    *words_written   = FDS_PAGE_TAG_SIZE;
+    *freeable_words  = 0;
 
     fds_header_t const * p_header = (fds_header_t*)p_addr;
 
@@ -302,22 +320,20 @@ static void page_scan(uint32_t const *       p_addr,
         }
         else
         {
-            if (can_gc != NULL)
-            {
-                *can_gc = true;
-            }
-
             if (hdr == FDS_HEADER_CORRUPT)
             {
                 // It could happen that a record has a corrupt header which would set a
                 // wrong offset for this page. In such cases, update this value to its maximum,
                 // to ensure that no new records will be written to this page and to enable
                 // correct statistics reporting by fds_stat().
-                *words_written = FDS_PAGE_SIZE;
+                *freeable_words += (p_page_end - (uint32_t*)p_header);
+                *words_written   = FDS_PAGE_SIZE;
 
                 // We can't continue to scan this page.
                 return;
             }
+
+            *freeable_words += (FDS_HEADER_SIZE + p_header->length_words);
         }
 
         *words_written += (FDS_HEADER_SIZE + p_header->length_words);
@@ -455,6 +471,372 @@ static bool record_find_next(uint16_t page, uint32_t const ** p_record)
 }
 
 
+#if (FDS_RECORD_INDEX_SIZE > 0)
+
+static uint32_t index_key(uint16_t file_id, uint16_t record_key)
+{
+    return (((uint32_t)file_id << 16) | record_key);
+}
+
+
+// Return the position of the first entry which is not smaller than the given key and record ID.
+// NOTE: Must be called from within a critical section.
+static uint32_t index_lower_bound(uint32_t key, uint32_t record_id)
+{
+    uint32_t lo = 0;
+    uint32_t hi = m_index.count;
+
+    while (lo < hi)
+    {
+        uint32_t                  const mid     = lo + (hi - lo) / 2;
+        fds_index_entry_t const * const p_entry = &m_index.entries[mid];
+
+        if (   (p_entry->key < key)
+            || ((p_entry->key == key) && (p_entry->record_id < record_id)))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+
+// Return the position in m_index.by_id of the first entry whose record ID is not smaller than
+// the given one.
+// NOTE: Must be called from within a critical section.
+static uint32_t index_by_id_lower_bound(uint32_t record_id)
+{
+    uint32_t lo = 0;
+    uint32_t hi = m_index.count;
+
+    while (lo < hi)
+    {
+        uint32_t const mid = lo + (hi - lo) / 2;
+
+        if (m_index.entries[m_index.by_id[mid]].record_id < record_id)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+
+// Return the position in m_index.by_key of the first entry which is not smaller than the given
+// record key and record ID.
+// NOTE: Must be called from within a critical section.
+static uint32_t index_by_key_lower_bound(uint16_t record_key, uint32_t record_id)
+{
+    uint32_t lo = 0;
+    uint32_t hi = m_index.count;
+
+    while (lo < hi)
+    {
+        uint32_t                  const mid     = lo + (hi - lo) / 2;
+        fds_index_entry_t const * const p_entry = &m_index.entries[m_index.by_key[mid]];
+        uint16_t                  const key     = (uint16_t)p_entry->key;
+
+        if ((key < record_key) || ((key == record_key) && (p_entry->record_id < record_id)))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+
+// Insert or remove a position in a view. Positions from the given one on move by one,
+// like the entries in m_index.entries.
+// NOTE: Must be called from within a critical section.
+static void index_view_insert(uint16_t * p_view, uint32_t at, uint32_t pos)
+{
+    for (uint32_t i = 0; i < m_index.count; i++)
+    {
+        if (p_view[i] >= pos)
+        {
+            p_view[i]++;
+        }
+    }
+
+    memmove(&p_view[at + 1], &p_view[at], (m_index.count - at) * sizeof(uint16_t));
+    p_view[at] = (uint16_t)pos;
+}
+
+
+static void index_view_remove(uint16_t * p_view, uint32_t at, uint32_t pos)
+{
+    memmove(&p_view[at], &p_view[at + 1], (m_index.count - at - 1) * sizeof(uint16_t));
+
+    for (uint32_t i = 0; i < m_index.count - 1; i++)
+    {
+        if (p_view[i] > pos)
+        {
+            p_view[i]--;
+        }
+    }
+}
+
+
+// Return the position of the entry of a record, or m_index.count if it is not indexed.
+// NOTE: Must be called from within a critical section.
+static uint32_t index_pos(fds_header_t const * p_header)
+{
+    uint32_t const key = index_key(p_header->file_id, p_header->record_key);
+    uint32_t const pos = index_lower_bound(key, p_header->record_id);
+
+    if (   (pos < m_index.count)
+        && (m_index.entries[pos].key       == key)
+        && (m_index.entries[pos].record_id == p_header->record_id))
+    {
+        return pos;
+    }
+
+    return m_index.count;
+}
+
+
+// Add a record to the index. If the index is full, flag it as overflown and return false.
+static bool index_insert(fds_header_t const * p_header, uint32_t const * p_record)
+{
+    bool ret = true;
+
+    CRITICAL_SECTION_ENTER();
+    if (m_index.count < FDS_RECORD_INDEX_SIZE)
+    {
+        uint32_t const key = index_key(p_header->file_id, p_header->record_key);
+        uint32_t const pos = index_lower_bound(key, p_header->record_id);
+
+        uint32_t const id_at  = index_by_id_lower_bound(p_header->record_id);
+        uint32_t const key_at = index_by_key_lower_bound(p_header->record_key,
+                                                         p_header->record_id);
+
+        index_view_insert(m_index.by_id,  id_at,  pos);
+        index_view_insert(m_index.by_key, key_at, pos);
+
+        memmove(&m_index.entries[pos + 1], &m_index.entries[pos],
+                (m_index.count - pos) * sizeof(fds_index_entry_t));
+
+        m_index.entries[pos].key       = key;
+        m_index.entries[pos].record_id = p_header->record_id;
+        m_index.entries[pos].p_record  = p_record;
+        m_index.count++;
+    }
+    else
+    {
+        m_index.overflow = true;
+        ret              = false;
+    }
+    CRITICAL_SECTION_EXIT();
+
+    return ret;
+}
+
+
+static void index_remove(fds_header_t const * p_header)
+{
+    CRITICAL_SECTION_ENTER();
+    uint32_t const pos = index_pos(p_header);
+    if (pos < m_index.count)
+    {
+        uint32_t const id_at  = index_by_id_lower_bound(p_header->record_id);
+        uint32_t const key_at = index_by_key_lower_bound(p_header->record_key,
+                                                         p_header->record_id);
+
+        index_view_remove(m_index.by_id,  id_at,  pos);
+        index_view_remove(m_index.by_key, key_at, pos);
+
+        m_index.count--;
+        memmove(&m_index.entries[pos], &m_index.entries[pos + 1],
+                (m_index.count - pos) * sizeof(fds_index_entry_t));
+    }
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Add all valid records on a page to the index.
+static bool index_page_add(uint16_t page)
+{
+    uint32_t const * p_record = NULL;
+
+    while (record_find_next(page, &p_record))
+    {
+        if (!index_insert((fds_header_t*)p_record, p_record))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// Update the location of the records which garbage collection has moved to a new page.
+static void index_page_remap(uint16_t page)
+{
+    uint32_t const * p_record = NULL;
+
+    while (record_find_next(page, &p_record))
+    {
+        CRITICAL_SECTION_ENTER();
+        uint32_t const pos = index_pos((fds_header_t*)p_record);
+        if (pos < m_index.count)
+        {
+            m_index.entries[pos].p_record = p_record;
+        }
+        CRITICAL_SECTION_EXIT();
+    }
+}
+
+
+// Index all records stored on data pages.
+static void index_rebuild(void)
+{
+    bool fits = true;
+
+    // Make searches use flash while the index is incomplete.
+    m_index.overflow = true;
+    m_index.count    = 0;
+
+    for (uint16_t page = 0; (page < FDS_DATA_PAGES) && fits; page++)
+    {
+        if (m_pages[page].page_type == FDS_PAGE_DATA)
+        {
+            fits = index_page_add(page);
+        }
+    }
+
+    m_index.overflow = !fits;
+}
+
+
+// Search the index for the record following the one in the token. Records of a file are found
+// in record key order and, within a key, in record ID order; records with a key in record ID order.
+// Records are matched by file ID and record key (if both are given), by file ID or by record key.
+static bool index_find_next(uint16_t          const * p_file_id,
+                            uint16_t          const * p_record_key,
+                            fds_find_token_t  const * p_token,
+                            fds_index_entry_t       * p_entry)
+{
+    bool     ret   = false;
+    uint32_t found = 0;
+
+    CRITICAL_SECTION_ENTER();
+    if ((p_file_id != NULL) && (p_record_key != NULL))
+    {
+        // Records with the same file ID and record key are stored next to each other,
+        // sorted by record ID.
+        uint32_t const key = index_key(*p_file_id, *p_record_key);
+        uint32_t const pos = index_lower_bound(key, p_token->record_id + 1);
+
+        if ((pos < m_index.count) && (m_index.entries[pos].key == key))
+        {
+            found = pos;
+            ret   = true;
+        }
+    }
+    else if (p_file_id != NULL)
+    {
+        // Records of a file are stored next to each other, sorted by record key and record ID.
+        uint32_t const pos = index_lower_bound(index_key(*p_file_id, p_token->record_key),
+                                               p_token->record_id + 1);
+
+        if ((pos < m_index.count) && ((m_index.entries[pos].key >> 16) == *p_file_id))
+        {
+            found = pos;
+            ret   = true;
+        }
+    }
+    else
+    {
+        // Records with a given key are spread across files; search the view sorted by record key.
+        uint32_t const at = index_by_key_lower_bound(*p_record_key, p_token->record_id + 1);
+
+        if (at < m_index.count)
+        {
+            found = m_index.by_key[at];
+            ret   = ((uint16_t)m_index.entries[found].key == *p_record_key);
+        }
+    }
+
+    if (ret)
+    {
+        *p_entry = m_index.entries[found];
+    }
+    CRITICAL_SECTION_EXIT();
+
+    return ret;
+}
+
+
+static ret_code_t index_record_find(uint16_t          const * p_file_id,
+                                    uint16_t          const * p_record_key,
+                                    fds_record_desc_t       * p_desc,
+                                    fds_find_token_t        * p_token)
+{
+    fds_index_entry_t entry;
+
+    if (!index_find_next(p_file_id, p_record_key, p_token, &entry))
+    {
+        return FDS_ERR_NOT_FOUND;
+    }
+
+    // Keep the page and address up to date, so that the token remains usable
+    // should the search fall back to flash.
+    (void) page_from_record(&p_token->page, entry.p_record);
+    p_token->p_addr     = entry.p_record;
+    p_token->record_id  = entry.record_id;
+    p_token->record_key = (uint16_t)entry.key;
+
+    p_desc->record_id    = entry.record_id;
+    p_desc->p_record     = entry.p_record;
+    p_desc->gc_run_count = m_gc.run_count;
+
+    return FDS_SUCCESS;
+}
+
+
+static bool index_find_by_id(fds_record_desc_t * const p_desc, uint16_t * const p_page)
+{
+    uint32_t const * p_record = NULL;
+
+    CRITICAL_SECTION_ENTER();
+    uint32_t const at = index_by_id_lower_bound(p_desc->record_id);
+    if (   (at < m_index.count)
+        && (m_index.entries[m_index.by_id[at]].record_id == p_desc->record_id))
+    {
+        p_record = m_index.entries[m_index.by_id[at]].p_record;
+    }
+    CRITICAL_SECTION_EXIT();
+
+    if ((p_record == NULL) || (page_from_record(p_page, p_record) != FDS_SUCCESS))
+    {
+        return false;
+    }
+
+    p_desc->p_record     = p_record;
+    p_desc->gc_run_count = m_gc.run_count;
+
+    return true;
+}
+
+#endif // FDS_RECORD_INDEX_SIZE > 0
+
+
 // Find a record given its descriptor and retrive the page in which the record is stored.
 // NOTE: Do not pass NULL as an argument for p_page.
 static bool record_find_by_desc(fds_record_desc_t * const p_desc, uint16_t * const p_page)
@@ -470,6 +852,13 @@ static bool record_find_by_desc(fds_record_desc_t * const p_desc, uint16_t * con
         return (page_from_record(p_page, p_desc->p_record) == FDS_SUCCESS);
     }
 
+#if (FDS_RECORD_INDEX_SIZE > 0)
+    if (!m_index.overflow)
+    {
+        return index_find_by_id(p_desc, p_page);
+    }
+#endif
+
     // Otherwise, find the record in flash.
     for (*p_page = 0; *p_page < FDS_DATA_PAGES; (*p_page)++)
     {
@@ -511,6 +900,13 @@ static ret_code_t record_find(uint16_t          const * p_file_id,
         return FDS_ERR_NULL_ARG;
     }
 
+#if (FDS_RECORD_INDEX_SIZE > 0)
+    if (((p_file_id != NULL) || (p_record_key != NULL)) && !m_index.overflow)
+    {
+        return index_record_find(p_file_id, p_record_key, p_desc, p_token);
+    }
+#endif
+
     // Begin (or resume) searching for a record.
     for (; p_token->page < FDS_DATA_PAGES; p_token->page++)
     {
@@ -601,7 +997,10 @@ static fds_op_t * queue_buf_get(nrf_atfifo_item_put_t * p_iput_ctx)
 {
     fds_op_t * const p_op = (fds_op_t*) nrf_atfifo_item_alloc(m_queue, p_iput_ctx);
 
-    memset(p_op, 0x00, sizeof(fds_op_t));
+    if (p_op != NULL)
+    {
+        memset(p_op, 0x00, sizeof(fds_op_t));
+    }
     return p_op;
 }
 
@@ -697,7 +1096,8 @@ static fds_init_opts_t pages_init(void)
 
                 // Scan the page to compute its write offset and determine whether or not the page
                 // can be garbage collected. Additionally, update the latest kwown record ID.
-                page_scan(p_page_addr, &m_pages[page].write_offset, &m_pages[page].can_gc);
+                page_scan(p_page_addr, &m_pages[page].write_offset, &m_pages[page].freeable_words);
+                m_pages[page].can_gc = (m_pages[page].freeable_words != 0);
 
                 ret |= PAGE_DATA;
                 page++;
@@ -717,7 +1117,7 @@ static fds_init_opts_t pages_init(void)
                 m_swap_page.p_addr = p_page_addr;
                 // If the swap is promoted, this offset should be kept, otherwise,
                 // it should be set to FDS_PAGE_TAG_SIZE.
-                page_scan(p_page_addr, &m_swap_page.write_offset, NULL);
+                page_scan(p_page_addr, &m_swap_page.write_offset, &m_gc.swap_freeable_words);
 
                 ret |= (m_swap_page.write_offset == FDS_PAGE_TAG_SIZE) ?
                         PAGE_SWAP_CLEAN : PAGE_SWAP_DIRTY;
@@ -734,6 +1134,10 @@ static fds_init_opts_t pages_init(void)
         ret &= NO_PAGES;
     }
 
+#if (FDS_RECORD_INDEX_SIZE > 0)
+    index_rebuild();
+#endif
+
     return (fds_init_opts_t)ret;
 }
 
@@ -785,6 +1189,85 @@ static ret_code_t record_header_write_finalize(fds_op_t * const p_op, uint32_t *
 }
 
 
+// If garbage collection was interrupted after copying a record to swap, return the location
+// of the copy. Return NULL otherwise.
+static uint32_t const * gc_record_copy_find(uint32_t const * const p_record, uint16_t page)
+{
+    bool copied;
+
+    if (page != m_gc.cur_page)
+    {
+        return NULL;
+    }
+
+    switch (m_gc.state)
+    {
+        case GC_FIND_NEXT_RECORD:
+            // The record pointed by p_record_src has been copied.
+            copied = (p_record <= m_gc.p_record_src);
+            break;
+
+        case GC_COPY_RECORD:
+            // The record pointed by p_record_src is about to be copied.
+            copied = (p_record < m_gc.p_record_src);
+            break;
+
+        case GC_ERASE_PAGE:
+            copied = true;
+            break;
+
+        default:
+            copied = false;
+            break;
+    }
+
+    if (copied)
+    {
+        uint32_t     const         record_id  = ((fds_header_t*)p_record)->record_id;
+        uint32_t     const * const p_swap_end = m_swap_page.p_addr + m_swap_page.write_offset;
+        fds_header_t const *       p_header   = (fds_header_t*)(m_swap_page.p_addr + FDS_PAGE_TAG_SIZE);
+
+        while (header_has_next(p_header, p_swap_end))
+        {
+            if (   (p_header->record_id == record_id)
+                && (header_check(p_header, p_swap_end) == FDS_HEADER_VALID))
+            {
+                return (uint32_t*)p_header;
+            }
+
+            p_header = header_jump(p_header);
+        }
+    }
+
+    return NULL;
+}
+
+
+#if (FDS_GC_AUTO_THRESHOLD > 0)
+// Flag garbage collection to be queued once the queue of operations drains, if the space taken up
+// by deleted records exceeds FDS_GC_AUTO_THRESHOLD.
+static void gc_auto_check(void)
+{
+    uint32_t freeable_words = 0;
+    uint32_t used_words     = 0;
+
+    for (uint16_t page = 0; page < FDS_DATA_PAGES; page++)
+    {
+        if (m_pages[page].page_type == FDS_PAGE_DATA)
+        {
+            used_words     += m_pages[page].write_offset - FDS_PAGE_TAG_SIZE;
+            freeable_words += m_pages[page].freeable_words;
+        }
+    }
+
+    if (freeable_words * 100 >= used_words * FDS_GC_AUTO_THRESHOLD)
+    {
+        m_gc.auto_pending = true;
+    }
+}
+#endif
+
+
 static ret_code_t record_header_flag_dirty(uint32_t * const p_record, uint16_t page_to_gc)
 {
     // Used to flag a record as dirty, i.e. ready for garbage collection.
@@ -794,6 +1277,30 @@ static ret_code_t record_header_flag_dirty(uint32_t * const p_record, uint16_t p
     // Flag the record as dirty.
     ret_code_t ret;
 
+    // Copy the header before it is overwritten, to remove the record from the index
+    // and to account for the space it takes up.
+    fds_header_t const header     = *(fds_header_t*)p_record;
+    uint16_t     const record_len = FDS_HEADER_SIZE + header.length_words;
+
+    // If the record has already been copied by garbage collection, flag the copy first, otherwise
+    // the record would be restored when the swap is promoted. Pass m_gc as parameter so that the
+    // event for this write is ignored; the operation proceeds once the original is flagged.
+    uint32_t const * const p_copy = gc_record_copy_find(p_record, page_to_gc);
+
+    if (p_copy != NULL)
+    {
+        ret = nrf_fstorage_write(&m_fs, (uint32_t)p_copy,
+            &dirty_header, FDS_HEADER_SIZE_TL * sizeof(uint32_t), &m_gc);
+
+        if (ret != NRF_SUCCESS)
+        {
+            return FDS_ERR_BUSY;
+        }
+
+        m_gc.swap_dirty           = true;
+        m_gc.swap_freeable_words += record_len;
+    }
+
     ret = nrf_fstorage_write(&m_fs, (uint32_t)p_record,
         &dirty_header, FDS_HEADER_SIZE_TL * sizeof(uint32_t), NULL);
 
@@ -802,7 +1309,16 @@ static ret_code_t record_header_flag_dirty(uint32_t * const p_record, uint16_t p
         return FDS_ERR_BUSY;
     }
 
-    m_pages[page_to_gc].can_gc = true;
+#if (FDS_RECORD_INDEX_SIZE > 0)
+    index_remove(&header);
+#endif
+
+    m_pages[page_to_gc].can_gc          = true;
+    m_pages[page_to_gc].freeable_words += record_len;
+
+#if (FDS_GC_AUTO_THRESHOLD > 0)
+    gc_auto_check();
+#endif
 
     return FDS_SUCCESS;
 }
@@ -904,8 +1420,10 @@ static bool crc_verify_success(uint16_t crc, uint16_t len_words, uint32_t const
 static void gc_init(void)
 {
     m_gc.run_count++;
-    m_gc.cur_page = 0;
-    m_gc.resume   = false;
+    m_gc.cur_page        = 0;
+    m_gc.resume          = false;
+    m_gc.auto_pending    = false;
+    m_gc.step_words      = 0;
 
     // Setup which pages to GC. Defer checking for open records and the can_gc flag,
     // as other operations might change those while GC is running.
@@ -946,6 +1464,8 @@ static bool gc_page_next(uint16_t * const p_next_page)
 static ret_code_t gc_swap_erase(void)
 {
     m_gc.state               = GC_DISCARD_SWAP;
+    m_gc.swap_dirty          = false;
+    m_gc.swap_freeable_words = 0;
     m_swap_page.write_offset = FDS_PAGE_TAG_SIZE;
 
     return nrf_fstorage_erase(&m_fs, (uint32_t)m_swap_page.p_addr, FDS_PHY_PAGES_IN_VPAGE, NULL);
@@ -1038,6 +1558,14 @@ static ret_code_t gc_next_page(void)
         m_gc.cur_page     = 0;
         m_gc.p_record_src = NULL;
 
+#if (FDS_RECORD_INDEX_SIZE > 0)
+        if (m_index.overflow)
+        {
+            // Garbage collection might have freed enough records for all of them to be indexed.
+            index_rebuild();
+        }
+#endif
+
         return FDS_OP_COMPLETED;
     }
 
@@ -1052,6 +1580,7 @@ static void gc_update_swap_offset(void)
     uint16_t     const         record_len = FDS_HEADER_SIZE + p_header->length_words;
 
     m_swap_page.write_offset += record_len;
+    m_gc.step_words          += record_len;
 }
 
 
@@ -1067,6 +1596,17 @@ static void gc_swap_pages(void)
     // Keep the offset for this page, but reset it for the swap.
     m_pages[m_gc.cur_page].write_offset = m_swap_page.write_offset;
     m_swap_page.write_offset            = FDS_PAGE_TAG_SIZE;
+
+    // The new page only holds valid records, unless some were deleted after being copied.
+    m_pages[m_gc.cur_page].can_gc         = m_gc.swap_dirty;
+    m_pages[m_gc.cur_page].freeable_words = m_gc.swap_freeable_words;
+    m_gc.swap_dirty                       = false;
+    m_gc.swap_freeable_words              = 0;
+
+#if (FDS_RECORD_INDEX_SIZE > 0)
+    // Records have been copied to the swap page in the same order; point the index to them.
+    index_page_remap(m_gc.cur_page);
+#endif
 }
 
 
@@ -1100,7 +1640,8 @@ static void gc_state_advance(void)
             break;
 
         case GC_TAG_NEW_SWAP:
-            m_gc.state = GC_NEXT_PAGE;
+            m_gc.state       = GC_NEXT_PAGE;
+            m_gc.step_words += FDS_PAGE_SIZE;
             break;
 
         default:
@@ -1158,6 +1699,7 @@ static ret_code_t init_execute(uint32_t prev_ret, fds_op_t * const p_op)
             // If the swap is going to be discarded then reset its write_offset.
             p_op->init.step          = FDS_OP_INIT_TAG_SWAP;
             m_swap_page.write_offset = FDS_PAGE_TAG_SIZE;
+            m_gc.swap_freeable_words = 0;
 
             ret = nrf_fstorage_erase(&m_fs, (uint32_t)m_swap_page.p_addr, FDS_PHY_PAGES_IN_VPAGE, NULL);
         } break;
@@ -1177,10 +1719,18 @@ static ret_code_t init_execute(uint32_t prev_ret, fds_op_t * const p_op)
             m_pages[gc].p_addr = p_old_swap;
 
             // Copy the offset from the swap to the new page.
-            m_pages[gc].write_offset = m_swap_page.write_offset;
-            m_swap_page.write_offset = FDS_PAGE_TAG_SIZE;
+            m_pages[gc].write_offset   = m_swap_page.write_offset;
+            m_swap_page.write_offset   = FDS_PAGE_TAG_SIZE;
+            m_pages[gc].freeable_words = m_gc.swap_freeable_words;
+            m_pages[gc].can_gc         = (m_gc.swap_freeable_words != 0);
+            m_gc.swap_freeable_words   = 0;
 
             m_pages[gc].page_type = FDS_PAGE_DATA;
+
+#if (FDS_RECORD_INDEX_SIZE > 0)
+            // The records on the promoted swap were not indexed by pages_init().
+            (void) index_page_add(gc);
+#endif
         } break;
 
         default:
@@ -1259,6 +1809,10 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
             break;
 
         case FDS_OP_WRITE_FLAG_DIRTY:
+#if (FDS_RECORD_INDEX_SIZE > 0)
+            // The header of the new record is complete; index it before deleting the old copy.
+            (void) index_insert(&p_op->write.header, p_write_addr);
+#endif
             p_op->write.step = FDS_OP_WRITE_DONE;
             ret = record_header_flag_dirty((uint32_t*)desc.p_record, page);
             break;
@@ -1266,6 +1820,13 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
         case FDS_OP_WRITE_DONE:
             ret = FDS_OP_COMPLETED;
 
+#if (FDS_RECORD_INDEX_SIZE > 0)
+            if (p_op->op_code == FDS_OP_WRITE)
+            {
+                (void) index_insert(&p_op->write.header, p_write_addr);
+            }
+#endif
+
 #if (FDS_CRC_CHECK_ON_WRITE)
             if (!crc_verify_success(p_op->write.header.crc16,
                                     p_op->write.header.length_words,
@@ -1332,7 +1893,48 @@ static ret_code_t delete_execute(uint32_t prev_ret, fds_op_t * const p_op)
 }
 
 
-static ret_code_t gc_execute(uint32_t prev_ret)
+#if (FDS_GC_STEP_WORDS > 0)
+// Check whether the work budget of the current GC step has been used, and GC is at a point
+// where it can be interrupted. If other operations are waiting, queue a new GC operation
+// behind them and return true.
+static bool gc_step_done(fds_op_t const * const p_cur_op)
+{
+    nrf_atfifo_item_put_t iput_ctx;
+
+    if (   ((m_gc.state != GC_FIND_NEXT_RECORD) && (m_gc.state != GC_NEXT_PAGE))
+        || (m_gc.step_words < FDS_GC_STEP_WORDS))
+    {
+        return false;
+    }
+
+    m_gc.step_words = 0;
+
+    if (m_queued_op_cnt == 1)
+    {
+        // No other operations are queued; keep going.
+        return false;
+    }
+
+    fds_op_t * const p_op = queue_buf_get(&iput_ctx);
+    if (p_op == NULL)
+    {
+        // The queue is full; keep going.
+        return false;
+    }
+
+    p_op->op_code      = FDS_OP_GC;
+    p_op->gc.is_resume = true;
+    p_op->gc.is_auto   = p_cur_op->gc.is_auto;
+
+    queue_buf_store(&iput_ctx);
+    (void) nrf_atomic_u32_add(&m_queued_op_cnt, 1);
+
+    return true;
+}
+#endif
+
+
+static ret_code_t gc_execute(uint32_t prev_ret, fds_op_t * const p_op)
 {
     ret_code_t ret;
 
@@ -1341,6 +1943,12 @@ static ret_code_t gc_execute(uint32_t prev_ret)
         return FDS_ERR_OPERATION_TIMEOUT;
     }
 
+    if (p_op->gc.is_resume && (m_gc.state == GC_BEGIN))
+    {
+        // GC was completed by another GC operation, queued by fds_gc() in the meantime.
+        return FDS_OP_PAUSED;
+    }
+
     if (m_gc.resume)
     {
         m_gc.resume = false;
@@ -1348,6 +1956,15 @@ static ret_code_t gc_execute(uint32_t prev_ret)
     else
     {
         gc_state_advance();
+
+#if (FDS_GC_STEP_WORDS > 0)
+        if (gc_step_done(p_op))
+        {
+            // Let other operations run. The next GC operation resumes from the current state.
+            m_gc.resume = true;
+            return FDS_OP_PAUSED;
+        }
+#endif
     }
 
     switch (m_gc.state)
@@ -1387,6 +2004,36 @@ static ret_code_t gc_execute(uint32_t prev_ret)
 }
 
 
+#if (FDS_GC_AUTO_THRESHOLD > 0)
+// Queue the garbage collection flagged by gc_auto_check() if no other operations are queued.
+// The operation is run by queue_process() as the next one, like a paused GC step.
+static void gc_auto_queue(void)
+{
+    nrf_atfifo_item_put_t iput_ctx;
+
+    if (!m_gc.auto_pending || (m_gc.state != GC_BEGIN) || (m_queued_op_cnt != 1))
+    {
+        return;
+    }
+
+    fds_op_t * const p_op = queue_buf_get(&iput_ctx);
+    if (p_op == NULL)
+    {
+        // The queue is full; try again once it drains.
+        return;
+    }
+
+    m_gc.auto_pending = false;
+
+    p_op->op_code    = FDS_OP_GC;
+    p_op->gc.is_auto = true;
+
+    queue_buf_store(&iput_ctx);
+    (void) nrf_atomic_u32_add(&m_queued_op_cnt, 1);
+}
+#endif
+
+
 static void queue_process(ret_code_t result)
 {
     static fds_op_t              * m_p_cur_op;  // Current fds operation.
@@ -1426,7 +2073,7 @@ static void queue_process(ret_code_t result)
                 break;
 
             case FDS_OP_GC:
-                result = gc_execute(result);
+                result = gc_execute(result, m_p_cur_op);
                 break;
 
             default:
@@ -1445,18 +2092,22 @@ static void queue_process(ret_code_t result)
         // - free the operation buffer
         // - execute any other queued operations
 
-        fds_evt_t evt =
+        // A paused operation has been queued again; it will send an event once it completes.
+        if (result != FDS_OP_PAUSED)
         {
-            // The operation might have failed for one of the following reasons:
-            // FDS_ERR_BUSY              - flash subsystem can't accept the operation
-            // FDS_ERR_OPERATION_TIMEOUT - flash subsystem timed out
-            // FDS_ERR_CRC_CHECK_FAILED  - a CRC check failed
-            // FDS_ERR_NOT_FOUND         - no record found (delete/update)
-            .result = (result == FDS_OP_COMPLETED) ? FDS_SUCCESS : result,
-        };
-
-        event_prepare(m_p_cur_op, &evt);
-        event_send(&evt);
+            fds_evt_t evt =
+            {
+                // The operation might have failed for one of the following reasons:
+                // FDS_ERR_BUSY              - flash subsystem can't accept the operation
+                // FDS_ERR_OPERATION_TIMEOUT - flash subsystem timed out
+                // FDS_ERR_CRC_CHECK_FAILED  - a CRC check failed
+                // FDS_ERR_NOT_FOUND         - no record found (delete/update)
+                .result = (result == FDS_OP_COMPLETED) ? FDS_SUCCESS : result,
+            };
+
+            event_prepare(m_p_cur_op, &evt);
+            event_send(&evt);
+        }
 
         // Zero the pointer to the current operation so that this function
         // will fetch a new one from the queue next time it is run.
@@ -1469,6 +2120,11 @@ static void queue_process(ret_code_t result)
         // Free the queue element used by the current operation.
         queue_free(&m_iget_ctx);
 
+#if (FDS_GC_AUTO_THRESHOLD > 0)
+        // If this was the last operation, queue garbage collection so that the loop picks it up.
+        gc_auto_queue();
+#endif
+
         if (!queue_has_next())
         {
             // No more elements left. Nothing to do.
@@ -1487,8 +2143,44 @@ static void queue_start(void)
 }
 
 
+// Enqueues garbage collection. The is_auto argument is reported in the FDS_EVT_GC event.
+static ret_code_t gc_enqueue(bool is_auto)
+{
+    fds_op_t * p_op;
+    nrf_atfifo_item_put_t iput_ctx;
+
+    p_op = queue_buf_get(&iput_ctx);
+    if (p_op == NULL)
+    {
+        return FDS_ERR_NO_SPACE_IN_QUEUES;
+    }
+
+    p_op->op_code    = FDS_OP_GC;
+    p_op->gc.is_auto = is_auto;
+
+    queue_buf_store(&iput_ctx);
+
+    if (m_gc.state != GC_BEGIN)
+    {
+        // Resume GC by retrying the last step.
+        m_gc.resume = true;
+    }
+
+    queue_start();
+
+    return FDS_SUCCESS;
+}
+
+
 static void fs_event_handler(nrf_fstorage_evt_t * p_evt)
 {
+    if (p_evt->p_param == &m_gc)
+    {
+        // A record copied to swap was flagged as dirty. The operation continues
+        // with the event for the original record.
+        return;
+    }
+
     queue_process(p_evt->result);
 }
 
@@ -1538,6 +2230,20 @@ static ret_code_t write_enqueue(fds_record_desc_t         * const p_desc,
         {
             // There is either not enough space in flash (FDS_ERR_NO_SPACE_IN_FLASH) or
             // the record exceeds the size of virtual page (FDS_ERR_RECORD_TOO_LARGE).
+#if (FDS_GC_AUTO_THRESHOLD > 0)
+            if ((ret == FDS_ERR_NO_SPACE_IN_FLASH) && (m_gc.state == GC_BEGIN))
+            {
+                // Reclaim space in the background. The write can be retried once
+                // the FDS_EVT_GC event is received.
+                m_gc.auto_pending = true;
+
+                if (m_queued_op_cnt == 0)
+                {
+                    // The queue is idle, so nothing would pick up the flag.
+                    (void) gc_enqueue(true);
+                }
+            }
+#endif
             return ret;
         }
     }
@@ -1628,6 +2334,10 @@ ret_code_t fds_register(fds_cb_t cb)
 
 static uint32_t flash_end_addr(void)
 {
+#if (FDS_BACKEND == NRF_FSTORAGE_RAM)
+    // The flash is emulated by the memory area given to the RAM implementation.
+    uint32_t end_addr = nrf_fstorage_ram_end_addr();
+#else
     uint32_t const bootloader_addr = BOOTLOADER_ADDRESS;
     uint32_t const page_sz         = NRF_FICR->CODEPAGESIZE;
 
@@ -1641,6 +2351,7 @@ static uint32_t flash_end_addr(void)
 #endif
 
     uint32_t end_addr = (bootloader_addr != 0xFFFFFFFF) ? bootloader_addr : (code_sz * page_sz);
+#endif
 
     return end_addr - (FDS_PHY_PAGES_RESERVED * FDS_PHY_PAGE_SIZE * sizeof(uint32_t));
 }
@@ -1662,6 +2373,8 @@ static ret_code_t flash_subsystem_init(void)
         return nrf_fstorage_init(&m_fs, &nrf_fstorage_sd, NULL);
     #elif (FDS_BACKEND == NRF_FSTORAGE_NVMC)
         return nrf_fstorage_init(&m_fs, &nrf_fstorage_nvmc, NULL);
+    #elif (FDS_BACKEND == NRF_FSTORAGE_RAM)
+        return nrf_fstorage_init(&m_fs, &nrf_fstorage_ram, NULL);
     #else
         #error Invalid FDS_BACKEND.
     #endif
@@ -2025,33 +2738,12 @@ ret_code_t fds_file_delete(uint16_t file_id)
 
 ret_code_t fds_gc(void)
 {
-    fds_op_t * p_op;
-    nrf_atfifo_item_put_t iput_ctx;
-
     if (!m_flags.initialized)
     {
         return FDS_ERR_NOT_INITIALIZED;
     }
 
-    p_op = queue_buf_get(&iput_ctx);
-    if (p_op == NULL)
-    {
-        return FDS_ERR_NO_SPACE_IN_QUEUES;
-    }
-
-    p_op->op_code = FDS_OP_GC;
-
-    queue_buf_store(&iput_ctx);
-
-    if (m_gc.state != GC_BEGIN)
-    {
-        // Resume GC by retrying the last step.
-        m_gc.resume = true;
-    }
-
-    queue_start();
-
-    return FDS_SUCCESS;
+    return gc_enqueue(false);
 }
 
 
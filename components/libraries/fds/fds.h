@@ -180,6 +180,8 @@ typedef struct
 {
     uint32_t const * p_addr;
     uint16_t         page;
+    uint32_t         record_id;     //!< The ID of the last record found using the record index.
+    uint16_t         record_key;    //!< The key of the last record found using the record index.
 } fds_find_token_t;
 
 
@@ -192,7 +194,7 @@ typedef enum
     FDS_EVT_UPDATE,     //!< Event for @ref fds_record_update.
     FDS_EVT_DEL_RECORD, //!< Event for @ref fds_record_delete.
     FDS_EVT_DEL_FILE,   //!< Event for @ref fds_file_delete.
-    FDS_EVT_GC          //!< Event for @ref fds_gc.
+    FDS_EVT_GC          //!< Event for @ref fds_gc, or for garbage collection started by FDS.
 } fds_evt_id_t;
 
 
@@ -218,6 +220,10 @@ typedef struct
             uint16_t file_id;
             uint16_t record_key;
         } del; //!< Information for @ref FDS_EVT_DEL_RECORD and @ref FDS_EVT_DEL_FILE events.
+        struct
+        {
+            bool is_auto;   //!< Garbage collection was started by FDS, not by @ref fds_gc.
+        } gc; //!< Information for @ref FDS_EVT_GC events.
     };
 } fds_evt_t;
 
@@ -632,6 +638,9 @@ ret_code_t fds_record_close(fds_record_desc_t * p_desc);
  * This function is asynchronous. Completion is reported through an event that is sent to the
  * registered event handler function.
  *
+ * @note    If FDS_GC_AUTO_THRESHOLD is set, FDS also starts garbage collection by itself and
+ *          reports its completion with an @ref FDS_EVT_GC event that has gc.is_auto set.
+ *
  * @retval  FDS_SUCCESS                 If the operation was queued successfully.
  * @retval  FDS_ERR_NOT_INITIALIZED     If the module is not initialized.
  * @retval  FDS_ERR_NO_SPACE_IN_QUEUES  If the operation queue is full.
@@ -75,9 +75,11 @@ extern "C" {
 
 #define FDS_OP_EXECUTING        (NRF_SUCCESS)
 #define FDS_OP_COMPLETED        (0x1D1D)
+#define FDS_OP_PAUSED           (0x1D1E)
 
 #define NRF_FSTORAGE_NVMC       1
 #define NRF_FSTORAGE_SD         2
+#define NRF_FSTORAGE_RAM        3
 
 // The size of a physical page, in 4-byte words.
 #if defined(NRF51)
@@ -101,6 +103,31 @@ extern "C" {
  // Just a shorter name for the size, in words, of a virtual page.
 #define FDS_PAGE_SIZE               (FDS_VIRTUAL_PAGE_SIZE)
 
+// The number of records that can be held by the RAM record index, 16 bytes each.
+// Set to zero to disable the index and always search records in flash.
+#ifndef FDS_RECORD_INDEX_SIZE
+    #define FDS_RECORD_INDEX_SIZE   (0)
+#endif
+
+#if (FDS_RECORD_INDEX_SIZE > 0xFFFF)
+    #error "FDS_RECORD_INDEX_SIZE must not exceed 65535."
+#endif
+
+// The amount of work, in 4-byte words, that garbage collection does before letting other queued
+// operations run. Copying a record costs its size, cleaning a page costs FDS_PAGE_SIZE.
+// Set to zero to run garbage collection to completion.
+#ifndef FDS_GC_STEP_WORDS
+    #define FDS_GC_STEP_WORDS       (0)
+#endif
+
+// Start garbage collection automatically once deleted records take up this percentage of the
+// flash space used to store data. Set to zero to disable.
+// Garbage collection is started once the queue of operations has drained, or when a write
+// fails for lack of space. It reports FDS_EVT_GC like fds_gc(), with gc.is_auto set.
+#ifndef FDS_GC_AUTO_THRESHOLD
+    #define FDS_GC_AUTO_THRESHOLD   (0)
+#endif
+
 #if (FDS_VIRTUAL_PAGE_SIZE % FDS_PHY_PAGE_SIZE != 0)
     #error "FDS_VIRTUAL_PAGE_SIZE must be a multiple of the size of a physical page."
 #endif
@@ -136,6 +163,7 @@ typedef struct
     uint16_t                words_reserved; // The amount of words reserved.
     uint32_t volatile       records_open;   // The number of open records.
     bool                    can_gc;         // Indicates that there are some records that have been deleted.
+    uint16_t                freeable_words; // The amount of words taken up by deleted records.
 } fds_page_t;
 
 
@@ -146,6 +174,15 @@ typedef struct
 } fds_swap_page_t;
 
 
+// An entry of the RAM record index.
+typedef struct
+{
+    uint32_t         key;           // The file ID (upper half-word) and the record key (lower half-word).
+    uint32_t         record_id;     // The record ID.
+    uint32_t const * p_record;      // The location of the record in flash.
+} fds_index_entry_t;
+
+
 // FDS op-codes.
 typedef enum
 {
@@ -221,6 +258,11 @@ typedef struct
             uint16_t          record_key;
             uint32_t          record_to_delete;
         } del;
+        struct
+        {
+            bool              is_resume;        // Whether the operation was queued to resume a paused GC.
+            bool              is_auto;          // Whether the operation was queued by FDS itself.
+        } gc;
     };
 } fds_op_t;
 
@@ -305,6 +347,10 @@ typedef struct
     uint16_t         run_count;                  // Total number of times GC was run.
     bool             do_gc_page[FDS_DATA_PAGES]; // Controls which pages to garbage collect.
     bool             resume;                     // Whether or not GC should be resumed.
+    bool             swap_dirty;                 // Whether a record copied to swap has been deleted.
+    uint16_t         swap_freeable_words;        // The amount of words taken up by deleted records on swap.
+    bool             auto_pending;               // Whether GC is to be queued once the queue drains.
+    uint32_t         step_words;                 // The amount of work done in the current GC step.
 } fds_gc_data_t;
 
 
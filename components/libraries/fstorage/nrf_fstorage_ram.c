@@ -0,0 +1,383 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include "sdk_common.h"
+
+#if NRF_MODULE_ENABLED(NRF_FSTORAGE)
+
+#include "nrf_fstorage_ram.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+
+#ifndef NRF_FSTORAGE_RAM_QUEUE_SIZE
+#define NRF_FSTORAGE_RAM_QUEUE_SIZE 4
+#endif
+
+#ifndef NRF_FSTORAGE_RAM_ERASE_UNIT
+#define NRF_FSTORAGE_RAM_ERASE_UNIT 4096
+#endif
+
+
+/* A deferred operation. */
+typedef struct
+{
+    nrf_fstorage_t const  * p_fs;
+    nrf_fstorage_evt_id_t   id;
+    uint32_t                addr;
+    void            const * p_src;
+    uint32_t                len;
+    void                  * p_param;
+} nrf_fstorage_ram_op_t;
+
+
+static nrf_fstorage_info_t m_flash_info =
+{
+    .erase_unit   = NRF_FSTORAGE_RAM_ERASE_UNIT,
+    .program_unit = 4,
+    .rmap         = true,
+    .wmap         = false,
+};
+
+
+static nrf_fstorage_ram_config_t m_config;
+static nrf_fstorage_ram_stat_t   m_stat;
+
+/* Deferred operations, executed in order. */
+static nrf_fstorage_ram_op_t     m_queue[NRF_FSTORAGE_RAM_QUEUE_SIZE];
+static uint32_t                  m_queue_head;
+static uint32_t                  m_queue_cnt;
+
+
+/* Send event to the event handler. */
+static void event_send(nrf_fstorage_ram_op_t const * p_op)
+{
+    if (p_op->p_fs->evt_handler == NULL)
+    {
+        /* Nothing to do. */
+        return;
+    }
+
+    nrf_fstorage_evt_t evt =
+    {
+        .result  = NRF_SUCCESS,
+        .id      = p_op->id,
+        .addr    = p_op->addr,
+        .p_src   = p_op->p_src,
+        .len     = p_op->len,
+        .p_param = p_op->p_param,
+    };
+
+    p_op->p_fs->evt_handler(&evt);
+}
+
+
+/* Program words: like NOR flash, a write can only clear bits. */
+static void mem_write(uint32_t dest, uint32_t const * p_src, uint32_t words)
+{
+    uint32_t * p_dest = (uint32_t*)(uintptr_t)dest;
+
+    for (uint32_t i = 0; i < words; i++)
+    {
+        if (p_dest[i] != 0xFFFFFFFF)
+        {
+            /* Only the bits which are zero in the source are cleared. */
+            m_stat.words_rewritten++;
+        }
+
+        p_dest[i] &= p_src[i];
+    }
+
+    m_stat.writes++;
+    m_stat.bytes_written += words * sizeof(uint32_t);
+    m_stat.time_ns       += m_config.latency.op_ns + (uint64_t)words * m_config.latency.write_word_ns;
+}
+
+
+static void mem_erase(uint32_t page_addr, uint32_t pages)
+{
+    for (uint32_t i = 0; i < pages; i++)
+    {
+        uint32_t const addr = page_addr + (i * m_flash_info.erase_unit);
+
+        memset((void*)(uintptr_t)addr, 0xFF, m_flash_info.erase_unit);
+
+        if (m_config.p_erase_count != NULL)
+        {
+            m_config.p_erase_count[(addr - nrf_fstorage_ram_start_addr()) / m_flash_info.erase_unit]++;
+        }
+    }
+
+    m_stat.erases  += pages;
+    m_stat.time_ns += m_config.latency.op_ns + (uint64_t)pages * m_config.latency.erase_page_ns;
+}
+
+
+static void op_execute(nrf_fstorage_ram_op_t const * p_op)
+{
+    if (p_op->id == NRF_FSTORAGE_EVT_WRITE_RESULT)
+    {
+        mem_write(p_op->addr, (uint32_t const *)p_op->p_src, p_op->len / m_flash_info.program_unit);
+    }
+    else
+    {
+        mem_erase(p_op->addr, p_op->len);
+    }
+
+    event_send(p_op);
+}
+
+
+/* Execute an operation, or queue it if operations are deferred. */
+static ret_code_t op_start(nrf_fstorage_ram_op_t const * p_op)
+{
+    if (!m_config.deferred)
+    {
+        op_execute(p_op);
+        return NRF_SUCCESS;
+    }
+
+    if (m_queue_cnt == NRF_FSTORAGE_RAM_QUEUE_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    m_queue[(m_queue_head + m_queue_cnt) % NRF_FSTORAGE_RAM_QUEUE_SIZE] = *p_op;
+    m_queue_cnt++;
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t init(nrf_fstorage_t * p_fs, void * p_param)
+{
+    UNUSED_PARAMETER(p_param);
+
+    if (m_config.p_mem == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    p_fs->p_flash_info = &m_flash_info;
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t uninit(nrf_fstorage_t * p_fs, void * p_param)
+{
+    UNUSED_PARAMETER(p_fs);
+    UNUSED_PARAMETER(p_param);
+
+    /* Drop pending operations. */
+    m_queue_cnt = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t read(nrf_fstorage_t const * p_fs, uint32_t src, void * p_dest, uint32_t len)
+{
+    UNUSED_PARAMETER(p_fs);
+
+    memcpy(p_dest, (uint32_t*)(uintptr_t)src, len);
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t write(nrf_fstorage_t const * p_fs,
+                        uint32_t               dest,
+                        void           const * p_src,
+                        uint32_t               len,
+                        void                 * p_param)
+{
+    nrf_fstorage_ram_op_t const op =
+    {
+        .p_fs    = p_fs,
+        .id      = NRF_FSTORAGE_EVT_WRITE_RESULT,
+        .addr    = dest,
+        .p_src   = p_src,
+        .len     = len,
+        .p_param = p_param,
+    };
+
+    return op_start(&op);
+}
+
+
+static ret_code_t erase(nrf_fstorage_t const * p_fs,
+                        uint32_t               page_addr,
+                        uint32_t               len,
+                        void                 * p_param)
+{
+    nrf_fstorage_ram_op_t const op =
+    {
+        .p_fs    = p_fs,
+        .id      = NRF_FSTORAGE_EVT_ERASE_RESULT,
+        .addr    = page_addr,
+        .len     = len,
+        .p_param = p_param,
+    };
+
+    return op_start(&op);
+}
+
+
+static uint8_t const * rmap(nrf_fstorage_t const * p_fs, uint32_t addr)
+{
+    UNUSED_PARAMETER(p_fs);
+
+    return (uint8_t*)(uintptr_t)addr;
+}
+
+
+static uint8_t * wmap(nrf_fstorage_t const * p_fs, uint32_t addr)
+{
+    UNUSED_PARAMETER(p_fs);
+    UNUSED_PARAMETER(addr);
+
+    /* Not supported. */
+    return NULL;
+}
+
+
+static bool is_busy(nrf_fstorage_t const * p_fs)
+{
+    UNUSED_PARAMETER(p_fs);
+
+    return (m_queue_cnt != 0);
+}
+
+
+ret_code_t nrf_fstorage_ram_config_set(nrf_fstorage_ram_config_t const * p_config)
+{
+    if ((p_config == NULL) || (p_config->p_mem == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    uintptr_t const start = (uintptr_t)p_config->p_mem;
+
+    if (   ((start & 0x3) != 0)
+        || ((uint64_t)start + p_config->size > UINT32_MAX))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (p_config->size % m_flash_info.erase_unit != 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_config     = *p_config;
+    m_queue_head = 0;
+    m_queue_cnt  = 0;
+
+    nrf_fstorage_ram_stat_clear();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_fstorage_ram_start_addr(void)
+{
+    return (uint32_t)(uintptr_t)m_config.p_mem;
+}
+
+
+uint32_t nrf_fstorage_ram_end_addr(void)
+{
+    return nrf_fstorage_ram_start_addr() + m_config.size;
+}
+
+
+bool nrf_fstorage_ram_process(void)
+{
+    if (m_queue_cnt == 0)
+    {
+        return false;
+    }
+
+    /* Dequeue before executing, since the event handler might start a new operation. */
+    nrf_fstorage_ram_op_t const op = m_queue[m_queue_head];
+
+    m_queue_head = (m_queue_head + 1) % NRF_FSTORAGE_RAM_QUEUE_SIZE;
+    m_queue_cnt--;
+
+    op_execute(&op);
+
+    return true;
+}
+
+
+void nrf_fstorage_ram_stat_get(nrf_fstorage_ram_stat_t * p_stat)
+{
+    *p_stat = m_stat;
+}
+
+
+void nrf_fstorage_ram_stat_clear(void)
+{
+    memset(&m_stat, 0x00, sizeof(m_stat));
+
+    if (m_config.p_erase_count != NULL)
+    {
+        memset(m_config.p_erase_count, 0x00,
+               (m_config.size / m_flash_info.erase_unit) * sizeof(uint32_t));
+    }
+}
+
+
+/* The exported API. */
+nrf_fstorage_api_t nrf_fstorage_ram =
+{
+    .init    = init,
+    .uninit  = uninit,
+    .read    = read,
+    .write   = write,
+    .erase   = erase,
+    .rmap    = rmap,
+    .wmap    = wmap,
+    .is_busy = is_busy
+};
+
+
+#endif // NRF_FSTORAGE_ENABLED
@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * @file
+ *
+ * @defgroup nrf_fstorage_ram RAM implementation
+ * @ingroup nrf_fstorage
+ * @{
+ *
+ * @brief API implementation of fstorage that emulates NOR flash in RAM.
+ *
+ * @details The flash is emulated by a memory area provided by the application, for example
+ *          a static array or a memory mapped file. The memory is addressed directly, so the
+ *          fstorage instance addresses are the addresses of the memory area itself, and they
+ *          must fit in 32 bits. Writes can only clear bits, and erasing a page sets all of
+ *          its bits. Operations can either complete immediately, like with the NVMC
+ *          implementation, or be deferred until @ref nrf_fstorage_ram_process is called,
+ *          like with the SoftDevice implementation. Each operation is charged a configurable
+ *          latency on a simulated clock.
+ */
+
+#ifndef NRF_FSTORAGE_RAM_H__
+#define NRF_FSTORAGE_RAM_H__
+
+#include "nrf_fstorage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**@brief   Latency of the emulated flash operations, in nanoseconds. */
+typedef struct
+{
+    uint32_t op_ns;             //!< Fixed cost of every write and erase operation.
+    uint32_t write_word_ns;     //!< Time to write a 4-byte word.
+    uint32_t erase_page_ns;     //!< Time to erase a page.
+} nrf_fstorage_ram_latency_t;
+
+
+/**@brief   Configuration of the emulated flash. */
+typedef struct
+{
+    void                       * p_mem;         //!< Memory area emulating the flash. Must be word-aligned.
+    uint32_t                     size;          //!< Size of the memory area, in bytes. Must be a multiple of NRF_FSTORAGE_RAM_ERASE_UNIT.
+    bool                         deferred;      //!< Complete operations from @ref nrf_fstorage_ram_process instead of immediately.
+    nrf_fstorage_ram_latency_t   latency;       //!< Latency of each operation.
+    uint32_t                   * p_erase_count; //!< Optional erase counters, one for each page. Can be NULL.
+} nrf_fstorage_ram_config_t;
+
+
+/**@brief   Statistics of the emulated flash. */
+typedef struct
+{
+    uint32_t writes;            //!< Number of write operations.
+    uint32_t erases;            //!< Number of pages erased.
+    uint32_t bytes_written;     //!< Number of bytes written.
+    uint32_t words_rewritten;   //!< Number of words written again since they were last erased.
+    uint64_t time_ns;           //!< Time spent executing flash operations.
+} nrf_fstorage_ram_stat_t;
+
+
+/**@brief   API implementation that emulates NOR flash in RAM.
+ *
+ * @details An fstorage instance with this API implementation can be initialized by providing
+ *          this structure as a parameter to @ref nrf_fstorage_init.
+ *          The structure is defined in @c nrf_fstorage_ram.c.
+ */
+extern nrf_fstorage_api_t nrf_fstorage_ram;
+
+
+/**@brief   Function for configuring the emulated flash.
+ *
+ * This function must be called before initializing an fstorage instance that uses this
+ * API implementation. The memory content is preserved.
+ *
+ * @param[in]   p_config    The configuration.
+ *
+ * @retval  NRF_SUCCESS             If the configuration was applied.
+ * @retval  NRF_ERROR_NULL          If @p p_config or its memory area is NULL.
+ * @retval  NRF_ERROR_INVALID_ADDR  If the memory area is not word-aligned or is not addressable with 32 bits.
+ * @retval  NRF_ERROR_INVALID_PARAM If the size is not a multiple of the page size.
+ */
+ret_code_t nrf_fstorage_ram_config_set(nrf_fstorage_ram_config_t const * p_config);
+
+
+/**@brief   Function for retrieving the address of the beginning of the emulated flash. */
+uint32_t nrf_fstorage_ram_start_addr(void);
+
+
+/**@brief   Function for retrieving the address of the end (exclusive) of the emulated flash. */
+uint32_t nrf_fstorage_ram_end_addr(void);
+
+
+/**@brief   Function for completing the oldest pending operation, when operations are deferred.
+ *
+ * The event for the operation is sent from this function.
+ *
+ * @retval  true    If an operation was completed.
+ * @retval  false   If no operation was pending.
+ */
+bool nrf_fstorage_ram_process(void);
+
+
+/**@brief   Function for retrieving the statistics of the emulated flash.
+ *
+ * @param[out]  p_stat  The statistics.
+ */
+void nrf_fstorage_ram_stat_get(nrf_fstorage_ram_stat_t * p_stat);
+
+
+/**@brief   Function for clearing the statistics and the erase counters of the emulated flash. */
+void nrf_fstorage_ram_stat_clear(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_FSTORAGE_RAM_H__
+/** @} */
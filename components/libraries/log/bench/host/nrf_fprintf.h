@@ -0,0 +1,52 @@
+#ifndef NRF_FPRINTF_H__
+#define NRF_FPRINTF_H__
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stddef.h>
+
+// Host replacement of nrf_fprintf, formatting with the C library.
+
+typedef void (* nrf_fprintf_fwrite)(void const * p_user_ctx, char const * p_str, size_t length);
+
+typedef struct nrf_fprintf_ctx
+{
+    char * const       p_io_buffer;
+    size_t const       io_buffer_size;
+    size_t             io_buffer_cnt;
+    bool               auto_flush;
+    void const * const p_user_ctx;
+    nrf_fprintf_fwrite fwrite;
+} nrf_fprintf_ctx_t;
+
+static inline void nrf_fprintf_buffer_flush(nrf_fprintf_ctx_t * const p_ctx)
+{
+    if (p_ctx->io_buffer_cnt > 0)
+    {
+        p_ctx->fwrite(p_ctx->p_user_ctx, p_ctx->p_io_buffer, p_ctx->io_buffer_cnt);
+        p_ctx->io_buffer_cnt = 0;
+    }
+}
+
+static inline void nrf_fprintf(nrf_fprintf_ctx_t * const p_ctx, char const * p_fmt, ...)
+{
+    char    str[256];
+    va_list args;
+
+    va_start(args, p_fmt);
+    int len = vsnprintf(str, sizeof(str), p_fmt, args);
+    va_end(args);
+
+    len = (len < (int)sizeof(str)) ? len : (int)sizeof(str) - 1;
+    for (int i = 0; i < len; i++)
+    {
+        p_ctx->p_io_buffer[p_ctx->io_buffer_cnt++] = str[i];
+        if (p_ctx->io_buffer_cnt == p_ctx->io_buffer_size)
+        {
+            nrf_fprintf_buffer_flush(p_ctx);
+        }
+    }
+}
+
+#endif // NRF_FPRINTF_H__
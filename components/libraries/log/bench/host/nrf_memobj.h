@@ -0,0 +1,27 @@
+#ifndef NRF_MEMOBJ_H
+#define NRF_MEMOBJ_H
+
+#include <stddef.h>
+
+#include <stdint.h>
+
+// Host replacement of the memory objects holding the log entries. An object is a flat buffer.
+
+typedef void * nrf_memobj_t;
+
+typedef struct
+{
+    size_t element_size;
+} nrf_memobj_pool_t;
+
+#define NRF_MEMOBJ_POOL_DEF(_name, _chunk_size, _pool_size) \
+    static nrf_memobj_pool_t _name = { .element_size = (_chunk_size) }
+
+uint32_t       nrf_memobj_pool_init(nrf_memobj_pool_t const * p_pool);
+nrf_memobj_t * nrf_memobj_alloc(nrf_memobj_pool_t const * p_pool, size_t size);
+void nrf_memobj_get(nrf_memobj_t const * p_obj);
+void nrf_memobj_put(nrf_memobj_t * p_obj);
+void nrf_memobj_write(nrf_memobj_t * p_obj, void * p_data, size_t len, size_t offset);
+void nrf_memobj_read(nrf_memobj_t * p_obj, void * p_data, size_t len, size_t offset);
+
+#endif // NRF_MEMOBJ_H
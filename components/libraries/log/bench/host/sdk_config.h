@@ -0,0 +1,23 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host builds of the logger used by nrf_log_bench and nrf_log_stress.
+// NRF_LOG_BACKEND_SERIAL_DICTIONARY and NRF_LOG_ALLOW_OVERFLOW can be selected on the command line.
+
+#define NRF_LOG_ENABLED 1
+#define NRF_LOG_USES_COLORS 0
+#define NRF_LOG_USES_TIMESTAMP 1
+#define NRF_LOG_STR_FORMATTER_TIMESTAMP_FORMAT_ENABLED 0
+#define NRF_LOG_DEFERRED 1
+#define NRF_LOG_FILTERS_ENABLED 0
+#define NRF_LOG_DEFAULT_LEVEL 4
+#define NRF_LOG_BUFSIZE 1024
+#define NRF_LOG_MSGPOOL_ELEMENT_SIZE 20
+#define NRF_LOG_MSGPOOL_ELEMENT_COUNT 8
+#define NRF_LOG_STR_PUSH_BUFFER_SIZE 128
+#ifndef NRF_LOG_ALLOW_OVERFLOW
+#define NRF_LOG_ALLOW_OVERFLOW 1
+#endif
+#define NRF_ATOMIC_USE_BUILD_IN 1
+
+#endif // SDK_CONFIG_H
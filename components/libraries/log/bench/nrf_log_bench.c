@@ -0,0 +1,307 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Benchmark of the serial backends with and without dictionary mode.
+ *
+ * Build it on host from this directory, once for each mode (d = 0 or 1):
+ *   L=../..; for s in nrf_log_backend_serial nrf_log_str_formatter; do
+ *       cc -O2 -Ihost -I$L/bench_host -I.. -I../src -I$L/util -I$L/strerror \
+ *          -DNRF_LOG_BACKEND_SERIAL_DICTIONARY=$d -c ../src/$s.c -o $s.o; done
+ *   cc -O2 -Ihost -I$L/bench_host -I.. -I../src -I$L/util -I$L/strerror -DNRF_LOG_BACKEND_SERIAL_DICTIONARY=$d \
+ *      -malign-data=abi -no-pie -Wl,-Ttext-segment=0x10000 nrf_log_bench.c nrf_log_backend_serial.o \
+ *      nrf_log_str_formatter.o $L/bench_host/bench.c -o nrf_log_bench_$d
+ * The program is linked at a low address because the logger keeps 22 bits of the format string addresses,
+ * and -malign-data=abi keeps the module data packed like an array, as the nRF linker scripts do.
+ *
+ * Usage: nrf_log_bench [entries] [output file]
+ *
+ * A mix of log entries is passed to nrf_log_backend_serial_put, like the frontend does when the logs are
+ * processed. The CPU time and the number of bytes sent per entry are reported, with the number of entries
+ * per second that a 115200 baud UART can carry. The same entries are then passed in batches of
+ * NRF_LOG_BATCH_SIZE to nrf_log_backend_serial_put_batch with a 255-byte buffer, the largest UART
+ * transfer, and the number of transport writes is compared. The output must be the same in both cases.
+ * The output can be written to a file; in dictionary mode,
+ * decoding it with nrf_log_dict_decode and this program gives the output of the text mode:
+ *   nrf_log_bench_0 1000 text.log
+ *   nrf_log_bench_1 1000 dict.bin
+ *   nrf_log_dict_decode nrf_log_bench_1 dict.bin | cmp - text.log
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdk_common.h"
+#include "nrf_log_backend_serial.h"
+#include "nrf_log_str_formatter.h"
+#include "nrf_log_internal.h"
+#include "nrf_log_ctrl.h"
+#include "bench.h"
+
+
+#define ENTRY_MAX_WORDS     (HEADER_SIZE + 8)
+#define ENTRY_KINDS         8
+#define OUTPUT_MAX          (64 * 1024 * 1024)
+#define TX_BUFFER_SIZE      64
+#define BATCH_BUFFER_SIZE   255
+#define UART_BYTES_PER_S    (115200 / 10)
+
+// The nRF linker scripts gather the log_const_data_<module> sections, sorted by name, into one section.
+// The modules of the benchmark are registered in that section directly.
+NRF_SECTION_ITEM_REGISTER(log_const_data, const nrf_log_module_const_data_t m_app_const) =
+{
+    .p_module_name = "app",
+};
+NRF_SECTION_ITEM_REGISTER(log_const_data, const nrf_log_module_const_data_t m_ble_gap_const) =
+{
+    .p_module_name = "ble_gap",
+};
+
+static char const m_peer_name[] = "peripheral";
+
+static char    m_push_buf[64];
+static uint8_t m_tx_buffer[BATCH_BUFFER_SIZE];
+static char  * m_output;
+static size_t  m_output_len;
+static size_t  m_tx_count;
+static size_t  m_tx_bytes;
+static bool    m_output_truncated;
+
+// Log entries as stored by the frontend.
+static uint32_t m_entries[ENTRY_KINDS][ENTRY_MAX_WORDS];
+
+
+const char * nrf_log_module_name_get(uint32_t module_id, bool is_ordered_idx)
+{
+    return NRF_SECTION_ITEM_GET(log_const_data, nrf_log_module_const_data_t, module_id)->p_module_name;
+}
+
+
+uint8_t nrf_log_color_id_get(uint32_t module_id, nrf_log_severity_t severity)
+{
+    return 0;
+}
+
+
+bool nrf_log_pushed_str_check(char const * p_str)
+{
+    return (p_str >= m_push_buf) && (p_str < &m_push_buf[sizeof(m_push_buf)]);
+}
+
+
+void nrf_memobj_get(nrf_memobj_t const * p_obj)
+{
+}
+
+
+void nrf_memobj_put(nrf_memobj_t * p_obj)
+{
+}
+
+
+void nrf_memobj_read(nrf_memobj_t * p_obj, void * p_data, size_t len, size_t offset)
+{
+    memcpy(p_data, (uint8_t const *)p_obj + offset, len);
+}
+
+
+static void tx(void const * p_context, char const * p_buffer, size_t len)
+{
+    m_tx_count++;
+    m_tx_bytes += len;
+    if (m_output_len + len > OUTPUT_MAX)
+    {
+        m_output_truncated = true;
+        len = OUTPUT_MAX - m_output_len;
+    }
+    memcpy(&m_output[m_output_len], p_buffer, len);
+    m_output_len += len;
+}
+
+
+static uint32_t addr(void const * p)
+{
+    uintptr_t const value = (uintptr_t)p;
+
+    if ((value & ~(uintptr_t)STD_ADDR_MASK) != 0)
+    {
+        fprintf(stderr, "%p is above the address range of the logger, link at a lower address\n", p);
+        exit(1);
+    }
+    return (uint32_t)value;
+}
+
+
+static void std_entry_set(uint32_t * p_entry, uint32_t module_id, nrf_log_severity_t severity,
+                          uint16_t dropped, char const * p_str, uint32_t nargs, uint32_t const * p_args)
+{
+    nrf_log_header_t * p_header = (nrf_log_header_t *)p_entry;
+
+    p_header->base.std.type     = HEADER_TYPE_STD;
+    p_header->base.std.severity = severity;
+    p_header->base.std.nargs    = nargs;
+    p_header->base.std.addr     = addr(p_str);
+    p_header->module_id         = (uint16_t)module_id;
+    p_header->dropped           = dropped;
+    p_header->timestamp         = 123456 + module_id;
+
+    memcpy(&p_entry[HEADER_SIZE], p_args, nargs * sizeof(uint32_t));
+}
+
+
+static void hexdump_entry_set(uint32_t * p_entry, uint32_t module_id, void const * p_data, uint32_t len)
+{
+    nrf_log_header_t * p_header = (nrf_log_header_t *)p_entry;
+
+    p_header->base.hexdump.type     = HEADER_TYPE_HEXDUMP;
+    p_header->base.hexdump.severity = NRF_LOG_SEVERITY_DEBUG;
+    p_header->base.hexdump.len      = len;
+    p_header->module_id             = (uint16_t)module_id;
+    p_header->dropped               = 0;
+    p_header->timestamp             = 654321;
+
+    memcpy(&p_entry[HEADER_SIZE], p_data, len);
+}
+
+
+static void entries_init(void)
+{
+    static uint8_t const data[] = "\x01\x02\x03\x04Hello\xff\x80 world";
+
+    strcpy(m_push_buf, "dynamic name");
+
+    std_entry_set(m_entries[0], 0, NRF_LOG_SEVERITY_INFO, 0, "Started.", 0, NULL);
+    std_entry_set(m_entries[1], 0, NRF_LOG_SEVERITY_DEBUG, 0, "Value %d, status 0x%08x", 2,
+                  (uint32_t[]){(uint32_t)-42, 0xBEEF});
+    std_entry_set(m_entries[2], 1, NRF_LOG_SEVERITY_INFO, 0, "Connected to %s, interval %u units, rssi %d dBm", 3,
+                  (uint32_t[]){addr(m_peer_name), 24, (uint32_t)-67});
+    std_entry_set(m_entries[3], 1, NRF_LOG_SEVERITY_WARNING, 0, "Device name: %s", 1,
+                  (uint32_t[]){addr(m_push_buf)});
+    std_entry_set(m_entries[4], 0, NRF_LOG_SEVERITY_ERROR, 3, "Error %u at line %u, %s:%d", 4,
+                  (uint32_t[]){8, 1234, addr("main.c"), 99});
+    std_entry_set(m_entries[5], 0, NRF_LOG_SEVERITY_INFO, 0, "%d %d %d %d %d %u", 6,
+                  (uint32_t[]){1, 2, 3, 4, 5, 600000});
+    std_entry_set(m_entries[6], 0, NRF_LOG_SEVERITY_INFO_RAW, 0, "raw %c%c\r\n", 2,
+                  (uint32_t[]){'o', 'k'});
+    hexdump_entry_set(m_entries[7], 1, data, sizeof(data) - 1);
+}
+
+
+int main(int argc, char ** argv)
+{
+    uint32_t const entries = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000;
+
+    if (NRF_SECTION_ITEM_COUNT(log_const_data, nrf_log_module_const_data_t) != 2)
+    {
+        fprintf(stderr, "The log_const_data section is not laid out like an array.\n");
+        return 1;
+    }
+
+    m_output = malloc(OUTPUT_MAX);
+    entries_init();
+    nrf_log_str_formatter_timestamp_freq_set(32768);
+
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < entries; i++)
+    {
+        nrf_log_backend_serial_put(NULL, (nrf_log_entry_t *)m_entries[i % ENTRY_KINDS],
+                                   m_tx_buffer, TX_BUFFER_SIZE, tx);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    double const bytes_per_entry = (double)m_tx_bytes / entries;
+
+    printf("%s mode: %u entries\n", NRF_LOG_BACKEND_SERIAL_DICTIONARY ? "dictionary" : "text", entries);
+    printf("cpu     %8.1f ns/entry, %10.0f entries/s (host)\n",
+           (double)elapsed / entries, entries / ((double)elapsed / 1e9));
+    printf("output  %8.1f bytes/entry, %10.0f entries/s on a 115200 baud UART\n",
+           bytes_per_entry, UART_BYTES_PER_S / bytes_per_entry);
+    printf("put     %8.2f transport writes/entry\n", (double)m_tx_count / entries);
+
+    if (m_output_truncated)
+    {
+        printf("output truncated\n");
+    }
+
+    // Same entries in batches.
+    char * const p_single_output   = m_output;
+    size_t const single_output_len = m_output_len;
+    nrf_log_entry_t * batch[NRF_LOG_BATCH_SIZE];
+
+    m_output     = malloc(OUTPUT_MAX);
+    m_output_len = 0;
+    m_tx_count   = 0;
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < entries; i += NRF_LOG_BATCH_SIZE)
+    {
+        uint32_t const count = MIN(entries - i, NRF_LOG_BATCH_SIZE);
+        for (uint32_t j = 0; j < count; j++)
+        {
+            batch[j] = (nrf_log_entry_t *)m_entries[(i + j) % ENTRY_KINDS];
+        }
+        nrf_log_backend_serial_put_batch(NULL, batch, count, m_tx_buffer, BATCH_BUFFER_SIZE, tx);
+    }
+    elapsed = bench_now_ns() - start;
+
+    printf("batch   %8.2f transport writes/entry, %8.1f ns/entry (host), batches of %u\n",
+           (double)m_tx_count / entries, (double)elapsed / entries, NRF_LOG_BATCH_SIZE);
+
+    if ((m_output_len != single_output_len) || (memcmp(m_output, p_single_output, m_output_len) != 0))
+    {
+        fprintf(stderr, "The output of the batches differs.\n");
+        return 1;
+    }
+    free(m_output);
+    m_output     = p_single_output;
+    m_output_len = single_output_len;
+
+    if (argc > 2)
+    {
+        FILE * p_f = fopen(argv[2], "wb");
+        if ((p_f == NULL) || (fwrite(m_output, 1, m_output_len, p_f) != m_output_len))
+        {
+            fprintf(stderr, "%s: cannot write\n", argv[2]);
+            return 1;
+        }
+        fclose(p_f);
+    }
+
+    return 0;
+}
@@ -0,0 +1,463 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Stress test of the logger buffer with many concurrent producers.
+ *
+ * Build it on host from this directory, with and without overflow (o = 0 or 1):
+ *   L=../..; cc -O2 -pthread -Ihost -I$L/bench_host -I.. -I../src -I$L/util -I$L/strerror -I$L/ringbuf \
+ *      -I$L/atomic -I$L/experimental_section_vars -DNRF_LOG_ALLOW_OVERFLOW=$o nrf_log_stress.c \
+ *      ../src/nrf_log_frontend.c ../src/nrf_log_str_formatter.c $L/ringbuf/nrf_ringbuf.c $L/atomic/nrf_atomic.c \
+ *      $L/bench_host/bench.c -o nrf_log_stress_$o
+ *
+ * Usage: nrf_log_stress [producers] [entries per producer] [interrupt period in us]
+ *
+ * Producer threads log standard entries and hexdumps carrying their ID, a sequence number and
+ * a checksum, while a consumer thread processes the logs, like the idle loop does. A periodic
+ * signal plays the part of an interrupt: it preempts any thread, possibly in the middle of
+ * logging or processing an entry, then processes the logs if the consumer is not busy, and
+ * logs a few entries itself. The backend checks that every entry is intact and that the entries
+ * of each producer come in order. When the producers are done, the number of entries processed
+ * plus the number of dropped entries reported by the logger must be the number of entries logged.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "sdk_common.h"
+#include "nrf_log_ctrl.h"
+#include "nrf_log_backend_interface.h"
+#include "nrf_log_internal.h"
+#include "nrf_atomic.h"
+#include "bench.h"
+
+
+#define PRODUCERS_MAX       64
+#define IRQ_ID(thread_idx)  (PRODUCERS_MAX + (thread_idx))     // Producer ID used by the signal.
+#define IDS_MAX             (2 * PRODUCERS_MAX + 1)
+#define IRQ_BURST           16
+#define HEXDUMP_MAX         40
+#define WATCHDOG_S          10
+#define ENTRY_MAX_SIZE      (sizeof(nrf_log_header_t) + 64)
+
+NRF_SECTION_ITEM_REGISTER(log_const_data, const nrf_log_module_const_data_t m_app_const) =
+{
+    .p_module_name = "app",
+};
+NRF_SECTION_ITEM_REGISTER(log_dynamic_data, nrf_log_module_dynamic_data_t m_app_dynamic);
+
+static uint32_t         m_producers;
+static uint32_t         m_entries;
+static volatile bool    m_done;
+static nrf_atomic_u32_t m_consumer_busy;
+static nrf_atomic_u32_t m_irq_logged;
+static nrf_atomic_u32_t m_producers_done;
+
+static __thread uint32_t t_irq_id;
+static __thread uint32_t t_irq_seq;
+
+// Accessed by the consumer only.
+static uint8_t          m_entry[ENTRY_MAX_SIZE];
+static uint32_t         m_next_seq[IDS_MAX];
+static uint64_t         m_processed;
+static uint64_t         m_dropped;
+static uint64_t         m_errors;
+static char const *     mp_first_error;
+static uint32_t         m_first_error_id;
+static uint32_t         m_first_error_seq;
+static bool             m_end;
+
+
+// The consumer allocates one entry at a time, and the backend is done with it when put returns.
+uint32_t nrf_memobj_pool_init(nrf_memobj_pool_t const * p_pool)
+{
+    return NRF_SUCCESS;
+}
+
+
+nrf_memobj_t * nrf_memobj_alloc(nrf_memobj_pool_t const * p_pool, size_t size)
+{
+    return (size <= sizeof(m_entry)) ? (nrf_memobj_t *)m_entry : NULL;
+}
+
+
+void nrf_memobj_get(nrf_memobj_t const * p_obj)
+{
+}
+
+
+void nrf_memobj_put(nrf_memobj_t * p_obj)
+{
+}
+
+
+void nrf_memobj_write(nrf_memobj_t * p_obj, void * p_data, size_t len, size_t offset)
+{
+    memcpy((uint8_t *)p_obj + offset, p_data, len);
+}
+
+
+void nrf_memobj_read(nrf_memobj_t * p_obj, void * p_data, size_t len, size_t offset)
+{
+    memcpy(p_data, (uint8_t const *)p_obj + offset, len);
+}
+
+
+static uint32_t checksum(uint32_t id, uint32_t seq)
+{
+    return (id * 0x9E3779B1) ^ (seq * 0x85EBCA6B) ^ 0x5A5A5A5A;
+}
+
+
+static uint8_t hexdump_byte(uint32_t id, uint32_t seq, uint32_t i)
+{
+    return (uint8_t)(checksum(id, seq) >> ((i % 4) * 8)) + (uint8_t)i;
+}
+
+
+static void error(char const * p_what, uint32_t id, uint32_t seq)
+{
+    // May be called from the signal handler, so the first error is printed at the end.
+    if (m_errors++ == 0)
+    {
+        mp_first_error    = p_what;
+        m_first_error_id  = id;
+        m_first_error_seq = seq;
+    }
+}
+
+
+static void entry_check(uint32_t id, uint32_t seq)
+{
+    if ((id >= IDS_MAX) || ((id >= m_producers) && (id < PRODUCERS_MAX)))
+    {
+        error("invalid producer", id, seq);
+        return;
+    }
+    if (seq < m_next_seq[id])
+    {
+        error("entry out of order", id, seq);
+    }
+    m_next_seq[id] = seq + 1;
+    m_processed++;
+}
+
+
+static void backend_put(nrf_log_backend_t const * p_backend, nrf_log_entry_t * p_entry)
+{
+    nrf_log_header_t header;
+    uint32_t         words[3];
+
+    nrf_memobj_read(p_entry, &header, HEADER_SIZE * sizeof(uint32_t), 0);
+    m_dropped += header.dropped;
+
+    if (header.base.generic.type == HEADER_TYPE_STD)
+    {
+        if (header.base.std.nargs == 0)
+        {
+            // Entry logged at the end to collect the dropped entries not reported yet.
+            m_end = (header.dropped == 0);
+            return;
+        }
+        if (header.base.std.nargs != ARRAY_SIZE(words))
+        {
+            error("invalid standard entry", 0, 0);
+            return;
+        }
+        nrf_memobj_read(p_entry, words, sizeof(words), HEADER_SIZE * sizeof(uint32_t));
+        if (words[2] != checksum(words[0], words[1]))
+        {
+            error("corrupted standard entry", words[0], words[1]);
+            return;
+        }
+        entry_check(words[0], words[1]);
+    }
+    else if (header.base.generic.type == HEADER_TYPE_HEXDUMP)
+    {
+        uint8_t  data[HEXDUMP_MAX];
+        uint32_t len = header.base.hexdump.len;
+
+        if ((len < 2 * sizeof(uint32_t)) || (len > sizeof(data)))
+        {
+            error("invalid hexdump", 0, 0);
+            return;
+        }
+        nrf_memobj_read(p_entry, data, len, HEADER_SIZE * sizeof(uint32_t));
+        memcpy(words, data, 2 * sizeof(uint32_t));
+        for (uint32_t i = 2 * sizeof(uint32_t); i < len; i++)
+        {
+            if (data[i] != hexdump_byte(words[0], words[1], i))
+            {
+                error("corrupted hexdump", words[0], words[1]);
+                return;
+            }
+        }
+        entry_check(words[0], words[1]);
+    }
+    else
+    {
+        error("invalid entry type", 0, 0);
+    }
+}
+
+
+static void backend_panic_set(nrf_log_backend_t const * p_backend)
+{
+}
+
+
+static void backend_flush(nrf_log_backend_t const * p_backend)
+{
+}
+
+
+static const nrf_log_backend_api_t m_backend_api =
+{
+    .put       = backend_put,
+    .panic_set = backend_panic_set,
+    .flush     = backend_flush,
+};
+
+NRF_LOG_BACKEND_DEF(m_backend, m_backend_api, NULL);
+
+
+static uint32_t timestamp_get(void)
+{
+    return 0;
+}
+
+
+static void entry_log(uint32_t id, uint32_t seq)
+{
+    uint32_t const severity_mid = NRF_LOG_SEVERITY_INFO;
+
+    if ((seq % 4) == 3)
+    {
+        uint8_t        data[HEXDUMP_MAX];
+        uint32_t const len = 2 * sizeof(uint32_t) + (seq % (HEXDUMP_MAX - 2 * sizeof(uint32_t) + 1));
+
+        memcpy(data, &id, sizeof(id));
+        memcpy(&data[sizeof(id)], &seq, sizeof(seq));
+        for (uint32_t i = 2 * sizeof(uint32_t); i < len; i++)
+        {
+            data[i] = hexdump_byte(id, seq, i);
+        }
+        nrf_log_frontend_hexdump(severity_mid, data, (uint16_t)len);
+    }
+    else
+    {
+        nrf_log_frontend_std_3(severity_mid, "%u %u %08x", id, seq, checksum(id, seq));
+    }
+}
+
+
+// Processes up to max_count entries unless another context is processing. There is one consumer
+// at a time, like on the device.
+static void logs_process(uint32_t max_count)
+{
+    if (nrf_atomic_u32_fetch_store(&m_consumer_busy, 1) == 0)
+    {
+        for (uint32_t i = 0; (i < max_count) && nrf_log_frontend_dequeue(); i++)
+        {
+        }
+        (void)nrf_atomic_u32_fetch_store(&m_consumer_busy, 0);
+    }
+}
+
+
+static void irq_handler(int signal)
+{
+    logs_process(UINT32_MAX);
+    for (uint32_t i = 0; i < IRQ_BURST; i++)
+    {
+        entry_log(t_irq_id, t_irq_seq++);
+    }
+    UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_irq_logged, IRQ_BURST));
+}
+
+
+static void irq_enable(uint32_t thread_idx)
+{
+    sigset_t set;
+
+    t_irq_id = IRQ_ID(thread_idx);
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set, SIGALRM);
+    (void)pthread_sigmask(SIG_UNBLOCK, &set, NULL);
+}
+
+
+static void * producer(void * p_arg)
+{
+    uint32_t const id = (uint32_t)(uintptr_t)p_arg;
+
+    irq_enable(id);
+    for (uint32_t seq = 0; seq < m_entries; seq++)
+    {
+        entry_log(id, seq);
+    }
+    UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_producers_done, 1));
+    return NULL;
+}
+
+
+static void * consumer(void * p_arg)
+{
+    irq_enable(PRODUCERS_MAX);
+    while (!m_done)
+    {
+        logs_process(UINT32_MAX);
+        sched_yield();
+    }
+    return NULL;
+}
+
+
+int main(int argc, char ** argv)
+{
+    pthread_t        producers[PRODUCERS_MAX];
+    pthread_t        consumer_thread;
+    sigset_t         set;
+    struct sigaction action = {.sa_handler = irq_handler};
+
+    m_producers = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 8;
+    m_entries   = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 10000000;
+
+    uint32_t const irq_period_us = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : 20;
+    if ((m_producers == 0) || (m_producers > PRODUCERS_MAX))
+    {
+        fprintf(stderr, "1 to %u producers are supported.\n", PRODUCERS_MAX);
+        return 1;
+    }
+
+    if ((nrf_log_init(timestamp_get, 32768) != NRF_SUCCESS) ||
+        (nrf_log_backend_add(&m_backend, NRF_LOG_SEVERITY_DEBUG) < 0))
+    {
+        fprintf(stderr, "Logger initialization failed.\n");
+        return 1;
+    }
+    nrf_log_backend_enable(&m_backend);
+
+    // Only the producers and the consumer are interrupted, the threads inherit the mask.
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set, SIGALRM);
+    (void)pthread_sigmask(SIG_BLOCK, &set, NULL);
+    (void)sigaction(SIGALRM, &action, NULL);
+
+    struct itimerval timer =
+    {
+        .it_interval = {.tv_usec = irq_period_us},
+        .it_value    = {.tv_usec = irq_period_us},
+    };
+
+    uint64_t const start = bench_now_ns();
+    (void)pthread_create(&consumer_thread, NULL, consumer, NULL);
+    for (uint32_t i = 0; i < m_producers; i++)
+    {
+        (void)pthread_create(&producers[i], NULL, producer, (void *)(uintptr_t)i);
+    }
+    (void)setitimer(ITIMER_REAL, &timer, NULL);
+
+    // A corrupted buffer can make the logger loop forever.
+    uint64_t processed = 0;
+    uint32_t idle_s    = 0;
+    while (m_producers_done < m_producers)
+    {
+        sleep(1);
+        idle_s    = (m_processed == processed) ? (idle_s + 1) : 0;
+        processed = m_processed;
+        if (idle_s == WATCHDOG_S)
+        {
+            printf("FAILED: no entry processed for %u s\n", WATCHDOG_S);
+            _exit(1);
+        }
+    }
+    for (uint32_t i = 0; i < m_producers; i++)
+    {
+        (void)pthread_join(producers[i], NULL);
+    }
+    m_done = true;
+    (void)pthread_join(consumer_thread, NULL);
+    uint64_t const elapsed = bench_now_ns() - start;
+
+    timer.it_interval.tv_usec = 0;
+    timer.it_value.tv_usec    = 0;
+    (void)setitimer(ITIMER_REAL, &timer, NULL);
+
+    // Process the remaining entries, then log entries until one reports no more dropped entries.
+    while (nrf_log_frontend_dequeue())
+    {
+    }
+    while (!m_end)
+    {
+        nrf_log_frontend_std_0(NRF_LOG_SEVERITY_INFO, "end");
+        while (nrf_log_frontend_dequeue())
+        {
+        }
+    }
+
+    uint64_t const logged = (uint64_t)m_producers * m_entries + m_irq_logged;
+
+    printf("overflow %s, %u producers, %u entries each, interrupt every %u us\n",
+           NRF_LOG_ALLOW_OVERFLOW ? "allowed" : "not allowed", m_producers, m_entries, irq_period_us);
+    printf("logged     %12llu, %u from interrupts, %.1f ns/entry\n",
+           (unsigned long long)logged, m_irq_logged, (double)elapsed / logged);
+    printf("processed  %12llu\n", (unsigned long long)m_processed);
+    printf("dropped    %12llu\n", (unsigned long long)m_dropped);
+
+    if (m_errors != 0)
+    {
+        printf("FAILED: %llu invalid entries, first: %s, producer %u, entry %u\n",
+               (unsigned long long)m_errors, mp_first_error, m_first_error_id, m_first_error_seq);
+        return 1;
+    }
+    if (m_processed + m_dropped != logged)
+    {
+        printf("FAILED: %lld entries are not accounted for\n",
+               (long long)(logged - m_processed - m_dropped));
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -93,6 +93,15 @@ typedef struct
      * @brief @ref nrf_log_backend_flush
      */
     void (*flush)(nrf_log_backend_t const * p_backend);
+
+    /**
+     * @brief @ref nrf_log_backend_put_batch
+     *
+     * Optional. If NULL, the entries of a batch are passed one by one with @ref put.
+     */
+    void (*put_batch)(nrf_log_backend_t const * p_backend,
+                      nrf_log_entry_t * const * pp_entries,
+                      uint32_t count);
 } nrf_log_backend_api_t;
 
 /**
@@ -158,6 +167,21 @@ NRF_SECTION_DEF(NRF_LOG_BACKEND_SECTION_NAME, nrf_log_backend_t);
 __STATIC_INLINE void nrf_log_backend_put(nrf_log_backend_t const * const p_backend,
                                          nrf_log_entry_t * p_msg);
 
+/**
+ * @brief Function for putting a batch of messages with log entries to the backend.
+ *
+ * The backend can process the whole batch at once, for example format all entries and
+ * transmit them with a single transport write. If the backend does not implement it, the
+ * entries are put one by one.
+ *
+ * @param[in] p_backend  Pointer to the backend instance.
+ * @param[in] pp_msg     Array of pointers to messages with log entries, oldest first.
+ * @param[in] count      Number of messages.
+ */
+__STATIC_INLINE void nrf_log_backend_put_batch(nrf_log_backend_t const * const p_backend,
+                                               nrf_log_entry_t * const * pp_msg,
+                                               uint32_t count);
+
 /**
  * @brief Function for reconfiguring backend to panic mode.
  *
@@ -225,6 +249,24 @@ __STATIC_INLINE void nrf_log_backend_put(nrf_log_backend_t const * const p_backe
     p_backend->p_api->put(p_backend, p_msg);
 }
 
+__STATIC_INLINE void nrf_log_backend_put_batch(nrf_log_backend_t const * const p_backend,
+                                               nrf_log_entry_t * const * pp_msg,
+                                               uint32_t count)
+{
+    if (p_backend->p_api->put_batch != NULL)
+    {
+        p_backend->p_api->put_batch(p_backend, pp_msg, count);
+    }
+    else
+    {
+        uint32_t i;
+        for (i = 0; i < count; i++)
+        {
+            p_backend->p_api->put(p_backend, pp_msg[i]);
+        }
+    }
+}
+
 __STATIC_INLINE void nrf_log_backend_panic_set(nrf_log_backend_t const * const p_backend)
 {
     p_backend->p_api->panic_set(p_backend);
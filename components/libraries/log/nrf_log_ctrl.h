@@ -93,6 +93,21 @@ typedef uint32_t (*nrf_log_timestamp_func_t)(void);
  */
 #define NRF_LOG_PROCESS()    NRF_LOG_INTERNAL_PROCESS()
 
+/**@brief Macro for processing up to a given number of log entries in one pass.
+ *
+ * The entries are passed to each backend at once, so that backends which implement
+ * @ref nrf_log_backend_put_batch can transmit them together. At most @ref NRF_LOG_BATCH_SIZE
+ * entries are processed.
+ *
+ * @note If logs are not deferred, this call has no use and is defined as 'false'.
+ *
+ * @param max_count Maximum number of entries to process.
+ *
+ * @retval true    There are more logs to process in the buffer.
+ * @retval false   No more logs in the buffer.
+ */
+#define NRF_LOG_PROCESS_BATCH(max_count) NRF_LOG_INTERNAL_PROCESS_BATCH(max_count)
+
 /** @brief Macro for processing all log entries from the buffer.
  * It blocks until all buffered entries are processed by the backend.
  *
@@ -160,6 +175,19 @@ void nrf_log_panic(void);
  */
 bool nrf_log_frontend_dequeue(void);
 
+/**
+ * @brief Function for handling a batch of log entries.
+ *
+ * Use this function only if the logs are buffered. It takes up to @p max_count entries, but no
+ * more than @ref NRF_LOG_BATCH_SIZE, from the buffer and passes them to each backend at once.
+ *
+ * @param max_count Maximum number of entries to process.
+ *
+ * @retval true  If there are more entries to process.
+ * @retval false If there are no more entries to process.
+ */
+bool nrf_log_frontend_dequeue_batch(uint32_t max_count);
+
 /**
  * @brief Function for getting number of independent log modules registered into the logger.
  *
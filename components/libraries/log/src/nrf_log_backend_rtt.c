@@ -105,6 +105,14 @@ static void nrf_log_backend_rtt_put(nrf_log_backend_t const * p_backend,
     nrf_log_backend_serial_put(p_backend, p_msg, m_string_buff, NRF_LOG_BACKEND_RTT_TEMP_BUFFER_SIZE, serial_tx);
 }
 
+static void nrf_log_backend_rtt_put_batch(nrf_log_backend_t const * p_backend,
+                                          nrf_log_entry_t * const * pp_msg,
+                                          uint32_t count)
+{
+    nrf_log_backend_serial_put_batch(p_backend, pp_msg, count, m_string_buff,
+                                     NRF_LOG_BACKEND_RTT_TEMP_BUFFER_SIZE, serial_tx);
+}
+
 static void nrf_log_backend_rtt_flush(nrf_log_backend_t const * p_backend)
 {
 
@@ -119,5 +127,6 @@ const nrf_log_backend_api_t nrf_log_backend_rtt_api = {
         .put       = nrf_log_backend_rtt_put,
         .flush     = nrf_log_backend_rtt_flush,
         .panic_set = nrf_log_backend_rtt_panic_set,
+        .put_batch = nrf_log_backend_rtt_put_batch,
 };
 #endif //NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_BACKEND_RTT)
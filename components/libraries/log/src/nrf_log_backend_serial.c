@@ -43,23 +43,143 @@
 #include "nrf_log_str_formatter.h"
 #include "nrf_log_internal.h"
 
-void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
-                               nrf_log_entry_t * p_msg,
-                               uint8_t * p_buffer,
-                               uint32_t  length,
-                               nrf_fprintf_fwrite tx_func)
+#define TEXT_BATCH_FORMAT_BUFFER_SIZE 32
+
+// Output buffer which is passed to the transport only when it is full or flushed.
+typedef struct
 {
-    nrf_memobj_get(p_msg);
+    uint8_t          * p_buffer;
+    uint32_t           length;
+    uint32_t           cnt;
+    nrf_fprintf_fwrite tx_func;
+} out_ctx_t;
 
-    nrf_fprintf_ctx_t fprintf_ctx = {
-            .p_io_buffer = (char *)p_buffer,
-            .io_buffer_size = length,
-            .io_buffer_cnt = 0,
-            .auto_flush = false,
-            .p_user_ctx = NULL,
-            .fwrite = tx_func
-    };
+static void out_flush(out_ctx_t * p_ctx)
+{
+    if (p_ctx->cnt > 0)
+    {
+        p_ctx->tx_func(NULL, (char const *)p_ctx->p_buffer, p_ctx->cnt);
+        p_ctx->cnt = 0;
+    }
+}
+
+static void out_write(out_ctx_t * p_ctx, void const * p_data, uint32_t len)
+{
+    uint8_t const * p_src = (uint8_t const *)p_data;
+
+    while (len > 0)
+    {
+        uint32_t chunk_len = MIN(len, p_ctx->length - p_ctx->cnt);
+
+        memcpy(&p_ctx->p_buffer[p_ctx->cnt], p_src, chunk_len);
+        p_ctx->cnt += chunk_len;
+        p_src      += chunk_len;
+        len        -= chunk_len;
+
+        if (p_ctx->cnt == p_ctx->length)
+        {
+            out_flush(p_ctx);
+        }
+    }
+}
 
+#if NRF_LOG_BACKEND_SERIAL_DICTIONARY
+#define DICT_FRAME_HEADER_MAX_SIZE  16
+
+static void dict_put(nrf_log_entry_t * p_msg, out_ctx_t * p_ctx)
+{
+    nrf_log_header_t header;
+    size_t           memobj_offset = 0;
+    uint8_t          frame[DICT_FRAME_HEADER_MAX_SIZE];
+    uint32_t         frame_len = 0;
+
+    nrf_memobj_read(p_msg, &header, HEADER_SIZE*sizeof(uint32_t), memobj_offset);
+    memobj_offset = HEADER_SIZE*sizeof(uint32_t);
+
+    // The severity bits are at the same position in both entry types.
+    frame[frame_len++] = NRF_LOG_DICT_SYNC;
+    frame[frame_len++] = (uint8_t)(header.base.generic.type | (header.base.std.severity << 2) |
+                                   (NRF_LOG_USES_TIMESTAMP ? NRF_LOG_DICT_FLAG_TIMESTAMP : 0) |
+                                   (header.dropped ? NRF_LOG_DICT_FLAG_DROPPED : 0));
+    frame[frame_len++] = (uint8_t)header.module_id;
+    frame[frame_len++] = (uint8_t)(header.module_id >> 8);
+
+    if (NRF_LOG_USES_TIMESTAMP)
+    {
+        memcpy(&frame[frame_len], &header.timestamp, sizeof(header.timestamp));
+        frame_len += sizeof(header.timestamp);
+    }
+
+    if (header.dropped)
+    {
+        memcpy(&frame[frame_len], &header.dropped, sizeof(header.dropped));
+        frame_len += sizeof(header.dropped);
+    }
+
+    if (header.base.generic.type == HEADER_TYPE_STD)
+    {
+        uint32_t nargs = header.base.std.nargs;
+        uint32_t addr  = header.base.std.addr;
+        uint32_t args[NRF_LOG_MAX_NUM_OF_ARGS];
+        uint8_t  str_mask = 0;
+
+        nrf_memobj_read(p_msg, args, nargs*sizeof(uint32_t), memobj_offset);
+
+        for (uint32_t i = 0; i < nargs; i++)
+        {
+            if (nrf_log_pushed_str_check((char const *)args[i]))
+            {
+                str_mask |= (uint8_t)(1 << i);
+            }
+        }
+
+        frame[frame_len++] = (uint8_t)nargs;
+        frame[frame_len++] = str_mask;
+        memcpy(&frame[frame_len], &addr, sizeof(addr));
+        frame_len += sizeof(addr);
+
+        out_write(p_ctx, frame, frame_len);
+        out_write(p_ctx, args, nargs*sizeof(uint32_t));
+
+        for (uint32_t i = 0; i < nargs; i++)
+        {
+            if (str_mask & (1 << i))
+            {
+                char const * p_str = (char const *)args[i];
+                out_write(p_ctx, p_str, strlen(p_str) + 1);
+            }
+        }
+    }
+    else if (header.base.generic.type == HEADER_TYPE_HEXDUMP)
+    {
+        uint32_t data_len = header.base.hexdump.len;
+
+        frame[frame_len++] = (uint8_t)data_len;
+        frame[frame_len++] = (uint8_t)(data_len >> 8);
+        out_write(p_ctx, frame, frame_len);
+
+        // Read the data straight into the output buffer.
+        while (data_len > 0)
+        {
+            uint32_t chunk_len = MIN(data_len, p_ctx->length - p_ctx->cnt);
+
+            nrf_memobj_read(p_msg, &p_ctx->p_buffer[p_ctx->cnt], chunk_len, memobj_offset);
+            memobj_offset += chunk_len;
+            data_len      -= chunk_len;
+            p_ctx->cnt    += chunk_len;
+
+            if (p_ctx->cnt == p_ctx->length)
+            {
+                out_flush(p_ctx);
+            }
+        }
+    }
+}
+#endif // NRF_LOG_BACKEND_SERIAL_DICTIONARY
+
+#if !NRF_LOG_BACKEND_SERIAL_DICTIONARY
+static void text_put(nrf_log_entry_t * p_msg, nrf_fprintf_ctx_t * p_fprintf_ctx)
+{
     nrf_log_str_formatter_entry_params_t params;
 
     nrf_log_header_t header;
@@ -88,7 +208,7 @@ void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
                                   args,
                                   nargs,
                                   &params,
-                                  &fprintf_ctx);
+                                  p_fprintf_ctx);
 
     }
     else if (header.base.generic.type == HEADER_TYPE_HEXDUMP)
@@ -107,10 +227,93 @@ void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
             nrf_log_hexdump_entry_process(data_buf,
                                          chunk_len,
                                          &params,
-                                         &fprintf_ctx);
+                                         p_fprintf_ctx);
         } while (data_len > 0);
     }
-    nrf_memobj_put(p_msg);
     /*lint -restore*/
 }
+
+// Formatted text is appended to the output buffer instead of being sent.
+static void text_batch_fwrite(void const * p_user_ctx, char const * p_str, size_t length)
+{
+    out_write((out_ctx_t *)p_user_ctx, p_str, length);
+}
+#endif // !NRF_LOG_BACKEND_SERIAL_DICTIONARY
+
+void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
+                               nrf_log_entry_t * p_msg,
+                               uint8_t * p_buffer,
+                               uint32_t  length,
+                               nrf_fprintf_fwrite tx_func)
+{
+    nrf_memobj_get(p_msg);
+
+#if NRF_LOG_BACKEND_SERIAL_DICTIONARY
+    out_ctx_t ctx = {
+            .p_buffer = p_buffer,
+            .length   = length,
+            .cnt      = 0,
+            .tx_func  = tx_func
+    };
+
+    dict_put(p_msg, &ctx);
+    out_flush(&ctx);
+#else
+
+    nrf_fprintf_ctx_t fprintf_ctx = {
+            .p_io_buffer = (char *)p_buffer,
+            .io_buffer_size = length,
+            .io_buffer_cnt = 0,
+            .auto_flush = false,
+            .p_user_ctx = NULL,
+            .fwrite = tx_func
+    };
+
+    text_put(p_msg, &fprintf_ctx);
+#endif // NRF_LOG_BACKEND_SERIAL_DICTIONARY
+    nrf_memobj_put(p_msg);
+}
+
+void nrf_log_backend_serial_put_batch(nrf_log_backend_t const * p_backend,
+                                      nrf_log_entry_t * const * pp_msg,
+                                      uint32_t count,
+                                      uint8_t * p_buffer,
+                                      uint32_t  length,
+                                      nrf_fprintf_fwrite tx_func)
+{
+    out_ctx_t ctx = {
+            .p_buffer = p_buffer,
+            .length   = length,
+            .cnt      = 0,
+            .tx_func  = tx_func
+    };
+    uint32_t i;
+
+#if !NRF_LOG_BACKEND_SERIAL_DICTIONARY
+    // The formatter flushes its buffer at the end of each entry, so it gets a small buffer of its
+    // own and the output buffer collects the entries.
+    char format_buf[TEXT_BATCH_FORMAT_BUFFER_SIZE];
+    nrf_fprintf_ctx_t fprintf_ctx = {
+            .p_io_buffer = format_buf,
+            .io_buffer_size = sizeof(format_buf),
+            .io_buffer_cnt = 0,
+            .auto_flush = false,
+            .p_user_ctx = &ctx,
+            .fwrite = text_batch_fwrite
+    };
+#endif
+
+    for (i = 0; i < count; i++)
+    {
+        nrf_memobj_get(pp_msg[i]);
+#if NRF_LOG_BACKEND_SERIAL_DICTIONARY
+        dict_put(pp_msg[i], &ctx);
+#else
+        text_put(pp_msg[i], &fprintf_ctx);
+#endif
+        nrf_memobj_put(pp_msg[i]);
+    }
+
+    out_flush(&ctx);
+}
 #endif //NRF_LOG_ENABLED
@@ -58,9 +58,39 @@ extern "C" {
 #endif
 
 /**
- * @brief A function for processing logger entry with simple serial interface as output.
+ * @brief Dictionary mode of the serial backends.
+ *
+ * When enabled, the entries are not formatted on the device. Each entry is sent as a binary frame
+ * holding the address of the format string and the raw arguments, and the text is rendered on the
+ * host by the nrf_log_dict_decode tool, which resolves the format strings and the module names from
+ * the ELF file of the application. All values are little-endian. A frame is made of:
  *
+ * - Sync byte, @ref NRF_LOG_DICT_SYNC.
+ * - Flags byte: the entry type (HEADER_TYPE_STD or HEADER_TYPE_HEXDUMP) in bits 0-1, the severity in
+ *   bits 2-4, @ref NRF_LOG_DICT_FLAG_TIMESTAMP and @ref NRF_LOG_DICT_FLAG_DROPPED.
+ * - Module ID, 2 bytes.
+ * - Timestamp, 4 bytes, if @ref NRF_LOG_DICT_FLAG_TIMESTAMP is set.
+ * - Number of dropped entries, 2 bytes, if @ref NRF_LOG_DICT_FLAG_DROPPED is set.
+ * - For standard entries: the number of arguments (1 byte), a mask of the arguments that are strings
+ *   stored by @ref nrf_log_push (1 byte), the format string address (4 bytes), the arguments
+ *   (4 bytes each) and then the pushed strings, null-terminated, in argument order.
+ * - For hexdump entries: the data length (2 bytes) and the data.
  *
+ * Strings passed as arguments must be either constant, so that they can be found in the ELF file,
+ * or stored with @ref nrf_log_push.
+ */
+#ifndef NRF_LOG_BACKEND_SERIAL_DICTIONARY
+#define NRF_LOG_BACKEND_SERIAL_DICTIONARY 0
+#endif
+
+#define NRF_LOG_DICT_SYNC           0xA5 //!< First byte of every frame.
+#define NRF_LOG_DICT_FLAG_TIMESTAMP 0x20 //!< The frame holds a timestamp.
+#define NRF_LOG_DICT_FLAG_DROPPED   0x40 //!< The frame holds the number of dropped entries.
+
+/**
+ * @brief A function for processing logger entry with simple serial interface as output.
+ *
+ * In dictionary mode, the entry is sent as a binary frame instead of being formatted.
  */
 void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
                                nrf_log_entry_t * p_msg,
@@ -68,6 +98,20 @@ void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
                                uint32_t  length,
                                nrf_fprintf_fwrite tx_func);
 
+/**
+ * @brief A function for processing a batch of logger entries with simple serial interface as output.
+ *
+ * The entries are formatted one after another into @p p_buffer, which is passed to @p tx_func
+ * only when it is full and after the last entry. A batch of short entries is then sent with a
+ * single transport write, if the buffer is large enough.
+ */
+void nrf_log_backend_serial_put_batch(nrf_log_backend_t const * p_backend,
+                                      nrf_log_entry_t * const * pp_msg,
+                                      uint32_t count,
+                                      uint8_t * p_buffer,
+                                      uint32_t  length,
+                                      nrf_fprintf_fwrite tx_func);
+
 #endif //NRF_LOG_BACKEND_SERIAL_H
 
 #ifdef __cplusplus
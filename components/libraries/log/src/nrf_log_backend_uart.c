@@ -96,6 +96,14 @@ static void nrf_log_backend_uart_put(nrf_log_backend_t const * p_backend,
                                NRF_LOG_BACKEND_UART_TEMP_BUFFER_SIZE, serial_tx);
 }
 
+static void nrf_log_backend_uart_put_batch(nrf_log_backend_t const * p_backend,
+                                           nrf_log_entry_t * const * pp_msg,
+                                           uint32_t count)
+{
+    nrf_log_backend_serial_put_batch(p_backend, pp_msg, count, m_string_buff,
+                                     NRF_LOG_BACKEND_UART_TEMP_BUFFER_SIZE, serial_tx);
+}
+
 static void nrf_log_backend_uart_flush(nrf_log_backend_t const * p_backend)
 {
 
@@ -112,5 +120,6 @@ const nrf_log_backend_api_t nrf_log_backend_uart_api = {
         .put       = nrf_log_backend_uart_put,
         .flush     = nrf_log_backend_uart_flush,
         .panic_set = nrf_log_backend_uart_panic_set,
+        .put_batch = nrf_log_backend_uart_put_batch,
 };
 #endif //NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_BACKEND_UART)
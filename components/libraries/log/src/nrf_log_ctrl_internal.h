@@ -63,10 +63,16 @@
         nrf_log_init(GET_VA_ARG_1(__VA_ARGS__),  \
                      GET_VA_ARG_1(GET_ARGS_AFTER_1(__VA_ARGS__, LOG_TIMESTAMP_DEFAULT_FREQUENCY)))
 
+// Maximum number of entries passed to the backends at once.
+#ifndef NRF_LOG_BATCH_SIZE
+#define NRF_LOG_BATCH_SIZE 8
+#endif
+
 #define NRF_LOG_INTERNAL_PROCESS() nrf_log_frontend_dequeue()
+#define NRF_LOG_INTERNAL_PROCESS_BATCH(max_count) nrf_log_frontend_dequeue_batch(max_count)
 #define NRF_LOG_INTERNAL_FLUSH()            \
     do {                                    \
-        while (NRF_LOG_INTERNAL_PROCESS()); \
+        while (NRF_LOG_INTERNAL_PROCESS_BATCH(NRF_LOG_BATCH_SIZE)); \
     } while (0)
 
 #define NRF_LOG_INTERNAL_FINAL_FLUSH()      \
@@ -78,6 +84,7 @@
 
 #else // NRF_MODULE_ENABLED(NRF_LOG)
 #define NRF_LOG_INTERNAL_PROCESS()            false
+#define NRF_LOG_INTERNAL_PROCESS_BATCH(max_count) false
 #define NRF_LOG_INTERNAL_FLUSH()
 #define NRF_LOG_INTERNAL_INIT(...) NRF_SUCCESS
 #define NRF_LOG_INTERNAL_HANDLERS_SET(default_handler, bytes_handler) \
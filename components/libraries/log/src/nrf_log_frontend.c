@@ -82,19 +82,28 @@ NRF_RINGBUF_DEF(m_log_push_ringbuf, NRF_LOG_STR_PUSH_BUFFER_SIZE);
  * that logger may break when indexes overflows. However, it is quite unlikely.
  * With rate of 1000 log entries with 2 parameters per second such situation
  * would happen after 12 days.
+ *
+ * @note The buffer is shared without critical sections. A producer reserves space by
+ * moving wr_idx forward with a compare-and-swap and marks the entry as in progress until
+ * it is complete. The oldest entry is removed, by the consumer or by a producer which
+ * needs space, by moving rd_idx forward with a compare-and-swap, so that each entry is
+ * either processed or counted as dropped exactly once. pending counts the producers which
+ * have reserved space but have not written the in progress header yet; the consumer only
+ * reads entries below wr_idx_safe, the last write index seen when no such producer existed.
  */
 typedef struct
 {
-    uint32_t                  wr_idx;          // Current write index (never reset)
-    uint32_t                  rd_idx;          // Current read index  (never_reset)
+    nrf_atomic_u32_t          wr_idx;          // Current write index (never reset)
+    nrf_atomic_u32_t          rd_idx;          // Current read index  (never_reset)
     uint32_t                  mask;            // Size of buffer (must be power of 2) presented as mask
     uint32_t                  buffer[NRF_LOG_BUF_WORDS];
     nrf_log_timestamp_func_t  timestamp_func;  // A pointer to function that returns timestamp
     nrf_log_backend_t const * p_backend_head;
-    nrf_atomic_flag_t         log_skipping;
-    nrf_atomic_flag_t         log_skipped;
+    nrf_atomic_u32_t          pending;         // Number of producers between reservation and in progress header
+    uint32_t                  wr_idx_safe;     // Write index below which all headers are written (consumer only)
     nrf_atomic_u32_t          log_dropped_cnt;
     bool                      autoflush;
+    bool                      panic;           // Entries left in progress are never completed.
 } log_data_t;
 
 static log_data_t   m_log_data;
@@ -121,9 +130,10 @@ ret_code_t nrf_log_init(nrf_log_timestamp_func_t timestamp_func, uint32_t timest
     m_log_data.mask         = NRF_LOG_BUF_WORDS - 1;
     m_log_data.wr_idx       = 0;
     m_log_data.rd_idx       = 0;
-    m_log_data.log_skipped  = 0;
-    m_log_data.log_skipping = 0;
+    m_log_data.pending      = 0;
+    m_log_data.wr_idx_safe  = 0;
     m_log_data.autoflush    = NRF_LOG_DEFERRED ? false : true;
+    m_log_data.panic        = false;
     if (NRF_LOG_USES_TIMESTAMP)
     {
         nrf_log_str_formatter_timestamp_freq_set(timestamp_freq);
@@ -310,98 +320,88 @@ nrf_log_severity_t nrf_log_module_filter_get(uint32_t backend_id,
     return severity;
 }
 /**
- * Function examines current header and omits packets which are in progress.
+ * Function returns the number of words taken by an entry, including its header. The length of
+ * an entry in progress is given in words, the length of a complete hexdump entry in bytes.
+ * The header may be invalid if the entry was removed after read index was read.
  */
-static bool invalid_packets_omit(nrf_log_header_t const * p_header, uint32_t * p_rd_idx)
+static uint32_t entry_len_get(nrf_log_main_header_t header)
 {
-    bool ret = false;
-    if (p_header->base.generic.in_progress == 1)
+    uint32_t len = HEADER_SIZE;
+
+    switch (header.generic.type)
     {
-        switch (p_header->base.generic.type)
-        {
-        case HEADER_TYPE_STD:
-            *p_rd_idx += (HEADER_SIZE + p_header->base.std.nargs);
-            break;
-        case HEADER_TYPE_HEXDUMP:
-            *p_rd_idx += (HEADER_SIZE + p_header->base.hexdump.len);
-            break;
-        default:
-            break;
-        }
-        ret = true;
+    case HEADER_TYPE_STD:
+        len += header.std.nargs;
+        break;
+    case HEADER_TYPE_HEXDUMP:
+        len += header.hexdump.in_progress ? header.hexdump.len :
+                                            CEIL_DIV(header.hexdump.len, sizeof(uint32_t));
+        break;
+    default:
+        break;
     }
-    return ret;
+    return len;
 }
+
 /**
- * @brief Skips the oldest, not processed logs to make space for new logs.
- * @details This function moves forward read index to prepare space for new logs.
+ * @brief Skips the oldest, not processed log to make space for new logs.
+ * @details This function moves forward read index to prepare space for new logs. An entry which
+ * is in progress is not skipped because its producer is still writing it, and the oldest
+ * header is not read while a producer may not have written its header yet.
+ *
+ * @return True if read index was moved forward, by this function or by another context.
  */
-
-static uint32_t log_skip(void)
+static bool log_skip(void)
 {
-    uint16_t dropped = 0;
-
-    (void)nrf_atomic_flag_set(&m_log_data.log_skipped);
-    (void)nrf_atomic_flag_set(&m_log_data.log_skipping);
-
-    uint32_t           rd_idx = m_log_data.rd_idx;
-    uint32_t           mask   = m_log_data.mask;
-    nrf_log_header_t * p_header = (nrf_log_header_t *)&m_log_data.buffer[rd_idx & mask];
-    nrf_log_header_t   header;
-
-    // Skip packets that may be invalid (interrupted while being in progress)
-    do {
-        if (invalid_packets_omit(p_header, &rd_idx))
-        {
-            //something was omitted. Point to new header and try again.
-            p_header = (nrf_log_header_t *)&m_log_data.buffer[rd_idx & mask];
-        }
-        else
-        {
-            break;
-        }
-    } while (true);
+    uint32_t rd_idx = m_log_data.rd_idx;
+    uint32_t mask   = m_log_data.mask;
 
-    uint32_t i;
-    for (i = 0; i < HEADER_SIZE; i++)
+    if (rd_idx == m_log_data.wr_idx)
     {
-        ((uint32_t*)&header)[i] = m_log_data.buffer[rd_idx++ & mask];
+        // Buffer was emptied in the meantime.
+        return true;
     }
 
-    switch (header.base.generic.type)
+    __DMB();
+    if (m_log_data.pending != 0)
     {
-        case HEADER_TYPE_HEXDUMP:
-            dropped = header.dropped;
-            rd_idx += CEIL_DIV(header.base.hexdump.len, sizeof(uint32_t));
-            break;
-        case HEADER_TYPE_STD:
-            dropped = header.dropped;
-            rd_idx += header.base.std.nargs;
-            break;
-        default:
-            ASSERT(false);
-            break;
+        return false;
     }
 
-    uint32_t log_skipping_tmp = nrf_atomic_flag_clear_fetch(&m_log_data.log_skipping);
-    //update read index only if log_skip was not interrupted by another log skip
-    if (log_skipping_tmp)
+    nrf_log_main_header_t header;
+    header.raw = m_log_data.buffer[rd_idx & mask];
+    if (header.generic.in_progress)
     {
-        m_log_data.rd_idx = rd_idx;
+        return false;
     }
 
-    return (uint32_t)dropped;
+    uint32_t dropped = m_log_data.buffer[(rd_idx + 1) & mask] >> 16;
+    uint32_t next    = rd_idx + entry_len_get(header);
+
+    // The header is valid only if the entry was not removed in the meantime, that is if read
+    // index did not change. Only the context which moves read index accounts for the entry.
+    if (nrf_atomic_u32_cmp_exch(&m_log_data.rd_idx, &rd_idx, next))
+    {
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.log_dropped_cnt, 1 + dropped));
+    }
+    return true;
 }
 
 /**
  * @brief Function for getting number of dropped logs. Dropped counter is reset after reading.
  *
- * @return Number of dropped logs saturated to 16 bits.
+ * @return Number of dropped logs saturated to 16 bits. The remainder is kept in the counter.
  */
 static inline uint32_t dropped_sat16_get(void)
 {
     uint32_t dropped = nrf_atomic_u32_fetch_store(&m_log_data.log_dropped_cnt, 0);
-    return __USAT(dropped, 16); //Saturate to 16 bits
+    uint32_t sat     = __USAT(dropped, 16); //Saturate to 16 bits
+
+    if (dropped != sat)
+    {
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.log_dropped_cnt, dropped - sat));
+    }
+    return sat;
 }
 
 
@@ -424,18 +424,27 @@ static inline void std_header_set(uint32_t severity_mid,
         m_log_data.buffer[(wr_idx + 2) & mask] = m_log_data.timestamp_func();
     }
 
-    nrf_log_header_t * p_header    = (nrf_log_header_t *)&m_log_data.buffer[wr_idx & mask];
-    p_header->base.std.severity    = severity_mid & NRF_LOG_LEVEL_MASK;
-    p_header->base.std.nargs       = nargs;
-    p_header->base.std.addr        = ((uint32_t)(p_str) & STD_ADDR_MASK);
-    p_header->base.std.type        = HEADER_TYPE_STD;
-    p_header->base.std.in_progress = 0;
+    nrf_log_main_header_t header;
+    header.raw             = 0;
+    header.std.severity    = severity_mid & NRF_LOG_LEVEL_MASK;
+    header.std.nargs       = nargs;
+    header.std.addr        = ((uint32_t)(p_str) & STD_ADDR_MASK);
+    header.std.type        = HEADER_TYPE_STD;
+    header.std.in_progress = 0;
+
+    // Entry is committed by a single write of the header, after the rest of the entry.
+    __DMB();
+    m_log_data.buffer[wr_idx & mask] = header.raw;
 }
 
 /**
  * @brief Allocates chunk in a buffer for one entry and injects overflow if
  * there is no room for requested entry.
  *
+ * @details The chunk is reserved by moving write index forward with a compare-and-swap, so
+ * the function can be interrupted by, and called from, any context without disabling interrupts.
+ * The entry is marked as in progress until its header is completed.
+ *
  * @param content_len   Number of 32bit arguments. In case of allocating for hex dump it
  *                      is the size of the buffer in 32bit words (ceiled).
  * @param p_wr_idx      Pointer to write index.
@@ -446,54 +455,56 @@ static inline void std_header_set(uint32_t severity_mid,
 static inline bool buf_prealloc(uint32_t content_len, uint32_t * p_wr_idx, bool std)
 {
     uint32_t req_len = content_len + HEADER_SIZE;
-    bool     ret            = true;
-    CRITICAL_REGION_ENTER();
-    *p_wr_idx = m_log_data.wr_idx;
-    uint32_t available_words = (m_log_data.mask + 1) - (m_log_data.wr_idx - m_log_data.rd_idx);
-    while (req_len > available_words)
-    {
-        UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.log_dropped_cnt, 1));
-        if (NRF_LOG_ALLOW_OVERFLOW)
+    uint32_t wr_idx  = m_log_data.wr_idx;
+
+    while (true)
+    {
+        // Read index is read after write index, so the free space is never overestimated if
+        // write index is still the same when it is swapped.
+        uint32_t available_words = (m_log_data.mask + 1) - (wr_idx - m_log_data.rd_idx);
+        if (req_len > available_words)
         {
-            uint32_t dropped_in_skip = log_skip();
-            UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.log_dropped_cnt, dropped_in_skip));
-            available_words = (m_log_data.mask + 1) - (m_log_data.wr_idx - m_log_data.rd_idx);
+            if (!NRF_LOG_ALLOW_OVERFLOW || !log_skip())
+            {
+                UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.log_dropped_cnt, 1));
+                return false;
+            }
+            wr_idx = m_log_data.wr_idx;
+            continue;
         }
-        else
+
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_log_data.pending, 1));
+        if (nrf_atomic_u32_cmp_exch(&m_log_data.wr_idx, &wr_idx, wr_idx + req_len))
         {
-            ret = false;
             break;
         }
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_sub(&m_log_data.pending, 1));
     }
 
-    if (ret)
-    {
-        nrf_log_main_header_t invalid_header;
-        invalid_header.raw = 0;
-
-        if (std)
-        {
-            invalid_header.std.type        = HEADER_TYPE_STD;
-            invalid_header.std.in_progress = 1;
-            invalid_header.std.nargs       = content_len;
-        }
-        else
-        {
-            invalid_header.hexdump.type = HEADER_TYPE_HEXDUMP;
-            invalid_header.hexdump.in_progress = 1;
-            invalid_header.hexdump.len = content_len;
-        }
+    nrf_log_main_header_t invalid_header;
+    invalid_header.raw = 0;
 
-        nrf_log_main_header_t * p_header =
-                   (nrf_log_main_header_t *)&m_log_data.buffer[m_log_data.wr_idx & m_log_data.mask];
+    if (std)
+    {
+        invalid_header.std.type        = HEADER_TYPE_STD;
+        invalid_header.std.in_progress = 1;
+        invalid_header.std.nargs       = content_len;
+    }
+    else
+    {
+        invalid_header.hexdump.type = HEADER_TYPE_HEXDUMP;
+        invalid_header.hexdump.in_progress = 1;
+        invalid_header.hexdump.len = content_len;
+    }
 
-        p_header->raw = invalid_header.raw;
+    m_log_data.buffer[wr_idx & m_log_data.mask] = invalid_header.raw;
 
-        m_log_data.wr_idx += req_len;
-    }
+    // The consumer may read the header once no producer is pending.
+    __DMB();
+    UNUSED_RETURN_VALUE(nrf_atomic_u32_sub(&m_log_data.pending, 1));
 
-    CRITICAL_REGION_EXIT();
-    return ret;
+    *p_wr_idx = wr_idx;
+    return true;
 }
 
 char const * nrf_log_push(char * const p_str)
@@ -533,6 +544,14 @@ char const * nrf_log_push(char * const p_str)
     }
 }
 
+bool nrf_log_pushed_str_check(char const * p_str)
+{
+    uint8_t const * p_start = m_log_push_ringbuf.p_buffer;
+
+    return ((uint8_t const *)p_str >= p_start) &&
+           ((uint8_t const *)p_str <= &p_start[m_log_push_ringbuf.bufsize_mask]);
+}
+
 static inline void std_n(uint32_t           severity_mid,
                          char const * const p_str,
                          uint32_t const *   args,
@@ -668,15 +687,16 @@ void nrf_log_frontend_hexdump(uint32_t           severity_mid,
         uint32_t dropped   = dropped_sat16_get();
         m_log_data.buffer[(header_wr_idx + 1) & mask] = module_id | (dropped << 16);
         //Header prepare
-        nrf_log_header_t * p_header = (nrf_log_header_t *)&m_log_data.buffer[header_wr_idx & mask];
-        p_header->base.hexdump.severity    = severity_mid & NRF_LOG_LEVEL_MASK;
-        p_header->base.hexdump.offset      = 0;
-        p_header->base.hexdump.len         = length;
-        p_header->base.hexdump.type        = HEADER_TYPE_HEXDUMP;
-        p_header->base.hexdump.in_progress = 0;
-
-
+        nrf_log_main_header_t header;
+        header.raw                 = 0;
+        header.hexdump.severity    = severity_mid & NRF_LOG_LEVEL_MASK;
+        header.hexdump.offset      = 0;
+        header.hexdump.len         = length;
+        header.hexdump.type        = HEADER_TYPE_HEXDUMP;
+        header.hexdump.in_progress = 0;
 
+        __DMB();
+        m_log_data.buffer[header_wr_idx & mask] = header.raw;
     }
 
     if (m_log_data.autoflush)
@@ -691,43 +711,64 @@ bool buffer_is_empty(void)
     return (m_log_data.rd_idx == m_log_data.wr_idx);
 }
 
-bool nrf_log_frontend_dequeue(void)
+/**
+ * @brief Takes the oldest entry from the buffer and copies it to a memory object.
+ *
+ * @param[out] pp_msg_buf  Memory object with the entry, or NULL if the entry was omitted.
+ * @param[out] p_header    Header of the entry.
+ *
+ * @retval NRF_SUCCESS          If an entry was taken from the buffer or omitted.
+ * @retval NRF_ERROR_NOT_FOUND  If no entry is ready to be processed.
+ * @retval NRF_ERROR_NO_MEM     If there was no memory object for the entry.
+ */
+static ret_code_t entry_dequeue(nrf_memobj_t ** pp_msg_buf, nrf_log_header_t * p_header)
 {
+    *pp_msg_buf = NULL;
 
     if (buffer_is_empty())
     {
-        return false;
+        return NRF_ERROR_NOT_FOUND;
     }
-    m_log_data.log_skipped      = 0;
-    //It has to be ensured that reading rd_idx occurs after skipped flag is cleared.
-    __DSB();
     uint32_t           rd_idx   = m_log_data.rd_idx;
+    uint32_t           wr_idx   = m_log_data.wr_idx;
     uint32_t           mask     = m_log_data.mask;
-    nrf_log_header_t * p_header = (nrf_log_header_t *)&m_log_data.buffer[rd_idx & mask];
+    uint32_t           entry_idx = rd_idx;
     nrf_log_header_t   header;
     nrf_memobj_t *     p_msg_buf = NULL;
     size_t             memobj_offset = 0;
-    uint32_t           severity = 0;
 
-    // Skip any in progress packets.
-    do {
-        if (invalid_packets_omit(p_header, &rd_idx) && (m_log_data.log_skipped == 0))
-        {
-            //Check if end of data is not reached.
-            if (rd_idx >= m_log_data.wr_idx)
-            {
-                m_log_data.rd_idx     = m_log_data.wr_idx;
-                return false;
-            }
-            //something was omitted. Point to new header and try again.
-            p_header = (nrf_log_header_t *)&m_log_data.buffer[rd_idx & mask];
-        }
-        else
+    //It has to be ensured that pending counter is read after write index.
+    __DMB();
+    if (m_log_data.pending == 0)
+    {
+        m_log_data.wr_idx_safe = wr_idx;
+    }
+    if ((int32_t)(m_log_data.wr_idx_safe - rd_idx) <= 0)
+    {
+        // Header of the oldest entry may not be written yet.
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    nrf_log_main_header_t main_header;
+    main_header.raw = m_log_data.buffer[rd_idx & mask];
+    if (main_header.generic.in_progress)
+    {
+        if (!m_log_data.panic)
         {
-            break;
+            // Entry is being written by an interrupted context. Entries which follow it are
+            // processed when it is complete, to keep the order of the logs.
+            return NRF_ERROR_NOT_FOUND;
         }
-    } while (true);
 
+        // After panic, an interrupted context never completes the entry, so it is omitted.
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_cmp_exch(&m_log_data.rd_idx,
+                                                    &entry_idx,
+                                                    rd_idx + entry_len_get(main_header)));
+        return NRF_SUCCESS;
+    }
+
+    //Entry is read after its header is found complete.
+    __DMB();
     uint32_t i;
     for (i = 0; i < HEADER_SIZE; i++)
     {
@@ -740,7 +781,6 @@ bool nrf_log_frontend_dequeue(void)
         uint32_t data_len       = MIN(header.base.hexdump.len, NRF_LOG_MAX_HEXDUMP); //limit the data
         header.base.hexdump.len = data_len;
         uint32_t msg_buf_size8  = sizeof(uint32_t)*HEADER_SIZE + data_len;
-        severity = header.base.hexdump.severity;
         p_msg_buf = nrf_memobj_alloc(&log_mempool, msg_buf_size8);
 
         if (p_msg_buf)
@@ -779,7 +819,6 @@ bool nrf_log_frontend_dequeue(void)
     {
         header.base.std.nargs = MIN(header.base.std.nargs, NRF_LOG_MAX_NUM_OF_ARGS);
         uint32_t msg_buf_size32 = HEADER_SIZE + header.base.std.nargs;
-        severity = header.base.std.severity;
 
         p_msg_buf = nrf_memobj_alloc(&log_mempool, msg_buf_size32*sizeof(uint32_t));
 
@@ -789,12 +828,20 @@ bool nrf_log_frontend_dequeue(void)
             nrf_memobj_write(p_msg_buf, &header, HEADER_SIZE*sizeof(uint32_t), memobj_offset);
             memobj_offset += HEADER_SIZE*sizeof(uint32_t);
 
-            for (i = 0; i < header.base.std.nargs; i++)
+            // Arguments are copied with at most two writes, depending on buffer wrapping.
+            uint32_t nargs  = header.base.std.nargs;
+            uint32_t space0 = mask + 1 - (rd_idx & mask);
+            uint32_t len0   = MIN(nargs, space0);
+
+            nrf_memobj_write(p_msg_buf, &m_log_data.buffer[rd_idx & mask],
+                             len0*sizeof(uint32_t), memobj_offset);
+            memobj_offset += len0*sizeof(uint32_t);
+            if (nargs > len0)
             {
-                nrf_memobj_write(p_msg_buf, &m_log_data.buffer[rd_idx++ & mask],
-                                 sizeof(uint32_t), memobj_offset);
-                memobj_offset += sizeof(uint32_t);
+                nrf_memobj_write(p_msg_buf, &m_log_data.buffer[0],
+                                 (nargs - len0)*sizeof(uint32_t), memobj_offset);
             }
+            rd_idx += nargs;
         }
     }
     else
@@ -804,72 +851,108 @@ bool nrf_log_frontend_dequeue(void)
 
     if (p_msg_buf)
     {
-        nrf_log_backend_t const * p_backend = m_log_data.p_backend_head;
-        if (NRF_LOG_ALLOW_OVERFLOW && m_log_data.log_skipped)
+        // Entry is consumed by moving read index forward. If NRF_LOG_ALLOW_OVERFLOW is set, then
+        // the entry may have been removed in the meantime by a context that needed space. In that
+        // case it is already counted as dropped and the copy may be invalid, so it is not forwarded.
+        if (!nrf_atomic_u32_cmp_exch(&m_log_data.rd_idx, &entry_idx, rd_idx))
         {
-            // Check if any log was skipped during log processing. Do not forward log if skipping 
-            // occured because data may be invalid.
             nrf_memobj_put(p_msg_buf);
+            p_msg_buf = NULL;
         }
-        else
+    }
+    else if (m_log_data.rd_idx == entry_idx)
+    {
+        // No memory for the entry. If the entry was removed in the meantime instead, its header
+        // may have been invalid and it is skipped with no message.
+        return NRF_ERROR_NO_MEM;
+    }
+
+    *pp_msg_buf = p_msg_buf;
+    *p_header   = header;
+    return NRF_SUCCESS;
+}
+
+/**
+ * @brief Checks if a backend accepts an entry, according to the filters of the entry's module.
+ */
+static bool entry_accepted(nrf_log_backend_t const * p_backend, nrf_log_header_t const * p_header)
+{
+    if (NRF_LOG_FILTERS_ENABLED)
+    {
+        // The severity bits are at the same position in both entry types.
+        uint32_t severity   = p_header->base.std.severity;
+        uint8_t  backend_id = nrf_log_backend_id_get(p_backend);
+        nrf_log_module_filter_data_t * p_module_filter =
+                                 NRF_LOG_FILTER_SECTION_VARS_GET(p_header->module_id);
+        uint32_t backend_lvl = BF_GET(p_module_filter->filter_lvls,
+                                      NRF_LOG_LEVEL_BITS,
+                                      (backend_id*NRF_LOG_LEVEL_BITS));
+
+        //Degrade INFO_RAW level to INFO.
+        severity = (severity == NRF_LOG_SEVERITY_INFO_RAW) ? NRF_LOG_SEVERITY_INFO : severity;
+        return (backend_lvl >= severity);
+    }
+    return true;
+}
+
+bool nrf_log_frontend_dequeue(void)
+{
+    return nrf_log_frontend_dequeue_batch(1);
+}
+
+bool nrf_log_frontend_dequeue_batch(uint32_t max_count)
+{
+    nrf_memobj_t *   msg_bufs[NRF_LOG_BATCH_SIZE];
+    nrf_log_header_t headers[NRF_LOG_BATCH_SIZE];
+    nrf_log_entry_t * accepted[NRF_LOG_BATCH_SIZE];
+    uint32_t         count   = 0;
+    ret_code_t       err_code = NRF_SUCCESS;
+    uint32_t         i;
+
+    max_count = MIN(max_count, NRF_LOG_BATCH_SIZE);
+
+    for (i = 0; i < max_count; i++)
+    {
+        err_code = entry_dequeue(&msg_bufs[count], &headers[count]);
+        if (err_code != NRF_SUCCESS)
+        {
+            break;
+        }
+        if (msg_bufs[count] != NULL)
         {
-            while (p_backend)
+            count++;
+        }
+    }
+
+    if (count > 0)
+    {
+        nrf_log_backend_t const * p_backend = m_log_data.p_backend_head;
+        while (p_backend)
+        {
+            uint32_t accepted_cnt = 0;
+            if (nrf_log_backend_is_enabled(p_backend) == true)
             {
-                bool entry_accepted = false;
-                if (nrf_log_backend_is_enabled(p_backend) == true)
+                for (i = 0; i < count; i++)
                 {
-                    if (NRF_LOG_FILTERS_ENABLED)
-                    {
-                        uint8_t backend_id = nrf_log_backend_id_get(p_backend);
-                        nrf_log_module_filter_data_t * p_module_filter =
-                                                 NRF_LOG_FILTER_SECTION_VARS_GET(header.module_id);
-                        uint32_t backend_lvl = BF_GET(p_module_filter->filter_lvls,
-                                                      NRF_LOG_LEVEL_BITS,
-                                                      (backend_id*NRF_LOG_LEVEL_BITS));
-
-                        //Degrade INFO_RAW level to INFO.
-                        severity = (severity == NRF_LOG_SEVERITY_INFO_RAW) ?
-                                                                 NRF_LOG_SEVERITY_INFO : severity;
-                        if (backend_lvl >= severity)
-                        {
-                            entry_accepted = true;
-                        }
-                    }
-                    else
+                    if (entry_accepted(p_backend, &headers[i]))
                     {
-                        (void)severity;
-                        entry_accepted = true;
+                        accepted[accepted_cnt++] = msg_bufs[i];
                     }
                 }
-                if (entry_accepted)
-                {
-                    nrf_log_backend_put(p_backend, p_msg_buf);
-                }
-                p_backend = p_backend->p_cb->p_next;
-            }
-
-            nrf_memobj_put(p_msg_buf);
-
-            if (NRF_LOG_ALLOW_OVERFLOW)
-            {
-                // Read index can be moved forward only if dequeueing process was not interrupt by
-                // skipping procedure. If NRF_LOG_ALLOW_OVERFLOW is set then in case of buffer gets full
-                // and new logger entry occurs, oldest entry is removed. In that case read index is
-                // changed and updating it here would corrupt the internal circular buffer.
-                CRITICAL_REGION_ENTER();
-                if (m_log_data.log_skipped == 0)
-                {
-                    m_log_data.rd_idx = rd_idx;
-                }
-                CRITICAL_REGION_EXIT();
             }
-            else
+            if (accepted_cnt > 0)
             {
-                m_log_data.rd_idx = rd_idx;
+                nrf_log_backend_put_batch(p_backend, accepted, accepted_cnt);
             }
+            p_backend = p_backend->p_cb->p_next;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            nrf_memobj_put(msg_bufs[i]);
         }
     }
-    else
+    else if (err_code == NRF_ERROR_NO_MEM)
     {
         //Could not allocate memobj - backends are not freeing them on time.
         nrf_log_backend_t const * p_backend = m_log_data.p_backend_head;
@@ -882,6 +965,10 @@ bool nrf_log_frontend_dequeue(void)
         NRF_LOG_WARNING("Backends flushed");
     }
 
+    if (err_code == NRF_ERROR_NOT_FOUND)
+    {
+        return false;
+    }
     return buffer_is_empty() ? false : true;
 }
 
@@ -972,6 +1059,7 @@ void nrf_log_panic(void)
 {
     nrf_log_backend_t const * p_backend = m_log_data.p_backend_head;
     m_log_data.autoflush = true;
+    m_log_data.panic     = true;
     while (p_backend)
     {
         nrf_log_backend_enable(p_backend);
@@ -507,6 +507,15 @@ void nrf_log_frontend_hexdump(uint32_t           severity_mid,
                               const void * const p_data,
                               uint16_t           length);
 
+/**
+ * @brief A function for checking if a string was stored by @ref nrf_log_push.
+ *
+ * @param p_str A pointer to a string.
+ *
+ * @return True if the string is in the buffer used by @ref nrf_log_push.
+ */
+bool nrf_log_pushed_str_check(char const * p_str);
+
 /**
  * @brief A function for reading a byte from log backend.
  *
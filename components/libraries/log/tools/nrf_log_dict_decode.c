@@ -0,0 +1,709 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Host decoder of the logs sent by the serial backends in dictionary mode
+ * (NRF_LOG_BACKEND_SERIAL_DICTIONARY, see nrf_log_backend_serial.h).
+ *
+ * Build it on host:
+ *   cc -O2 nrf_log_dict_decode.c -o nrf_log_dict_decode
+ *
+ * Usage: nrf_log_dict_decode [-t timestamp frequency] <application ELF file> [log file]
+ *
+ * The frames are read from the log file, or from the standard input if no file is given, for example
+ * piped from a serial port or from JLinkRTTLogger. Format strings and constant string arguments are read
+ * from the ELF file, and the module names from the log_const_data section. The text is the same as the one
+ * printed by the backends without dictionary mode and without colors, except for the notices of
+ * dropped logs, which the backends always print in red. If a timestamp frequency is given,
+ * timestamps are printed as [hh:mm:ss.ms,us] instead of raw ticks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+// Frame format, see nrf_log_backend_serial.h.
+#define DICT_SYNC               0xA5
+#define DICT_TYPE_MASK          0x03
+#define DICT_TYPE_STD           1
+#define DICT_TYPE_HEXDUMP       2
+#define DICT_SEVERITY_POS       2
+#define DICT_SEVERITY_MASK      0x07
+#define DICT_FLAG_TIMESTAMP     0x20
+#define DICT_FLAG_DROPPED       0x40
+#define DICT_MAX_ARGS           6
+#define DICT_MAX_HEXDUMP        1023
+
+#define SEVERITY_INFO_RAW       5
+#define COLOR_CODE_DEFAULT      "\x1B[0m"
+#define COLOR_CODE_RED          "\x1B[1;31m"
+#define HEXDUMP_BYTES_IN_LINE   8
+#define LINE_MAX                1024
+
+typedef struct
+{
+    uint64_t addr;
+    uint64_t size;
+    uint64_t offset;
+} region_t;
+
+typedef struct
+{
+    uint8_t  * p_file;
+    size_t     file_size;
+    bool       is_64;
+    region_t * p_regions;
+    uint32_t   region_cnt;
+    char const ** pp_modules;
+    uint32_t   module_cnt;
+} elf_t;
+
+static elf_t    m_elf;
+static uint32_t m_timestamp_freq;
+
+static const char * const m_severity_names[] =
+{
+    NULL,
+    "error",
+    "warning",
+    "info",
+    "debug",
+};
+
+
+static uint8_t * file_load(char const * p_path, size_t * p_size)
+{
+    FILE * p_f = fopen(p_path, "rb");
+    if (p_f == NULL)
+    {
+        return NULL;
+    }
+
+    fseek(p_f, 0, SEEK_END);
+    long const size = ftell(p_f);
+    fseek(p_f, 0, SEEK_SET);
+
+    uint8_t * p_buf = malloc((size_t)size + 1);
+    if ((p_buf != NULL) && (fread(p_buf, 1, (size_t)size, p_f) != (size_t)size))
+    {
+        free(p_buf);
+        p_buf = NULL;
+    }
+    fclose(p_f);
+
+    *p_size = (size_t)size;
+    return p_buf;
+}
+
+
+// Returns a pointer to the content of the ELF file at the given address, or NULL if the address
+// is not in a loaded section. At most *p_len bytes are available from the returned pointer.
+static void const * elf_ptr(uint64_t addr, uint64_t * p_len)
+{
+    for (uint32_t i = 0; i < m_elf.region_cnt; i++)
+    {
+        region_t const * p_region = &m_elf.p_regions[i];
+
+        if ((addr >= p_region->addr) && (addr < p_region->addr + p_region->size))
+        {
+            *p_len = p_region->addr + p_region->size - addr;
+            return &m_elf.p_file[p_region->offset + (addr - p_region->addr)];
+        }
+    }
+    return NULL;
+}
+
+
+static char const * elf_str(uint64_t addr)
+{
+    uint64_t     len;
+    char const * p_str = elf_ptr(addr, &len);
+
+    if ((p_str == NULL) || (memchr(p_str, '\0', len) == NULL))
+    {
+        return NULL;
+    }
+    return p_str;
+}
+
+
+static uint64_t elf_ptr_read(uint64_t addr, bool * p_ok)
+{
+    uint64_t        len;
+    uint8_t const * p_data = elf_ptr(addr, &len);
+    uint64_t        value  = 0;
+    uint32_t        size   = m_elf.is_64 ? 8 : 4;
+
+    *p_ok = (p_data != NULL) && (len >= size);
+    if (*p_ok)
+    {
+        memcpy(&value, p_data, size);
+    }
+    return value;
+}
+
+
+// Generic view of the 32-bit and 64-bit ELF structures.
+#define ELF_FIELD(p_base, type32, type64, field) \
+    (m_elf.is_64 ? (uint64_t)((type64 const *)(p_base))->field : (uint64_t)((type32 const *)(p_base))->field)
+
+static bool elf_load(char const * p_path)
+{
+    m_elf.p_file = file_load(p_path, &m_elf.file_size);
+    if ((m_elf.p_file == NULL) || (m_elf.file_size < sizeof(Elf32_Ehdr)) ||
+        (memcmp(m_elf.p_file, ELFMAG, SELFMAG) != 0) || (m_elf.p_file[EI_DATA] != ELFDATA2LSB))
+    {
+        fprintf(stderr, "%s: not a little-endian ELF file\n", p_path);
+        return false;
+    }
+
+    m_elf.is_64 = (m_elf.p_file[EI_CLASS] == ELFCLASS64);
+
+    uint8_t const * p_ehdr    = m_elf.p_file;
+    uint64_t const  shoff     = ELF_FIELD(p_ehdr, Elf32_Ehdr, Elf64_Ehdr, e_shoff);
+    uint64_t const  shentsize = ELF_FIELD(p_ehdr, Elf32_Ehdr, Elf64_Ehdr, e_shentsize);
+    uint64_t const  shnum     = ELF_FIELD(p_ehdr, Elf32_Ehdr, Elf64_Ehdr, e_shnum);
+
+    if (shoff + shnum * shentsize > m_elf.file_size)
+    {
+        fprintf(stderr, "%s: truncated ELF file\n", p_path);
+        return false;
+    }
+
+    m_elf.p_regions = calloc(shnum, sizeof(region_t));
+
+    uint8_t const * p_symtab = NULL;
+    uint64_t        sym_cnt  = 0;
+    char const    * p_strtab = NULL;
+
+    for (uint64_t i = 0; i < shnum; i++)
+    {
+        uint8_t const * p_shdr = &m_elf.p_file[shoff + i * shentsize];
+        uint64_t const  type   = ELF_FIELD(p_shdr, Elf32_Shdr, Elf64_Shdr, sh_type);
+        uint64_t const  flags  = ELF_FIELD(p_shdr, Elf32_Shdr, Elf64_Shdr, sh_flags);
+        uint64_t const  offset = ELF_FIELD(p_shdr, Elf32_Shdr, Elf64_Shdr, sh_offset);
+        uint64_t const  size   = ELF_FIELD(p_shdr, Elf32_Shdr, Elf64_Shdr, sh_size);
+
+        if ((type != SHT_NOBITS) && (offset + size > m_elf.file_size))
+        {
+            continue;
+        }
+
+        if ((flags & SHF_ALLOC) && (type != SHT_NOBITS) && (size > 0))
+        {
+            region_t * p_region = &m_elf.p_regions[m_elf.region_cnt++];
+            p_region->addr   = ELF_FIELD(p_shdr, Elf32_Shdr, Elf64_Shdr, sh_addr);
+            p_region->size   = size;
+            p_region->offset = offset;
+        }
+        else if (type == SHT_SYMTAB)
+        {
+            uint64_t const  link      = ELF_FIELD(p_shdr, Elf32_Shdr, Elf64_Shdr, sh_link);
+            uint8_t const * p_strhdr  = &m_elf.p_file[shoff + link * shentsize];
+
+            p_symtab = &m_elf.p_file[offset];
+            sym_cnt  = size / ELF_FIELD(p_shdr, Elf32_Shdr, Elf64_Shdr, sh_entsize);
+            p_strtab = (char const *)&m_elf.p_file[ELF_FIELD(p_strhdr, Elf32_Shdr, Elf64_Shdr, sh_offset)];
+        }
+    }
+
+    if (p_symtab == NULL)
+    {
+        fprintf(stderr, "%s: no symbol table, module names are not available\n", p_path);
+        return true;
+    }
+
+    // The module ID is the index of the module in the log_const_data section.
+    uint64_t const symsize = m_elf.is_64 ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym);
+    uint64_t       start   = 0;
+    uint64_t       stop    = 0;
+
+    for (uint64_t i = 0; i < sym_cnt; i++)
+    {
+        uint8_t const * p_sym  = &p_symtab[i * symsize];
+        char const    * p_name = &p_strtab[ELF_FIELD(p_sym, Elf32_Sym, Elf64_Sym, st_name)];
+
+        if (strcmp(p_name, "__start_log_const_data") == 0)
+        {
+            start = ELF_FIELD(p_sym, Elf32_Sym, Elf64_Sym, st_value);
+        }
+        else if (strcmp(p_name, "__stop_log_const_data") == 0)
+        {
+            stop = ELF_FIELD(p_sym, Elf32_Sym, Elf64_Sym, st_value);
+        }
+    }
+
+    // All the entries have the same size, which is the size of the smallest object in the section.
+    uint64_t stride = 0;
+
+    for (uint64_t i = 0; (i < sym_cnt) && (start < stop); i++)
+    {
+        uint8_t const * p_sym = &p_symtab[i * symsize];
+        uint64_t const  value = ELF_FIELD(p_sym, Elf32_Sym, Elf64_Sym, st_value);
+        uint64_t const  size  = ELF_FIELD(p_sym, Elf32_Sym, Elf64_Sym, st_size);
+        uint8_t  const  info  = (uint8_t)ELF_FIELD(p_sym, Elf32_Sym, Elf64_Sym, st_info);
+
+        if ((ELF32_ST_TYPE(info) == STT_OBJECT) && (size > 0) && (value >= start) && (value < stop) &&
+            ((stride == 0) || (size < stride)))
+        {
+            stride = size;
+        }
+    }
+
+    if (stride == 0)
+    {
+        fprintf(stderr, "%s: no log_const_data section, module names are not available\n", p_path);
+        return true;
+    }
+
+    m_elf.module_cnt = (uint32_t)((stop - start) / stride);
+    m_elf.pp_modules = calloc(m_elf.module_cnt, sizeof(char const *));
+
+    for (uint32_t i = 0; i < m_elf.module_cnt; i++)
+    {
+        bool           ok;
+        uint64_t const name_addr = elf_ptr_read(start + i * stride, &ok);
+
+        m_elf.pp_modules[i] = ok ? elf_str(name_addr) : NULL;
+    }
+
+    return true;
+}
+
+
+static size_t timestamp_print(char * p_out, size_t size, uint32_t timestamp)
+{
+    if (m_timestamp_freq == 0)
+    {
+        return (size_t)snprintf(p_out, size, "[%08lu] ", (unsigned long)timestamp);
+    }
+
+    uint32_t const seconds  = timestamp / m_timestamp_freq;
+    uint32_t const reminder = timestamp % m_timestamp_freq;
+    uint64_t const us       = ((uint64_t)reminder * 1000000) / m_timestamp_freq;
+
+    return (size_t)snprintf(p_out, size, "[%02u:%02u:%02u.%03u,%03u] ",
+                            seconds / 3600, (seconds / 60) % 60, seconds % 60,
+                            (uint32_t)(us / 1000), (uint32_t)(us % 1000));
+}
+
+
+static size_t prefix_print(char * p_out, size_t size, uint32_t severity, uint32_t module_id,
+                           bool has_timestamp, uint32_t timestamp)
+{
+    size_t len = 0;
+
+    if (severity == SEVERITY_INFO_RAW)
+    {
+        return 0;
+    }
+
+    if (has_timestamp)
+    {
+        len += timestamp_print(p_out, size, timestamp);
+    }
+
+    char const * p_module = (module_id < m_elf.module_cnt) ? m_elf.pp_modules[module_id] : NULL;
+    char const * p_sev    = (severity < 5) ? m_severity_names[severity] : NULL;
+    char         module_buf[16];
+
+    if (p_module == NULL)
+    {
+        snprintf(module_buf, sizeof(module_buf), "module %u", module_id);
+        p_module = module_buf;
+    }
+
+    len += (size_t)snprintf(&p_out[len], size - len, "<%s> %s: ", (p_sev != NULL) ? p_sev : "?", p_module);
+    return len;
+}
+
+
+// Render a printf format string with 32-bit arguments. String arguments are taken from the
+// pushed strings of the frame or from the ELF file.
+static size_t format_print(char * p_out, size_t size, char const * p_fmt,
+                           uint32_t const * p_args, uint32_t nargs, char const * const * pp_pushed)
+{
+    size_t   len     = 0;
+    uint32_t arg_idx = 0;
+
+    while ((*p_fmt != '\0') && (len + 1 < size))
+    {
+        if (*p_fmt != '%')
+        {
+            p_out[len++] = *p_fmt++;
+            continue;
+        }
+
+        // Copy the conversion specification without the length modifiers, which do not
+        // matter since every argument is 32 bits wide.
+        char spec[32];
+        size_t spec_len = 0;
+
+        spec[spec_len++] = *p_fmt++;
+        while ((*p_fmt != '\0') && (strchr("-+ #0123456789.*hljztL", *p_fmt) != NULL) && (spec_len < sizeof(spec) - 2))
+        {
+            if (strchr("hljztL", *p_fmt) == NULL)
+            {
+                spec[spec_len++] = *p_fmt;
+            }
+            p_fmt++;
+        }
+        char const conv = *p_fmt;
+        if (conv == '\0')
+        {
+            break;
+        }
+        p_fmt++;
+
+        if (conv == '%')
+        {
+            p_out[len++] = '%';
+            continue;
+        }
+
+        spec[spec_len++] = conv;
+        spec[spec_len]   = '\0';
+
+        if ((strchr(spec, '*') != NULL) || (arg_idx >= nargs))
+        {
+            // Not supported by nrf_fprintf either.
+            len += (size_t)snprintf(&p_out[len], size - len, "%s", spec);
+            continue;
+        }
+
+        uint32_t const arg = p_args[arg_idx];
+        char const * p_str = pp_pushed[arg_idx];
+        arg_idx++;
+
+        switch (conv)
+        {
+            case 'd':
+            case 'i':
+                len += (size_t)snprintf(&p_out[len], size - len, spec, (int)(int32_t)arg);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+            case 'c':
+                len += (size_t)snprintf(&p_out[len], size - len, spec, (unsigned)arg);
+                break;
+            case 'p':
+                len += (size_t)snprintf(&p_out[len], size - len, "0x%08x", (unsigned)arg);
+                break;
+            case 's':
+                if (p_str == NULL)
+                {
+                    p_str = elf_str(arg);
+                }
+                if (p_str != NULL)
+                {
+                    len += (size_t)snprintf(&p_out[len], size - len, spec, p_str);
+                }
+                else
+                {
+                    len += (size_t)snprintf(&p_out[len], size - len, "<string at 0x%08x>", (unsigned)arg);
+                }
+                break;
+            default:
+                len += (size_t)snprintf(&p_out[len], size - len, "%s", spec);
+                break;
+        }
+
+        if (len >= size)
+        {
+            len = size - 1;
+        }
+    }
+
+    p_out[len] = '\0';
+    return len;
+}
+
+
+typedef struct
+{
+    uint8_t * p_data;
+    size_t    len;
+    size_t    pos;
+    size_t    cap;
+} stream_t;
+
+typedef enum
+{
+    FRAME_OK,           // A frame was decoded.
+    FRAME_INVALID,      // The data at the current position is not a frame.
+    FRAME_INCOMPLETE,   // More data is needed to decode the frame.
+} frame_result_t;
+
+static bool stream_get(stream_t * p_stream, void * p_dst, size_t len)
+{
+    if (p_stream->pos + len > p_stream->len)
+    {
+        return false;
+    }
+    memcpy(p_dst, &p_stream->p_data[p_stream->pos], len);
+    p_stream->pos += len;
+    return true;
+}
+
+
+// Decode one frame starting at the current position.
+static frame_result_t frame_decode(stream_t * p_stream)
+{
+    uint8_t  sync;
+    uint8_t  flags;
+    uint16_t module_id;
+    uint32_t timestamp = 0;
+    uint16_t dropped   = 0;
+    char     line[LINE_MAX];
+    size_t   len;
+
+    if (!stream_get(p_stream, &sync, 1) || !stream_get(p_stream, &flags, 1) ||
+        !stream_get(p_stream, &module_id, 2))
+    {
+        return FRAME_INCOMPLETE;
+    }
+
+    uint32_t const type     = flags & DICT_TYPE_MASK;
+    uint32_t const severity = (flags >> DICT_SEVERITY_POS) & DICT_SEVERITY_MASK;
+
+    if (((type != DICT_TYPE_STD) && (type != DICT_TYPE_HEXDUMP)) ||
+        (severity == 0) || (severity > SEVERITY_INFO_RAW) || (flags & 0x80) || (sync != DICT_SYNC))
+    {
+        return FRAME_INVALID;
+    }
+    if (((flags & DICT_FLAG_TIMESTAMP) && !stream_get(p_stream, &timestamp, 4)) ||
+        ((flags & DICT_FLAG_DROPPED) && !stream_get(p_stream, &dropped, 2)))
+    {
+        return FRAME_INCOMPLETE;
+    }
+
+    if (type == DICT_TYPE_STD)
+    {
+        uint8_t      nargs;
+        uint8_t      str_mask;
+        uint32_t     addr;
+        uint32_t     args[DICT_MAX_ARGS];
+        char const * pushed[DICT_MAX_ARGS] = {NULL};
+
+        if (!stream_get(p_stream, &nargs, 1))
+        {
+            return FRAME_INCOMPLETE;
+        }
+        if (nargs > DICT_MAX_ARGS)
+        {
+            return FRAME_INVALID;
+        }
+        if (!stream_get(p_stream, &str_mask, 1) || !stream_get(p_stream, &addr, 4) ||
+            !stream_get(p_stream, args, nargs * sizeof(uint32_t)))
+        {
+            return FRAME_INCOMPLETE;
+        }
+
+        char const * p_fmt = elf_str(addr);
+        if ((p_fmt == NULL) || (str_mask >> nargs))
+        {
+            return FRAME_INVALID;
+        }
+
+        for (uint32_t i = 0; i < nargs; i++)
+        {
+            if (str_mask & (1u << i))
+            {
+                char const * p_str = (char const *)&p_stream->p_data[p_stream->pos];
+                char const * p_end = memchr(p_str, '\0', p_stream->len - p_stream->pos);
+                if (p_end == NULL)
+                {
+                    return FRAME_INCOMPLETE;
+                }
+                pushed[i]       = p_str;
+                p_stream->pos  += (size_t)(p_end - p_str) + 1;
+            }
+        }
+
+        if (dropped)
+        {
+            printf("%sLogs dropped (%d)%s\r\n", COLOR_CODE_RED, dropped, COLOR_CODE_DEFAULT);
+        }
+        len  = prefix_print(line, sizeof(line), severity, module_id, flags & DICT_FLAG_TIMESTAMP, timestamp);
+        len += format_print(&line[len], sizeof(line) - len, p_fmt, args, nargs, pushed);
+        fwrite(line, 1, len, stdout);
+        if (severity != SEVERITY_INFO_RAW)
+        {
+            printf("\r\n");
+        }
+    }
+    else
+    {
+        uint16_t data_len;
+        uint8_t  data[DICT_MAX_HEXDUMP];
+
+        if (!stream_get(p_stream, &data_len, 2))
+        {
+            return FRAME_INCOMPLETE;
+        }
+        if (data_len > DICT_MAX_HEXDUMP)
+        {
+            return FRAME_INVALID;
+        }
+        if (!stream_get(p_stream, data, data_len))
+        {
+            return FRAME_INCOMPLETE;
+        }
+
+        if (dropped)
+        {
+            printf("%sLogs dropped (%d)%s\r\n", COLOR_CODE_RED, dropped, COLOR_CODE_DEFAULT);
+        }
+
+        // One line for every 8 bytes, like the backends print them.
+        uint32_t offset = 0;
+        do
+        {
+            uint32_t const chunk_len = ((data_len - offset) < HEXDUMP_BYTES_IN_LINE) ?
+                                       (data_len - offset) : HEXDUMP_BYTES_IN_LINE;
+
+            len = prefix_print(line, sizeof(line), severity, module_id, flags & DICT_FLAG_TIMESTAMP, timestamp);
+            for (uint32_t i = 0; i < HEXDUMP_BYTES_IN_LINE; i++)
+            {
+                len += (i < chunk_len) ? (size_t)snprintf(&line[len], sizeof(line) - len, " %02x", data[offset + i])
+                                       : (size_t)snprintf(&line[len], sizeof(line) - len, "   ");
+            }
+            line[len++] = '|';
+            for (uint32_t i = 0; i < HEXDUMP_BYTES_IN_LINE; i++)
+            {
+                char const c = (char)data[offset + i];
+                line[len++] = (i >= chunk_len) ? ' ' : (((c <= 0x7E) && isprint((int)c)) ? c : '.');
+            }
+            fwrite(line, 1, len, stdout);
+            printf("\r\n");
+            offset += chunk_len;
+        } while (offset < data_len);
+    }
+
+    return FRAME_OK;
+}
+
+
+int main(int argc, char ** argv)
+{
+    int arg = 1;
+
+    if ((argc > 2) && (strcmp(argv[1], "-t") == 0))
+    {
+        m_timestamp_freq = (uint32_t)strtoul(argv[2], NULL, 0);
+        arg += 2;
+    }
+
+    if ((arg >= argc) || (arg + 2 < argc))
+    {
+        fprintf(stderr, "Usage: %s [-t timestamp frequency] <application ELF file> [log file]\n", argv[0]);
+        return 2;
+    }
+
+    if (!elf_load(argv[arg]))
+    {
+        return 1;
+    }
+
+    int const fd = (arg + 1 < argc) ? open(argv[arg + 1], O_RDONLY) : STDIN_FILENO;
+    if (fd < 0)
+    {
+        fprintf(stderr, "%s: cannot open\n", argv[arg + 1]);
+        return 1;
+    }
+
+    // Decode the frames as the data arrives, so that the tool can be used on a live stream.
+    // After a byte that does not start a valid frame, decoding resumes from the next byte.
+    stream_t stream  = {.cap = 4096};
+    uint32_t skipped = 0;
+    ssize_t  n;
+
+    stream.p_data = malloc(stream.cap);
+
+    while ((n = read(fd, &stream.p_data[stream.len], stream.cap - stream.len)) > 0)
+    {
+        stream.len += (size_t)n;
+
+        while (stream.pos < stream.len)
+        {
+            size_t const         start  = stream.pos;
+            frame_result_t const result = frame_decode(&stream);
+
+            if (result == FRAME_INVALID)
+            {
+                stream.pos = start + 1;
+                skipped++;
+            }
+            else if (result == FRAME_INCOMPLETE)
+            {
+                stream.pos = start;
+                break;
+            }
+        }
+        fflush(stdout);
+
+        // Keep the incomplete frame at the beginning of the buffer.
+        memmove(stream.p_data, &stream.p_data[stream.pos], stream.len - stream.pos);
+        stream.len -= stream.pos;
+        stream.pos  = 0;
+
+        if (stream.len == stream.cap)
+        {
+            stream.cap   *= 2;
+            stream.p_data = realloc(stream.p_data, stream.cap);
+        }
+    }
+
+    skipped += (uint32_t)stream.len;
+    if (skipped > 0)
+    {
+        fprintf(stderr, "%u bytes skipped\n", skipped);
+    }
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of the memory manager used by mem_manager_bench. The medium
+// category is large, to show that the time does not depend on the number of blocks.
+
+#define MEM_MANAGER_ENABLED 1
+#define MEM_MANAGER_DISABLE_API_PARAM_CHECK 0
+#define MEM_MANAGER_CONFIG_LOG_ENABLED 0
+
+#define MEMORY_MANAGER_XXSMALL_BLOCK_COUNT 40
+#define MEMORY_MANAGER_XXSMALL_BLOCK_SIZE 8
+#define MEMORY_MANAGER_SMALL_BLOCK_COUNT 100
+#define MEMORY_MANAGER_SMALL_BLOCK_SIZE 32
+#define MEMORY_MANAGER_MEDIUM_BLOCK_COUNT 1000
+#define MEMORY_MANAGER_MEDIUM_BLOCK_SIZE 64
+#define MEMORY_MANAGER_XLARGE_BLOCK_COUNT 10
+#define MEMORY_MANAGER_XLARGE_BLOCK_SIZE 1024
+
+#define NRF_LOG_ENABLED 0
+
+#endif // SDK_CONFIG_H
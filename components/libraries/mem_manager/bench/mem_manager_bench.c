@@ -0,0 +1,351 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Test and benchmark of the memory manager.
+ *
+ * Build it on host from this directory:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I$L/util -I$L/log -I$L/log/src -I$L/strerror \
+ *      mem_manager_bench.c ../mem_manager.c $L/bench_host/bench.c -o mem_manager_bench
+ *
+ * Usage: mem_manager_bench [random operations]
+ *
+ * The test reserves every block of every size, checks that the blocks do not overlap and that
+ * larger blocks are given when the smaller ones run out, resizes blocks with nrf_realloc, and
+ * runs random allocations, reallocations and frees against a model of the content of each block.
+ *
+ * The benchmark measures the time to reserve and free a block in the largest category while all
+ * other blocks of the category are in use, which is the worst case of a linear search.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdk_common.h"
+#include "mem_manager.h"
+#include "bench.h"
+
+
+#define SIZES               4
+#define BLOCKS_MAX          (MEMORY_MANAGER_XXSMALL_BLOCK_COUNT + MEMORY_MANAGER_SMALL_BLOCK_COUNT + \
+                             MEMORY_MANAGER_MEDIUM_BLOCK_COUNT  + MEMORY_MANAGER_XLARGE_BLOCK_COUNT)
+#define BENCH_ROUNDS        1000000
+
+typedef struct
+{
+    uint8_t * p_mem;
+    uint32_t  size;
+    uint8_t   fill;
+} block_t;
+
+static const uint32_t m_sizes[SIZES] =
+{
+    MEMORY_MANAGER_XXSMALL_BLOCK_SIZE,
+    MEMORY_MANAGER_SMALL_BLOCK_SIZE,
+    MEMORY_MANAGER_MEDIUM_BLOCK_SIZE,
+    MEMORY_MANAGER_XLARGE_BLOCK_SIZE
+};
+
+static const uint32_t m_counts[SIZES] =
+{
+    MEMORY_MANAGER_XXSMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_SMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,
+    MEMORY_MANAGER_XLARGE_BLOCK_COUNT
+};
+
+static block_t  m_blocks[BLOCKS_MAX + 1];     // One more for the reservation that fails.
+static uint32_t m_block_count;
+
+
+static void block_fill(block_t * p_block)
+{
+    p_block->fill = (uint8_t)bench_random();
+    for (uint32_t i = 0; i < p_block->size; i++)
+    {
+        p_block->p_mem[i] = (uint8_t)(p_block->fill + i);
+    }
+}
+
+
+static bool block_check(block_t const * p_block, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (p_block->p_mem[i] != (uint8_t)(p_block->fill + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Reserves blocks of the given size until there is no memory, and checks the sizes given.
+static void reserve_all(uint32_t requested)
+{
+    uint32_t expected = 0;
+
+    for (;;)
+    {
+        block_t * p_block = &m_blocks[m_block_count];
+
+        p_block->size = requested;
+        if (nrf_mem_reserve(&p_block->p_mem, &p_block->size) != NRF_SUCCESS)
+        {
+            break;
+        }
+
+        // Blocks of the smallest suitable size come first, then the larger ones.
+        while ((expected < SIZES) && (p_block->size != m_sizes[expected]))
+        {
+            expected++;
+        }
+        CHECK(expected < SIZES);
+        block_fill(p_block);
+        m_block_count++;
+    }
+}
+
+
+static void free_all(void)
+{
+    for (uint32_t i = 0; i < m_block_count; i++)
+    {
+        CHECK(block_check(&m_blocks[i], m_blocks[i].size));
+        nrf_free(m_blocks[i].p_mem);
+    }
+    m_block_count = 0;
+}
+
+
+static void test_reserve(void)
+{
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i < SIZES; i++)
+    {
+        total += m_counts[i];
+    }
+
+    // Small requests get every block, then all blocks are checked for overlaps by their content.
+    reserve_all(1);
+    CHECK(m_block_count == total);
+    free_all();
+
+    // After freeing, every block can be reserved again.
+    reserve_all(MEMORY_MANAGER_SMALL_BLOCK_SIZE);
+    CHECK(m_block_count == total - MEMORY_MANAGER_XXSMALL_BLOCK_COUNT);
+    CHECK(nrf_malloc(MEMORY_MANAGER_XLARGE_BLOCK_SIZE + 1) == NULL);
+    free_all();
+
+    // Freeing a pointer inside a block or outside the pool does nothing.
+    uint8_t * p_mem = nrf_malloc(MEMORY_MANAGER_XLARGE_BLOCK_SIZE);
+    CHECK(p_mem != NULL);
+    nrf_free(p_mem + 1);
+    nrf_free(&p_mem);
+    reserve_all(MEMORY_MANAGER_XLARGE_BLOCK_SIZE);
+    CHECK(m_block_count == MEMORY_MANAGER_XLARGE_BLOCK_COUNT - 1);
+    free_all();
+    nrf_free(p_mem);
+}
+
+
+static void test_realloc(void)
+{
+    block_t block = {.size = MEMORY_MANAGER_XXSMALL_BLOCK_SIZE};
+
+    block.p_mem = nrf_realloc(NULL, block.size);
+    CHECK(block.p_mem != NULL);
+    block_fill(&block);
+
+    // A block that is large enough is kept.
+    CHECK(nrf_realloc(block.p_mem, 1) == block.p_mem);
+    CHECK(nrf_realloc(block.p_mem, block.size) == block.p_mem);
+
+    // A larger one is moved with its content.
+    for (uint32_t i = 1; i < SIZES; i++)
+    {
+        uint8_t * p_mem = nrf_realloc(block.p_mem, m_sizes[i - 1] + 1);
+
+        CHECK(p_mem != NULL);
+        CHECK(p_mem != block.p_mem);
+        block.p_mem = p_mem;
+        CHECK(block_check(&block, block.size));
+        block.size = m_sizes[i];
+        block_fill(&block);
+    }
+
+    // The block is left untouched when there is no larger one.
+    CHECK(nrf_realloc(block.p_mem, MEMORY_MANAGER_XLARGE_BLOCK_SIZE + 1) == NULL);
+    CHECK(block_check(&block, block.size));
+    CHECK(nrf_realloc(m_blocks, 1) == NULL);
+    nrf_free(block.p_mem);
+
+    // All blocks are free again.
+    reserve_all(1);
+    CHECK(m_block_count == BLOCKS_MAX);
+    free_all();
+}
+
+
+static void test_random(uint32_t operations)
+{
+    for (uint32_t op = 0; op < operations; op++)
+    {
+        uint32_t const r    = bench_random();
+        uint32_t const size = 1 + (bench_random() % MEMORY_MANAGER_XLARGE_BLOCK_SIZE) /
+                                  (1 << (bench_random() % 8));
+
+        switch (r % 3)
+        {
+            case 0:
+            {
+                block_t * p_block = &m_blocks[m_block_count];
+
+                p_block->size = size;
+                if (nrf_mem_reserve(&p_block->p_mem, &p_block->size) == NRF_SUCCESS)
+                {
+                    CHECK(p_block->size >= size);
+                    block_fill(p_block);
+                    m_block_count++;
+                }
+                break;
+            }
+
+            case 1:
+                if (m_block_count > 0)
+                {
+                    block_t * p_block = &m_blocks[(r >> 2) % m_block_count];
+                    uint8_t * p_mem   = nrf_realloc(p_block->p_mem, size);
+
+                    if (p_mem != NULL)
+                    {
+                        CHECK(block_check(p_block, MIN(p_block->size, size)) ||
+                              (p_mem != p_block->p_mem));
+                        p_block->p_mem = p_mem;
+                        CHECK(block_check(p_block, MIN(p_block->size, size)));
+                        p_block->size  = MAX(p_block->size, size);
+                        block_fill(p_block);
+                    }
+                    else
+                    {
+                        CHECK(block_check(p_block, p_block->size));
+                    }
+                }
+                break;
+
+            default:
+                if (m_block_count > 0)
+                {
+                    uint32_t const i = (r >> 2) % m_block_count;
+
+                    CHECK(block_check(&m_blocks[i], m_blocks[i].size));
+                    nrf_free(m_blocks[i].p_mem);
+                    m_blocks[i] = m_blocks[--m_block_count];
+                }
+                break;
+        }
+    }
+    free_all();
+
+    reserve_all(1);
+    CHECK(m_block_count == BLOCKS_MAX);
+    free_all();
+}
+
+
+static void bench(void)
+{
+    // Every block but the last one of the medium category is in use.
+    for (uint32_t i = 0; i < MEMORY_MANAGER_MEDIUM_BLOCK_COUNT - 1; i++)
+    {
+        m_blocks[i].size = MEMORY_MANAGER_MEDIUM_BLOCK_SIZE;
+        CHECK(nrf_mem_reserve(&m_blocks[i].p_mem, &m_blocks[i].size) == NRF_SUCCESS);
+    }
+    m_block_count = MEMORY_MANAGER_MEDIUM_BLOCK_COUNT - 1;
+
+    uint64_t const start = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+    {
+        void * p_mem = nrf_malloc(MEMORY_MANAGER_MEDIUM_BLOCK_SIZE);
+        nrf_free(p_mem);
+    }
+    uint64_t const elapsed = bench_now_ns() - start;
+
+    printf("reserve/free with %u of %u blocks in use: %.1f ns\n",
+           MEMORY_MANAGER_MEDIUM_BLOCK_COUNT - 1, MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,
+           (double)elapsed / BENCH_ROUNDS);
+
+    // The last medium block was reserved and freed each time, after it a larger block is given.
+    void * p_mem    = nrf_malloc(MEMORY_MANAGER_MEDIUM_BLOCK_SIZE);
+    void * p_larger = nrf_malloc(MEMORY_MANAGER_MEDIUM_BLOCK_SIZE);
+    CHECK((p_mem != NULL) && (p_larger != NULL));
+    nrf_free(p_larger);
+    nrf_free(p_mem);
+    for (uint32_t i = 0; i < m_block_count; i++)
+    {
+        nrf_free(m_blocks[i].p_mem);
+    }
+    m_block_count = 0;
+}
+
+
+int main(int argc, char ** argv)
+{
+    uint32_t const operations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000;
+
+    CHECK(nrf_mem_init() == NRF_SUCCESS);
+
+    test_reserve();
+    test_realloc();
+    test_random(operations);
+    bench();
+
+    reserve_all(1);
+    CHECK(m_block_count == BLOCKS_MAX);
+    free_all();
+
+    if (bench_failed())
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
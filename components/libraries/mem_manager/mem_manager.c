@@ -177,9 +177,6 @@ NRF_LOG_MODULE_REGISTER();
 #ifndef MEMORY_MANAGER_XXSMALL_BLOCK_COUNT
     #define MEMORY_MANAGER_XXSMALL_BLOCK_COUNT 0
     #define MEMORY_MANAGER_XXSMALL_BLOCK_SIZE  0
-    #define XXSMALL_BLOCK_START                0
-    #define XXSMALL_BLOCK_END                  0
-    #define XXSMALL_MEMORY_START               0
 #endif // MEMORY_MANAGER_XXSMALL_BLOCK_SIZE
 
 
@@ -187,9 +184,6 @@ NRF_LOG_MODULE_REGISTER();
 #ifndef MEMORY_MANAGER_XSMALL_BLOCK_COUNT
    #define MEMORY_MANAGER_XSMALL_BLOCK_COUNT   0
    #define MEMORY_MANAGER_XSMALL_BLOCK_SIZE    0
-   #define XSMALL_BLOCK_START                  0
-   #define XSMALL_BLOCK_END                    0
-   #define XSMALL_MEMORY_START                 0
 #endif // MEMORY_MANAGER_XSMALL_BLOCK_SIZE
 
 
@@ -197,9 +191,6 @@ NRF_LOG_MODULE_REGISTER();
 #ifndef MEMORY_MANAGER_SMALL_BLOCK_COUNT
    #define MEMORY_MANAGER_SMALL_BLOCK_COUNT    0
    #define MEMORY_MANAGER_SMALL_BLOCK_SIZE     0
-   #define SMALL_BLOCK_START                   0
-   #define SMALL_BLOCK_END                     0
-   #define SMALL_MEMORY_START                  0
 #endif // MEMORY_MANAGER_SMALL_BLOCK_COUNT
 
 
@@ -207,9 +198,6 @@ NRF_LOG_MODULE_REGISTER();
 #ifndef MEMORY_MANAGER_MEDIUM_BLOCK_COUNT
    #define MEMORY_MANAGER_MEDIUM_BLOCK_COUNT   0
    #define MEMORY_MANAGER_MEDIUM_BLOCK_SIZE    0
-   #define MEDIUM_BLOCK_START                  0
-   #define MEDIUM_BLOCK_END                    0
-   #define MEDIUM_MEMORY_START                 0
 #endif // MEMORY_MANAGER_MEDIUM_BLOCK_COUNT
 
 
@@ -217,9 +205,6 @@ NRF_LOG_MODULE_REGISTER();
 #ifndef MEMORY_MANAGER_LARGE_BLOCK_COUNT
    #define MEMORY_MANAGER_LARGE_BLOCK_COUNT    0
    #define MEMORY_MANAGER_LARGE_BLOCK_SIZE     0
-   #define LARGE_BLOCK_START                   0
-   #define LARGE_BLOCK_END                     0
-   #define LARGE_MEMORY_START                  0
 #endif // MEMORY_MANAGER_LARGE_BLOCK_COUNT
 
 
@@ -227,9 +212,6 @@ NRF_LOG_MODULE_REGISTER();
 #ifndef MEMORY_MANAGER_XLARGE_BLOCK_COUNT
    #define MEMORY_MANAGER_XLARGE_BLOCK_COUNT   0
    #define MEMORY_MANAGER_XLARGE_BLOCK_SIZE    0
-   #define XLARGE_BLOCK_START                  0
-   #define XLARGE_BLOCK_END                    0
-   #define XLARGE_MEMORY_START                 0
 #endif // MEMORY_MANAGER_XLARGE_BLOCK_COUNT
 
 
@@ -237,9 +219,6 @@ NRF_LOG_MODULE_REGISTER();
 #ifndef MEMORY_MANAGER_XXLARGE_BLOCK_COUNT
    #define MEMORY_MANAGER_XXLARGE_BLOCK_COUNT  0
    #define MEMORY_MANAGER_XXLARGE_BLOCK_SIZE   0
-   #define XXLARGE_BLOCK_START                 0
-   #define XXLARGE_BLOCK_END                   0
-   #define XXLARGE_MEMORY_START                0
 #endif // MEMORY_MANAGER_XXLARGE_BLOCK_COUNT
 
 
@@ -429,7 +408,38 @@ NRF_LOG_MODULE_REGISTER();
 #define BLOCK_CAT_XXL                  6                                                            /**< Extra Extra Large category identifier. */
 
 #define BITMAP_SIZE                    32                                                           /**< Bitmap size for each word used to contain block information. */
-#define BLOCK_BITMAP_ARRAY_SIZE        CEIL_DIV(TOTAL_BLOCK_COUNT, BITMAP_SIZE)                     /**< Determines number of blocks needed for book keeping availability status of all blocks. */
+#define BITMAP_MASK(bit)               (0x80000000UL >> (bit))                                      /**< Mask of a bit in a bitmap word. Bits are numbered from the most significant one, so that count leading zeros gives the first set bit. */
+#define CAT_BLOCK_COUNT_MAX            (BITMAP_SIZE * BITMAP_SIZE)                                  /**< Maximum number of blocks in a category, limited by the size of the category bitmap. */
+#define BLOCK_INDEX_INVALID            0xFFFFFFFF                                                   /**< Block index returned when no block is found. */
+
+
+/**@brief Number of bitmap words used by each block category. Each category starts in a new word. */
+#define XXSMALL_BITMAP_SIZE   CEIL_DIV(MEMORY_MANAGER_XXSMALL_BLOCK_COUNT, BITMAP_SIZE)
+#define XSMALL_BITMAP_SIZE    CEIL_DIV(MEMORY_MANAGER_XSMALL_BLOCK_COUNT,  BITMAP_SIZE)
+#define SMALL_BITMAP_SIZE     CEIL_DIV(MEMORY_MANAGER_SMALL_BLOCK_COUNT,   BITMAP_SIZE)
+#define MEDIUM_BITMAP_SIZE    CEIL_DIV(MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,  BITMAP_SIZE)
+#define LARGE_BITMAP_SIZE     CEIL_DIV(MEMORY_MANAGER_LARGE_BLOCK_COUNT,   BITMAP_SIZE)
+#define XLARGE_BITMAP_SIZE    CEIL_DIV(MEMORY_MANAGER_XLARGE_BLOCK_COUNT,  BITMAP_SIZE)
+#define XXLARGE_BITMAP_SIZE   CEIL_DIV(MEMORY_MANAGER_XXLARGE_BLOCK_COUNT, BITMAP_SIZE)
+
+/**@brief Index of the first bitmap word of each block category. */
+#define XXSMALL_BITMAP_START  0
+#define XSMALL_BITMAP_START   (XXSMALL_BITMAP_START + XXSMALL_BITMAP_SIZE)
+#define SMALL_BITMAP_START    (XSMALL_BITMAP_START  + XSMALL_BITMAP_SIZE)
+#define MEDIUM_BITMAP_START   (SMALL_BITMAP_START   + SMALL_BITMAP_SIZE)
+#define LARGE_BITMAP_START    (MEDIUM_BITMAP_START  + MEDIUM_BITMAP_SIZE)
+#define XLARGE_BITMAP_START   (LARGE_BITMAP_START   + LARGE_BITMAP_SIZE)
+#define XXLARGE_BITMAP_START  (XLARGE_BITMAP_START  + XLARGE_BITMAP_SIZE)
+
+#define BLOCK_BITMAP_ARRAY_SIZE        (XXLARGE_BITMAP_START + XXLARGE_BITMAP_SIZE)                 /**< Determines number of words needed for book keeping availability status of all blocks. */
+
+STATIC_ASSERT(MEMORY_MANAGER_XXSMALL_BLOCK_COUNT <= CAT_BLOCK_COUNT_MAX);
+STATIC_ASSERT(MEMORY_MANAGER_XSMALL_BLOCK_COUNT  <= CAT_BLOCK_COUNT_MAX);
+STATIC_ASSERT(MEMORY_MANAGER_SMALL_BLOCK_COUNT   <= CAT_BLOCK_COUNT_MAX);
+STATIC_ASSERT(MEMORY_MANAGER_MEDIUM_BLOCK_COUNT  <= CAT_BLOCK_COUNT_MAX);
+STATIC_ASSERT(MEMORY_MANAGER_LARGE_BLOCK_COUNT   <= CAT_BLOCK_COUNT_MAX);
+STATIC_ASSERT(MEMORY_MANAGER_XLARGE_BLOCK_COUNT  <= CAT_BLOCK_COUNT_MAX);
+STATIC_ASSERT(MEMORY_MANAGER_XXLARGE_BLOCK_COUNT <= CAT_BLOCK_COUNT_MAX);
 
 
 /**@brief Lookup table for maximum memory size per block category. */
@@ -480,8 +490,21 @@ static const uint32_t m_block_mem_start[BLOCK_CAT_COUNT] =
     XXLARGE_MEMORY_START
 };
 
+/**@brief Lookup table for first bitmap word for each block category. */
+static const uint32_t m_bitmap_start[BLOCK_CAT_COUNT] =
+{
+    XXSMALL_BITMAP_START,
+    XSMALL_BITMAP_START,
+    SMALL_BITMAP_START,
+    MEDIUM_BITMAP_START,
+    LARGE_BITMAP_START,
+    XLARGE_BITMAP_START,
+    XXLARGE_BITMAP_START
+};
+
 static uint8_t  m_memory[TOTAL_MEMORY_SIZE];                                                        /**< Memory managed by the module. */
 static uint32_t m_mem_pool[BLOCK_BITMAP_ARRAY_SIZE];                                                /**< Bitmap used for book-keeping availability of all blocks managed by the module.  */
+static uint32_t m_cat_bitmap[BLOCK_CAT_COUNT];                                                      /**< Bitmap of the words of @ref m_mem_pool that have a free block, for each block category. */
 
 #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
 
@@ -512,12 +535,6 @@ static uint32_t m_min_size[BLOCK_CAT_COUNT]  =
 /**@brief Table for book keeping largest size allocated in each block range. */
 static uint32_t m_max_size[BLOCK_CAT_COUNT];
 
-/**@brief Global pointing to minimum size holder for block type being allocated. */
-static uint32_t * p_min_size;
-
-/**@brief Global pointing to maximum size holder for block type being allocated. */
-static uint32_t * p_max_size;
-
 /**@brief Lookup table for count of block available in each block category. */
 static uint32_t m_block_count[BLOCK_CAT_COUNT] =
 {
@@ -540,12 +557,13 @@ static bool     m_module_initialized = false;
 
 /**@brief Function to get X and Y coordinates.
  *
- * @details Function to get X and Y co-ordinates for the block identified by index.
- *          Here, X determines relevant word for the block. Y determines the actual bit in the word.
+ * @details Function to get X and Y co-ordinates for the block identified by index in its category.
+ *          Here, X determines relevant word for the block, counted from the first word of the
+ *          category. Y determines the actual bit in the word.
  *
- * @param[in]  index Identifies the block.
- * @param[out] p_x   Points to the word that contains the bit representing the block.
- * @param[out] p_y   Contains the bitnumber in the the word 'X' relevant to the block.
+ * @param[in]  block_index Identifies the block in its category.
+ * @param[out] p_x         Points to the word that contains the bit representing the block.
+ * @param[out] p_y         Contains the bitnumber in the the word 'X' relevant to the block.
  */
 static __INLINE void get_block_coordinates(uint32_t block_index, uint32_t * p_x, uint32_t * p_y)
 {
@@ -560,7 +578,7 @@ static __INLINE void get_block_coordinates(uint32_t block_index, uint32_t * p_x,
 
 
 /**@brief Initializes the block by setting it to be free. */
-static void block_init (uint32_t block_index)
+static void block_init(uint32_t block_cat, uint32_t block_index)
 {
     uint32_t x;
     uint32_t y;
@@ -569,19 +587,20 @@ static void block_init (uint32_t block_index)
     // X determines relevant word for the block. Y determines the actual bit in the word.
     get_block_coordinates(block_index, &x, &y);
 
-    // Set bit related to the block to indicate that the block is free.
-    SET_BIT(m_mem_pool[x], y);
+    // Set bit related to the block to indicate that the block is free, and mark the word as having
+    // a free block.
+    m_mem_pool[m_bitmap_start[block_cat] + x] |= BITMAP_MASK(y);
+    m_cat_bitmap[block_cat]                   |= BITMAP_MASK(x);
 }
 
 
-/**@brief Function to get the category of the block of size 'size' or block number 'block_index'.*/
-static __INLINE uint32_t get_block_cat(uint32_t size, uint32_t block_index)
+/**@brief Function to get the category of the smallest blocks that can hold 'size' bytes. */
+static __INLINE uint32_t get_block_cat(uint32_t size)
 {
     for (uint32_t block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
     {
-        if (((size != 0) && (size <= m_block_size[block_cat]) &&
-            (m_block_end[block_cat] != m_block_start[block_cat])) ||
-            (block_index < m_block_end[block_cat]))
+        if ((size <= m_block_size[block_cat]) &&
+            (m_block_end[block_cat] != m_block_start[block_cat]))
         {
             return block_cat;
         }
@@ -591,22 +610,50 @@ static __INLINE uint32_t get_block_cat(uint32_t size, uint32_t block_index)
 }
 
 
-/**@brief Function to get the size of the block number 'block_index'. */
-static __INLINE uint32_t get_block_size(uint32_t block_index)
+/**@brief Function to get the category and the index of the block starting at 'p_mem'.
+ *
+ * @details The category is found by comparing the address with the start of the memory of each
+ *          category, and the index by dividing the offset in the category by the block size, so
+ *          the time does not depend on the number of blocks.
+ *
+ * @param[in]  p_mem         Pointer to the memory block.
+ * @param[out] p_block_cat   Category of the block.
+ * @param[out] p_block_index Index of the block in its category.
+ *
+ * @retval true  If p_mem is the start of a block managed by the module.
+ * @retval false Otherwise.
+ */
+static bool get_block_from_memory(void const * p_mem, uint32_t * p_block_cat, uint32_t * p_block_index)
 {
-    const uint32_t block_cat = get_block_cat(0, block_index);
+    const uintptr_t memory_index = (uintptr_t)p_mem - (uintptr_t)m_memory;
+
+    if (memory_index >= TOTAL_MEMORY_SIZE)
+    {
+        return false;
+    }
+
+    for (uint32_t block_cat = BLOCK_CAT_COUNT; block_cat-- > 0; )
+    {
+        if ((m_block_end[block_cat] != m_block_start[block_cat]) &&
+            (memory_index >= m_block_mem_start[block_cat]))
+        {
+            const uint32_t offset      = memory_index - m_block_mem_start[block_cat];
+            const uint32_t block_index = offset / m_block_size[block_cat];
 
-    #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
-        p_min_size = &m_min_size[block_cat];
-        p_max_size = &m_max_size[block_cat];
-    #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+            (*p_block_cat)   = block_cat;
+            (*p_block_index) = block_index;
 
-    return m_block_size[block_cat];
+            return ((block_index * m_block_size[block_cat]) == offset);
+        }
+    }
+
+    return false;
 }
 
 
+#ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
 /**@brief Function to free the block identified by block number 'block_index'. */
-static bool is_block_free(uint32_t block_index)
+static bool is_block_free(uint32_t block_cat, uint32_t block_index)
 {
     uint32_t x;
     uint32_t y;
@@ -615,12 +662,13 @@ static bool is_block_free(uint32_t block_index)
     // X determines relevant word for the block. Y determines the actual bit in the word.
     get_block_coordinates(block_index, &x, &y);
 
-    return IS_SET(m_mem_pool[x], y);
+    return ((m_mem_pool[m_bitmap_start[block_cat] + x] & BITMAP_MASK(y)) != 0);
 }
+#endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
 
 
 /**@brief Function to allocate the block identified by block number 'block_index'. */
-static void block_allocate(uint32_t block_index)
+static void block_allocate(uint32_t block_cat, uint32_t block_index)
 {
     uint32_t x;
     uint32_t y;
@@ -629,7 +677,36 @@ static void block_allocate(uint32_t block_index)
     // X determines relevant word for the block. Y determines the actual bit in the word.
     get_block_coordinates(block_index, &x, &y);
 
-    CLR_BIT(m_mem_pool[x], y);
+    uint32_t * const p_word = &m_mem_pool[m_bitmap_start[block_cat] + x];
+
+    (*p_word) &= ~BITMAP_MASK(y);
+    if ((*p_word) == 0)
+    {
+        m_cat_bitmap[block_cat] &= ~BITMAP_MASK(x);
+    }
+}
+
+
+/**@brief Function to find a free block in the category 'block_cat'.
+ *
+ * @details The category bitmap tells which words of the block bitmap have a free block, so a free
+ *          block is found with two count leading zeros operations whatever the number of blocks.
+ *
+ * @return Index of the block in its category, or BLOCK_INDEX_INVALID if all blocks are in use.
+ */
+static __INLINE uint32_t block_find_free(uint32_t block_cat)
+{
+    const uint32_t cat_bitmap = m_cat_bitmap[block_cat];
+
+    if (cat_bitmap == 0)
+    {
+        return BLOCK_INDEX_INVALID;
+    }
+
+    const uint32_t x = __CLZ(cat_bitmap);
+    const uint32_t y = __CLZ(m_mem_pool[m_bitmap_start[block_cat] + x]);
+
+    return (x * BITMAP_SIZE + y);
 }
 
 
@@ -641,11 +718,14 @@ uint32_t nrf_mem_init(void)
 
     MM_MUTEX_LOCK();
 
-    uint32_t block_index = 0;
-
-    for (block_index = 0; block_index < TOTAL_BLOCK_COUNT; block_index++)
+    for (uint32_t block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
     {
-        block_init(block_index);
+        const uint32_t block_count = m_block_end[block_cat] - m_block_start[block_cat];
+
+        for (uint32_t block_index = 0; block_index < block_count; block_index++)
+        {
+            block_init(block_cat, block_index);
+        }
     }
 
 #if (MEM_MANAGER_DISABLE_API_PARAM_CHECK == 0)
@@ -678,40 +758,39 @@ uint32_t nrf_mem_reserve(uint8_t ** pp_buffer, uint32_t * p_size)
 
     MM_MUTEX_LOCK();
 
-    const uint32_t block_cat    = get_block_cat(requested_size, TOTAL_BLOCK_COUNT);
-    uint32_t       block_index  = m_block_start[block_cat];
-    uint32_t       memory_index = m_block_mem_start[block_cat];
-    uint32_t       err_code     = (NRF_ERROR_NO_MEM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE);
+    uint32_t block_cat = get_block_cat(requested_size);
+    uint32_t err_code  = (NRF_ERROR_NO_MEM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE);
 
-    NRF_LOG_DEBUG("Start index for the pool = 0x%08lX, total block count 0x%08X",
-           block_index,
+    NRF_LOG_DEBUG("Start category for the pool = %d, total block count 0x%08X",
+           block_cat,
            TOTAL_BLOCK_COUNT);
 
-    for (; block_index < TOTAL_BLOCK_COUNT; block_index++)
+    // Larger blocks are used when all blocks of the smallest suitable category are in use.
+    for (; block_cat < BLOCK_CAT_COUNT; block_cat++)
     {
-        uint32_t block_size = get_block_size(block_index);
+        const uint32_t block_index = block_find_free(block_cat);
 
-        if (is_block_free(block_index) == true)
+        if (block_index != BLOCK_INDEX_INVALID)
         {
-            NRF_LOG_DEBUG("Reserving block 0x%08lX", block_index);
+            NRF_LOG_DEBUG("Reserving block 0x%08lX", m_block_start[block_cat] + block_index);
 
             // Search succeeded, found free block.
             err_code     = NRF_SUCCESS;
 
             // Allocate block.
-            block_allocate(block_index);
+            block_allocate(block_cat, block_index);
 
-            (*pp_buffer) = &m_memory[memory_index];
-            (*p_size)    = block_size;
+            (*pp_buffer) = &m_memory[m_block_mem_start[block_cat] +
+                                     block_index * m_block_size[block_cat]];
+            (*p_size)    = m_block_size[block_cat];
 
             #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
-                (*p_min_size) = MIN((*p_min_size), requested_size);
-                (*p_max_size) = MAX((*p_max_size), requested_size);
+                m_min_size[block_cat] = MIN(m_min_size[block_cat], requested_size);
+                m_max_size[block_cat] = MAX(m_max_size[block_cat], requested_size);
             #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
 
             break;
         }
-        memory_index += block_size;
     }
     if (err_code != NRF_SUCCESS)
     {
@@ -780,21 +859,16 @@ void nrf_free(void * p_mem)
 
     NRF_LOG_DEBUG(">> %s %p.", (uint32_t)__func__, (uint32_t)p_mem);
 
-    MM_MUTEX_LOCK();
+    uint32_t block_cat;
+    uint32_t block_index;
 
-    uint32_t index;
-    uint32_t memory_index = 0;
+    MM_MUTEX_LOCK();
 
-    for (index = 0; index < TOTAL_BLOCK_COUNT; index++)
+    if (get_block_from_memory(p_mem, &block_cat, &block_index))
     {
-        if (&m_memory[memory_index] == p_mem)
-        {
-            // Found a free block of memory, assign.
-            NRF_LOG_DEBUG("<< Freeing block %d.", index);
-            block_init(index);
-            break;
-        }
-        memory_index += get_block_size(index);
+        // Found a free block of memory, assign.
+        NRF_LOG_DEBUG("<< Freeing block %d.", m_block_start[block_cat] + block_index);
+        block_init(block_cat, block_index);
     }
 
     MM_MUTEX_UNLOCK();
@@ -806,7 +880,38 @@ void nrf_free(void * p_mem)
 
 void * nrf_realloc(void * p_mem, uint32_t size)
 {
-    return p_mem;
+    uint32_t block_cat;
+    uint32_t block_index;
+
+    if (p_mem == NULL)
+    {
+        return nrf_malloc(size);
+    }
+
+    if (!get_block_from_memory(p_mem, &block_cat, &block_index))
+    {
+        NRF_LOG_DEBUG("[%s]: %p is not a block", (uint32_t)__func__, (uint32_t)p_mem);
+        return NULL;
+    }
+
+    // The block is kept when it is large enough.
+    if (size <= m_block_size[block_cat])
+    {
+        return p_mem;
+    }
+
+    void * p_new_mem = nrf_malloc(size);
+
+    if (p_new_mem != NULL)
+    {
+        memcpy(p_new_mem, p_mem, m_block_size[block_cat]);
+        nrf_free(p_mem);
+    }
+
+    NRF_LOG_DEBUG("[%s]: %p moved to %p, size %d", (uint32_t)__func__,
+                  (uint32_t)p_mem, (uint32_t)p_new_mem, size);
+
+    return p_new_mem;
 }
 
 
@@ -828,10 +933,9 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
     #define ASCII_VALUE_FOR_SPACE   32
 
     char           print_buffer[PRINT_BUFFER_SIZE];
-    const uint32_t total_count   = (m_block_start[block_cat] + m_block_count[block_cat]);
     uint32_t       in_use        = 0;
     uint32_t       num_of_blocks = 0;
-    uint32_t       index         = m_block_start[block_cat];
+    uint32_t       index         = 0;
     uint32_t       column_number;
 
     // No statistic provided in case block category is not included.
@@ -839,9 +943,9 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
     {
         memset(print_buffer, ASCII_VALUE_FOR_SPACE, PRINT_BUFFER_SIZE);
 
-        for (; index < total_count; index++)
+        for (; index < m_block_count[block_cat]; index++)
         {
-            if (is_block_free(index) == false)
+            if (is_block_free(block_cat, index) == false)
             {
                 num_of_blocks++;
                 in_use += m_block_size[block_cat];
@@ -139,15 +139,18 @@ void * nrf_calloc(uint32_t nmemb, uint32_t size);
 void nrf_free(void * p_buffer);
 
 
-/**@brief Memory reallocation (trim) function.
+/**@brief 'realloc' styled memory reallocation function.
  *
- * @details API to reallocate memory or to trim it. Trim is mentioned here to avoid use of API to
- *          request memory size larger than original memory allocated.
+ * @details API to change the size of a memory block. If the block already holds 'size' bytes, it
+ *          is kept and p_buffer is returned. Otherwise, a larger block is reserved, the content of
+ *          the block is copied to it, and the old block is freed. If no larger block is available,
+ *          the old block is left untouched and NULL is returned. If p_buffer is NULL, the function
+ *          behaves like @ref nrf_malloc.
  *
- * @param[in] p_buffer   Pointer to the memory block that needs to be trimmed.
- * @param[in] size       Size of memory at the beginning of the buffer to be left untrimmed.
+ * @param[in] p_buffer   Pointer to the memory block to be resized, or NULL.
+ * @param[in] size       Requested memory size.
  *
- * @retval    Pointer to memory location with trimmed size, else, NULL.
+ * @retval    Pointer to memory location of at least 'size' bytes, else, NULL.
  */
 void * nrf_realloc(void *p_buffer, uint32_t size);
 
@@ -42,6 +42,9 @@
 #include "nrf_atomic.h"
 #include "nrf_assert.h"
 
+/** @brief Maximum number of chunks allocated or freed in one call to the block allocator. */
+#define MEMOBJ_CHUNK_BATCH 8
+
 typedef struct memobj_elem_s memobj_elem_t;
 
 /** @brief Standard chunk header. */
@@ -96,38 +99,50 @@ nrf_memobj_t * nrf_memobj_alloc(nrf_memobj_pool_t const * p_pool,
     uint32_t bsize = (uint32_t)NRF_BALLOC_ELEMENT_SIZE((nrf_balloc_t const *)p_pool) - sizeof(memobj_header_t);
     uint8_t num_of_chunks = (uint8_t)CEIL_DIV(size + sizeof(memobj_head_header_t), bsize);
 
-    memobj_head_t * p_head = nrf_balloc_alloc((nrf_balloc_t const *)p_pool);
-    if (p_head == NULL)
-    {
-        return NULL;
-    }
-    p_head->head_header.data.fields.user_cnt = 0;
-    p_head->head_header.data.fields.chunk_cnt = 1;
-    p_head->head_header.data.fields.chunk_size = bsize;
-
-    memobj_header_t * p_prev = (memobj_header_t *)p_head;
-    memobj_header_t * p_curr;
-    uint32_t i;
-    uint32_t chunk_less1 = (uint32_t)num_of_chunks - 1;
+    void            * p_chunks[MEMOBJ_CHUNK_BATCH];
+    memobj_head_t   * p_head = NULL;
+    memobj_header_t * p_prev = NULL;
+    uint8_t           chunk_cnt = 0;
 
-    p_prev->p_next =  (memobj_elem_t *)p_pool;
-    for (i = 0; i < chunk_less1; i++)
+    // Chunks are taken from the pool in batches to limit the number of critical regions.
+    while (chunk_cnt < num_of_chunks)
     {
-        p_curr = (memobj_header_t *)nrf_balloc_alloc((nrf_balloc_t const *)p_pool);
-        if (p_curr)
+        uint8_t requested = MIN(num_of_chunks - chunk_cnt, MEMOBJ_CHUNK_BATCH);
+        uint8_t allocated = nrf_balloc_alloc_n((nrf_balloc_t const *)p_pool, p_chunks, requested);
+
+        for (uint8_t i = 0; i < allocated; i++)
         {
-            (p_head->head_header.data.fields.chunk_cnt)++;
-            p_prev->p_next = (memobj_elem_t *)p_curr;
+            memobj_header_t * p_curr = (memobj_header_t *)p_chunks[i];
+
+            if (p_prev == NULL)
+            {
+                p_head = (memobj_head_t *)p_curr;
+            }
+            else
+            {
+                p_prev->p_next = (memobj_elem_t *)p_curr;
+            }
             p_curr->p_next = (memobj_elem_t *)p_pool;
             p_prev = p_curr;
         }
-        else
+        chunk_cnt += allocated;
+
+        if (allocated < requested)
         {
             //Could not allocate all requested buffers
-            nrf_memobj_free((nrf_memobj_t *)p_head);
+            if (p_head != NULL)
+            {
+                p_head->head_header.data.fields.chunk_cnt = chunk_cnt;
+                nrf_memobj_free((nrf_memobj_t *)p_head);
+            }
             return NULL;
         }
     }
+
+    p_head->head_header.data.fields.user_cnt = 0;
+    p_head->head_header.data.fields.chunk_cnt = chunk_cnt;
+    p_head->head_header.data.fields.chunk_size = bsize;
+
     return (nrf_memobj_t *)p_head;
 }
 
@@ -137,7 +152,6 @@ void nrf_memobj_free(nrf_memobj_t * p_obj)
     uint8_t chunk_cnt = p_head->head_header.data.fields.chunk_cnt;
     uint32_t i;
     memobj_header_t * p_curr = (memobj_header_t *)p_obj;
-    memobj_header_t * p_next;
     uint32_t chunk_less1 = (uint32_t)chunk_cnt - 1;
 
     for (i = 0; i < chunk_less1; i++)
@@ -146,12 +160,21 @@ void nrf_memobj_free(nrf_memobj_t * p_obj)
     }
     nrf_balloc_t const * p_pool2 = (nrf_balloc_t const *)p_curr->p_next;
 
+    void  * p_chunks[MEMOBJ_CHUNK_BATCH];
+    uint8_t batch_cnt = 0;
+
+    // Chunk headers are read before the batch is freed, as freeing may overwrite them.
     p_curr = (memobj_header_t *)p_obj;
     for (i = 0; i < chunk_cnt; i++)
     {
-        p_next = (memobj_header_t *)p_curr->p_next;
-        nrf_balloc_free(p_pool2, p_curr);
-        p_curr = p_next;
+        p_chunks[batch_cnt++] = p_curr;
+        p_curr = (memobj_header_t *)p_curr->p_next;
+
+        if ((batch_cnt == MEMOBJ_CHUNK_BATCH) || (i == chunk_less1))
+        {
+            nrf_balloc_free_n(p_pool2, p_chunks, batch_cnt);
+            batch_cnt = 0;
+        }
     }
 }
 
@@ -0,0 +1,22 @@
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include <stdint.h>
+#include "compiler_abstraction.h"
+#include "nrf.h"
+#include "nrf_assert.h"
+#include "app_error.h"
+
+// Interrupts are played by a signal in nrf_queue_stress. A critical region blocks the signal in
+// the calling thread and excludes the other threads, like masking interrupts on a single core.
+void app_util_critical_region_enter(uint8_t * p_nested);
+void app_util_critical_region_exit(uint8_t nested);
+
+#define CRITICAL_REGION_ENTER()     app_util_critical_region_enter(NULL)
+#define CRITICAL_REGION_EXIT()      app_util_critical_region_exit(0)
+#define CRITICAL_SECTION_ENTER()    CRITICAL_REGION_ENTER()
+#define CRITICAL_SECTION_EXIT()     CRITICAL_REGION_EXIT()
+
+#define APP_IRQ_PRIORITY_LOW    0
+
+#endif // APP_UTIL_PLATFORM_H__
@@ -0,0 +1,479 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Stress test and benchmark of the queue modes with concurrent producers.
+ *
+ * Build it on host from this directory:
+ *   L=../..; cc -O2 -pthread -Ihost -I$L/bench_host -I.. -I$L/util -I$L/atomic -I$L/log -I$L/log/src \
+ *      -I$L/strerror nrf_queue_stress.c ../nrf_queue.c $L/atomic/nrf_atomic.c $L/bench_host/bench.c \
+ *      -o nrf_queue_stress
+ *
+ * Usage: nrf_queue_stress [producers] [elements per producer] [interrupt period in us]
+ *
+ * Producer threads push elements carrying their ID, a sequence number and a checksum, with single
+ * pushes, writes and partial writes, while a consumer thread pops, peeks, reads and takes them out.
+ * A periodic signal plays the part of an interrupt: it preempts any thread, possibly in the middle
+ * of copying an element, then receives elements if the consumer is not busy, and pushes a few
+ * elements itself when the queue has many producers.
+ * A critical region blocks the signal and excludes the other threads, like masking interrupts.
+ * The consumer checks that every element is intact and that the elements of each producer come
+ * in order, and every pushed element must be received.
+ *
+ * The same load is run with a single producer in NRF_QUEUE_MODE_NO_OVERFLOW and
+ * NRF_QUEUE_MODE_SPSC, then with all producers in NRF_QUEUE_MODE_NO_OVERFLOW and
+ * NRF_QUEUE_MODE_MPSC. On host, a critical region costs system calls, so the time per element
+ * shows which mode scales, not the time it takes on the device.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "sdk_common.h"
+#include "nrf_queue.h"
+#include "bench.h"
+
+
+#define PRODUCERS_MAX       64
+#define IRQ_ID(thread_idx)  (PRODUCERS_MAX + (thread_idx))     // Producer ID used by the signal.
+#define IDS_MAX             (2 * PRODUCERS_MAX + 1)
+#define IRQ_BURST           4
+#define BURST_MAX           8
+#define QUEUE_SIZE          64
+#define WATCHDOG_S          10
+#define WATCHDOG_POLL_MS    10
+
+typedef struct
+{
+    uint32_t id;
+    uint32_t seq;
+    uint32_t check[2];
+} element_t;
+
+NRF_QUEUE_DEF(element_t, m_queue_no_overflow, QUEUE_SIZE, NRF_QUEUE_MODE_NO_OVERFLOW);
+NRF_QUEUE_DEF(element_t, m_queue_spsc, QUEUE_SIZE, NRF_QUEUE_MODE_SPSC);
+NRF_QUEUE_DEF(element_t, m_queue_mpsc, QUEUE_SIZE, NRF_QUEUE_MODE_MPSC);
+
+static pthread_mutex_t   m_critical_region = PTHREAD_MUTEX_INITIALIZER;
+static __thread uint32_t t_critical_nesting;
+static __thread sigset_t t_critical_saved_mask;
+
+static nrf_queue_t const * mp_queue;
+static uint32_t            m_producers;
+static uint32_t            m_elements;
+static bool                m_irq_producer;
+static volatile bool       m_done;
+static nrf_atomic_u32_t    m_consumer_busy;
+static nrf_atomic_u32_t    m_producers_done;
+static nrf_atomic_u32_t    m_irq_pushed;
+static nrf_atomic_u32_t    m_irq_dropped;
+
+static __thread uint32_t t_irq_id;
+static __thread uint32_t t_irq_seq;
+
+// Accessed by the consumer only.
+static uint32_t            m_consumer_op;
+static uint32_t            m_next_seq[IDS_MAX];
+static volatile uint64_t   m_received;
+static uint64_t            m_errors;
+static char const *        mp_first_error;
+static uint32_t            m_first_error_id;
+static uint32_t            m_first_error_seq;
+
+
+void app_util_critical_region_enter(uint8_t * p_nested)
+{
+    sigset_t set;
+    sigset_t saved_mask;
+
+    // The signal is blocked first, so that it cannot run between the nesting check and the lock.
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set, SIGALRM);
+    (void)pthread_sigmask(SIG_BLOCK, &set, &saved_mask);
+    if (t_critical_nesting++ == 0)
+    {
+        t_critical_saved_mask = saved_mask;
+        (void)pthread_mutex_lock(&m_critical_region);
+    }
+}
+
+
+void app_util_critical_region_exit(uint8_t nested)
+{
+    if (--t_critical_nesting == 0)
+    {
+        (void)pthread_mutex_unlock(&m_critical_region);
+        (void)pthread_sigmask(SIG_SETMASK, &t_critical_saved_mask, NULL);
+    }
+}
+
+
+static uint32_t checksum(uint32_t id, uint32_t seq)
+{
+    return (id * 0x9E3779B1) ^ (seq * 0x85EBCA6B) ^ 0x5A5A5A5A;
+}
+
+
+static void element_make(element_t * p_element, uint32_t id, uint32_t seq)
+{
+    p_element->id       = id;
+    p_element->seq      = seq;
+    p_element->check[0] = checksum(id, seq);
+    p_element->check[1] = ~p_element->check[0];
+}
+
+
+static void error(char const * p_what, uint32_t id, uint32_t seq)
+{
+    if (m_errors++ == 0)
+    {
+        mp_first_error    = p_what;
+        m_first_error_id  = id;
+        m_first_error_seq = seq;
+    }
+}
+
+
+static void element_check(element_t const * p_element)
+{
+    uint32_t const id  = p_element->id;
+    uint32_t const seq = p_element->seq;
+
+    if ((p_element->check[0] != checksum(id, seq)) || (p_element->check[1] != ~checksum(id, seq)))
+    {
+        error("corrupted element", id, seq);
+        return;
+    }
+    if ((id >= IDS_MAX) || ((id >= m_producers) && (id < PRODUCERS_MAX)))
+    {
+        error("invalid producer", id, seq);
+        return;
+    }
+    if (seq != m_next_seq[id])
+    {
+        error((seq < m_next_seq[id]) ? "element received twice or out of order" : "element lost",
+              id, seq);
+    }
+    m_next_seq[id] = seq + 1;
+    m_received++;
+}
+
+
+// Receives elements with one of the ways the queue offers.
+static uint32_t elements_receive_once(void)
+{
+    element_t elements[BURST_MAX];
+    element_t popped;
+    uint32_t  count = 0;
+    uint32_t  op    = m_consumer_op++;
+
+    switch (op % 4)
+    {
+        case 0:
+            count = (nrf_queue_pop(mp_queue, &elements[0]) == NRF_SUCCESS) ? 1 : 0;
+            break;
+
+        case 1:
+            if (nrf_queue_peek(mp_queue, &elements[0]) == NRF_SUCCESS)
+            {
+                if ((nrf_queue_pop(mp_queue, &popped) != NRF_SUCCESS) ||
+                    (memcmp(&popped, &elements[0], sizeof(popped)) != 0))
+                {
+                    error("popped element differs from peeked", popped.id, popped.seq);
+                }
+                count = 1;
+            }
+            break;
+
+        case 2:
+            count = 1 + ((op / 4) % BURST_MAX);
+            if (nrf_queue_read(mp_queue, elements, count) != NRF_SUCCESS)
+            {
+                count = 0;
+            }
+            break;
+
+        default:
+            count = nrf_queue_out(mp_queue, elements, BURST_MAX);
+            break;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        element_check(&elements[i]);
+    }
+    return count;
+}
+
+
+// Receives elements until the queue looks empty, unless another context is receiving. There is
+// one consumer at a time, like on the device.
+static void elements_receive(void)
+{
+    if (nrf_atomic_u32_fetch_store(&m_consumer_busy, 1) == 0)
+    {
+        // Each way of receiving is tried, so that a read of many elements does not end it.
+        for (uint32_t idle = 0; idle < 4; )
+        {
+            idle = (elements_receive_once() == 0) ? (idle + 1) : 0;
+        }
+        (void)nrf_atomic_u32_fetch_store(&m_consumer_busy, 0);
+    }
+}
+
+
+static void irq_handler(int signal)
+{
+    element_t element;
+
+    elements_receive();
+    if (!m_irq_producer)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < IRQ_BURST; i++)
+    {
+        // An interrupt cannot wait for the consumer, the elements that do not fit are dropped.
+        element_make(&element, t_irq_id, t_irq_seq);
+        if (nrf_queue_push(mp_queue, &element) != NRF_SUCCESS)
+        {
+            UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_irq_dropped, IRQ_BURST - i));
+            break;
+        }
+        t_irq_seq++;
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_irq_pushed, 1));
+    }
+}
+
+
+static void irq_enable(uint32_t thread_idx)
+{
+    sigset_t set;
+
+    t_irq_id = IRQ_ID(thread_idx);
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set, SIGALRM);
+    (void)pthread_sigmask(SIG_UNBLOCK, &set, NULL);
+}
+
+
+static void * producer(void * p_arg)
+{
+    uint32_t const id = (uint32_t)(uintptr_t)p_arg;
+    element_t      elements[BURST_MAX];
+    uint32_t       seq = 0;
+
+    irq_enable(id);
+    for (uint32_t i = 0; seq < m_elements; i++)
+    {
+        uint32_t const count = MIN(1 + (i % BURST_MAX), m_elements - seq);
+        uint32_t       written;
+
+        for (uint32_t j = 0; j < count; j++)
+        {
+            element_make(&elements[j], id, seq + j);
+        }
+        switch (i % 3)
+        {
+            case 0:
+                written = (nrf_queue_push(mp_queue, &elements[0]) == NRF_SUCCESS) ? 1 : 0;
+                break;
+
+            case 1:
+                written = (nrf_queue_write(mp_queue, elements, count) == NRF_SUCCESS) ? count : 0;
+                break;
+
+            default:
+                written = nrf_queue_in(mp_queue, elements, count);
+                break;
+        }
+        seq += written;
+        if (written == 0)
+        {
+            sched_yield();
+        }
+    }
+    UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&m_producers_done, 1));
+    return NULL;
+}
+
+
+static void * consumer(void * p_arg)
+{
+    irq_enable(PRODUCERS_MAX);
+    while (!m_done || !nrf_queue_is_empty(mp_queue))
+    {
+        elements_receive();
+        sched_yield();
+    }
+    return NULL;
+}
+
+
+static bool run(nrf_queue_t const * p_queue,
+                char const        * p_mode,
+                uint32_t            producers,
+                uint32_t            irq_period_us)
+{
+    pthread_t producer_threads[PRODUCERS_MAX];
+    pthread_t consumer_thread;
+
+    mp_queue         = p_queue;
+    m_producers      = producers;
+    m_irq_producer   = (p_queue->mode != NRF_QUEUE_MODE_SPSC);
+    m_done           = false;
+    m_consumer_busy  = 0;
+    m_consumer_op    = 0;
+    m_producers_done = 0;
+    m_irq_pushed     = 0;
+    m_irq_dropped    = 0;
+    m_received       = 0;
+    m_errors         = 0;
+    memset(m_next_seq, 0, sizeof(m_next_seq));
+    nrf_queue_reset(p_queue);
+
+    struct itimerval timer =
+    {
+        .it_interval = {.tv_usec = irq_period_us},
+        .it_value    = {.tv_usec = irq_period_us},
+    };
+
+    uint64_t const start = bench_now_ns();
+    (void)pthread_create(&consumer_thread, NULL, consumer, NULL);
+    for (uint32_t i = 0; i < producers; i++)
+    {
+        (void)pthread_create(&producer_threads[i], NULL, producer, (void *)(uintptr_t)i);
+    }
+    (void)setitimer(ITIMER_REAL, &timer, NULL);
+
+    // A corrupted queue can make the consumer or the producers wait forever. The producers are
+    // polled often, so that the time of the run is measured precisely.
+    uint64_t received = 0;
+    uint32_t idle_ms  = 0;
+    while (m_producers_done < producers)
+    {
+        (void)usleep(WATCHDOG_POLL_MS * 1000);
+        idle_ms  = (m_received == received) ? (idle_ms + WATCHDOG_POLL_MS) : 0;
+        received = m_received;
+        if (idle_ms >= WATCHDOG_S * 1000)
+        {
+            printf("FAILED: %s, no element received for %u s\n", p_mode, WATCHDOG_S);
+            _exit(1);
+        }
+    }
+
+    timer.it_interval.tv_usec = 0;
+    timer.it_value.tv_usec    = 0;
+    (void)setitimer(ITIMER_REAL, &timer, NULL);
+
+    for (uint32_t i = 0; i < producers; i++)
+    {
+        (void)pthread_join(producer_threads[i], NULL);
+    }
+    m_done = true;
+    (void)pthread_join(consumer_thread, NULL);
+    uint64_t const elapsed = bench_now_ns() - start;
+
+    uint64_t const pushed = (uint64_t)producers * m_elements + m_irq_pushed;
+
+    printf("%-12s %2u producers %12llu elements %8.1f ns/element, max utilization %2u/%u, "
+           "%u interrupt elements dropped\n",
+           p_mode, producers, (unsigned long long)pushed, (double)elapsed / pushed,
+           (unsigned)nrf_queue_max_utilization_get(p_queue), QUEUE_SIZE, m_irq_dropped);
+
+    if (m_errors != 0)
+    {
+        printf("FAILED: %llu invalid elements, first: %s, producer %u, element %u\n",
+               (unsigned long long)m_errors, mp_first_error, m_first_error_id, m_first_error_seq);
+        return false;
+    }
+    if (m_received != pushed)
+    {
+        printf("FAILED: %lld elements are not accounted for\n", (long long)(pushed - m_received));
+        return false;
+    }
+    if (!nrf_queue_is_empty(p_queue) || (nrf_queue_utilization_get(p_queue) != 0) ||
+        (nrf_queue_max_utilization_get(p_queue) > QUEUE_SIZE))
+    {
+        printf("FAILED: invalid queue state at the end\n");
+        return false;
+    }
+    return true;
+}
+
+
+int main(int argc, char ** argv)
+{
+    sigset_t         set;
+    struct sigaction action = {.sa_handler = irq_handler};
+
+    uint32_t const producers = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 4;
+    m_elements               = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 2000000;
+
+    uint32_t const irq_period_us = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : 20;
+    if ((producers == 0) || (producers > PRODUCERS_MAX))
+    {
+        fprintf(stderr, "1 to %u producers are supported.\n", PRODUCERS_MAX);
+        return 1;
+    }
+
+    // Only the producers and the consumer are interrupted, the threads inherit the mask.
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set, SIGALRM);
+    (void)pthread_sigmask(SIG_BLOCK, &set, NULL);
+    (void)sigaction(SIGALRM, &action, NULL);
+
+    printf("%u elements per producer, interrupt every %u us\n", m_elements, irq_period_us);
+    bool ok = run(&m_queue_no_overflow, "no overflow", 1, irq_period_us) &&
+              run(&m_queue_spsc, "spsc", 1, irq_period_us) &&
+              run(&m_queue_no_overflow, "no overflow", producers, irq_period_us) &&
+              run(&m_queue_mpsc, "mpsc", producers, irq_period_us);
+
+    if (!ok)
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -54,9 +54,29 @@
 
 NRF_SECTION_DEF(nrf_queue, nrf_queue_t);
 
+// In NRF_QUEUE_MODE_MPSC, the state word holds the front index, the back index including the
+// elements reserved by the producers, and the number of producers that have reserved elements
+// and not written them yet. A producer checks the free space and reserves it with one
+// compare-and-swap of the whole word, so that it fails if the consumer has moved in between.
+#define QUEUE_STATE_FRONT_MASK  0x00000FFFUL
+#define QUEUE_STATE_BACK_POS    12
+#define QUEUE_STATE_BACK_MASK   0x00FFF000UL
+#define QUEUE_STATE_WRITER      0x01000000UL
+#define QUEUE_STATE_IDX_MAX     0xFFFUL
+
+STATIC_ASSERT(QUEUE_STATE_IDX_MAX == NRF_QUEUE_MPSC_SIZE_MAX);
+
 #if NRF_QUEUE_CLI_CMDS
 #include "nrf_cli.h"
 
+static const char * const m_mode_names[] =
+{
+    [NRF_QUEUE_MODE_OVERFLOW]    = "Overflow",
+    [NRF_QUEUE_MODE_NO_OVERFLOW] = "No overflow",
+    [NRF_QUEUE_MODE_SPSC]        = "Single producer, single consumer",
+    [NRF_QUEUE_MODE_MPSC]        = "Many producers, single consumer",
+};
+
 static void nrf_queue_status(nrf_cli_t const * p_cli, size_t argc, char **argv)
 {
     UNUSED_PARAMETER(argv);
@@ -93,7 +113,7 @@ static void nrf_queue_status(nrf_cli_t const * p_cli, size_t argc, char **argv)
                         p_name, element_size,
                         100ul * util/size, util,size,
                         100ul * max_util/size, max_util,size,
-                        (p_instance->mode == NRF_QUEUE_MODE_OVERFLOW) ? "Overflow" : "No overflow");
+                        m_mode_names[p_instance->mode]);
 
     }
 }
@@ -120,6 +140,98 @@ __STATIC_INLINE size_t nrf_queue_next_idx(nrf_queue_t const * p_queue, size_t id
     return (idx < p_queue->size) ? (idx + 1) : 0;
 }
 
+/**@brief Get the index that is a number of elements after another one.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ * @param[in]   idx         Current index.
+ * @param[in]   count       Number of elements, not greater than the queue size.
+ *
+ * @return      Element index.
+ */
+__STATIC_INLINE size_t queue_idx_add(nrf_queue_t const * p_queue, size_t idx, size_t count)
+{
+    idx += count;
+    return (idx <= p_queue->size) ? idx : (idx - p_queue->size - 1);
+}
+
+/**@brief Check if the indexes of the queue are updated without critical regions.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ *
+ * @return      True in @ref NRF_QUEUE_MODE_SPSC and @ref NRF_QUEUE_MODE_MPSC.
+ */
+__STATIC_INLINE bool queue_is_lock_free(nrf_queue_t const * p_queue)
+{
+    return (p_queue->mode == NRF_QUEUE_MODE_SPSC) || (p_queue->mode == NRF_QUEUE_MODE_MPSC);
+}
+
+/**@brief Get the front index.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ *
+ * @return      Front index.
+ */
+__STATIC_INLINE size_t queue_front_get(nrf_queue_t const * p_queue)
+{
+    if (p_queue->mode == NRF_QUEUE_MODE_MPSC)
+    {
+        return p_queue->p_cb->state & QUEUE_STATE_FRONT_MASK;
+    }
+    return p_queue->p_cb->front;
+}
+
+/**@brief Get the back index, including the elements that producers are still writing.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ *
+ * @return      Back index.
+ */
+__STATIC_INLINE size_t queue_back_get(nrf_queue_t const * p_queue)
+{
+    if (p_queue->mode == NRF_QUEUE_MODE_MPSC)
+    {
+        return (p_queue->p_cb->state & QUEUE_STATE_BACK_MASK) >> QUEUE_STATE_BACK_POS;
+    }
+    return p_queue->p_cb->back;
+}
+
+/**@brief Get the back index of the elements that can be read.
+ *
+ * In @ref NRF_QUEUE_MODE_MPSC, the reserved elements can be read once no producer is writing.
+ * Until then, the back index last seen by the consumer is used.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ *
+ * @return      Back index.
+ */
+__STATIC_INLINE size_t queue_readable_back_get(nrf_queue_t const * p_queue)
+{
+    if (p_queue->mode == NRF_QUEUE_MODE_MPSC)
+    {
+        uint32_t state = p_queue->p_cb->state;
+        if (state < QUEUE_STATE_WRITER)
+        {
+            return state >> QUEUE_STATE_BACK_POS;
+        }
+    }
+    return p_queue->p_cb->back;
+}
+
+/**@brief Get the number of elements between two indexes.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ * @param[in]   front       Front index.
+ * @param[in]   back        Back index.
+ *
+ * @return      Number of elements.
+ */
+__STATIC_INLINE size_t queue_utilization_calc(nrf_queue_t const * p_queue,
+                                              size_t              front,
+                                              size_t              back)
+{
+    return (back >= front) ? (back - front) : (p_queue->size + 1 - front + back);
+}
+
 /**@brief Get current queue utilization. This function assumes that this process will not be interrupted.
  *
  * @param[in]   p_queue     Pointer to the queue instance.
@@ -128,16 +240,368 @@ __STATIC_INLINE size_t nrf_queue_next_idx(nrf_queue_t const * p_queue, size_t id
  */
 __STATIC_INLINE size_t queue_utilization_get(nrf_queue_t const * p_queue)
 {
-    size_t front    = p_queue->p_cb->front;
-    size_t back     = p_queue->p_cb->back;
-    return (back >= front) ? (back - front) : (p_queue->size + 1 - front + back);
+    size_t front    = queue_front_get(p_queue);
+    size_t back     = queue_back_get(p_queue);
+    return queue_utilization_calc(p_queue, front, back);
+}
+
+/**@brief Update the maximum utilization of the queue.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ * @param[in]   utilization Current utilization.
+ */
+static void queue_max_utilization_update(nrf_queue_t const * p_queue, size_t utilization)
+{
+    uint32_t max_utilization = p_queue->p_cb->max_utilization;
+
+    if (p_queue->mode == NRF_QUEUE_MODE_MPSC)
+    {
+        // Other producers may update the maximum at the same time.
+        while ((max_utilization < utilization)
+            && !nrf_atomic_u32_cmp_exch(&p_queue->p_cb->max_utilization,
+                                        &max_utilization,
+                                        utilization))
+        {
+        }
+    }
+    else if (max_utilization < utilization)
+    {
+        p_queue->p_cb->max_utilization = utilization;
+    }
+}
+
+/**@brief Write one element to the queue storage.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ * @param[in]   pos         Element index.
+ * @param[in]   p_element   Pointer to the element.
+ */
+static void queue_element_write(nrf_queue_t const * p_queue, size_t pos, void const * p_element)
+{
+    switch (p_queue->element_size)
+    {
+        case sizeof(uint8_t):
+            ((uint8_t *)p_queue->p_buffer)[pos] = *((uint8_t *)p_element);
+            break;
+
+        case sizeof(uint16_t):
+            ((uint16_t *)p_queue->p_buffer)[pos] = *((uint16_t *)p_element);
+            break;
+
+        case sizeof(uint32_t):
+            ((uint32_t *)p_queue->p_buffer)[pos] = *((uint32_t *)p_element);
+            break;
+
+        case sizeof(uint64_t):
+            ((uint64_t *)p_queue->p_buffer)[pos] = *((uint64_t *)p_element);
+            break;
+
+        default:
+            memcpy((void *)((size_t)p_queue->p_buffer + pos * p_queue->element_size),
+                   p_element,
+                   p_queue->element_size);
+            break;
+    }
+}
+
+/**@brief Read one element from the queue storage.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ * @param[in]   pos         Element index.
+ * @param[out]  p_element   Pointer where the element will be copied.
+ */
+static void queue_element_read(nrf_queue_t const * p_queue, size_t pos, void * p_element)
+{
+    switch (p_queue->element_size)
+    {
+        case sizeof(uint8_t):
+            *((uint8_t *)p_element) = ((uint8_t *)p_queue->p_buffer)[pos];
+            break;
+
+        case sizeof(uint16_t):
+            *((uint16_t *)p_element) = ((uint16_t *)p_queue->p_buffer)[pos];
+            break;
+
+        case sizeof(uint32_t):
+            *((uint32_t *)p_element) = ((uint32_t *)p_queue->p_buffer)[pos];
+            break;
+
+        case sizeof(uint64_t):
+            *((uint64_t *)p_element) = ((uint64_t *)p_queue->p_buffer)[pos];
+            break;
+
+        default:
+            memcpy(p_element,
+                   (void const *)((size_t)p_queue->p_buffer + pos * p_queue->element_size),
+                   p_queue->element_size);
+            break;
+    }
+}
+
+/**@brief Reserve elements at the back of a queue in @ref NRF_QUEUE_MODE_SPSC or
+ *        @ref NRF_QUEUE_MODE_MPSC. The elements must be committed with @ref lock_free_commit
+ *        when they are written.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   min_count           Minimal number of elements to reserve, at least 1.
+ * @param[in]   max_count           Maximal number of elements to reserve.
+ * @param[out]  p_pos               Index of the first reserved element.
+ *
+ * @return      The number of reserved elements, 0 if fewer than @p min_count are available.
+ */
+static size_t lock_free_reserve(nrf_queue_t const * p_queue,
+                                size_t              min_count,
+                                size_t              max_count,
+                                size_t            * p_pos)
+{
+    nrf_queue_cb_t * p_cb = p_queue->p_cb;
+    size_t           utilization;
+    size_t           count;
+
+    if (p_queue->mode == NRF_QUEUE_MODE_SPSC)
+    {
+        size_t back = p_cb->back;
+
+        utilization = queue_utilization_calc(p_queue, p_cb->front, back);
+        count       = MIN(max_count, p_queue->size - utilization);
+        if (count < min_count)
+        {
+            return 0;
+        }
+        *p_pos = back;
+    }
+    else
+    {
+        uint32_t state = p_cb->state;
+        uint32_t new_state;
+
+        ASSERT(p_queue->size <= QUEUE_STATE_IDX_MAX);
+
+        // Move the back index and count this producer as writing in one step, so that the
+        // consumer never sees the new index without the elements being written.
+        do
+        {
+            size_t front = state & QUEUE_STATE_FRONT_MASK;
+            size_t back  = (state & QUEUE_STATE_BACK_MASK) >> QUEUE_STATE_BACK_POS;
+
+            utilization = queue_utilization_calc(p_queue, front, back);
+            count       = MIN(max_count, p_queue->size - utilization);
+            if (count < min_count)
+            {
+                return 0;
+            }
+            *p_pos    = back;
+            new_state = ((state & ~QUEUE_STATE_BACK_MASK) + QUEUE_STATE_WRITER)
+                      | (queue_idx_add(p_queue, back, count) << QUEUE_STATE_BACK_POS);
+        } while (!nrf_atomic_u32_cmp_exch(&p_cb->state, &state, new_state));
+    }
+
+    queue_max_utilization_update(p_queue, utilization + count);
+
+    return count;
+}
+
+/**@brief Make elements reserved with @ref lock_free_reserve available to the consumer.
+ *
+ * In @ref NRF_QUEUE_MODE_MPSC, the elements become available when no other producer is writing.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   pos                 Index of the first reserved element.
+ * @param[in]   count               Number of reserved elements.
+ */
+static void lock_free_commit(nrf_queue_t const * p_queue, size_t pos, size_t count)
+{
+    // The elements must be written before the consumer can see them.
+    __DMB();
+
+    if (p_queue->mode == NRF_QUEUE_MODE_SPSC)
+    {
+        p_queue->p_cb->back = queue_idx_add(p_queue, pos, count);
+    }
+    else
+    {
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_sub(&p_queue->p_cb->state, QUEUE_STATE_WRITER));
+    }
+}
+
+/**@brief Get the elements that the consumer can read in @ref NRF_QUEUE_MODE_SPSC or
+ *        @ref NRF_QUEUE_MODE_MPSC. Only the consumer may call this function.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[out]  p_front             Index of the first element.
+ *
+ * @return      The number of elements that can be read.
+ */
+static size_t lock_free_readable_get(nrf_queue_t const * p_queue, size_t * p_front)
+{
+    size_t front = queue_front_get(p_queue);
+    size_t back  = queue_readable_back_get(p_queue);
+
+    if (p_queue->mode == NRF_QUEUE_MODE_MPSC)
+    {
+        // Keep the back index for the next calls, when producers may be writing again.
+        p_queue->p_cb->back = back;
+    }
+
+    // The elements must not be read before the index.
+    __DMB();
+
+    *p_front = front;
+    return queue_utilization_calc(p_queue, front, back);
+}
+
+/**@brief Remove elements that the consumer has read from the front of the queue.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   front               Index of the first element.
+ * @param[in]   count               Number of elements.
+ */
+static void lock_free_release(nrf_queue_t const * p_queue, size_t front, size_t count)
+{
+    // The elements must be read before the producers can overwrite them.
+    __DMB();
+
+    front = queue_idx_add(p_queue, front, count);
+    if (p_queue->mode == NRF_QUEUE_MODE_SPSC)
+    {
+        p_queue->p_cb->front = front;
+    }
+    else
+    {
+        uint32_t state = p_queue->p_cb->state;
+
+        while (!nrf_atomic_u32_cmp_exch(&p_queue->p_cb->state,
+                                        &state,
+                                        (state & ~QUEUE_STATE_FRONT_MASK) | front))
+        {
+        }
+    }
+}
+
+/**@brief Copy elements to the queue storage, wrapping around its end.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   pos                 Index of the first element.
+ * @param[in]   p_data              Pointer to the buffer with elements to write.
+ * @param[in]   element_count       Number of elements to write.
+ */
+static void queue_elements_write(nrf_queue_t const * p_queue,
+                                 size_t              pos,
+                                 void const        * p_data,
+                                 size_t              element_count)
+{
+    size_t continuous  = MIN(element_count, p_queue->size + 1 - pos);
+    void * p_write_ptr = (void *)((size_t)p_queue->p_buffer + pos * p_queue->element_size);
+
+    memcpy(p_write_ptr, p_data, continuous * p_queue->element_size);
+    memcpy(p_queue->p_buffer,
+           (void const *)((size_t)p_data + continuous * p_queue->element_size),
+           (element_count - continuous) * p_queue->element_size);
+}
+
+/**@brief Copy elements from the queue storage, wrapping around its end.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   pos                 Index of the first element.
+ * @param[out]  p_data              Pointer to the buffer where elements will be copied.
+ * @param[in]   element_count       Number of elements to read.
+ */
+static void queue_elements_read(nrf_queue_t const * p_queue,
+                                size_t              pos,
+                                void              * p_data,
+                                size_t              element_count)
+{
+    size_t       continuous = MIN(element_count, p_queue->size + 1 - pos);
+    void const * p_read_ptr = (void const *)((size_t)p_queue->p_buffer
+                                           + pos * p_queue->element_size);
+
+    memcpy(p_data, p_read_ptr, continuous * p_queue->element_size);
+    memcpy((void *)((size_t)p_data + continuous * p_queue->element_size),
+           p_queue->p_buffer,
+           (element_count - continuous) * p_queue->element_size);
+}
+
+/**@brief Write elements to a queue in @ref NRF_QUEUE_MODE_SPSC or @ref NRF_QUEUE_MODE_MPSC.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   p_data              Pointer to the buffer with elements to write.
+ * @param[in]   min_count           Minimal number of elements to write, at least 1.
+ * @param[in]   max_count           Maximal number of elements to write.
+ *
+ * @return      The number of written elements, 0 if fewer than @p min_count could be written.
+ */
+static size_t lock_free_write(nrf_queue_t const * p_queue,
+                              void const        * p_data,
+                              size_t              min_count,
+                              size_t              max_count)
+{
+    size_t pos;
+    size_t count = lock_free_reserve(p_queue, min_count, max_count, &pos);
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (count == 1)
+    {
+        queue_element_write(p_queue, pos, p_data);
+    }
+    else
+    {
+        queue_elements_write(p_queue, pos, p_data, count);
+    }
+
+    lock_free_commit(p_queue, pos, count);
+    return count;
+}
+
+/**@brief Read elements from a queue in @ref NRF_QUEUE_MODE_SPSC or @ref NRF_QUEUE_MODE_MPSC.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[out]  p_data              Pointer to the buffer where elements will be copied.
+ * @param[in]   min_count           Minimal number of elements to read, at least 1.
+ * @param[in]   max_count           Maximal number of elements to read.
+ * @param[in]   just_peek           If true, the elements are not removed from the queue.
+ *
+ * @return      The number of read elements, 0 if fewer than @p min_count could be read.
+ */
+static size_t lock_free_read(nrf_queue_t const * p_queue,
+                             void              * p_data,
+                             size_t              min_count,
+                             size_t              max_count,
+                             bool                just_peek)
+{
+    size_t front;
+    size_t readable = lock_free_readable_get(p_queue, &front);
+    size_t count    = MIN(max_count, readable);
+
+    if (count < min_count)
+    {
+        return 0;
+    }
+
+    if (count == 1)
+    {
+        queue_element_read(p_queue, front, p_data);
+    }
+    else
+    {
+        queue_elements_read(p_queue, front, p_data, count);
+    }
+
+    if (!just_peek)
+    {
+        lock_free_release(p_queue, front, count);
+    }
+    return count;
 }
 
 bool nrf_queue_is_full(nrf_queue_t const * p_queue)
 {
     ASSERT(p_queue != NULL);
-    size_t front    = p_queue->p_cb->front;
-    size_t back     = p_queue->p_cb->back;
+    size_t front    = queue_front_get(p_queue);
+    size_t back     = queue_back_get(p_queue);
 
     return (nrf_queue_next_idx(p_queue, back) == front);
 }
@@ -149,6 +613,14 @@ ret_code_t nrf_queue_push(nrf_queue_t const * p_queue, void const * p_element)
     ASSERT(p_queue != NULL);
     ASSERT(p_element != NULL);
 
+    if (queue_is_lock_free(p_queue))
+    {
+        size_t count = lock_free_write(p_queue, p_element, 1, 1);
+        status = (count == 1) ? NRF_SUCCESS : NRF_ERROR_NO_MEM;
+        NRF_LOG_INST_DEBUG(p_queue->p_log, "pushed element 0x%08X, status:%d", p_element, status);
+        return status;
+    }
+
     CRITICAL_REGION_ENTER();
     bool is_full = nrf_queue_is_full(p_queue);
 
@@ -165,37 +637,10 @@ ret_code_t nrf_queue_push(nrf_queue_t const * p_queue, void const * p_element)
         }
 
         // Write a new element.
-        switch (p_queue->element_size)
-        {
-            case sizeof(uint8_t):
-                ((uint8_t *)p_queue->p_buffer)[write_pos] = *((uint8_t *)p_element);
-                break;
-
-            case sizeof(uint16_t):
-                ((uint16_t *)p_queue->p_buffer)[write_pos] = *((uint16_t *)p_element);
-                break;
-
-            case sizeof(uint32_t):
-                ((uint32_t *)p_queue->p_buffer)[write_pos] = *((uint32_t *)p_element);
-                break;
-
-            case sizeof(uint64_t):
-                ((uint64_t *)p_queue->p_buffer)[write_pos] = *((uint64_t *)p_element);
-                break;
-
-            default:
-                memcpy((void *)((size_t)p_queue->p_buffer + write_pos * p_queue->element_size),
-                       p_element,
-                       p_queue->element_size);
-                break;
-        }
+        queue_element_write(p_queue, write_pos, p_element);
 
         // Update utilization.
-        size_t utilization = queue_utilization_get(p_queue);
-        if (p_queue->p_cb->max_utilization < utilization)
-        {
-            p_queue->p_cb->max_utilization = utilization;
-        }
+        queue_max_utilization_update(p_queue, queue_utilization_get(p_queue));
     }
     else
     {
@@ -217,6 +662,15 @@ ret_code_t nrf_queue_generic_pop(nrf_queue_t const * p_queue,
     ASSERT(p_queue      != NULL);
     ASSERT(p_element    != NULL);
 
+    if (queue_is_lock_free(p_queue))
+    {
+        size_t count = lock_free_read(p_queue, p_element, 1, 1, just_peek);
+        status = (count == 1) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND;
+        NRF_LOG_INST_DEBUG(p_queue->p_log, "%s element 0x%08X, status:%d",
+                                             just_peek ? "peeked" : "popped", p_element, status);
+        return status;
+    }
+
     CRITICAL_REGION_ENTER();
 
     if (!nrf_queue_is_empty(p_queue))
@@ -231,30 +685,7 @@ ret_code_t nrf_queue_generic_pop(nrf_queue_t const * p_queue,
         }
 
         // Read element.
-        switch (p_queue->element_size)
-        {
-            case sizeof(uint8_t):
-                *((uint8_t *)p_element) = ((uint8_t *)p_queue->p_buffer)[read_pos];
-                break;
-
-            case sizeof(uint16_t):
-                *((uint16_t *)p_element) = ((uint16_t *)p_queue->p_buffer)[read_pos];
-                break;
-
-            case sizeof(uint32_t):
-                *((uint32_t *)p_element) = ((uint32_t *)p_queue->p_buffer)[read_pos];
-                break;
-
-            case sizeof(uint64_t):
-                *((uint64_t *)p_element) = ((uint64_t *)p_queue->p_buffer)[read_pos];
-                break;
-
-            default:
-                memcpy(p_element,
-                       (void const *)((size_t)p_queue->p_buffer + read_pos * p_queue->element_size),
-                       p_queue->element_size);
-                break;
-        }
+        queue_element_read(p_queue, read_pos, p_element);
     }
     else
     {
@@ -311,11 +742,7 @@ static void queue_write(nrf_queue_t const * p_queue, void const * p_data, uint32
     }
 
     // Update utilization.
-    size_t utilization = queue_utilization_get(p_queue);
-    if (p_queue->p_cb->max_utilization < utilization)
-    {
-        p_queue->p_cb->max_utilization = utilization;
-    }
+    queue_max_utilization_update(p_queue, queue_utilization_get(p_queue));
 }
 
 ret_code_t nrf_queue_write(nrf_queue_t const * p_queue,
@@ -333,6 +760,15 @@ ret_code_t nrf_queue_write(nrf_queue_t const * p_queue,
         return NRF_SUCCESS;
     }
 
+    if (queue_is_lock_free(p_queue))
+    {
+        size_t count = lock_free_write(p_queue, p_data, element_count, element_count);
+        status = (count == element_count) ? NRF_SUCCESS : NRF_ERROR_NO_MEM;
+        NRF_LOG_INST_DEBUG(p_queue->p_log, "Write %d elements (start address: 0x%08X), status:%d",
+                                           element_count, p_data, status);
+        return status;
+    }
+
     CRITICAL_REGION_ENTER();
 
     if ((nrf_queue_available_get(p_queue) >= element_count)
@@ -367,6 +803,15 @@ size_t nrf_queue_in(nrf_queue_t const * p_queue,
         return 0;
     }
 
+    if (queue_is_lock_free(p_queue))
+    {
+        element_count = lock_free_write(p_queue, p_data, 1, element_count);
+        NRF_LOG_INST_DEBUG(p_queue->p_log,
+                           "Put in %d elements (start address: 0x%08X), requested :%d",
+                           element_count, p_data, req_element_count);
+        return element_count;
+    }
+
     CRITICAL_REGION_ENTER();
 
     if (p_queue->mode == NRF_QUEUE_MODE_OVERFLOW)
@@ -444,6 +889,15 @@ ret_code_t nrf_queue_read(nrf_queue_t const * p_queue,
         return NRF_SUCCESS;
     }
 
+    if (queue_is_lock_free(p_queue))
+    {
+        size_t count = lock_free_read(p_queue, p_data, element_count, element_count, false);
+        status = (count == element_count) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND;
+        NRF_LOG_INST_DEBUG(p_queue->p_log, "Read %d elements (start address: 0x%08X), status :%d",
+                                           element_count, p_data, status);
+        return status;
+    }
+
     CRITICAL_REGION_ENTER();
 
     if (element_count <= queue_utilization_get(p_queue))
@@ -476,6 +930,14 @@ size_t nrf_queue_out(nrf_queue_t const * p_queue,
         return 0;
     }
 
+    if (queue_is_lock_free(p_queue))
+    {
+        element_count = lock_free_read(p_queue, p_data, 1, element_count, false);
+        NRF_LOG_INST_DEBUG(p_queue->p_log, "Out %d elements (start address: 0x%08X), requested :%d",
+                                           element_count, p_data, req_element_count);
+        return element_count;
+    }
+
     CRITICAL_REGION_ENTER();
 
     size_t utilization = queue_utilization_get(p_queue);
@@ -508,6 +970,11 @@ size_t nrf_queue_utilization_get(nrf_queue_t const * p_queue)
     size_t utilization;
     ASSERT(p_queue != NULL);
 
+    if (queue_is_lock_free(p_queue))
+    {
+        return queue_utilization_get(p_queue);
+    }
+
     CRITICAL_REGION_ENTER();
 
     utilization = queue_utilization_get(p_queue);
@@ -520,8 +987,8 @@ size_t nrf_queue_utilization_get(nrf_queue_t const * p_queue)
 bool nrf_queue_is_empty(nrf_queue_t const * p_queue)
 {
     ASSERT(p_queue != NULL);
-    size_t front    = p_queue->p_cb->front;
-    size_t back     = p_queue->p_cb->back;
+    size_t front    = queue_front_get(p_queue);
+    size_t back     = queue_readable_back_get(p_queue);
     return (front == back);
 }
 
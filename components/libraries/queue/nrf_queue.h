@@ -56,6 +56,7 @@
 #include "app_util_platform.h"
 #include "nrf_log_instance.h"
 #include "nrf_section.h"
+#include "nrf_atomic.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -68,18 +69,35 @@ extern "C" {
 /**@brief Queue control block. */
 typedef struct
 {
-    volatile size_t front;          //!< Queue front index.
-    volatile size_t back;           //!< Queue back index.
-    size_t max_utilization;         //!< Maximum utilization of the queue.
+    volatile size_t  front;           //!< Queue front index.
+    volatile size_t  back;            //!< Queue back index.
+    nrf_atomic_u32_t state;           //!< Indexes and writing producers (@ref NRF_QUEUE_MODE_MPSC).
+    nrf_atomic_u32_t max_utilization; //!< Maximum utilization of the queue.
 } nrf_queue_cb_t;
 
-/**@brief Supported queue modes. */
+/**@brief Supported queue modes.
+ *
+ * In @ref NRF_QUEUE_MODE_OVERFLOW and @ref NRF_QUEUE_MODE_NO_OVERFLOW, every operation runs in
+ * a critical region, so any context can push or pop elements.
+ *
+ * In @ref NRF_QUEUE_MODE_SPSC and @ref NRF_QUEUE_MODE_MPSC, the indexes are updated without
+ * a critical region and the elements are copied with interrupts enabled. Only one context may
+ * pop, peek, read or take out elements, for example the main loop. If the queue is full, new
+ * elements are not accepted. @ref nrf_queue_reset may only be called when the queue is not used.
+ * In @ref NRF_QUEUE_MODE_MPSC, elements pushed while another producer is preempted in the middle
+ * of a push can be popped once that producer is done. Until then, they count in the utilization.
+ */
 typedef enum
 {
     NRF_QUEUE_MODE_OVERFLOW,        //!< If the queue is full, new element will overwrite the oldest.
     NRF_QUEUE_MODE_NO_OVERFLOW,     //!< If the queue is full, new element will not be accepted.
+    NRF_QUEUE_MODE_SPSC,            //!< Single producer, single consumer, without critical regions.
+    NRF_QUEUE_MODE_MPSC,            //!< Many producers, single consumer, without critical regions.
 } nrf_queue_mode_t;
 
+/**@brief Maximum size of a queue in @ref NRF_QUEUE_MODE_MPSC, which packs its indexes in 12 bits. */
+#define NRF_QUEUE_MPSC_SIZE_MAX     4095
+
 /**@brief Instance of the queue. */
 typedef struct
 {
@@ -105,10 +123,14 @@ typedef struct
  *
  * @param[in]   _type       Type which is stored.
  * @param[in]   _name       Name of the queue.
- * @param[in]   _size       Size of the queue.
+ * @param[in]   _size       Size of the queue. In @ref NRF_QUEUE_MODE_MPSC, it must not
+ *                          exceed @ref NRF_QUEUE_MPSC_SIZE_MAX.
  * @param[in]   _mode       Mode of the queue.
  */
 #define NRF_QUEUE_DEF(_type, _name, _size, _mode)                                        \
+    STATIC_ASSERT(((_mode) != NRF_QUEUE_MODE_MPSC) ||                                    \
+                  ((_size) <= NRF_QUEUE_MPSC_SIZE_MAX),                                  \
+                  "Queue too large for NRF_QUEUE_MODE_MPSC.");                           \
     static _type             CONCAT_2(_name, _nrf_queue_buffer[(_size) + 1]);            \
     static nrf_queue_cb_t    CONCAT_2(_name, _nrf_queue_cb);                             \
     NRF_LOG_INSTANCE_REGISTER(NRF_QUEUE_LOG_NAME, _name,                                 \
@@ -281,7 +303,7 @@ typedef struct
  * @param[in]   p_element           Pointer to the element that will be stored in the queue.
  *
  * @return      NRF_SUCCESS         If an element has been successfully added.
- * @return      NRF_ERROR_NO_MEM    If the queue is full (only in @ref NRF_QUEUE_MODE_NO_OVERFLOW).
+ * @return      NRF_ERROR_NO_MEM    If the queue is full (not in @ref NRF_QUEUE_MODE_OVERFLOW).
  */
 ret_code_t nrf_queue_push(nrf_queue_t const * p_queue, void const * p_element);
 
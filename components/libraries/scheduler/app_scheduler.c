@@ -47,24 +47,64 @@
 #include "nrf_assert.h"
 #include "app_util_platform.h"
 
-/**@brief Structure for holding a scheduled event header. */
+/**@brief Structure for holding a scheduled event header.
+ *
+ * @details The event data follows the header in the queue buffer. Events are aligned to
+ *          APP_SCHED_EVENT_ALIGN.
+ */
 typedef struct
 {
     app_sched_event_handler_t handler;          /**< Pointer to event handler to receive the event. */
     uint16_t                  event_data_size;  /**< Size of event data. */
+    volatile uint16_t         flags;            /**< Event state, see EVENT_FLAG_*. */
+#if APP_SCHEDULER_WITH_PROFILER
+    uint32_t                  timestamp;        /**< Time when the event was put. */
+#endif
 } event_header_t;
 
-STATIC_ASSERT(sizeof(event_header_t) <= APP_SCHED_EVENT_HEADER_SIZE);
+STATIC_ASSERT(sizeof(event_header_t) == APP_SCHED_EVENT_HEADER_SIZE);
+
+#define EVENT_FLAG_COMMITTED        0x0001  /**< Event data written, the event can be executed. */
+#define EVENT_FLAG_WRAP             0x0002  /**< Not an event, the queue continues at the start of the buffer. */
+#define EVENT_FLAG_COALESCED        0x0004  /**< Event of a handler that coalesces its events. */
+#define EVENT_FLAGS_HANDLER_Pos     8       /**< Position of the coalescing handler index in the flags. */
 
-static event_header_t * m_queue_event_headers;  /**< Array for holding the queue event headers. */
-static uint8_t        * m_queue_event_data;     /**< Array for holding the queue event data. */
-static volatile uint8_t m_queue_start_index;    /**< Index of queue entry at the start of the queue. */
-static volatile uint8_t m_queue_end_index;      /**< Index of queue entry at the end of the queue. */
-static uint16_t         m_queue_event_size;     /**< Maximum event size in queue. */
-static uint16_t         m_queue_size;           /**< Number of queue entries. */
+#define QUEUE_NO_SPACE              UINT32_MAX  /**< Offset returned when the event does not fit. */
 
+/**@brief Structure for holding an event queue of one priority. */
+typedef struct
+{
+    uint8_t         * p_buffer;         /**< Buffer for holding the queue events. */
+    uint32_t          buffer_size;      /**< Size of the queue buffer, a multiple of the event alignment. */
+    volatile uint32_t start;            /**< Offset of the event at the start of the queue. */
+    volatile uint32_t end;              /**< Offset of the free space at the end of the queue. */
+    uint16_t          event_size;       /**< Maximum event size in queue. */
 #if APP_SCHEDULER_WITH_PROFILER
-static uint16_t m_max_queue_utilization;    /**< Maximum observed queue utilization. */
+    uint16_t          events_put;       /**< Number of events added to the queue. */
+    volatile uint16_t events_executed;  /**< Number of events executed. */
+    app_sched_queue_stats_t stats;      /**< Statistics of the queue. */
+#endif
+} sched_queue_t;
+
+static sched_queue_t m_queues[APP_SCHEDULER_PRIORITY_COUNT];    /**< Event queues, highest priority first. */
+
+static app_sched_timestamp_func_t m_timestamp_func;     /**< Time stamp function, or NULL. */
+static uint32_t                   m_timestamp_mask;     /**< Mask of the time stamp counter bits. */
+static uint32_t                   m_execute_budget;     /**< Time budget of app_sched_execute, or 0. */
+
+#if APP_SCHEDULER_WITH_COALESCING
+/**@brief Structure for holding the state of a handler that coalesces its events. */
+typedef struct
+{
+    app_sched_event_handler_t handler;  /**< Event handler. */
+    sched_queue_t           * p_queue;  /**< Queue of the latest event waiting. */
+    uint32_t                  pending;  /**< Offset of the latest event waiting in the queue. */
+} coalescing_handler_t;
+
+static coalescing_handler_t m_coalescing_handlers[APP_SCHEDULER_COALESCING_HANDLERS];
+static uint8_t              m_coalescing_handlers_count;
+
+STATIC_ASSERT(APP_SCHEDULER_COALESCING_HANDLERS <= (UINT16_MAX >> EVENT_FLAGS_HANDLER_Pos));
 #endif
 
 #if APP_SCHEDULER_WITH_PAUSE
@@ -72,154 +112,530 @@ static uint32_t m_scheduler_paused_counter = 0; /**< Counter storing the differe
                                                      and resuming the scheduler. */
 #endif
 
-/**@brief Function for incrementing a queue index, and handle wrap-around.
+/**@brief Function for getting the number of bytes taken in the queue by an event.
  *
- * @param[in]   index   Old index.
+ * @param[in]   event_data_size   Size of event data.
  *
- * @return      New (incremented) index.
+ * @return      Size of the event header and the aligned event data.
  */
-static __INLINE uint8_t next_index(uint8_t index)
+static __INLINE uint32_t event_entry_size(uint16_t event_data_size)
 {
-    return (index < m_queue_size) ? (index + 1) : 0;
+    return APP_SCHED_EVENT_HEADER_SIZE
+           + ((event_data_size + APP_SCHED_EVENT_ALIGN - 1) & ~(APP_SCHED_EVENT_ALIGN - 1));
 }
 
 
-static __INLINE uint8_t app_sched_queue_full()
+/**@brief Function for getting the event header at a given offset in a queue buffer. */
+static __INLINE event_header_t * event_header_get(sched_queue_t const * p_queue, uint32_t offset)
 {
-  uint8_t tmp = m_queue_start_index;
-  return next_index(m_queue_end_index) == tmp;
+    return (event_header_t *)&p_queue->p_buffer[offset];
 }
 
-/**@brief Macro for checking if a queue is full. */
-#define APP_SCHED_QUEUE_FULL() app_sched_queue_full()
 
-
-static __INLINE uint8_t app_sched_queue_empty()
+/**@brief Function for getting the time elapsed since a time stamp. */
+static __INLINE uint32_t timestamp_elapsed(uint32_t timestamp)
 {
-  uint8_t tmp = m_queue_start_index;
-  return m_queue_end_index == tmp;
+    return (m_timestamp_func() - timestamp) & m_timestamp_mask;
 }
 
-/**@brief Macro for checking if a queue is empty. */
-#define APP_SCHED_QUEUE_EMPTY() app_sched_queue_empty()
 
+/**@brief Function for reserving room for an event at the end of a queue.
+ *
+ * @details If the event does not fit at the end of the buffer, the rest of the buffer is marked as
+ *          unused and the event is placed at the start of the buffer. Events never take the last
+ *          header's worth of the buffer, so that the wrap marker always fits. Some room is always
+ *          kept free, so that a full queue is not mistaken for an empty one. Must be called in a
+ *          critical region.
+ *
+ * @param[in]   p_queue      Queue.
+ * @param[in]   entry_size   Number of bytes to reserve, see @ref event_entry_size.
+ *
+ * @return      Offset of the reserved room, or QUEUE_NO_SPACE.
+ */
+static uint32_t queue_space_reserve(sched_queue_t * p_queue, uint32_t entry_size)
+{
+    uint32_t start = p_queue->start;
+    uint32_t end   = p_queue->end;
+    uint32_t offset;
+
+    if (end >= start)
+    {
+        uint32_t tail = p_queue->buffer_size - APP_SCHED_EVENT_HEADER_SIZE - end;
+
+        if (entry_size <= tail)
+        {
+            offset = end;
+        }
+        else if (entry_size < start)
+        {
+            event_header_get(p_queue, end)->flags = EVENT_FLAG_WRAP;
+            offset = 0;
+        }
+        else
+        {
+            return QUEUE_NO_SPACE;
+        }
+    }
+    else if (entry_size < (start - end))
+    {
+        offset = end;
+    }
+    else
+    {
+        return QUEUE_NO_SPACE;
+    }
 
-uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event_buffer)
+    p_queue->end = offset + entry_size;
+
+    return offset;
+}
+
+
+uint32_t app_sched_queue_init(uint8_t  priority,
+                              uint16_t event_size,
+                              void *   p_event_buffer,
+                              uint32_t buffer_size)
 {
-    uint16_t data_start_index = (queue_size + 1) * sizeof(event_header_t);
+    sched_queue_t * p_queue;
 
     // Check that buffer is correctly aligned
-    if (!is_word_aligned(p_event_buffer))
+    if ((priority >= APP_SCHEDULER_PRIORITY_COUNT) || !is_word_aligned(p_event_buffer))
     {
         return NRF_ERROR_INVALID_PARAM;
     }
 
+    // The buffer must hold an event of the maximum size and the wrap marker.
+    buffer_size &= ~(APP_SCHED_EVENT_ALIGN - 1);
+    if (buffer_size < event_entry_size(event_size) + APP_SCHED_EVENT_HEADER_SIZE)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_queue = &m_queues[priority];
+    memset(p_queue, 0, sizeof(*p_queue));
+    p_queue->p_buffer    = p_event_buffer;
+    p_queue->buffer_size = buffer_size;
+    p_queue->event_size  = event_size;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_buffer_init(uint16_t event_size, void * p_event_buffer, uint32_t buffer_size)
+{
     // Initialize event scheduler
-    m_queue_event_headers = p_event_buffer;
-    m_queue_event_data    = &((uint8_t *)p_event_buffer)[data_start_index];
-    m_queue_end_index     = 0;
-    m_queue_start_index   = 0;
-    m_queue_event_size    = event_size;
-    m_queue_size          = queue_size;
+    memset(m_queues, 0, sizeof(m_queues));
+    m_execute_budget = 0;
 
-#if APP_SCHEDULER_WITH_PROFILER
-    m_max_queue_utilization = 0;
+#if APP_SCHEDULER_WITH_COALESCING
+    m_coalescing_handlers_count = 0;
 #endif
 
+    return app_sched_queue_init(APP_SCHEDULER_DEFAULT_PRIORITY,
+                                event_size,
+                                p_event_buffer,
+                                buffer_size);
+}
+
+
+uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event_buffer)
+{
+    return app_sched_buffer_init(event_size,
+                                 p_event_buffer,
+                                 APP_SCHED_BUF_SIZE(event_size, queue_size));
+}
+
+
+void app_sched_timestamp_func_set(app_sched_timestamp_func_t timestamp_func,
+                                  uint32_t                   timestamp_mask)
+{
+    if (timestamp_func == NULL)
+    {
+        // The time budget cannot be measured without time stamps.
+        m_execute_budget = 0;
+    }
+
+    m_timestamp_mask = timestamp_mask;
+    m_timestamp_func = timestamp_func;
+}
+
+
+uint32_t app_sched_execute_budget_set(uint32_t budget)
+{
+    if (m_timestamp_func == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_execute_budget = budget;
+
     return NRF_SUCCESS;
 }
 
 
 uint16_t app_sched_queue_space_get()
 {
-    uint16_t start = m_queue_start_index;
-    uint16_t end   = m_queue_end_index;
-    uint16_t free_space = m_queue_size - ((end >= start) ?
-                           (end - start) : (m_queue_size + 1 - start + end));
-    return free_space;
+    sched_queue_t const * p_queue = &m_queues[APP_SCHEDULER_DEFAULT_PRIORITY];
+
+    uint32_t start      = p_queue->start;
+    uint32_t end        = p_queue->end;
+    uint32_t entry_size = event_entry_size(p_queue->event_size);
+    uint32_t space;
+
+    // Events end before the wrap marker room, and never fill the queue up to its start.
+    if (end >= start)
+    {
+        space = (p_queue->buffer_size - APP_SCHED_EVENT_HEADER_SIZE - end) / entry_size;
+        if (start != 0)
+        {
+            space += (start - 1) / entry_size;
+        }
+    }
+    else
+    {
+        space = (start - end - 1) / entry_size;
+    }
+
+    return (uint16_t)space;
 }
 
 
 #if APP_SCHEDULER_WITH_PROFILER
-static void queue_utilization_check(void)
+/**@brief Function for counting an event added to a queue. Must be called in a critical region,
+ *        because it modifies the maximum utilization.
+ */
+static void queue_utilization_check(sched_queue_t * p_queue)
 {
-    uint16_t start = m_queue_start_index;
-    uint16_t end   = m_queue_end_index;
-    uint16_t queue_utilization = (end >= start) ? (end - start) :
-        (m_queue_size + 1 - start + end);
+    uint16_t queue_utilization = ++p_queue->events_put - p_queue->events_executed;
 
-    if (queue_utilization > m_max_queue_utilization)
+    if (queue_utilization > p_queue->stats.max_utilization)
     {
-        m_max_queue_utilization = queue_utilization;
+        p_queue->stats.max_utilization = queue_utilization;
     }
 }
 
 uint16_t app_sched_queue_utilization_get(void)
 {
-    return m_max_queue_utilization;
+    uint16_t max_queue_utilization = 0;
+
+    for (uint32_t i = 0; i < APP_SCHEDULER_PRIORITY_COUNT; i++)
+    {
+        if (m_queues[i].stats.max_utilization > max_queue_utilization)
+        {
+            max_queue_utilization = m_queues[i].stats.max_utilization;
+        }
+    }
+
+    return max_queue_utilization;
+}
+
+uint32_t app_sched_queue_stats_get(uint8_t priority, app_sched_queue_stats_t * p_stats)
+{
+    if (priority >= APP_SCHEDULER_PRIORITY_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_queues[priority].stats;
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
 }
 #endif // APP_SCHEDULER_WITH_PROFILER
 
 
-uint32_t app_sched_event_put(void const              * p_event_data,
-                             uint16_t                  event_data_size,
-                             app_sched_event_handler_t handler)
+/**@brief Function for getting the queue of a priority to put an event into.
+ *
+ * @param[in]   priority          Priority of the event.
+ * @param[in]   event_data_size   Size of event data.
+ * @param[out]  pp_queue          Queue of the priority.
+ *
+ * @return      NRF_SUCCESS if the event can be put into the queue, otherwise an error code.
+ */
+static uint32_t queue_get(uint8_t priority, uint16_t event_data_size, sched_queue_t ** pp_queue)
+{
+    if (priority >= APP_SCHEDULER_PRIORITY_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    *pp_queue = &m_queues[priority];
+
+    if ((*pp_queue)->p_buffer == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (event_data_size > (*pp_queue)->event_size)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for reserving room for an event and writing its header. Must be called in a
+ *        critical region.
+ *
+ * @param[in]   p_queue           Queue.
+ * @param[in]   event_data_size   Size of event data.
+ * @param[in]   handler           Event handler.
+ * @param[in]   flags             Initial event flags.
+ *
+ * @return      Offset of the event header, or QUEUE_NO_SPACE.
+ */
+static uint32_t event_reserve(sched_queue_t           * p_queue,
+                              uint16_t                  event_data_size,
+                              app_sched_event_handler_t handler,
+                              uint16_t                  flags)
 {
-    uint32_t err_code;
+    uint32_t offset = queue_space_reserve(p_queue, event_entry_size(event_data_size));
 
-    if (event_data_size <= m_queue_event_size)
+    if (offset != QUEUE_NO_SPACE)
     {
-        uint16_t event_index = 0xFFFF;
+        event_header_t * p_header = event_header_get(p_queue, offset);
+
+        p_header->handler         = handler;
+        p_header->event_data_size = event_data_size;
+        p_header->flags           = flags;
+
+    #if APP_SCHEDULER_WITH_PROFILER
+        p_header->timestamp = (m_timestamp_func != NULL) ? m_timestamp_func() : 0;
+        queue_utilization_check(p_queue);
+    #endif
+    }
+
+    return offset;
+}
+
+
+uint32_t app_sched_event_priority_alloc(uint8_t                   priority,
+                                        uint16_t                  event_data_size,
+                                        app_sched_event_handler_t handler,
+                                        void **                   pp_event_data)
+{
+    sched_queue_t * p_queue;
+    uint32_t        offset;
+    uint32_t        err_code = queue_get(priority, event_data_size, &p_queue);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    CRITICAL_REGION_ENTER();
+    offset = event_reserve(p_queue, event_data_size, handler, 0);
+    CRITICAL_REGION_EXIT();
+
+    if (offset == QUEUE_NO_SPACE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    *pp_event_data = &p_queue->p_buffer[offset + APP_SCHED_EVENT_HEADER_SIZE];
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_event_alloc(uint16_t                  event_data_size,
+                               app_sched_event_handler_t handler,
+                               void **                   pp_event_data)
+{
+    return app_sched_event_priority_alloc(APP_SCHEDULER_DEFAULT_PRIORITY,
+                                          event_data_size,
+                                          handler,
+                                          pp_event_data);
+}
+
+
+void app_sched_event_commit(void * p_event_data)
+{
+    event_header_t * p_header =
+        (event_header_t *)((uint8_t *)p_event_data - APP_SCHED_EVENT_HEADER_SIZE);
+
+    ASSERT((p_header->flags & (EVENT_FLAG_COMMITTED | EVENT_FLAG_WRAP)) == 0);
+
+    // The event data must be in the queue before the main context sees the event.
+    __DMB();
+    p_header->flags |= EVENT_FLAG_COMMITTED;
+}
 
-        CRITICAL_REGION_ENTER();
 
-        if (!APP_SCHED_QUEUE_FULL())
+#if APP_SCHEDULER_WITH_COALESCING
+/**@brief Function for finding the index of a handler that coalesces its events.
+ *
+ * @return Index in m_coalescing_handlers, or APP_SCHEDULER_COALESCING_HANDLERS if not found.
+ */
+static uint32_t coalescing_handler_find(app_sched_event_handler_t handler)
+{
+    uint32_t i;
+
+    for (i = 0; i < m_coalescing_handlers_count; i++)
+    {
+        if (m_coalescing_handlers[i].handler == handler)
         {
-            event_index       = m_queue_end_index;
-            m_queue_end_index = next_index(m_queue_end_index);
-
-        #if APP_SCHEDULER_WITH_PROFILER
-            // This function call must be protected with critical region because
-            // it modifies 'm_max_queue_utilization'.
-            queue_utilization_check();
-        #endif
+            return i;
         }
+    }
 
-        CRITICAL_REGION_EXIT();
+    return APP_SCHEDULER_COALESCING_HANDLERS;
+}
 
-        if (event_index != 0xFFFF)
-        {
-            // NOTE: This can be done outside the critical region since the event consumer will
-            //       always be called from the main loop, and will thus never interrupt this code.
-            m_queue_event_headers[event_index].handler = handler;
-            if ((p_event_data != NULL) && (event_data_size > 0))
-            {
-                memcpy(&m_queue_event_data[event_index * m_queue_event_size],
-                       p_event_data,
-                       event_data_size);
-                m_queue_event_headers[event_index].event_data_size = event_data_size;
-            }
-            else
-            {
-                m_queue_event_headers[event_index].event_data_size = 0;
-            }
 
-            err_code = NRF_SUCCESS;
-        }
-        else
+uint32_t app_sched_handler_coalescing_enable(app_sched_event_handler_t handler)
+{
+    if (coalescing_handler_find(handler) < APP_SCHEDULER_COALESCING_HANDLERS)
+    {
+        return NRF_SUCCESS;
+    }
+
+    if (m_coalescing_handlers_count == APP_SCHEDULER_COALESCING_HANDLERS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    m_coalescing_handlers[m_coalescing_handlers_count].handler = handler;
+    m_coalescing_handlers[m_coalescing_handlers_count].p_queue = NULL;
+    m_coalescing_handlers[m_coalescing_handlers_count].pending = QUEUE_NO_SPACE;
+    m_coalescing_handlers_count++;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for putting an event of a handler that coalesces its events.
+ *
+ * @details The data is copied in the critical region, so that a put preempting another one for the
+ *          same handler cannot have its data overwritten with older data.
+ */
+static uint32_t coalesced_event_put(uint32_t                  index,
+                                    sched_queue_t           * p_queue,
+                                    void const              * p_event_data,
+                                    uint16_t                  event_data_size,
+                                    app_sched_event_handler_t handler)
+{
+    coalescing_handler_t * p_coalescing = &m_coalescing_handlers[index];
+    uint32_t               err_code     = NRF_SUCCESS;
+    uint32_t               offset;
+
+    CRITICAL_REGION_ENTER();
+
+    offset = p_coalescing->pending;
+    if ((offset == QUEUE_NO_SPACE)
+        || (p_coalescing->p_queue != p_queue)
+        || (event_header_get(p_queue, offset)->event_data_size != event_data_size))
+    {
+        offset = event_reserve(p_queue,
+                               event_data_size,
+                               handler,
+                               (uint16_t)(EVENT_FLAG_COALESCED | (index << EVENT_FLAGS_HANDLER_Pos)));
+    }
+
+    if (offset != QUEUE_NO_SPACE)
+    {
+        if (event_data_size > 0)
         {
-            err_code = NRF_ERROR_NO_MEM;
+            memcpy(&p_queue->p_buffer[offset + APP_SCHED_EVENT_HEADER_SIZE],
+                   p_event_data,
+                   event_data_size);
         }
+
+        event_header_get(p_queue, offset)->flags |= EVENT_FLAG_COMMITTED;
+        p_coalescing->p_queue = p_queue;
+        p_coalescing->pending = offset;
     }
     else
     {
-        err_code = NRF_ERROR_INVALID_LENGTH;
+        err_code = NRF_ERROR_NO_MEM;
     }
 
+    CRITICAL_REGION_EXIT();
+
     return err_code;
 }
 
 
+/**@brief Function for marking a coalesced event as no longer waiting, before it is executed.
+ *
+ * @param[in]   p_queue  Queue of the event.
+ * @param[in]   offset   Offset of the event.
+ * @param[in]   flags    Event flags.
+ */
+static void coalesced_event_start(sched_queue_t const * p_queue, uint32_t offset, uint16_t flags)
+{
+    coalescing_handler_t * p_coalescing =
+        &m_coalescing_handlers[flags >> EVENT_FLAGS_HANDLER_Pos];
+
+    CRITICAL_REGION_ENTER();
+    if ((p_coalescing->p_queue == p_queue) && (p_coalescing->pending == offset))
+    {
+        p_coalescing->pending = QUEUE_NO_SPACE;
+    }
+    CRITICAL_REGION_EXIT();
+}
+#endif // APP_SCHEDULER_WITH_COALESCING
+
+
+uint32_t app_sched_event_priority_put(uint8_t                   priority,
+                                      void const              * p_event_data,
+                                      uint16_t                  event_data_size,
+                                      app_sched_event_handler_t handler)
+{
+    sched_queue_t * p_queue;
+    void          * p_queue_data;
+    uint32_t        err_code = queue_get(priority, event_data_size, &p_queue);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    if (p_event_data == NULL)
+    {
+        event_data_size = 0;
+    }
+
+#if APP_SCHEDULER_WITH_COALESCING
+    uint32_t index = coalescing_handler_find(handler);
+
+    if (index < APP_SCHEDULER_COALESCING_HANDLERS)
+    {
+        return coalesced_event_put(index, p_queue, p_event_data, event_data_size, handler);
+    }
+#endif
+
+    err_code = app_sched_event_priority_alloc(priority, event_data_size, handler, &p_queue_data);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        // NOTE: This can be done outside the critical region since the event consumer will
+        //       not execute the event before it is committed.
+        if (event_data_size > 0)
+        {
+            memcpy(p_queue_data, p_event_data, event_data_size);
+        }
+
+        app_sched_event_commit(p_queue_data);
+    }
+
+    return err_code;
+}
+
+
+uint32_t app_sched_event_put(void const              * p_event_data,
+                             uint16_t                  event_data_size,
+                             app_sched_event_handler_t handler)
+{
+    return app_sched_event_priority_put(APP_SCHEDULER_DEFAULT_PRIORITY,
+                                        p_event_data,
+                                        event_data_size,
+                                        handler);
+}
+
+
 #if APP_SCHEDULER_WITH_PAUSE
 void app_sched_pause(void)
 {
@@ -260,29 +676,143 @@ static __INLINE bool is_app_sched_paused(void)
 }
 
 
+/**@brief Function for getting the event at the start of a queue, if it can be executed.
+ *
+ * @param[in]   p_queue   Queue.
+ * @param[in]   end       End of the queue, as read at the start of the run of events.
+ *
+ * @return      Event header, or NULL if the run is over or its next event is not committed.
+ */
+static event_header_t * queue_head_get(sched_queue_t * p_queue, uint32_t end)
+{
+    uint32_t         start = p_queue->start;
+    event_header_t * p_header;
+
+    if (start == end)
+    {
+        return NULL;
+    }
+
+    p_header = event_header_get(p_queue, start);
+    if (p_header->flags & EVENT_FLAG_WRAP)
+    {
+        // There is always an event at the start of the buffer after a wrap marker.
+        p_queue->start = 0;
+        p_header       = event_header_get(p_queue, 0);
+    }
+
+    return (p_header->flags & EVENT_FLAG_COMMITTED) ? p_header : NULL;
+}
+
+
+/**@brief Function for checking if a queue of higher priority than a given one has events.
+ *
+ * @param[in]   priority   Priority.
+ */
+static __INLINE bool queues_higher_pending(uint32_t priority)
+{
+    for (uint32_t i = 0; i < priority; i++)
+    {
+        if (m_queues[i].start != m_queues[i].end)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**@brief Function for executing the event at the start of a queue and removing it.
+ *
+ * @param[in]   p_queue    Queue.
+ * @param[in]   p_header   Event at the start of the queue, see @ref queue_head_get.
+ */
+static void event_execute(sched_queue_t * p_queue, event_header_t * p_header)
+{
+    // Since this function is only called from the main loop, there is no need for a critical
+    // region here. The start of the queue is moved only after an event is processed, so that
+    // its room is not reused while the handler runs.
+    uint32_t start = (uint32_t)((uint8_t *)p_header - p_queue->p_buffer);
+
+#if APP_SCHEDULER_WITH_COALESCING
+    if (p_header->flags & EVENT_FLAG_COALESCED)
+    {
+        coalesced_event_start(p_queue, start, p_header->flags);
+    }
+#endif
+
+#if APP_SCHEDULER_WITH_PROFILER
+    if (m_timestamp_func != NULL)
+    {
+        uint32_t latency = timestamp_elapsed(p_header->timestamp);
+
+        p_queue->stats.latency_total += latency;
+        if (latency > p_queue->stats.latency_max)
+        {
+            p_queue->stats.latency_max = latency;
+        }
+    }
+#endif
+
+    p_header->handler(&p_queue->p_buffer[start + APP_SCHED_EVENT_HEADER_SIZE],
+                      p_header->event_data_size);
+
+#if APP_SCHEDULER_WITH_PROFILER
+    p_queue->stats.events++;
+    p_queue->events_executed++;
+#endif
+
+    // Event processed, now it is safe to move the queue start, so the room
+    // occupied by this event can be used to store a next one.
+    p_queue->start = start + event_entry_size(p_header->event_data_size);
+}
+
+
 void app_sched_execute(void)
 {
-    while (!is_app_sched_paused() && !APP_SCHED_QUEUE_EMPTY())
+    uint32_t priority = 0;
+    uint32_t started  = (m_execute_budget != 0) ? m_timestamp_func() : 0;
+
+    while ((priority < APP_SCHEDULER_PRIORITY_COUNT) && !is_app_sched_paused())
     {
-        // Since this function is only called from the main loop, there is no
-        // need for a critical region here, however a special care must be taken
-        // regarding update of the queue start index (see the end of the loop).
-        uint16_t event_index = m_queue_start_index;
+        sched_queue_t  * p_queue = &m_queues[priority];
+        event_header_t * p_header;
+        bool             preempted = false;
 
-        void * p_event_data;
-        uint16_t event_data_size;
-        app_sched_event_handler_t event_handler;
+        // The end of the queue is read once for a run of events. Events put during the run are
+        // executed in the next one.
+        uint32_t const end = p_queue->end;
+
+        while (!is_app_sched_paused() && ((p_header = queue_head_get(p_queue, end)) != NULL))
+        {
+            event_execute(p_queue, p_header);
 
-        p_event_data = &m_queue_event_data[event_index * m_queue_event_size];
-        event_data_size = m_queue_event_headers[event_index].event_data_size;
-        event_handler   = m_queue_event_headers[event_index].handler;
+            if ((m_execute_budget != 0) && (timestamp_elapsed(started) >= m_execute_budget))
+            {
+                // Wake up the main loop to execute the remaining events.
+                __SEV();
+                return;
+            }
 
-        event_handler(p_event_data, event_data_size);
+            // The handler or an interrupt may have put events of higher priority.
+            if (queues_higher_pending(priority))
+            {
+                preempted = true;
+                break;
+            }
+        }
 
-        // Event processed, now it is safe to move the queue start index,
-        // so the queue entry occupied by this event can be used to store
-        // a next one.
-        m_queue_start_index = next_index(m_queue_start_index);
+        if (preempted)
+        {
+            priority = 0;
+        }
+        else if (p_queue->end == end)
+        {
+            // Events are executed in order, so an event that is not committed yet holds back
+            // the rest of its queue, but not the queues of lower priority.
+            priority++;
+        }
     }
 }
 #endif //NRF_MODULE_ENABLED(APP_SCHEDULER)
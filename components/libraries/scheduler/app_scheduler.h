@@ -65,6 +65,16 @@
  *     with the appropriate data and event handler. This will insert an event into the
  *     scheduler's queue. The app_sched_execute() function will pull this event and call its
  *     handler in the main context.
+ *   - Alternatively, reserve room for the event with app_sched_event_alloc(), write the event
+ *     data directly into the queue, and pass the event to the main context with
+ *     app_sched_event_commit(). This saves copying large events.
+ *
+ * Events are stored in a byte ring, each one taking only the room its data needs, so a queue
+ * holds more small events than large ones.
+ *
+ * Events can be put into several queues of different priorities, each with its own buffer (see
+ * @ref APP_SCHEDULER_PRIORITY_COUNT and @ref APP_SCHED_QUEUE_INIT). app_sched_execute() always
+ * executes the events of higher priority first, and can be given a time budget.
  *
  * @if (PERIPHERAL)
  * For an example usage of the scheduler, see the implementations of
@@ -86,9 +96,56 @@
 extern "C" {
 #endif
 
-#define APP_SCHED_EVENT_HEADER_SIZE 8       /**< Size of app_scheduler.event_header_t (only for use inside APP_SCHED_BUF_SIZE()). */
+#ifndef APP_SCHEDULER_WITH_COALESCING
+#define APP_SCHEDULER_WITH_COALESCING 0     /**< Enable @ref app_sched_handler_coalescing_enable. */
+#endif
+
+#ifndef APP_SCHEDULER_COALESCING_HANDLERS
+#define APP_SCHEDULER_COALESCING_HANDLERS 4 /**< Maximum number of handlers that coalesce their events. */
+#endif
+
+#ifndef APP_SCHEDULER_PRIORITY_COUNT
+#define APP_SCHEDULER_PRIORITY_COUNT 1      /**< Number of event queues. Priority 0 is the highest. */
+#endif
+
+#ifndef APP_SCHEDULER_DEFAULT_PRIORITY
+#define APP_SCHEDULER_DEFAULT_PRIORITY (APP_SCHEDULER_PRIORITY_COUNT - 1)  /**< Priority of the queue set up by @ref APP_SCHED_INIT and used by @ref app_sched_event_put. */
+#endif
+
+#if APP_SCHEDULER_DEFAULT_PRIORITY >= APP_SCHEDULER_PRIORITY_COUNT
+#error "APP_SCHEDULER_DEFAULT_PRIORITY must be lower than APP_SCHEDULER_PRIORITY_COUNT."
+#endif
+
+#define APP_SCHED_EVENT_ALIGN sizeof(void *)                /**< Alignment of the events in the scheduler buffer (only for use inside APP_SCHED_BUF_SIZE()). */
+
+#if APP_SCHEDULER_WITH_PROFILER
+#define APP_SCHED_EVENT_HEADER_FIELDS_SIZE (sizeof(void *) + 8) /**< Size of the fields of app_scheduler.event_header_t: handler, size, flags and the time stamp used by the statistics. */
+#else
+#define APP_SCHED_EVENT_HEADER_FIELDS_SIZE (sizeof(void *) + 4) /**< Size of the fields of app_scheduler.event_header_t: handler, size and flags. */
+#endif
+
+/**@brief Size of app_scheduler.event_header_t, its fields padded to the event alignment (only for
+ *        use inside APP_SCHED_BUF_SIZE()). It is 8 bytes on the target, or 12 bytes with the
+ *        profiler.
+ */
+#define APP_SCHED_EVENT_HEADER_SIZE                                                                \
+            (APP_SCHED_EVENT_ALIGN * CEIL_DIV(APP_SCHED_EVENT_HEADER_FIELDS_SIZE, APP_SCHED_EVENT_ALIGN))
+
+/**@brief Compute number of bytes taken in the scheduler buffer by an event.
+ *
+ * @param[in] EVENT_SIZE   Size of the event data.
+ *
+ * @return    Size of the event header and the aligned event data (in bytes).
+ */
+#define APP_SCHED_EVENT_ENTRY_SIZE(EVENT_SIZE)                                                     \
+            (APP_SCHED_EVENT_HEADER_SIZE + APP_SCHED_EVENT_ALIGN * CEIL_DIV((EVENT_SIZE),          \
+                                                                            APP_SCHED_EVENT_ALIGN))
 
 /**@brief Compute number of bytes required to hold the scheduler buffer.
+ *
+ * @details The buffer holds at least QUEUE_SIZE events of EVENT_SIZE bytes, and more events if
+ *          they are smaller. One more event accounts for the room lost when the queue wraps
+ *          around, and the end of the buffer is kept free for the wrap marker.
  *
  * @param[in] EVENT_SIZE   Maximum size of events to be passed through the scheduler.
  * @param[in] QUEUE_SIZE   Number of entries in scheduler queue (i.e. the maximum number of events
@@ -97,11 +154,25 @@ extern "C" {
  * @return    Required scheduler buffer size (in bytes).
  */
 #define APP_SCHED_BUF_SIZE(EVENT_SIZE, QUEUE_SIZE)                                                 \
-            (((EVENT_SIZE) + APP_SCHED_EVENT_HEADER_SIZE) * ((QUEUE_SIZE) + 1))
+            ((APP_SCHED_EVENT_ENTRY_SIZE(EVENT_SIZE) * ((QUEUE_SIZE) + 1))                         \
+             + APP_SCHED_EVENT_HEADER_SIZE)
 
 /**@brief Scheduler event handler type. */
 typedef void (*app_sched_event_handler_t)(void * p_event_data, uint16_t event_size);
 
+/**@brief Time stamp function type, see @ref app_sched_timestamp_func_set. */
+typedef uint32_t (*app_sched_timestamp_func_t)(void);
+
+/**@brief Statistics of a queue, see @ref app_sched_queue_stats_get. Times are in units of the
+ *        time stamp function. */
+typedef struct
+{
+    uint32_t events;            /**< Number of events executed. */
+    uint32_t latency_max;       /**< Longest time from putting an event to calling its handler. */
+    uint64_t latency_total;     /**< Sum of the times from putting the events to calling their handlers. */
+    uint16_t max_utilization;   /**< Maximum observed number of events in the queue. */
+} app_sched_queue_stats_t;
+
 /**@brief Macro for initializing the event scheduler.
  *
  * @details It will also handle dimensioning and allocation of the memory buffer required by the
@@ -123,9 +194,54 @@ typedef void (*app_sched_event_handler_t)(void * p_event_data, uint16_t event_si
         APP_ERROR_CHECK(ERR_CODE);                                                                 \
     } while (0)
 
+/**@brief Macro for initializing the event scheduler with a buffer of a given size.
+ *
+ * @details Use it instead of @ref APP_SCHED_INIT when most events are smaller than the largest
+ *          one, to size the buffer for the expected mix of events.
+ *
+ * @param[in] EVENT_SIZE   Maximum size of events to be passed through the scheduler.
+ * @param[in] BUFFER_SIZE  Size of the scheduler buffer (in bytes). It must be able to hold
+ *                         at least one event of EVENT_SIZE bytes, see
+ *                         @ref APP_SCHED_EVENT_ENTRY_SIZE.
+ *
+ * @note Since this macro allocates a buffer, it must only be called once (it is OK to call it
+ *       several times as long as it is from the same location, e.g. to do a reinitialization).
+ */
+#define APP_SCHED_BUFFER_INIT(EVENT_SIZE, BUFFER_SIZE)                                             \
+    do                                                                                             \
+    {                                                                                              \
+        static uint32_t APP_SCHED_BUF[CEIL_DIV((BUFFER_SIZE), sizeof(uint32_t))];                  \
+        uint32_t ERR_CODE = app_sched_buffer_init((EVENT_SIZE), APP_SCHED_BUF,                     \
+                                                  sizeof(APP_SCHED_BUF));                          \
+        APP_ERROR_CHECK(ERR_CODE);                                                                 \
+    } while (0)
+
+/**@brief Macro for initializing the queue of a given priority.
+ *
+ * @details It must be used after @ref APP_SCHED_INIT or @ref APP_SCHED_BUFFER_INIT, which set up
+ *          the queue of @ref APP_SCHEDULER_DEFAULT_PRIORITY.
+ *
+ * @param[in] PRIORITY     Priority of the queue, lower than @ref APP_SCHEDULER_PRIORITY_COUNT.
+ * @param[in] EVENT_SIZE   Maximum size of events to be put in the queue.
+ * @param[in] QUEUE_SIZE   Number of events of EVENT_SIZE bytes that the queue can hold.
+ *
+ * @note Since this macro allocates a buffer, it must only be called once for each queue (it is OK
+ *       to call it several times as long as it is from the same location).
+ */
+#define APP_SCHED_QUEUE_INIT(PRIORITY, EVENT_SIZE, QUEUE_SIZE)                                     \
+    do                                                                                             \
+    {                                                                                              \
+        static uint32_t APP_SCHED_BUF[CEIL_DIV(APP_SCHED_BUF_SIZE((EVENT_SIZE), (QUEUE_SIZE)),     \
+                                               sizeof(uint32_t))];                                 \
+        uint32_t ERR_CODE = app_sched_queue_init((PRIORITY), (EVENT_SIZE), APP_SCHED_BUF,          \
+                                                 sizeof(APP_SCHED_BUF));                           \
+        APP_ERROR_CHECK(ERR_CODE);                                                                 \
+    } while (0)
+
 /**@brief Function for initializing the Scheduler.
  *
- * @details It must be called before entering the main loop.
+ * @details It must be called before entering the main loop. It empties the queues of all
+ *          priorities, and sets up the queue of @ref APP_SCHEDULER_DEFAULT_PRIORITY.
  *
  * @param[in]   max_event_size   Maximum size of events to be passed through the scheduler.
  * @param[in]   queue_size       Number of entries in scheduler queue (i.e. the maximum number of
@@ -143,13 +259,84 @@ typedef void (*app_sched_event_handler_t)(void * p_event_data, uint16_t event_si
  */
 uint32_t app_sched_init(uint16_t max_event_size, uint16_t queue_size, void * p_evt_buffer);
 
+/**@brief Function for initializing the Scheduler with a buffer of a given size.
+ *
+ * @details It must be called before entering the main loop. It empties the queues of all
+ *          priorities, and sets up the queue of @ref APP_SCHEDULER_DEFAULT_PRIORITY.
+ *
+ * @param[in]   max_event_size   Maximum size of events to be passed through the scheduler.
+ * @param[in]   p_evt_buffer     Pointer to memory buffer for holding the scheduler queue. The
+ *                               buffer must be aligned to a 4 byte boundary.
+ * @param[in]   buffer_size      Size of the buffer (in bytes).
+ *
+ * @note Normally initialization should be done using the APP_SCHED_BUFFER_INIT() macro.
+ *
+ * @retval      NRF_SUCCESS               Successful initialization.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid parameter (buffer not aligned to a 4 byte
+ *                                        boundary).
+ * @retval      NRF_ERROR_INVALID_LENGTH  Buffer too small for an event of max_event_size bytes.
+ */
+uint32_t app_sched_buffer_init(uint16_t max_event_size, void * p_evt_buffer, uint32_t buffer_size);
+
+/**@brief Function for initializing the queue of a given priority.
+ *
+ * @details It must be called after @ref app_sched_init or @ref app_sched_buffer_init.
+ *
+ * @param[in]   priority         Priority of the queue.
+ * @param[in]   max_event_size   Maximum size of events to be put in the queue.
+ * @param[in]   p_evt_buffer     Pointer to memory buffer for holding the queue. The buffer must be
+ *                               aligned to a 4 byte boundary.
+ * @param[in]   buffer_size      Size of the buffer (in bytes).
+ *
+ * @note Normally initialization should be done using the APP_SCHED_QUEUE_INIT() macro.
+ *
+ * @retval      NRF_SUCCESS               Successful initialization.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority or buffer not aligned to a 4 byte
+ *                                        boundary.
+ * @retval      NRF_ERROR_INVALID_LENGTH  Buffer too small for an event of max_event_size bytes.
+ */
+uint32_t app_sched_queue_init(uint8_t  priority,
+                              uint16_t max_event_size,
+                              void *   p_evt_buffer,
+                              uint32_t buffer_size);
+
 /**@brief Function for executing all scheduled events.
  *
  * @details This function must be called from within the main loop. It will execute all events
- *          scheduled since the last time it was called.
+ *          scheduled since the last time it was called, the events of higher priority first. An
+ *          event put while a handler runs is executed before the remaining events of lower
+ *          priority.
+ *
+ *          If a time budget is set with @ref app_sched_execute_budget_set, the function returns
+ *          when the budget is used up, even if events are left. It then signals an event to the
+ *          CPU (__SEV), so that the next wait for event in the main loop returns immediately and
+ *          the function is called again.
  */
 void app_sched_execute(void);
 
+/**@brief Function for setting the time stamp function used for the time budget and the latency
+ *        statistics.
+ *
+ * @param[in]   timestamp_func   Function returning a free-running counter, e.g. app_timer_cnt_get,
+ *                               or NULL. NULL also removes the time budget.
+ * @param[in]   timestamp_mask   Mask of the counter bits, e.g. 0xFFFFFF for the 24 bit RTC counter.
+ *                               It must be a power of two minus one.
+ */
+void app_sched_timestamp_func_set(app_sched_timestamp_func_t timestamp_func,
+                                  uint32_t                   timestamp_mask);
+
+/**@brief Function for setting the time budget of each @ref app_sched_execute call.
+ *
+ * @details The budget is checked after each event, so the handler running when the budget is used
+ *          up is not interrupted.
+ *
+ * @param[in]   budget   Time budget in units of the time stamp function, or 0 for no budget.
+ *
+ * @retval      NRF_SUCCESS               Budget set.
+ * @retval      NRF_ERROR_INVALID_STATE   No time stamp function set.
+ */
+uint32_t app_sched_execute_budget_set(uint32_t budget);
+
 /**@brief Function for scheduling an event.
  *
  * @details Puts an event into the event queue.
@@ -164,22 +351,123 @@ uint32_t app_sched_event_put(void const *              p_event_data,
                              uint16_t                  event_size,
                              app_sched_event_handler_t handler);
 
+/**@brief Function for scheduling an event with a given priority.
+ *
+ * @details Puts an event into the event queue of the priority.
+ *
+ * @param[in]   priority       Priority of the event. Priority 0 is the highest.
+ * @param[in]   p_event_data   Pointer to event data to be scheduled.
+ * @param[in]   event_size     Size of event data to be scheduled.
+ * @param[in]   handler        Event handler to receive the event.
+ *
+ * @retval      NRF_SUCCESS               Event scheduled.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority.
+ * @retval      NRF_ERROR_INVALID_STATE   Queue of the priority not initialized.
+ * @retval      NRF_ERROR_INVALID_LENGTH  Event larger than the maximum event size of the queue.
+ * @retval      NRF_ERROR_NO_MEM          Not enough room in the queue.
+ */
+uint32_t app_sched_event_priority_put(uint8_t                   priority,
+                                      void const *              p_event_data,
+                                      uint16_t                  event_size,
+                                      app_sched_event_handler_t handler);
+
+/**@brief Function for reserving room for an event in the queue.
+ *
+ * @details The event data is written by the caller directly into the queue, then the event is
+ *          passed to the main context with @ref app_sched_event_commit. Events are executed in the
+ *          order in which they were reserved, so an event that is not committed holds back the
+ *          events reserved after it.
+ *
+ * @param[in]   event_size      Size of event data to be scheduled.
+ * @param[in]   handler         Event handler to receive the event.
+ * @param[out]  pp_event_data   Pointer to the room for the event data. It is aligned to a 4 byte
+ *                              boundary.
+ *
+ * @retval      NRF_SUCCESS               Room for the event reserved.
+ * @retval      NRF_ERROR_INVALID_LENGTH  Event larger than the maximum event size.
+ * @retval      NRF_ERROR_NO_MEM          Not enough room in the queue.
+ */
+uint32_t app_sched_event_alloc(uint16_t                  event_size,
+                               app_sched_event_handler_t handler,
+                               void **                   pp_event_data);
+
+/**@brief Function for reserving room for an event in the queue of a given priority.
+ *
+ * @details See @ref app_sched_event_alloc.
+ *
+ * @param[in]   priority        Priority of the event. Priority 0 is the highest.
+ * @param[in]   event_size      Size of event data to be scheduled.
+ * @param[in]   handler         Event handler to receive the event.
+ * @param[out]  pp_event_data   Pointer to the room for the event data.
+ *
+ * @retval      NRF_SUCCESS               Room for the event reserved.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority.
+ * @retval      NRF_ERROR_INVALID_STATE   Queue of the priority not initialized.
+ * @retval      NRF_ERROR_INVALID_LENGTH  Event larger than the maximum event size of the queue.
+ * @retval      NRF_ERROR_NO_MEM          Not enough room in the queue.
+ */
+uint32_t app_sched_event_priority_alloc(uint8_t                   priority,
+                                        uint16_t                  event_size,
+                                        app_sched_event_handler_t handler,
+                                        void **                   pp_event_data);
+
+/**@brief Function for passing an event reserved with @ref app_sched_event_alloc or
+ *        @ref app_sched_event_priority_alloc to the main context.
+ *
+ * @param[in]   p_event_data    Pointer returned when reserving the event.
+ */
+void app_sched_event_commit(void * p_event_data);
+
+/**@brief Function for making a handler coalesce its events.
+ *
+ * @details When @ref app_sched_event_put is called for the handler while one of its events of the
+ *          same size and priority is waiting in the queue, the data of the waiting event is
+ *          replaced and no event is added. The handler is then called once with the latest data. Events reserved
+ *          with @ref app_sched_event_alloc are never coalesced.
+ *
+ * @note @ref APP_SCHEDULER_WITH_COALESCING must be enabled to use this functionality. The
+ *       function must not be called while events are put from interrupts.
+ *
+ * @param[in]   handler         Event handler.
+ *
+ * @retval      NRF_SUCCESS       The handler coalesces its events.
+ * @retval      NRF_ERROR_NO_MEM  @ref APP_SCHEDULER_COALESCING_HANDLERS handlers already coalesce
+ *                                their events.
+ */
+uint32_t app_sched_handler_coalescing_enable(app_sched_event_handler_t handler);
+
 /**@brief Function for getting the maximum observed queue utilization.
  *
  * Function for tuning the module and determining QUEUE_SIZE value and thus module RAM usage.
  *
  * @note @ref APP_SCHEDULER_WITH_PROFILER must be enabled to use this functionality.
  *
- * @return Maximum number of events in queue observed so far.
+ * @return Maximum number of events observed so far in the queue of any priority.
  */
 uint16_t app_sched_queue_utilization_get(void);
 
-/**@brief Function for getting the current amount of free space in the queue.
+/**@brief Function for getting the statistics of the queue of a given priority.
+ *
+ * @details The latency is measured only when a time stamp function is set with
+ *          @ref app_sched_timestamp_func_set.
+ *
+ * @note @ref APP_SCHEDULER_WITH_PROFILER must be enabled to use this functionality.
+ *
+ * @param[in]   priority   Priority of the queue.
+ * @param[out]  p_stats    Statistics of the queue.
+ *
+ * @retval      NRF_SUCCESS               Statistics copied.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority.
+ */
+uint32_t app_sched_queue_stats_get(uint8_t priority, app_sched_queue_stats_t * p_stats);
+
+/**@brief Function for getting the current amount of free space in the queue of
+ *        @ref APP_SCHEDULER_DEFAULT_PRIORITY.
  *
  * @details The real amount of free space may be less if entries are being added from an interrupt.
  *          To get the sxact value, this function should be called from the critical section.
  *
- * @return Amount of free space in the queue.
+ * @return Number of events of the maximum size that can be put in the queue.
  */
 uint16_t app_sched_queue_space_get(void);
 
@@ -0,0 +1,812 @@
+/**
+ * Copyright (c) 2016 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Test, stress test and benchmark of the scheduler.
+ *
+ * Build it on host from this directory, with or without coalescing and the profiler:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I$L/util -I$L/log -I$L/log/src -I$L/strerror \
+ *      [-DAPP_SCHEDULER_WITH_COALESCING=0] [-DAPP_SCHEDULER_WITH_PROFILER=0] \
+ *      app_scheduler_stress.c ../app_scheduler.c $L/bench_host/bench.c -o app_scheduler_stress
+ *
+ * Usage: app_scheduler_stress [thread operations] [interrupt period in us]
+ *
+ * First, the queue is checked alone: how many events of each size fit, the order of execution,
+ * events reserved with app_sched_event_alloc and committed out of order, pausing, coalescing,
+ * priorities, the time budget and the statistics. Then the time to put and execute an event is
+ * printed.
+ *
+ * Then the thread, a low priority interrupt and a high priority interrupt that can preempt it
+ * put events of random sizes with app_sched_event_priority_put and app_sched_event_priority_alloc
+ * at the same time, while the thread executes them. Each source puts its events with its own
+ * scheduler priority, the higher the interrupt priority the higher the scheduler priority. The
+ * interrupts are played by two timer signals. Each event carries the number of its source and a
+ * sequence number, and its data is filled with a pattern, so that every event must be executed
+ * once, in order, with its own data, and only when no event of higher priority is waiting. The
+ * high priority interrupt also puts coalesced events with an increasing counter, which must never
+ * go back.
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "sdk_common.h"
+#include "app_scheduler.h"
+#include "bench.h"
+
+
+#define EVENT_SIZE_MAX      64
+#define QUEUE_SIZE          16
+#define IRQ_OPERATIONS      4
+#define BENCH_ROUNDS        1000000
+
+typedef enum
+{
+    SOURCE_THREAD,
+    SOURCE_LOW,
+    SOURCE_HIGH,
+    SOURCE_COUNT
+} source_t;
+
+typedef struct
+{
+    uint32_t source;
+    uint32_t sequence;
+    uint8_t  data[EVENT_SIZE_MAX - 2 * sizeof(uint32_t)];
+} event_t;
+
+typedef struct
+{
+    uint32_t random;
+    uint32_t put;           // Sequence number of the next event.
+    uint32_t executed;      // Sequence number of the next event to execute.
+    uint64_t shortages;
+} producer_t;
+
+static uint32_t   m_buffers[APP_SCHEDULER_PRIORITY_COUNT]
+                           [CEIL_DIV(APP_SCHED_BUF_SIZE(EVENT_SIZE_MAX, QUEUE_SIZE),
+                                     sizeof(uint32_t))];
+static uint8_t    m_source_priorities[SOURCE_COUNT];
+static bool       m_interrupts;
+static uint32_t   m_critical_nesting;
+static sigset_t   m_critical_saved_mask;
+static uint64_t   m_critical_regions;
+
+static producer_t m_producers[SOURCE_COUNT];
+static uint32_t   m_put_before[SOURCE_COUNT];   // Events put before the last handler returned.
+static uint32_t   m_coalesced_put;
+static uint32_t   m_coalesced_executed;
+static uint64_t   m_coalesced_events;
+
+
+
+void app_util_critical_region_enter(uint8_t * p_nested)
+{
+    sigset_t set;
+    sigset_t saved_mask;
+
+    // Without the timers, the benchmark measures the scheduler rather than the system calls.
+    m_critical_regions++;
+    if (!m_interrupts)
+    {
+        return;
+    }
+
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set, SIGALRM);
+    (void)sigaddset(&set, SIGPROF);
+    (void)sigprocmask(SIG_BLOCK, &set, &saved_mask);
+    if (m_critical_nesting++ == 0)
+    {
+        m_critical_saved_mask = saved_mask;
+    }
+}
+
+
+void app_util_critical_region_exit(uint8_t nested)
+{
+    if (m_interrupts && (--m_critical_nesting == 0))
+    {
+        (void)sigprocmask(SIG_SETMASK, &m_critical_saved_mask, NULL);
+    }
+}
+
+
+static uint32_t random_next(uint32_t * p_random)
+{
+    *p_random = *p_random * 1103515245 + 12345;
+    return *p_random >> 8;
+}
+
+
+static void sched_init(void)
+{
+    APP_ERROR_CHECK(app_sched_init(EVENT_SIZE_MAX,
+                                   QUEUE_SIZE,
+                                   m_buffers[APP_SCHEDULER_DEFAULT_PRIORITY]));
+    for (uint8_t i = 0; i < APP_SCHEDULER_PRIORITY_COUNT; i++)
+    {
+        if (i != APP_SCHEDULER_DEFAULT_PRIORITY)
+        {
+            APP_ERROR_CHECK(app_sched_queue_init(i, EVENT_SIZE_MAX, m_buffers[i],
+                                                 sizeof(m_buffers[i])));
+        }
+    }
+}
+
+
+/* Functional tests, with events that record their handler calls. */
+
+static uint32_t m_calls;
+static uint32_t m_last_value;
+static uint16_t m_last_size;
+
+static void record_handler(void * p_event_data, uint16_t event_size)
+{
+    m_calls++;
+    m_last_size = event_size;
+    if (event_size >= sizeof(uint32_t))
+    {
+        CHECK(((uintptr_t)p_event_data % sizeof(uint32_t)) == 0);
+        m_last_value = *(uint32_t *)p_event_data;
+    }
+}
+
+
+static void order_handler(void * p_event_data, uint16_t event_size)
+{
+    CHECK(*(uint32_t *)p_event_data == m_calls);
+    m_calls++;
+}
+
+
+static void repost_handler(void * p_event_data, uint16_t event_size)
+{
+    if (++m_calls < 5)
+    {
+        CHECK(app_sched_event_put(NULL, 0, repost_handler) == NRF_SUCCESS);
+    }
+}
+
+
+static uint32_t fill_count(uint16_t event_size)
+{
+    static uint8_t data[EVENT_SIZE_MAX];
+    uint32_t       count = 0;
+
+    while (app_sched_event_put(data, event_size, record_handler) == NRF_SUCCESS)
+    {
+        count++;
+    }
+    return count;
+}
+
+
+static void test_sizes(void)
+{
+    uint32_t large;
+    uint32_t small;
+    uint8_t  data[EVENT_SIZE_MAX + 1] = {0};
+
+    sched_init();
+    CHECK(app_sched_queue_space_get() >= QUEUE_SIZE);
+    CHECK(app_sched_event_put(data, EVENT_SIZE_MAX + 1, record_handler) ==
+          NRF_ERROR_INVALID_LENGTH);
+
+    // The buffer holds at least QUEUE_SIZE events of the maximum size, wherever the queue
+    // starts, and many more small events.
+    for (uint32_t offset = 0; offset < QUEUE_SIZE * 2; offset++)
+    {
+        sched_init();
+        for (uint32_t i = 0; i < offset; i++)
+        {
+            CHECK(app_sched_event_put(data, (uint16_t)(1 + i * 7 % EVENT_SIZE_MAX),
+                                      record_handler) == NRF_SUCCESS);
+            app_sched_execute();
+        }
+        large = fill_count(EVENT_SIZE_MAX);
+        CHECK(large >= QUEUE_SIZE);
+        CHECK(app_sched_queue_space_get() == 0);
+        m_calls = 0;
+        app_sched_execute();
+        CHECK(m_calls == large);
+    }
+
+    small = fill_count(4);
+    CHECK(small >= large * 2);
+    app_sched_execute();
+
+    // No data.
+    m_calls = 0;
+    CHECK(app_sched_event_put(NULL, 10, record_handler) == NRF_SUCCESS);
+    app_sched_execute();
+    CHECK((m_calls == 1) && (m_last_size == 0));
+#if APP_SCHEDULER_WITH_PROFILER
+    CHECK(app_sched_queue_utilization_get() == small);
+#endif
+}
+
+
+static void test_alloc_commit(void)
+{
+    uint32_t * p_data[3];
+
+    sched_init();
+    m_calls = 0;
+
+    // Events are executed in the order of reservation, and an event that is not committed
+    // holds the following ones back.
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        CHECK(app_sched_event_alloc(sizeof(uint32_t), order_handler, (void **)&p_data[i]) ==
+              NRF_SUCCESS);
+        CHECK(((uintptr_t)p_data[i] % sizeof(uint32_t)) == 0);
+        *p_data[i] = i;
+    }
+    CHECK(app_sched_event_alloc(EVENT_SIZE_MAX + 1, order_handler, (void **)&p_data[0]) ==
+          NRF_ERROR_INVALID_LENGTH);
+
+    app_sched_event_commit(p_data[1]);
+    app_sched_event_commit(p_data[2]);
+    app_sched_execute();
+    CHECK(m_calls == 0);
+    app_sched_event_commit(p_data[0]);
+    app_sched_execute();
+    CHECK(m_calls == 3);
+
+    // Pausing.
+    app_sched_pause();
+    CHECK(app_sched_event_put(&m_calls, sizeof(uint32_t), order_handler) == NRF_SUCCESS);
+    app_sched_execute();
+    CHECK(m_calls == 3);
+    app_sched_resume();
+    app_sched_execute();
+    CHECK(m_calls == 4);
+
+    // An event put by a handler in its own queue is executed by the same call.
+    m_calls = 0;
+    CHECK(app_sched_event_put(NULL, 0, repost_handler) == NRF_SUCCESS);
+    app_sched_execute();
+    CHECK(m_calls == 5);
+}
+
+
+#if APP_SCHEDULER_WITH_COALESCING
+static void coalesced_handler(void * p_event_data, uint16_t event_size)
+{
+    uint32_t value = 100;
+
+    record_handler(p_event_data, event_size);
+
+    // The event is no longer waiting, so a new one is added.
+    if (m_calls == 1)
+    {
+        CHECK(app_sched_event_put(&value, sizeof(value), coalesced_handler) == NRF_SUCCESS);
+    }
+}
+
+
+static void test_coalescing(void)
+{
+    uint32_t value;
+    uint8_t  byte = 0;
+
+    sched_init();
+    m_calls = 0;
+    CHECK(app_sched_handler_coalescing_enable(coalesced_handler) == NRF_SUCCESS);
+    CHECK(app_sched_handler_coalescing_enable(coalesced_handler) == NRF_SUCCESS);
+
+    for (value = 1; value <= 5; value++)
+    {
+        CHECK(app_sched_event_put(&value, sizeof(value), coalesced_handler) == NRF_SUCCESS);
+    }
+    app_sched_execute();
+    CHECK(m_calls == 2);
+    CHECK(m_last_value == 100);
+
+    // Events of another size are not coalesced with the waiting one.
+    m_calls = 0;
+    value   = 7;
+    CHECK(app_sched_event_put(&value, sizeof(value), coalesced_handler) == NRF_SUCCESS);
+    CHECK(app_sched_event_put(&byte, sizeof(byte), coalesced_handler) == NRF_SUCCESS);
+    CHECK(app_sched_event_put(&byte, sizeof(byte), coalesced_handler) == NRF_SUCCESS);
+    app_sched_execute();
+    CHECK(m_calls == 3);
+    CHECK(m_last_size == sizeof(uint32_t));
+
+    // Other handlers are not coalesced.
+    m_calls = 0;
+    CHECK(app_sched_event_put(&value, sizeof(value), record_handler) == NRF_SUCCESS);
+    CHECK(app_sched_event_put(&value, sizeof(value), record_handler) == NRF_SUCCESS);
+    app_sched_execute();
+    CHECK(m_calls == 2);
+
+    for (uint32_t i = 1; i < APP_SCHEDULER_COALESCING_HANDLERS; i++)
+    {
+        CHECK(app_sched_handler_coalescing_enable((app_sched_event_handler_t)(uintptr_t)i) ==
+              NRF_SUCCESS);
+    }
+    CHECK(app_sched_handler_coalescing_enable(record_handler) == NRF_ERROR_NO_MEM);
+}
+#endif // APP_SCHEDULER_WITH_COALESCING
+
+
+/* Priorities, time budget and statistics, with a clock advanced by the handlers. */
+
+static uint32_t m_time;
+static uint32_t m_order[16];
+
+static uint32_t time_get(void)
+{
+    return m_time;
+}
+
+
+static void priority_handler(void * p_event_data, uint16_t event_size)
+{
+    uint32_t const value = *(uint32_t *)p_event_data;
+
+    m_order[m_calls++ % ARRAY_SIZE(m_order)] = value;
+    m_time += 10;
+
+    // An event of the highest priority put by a handler is executed next.
+    if (value == 100)
+    {
+        uint32_t urgent = 1;
+
+        CHECK(app_sched_event_priority_put(0, &urgent, sizeof(urgent), priority_handler) ==
+              NRF_SUCCESS);
+    }
+}
+
+
+static void priority_put(uint8_t priority, uint32_t value)
+{
+    CHECK(app_sched_event_priority_put(priority, &value, sizeof(value), priority_handler) ==
+          NRF_SUCCESS);
+}
+
+
+static void test_priorities(void)
+{
+    uint8_t const lowest = APP_SCHEDULER_PRIORITY_COUNT - 1;
+    uint32_t      value  = 0;
+
+    // Only the queue of the default priority is set up by app_sched_init.
+    APP_ERROR_CHECK(app_sched_init(EVENT_SIZE_MAX, QUEUE_SIZE,
+                                   m_buffers[APP_SCHEDULER_DEFAULT_PRIORITY]));
+    CHECK(app_sched_event_priority_put(APP_SCHEDULER_PRIORITY_COUNT, &value, sizeof(value),
+                                       priority_handler) == NRF_ERROR_INVALID_PARAM);
+    if (APP_SCHEDULER_DEFAULT_PRIORITY != 0)
+    {
+        void * p_data;
+
+        CHECK(app_sched_event_priority_put(0, &value, sizeof(value), priority_handler) ==
+              NRF_ERROR_INVALID_STATE);
+        CHECK(app_sched_event_priority_alloc(0, sizeof(value), priority_handler, &p_data) ==
+              NRF_ERROR_INVALID_STATE);
+    }
+    CHECK(app_sched_queue_init(0, EVENT_SIZE_MAX, m_buffers[0], 8) == NRF_ERROR_INVALID_LENGTH);
+
+    sched_init();
+    app_sched_timestamp_func_set(time_get, UINT32_MAX);
+    m_calls = 0;
+    m_time  = 0;
+
+    // Events of higher priority first, in order within each priority. The handler of event 100
+    // puts event 1, which is executed before event 101.
+    priority_put(lowest, 100);
+    priority_put(lowest, 101);
+    priority_put(0, 0);
+    priority_put(lowest, 102);
+    priority_put(0, 2);
+    m_time = 1000;
+    app_sched_execute();
+
+    uint32_t const expected[] = {0, 2, 100, 1, 101, 102};
+    uint32_t const count      = (APP_SCHEDULER_PRIORITY_COUNT > 1) ? ARRAY_SIZE(expected) : 0;
+
+    CHECK(m_calls == ARRAY_SIZE(expected));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        CHECK(m_order[i] == expected[i]);
+    }
+
+#if APP_SCHEDULER_WITH_PROFILER
+    // Statistics: each event waited from time 0 or from the handler that put it.
+    app_sched_queue_stats_t stats;
+
+    CHECK(app_sched_queue_stats_get(APP_SCHEDULER_PRIORITY_COUNT, &stats) ==
+          NRF_ERROR_INVALID_PARAM);
+    CHECK(app_sched_queue_stats_get(lowest, &stats) == NRF_SUCCESS);
+    if (APP_SCHEDULER_PRIORITY_COUNT > 1)
+    {
+        CHECK(stats.events == 3);
+        CHECK(stats.max_utilization == 3);
+        CHECK(stats.latency_max == 1050);
+        CHECK(stats.latency_total == 1020 + 1040 + 1050);
+        CHECK(app_sched_queue_stats_get(0, &stats) == NRF_SUCCESS);
+        CHECK(stats.events == 3);
+        CHECK(stats.max_utilization == 2);
+        CHECK(stats.latency_max == 1010);
+        CHECK(stats.latency_total == 1000 + 1010 + 0);
+    }
+#endif
+    app_sched_timestamp_func_set(NULL, 0);
+}
+
+
+static void test_budget(void)
+{
+    sched_init();
+    CHECK(app_sched_execute_budget_set(25) == NRF_ERROR_INVALID_STATE);
+
+    // The time stamps wrap at 24 bits.
+    app_sched_timestamp_func_set(time_get, 0xFFFFFF);
+    CHECK(app_sched_execute_budget_set(25) == NRF_SUCCESS);
+    m_calls = 0;
+    m_time  = 0xFFFFF0;
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        priority_put(APP_SCHEDULER_PRIORITY_COUNT - 1, i);
+    }
+
+    // The budget is checked after each event, so three events of 10 are executed per call.
+    app_sched_execute();
+    CHECK(m_calls == 3);
+    app_sched_execute();
+    CHECK(m_calls == 6);
+    // Removing the time stamp function removes the budget.
+    app_sched_timestamp_func_set(NULL, 0);
+    CHECK(app_sched_execute_budget_set(25) == NRF_ERROR_INVALID_STATE);
+    app_sched_execute();
+    CHECK(m_calls == 8);
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        CHECK(m_order[i] == i);
+    }
+}
+
+
+/* Benchmark. */
+
+static void empty_handler(void * p_event_data, uint16_t event_size)
+{
+}
+
+
+static void bench_print(char const * p_name, uint16_t event_size, uint64_t start)
+{
+    uint64_t const elapsed = bench_now_ns() - start;
+
+    printf("%-16s %2u bytes %6.3f critical regions/event %8.1f ns/event\n", p_name, event_size,
+           (double)m_critical_regions / BENCH_ROUNDS, (double)elapsed / BENCH_ROUNDS);
+}
+
+
+static void bench(void)
+{
+    static uint8_t data[EVENT_SIZE_MAX];
+    uint16_t const sizes[] = {4, EVENT_SIZE_MAX};
+
+    sched_init();
+    for (uint32_t i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        uint64_t start = bench_now_ns();
+
+        m_critical_regions = 0;
+        for (uint32_t j = 0; j < BENCH_ROUNDS / 8; j++)
+        {
+            for (uint32_t k = 0; k < 8; k++)
+            {
+                (void)app_sched_event_put(data, sizes[i], empty_handler);
+            }
+            app_sched_execute();
+        }
+        bench_print("put", sizes[i], start);
+
+        start              = bench_now_ns();
+        m_critical_regions = 0;
+        for (uint32_t j = 0; j < BENCH_ROUNDS / 8; j++)
+        {
+            for (uint32_t k = 0; k < 8; k++)
+            {
+                void * p_data;
+
+                (void)app_sched_event_alloc(sizes[i], empty_handler, &p_data);
+                app_sched_event_commit(p_data);
+            }
+            app_sched_execute();
+        }
+        bench_print("alloc and commit", sizes[i], start);
+    }
+}
+
+
+/* Stress test. */
+
+// Records the events put so far, which must be executed before any event of lower priority.
+static void puts_record(void)
+{
+    for (uint32_t i = 0; i < SOURCE_COUNT; i++)
+    {
+        m_put_before[i] = m_producers[i].put;
+    }
+}
+
+
+static void event_handler(void * p_event_data, uint16_t event_size)
+{
+    event_t const * p_event = p_event_data;
+    producer_t *    p_producer;
+
+    if ((event_size < 2 * sizeof(uint32_t)) || (p_event->source >= SOURCE_COUNT))
+    {
+        bench_error_record("event header");
+        return;
+    }
+
+    p_producer = &m_producers[p_event->source];
+    if (p_event->sequence != p_producer->executed)
+    {
+        bench_error_record("event order");
+    }
+
+    // The events of higher priority put before the scheduler chose this event are executed.
+    for (uint32_t i = 0; i < SOURCE_COUNT; i++)
+    {
+        if ((m_source_priorities[i] < m_source_priorities[p_event->source])
+            && (m_producers[i].executed < m_put_before[i]))
+        {
+            bench_error_record("event priority");
+        }
+    }
+    p_producer->executed = p_event->sequence + 1;
+
+    for (uint32_t i = 0; i < event_size - 2 * sizeof(uint32_t); i++)
+    {
+        if (p_event->data[i] != (uint8_t)(p_event->sequence + i))
+        {
+            bench_error_record("event data");
+            break;
+        }
+    }
+    puts_record();
+}
+
+
+#if APP_SCHEDULER_WITH_COALESCING
+static void counter_handler(void * p_event_data, uint16_t event_size)
+{
+    uint32_t const value = *(uint32_t *)p_event_data;
+
+    if ((event_size != sizeof(uint32_t)) || (value <= m_coalesced_executed))
+    {
+        bench_error_record("coalesced event");
+    }
+    m_coalesced_executed = value;
+    m_coalesced_events++;
+    puts_record();
+}
+#endif // APP_SCHEDULER_WITH_COALESCING
+
+
+static void event_fill(event_t * p_event, source_t source, uint16_t size)
+{
+    p_event->source   = source;
+    p_event->sequence = m_producers[source].put;
+    for (uint32_t i = 0; i < size - 2 * sizeof(uint32_t); i++)
+    {
+        p_event->data[i] = (uint8_t)(p_event->sequence + i);
+    }
+}
+
+
+static void producer_step(source_t source)
+{
+    producer_t *   p_producer = &m_producers[source];
+    uint32_t const random     = random_next(&p_producer->random);
+    uint16_t const size       = (uint16_t)(2 * sizeof(uint32_t) +
+                                           (random >> 1) % (EVENT_SIZE_MAX - 2 * sizeof(uint32_t) + 1));
+    uint32_t       err_code;
+
+    if (random & 1)
+    {
+        event_t event;
+
+        event_fill(&event, source, size);
+        err_code = app_sched_event_priority_put(m_source_priorities[source],
+                                                &event, size, event_handler);
+    }
+    else
+    {
+        void * p_event;
+
+        err_code = app_sched_event_priority_alloc(m_source_priorities[source],
+                                                  size, event_handler, &p_event);
+        if (err_code == NRF_SUCCESS)
+        {
+            event_fill(p_event, source, size);
+            app_sched_event_commit(p_event);
+        }
+    }
+
+    if (err_code == NRF_SUCCESS)
+    {
+        p_producer->put++;
+    }
+    else
+    {
+        CHECK(err_code == NRF_ERROR_NO_MEM);
+        p_producer->shortages++;
+    }
+}
+
+
+static void irq_low_handler(int signal)
+{
+    for (uint32_t i = 0; i < IRQ_OPERATIONS; i++)
+    {
+        producer_step(SOURCE_LOW);
+    }
+}
+
+
+static void irq_high_handler(int signal)
+{
+    for (uint32_t i = 0; i < IRQ_OPERATIONS; i++)
+    {
+        producer_step(SOURCE_HIGH);
+    }
+
+#if APP_SCHEDULER_WITH_COALESCING
+    m_coalesced_put++;
+    (void)app_sched_event_priority_put(m_source_priorities[SOURCE_HIGH], &m_coalesced_put,
+                                       sizeof(m_coalesced_put), counter_handler);
+#endif
+}
+
+
+static void timers_set(uint32_t period_us)
+{
+    struct itimerval timer =
+    {
+        .it_interval = {.tv_usec = period_us},
+        .it_value    = {.tv_usec = period_us},
+    };
+
+    if (period_us != 0)
+    {
+        m_interrupts = true;
+    }
+    (void)setitimer(ITIMER_REAL, &timer, NULL);
+
+    // The high priority interrupt comes at another, unrelated rate.
+    timer.it_interval.tv_usec = (period_us * 7) / 5;
+    timer.it_value.tv_usec    = (period_us * 7) / 5;
+    (void)setitimer(ITIMER_PROF, &timer, NULL);
+}
+
+
+int main(int argc, char ** argv)
+{
+    struct sigaction action = {0};
+
+    uint64_t const operations    = (argc > 1) ? strtoull(argv[1], NULL, 0) : 5000000;
+    uint32_t const irq_period_us = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 20;
+
+    // The high priority interrupt preempts the low priority one, but not the other way round.
+    (void)sigemptyset(&action.sa_mask);
+    action.sa_handler = irq_low_handler;
+    (void)sigaction(SIGALRM, &action, NULL);
+    (void)sigaddset(&action.sa_mask, SIGALRM);
+    action.sa_handler = irq_high_handler;
+    (void)sigaction(SIGPROF, &action, NULL);
+
+    printf("coalescing %u, profiler %u, priorities %u, event header %u bytes\n",
+           APP_SCHEDULER_WITH_COALESCING, APP_SCHEDULER_WITH_PROFILER, APP_SCHEDULER_PRIORITY_COUNT,
+           (unsigned)APP_SCHED_EVENT_HEADER_SIZE);
+    test_sizes();
+    test_alloc_commit();
+#if APP_SCHEDULER_WITH_COALESCING
+    test_coalescing();
+#endif
+    test_priorities();
+    test_budget();
+    if (bench_failed())
+    {
+        return 1;
+    }
+
+    bench();
+
+    sched_init();
+#if APP_SCHEDULER_WITH_COALESCING
+    APP_ERROR_CHECK(app_sched_handler_coalescing_enable(counter_handler));
+#endif
+    for (uint32_t i = 0; i < SOURCE_COUNT; i++)
+    {
+        m_producers[i].random = 1 + i;
+    }
+    m_source_priorities[SOURCE_THREAD] = APP_SCHEDULER_DEFAULT_PRIORITY;
+    m_source_priorities[SOURCE_LOW]    = (APP_SCHEDULER_PRIORITY_COUNT > 2) ? 1 : 0;
+    m_source_priorities[SOURCE_HIGH]   = 0;
+
+    timers_set(irq_period_us);
+    for (uint64_t i = 0; i < operations; i++)
+    {
+        producer_step(SOURCE_THREAD);
+        if ((i % 4) == 0)
+        {
+            app_sched_execute();
+        }
+    }
+    timers_set(0);
+    m_interrupts = false;
+    app_sched_execute();
+
+    uint64_t events    = 0;
+    uint64_t shortages = 0;
+    for (uint32_t i = 0; i < SOURCE_COUNT; i++)
+    {
+        CHECK(m_producers[i].executed == m_producers[i].put);
+        events    += m_producers[i].put;
+        shortages += m_producers[i].shortages;
+    }
+    CHECK(m_coalesced_executed == m_coalesced_put);
+    printf("stress: %llu events (thread %u, low %u, high %u), %llu shortages, "
+           "%llu of %u coalesced events executed\n",
+           (unsigned long long)events,
+           m_producers[SOURCE_THREAD].put, m_producers[SOURCE_LOW].put,
+           m_producers[SOURCE_HIGH].put, (unsigned long long)shortages,
+           (unsigned long long)m_coalesced_events, m_coalesced_put);
+#if APP_SCHEDULER_WITH_PROFILER
+    printf("max utilization %u\n", app_sched_queue_utilization_get());
+#endif
+
+    if (bench_failed())
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include <stdint.h>
+#include "compiler_abstraction.h"
+#include "nrf.h"
+#include "nrf_assert.h"
+#include "app_error.h"
+
+// Interrupts are played by signals in app_scheduler_stress. A critical region blocks the signals,
+// like masking interrupts.
+void app_util_critical_region_enter(uint8_t * p_nested);
+void app_util_critical_region_exit(uint8_t nested);
+
+#define CRITICAL_REGION_ENTER()     app_util_critical_region_enter(NULL)
+#define CRITICAL_REGION_EXIT()      app_util_critical_region_exit(0)
+
+#endif // APP_UTIL_PLATFORM_H__
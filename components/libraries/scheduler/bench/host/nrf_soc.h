@@ -0,0 +1,6 @@
+#ifndef NRF_SOC_H__
+#define NRF_SOC_H__
+
+#include "nrf.h"
+
+#endif // NRF_SOC_H__
@@ -0,0 +1,24 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of the scheduler used by app_scheduler_stress. Coalescing, the
+// profiler and the number of priorities can be set from the command line.
+
+#define APP_SCHEDULER_ENABLED 1
+#define APP_SCHEDULER_WITH_PAUSE 1
+
+#ifndef APP_SCHEDULER_WITH_PROFILER
+#define APP_SCHEDULER_WITH_PROFILER 1
+#endif
+
+#ifndef APP_SCHEDULER_WITH_COALESCING
+#define APP_SCHEDULER_WITH_COALESCING 1
+#endif
+
+#ifndef APP_SCHEDULER_PRIORITY_COUNT
+#define APP_SCHEDULER_PRIORITY_COUNT 3
+#endif
+
+#define NRF_LOG_ENABLED 0
+
+#endif // SDK_CONFIG_H
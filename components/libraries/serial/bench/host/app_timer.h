@@ -0,0 +1,40 @@
+#ifndef APP_TIMER_H__
+#define APP_TIMER_H__
+
+// Host stand-in for the timers of nrf_serial, used by nrf_serial_bench only with timeouts that
+// need no timer.
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef struct
+{
+    uint32_t unused;
+} app_timer_t;
+
+typedef app_timer_t * app_timer_id_t;
+
+typedef void (*app_timer_timeout_handler_t)(void * p_context);
+
+typedef enum
+{
+    APP_TIMER_MODE_SINGLE_SHOT,
+    APP_TIMER_MODE_REPEATED
+} app_timer_mode_t;
+
+#define APP_TIMER_DEF(timer_id)                     \
+    static app_timer_t timer_id##_data;             \
+    static const app_timer_id_t timer_id = &timer_id##_data
+
+#define APP_TIMER_TICKS(ms)             ((uint32_t)(ms) * 32)
+#define APP_TIMER_MIN_TIMEOUT_TICKS     5
+
+ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                            app_timer_mode_t            mode,
+                            app_timer_timeout_handler_t timeout_handler);
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context);
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id);
+
+#endif // APP_TIMER_H__
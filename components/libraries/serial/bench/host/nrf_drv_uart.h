@@ -0,0 +1,110 @@
+#ifndef NRF_DRV_UART_H__
+#define NRF_DRV_UART_H__
+
+// Host stand-in for the UART driver, implemented by nrf_serial_bench on a simulated UARTE.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#define NRF_UART_PSEL_DISCONNECTED 0xFFFFFFFF
+
+typedef enum
+{
+    NRF_UART_HWFC_DISABLED,
+    NRF_UART_HWFC_ENABLED
+} nrf_uart_hwfc_t;
+
+typedef enum
+{
+    NRF_UART_PARITY_EXCLUDED,
+    NRF_UART_PARITY_INCLUDED
+} nrf_uart_parity_t;
+
+typedef enum
+{
+    NRF_UART_BAUDRATE_115200,
+    NRF_UART_BAUDRATE_1000000
+} nrf_uart_baudrate_t;
+
+typedef struct
+{
+    uint8_t inst_idx;
+} nrf_drv_uart_t;
+
+#define NRF_DRV_UART_INSTANCE(id) { .inst_idx = id }
+
+typedef enum
+{
+    NRF_DRV_UART_EVT_TX_DONE,
+    NRF_DRV_UART_EVT_RX_DONE,
+    NRF_DRV_UART_EVT_ERROR,
+} nrf_drv_uart_evt_type_t;
+
+typedef struct
+{
+    uint32_t            pseltxd;
+    uint32_t            pselrxd;
+    uint32_t            pselcts;
+    uint32_t            pselrts;
+    void *              p_context;
+    nrf_uart_hwfc_t     hwfc;
+    nrf_uart_parity_t   parity;
+    nrf_uart_baudrate_t baudrate;
+    uint8_t             interrupt_priority;
+    bool                use_easy_dma;
+} nrf_drv_uart_config_t;
+
+typedef struct
+{
+    uint8_t * p_data;
+    uint8_t   bytes;
+} nrf_drv_uart_xfer_evt_t;
+
+typedef struct
+{
+    nrf_drv_uart_xfer_evt_t rxtx;
+    uint32_t                error_mask;
+} nrf_drv_uart_error_evt_t;
+
+typedef struct
+{
+    nrf_drv_uart_evt_type_t type;
+    union
+    {
+        nrf_drv_uart_xfer_evt_t  rxtx;
+        nrf_drv_uart_error_evt_t error;
+    } data;
+} nrf_drv_uart_event_t;
+
+typedef void (*nrf_uart_event_handler_t)(nrf_drv_uart_event_t * p_event, void * p_context);
+
+ret_code_t nrf_drv_uart_init(nrf_drv_uart_t const *        p_instance,
+                             nrf_drv_uart_config_t const * p_config,
+                             nrf_uart_event_handler_t      event_handler);
+
+void nrf_drv_uart_uninit(nrf_drv_uart_t const * p_instance);
+
+ret_code_t nrf_drv_uart_tx(nrf_drv_uart_t const * p_instance,
+                           uint8_t const *        p_data,
+                           uint8_t                length);
+
+bool nrf_drv_uart_tx_in_progress(nrf_drv_uart_t const * p_instance);
+
+void nrf_drv_uart_tx_abort(nrf_drv_uart_t const * p_instance);
+
+ret_code_t nrf_drv_uart_rx(nrf_drv_uart_t const * p_instance,
+                           uint8_t *              p_data,
+                           uint8_t                length);
+
+bool nrf_drv_uart_rx_ready(nrf_drv_uart_t const * p_instance);
+
+void nrf_drv_uart_rx_enable(nrf_drv_uart_t const * p_instance);
+
+void nrf_drv_uart_rx_disable(nrf_drv_uart_t const * p_instance);
+
+void nrf_drv_uart_rx_abort(nrf_drv_uart_t const * p_instance);
+
+bool nrfx_is_in_ram(void const * p_object);
+
+#endif // NRF_DRV_UART_H__
@@ -0,0 +1,20 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of the serial port library used by nrf_serial_bench.
+
+#define NRF_SERIAL_ENABLED 1
+
+#define NRF_QUEUE_ENABLED 1
+#define NRF_QUEUE_CLI_CMDS 0
+#define NRF_QUEUE_CONFIG_LOG_ENABLED 0
+#define NRF_QUEUE_CONFIG_LOG_LEVEL 3
+#define NRF_QUEUE_CONFIG_LOG_INIT_FILTER_LEVEL 3
+#define NRF_QUEUE_CONFIG_INFO_COLOR 0
+#define NRF_QUEUE_CONFIG_DEBUG_COLOR 0
+
+#define NRF_ATOMIC_USE_BUILD_IN 1
+
+#define NRF_LOG_ENABLED 0
+
+#endif // SDK_CONFIG_H
@@ -0,0 +1,851 @@
+/**
+ * Copyright (c) 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* Test and benchmark of streamed transfers of the serial port library, on a simulated UARTE.
+ *
+ * Build it on host from this directory:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I$L/queue -I$L/util -I$L/atomic -I$L/mutex -I$L/log \
+ *      -I$L/log/src -I$L/strerror nrf_serial_bench.c ../nrf_serial.c $L/queue/nrf_queue.c \
+ *      $L/atomic/nrf_atomic.c $L/bench_host/bench.c -o nrf_serial_bench
+ *
+ * Usage: nrf_serial_bench [kilobytes]
+ *
+ * The driver is replaced by a simulation of UARTE at 1 Mbaud, with EasyDMA, a 4-byte RX FIFO, an
+ * interrupt latency of 5 us, and interrupts blocked for 300 us every 10 ms, as by radio events.
+ * Interrupts are called from the main loop when the simulated time reaches them, the main loop
+ * being the sleep handler of the serial port.
+ *
+ * The data is sent in four ways:
+ * - queue: with nrf_serial_write, through the TX queue and the TX buffer,
+ * - stream: with nrf_serial_write_stream, four 1 kB descriptors resubmitted from their handler,
+ * - stream flash: as stream, with data in flash, sent through the TX buffer,
+ * and in RAM from the TX queue and from descriptors at the same time, each in order. Data in
+ * flash cannot be written to the queue in DMA mode.
+ *
+ * The data is received in two ways:
+ * - queue: through the RX buffer and the RX queue, read as it arrives,
+ * - stream: with nrf_serial_read_stream, two 1 kB descriptors resubmitted from their handler.
+ *
+ * For each way, the line utilization, interrupts per kilobyte, bytes sent from the TX buffer,
+ * copied there by the CPU, lost bytes and host time per byte are printed. Aborting streamed
+ * transmissions and error codes are tested as well.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sdk_common.h"
+#include "nrf_serial.h"
+#include "bench.h"
+
+
+#define BYTE_NS             10000       // 1 Mbaud, 10 bits per byte.
+#define IRQ_LATENCY_NS      5000
+#define BLOCK_PERIOD_NS     10000000    // Interrupts are blocked every 10 ms
+#define BLOCK_NS            300000      // for 300 us.
+#define RX_FIFO_SIZE        4
+#define RX_EVENTS_MAX       4
+#define DESC_SIZE           1024
+#define TX_DESCS            4
+#define RX_DESCS            2
+#define DATA_SIZE_MAX       (1024 * 1024)
+
+typedef struct
+{
+    uint8_t * p_data;
+    uint8_t   length;
+    uint8_t   count;
+} rx_buffer_t;
+
+typedef struct
+{
+    uint64_t  time;
+    uint8_t * p_data;
+    uint8_t   bytes;
+} rx_event_t;
+
+NRF_SERIAL_DRV_UART_CONFIG_DEF(m_uart_config,
+                               8, 6, 5, 7,
+                               NRF_UART_HWFC_DISABLED, NRF_UART_PARITY_EXCLUDED,
+                               NRF_UART_BAUDRATE_1000000,
+                               6);
+
+NRF_SERIAL_QUEUES_DEF(m_serial_queues, 256, 256);
+NRF_SERIAL_BUFFERS_DEF(m_serial_buffers, 32, 1);
+
+static void sim_sleep(void);
+
+NRF_SERIAL_CONFIG_DEF(m_serial_config, NRF_SERIAL_MODE_DMA,
+                      &m_serial_queues, &m_serial_buffers, NULL, sim_sleep);
+NRF_SERIAL_CONFIG_DEF(m_serial_config_polling, NRF_SERIAL_MODE_POLLING,
+                      NULL, NULL, NULL, NULL);
+
+NRF_SERIAL_UART_DEF(m_serial, 0);
+
+static uint8_t                  m_flash[64 * 1024];     // Not in RAM for the simulated EasyDMA.
+static uint8_t                  m_ram[DATA_SIZE_MAX];
+static uint8_t                  m_sink[DATA_SIZE_MAX];  // Data sent on the line.
+static uint32_t                 m_sink_length;
+static uint8_t                  m_received[DATA_SIZE_MAX];
+static uint32_t                 m_received_length;
+static uint8_t                  m_rx_buffers[RX_DESCS][DESC_SIZE];
+static nrf_serial_buf_desc_t    m_descs[TX_DESCS];
+static uint8_t const *          mp_source;              // Data streamed by the descriptors.
+static uint32_t                 m_source_size;
+static uint32_t                 m_source_next;
+static uint32_t                 m_stream_done;
+static uint32_t                 m_handler_calls;
+
+// Simulated UARTE.
+static nrf_uart_event_handler_t m_uart_handler;
+static void *                   mp_uart_context;
+static bool                     m_easy_dma;
+static uint64_t                 m_now;                  // Simulated time in nanoseconds.
+static bool                     m_tx_busy;
+static uint8_t const *          mp_tx_data;
+static uint8_t                  m_tx_length;
+static uint64_t                 m_tx_start;
+static uint64_t                 m_tx_irq;
+static rx_buffer_t              m_rx_primary;
+static rx_buffer_t              m_rx_secondary;
+static bool                     m_rx_primary_set;
+static bool                     m_rx_secondary_set;
+static uint8_t                  m_rx_fifo[RX_FIFO_SIZE];
+static uint8_t                  m_rx_fifo_count;
+static rx_event_t               m_rx_events[RX_EVENTS_MAX];
+static uint8_t                  m_rx_event_count;
+static uint32_t                 m_rx_left;              // Bytes still to arrive on the line.
+static uint32_t                 m_rx_sent;
+static uint64_t                 m_rx_next_byte;
+
+// Statistics.
+static uint64_t                 m_line_busy_ns;
+static uint32_t                 m_irqs;
+static uint32_t                 m_copied;               // Bytes sent from the TX buffer.
+static uint32_t                 m_rx_lost;
+
+
+
+static uint8_t rx_byte(uint32_t idx)
+{
+    return (uint8_t)((idx * 7) ^ (idx >> 8));
+}
+
+
+// Returns the time of an interrupt raised at the given time, after the blocked intervals.
+static uint64_t irq_time(uint64_t time)
+{
+    if (time % BLOCK_PERIOD_NS < BLOCK_NS)
+    {
+        time += BLOCK_NS - time % BLOCK_PERIOD_NS;
+    }
+    return time + IRQ_LATENCY_NS;
+}
+
+
+ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                            app_timer_mode_t            mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    bench_error_record("timer used");
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+    bench_error_record("timer used");
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    return NRF_SUCCESS;
+}
+
+
+bool nrfx_is_in_ram(void const * p_object)
+{
+    uint8_t const * p = p_object;
+    return (p < m_flash) || (p >= m_flash + sizeof(m_flash));
+}
+
+
+static void sim_reset(void)
+{
+    m_now              = 0;
+    m_tx_busy          = false;
+    m_rx_primary_set   = false;
+    m_rx_secondary_set = false;
+    m_rx_fifo_count    = 0;
+    m_rx_event_count   = 0;
+    m_rx_left          = 0;
+    m_rx_sent          = 0;
+    m_sink_length      = 0;
+    m_line_busy_ns     = 0;
+    m_irqs             = 0;
+    m_copied           = 0;
+    m_rx_lost          = 0;
+}
+
+
+ret_code_t nrf_drv_uart_init(nrf_drv_uart_t const *        p_instance,
+                             nrf_drv_uart_config_t const * p_config,
+                             nrf_uart_event_handler_t      event_handler)
+{
+    sim_reset();
+    m_uart_handler  = event_handler;
+    mp_uart_context = p_config->p_context;
+    m_easy_dma      = p_config->use_easy_dma;
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_uart_uninit(nrf_drv_uart_t const * p_instance)
+{
+    sim_reset();
+}
+
+
+ret_code_t nrf_drv_uart_tx(nrf_drv_uart_t const * p_instance,
+                           uint8_t const *        p_data,
+                           uint8_t                length)
+{
+    if (m_tx_busy)
+    {
+        bench_error_record("transmission started during another one");
+        return NRF_ERROR_BUSY;
+    }
+    if (m_easy_dma && !nrfx_is_in_ram(p_data))
+    {
+        bench_error_record("EasyDMA transmission from flash");
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (m_sink_length + length > sizeof(m_sink))
+    {
+        bench_error_record("too much data sent");
+        return NRF_ERROR_NO_MEM;
+    }
+
+    uint8_t const * p_txb = m_serial_buffers.p_txb;
+    if ((p_data >= p_txb) && (p_data < p_txb + m_serial_buffers.tx_size))
+    {
+        m_copied += length;
+    }
+
+    // The data is on the line as soon as the transmission starts, it is cut back on abort.
+    memcpy(&m_sink[m_sink_length], p_data, length);
+    m_sink_length  += length;
+    m_line_busy_ns += (uint64_t)length * BYTE_NS;
+
+    m_tx_busy   = true;
+    mp_tx_data  = p_data;
+    m_tx_length = length;
+    m_tx_start  = m_now;
+    m_tx_irq    = irq_time(m_now + (uint64_t)length * BYTE_NS);
+    return NRF_SUCCESS;
+}
+
+
+bool nrf_drv_uart_tx_in_progress(nrf_drv_uart_t const * p_instance)
+{
+    return m_tx_busy;
+}
+
+
+void nrf_drv_uart_tx_abort(nrf_drv_uart_t const * p_instance)
+{
+    if (!m_tx_busy)
+    {
+        return;
+    }
+
+    // As nrfx, no event is generated for the aborted transmission.
+    uint64_t sent = MIN((m_now - m_tx_start) / BYTE_NS, m_tx_length);
+    m_sink_length  -= m_tx_length - (uint32_t)sent;
+    m_line_busy_ns -= (m_tx_length - sent) * BYTE_NS;
+    m_tx_busy       = false;
+}
+
+
+static void rx_event_push(void)
+{
+    if (m_rx_event_count == RX_EVENTS_MAX)
+    {
+        bench_error_record("too many receptions done");
+        return;
+    }
+
+    rx_event_t * p_event = &m_rx_events[m_rx_event_count++];
+    uint64_t     time    = irq_time(m_now);
+
+    // Interrupts are handled in order.
+    if ((m_rx_event_count > 1) && (time < p_event[-1].time))
+    {
+        time = p_event[-1].time;
+    }
+    p_event->time   = time;
+    p_event->p_data = m_rx_primary.p_data;
+    p_event->bytes  = m_rx_primary.count;
+
+    // The secondary buffer follows without a gap.
+    m_rx_primary_set = m_rx_secondary_set;
+    m_rx_primary     = m_rx_secondary;
+    m_rx_secondary_set = false;
+}
+
+
+static void rx_fifo_drain(void)
+{
+    uint8_t i = 0;
+    while (m_rx_primary_set && (i < m_rx_fifo_count))
+    {
+        m_rx_primary.p_data[m_rx_primary.count++] = m_rx_fifo[i++];
+        if (m_rx_primary.count == m_rx_primary.length)
+        {
+            rx_event_push();
+        }
+    }
+    memmove(m_rx_fifo, &m_rx_fifo[i], m_rx_fifo_count - i);
+    m_rx_fifo_count -= i;
+}
+
+
+ret_code_t nrf_drv_uart_rx(nrf_drv_uart_t const * p_instance,
+                           uint8_t *              p_data,
+                           uint8_t                length)
+{
+    rx_buffer_t buffer =
+    {
+        .p_data = p_data,
+        .length = length,
+    };
+
+    if (!m_rx_primary_set)
+    {
+        m_rx_primary     = buffer;
+        m_rx_primary_set = true;
+        rx_fifo_drain();
+    }
+    else if (!m_rx_secondary_set)
+    {
+        m_rx_secondary     = buffer;
+        m_rx_secondary_set = true;
+    }
+    else
+    {
+        bench_error_record("reception started with two set");
+        return NRF_ERROR_BUSY;
+    }
+    return NRF_SUCCESS;
+}
+
+
+bool nrf_drv_uart_rx_ready(nrf_drv_uart_t const * p_instance)
+{
+    return false;
+}
+
+
+void nrf_drv_uart_rx_enable(nrf_drv_uart_t const * p_instance)
+{
+}
+
+
+void nrf_drv_uart_rx_disable(nrf_drv_uart_t const * p_instance)
+{
+}
+
+
+void nrf_drv_uart_rx_abort(nrf_drv_uart_t const * p_instance)
+{
+    m_rx_secondary_set = false;
+    if (m_rx_primary_set)
+    {
+        rx_event_push();
+    }
+}
+
+
+static void rx_byte_arrive(void)
+{
+    uint8_t byte = rx_byte(m_rx_sent++);
+
+    m_rx_left--;
+    m_rx_next_byte += BYTE_NS;
+
+    if (m_rx_primary_set)
+    {
+        m_rx_primary.p_data[m_rx_primary.count++] = byte;
+        if (m_rx_primary.count == m_rx_primary.length)
+        {
+            rx_event_push();
+        }
+    }
+    else if (m_rx_fifo_count < RX_FIFO_SIZE)
+    {
+        m_rx_fifo[m_rx_fifo_count++] = byte;
+    }
+    else
+    {
+        m_rx_lost++;
+    }
+}
+
+
+// Advances the simulation to its next event. Returns false if there is none.
+static bool sim_step(void)
+{
+    uint64_t next = UINT64_MAX;
+
+    if (m_rx_left != 0)
+    {
+        next = m_rx_next_byte;
+    }
+    if ((m_rx_event_count != 0) && (m_rx_events[0].time < next))
+    {
+        next = m_rx_events[0].time;
+    }
+    if (m_tx_busy && (m_tx_irq < next))
+    {
+        next = m_tx_irq;
+    }
+    if (next == UINT64_MAX)
+    {
+        return false;
+    }
+
+    m_now = next;
+    if ((m_rx_left != 0) && (m_rx_next_byte == next))
+    {
+        rx_byte_arrive();
+    }
+    else if ((m_rx_event_count != 0) && (m_rx_events[0].time == next))
+    {
+        nrf_drv_uart_event_t event =
+        {
+            .type = NRF_DRV_UART_EVT_RX_DONE,
+            .data.rxtx =
+            {
+                .p_data = m_rx_events[0].p_data,
+                .bytes  = m_rx_events[0].bytes,
+            },
+        };
+
+        memmove(m_rx_events, &m_rx_events[1], --m_rx_event_count * sizeof(m_rx_events[0]));
+        m_irqs++;
+        m_uart_handler(&event, mp_uart_context);
+    }
+    else
+    {
+        nrf_drv_uart_event_t event =
+        {
+            .type = NRF_DRV_UART_EVT_TX_DONE,
+            .data.rxtx =
+            {
+                .p_data = (uint8_t *)mp_tx_data,
+                .bytes  = m_tx_length,
+            },
+        };
+
+        m_tx_busy = false;
+        m_irqs++;
+        m_uart_handler(&event, mp_uart_context);
+    }
+    return true;
+}
+
+
+static void sim_sleep(void)
+{
+    if (!sim_step())
+    {
+        bench_error_record("sleeping with nothing to wait for");
+    }
+}
+
+
+static void serial_open(void)
+{
+    APP_ERROR_CHECK(nrf_serial_init(&m_serial, &m_uart_config, &m_serial_config));
+}
+
+
+static void serial_close(void)
+{
+    APP_ERROR_CHECK(nrf_serial_uninit(&m_serial));
+}
+
+
+static void tx_stream_handler(nrf_serial_t const * p_serial, nrf_serial_buf_desc_t * p_desc)
+{
+    CHECK(p_serial == &m_serial);
+    CHECK(p_desc->done == p_desc->size);
+
+    m_handler_calls++;
+    m_stream_done += p_desc->done;
+    if (m_source_next < m_source_size)
+    {
+        p_desc->p_data  = (uint8_t *)&mp_source[m_source_next];
+        p_desc->size    = MIN(DESC_SIZE, m_source_size - m_source_next);
+        m_source_next  += p_desc->size;
+        CHECK(nrf_serial_write_stream(p_serial, p_desc) == NRF_SUCCESS);
+    }
+}
+
+
+static void stream_start(uint8_t const * p_source, uint32_t size, nrf_serial_buf_handler_t handler)
+{
+    mp_source      = p_source;
+    m_source_size  = size;
+    m_source_next  = 0;
+    m_stream_done  = 0;
+    m_handler_calls = 0;
+
+    for (uint32_t i = 0; (i < TX_DESCS) && (m_source_next < m_source_size); i++)
+    {
+        m_descs[i].p_data  = (uint8_t *)&mp_source[m_source_next];
+        m_descs[i].size    = MIN(DESC_SIZE, m_source_size - m_source_next);
+        m_descs[i].handler = handler;
+        m_source_next     += m_descs[i].size;
+        CHECK(nrf_serial_write_stream(&m_serial, &m_descs[i]) == NRF_SUCCESS);
+    }
+}
+
+
+static void report(char const * p_name, uint32_t size, uint64_t host_ns)
+{
+    printf("%-13s %5.1f%% line  %6.1f irq/kB  %7u copied  %5u lost  %6.1f ns/B\n",
+           p_name,
+           100.0 * m_line_busy_ns / (m_now ? m_now : 1),
+           1024.0 * m_irqs / size,
+           m_copied,
+           m_rx_lost,
+           (double)host_ns / size);
+}
+
+
+static void tx_run(char const * p_name, uint8_t const * p_data, uint32_t size, bool stream)
+{
+    serial_open();
+    uint64_t start = bench_now_ns();
+
+    if (stream)
+    {
+        stream_start(p_data, size, tx_stream_handler);
+        while (m_stream_done < size)
+        {
+            sim_sleep();
+        }
+        CHECK(m_handler_calls == (size + DESC_SIZE - 1) / DESC_SIZE);
+    }
+    else
+    {
+        size_t written;
+        CHECK(nrf_serial_write(&m_serial, p_data, size, &written, NRF_SERIAL_MAX_TIMEOUT)
+              == NRF_SUCCESS);
+        CHECK(written == size);
+    }
+    CHECK(nrf_serial_flush(&m_serial, NRF_SERIAL_MAX_TIMEOUT) == NRF_SUCCESS);
+
+    uint64_t host_ns = bench_now_ns() - start;
+
+    CHECK(m_sink_length == size);
+    CHECK(memcmp(m_sink, p_data, size) == 0);
+    report(p_name, size, host_ns);
+    serial_close();
+}
+
+
+// Queued data is below 0x80 and streamed data above, each must be sent in order.
+static void test_tx_mixed(uint32_t size)
+{
+    uint32_t queued = 0;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        m_ram[i] = (uint8_t)(0x80 | (i % 0x7F));
+    }
+
+    serial_open();
+    stream_start(m_ram, size, tx_stream_handler);
+    while ((queued < size) || (m_stream_done < size))
+    {
+        if (queued < size)
+        {
+            uint8_t data[64];
+            uint32_t len = MIN(sizeof(data), size - queued);
+            size_t   written;
+
+            for (uint32_t i = 0; i < len; i++)
+            {
+                data[i] = (uint8_t)((queued + i) % 0x7F);
+            }
+            ret_code_t ret = nrf_serial_write(&m_serial, data, len, &written, 0);
+            CHECK((ret == NRF_SUCCESS) || (ret == NRF_ERROR_TIMEOUT));
+            queued += written;
+        }
+        if (!sim_step())
+        {
+            bench_error_record("mixed transmission stalled");
+            break;
+        }
+    }
+    CHECK(nrf_serial_flush(&m_serial, NRF_SERIAL_MAX_TIMEOUT) == NRF_SUCCESS);
+
+    uint32_t queue_idx  = 0;
+    uint32_t stream_idx = 0;
+    bool     ordered    = true;
+    for (uint32_t i = 0; i < m_sink_length; i++)
+    {
+        if (m_sink[i] & 0x80)
+        {
+            ordered &= (m_sink[i] == (uint8_t)(0x80 | (stream_idx++ % 0x7F)));
+        }
+        else
+        {
+            ordered &= (m_sink[i] == (uint8_t)(queue_idx++ % 0x7F));
+        }
+    }
+    CHECK(ordered);
+    CHECK(queue_idx == size);
+    CHECK(stream_idx == size);
+    serial_close();
+}
+
+
+static void abort_handler(nrf_serial_t const * p_serial, nrf_serial_buf_desc_t * p_desc)
+{
+    m_handler_calls++;
+    m_stream_done += p_desc->done;
+}
+
+
+static void test_tx_abort(void)
+{
+    serial_open();
+    stream_start(m_ram, TX_DESCS * DESC_SIZE, abort_handler);
+
+    // Abort in the middle of the second descriptor.
+    while (m_handler_calls == 0)
+    {
+        sim_sleep();
+    }
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        sim_sleep();
+    }
+    CHECK(nrf_serial_tx_abort(&m_serial) == NRF_SUCCESS);
+    CHECK(m_handler_calls == TX_DESCS);
+    CHECK(!nrf_drv_uart_tx_in_progress(&m_serial.instance));
+    CHECK(nrf_serial_flush(&m_serial, 0) == NRF_SUCCESS);
+    CHECK(m_sink_length >= m_stream_done);
+    CHECK(memcmp(m_sink, m_ram, m_sink_length) == 0);
+
+    // Transmissions go on after the abort.
+    m_sink_length = 0;
+    stream_start(m_ram, DESC_SIZE, tx_stream_handler);
+    CHECK(nrf_serial_flush(&m_serial, NRF_SERIAL_MAX_TIMEOUT) == NRF_SUCCESS);
+    CHECK((m_sink_length == DESC_SIZE) && (m_handler_calls == 1));
+    serial_close();
+}
+
+
+static void test_errors(void)
+{
+    nrf_serial_buf_desc_t desc =
+    {
+        .p_data = m_ram,
+    };
+
+    CHECK(nrf_serial_write_stream(&m_serial, &desc) == NRF_ERROR_MODULE_NOT_INITIALIZED);
+    CHECK(nrf_serial_read_stream(&m_serial, &desc) == NRF_ERROR_MODULE_NOT_INITIALIZED);
+
+    serial_open();
+    CHECK(nrf_serial_write_stream(&m_serial, &desc) == NRF_ERROR_INVALID_LENGTH);
+    CHECK(nrf_serial_read_stream(&m_serial, &desc) == NRF_ERROR_INVALID_LENGTH);
+    desc.p_data = m_flash;
+    desc.size   = 16;
+    CHECK(nrf_serial_read_stream(&m_serial, &desc) == NRF_ERROR_INVALID_ADDR);
+    CHECK(nrf_serial_write(&m_serial, m_flash, 16, NULL, 0) == NRF_ERROR_INVALID_ADDR);
+    serial_close();
+
+    APP_ERROR_CHECK(nrf_serial_init(&m_serial, &m_uart_config, &m_serial_config_polling));
+    CHECK(nrf_serial_write_stream(&m_serial, &desc) == NRF_ERROR_NOT_SUPPORTED);
+    CHECK(nrf_serial_read_stream(&m_serial, &desc) == NRF_ERROR_NOT_SUPPORTED);
+    serial_close();
+}
+
+
+static void rx_stream_handler(nrf_serial_t const * p_serial, nrf_serial_buf_desc_t * p_desc)
+{
+    CHECK(p_desc->done == p_desc->size);
+    CHECK(m_received_length + p_desc->done <= sizeof(m_received));
+
+    memcpy(&m_received[m_received_length], p_desc->p_data, p_desc->done);
+    m_received_length += p_desc->done;
+    m_handler_calls++;
+    if (m_source_next < m_source_size)
+    {
+        p_desc->size   = MIN(DESC_SIZE, m_source_size - m_source_next);
+        m_source_next += p_desc->size;
+        CHECK(nrf_serial_read_stream(p_serial, p_desc) == NRF_SUCCESS);
+    }
+}
+
+
+// Reads the RX queue as it fills, without blocking.
+static void rx_queue_read(void)
+{
+    size_t available = nrf_queue_utilization_get(m_serial_queues.p_rxq);
+    size_t read;
+
+    if (available != 0)
+    {
+        CHECK(m_received_length + available <= sizeof(m_received));
+        CHECK(nrf_serial_read(&m_serial, &m_received[m_received_length], available, &read, 0)
+              == NRF_SUCCESS);
+        m_received_length += read;
+    }
+}
+
+
+static void rx_run(char const * p_name, uint32_t size, bool stream)
+{
+    serial_open();
+    m_received_length = 0;
+
+    uint32_t streamed = 0;
+    if (stream)
+    {
+        // The reception in progress, of the RX buffer, gets the first byte.
+        streamed        = size - m_serial_buffers.rx_size;
+        m_source_size   = streamed;
+        m_source_next   = 0;
+        m_handler_calls = 0;
+        for (uint32_t i = 0; (i < RX_DESCS) && (m_source_next < m_source_size); i++)
+        {
+            m_descs[i].p_data  = m_rx_buffers[i];
+            m_descs[i].size    = MIN(DESC_SIZE, m_source_size - m_source_next);
+            m_descs[i].handler = rx_stream_handler;
+            m_source_next     += m_descs[i].size;
+            CHECK(nrf_serial_read_stream(&m_serial, &m_descs[i]) == NRF_SUCCESS);
+        }
+    }
+
+    uint64_t start = bench_now_ns();
+
+    m_rx_left      = size;
+    m_rx_next_byte = BYTE_NS;
+    while (sim_step())
+    {
+        if (!stream)
+        {
+            rx_queue_read();
+        }
+    }
+
+    uint64_t host_ns = bench_now_ns() - start;
+
+    if (stream)
+    {
+        // The byte of the RX buffer comes from the queue, before the streamed ones.
+        uint8_t first;
+        CHECK(nrf_serial_read(&m_serial, &first, 1, NULL, 0) == NRF_SUCCESS);
+        memmove(&m_received[1], m_received, m_received_length);
+        m_received[0] = first;
+        m_received_length++;
+        CHECK(m_handler_calls == (streamed + DESC_SIZE - 1) / DESC_SIZE);
+    }
+
+    m_line_busy_ns = (uint64_t)size * BYTE_NS;
+    report(p_name, size, host_ns);
+
+    CHECK(m_received_length + m_rx_lost == size);
+    if (stream)
+    {
+        CHECK(m_rx_lost == 0);
+        bool equal = true;
+        for (uint32_t i = 0; i < m_received_length; i++)
+        {
+            equal &= (m_received[i] == rx_byte(i));
+        }
+        CHECK(equal);
+    }
+    serial_close();
+}
+
+
+int main(int argc, char ** argv)
+{
+    uint32_t const kilobytes = (argc > 1) ? strtoul(argv[1], NULL, 0) : 256;
+    uint32_t const size      = MIN(kilobytes * 1024, DATA_SIZE_MAX);
+    uint32_t const flash_size = MIN(size, sizeof(m_flash));
+
+    for (uint32_t i = 0; i < sizeof(m_ram); i++)
+    {
+        m_ram[i] = (uint8_t)bench_random();
+    }
+    for (uint32_t i = 0; i < sizeof(m_flash); i++)
+    {
+        m_flash[i] = (uint8_t)bench_random();
+    }
+
+    test_errors();
+    test_tx_abort();
+    test_tx_mixed(size / 4);
+
+    printf("TX, %u bytes (flash %u)\n", size, flash_size);
+    tx_run("queue", m_ram, size, false);
+    tx_run("stream", m_ram, size, true);
+    tx_run("stream flash", m_flash, flash_size, true);
+
+    printf("RX, %u bytes\n", size);
+    rx_run("queue", size, false);
+    rx_run("stream", size, true);
+
+    if (bench_failed())
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
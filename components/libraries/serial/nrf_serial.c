@@ -40,6 +40,7 @@
 #include "sdk_common.h"
 #if NRF_MODULE_ENABLED(NRF_SERIAL)
 #include "nrf_serial.h"
+#include "app_util_platform.h"
 
 #if defined (UART_PRESENT)
 
@@ -92,6 +93,23 @@ static size_t serial_rx(nrf_serial_t const * p_serial,
     return nrf_queue_out(p_rxq, p_buff, length);
 }
 
+/* Returns false if the TX queue is empty. */
+static bool tx_queue_start(nrf_serial_t const * p_serial)
+{
+    nrf_queue_t const * p_txq = p_serial->p_ctx->p_config->p_queues->p_txq;
+    nrf_serial_buffers_t const * p_buffs = p_serial->p_ctx->p_config->p_buffers;
+
+    size_t len = nrf_queue_out(p_txq, p_buffs->p_txb, p_buffs->tx_size);
+    if (len == 0)
+    {
+        return false;
+    }
+
+    ret_code_t ret = nrf_drv_uart_tx(&p_serial->instance, p_buffs->p_txb, len);
+    ASSERT(ret == NRF_SUCCESS);
+    return true;
+}
+
 static size_t serial_tx(nrf_serial_t const * p_serial,
                         uint8_t const * p_buff,
                         size_t length)
@@ -107,75 +125,244 @@ static size_t serial_tx(nrf_serial_t const * p_serial,
     }
 
     nrf_queue_t const * p_txq = p_serial->p_ctx->p_config->p_queues->p_txq;
-    nrf_serial_buffers_t const * p_buffs = p_serial->p_ctx->p_config->p_buffers;
 
     /* Try to enqueue data. */
     size_t queue_in_len = nrf_queue_in(p_txq, p_buff, length);
-    if (nrf_drv_uart_tx_in_progress(&p_serial->instance))
+
+    /* Streamed data may be submitted from an interrupt. */
+    CRITICAL_REGION_ENTER();
+    if (!nrf_drv_uart_tx_in_progress(&p_serial->instance))
     {
-        return queue_in_len;
+        (void)tx_queue_start(p_serial);
     }
+    CRITICAL_REGION_EXIT();
 
-    size_t len = nrf_queue_out(p_txq, p_buffs->p_txb, p_buffs->tx_size);
-    ASSERT(len > 0);
-    ret_code_t ret = nrf_drv_uart_tx(&p_serial->instance, p_buffs->p_txb, len);
+    return queue_in_len;
+}
+
+static void tx_stream_start(nrf_serial_t const * p_serial)
+{
+    nrf_serial_ctx_t * p_ctx = p_serial->p_ctx;
+    nrf_serial_buf_desc_t * p_desc = p_ctx->p_tx_head;
+    uint8_t const * p_chunk = &p_desc->p_data[p_desc->done];
+    size_t len = MIN(p_desc->size - p_desc->done, UINT8_MAX);
+
+    if ((p_ctx->p_config->mode == NRF_SERIAL_MODE_DMA) && !nrfx_is_in_ram(p_chunk))
+    {
+        /* EasyDMA cannot read the data, it is sent from the TX buffer. */
+        nrf_serial_buffers_t const * p_buffs = p_ctx->p_config->p_buffers;
+
+        len = MIN(len, p_buffs->tx_size);
+        memcpy(p_buffs->p_txb, p_chunk, len);
+        p_chunk = p_buffs->p_txb;
+    }
+
+    p_ctx->tx_chunk = (uint8_t)len;
+    ret_code_t ret = nrf_drv_uart_tx(&p_serial->instance, p_chunk, (uint8_t)len);
     ASSERT(ret == NRF_SUCCESS);
+}
 
-    return queue_in_len;
+/* Returns the streamed transmission completed by the chunk sent, if any. */
+static nrf_serial_buf_desc_t * tx_stream_chunk_done(nrf_serial_t const * p_serial)
+{
+    nrf_serial_ctx_t * p_ctx = p_serial->p_ctx;
+    nrf_serial_buf_desc_t * p_desc = p_ctx->p_tx_head;
+
+    p_desc->done += p_ctx->tx_chunk;
+    p_ctx->tx_chunk = 0;
+    if (p_desc->done < p_desc->size)
+    {
+        return NULL;
+    }
+
+    p_ctx->p_tx_head = p_desc->p_next;
+    if (p_ctx->p_tx_head == NULL)
+    {
+        p_ctx->p_tx_tail = NULL;
+    }
+    return p_desc;
+}
+
+/* Hands receptions to the driver, up to two, so that the second one follows the first one
+ * without a gap. The RX buffer is used only when there is no streamed reception to hand, and
+ * only as the first one, as before streaming. */
+static void rx_chunks_start(nrf_serial_t const * p_serial)
+{
+    nrf_serial_ctx_t * p_ctx = p_serial->p_ctx;
+    nrf_serial_buffers_t const * p_buffs = p_ctx->p_config->p_buffers;
+
+    while (p_ctx->rx_chunk_count < ARRAY_SIZE(p_ctx->rx_chunks))
+    {
+        nrf_serial_rx_chunk_t * p_chunk = &p_ctx->rx_chunks[p_ctx->rx_chunk_count];
+        nrf_serial_buf_desc_t * p_desc = p_ctx->p_rx_next;
+        uint8_t * p_data;
+
+        if (p_desc != NULL)
+        {
+            /* Chunks of equal length, so that the last one is not too short to hand the next
+             * one before it is full. */
+            size_t left = p_desc->size - p_desc->offset;
+            size_t chunks = CEIL_DIV(left, UINT8_MAX);
+
+            p_chunk->p_desc = p_desc;
+            p_chunk->length = (uint8_t)CEIL_DIV(left, chunks);
+            p_data = &p_desc->p_data[p_desc->offset];
+            p_desc->offset += p_chunk->length;
+            if (p_desc->offset == p_desc->size)
+            {
+                p_ctx->p_rx_next = p_desc->p_next;
+            }
+        }
+        else if (p_ctx->rx_chunk_count == 0)
+        {
+            p_chunk->p_desc = NULL;
+            p_chunk->length = p_buffs->rx_size;
+            p_data = p_buffs->p_rxb;
+        }
+        else
+        {
+            break;
+        }
+
+        p_ctx->rx_chunk_count++;
+        ret_code_t ret = nrf_drv_uart_rx(&p_serial->instance, p_data, p_chunk->length);
+        ASSERT(ret == NRF_SUCCESS);
+    }
+}
+
+/* The driver dropped the receptions handed to it, the rest of the streamed receptions is
+ * handed again. */
+static void rx_stream_rewind(nrf_serial_t const * p_serial)
+{
+    nrf_serial_ctx_t * p_ctx = p_serial->p_ctx;
+
+    for (nrf_serial_buf_desc_t * p_desc = p_ctx->p_rx_head;
+         (p_desc != NULL) && (p_desc->offset != p_desc->done);
+         p_desc = p_desc->p_next)
+    {
+        p_desc->offset = p_desc->done;
+    }
+    p_ctx->p_rx_next = p_ctx->p_rx_head;
+    p_ctx->rx_chunk_count = 0;
+}
+
+/* Returns the streamed reception completed by the chunk received, if any. */
+static nrf_serial_buf_desc_t * rx_stream_chunk_done(nrf_serial_t const * p_serial,
+                                                    nrf_serial_buf_desc_t * p_desc,
+                                                    size_t bytes)
+{
+    nrf_serial_ctx_t * p_ctx = p_serial->p_ctx;
+
+    p_desc->done += bytes;
+    if (p_desc->done < p_desc->size)
+    {
+        return NULL;
+    }
+
+    ASSERT(p_desc == p_ctx->p_rx_head);
+    p_ctx->p_rx_head = p_desc->p_next;
+    if (p_ctx->p_rx_head == NULL)
+    {
+        p_ctx->p_rx_tail = NULL;
+    }
+    return p_desc;
 }
 
 static void uart_event_handler(nrf_drv_uart_event_t * p_event, void * p_context)
 {
-    uint32_t ret;
     nrf_serial_t const * p_serial = p_context;
 
     switch (p_event->type)
     {
         case NRF_DRV_UART_EVT_RX_DONE:
         {
-            nrf_queue_t const * p_rxq =
-                    p_serial->p_ctx->p_config->p_queues->p_rxq;
-            size_t len = nrf_queue_in(p_rxq,
-                                      p_event->data.rxtx.p_data,
-                                      p_event->data.rxtx.bytes);
+            nrf_serial_ctx_t * p_ctx = p_serial->p_ctx;
+            nrf_serial_rx_chunk_t chunk = p_ctx->rx_chunks[0];
+            nrf_serial_buf_desc_t * p_done = NULL;
+
+            ASSERT(p_ctx->rx_chunk_count > 0);
+            p_ctx->rx_chunks[0] = p_ctx->rx_chunks[1];
+            p_ctx->rx_chunk_count--;
 
-            if (len < p_event->data.rxtx.bytes)
+            if (chunk.p_desc != NULL)
             {
-                event_handler(p_serial, NRF_SERIAL_EVENT_FIFO_ERR);
-                break;
+                p_done = rx_stream_chunk_done(p_serial,
+                                              chunk.p_desc,
+                                              p_event->data.rxtx.bytes);
+            }
+            if (p_event->data.rxtx.bytes < chunk.length)
+            {
+                /* Reception aborted. */
+                rx_stream_rewind(p_serial);
             }
 
-            event_handler(p_serial, NRF_SERIAL_EVENT_RX_DATA);
-            nrf_serial_buffers_t const * p_buffs =
-                    p_serial->p_ctx->p_config->p_buffers;
+            if (chunk.p_desc == NULL)
+            {
+                nrf_queue_t const * p_rxq =
+                        p_serial->p_ctx->p_config->p_queues->p_rxq;
+                size_t len = nrf_queue_in(p_rxq,
+                                          p_event->data.rxtx.p_data,
+                                          p_event->data.rxtx.bytes);
+
+                if (len < p_event->data.rxtx.bytes)
+                {
+                    event_handler(p_serial, NRF_SERIAL_EVENT_FIFO_ERR);
+                    break;
+                }
+
+                event_handler(p_serial, NRF_SERIAL_EVENT_RX_DATA);
+            }
 
-            ret = nrf_drv_uart_rx(&p_serial->instance,
-                                  p_buffs->p_rxb,
-                                  p_buffs->rx_size);
-            ASSERT(ret == NRF_SUCCESS);
+            rx_chunks_start(p_serial);
+            if ((p_done != NULL) && (p_done->handler != NULL))
+            {
+                p_done->handler(p_serial, p_done);
+            }
             break;
         }
         case NRF_DRV_UART_EVT_ERROR:
         {
+            /* The driver drops the receptions on errors. */
+            rx_stream_rewind(p_serial);
             event_handler(p_serial, NRF_SERIAL_EVENT_DRV_ERR);
+            if (p_serial->p_ctx->p_rx_head != NULL)
+            {
+                rx_chunks_start(p_serial);
+            }
             break;
         }
         case NRF_DRV_UART_EVT_TX_DONE:
         {
-            nrf_queue_t const * p_txq =
-                    p_serial->p_ctx->p_config->p_queues->p_txq;
-            nrf_serial_buffers_t const * p_buffs =
-                    p_serial->p_ctx->p_config->p_buffers;
-
-            event_handler(p_serial, NRF_SERIAL_EVENT_TX_DONE);
-            size_t len = nrf_queue_out(p_txq, p_buffs->p_txb, p_buffs->tx_size);
-            if (len == 0)
+            nrf_serial_ctx_t * p_ctx = p_serial->p_ctx;
+            nrf_serial_buf_desc_t * p_done = NULL;
+
+            if (p_ctx->tx_chunk != 0)
             {
-                break;
+                /* Streamed chunk sent, queued data goes next if there is any. */
+                p_done = tx_stream_chunk_done(p_serial);
+                if (!tx_queue_start(p_serial) && (p_ctx->p_tx_head != NULL))
+                {
+                    tx_stream_start(p_serial);
+                }
+            }
+            else
+            {
+                event_handler(p_serial, NRF_SERIAL_EVENT_TX_DONE);
+                if (p_ctx->p_tx_head != NULL)
+                {
+                    tx_stream_start(p_serial);
+                }
+                else
+                {
+                    (void)tx_queue_start(p_serial);
+                }
             }
 
-            ret = nrf_drv_uart_tx(&p_serial->instance, p_buffs->p_txb, len);
-            ASSERT(ret == NRF_SUCCESS);
+            /* Called last, so that it can submit the next transmission. */
+            if ((p_done != NULL) && (p_done->handler != NULL))
+            {
+                p_done->handler(p_serial, p_done);
+            }
             break;
         }
         default:
@@ -250,6 +437,10 @@ ret_code_t nrf_serial_init(nrf_serial_t const * p_serial,
         }
     }
 
+    p_serial->p_ctx->rx_chunks[0].p_desc = NULL;
+    p_serial->p_ctx->rx_chunks[0].length = p_serial->p_ctx->p_config->p_buffers->rx_size;
+    p_serial->p_ctx->rx_chunk_count = 1;
+
     return nrf_drv_uart_rx(&p_serial->instance,
                            p_serial->p_ctx->p_config->p_buffers->p_rxb,
                            p_serial->p_ctx->p_config->p_buffers->rx_size);
@@ -498,6 +689,113 @@ ret_code_t nrf_serial_read(nrf_serial_t const * p_serial,
     return NRF_SUCCESS;
 }
 
+ret_code_t nrf_serial_write_stream(nrf_serial_t const * p_serial,
+                                   nrf_serial_buf_desc_t * p_desc)
+{
+    ASSERT(p_serial && p_desc);
+    nrf_serial_ctx_t * p_ctx = p_serial->p_ctx;
+
+    if (!p_ctx->p_config)
+    {
+        return NRF_ERROR_MODULE_NOT_INITIALIZED;
+    }
+
+    if (!(p_ctx->flags & NRF_SERIAL_TX_ENABLED_FLAG))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_ctx->p_config->mode == NRF_SERIAL_MODE_POLLING)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    if (p_desc->size == 0)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_desc->done = 0;
+    p_desc->offset = 0;
+    p_desc->p_next = NULL;
+
+    CRITICAL_REGION_ENTER();
+    if (p_ctx->p_tx_tail)
+    {
+        p_ctx->p_tx_tail->p_next = p_desc;
+    }
+    else
+    {
+        p_ctx->p_tx_head = p_desc;
+    }
+    p_ctx->p_tx_tail = p_desc;
+
+    if (!nrf_drv_uart_tx_in_progress(&p_serial->instance))
+    {
+        tx_stream_start(p_serial);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_serial_read_stream(nrf_serial_t const * p_serial,
+                                  nrf_serial_buf_desc_t * p_desc)
+{
+    ASSERT(p_serial && p_desc);
+    nrf_serial_ctx_t * p_ctx = p_serial->p_ctx;
+
+    if (!p_ctx->p_config)
+    {
+        return NRF_ERROR_MODULE_NOT_INITIALIZED;
+    }
+
+    if (!(p_ctx->flags & NRF_SERIAL_RX_ENABLED_FLAG))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_ctx->p_config->mode == NRF_SERIAL_MODE_POLLING)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    if (p_desc->size == 0)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    if (!nrfx_is_in_ram(p_desc->p_data) &&
+         p_ctx->p_config->mode == NRF_SERIAL_MODE_DMA)
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    p_desc->done = 0;
+    p_desc->offset = 0;
+    p_desc->p_next = NULL;
+
+    CRITICAL_REGION_ENTER();
+    if (p_ctx->p_rx_tail)
+    {
+        p_ctx->p_rx_tail->p_next = p_desc;
+    }
+    else
+    {
+        p_ctx->p_rx_head = p_desc;
+    }
+    p_ctx->p_rx_tail = p_desc;
+
+    if (p_ctx->p_rx_next == NULL)
+    {
+        p_ctx->p_rx_next = p_desc;
+    }
+    rx_chunks_start(p_serial);
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
 ret_code_t nrf_serial_flush(nrf_serial_t const * p_serial, uint32_t timeout_ms)
 {
 
@@ -545,7 +843,8 @@ ret_code_t nrf_serial_flush(nrf_serial_t const * p_serial, uint32_t timeout_ms)
     do
     {
         empty = nrf_queue_is_empty(p_serial->p_ctx->p_config->p_queues->p_txq)
-                && !nrf_drv_uart_tx_in_progress(&p_serial->instance);
+                && !nrf_drv_uart_tx_in_progress(&p_serial->instance)
+                && (p_serial->p_ctx->p_tx_head == NULL);
         if (empty)
         {
             break;
@@ -586,13 +885,33 @@ ret_code_t nrf_serial_tx_abort(nrf_serial_t const * p_serial)
         return NRF_ERROR_BUSY;
     }
 
+    nrf_serial_buf_desc_t * p_dropped;
+
+    CRITICAL_REGION_ENTER();
+    p_dropped = p_serial->p_ctx->p_tx_head;
+    p_serial->p_ctx->p_tx_head = NULL;
+    p_serial->p_ctx->p_tx_tail = NULL;
+    /* The driver does not report aborted transmissions. */
+    p_serial->p_ctx->tx_chunk = 0;
     nrf_drv_uart_tx_abort(&p_serial->instance);
+    CRITICAL_REGION_EXIT();
+
     if (p_serial->p_ctx->p_config->p_queues->p_txq)
     {
         nrf_queue_reset(p_serial->p_ctx->p_config->p_queues->p_txq);
     }
 
     nrf_mtx_unlock(&p_serial->p_ctx->write_lock);
+
+    while (p_dropped != NULL)
+    {
+        nrf_serial_buf_desc_t * p_next = p_dropped->p_next;
+        if (p_dropped->handler)
+        {
+            p_dropped->handler(p_serial, p_dropped);
+        }
+        p_dropped = p_next;
+    }
     return NRF_SUCCESS;
 }
 
@@ -657,6 +976,16 @@ ret_code_t nrf_serial_read(nrf_serial_t const * p_serial,
 {
     return NRF_ERROR_NOT_SUPPORTED;
 }
+ret_code_t nrf_serial_write_stream(nrf_serial_t const * p_serial,
+                                   nrf_serial_buf_desc_t * p_desc)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+ret_code_t nrf_serial_read_stream(nrf_serial_t const * p_serial,
+                                  nrf_serial_buf_desc_t * p_desc)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
 ret_code_t nrf_serial_flush(nrf_serial_t const * p_serial, uint32_t timeout_ms)
 {
     return NRF_ERROR_NOT_SUPPORTED;
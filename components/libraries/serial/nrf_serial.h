@@ -231,6 +231,39 @@ typedef struct {
         .sleep_handler = _sleep,                                                     \
     }
 
+/**
+ * @brief Buffer descriptor of a streamed transfer.
+ *
+ * @note The descriptor belongs to the module from its submission with
+ *       @ref nrf_serial_write_stream or @ref nrf_serial_read_stream until its handler is called.
+ * */
+typedef struct nrf_serial_buf_desc_s nrf_serial_buf_desc_t;
+
+/**
+ * @brief Streamed transfer completion handler type.
+ * */
+typedef void (*nrf_serial_buf_handler_t)(struct nrf_serial_s const * p_serial,
+                                         nrf_serial_buf_desc_t * p_desc);
+
+struct nrf_serial_buf_desc_s {
+    uint8_t * p_data;                   //!< Data to send (RAM or flash) or buffer to receive into (RAM).
+    size_t size;                        //!< Size of the data or buffer.
+    size_t done;                        //!< Number of bytes transferred. Set by the module.
+    nrf_serial_buf_handler_t handler;   //!< Completion handler, called from the UART interrupt. Can be NULL.
+    void * p_context;                   //!< User context.
+
+    nrf_serial_buf_desc_t * p_next;     //!< Next descriptor of the list. Used internally.
+    size_t offset;                      //!< Bytes handed to the driver. Used internally.
+};
+
+/**
+ * @brief Reception handed to the driver.
+ * */
+typedef struct {
+    nrf_serial_buf_desc_t * p_desc; //!< Streamed reception, NULL for the RX buffer.
+    uint8_t length;                 //!< Length of the reception.
+} nrf_serial_rx_chunk_t;
+
 #define NRF_SERIAL_RX_ENABLED_FLAG (1u << 0)    //!< Receiver enable flag.
 #define NRF_SERIAL_TX_ENABLED_FLAG (1u << 1)    //!< Transmitter enable flag.
 
@@ -245,6 +278,16 @@ typedef struct {
     nrf_mtx_t read_lock;    //!< Read operation lock.
 
     uint8_t flags;         //!< Transmitter/receiver enable flags.
+
+    nrf_serial_buf_desc_t * p_tx_head;  //!< Streamed transmissions, the first one being sent.
+    nrf_serial_buf_desc_t * p_tx_tail;  //!< Last streamed transmission.
+    uint8_t tx_chunk;                   //!< Length of the streamed chunk being sent, 0 if none.
+
+    nrf_serial_buf_desc_t * p_rx_head;  //!< Streamed receptions, the first one being filled.
+    nrf_serial_buf_desc_t * p_rx_tail;  //!< Last streamed reception.
+    nrf_serial_buf_desc_t * p_rx_next;  //!< First streamed reception not handed to the driver entirely.
+    nrf_serial_rx_chunk_t rx_chunks[2]; //!< Receptions handed to the driver, the first one in progress.
+    uint8_t rx_chunk_count;             //!< Number of receptions handed to the driver.
 } nrf_serial_ctx_t;
 
 /**
@@ -358,7 +401,57 @@ ret_code_t nrf_serial_read(nrf_serial_t const * p_serial,
                            uint32_t timeout_ms);
 
 /**
- * @brief Function for flushing a serial port TX queue.
+ * @brief Function for streaming data to a serial port without copying it.
+ *
+ * The data is handed to the driver as it is, in chunks of up to 255 bytes, after the data of the
+ * descriptors submitted before. In @ref NRF_SERIAL_MODE_DMA mode, data that is not in RAM is
+ * copied chunk by chunk to the TX buffer, for EasyDMA. Streamed data and data written with
+ * @ref nrf_serial_write are sent in alternate chunks.
+ *
+ * The function returns immediately. The handler of the descriptor is called when all of its
+ * data has been sent, or when it is dropped by @ref nrf_serial_tx_abort.
+ *
+ * @param p_serial  Serial port instance.
+ * @param p_desc    Descriptor of the data. The data and the descriptor must stay valid until its
+ *                  handler is called.
+ *
+ * @retval NRF_SUCCESS                       If the descriptor was submitted.
+ * @retval NRF_ERROR_MODULE_NOT_INITIALIZED  If the serial port is not initialized.
+ * @retval NRF_ERROR_INVALID_STATE           If the transmitter is not enabled.
+ * @retval NRF_ERROR_NOT_SUPPORTED           In @ref NRF_SERIAL_MODE_POLLING mode.
+ * @retval NRF_ERROR_INVALID_LENGTH          If the descriptor has no data.
+ * */
+ret_code_t nrf_serial_write_stream(nrf_serial_t const * p_serial,
+                                   nrf_serial_buf_desc_t * p_desc);
+
+/**
+ * @brief Function for receiving data from a serial port directly into a buffer.
+ *
+ * The buffer is handed to the driver, in chunks of up to 255 bytes, after the buffers of the
+ * descriptors submitted before. From the end of the reception in progress, received data goes
+ * to the submitted buffers instead of the RX queue. The next chunk is handed to the driver before
+ * the current one is full, so that reception is continuous.
+ *
+ * The function returns immediately. The handler of the descriptor is called when its buffer
+ * is full.
+ *
+ * @param p_serial  Serial port instance.
+ * @param p_desc    Descriptor of the buffer, in RAM. The buffer and the descriptor must stay
+ *                  valid until its handler is called.
+ *
+ * @retval NRF_SUCCESS                       If the descriptor was submitted.
+ * @retval NRF_ERROR_MODULE_NOT_INITIALIZED  If the serial port is not initialized.
+ * @retval NRF_ERROR_INVALID_STATE           If the receiver is not enabled.
+ * @retval NRF_ERROR_NOT_SUPPORTED           In @ref NRF_SERIAL_MODE_POLLING mode.
+ * @retval NRF_ERROR_INVALID_LENGTH          If the descriptor has no buffer.
+ * @retval NRF_ERROR_INVALID_ADDR            If the buffer is not in RAM, in
+ *                                           @ref NRF_SERIAL_MODE_DMA mode.
+ * */
+ret_code_t nrf_serial_read_stream(nrf_serial_t const * p_serial,
+                                  nrf_serial_buf_desc_t * p_desc);
+
+/**
+ * @brief Function for flushing a serial port TX queue and streamed transmissions.
  *
  * @param p_serial   Serial port instance.
  * @param timeout_ms Operation timeout, in milliseconds. Pass 0 to operate in
@@ -370,7 +463,8 @@ ret_code_t nrf_serial_flush(nrf_serial_t const * p_serial, uint32_t timeout_ms);
 
 /**
  * @brief Function for aborting a serial port transmission.
- * Aborts the current ongoing transmission and resets TX FIFO.
+ * Aborts the current ongoing transmission and resets TX FIFO. Streamed transmissions are
+ * dropped, and their handlers are called from this function.
  *
  * @param p_serial  Serial port instance.
  *
@@ -0,0 +1,7 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of sha256 used by sha256_bench.
+// SHA256_UNROLLED is selected on the command line.
+
+#endif // SDK_CONFIG_H
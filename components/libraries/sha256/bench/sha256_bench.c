@@ -0,0 +1,276 @@
+/**
+ * Copyright (c) 2015 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Benchmark of sha256.
+ *
+ * Build it on host from this directory. The module is compiled twice, with the rolled and the
+ * unrolled transform:
+ *   L=../..; for u in 0 1; do
+ *       cc -O2 -Ihost -I$L/bench_host -I.. -I$L/util -c ../sha256.c -DSHA256_UNROLLED=$u \
+ *          -Dsha256_init=sha256_init_$u -Dsha256_update=sha256_update_$u \
+ *          -Dsha256_final=sha256_final_$u -Dsha256_transform=sha256_transform_$u -o sha256_$u.o
+ *   done
+ *   cc -O2 -Ihost -I$L/bench_host -I.. -I$L/util sha256_bench.c sha256_0.o sha256_1.o \
+ *      $L/bench_host/bench.c -o sha256_bench
+ *
+ * Usage: sha256_bench [minimum time per measurement in ms]
+ *
+ * Three implementations are compared:
+ *   - bytewise: the update that copies every byte into the context, with the rolled transform.
+ *   - blocks:   sha256_update, which hashes whole blocks from the caller's buffer, with the rolled transform.
+ *   - unrolled: sha256_update with SHA256_UNROLLED.
+ * The digests are first checked against known vectors and against each other on random data fed in
+ * random chunks. Then the cost is measured when hashing buffers in one call and when streaming them
+ * in 100-byte chunks. It is reported in cycles per byte on x86 and in nanoseconds per byte elsewhere.
+ * The exit status is non-zero if any check fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sha256.h"
+#include "bench.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+#define IMPL_COUNT      3
+#define MAX_SIZE        (1024 * 1024)
+#define STREAM_CHUNK    100
+#define CHECK_ROUNDS    2000
+#define CHECK_MAX_SIZE  1000
+
+#define DECLARE_VARIANT(n)                                                                  \
+    ret_code_t sha256_init_##n(sha256_context_t * ctx);                                     \
+    ret_code_t sha256_update_##n(sha256_context_t * ctx, const uint8_t * data, size_t len); \
+    ret_code_t sha256_final_##n(sha256_context_t * ctx, uint8_t * hash, uint8_t le);        \
+    void       sha256_transform_##n(sha256_context_t * ctx, const uint8_t * data);
+
+DECLARE_VARIANT(0)
+DECLARE_VARIANT(1)
+
+
+// The update as it was before whole blocks were hashed from the caller's buffer.
+static ret_code_t update_bytewise(sha256_context_t * ctx, const uint8_t * data, size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        ctx->data[ctx->datalen] = data[i];
+        ctx->datalen++;
+        if (ctx->datalen == 64)
+        {
+            sha256_transform_0(ctx, ctx->data);
+            ctx->bitlen += 512;
+            ctx->datalen = 0;
+        }
+    }
+    return NRF_SUCCESS;
+}
+
+
+typedef struct
+{
+    char const * p_name;
+    ret_code_t (*init)(sha256_context_t *);
+    ret_code_t (*update)(sha256_context_t *, const uint8_t *, size_t);
+    ret_code_t (*final)(sha256_context_t *, uint8_t *, uint8_t);
+} impl_t;
+
+static const impl_t m_impl[IMPL_COUNT] =
+{
+    {"bytewise", sha256_init_0, update_bytewise, sha256_final_0},
+    {"blocks",   sha256_init_0, sha256_update_0, sha256_final_0},
+    {"unrolled", sha256_init_1, sha256_update_1, sha256_final_1},
+};
+
+static uint8_t m_buf[MAX_SIZE + 64];
+static uint8_t volatile m_sink;
+
+
+static uint64_t now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+
+// Hash the data, fed in chunks of the given size (0 for a single call).
+static void hash(impl_t const * p_impl, uint8_t const * p_data, size_t size, size_t chunk, uint8_t * p_digest)
+{
+    sha256_context_t ctx;
+
+    (void)p_impl->init(&ctx);
+    if (chunk == 0)
+    {
+        (void)p_impl->update(&ctx, p_data, size);
+    }
+    else
+    {
+        for (size_t done = 0; done < size; done += chunk)
+        {
+            (void)p_impl->update(&ctx, p_data + done, (size - done < chunk) ? (size - done) : chunk);
+        }
+    }
+    (void)p_impl->final(&ctx, p_digest, 0);
+}
+
+
+static uint32_t check(void)
+{
+    static uint8_t const abc_digest[32] =
+    {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+    // The two-block vector of FIPS 180-2.
+    static char const long_msg[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    static uint8_t const long_digest[32] =
+    {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+        0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1,
+    };
+
+    uint32_t errors = 0;
+    uint8_t  digest[32];
+    uint8_t  ref[32];
+
+    for (uint32_t i = 0; i < IMPL_COUNT; i++)
+    {
+        hash(&m_impl[i], (uint8_t const *)"abc", 3, 0, digest);
+        if (memcmp(digest, abc_digest, sizeof(digest)) != 0)
+        {
+            printf("%s: wrong digest of \"abc\"\n", m_impl[i].p_name);
+            errors++;
+        }
+        hash(&m_impl[i], (uint8_t const *)long_msg, strlen(long_msg), 7, digest);
+        if (memcmp(digest, long_digest, sizeof(digest)) != 0)
+        {
+            printf("%s: wrong digest of the two-block vector\n", m_impl[i].p_name);
+            errors++;
+        }
+    }
+
+    for (uint32_t round = 0; round < CHECK_ROUNDS; round++)
+    {
+        size_t const offset = (size_t)rand() % 64;
+        size_t const size   = (size_t)rand() % (CHECK_MAX_SIZE + 1);
+        size_t const chunk  = (size_t)rand() % 200;
+
+        hash(&m_impl[0], m_buf + offset, size, 0, ref);
+        for (uint32_t i = 0; i < IMPL_COUNT; i++)
+        {
+            hash(&m_impl[i], m_buf + offset, size, chunk, digest);
+            if (memcmp(digest, ref, sizeof(digest)) != 0)
+            {
+                printf("%s: mismatch, offset %zu size %zu chunk %zu\n", m_impl[i].p_name, offset, size, chunk);
+                errors++;
+            }
+        }
+    }
+
+    return errors;
+}
+
+
+// Returns the cost per byte.
+static double measure(impl_t const * p_impl, size_t size, size_t chunk, uint64_t min_ns)
+{
+    uint64_t const start_ns = bench_now_ns();
+    uint64_t const start    = now();
+    uint64_t       bytes    = 0;
+    uint8_t        digest[32];
+
+    do
+    {
+        hash(p_impl, m_buf, size, chunk, digest);
+        m_sink ^= digest[0];
+        bytes  += size;
+    } while (bench_now_ns() - start_ns < min_ns);
+
+    return (double)(now() - start) / (double)bytes;
+}
+
+
+int main(int argc, char ** argv)
+{
+    uint64_t const min_ns = ((argc > 1) ? strtoull(argv[1], NULL, 0) : 100) * 1000000ULL;
+
+    srand(1);
+    for (size_t i = 0; i < sizeof(m_buf); i++)
+    {
+        m_buf[i] = (uint8_t)rand();
+    }
+
+    uint32_t const errors = check();
+    printf("cross-check: %u rounds, %u errors\n", CHECK_ROUNDS, errors);
+
+    for (uint32_t stream = 0; stream < 2; stream++)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        printf("\n--- %s, cycles/byte ---\n%10s", stream ? "100-byte chunks" : "one call", "size");
+#else
+        printf("\n--- %s, ns/byte ---\n%10s", stream ? "100-byte chunks" : "one call", "size");
+#endif
+        for (uint32_t i = 0; i < IMPL_COUNT; i++)
+        {
+            printf("%12s", m_impl[i].p_name);
+        }
+        printf("\n");
+
+        for (size_t size = 64; size <= MAX_SIZE; size *= 4)
+        {
+            printf("%10zu", size);
+            for (uint32_t i = 0; i < IMPL_COUNT; i++)
+            {
+                printf("%12.2f", measure(&m_impl[i], size, stream ? STREAM_CHUNK : 0, min_ns));
+            }
+            printf("\n");
+        }
+    }
+
+    return (errors == 0) ? 0 : 1;
+}
@@ -53,6 +53,10 @@
 #define SIG0(x) (ROTRIGHT(x,7) ^ ROTRIGHT(x,18) ^ ((x) >> 3))
 #define SIG1(x) (ROTRIGHT(x,17) ^ ROTRIGHT(x,19) ^ ((x) >> 10))
 
+#ifndef SHA256_UNROLLED
+#define SHA256_UNROLLED 0   // Unroll the message schedule and the compression rounds. Faster, but larger.
+#endif
+
 
 static const uint32_t k[64] = {
     0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
@@ -66,6 +70,81 @@ static const uint32_t k[64] = {
 };
 
 
+#if SHA256_UNROLLED
+
+// Load a big-endian word.
+#define LOAD_BE(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | ((uint32_t)(p)[3]))
+
+// The message schedule is kept in a rolling window of 16 words. i is a constant in every
+// expansion, so the indexes are resolved at compile time.
+#define M(i) (((i) < 16) ? m[i] : (m[(i) & 15] += SIG1(m[((i) - 2) & 15]) + m[((i) - 7) & 15] + SIG0(m[((i) - 15) & 15])))
+
+// One round. Instead of shifting the working variables, the callers rotate their names.
+#define ROUND(a,b,c,d,e,f,g,h,i) do {                               \
+        uint32_t t1 = (h) + EP1(e) + CH(e,f,g) + k[i] + M(i);       \
+        (d) += t1;                                                  \
+        (h)  = t1 + EP0(a) + MAJ(a,b,c);                            \
+    } while (0)
+
+#define ROUNDS8(i) do {                                             \
+        ROUND(a, b, c, d, e, f, g, h, (i) + 0);                     \
+        ROUND(h, a, b, c, d, e, f, g, (i) + 1);                     \
+        ROUND(g, h, a, b, c, d, e, f, (i) + 2);                     \
+        ROUND(f, g, h, a, b, c, d, e, (i) + 3);                     \
+        ROUND(e, f, g, h, a, b, c, d, (i) + 4);                     \
+        ROUND(d, e, f, g, h, a, b, c, (i) + 5);                     \
+        ROUND(c, d, e, f, g, h, a, b, (i) + 6);                     \
+        ROUND(b, c, d, e, f, g, h, a, (i) + 7);                     \
+    } while (0)
+
+/**@brief Function for calculating the hash of a 64-byte section of data.
+ *
+ * @param[in,out] ctx   Hash instance.
+ * @param[in]     data  Aray with data to be hashed. Assumed to be 64 bytes long.
+ */
+void sha256_transform(sha256_context_t *ctx, const uint8_t * data)
+{
+    uint32_t a, b, c, d, e, f, g, h, m[16];
+
+    m[0]  = LOAD_BE(data);      m[1]  = LOAD_BE(data + 4);
+    m[2]  = LOAD_BE(data + 8);  m[3]  = LOAD_BE(data + 12);
+    m[4]  = LOAD_BE(data + 16); m[5]  = LOAD_BE(data + 20);
+    m[6]  = LOAD_BE(data + 24); m[7]  = LOAD_BE(data + 28);
+    m[8]  = LOAD_BE(data + 32); m[9]  = LOAD_BE(data + 36);
+    m[10] = LOAD_BE(data + 40); m[11] = LOAD_BE(data + 44);
+    m[12] = LOAD_BE(data + 48); m[13] = LOAD_BE(data + 52);
+    m[14] = LOAD_BE(data + 56); m[15] = LOAD_BE(data + 60);
+
+    a = ctx->state[0];
+    b = ctx->state[1];
+    c = ctx->state[2];
+    d = ctx->state[3];
+    e = ctx->state[4];
+    f = ctx->state[5];
+    g = ctx->state[6];
+    h = ctx->state[7];
+
+    ROUNDS8(0);
+    ROUNDS8(8);
+    ROUNDS8(16);
+    ROUNDS8(24);
+    ROUNDS8(32);
+    ROUNDS8(40);
+    ROUNDS8(48);
+    ROUNDS8(56);
+
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+    ctx->state[5] += f;
+    ctx->state[6] += g;
+    ctx->state[7] += h;
+}
+
+#else
+
 /**@brief Function for calculating the hash of a 64-byte section of data.
  *
  * @param[in,out] ctx   Hash instance.
@@ -112,6 +191,8 @@ void sha256_transform(sha256_context_t *ctx, const uint8_t * data)
     ctx->state[7] += h;
 }
 
+#endif // SHA256_UNROLLED
+
 
 ret_code_t sha256_init(sha256_context_t *ctx)
 {
@@ -140,16 +221,32 @@ ret_code_t sha256_update(sha256_context_t *ctx, const uint8_t * data, size_t len
         return NRF_ERROR_NULL;
     }
 
-    uint32_t i;
+    size_t chunk;
 
-    for (i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
-        if (ctx->datalen == 64) {
-            sha256_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
-        }
+    // Complete the block that is partially buffered.
+    if ((ctx->datalen > 0) && (len > 0)) {
+        chunk = MIN(len, 64 - ctx->datalen);
+        memcpy(&ctx->data[ctx->datalen], data, chunk);
+        ctx->datalen += chunk;
+        data += chunk;
+        len -= chunk;
+        if (ctx->datalen < 64)
+            return NRF_SUCCESS;
+        sha256_transform(ctx, ctx->data);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
+    }
+
+    // Hash whole blocks directly from the caller's buffer.
+    for ( ; len >= 64; data += 64, len -= 64) {
+        sha256_transform(ctx, data);
+        ctx->bitlen += 512;
+    }
+
+    // Buffer the rest until the block is completed by the next call or by sha256_final.
+    if (len > 0) {
+        memcpy(ctx->data, data, len);
+        ctx->datalen = len;
     }
 
     return NRF_SUCCESS;
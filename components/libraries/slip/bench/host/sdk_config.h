@@ -0,0 +1,8 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of the SLIP module used by slip_bench.
+
+#define SLIP_ENABLED 1
+
+#endif // SDK_CONFIG_H
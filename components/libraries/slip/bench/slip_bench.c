@@ -0,0 +1,450 @@
+/**
+ * Copyright (c) 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Test and benchmark of the SLIP encoders and decoders against the byte-by-byte ones.
+ *
+ * Build it on host from this directory:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I$L/util slip_bench.c ../slip.c $L/bench_host/bench.c \
+ *      -o slip_bench
+ *
+ * Usage: slip_bench [minimum time per measurement in ms]
+ *
+ * The encoders are first checked against the byte-by-byte encoder on packets of random size,
+ * alignment and density of END and ESC bytes, with random output windows for the incremental one.
+ * slip_decode_buf is checked against slip_decode_add_byte on a stream of such packets, cut into
+ * random blocks, with invalid escape sequences and packets too long for the buffer among them:
+ * both must report the same packets and errors, in the same order.
+ *
+ * Then the throughput of each is measured on 64 different 4 kB packets of random bytes, where one
+ * byte in 128 is END or ESC, and on escape-heavy packets, where half of the bytes are. The decoders are given
+ * the data in 64 byte blocks, as received from USB CDC ACM.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdk_common.h"
+#include "slip.h"
+#include "bench.h"
+
+
+#define SLIP_BYTE_END       0300
+#define SLIP_BYTE_ESC       0333
+#define SLIP_BYTE_ESC_END   0334
+#define SLIP_BYTE_ESC_ESC   0335
+
+#define CHECK_ROUNDS        20000
+#define CHECK_MAX_SIZE      600
+#define STREAM_PACKETS      16
+#define DECODE_BUFFER_SIZE  512
+#define BENCH_SIZE          4096
+#define BENCH_PACKETS       64          // Different packets, so that branches are not learned.
+#define RX_BLOCK_SIZE       64
+
+// Decoding event, as seen by the application.
+typedef struct
+{
+    ret_code_t ret_code;
+    uint32_t   length;
+    uint32_t   offset;      // Offset of the packet in m_packets, for NRF_SUCCESS.
+} decode_event_t;
+
+static uint8_t        m_input[CHECK_MAX_SIZE + 8];
+static uint8_t        m_stream[STREAM_PACKETS * (2 * CHECK_MAX_SIZE + 8)];
+static uint8_t        m_output[2 * BENCH_SIZE + 8];
+static uint8_t        m_output_ref[2 * BENCH_SIZE + 8];
+static uint8_t        m_bench_input[BENCH_PACKETS][BENCH_SIZE];
+static uint8_t        m_bench_encoded[BENCH_PACKETS][2 * BENCH_SIZE + 1];
+static uint32_t       m_bench_encoded_length[BENCH_PACKETS];
+static uint8_t        m_decode_buffer[BENCH_SIZE];
+static uint8_t        m_packets[2][STREAM_PACKETS * DECODE_BUFFER_SIZE];
+static decode_event_t m_events[2][STREAM_PACKETS * 4 + (2 * CHECK_MAX_SIZE + 8) * STREAM_PACKETS];
+static uint32_t volatile m_sink;
+
+
+// Random bytes, of which about one in special_one_in is END or ESC.
+static void random_fill(uint8_t * p_data, uint32_t length, uint32_t special_one_in)
+{
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if ((bench_random() % special_one_in) == 0)
+        {
+            p_data[i] = (bench_random() & 1) ? SLIP_BYTE_END : SLIP_BYTE_ESC;
+        }
+        else
+        {
+            do
+            {
+                p_data[i] = (uint8_t)bench_random();
+            } while ((p_data[i] == SLIP_BYTE_END) || (p_data[i] == SLIP_BYTE_ESC));
+        }
+    }
+}
+
+
+// The byte-by-byte encoder the module had before.
+static void reference_encode(uint8_t * p_output, uint8_t const * p_input, uint32_t input_length,
+                             uint32_t * p_output_length)
+{
+    *p_output_length = 0;
+
+    for (uint32_t i = 0; i < input_length; i++)
+    {
+        switch (p_input[i])
+        {
+            case SLIP_BYTE_END:
+                p_output[(*p_output_length)++] = SLIP_BYTE_ESC;
+                p_output[(*p_output_length)++] = SLIP_BYTE_ESC_END;
+                break;
+
+            case SLIP_BYTE_ESC:
+                p_output[(*p_output_length)++] = SLIP_BYTE_ESC;
+                p_output[(*p_output_length)++] = SLIP_BYTE_ESC_ESC;
+                break;
+
+            default:
+                p_output[(*p_output_length)++] = p_input[i];
+        }
+    }
+    p_output[(*p_output_length)++] = SLIP_BYTE_END;
+}
+
+
+static uint32_t incremental_encode(uint8_t * p_output, uint8_t const * p_input,
+                                   uint32_t input_length, uint32_t window_max)
+{
+    slip_encoder_t encoder;
+    uint32_t       length = 0;
+    ret_code_t     ret_code;
+
+    slip_encoder_init(&encoder, p_input, input_length);
+    do
+    {
+        uint32_t window = (window_max == 0) ? (bench_random() % 16) : window_max;
+        uint32_t written;
+
+        ret_code = slip_encoder_run(&encoder, &p_output[length], window, &written);
+        CHECK(written <= window);
+        CHECK((ret_code == NRF_SUCCESS) || (written == window));
+        length += written;
+    } while (ret_code == NRF_ERROR_BUSY);
+    CHECK(ret_code == NRF_SUCCESS);
+
+    return length;
+}
+
+
+static void encoders_check(void)
+{
+    for (uint32_t round = 0; round < CHECK_ROUNDS; round++)
+    {
+        uint32_t  length = bench_random() % CHECK_MAX_SIZE;
+        uint8_t * p_in   = &m_input[bench_random() % 8];
+        uint8_t * p_out  = &m_output[bench_random() % 8];
+        uint32_t  ref_length;
+        uint32_t  out_length;
+
+        random_fill(p_in, length, 1 + bench_random() % 64);
+        reference_encode(m_output_ref, p_in, length, &ref_length);
+
+        CHECK(slip_encode(p_out, p_in, length, &out_length) == NRF_SUCCESS);
+        CHECK((out_length == ref_length) && (memcmp(p_out, m_output_ref, ref_length) == 0));
+
+        out_length = incremental_encode(p_out, p_in, length, 0);
+        CHECK((out_length == ref_length) && (memcmp(p_out, m_output_ref, ref_length) == 0));
+    }
+}
+
+
+// Builds a stream of packets, some of them too long for the decoding buffer and some with an
+// invalid escape sequence, and returns its length.
+static uint32_t stream_build(void)
+{
+    uint32_t length = 0;
+
+    for (uint32_t p = 0; p < STREAM_PACKETS; p++)
+    {
+        uint32_t packet_length = bench_random() % CHECK_MAX_SIZE;
+        uint32_t encoded_length;
+
+        random_fill(m_input, packet_length, 1 + bench_random() % 64);
+        (void)slip_encode(&m_stream[length], m_input, packet_length, &encoded_length);
+        if ((bench_random() % 8) == 0 && (encoded_length > 2))
+        {
+            // Invalid escape sequence.
+            uint32_t pos = bench_random() % (encoded_length - 2);
+
+            m_stream[length + pos]     = SLIP_BYTE_ESC;
+            m_stream[length + pos + 1] = (uint8_t)(bench_random() % 0x80);
+        }
+        length += encoded_length;
+    }
+    return length;
+}
+
+
+static uint32_t event_add(decode_event_t * p_events, uint32_t count, ret_code_t ret_code,
+                          slip_t * p_slip, uint8_t * p_packets, uint32_t * p_offset)
+{
+    p_events[count].ret_code = ret_code;
+    p_events[count].length   = p_slip->current_index;
+    p_events[count].offset   = *p_offset;
+    if (ret_code == NRF_SUCCESS)
+    {
+        // Hand the packet over and decode the next one after it, like the DFU transport.
+        *p_offset              += p_slip->current_index;
+        p_slip->p_buffer        = &p_packets[*p_offset];
+        p_slip->current_index   = 0;
+        p_slip->state           = SLIP_STATE_DECODING;
+    }
+    return count + 1;
+}
+
+
+static void slip_reset(slip_t * p_slip, uint8_t * p_buffer)
+{
+    p_slip->state         = SLIP_STATE_DECODING;
+    p_slip->p_buffer      = p_buffer;
+    p_slip->current_index = 0;
+    p_slip->buffer_len    = DECODE_BUFFER_SIZE;
+}
+
+
+static void decoders_check(void)
+{
+    for (uint32_t round = 0; round < CHECK_ROUNDS / 50; round++)
+    {
+        uint32_t const length   = stream_build();
+        uint32_t       count[2] = { 0, 0 };
+        uint32_t       offset[2] = { 0, 0 };
+        slip_t         slip[2];
+        uint32_t       i;
+
+        slip_reset(&slip[0], m_packets[0]);
+        slip_reset(&slip[1], m_packets[1]);
+
+        for (i = 0; i < length; i++)
+        {
+            ret_code_t ret_code = slip_decode_add_byte(&slip[0], m_stream[i]);
+
+            if (ret_code != NRF_ERROR_BUSY)
+            {
+                count[0] = event_add(m_events[0], count[0], ret_code, &slip[0], m_packets[0],
+                                     &offset[0]);
+                if (ret_code == NRF_ERROR_NO_MEM)
+                {
+                    // Drop the rest of the packet, as a new buffer would be needed.
+                    slip[0].state         = SLIP_STATE_CLEARING_INVALID_PACKET;
+                    slip[0].current_index = 0;
+                }
+            }
+        }
+
+        for (i = 0; i < length; )
+        {
+            uint32_t   block = 1 + bench_random() % 200;
+            uint32_t   consumed;
+            ret_code_t ret_code;
+
+            block    = MIN(block, length - i);
+            ret_code = slip_decode_buf(&slip[1], &m_stream[i], block, &consumed);
+
+            CHECK((consumed > 0) && (consumed <= block));
+            CHECK((ret_code != NRF_ERROR_BUSY) || (consumed == block));
+            i += consumed;
+            if (ret_code != NRF_ERROR_BUSY)
+            {
+                count[1] = event_add(m_events[1], count[1], ret_code, &slip[1], m_packets[1],
+                                     &offset[1]);
+                if (ret_code == NRF_ERROR_NO_MEM)
+                {
+                    slip[1].state         = SLIP_STATE_CLEARING_INVALID_PACKET;
+                    slip[1].current_index = 0;
+                }
+            }
+        }
+
+        CHECK(count[0] == count[1]);
+        CHECK(memcmp(m_events[0], m_events[1], count[0] * sizeof(decode_event_t)) == 0);
+        CHECK(memcmp(m_packets[0], m_packets[1], offset[0]) == 0);
+        CHECK((slip[0].state == slip[1].state) &&
+              (slip[0].current_index == slip[1].current_index));
+    }
+}
+
+
+static void decode_errors_check(void)
+{
+    static uint8_t const invalid[] = { 1, SLIP_BYTE_ESC, 2, 3, SLIP_BYTE_END, 4, SLIP_BYTE_END };
+
+    slip_t   slip;
+    uint8_t  buffer[4];
+    uint32_t consumed;
+
+    slip.state         = SLIP_STATE_DECODING;
+    slip.p_buffer      = buffer;
+    slip.current_index = 0;
+    slip.buffer_len    = sizeof(buffer);
+
+    CHECK(slip_decode_buf(NULL, invalid, sizeof(invalid), &consumed) == NRF_ERROR_NULL);
+    CHECK(slip_decode_buf(&slip, invalid, 0, &consumed) == NRF_ERROR_BUSY);
+    CHECK(consumed == 0);
+
+    // The invalid packet is reported at its bad escape sequence and dropped up to its END byte.
+    CHECK(slip_decode_buf(&slip, invalid, sizeof(invalid), &consumed) == NRF_ERROR_INVALID_DATA);
+    CHECK(consumed == 3);
+    CHECK(slip_decode_buf(&slip, &invalid[3], sizeof(invalid) - 3, &consumed) == NRF_SUCCESS);
+    CHECK((consumed == 4) && (slip.current_index == 1) && (buffer[0] == 4));
+
+    // Every byte which does not fit is dropped, including END.
+    slip.current_index = 0;
+    CHECK(slip_decode_buf(&slip, m_input, 6, &consumed) == NRF_ERROR_NO_MEM);
+    CHECK((consumed == 5) && (slip.current_index == 4));
+}
+
+
+static double measure(uint32_t special_one_in, uint32_t method, uint64_t min_ns)
+{
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t iterations = 0;
+
+    for (uint32_t n = 0; n < BENCH_PACKETS; n++)
+    {
+        random_fill(m_bench_input[n], BENCH_SIZE, special_one_in);
+        (void)slip_encode(m_bench_encoded[n], m_bench_input[n], BENCH_SIZE,
+                          &m_bench_encoded_length[n]);
+    }
+
+    start = bench_now_ns();
+    do
+    {
+        for (uint32_t n = 0; n < BENCH_PACKETS; n++)
+        {
+            uint8_t const * p_input        = m_bench_input[n];
+            uint8_t const * p_encoded      = m_bench_encoded[n];
+            uint32_t const  encoded_length = m_bench_encoded_length[n];
+            uint32_t        length         = 0;
+
+            switch (method)
+            {
+                case 0:
+                    reference_encode(m_output, p_input, BENCH_SIZE, &length);
+                    break;
+
+                case 1:
+                    (void)slip_encode(m_output, (uint8_t *)p_input, BENCH_SIZE, &length);
+                    break;
+
+                case 2:
+                    length = incremental_encode(m_output, p_input, BENCH_SIZE, RX_BLOCK_SIZE);
+                    break;
+
+                case 3:
+                case 4:
+                {
+                    slip_t slip;
+
+                    slip_reset(&slip, m_decode_buffer);
+                    slip.buffer_len = sizeof(m_decode_buffer);
+                    for (uint32_t i = 0; i < encoded_length; )
+                    {
+                        uint32_t const block = MIN(encoded_length - i, RX_BLOCK_SIZE);
+
+                        if (method == 3)
+                        {
+                            for (uint32_t j = 0; j < block; j++)
+                            {
+                                (void)slip_decode_add_byte(&slip, p_encoded[i + j]);
+                            }
+                            i += block;
+                        }
+                        else
+                        {
+                            uint32_t consumed;
+
+                            (void)slip_decode_buf(&slip, &p_encoded[i], block, &consumed);
+                            i += consumed;
+                        }
+                    }
+                    length = slip.current_index;
+                    CHECK(length == BENCH_SIZE);
+                    break;
+                }
+            }
+            m_sink += length + m_output[n];
+        }
+        iterations += BENCH_PACKETS;
+        elapsed = bench_now_ns() - start;
+    } while (elapsed < min_ns);
+
+    return (double)iterations * BENCH_SIZE * 1000.0 / (double)elapsed;
+}
+
+
+int main(int argc, char ** argv)
+{
+    static char const * const method_names[] =
+    {
+        "encode byte by byte", "slip_encode", "slip_encoder_run, 64 B",
+        "decode byte by byte", "slip_decode_buf, 64 B"
+    };
+    uint64_t const min_ns = ((argc > 1) ? strtoul(argv[1], NULL, 0) : 200) * 1000000ULL;
+
+    encoders_check();
+    decoders_check();
+    decode_errors_check();
+
+    printf("%-24s %14s %14s\n", "MB/s", "random", "escape-heavy");
+    for (uint32_t method = 0; method < ARRAY_SIZE(method_names); method++)
+    {
+        double random = measure(128, method, min_ns);
+        double escape = measure(2, method, min_ns);
+
+        printf("%-24s %14.1f %14.1f\n", method_names[method], random, escape);
+    }
+
+    if (bench_failed())
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
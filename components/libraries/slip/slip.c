@@ -50,6 +50,87 @@
 #define SLIP_BYTE_ESC_ESC         0335    /* ESC ESC_ESC means ESC data byte */
 
 
+#define SLIP_WORD_ONES            0x01010101UL
+#define SLIP_WORD_HIGH_BITS       0x80808080UL
+
+/* non-zero if one of the bytes of the word w is equal to b */
+#define SLIP_WORD_HAS_BYTE(w, b)  ((((w) ^ ((b) * SLIP_WORD_ONES)) - SLIP_WORD_ONES) & \
+                                   ~((w) ^ ((b) * SLIP_WORD_ONES)) & SLIP_WORD_HIGH_BITS)
+
+#define SLIP_IS_WORD_ALIGNED(p)   ((((uint32_t)(uintptr_t)(p)) & 0x03) == 0)
+
+
+/**@brief Function for reading a word of data if none of its bytes is END or ESC.
+ *
+ * Runs of such bytes are copied a word at a time, and only the words around END and ESC bytes
+ * are handled byte by byte.
+ *
+ * @param[in]  p_data  Word-aligned data, at least one word long.
+ * @param[out] p_word  The word.
+ *
+ * @return True if the bytes of the word can be copied as they are.
+ */
+static __INLINE bool plain_word_read(uint8_t const * p_data, uint32_t * p_word)
+{
+    uint32_t word;
+
+    memcpy(&word, p_data, sizeof(word));
+    *p_word = word;
+    return !SLIP_WORD_HAS_BYTE(word, SLIP_BYTE_END) && !SLIP_WORD_HAS_BYTE(word, SLIP_BYTE_ESC);
+}
+
+
+/**@brief Function for encoding one byte.
+ *
+ * @return Number of bytes written to @p p_output, 1 or 2.
+ */
+static __INLINE uint32_t byte_encode(uint8_t * p_output, uint8_t c)
+{
+    switch (c)
+    {
+        case SLIP_BYTE_END:
+            p_output[0] = SLIP_BYTE_ESC;
+            p_output[1] = SLIP_BYTE_ESC_END;
+            return 2;
+
+        case SLIP_BYTE_ESC:
+            p_output[0] = SLIP_BYTE_ESC;
+            p_output[1] = SLIP_BYTE_ESC_ESC;
+            return 2;
+
+        default:
+            p_output[0] = c;
+            return 1;
+    }
+}
+
+
+/**@brief Function for encoding a word of data.
+ *
+ * @param[out] p_output  Room for at least two words.
+ * @param[in]  p_input   Word-aligned data, at least one word long.
+ *
+ * @return Number of bytes written to @p p_output.
+ */
+static __INLINE uint32_t word_encode(uint8_t * p_output, uint8_t const * p_input)
+{
+    uint32_t word;
+    uint32_t length = 0;
+
+    if (plain_word_read(p_input, &word))
+    {
+        memcpy(p_output, &word, sizeof(word));
+        return sizeof(word);
+    }
+
+    for (uint32_t i = 0; i < sizeof(word); i++)
+    {
+        length += byte_encode(&p_output[length], p_input[i]);
+    }
+    return length;
+}
+
+
 ret_code_t slip_encode(uint8_t * p_output,  uint8_t * p_input, uint32_t input_length, uint32_t * p_output_buffer_length)
 {
     if (p_output == NULL || p_input == NULL || p_output_buffer_length == NULL)
@@ -57,30 +138,103 @@ ret_code_t slip_encode(uint8_t * p_output,  uint8_t * p_input, uint32_t input_le
         return NRF_ERROR_NULL;
     }
 
-    *p_output_buffer_length = 0;
-    uint32_t input_index;
+    uint32_t input_index  = 0;
+    uint32_t output_index = 0;
 
-    for (input_index = 0; input_index < input_length; input_index++)
+    while (input_index < input_length)
     {
-        switch (p_input[input_index])
+        // A tail shorter than two words is cheaper to encode byte by byte.
+        if (SLIP_IS_WORD_ALIGNED(&p_input[input_index]) &&
+            (input_length - input_index >= 2 * sizeof(uint32_t)))
         {
-            case SLIP_BYTE_END:
-                p_output[(*p_output_buffer_length)++] = SLIP_BYTE_ESC;
-                p_output[(*p_output_buffer_length)++] = SLIP_BYTE_ESC_END;
-                break;
+            output_index += word_encode(&p_output[output_index], &p_input[input_index]);
+            input_index  += sizeof(uint32_t);
+        }
+        else
+        {
+            output_index += byte_encode(&p_output[output_index], p_input[input_index]);
+            input_index++;
+        }
+    }
+    p_output[output_index++] = SLIP_BYTE_END;
+    *p_output_buffer_length  = output_index;
 
-            case SLIP_BYTE_ESC:
-                p_output[(*p_output_buffer_length)++] = SLIP_BYTE_ESC;
-                p_output[(*p_output_buffer_length)++] = SLIP_BYTE_ESC_ESC;
-                break;
+    return NRF_SUCCESS;
+}
+
+
+void slip_encoder_init(slip_encoder_t * p_encoder, uint8_t const * p_input, uint32_t input_length)
+{
+    p_encoder->p_input      = p_input;
+    p_encoder->input_length = input_length;
+    p_encoder->input_index  = 0;
+    p_encoder->pending      = 0;
+    p_encoder->done         = false;
+}
+
+
+ret_code_t slip_encoder_run(slip_encoder_t * p_encoder, uint8_t * p_output, uint32_t output_size, uint32_t * p_output_length)
+{
+    if (p_encoder == NULL || p_output == NULL || p_output_length == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
 
-            default:
-                p_output[(*p_output_buffer_length)++] = p_input[input_index];
+    // The state is kept in local variables, as writes to the output could alias it.
+    uint8_t const * p_input      = p_encoder->p_input;
+    uint32_t const  input_length = p_encoder->input_length;
+    uint32_t        input_index  = p_encoder->input_index;
+    uint8_t         pending      = p_encoder->pending;
+    uint32_t        output_index = 0;
+
+    while (output_index < output_size)
+    {
+        uint8_t const * p_in = &p_input[input_index];
+
+        if (pending != 0)
+        {
+            // Second byte of the escape sequence which ended the previous window.
+            p_output[output_index++] = pending;
+            pending                  = 0;
+        }
+        else if (input_index == input_length)
+        {
+            break;
+        }
+        else if (SLIP_IS_WORD_ALIGNED(p_in) &&
+                 (input_length - input_index >= 2 * sizeof(uint32_t)) &&
+                 (output_size - output_index >= 2 * sizeof(uint32_t)))
+        {
+            output_index += word_encode(&p_output[output_index], p_in);
+            input_index  += sizeof(uint32_t);
+        }
+        else if ((*p_in == SLIP_BYTE_END) || (*p_in == SLIP_BYTE_ESC))
+        {
+            // The second byte of the escape sequence may not fit in the window.
+            p_output[output_index++] = SLIP_BYTE_ESC;
+            pending                  = (*p_in == SLIP_BYTE_END) ? SLIP_BYTE_ESC_END
+                                                                : SLIP_BYTE_ESC_ESC;
+            input_index++;
+        }
+        else
+        {
+            p_output[output_index++] = *p_in;
+            input_index++;
         }
     }
-    p_output[(*p_output_buffer_length)++] = SLIP_BYTE_END;
 
-    return NRF_SUCCESS;
+    if ((input_index == input_length) && (pending == 0) &&
+        (output_index < output_size) && !p_encoder->done)
+    {
+        p_output[output_index++] = SLIP_BYTE_END;
+        p_encoder->done          = true;
+    }
+
+    p_encoder->input_index = input_index;
+    p_encoder->pending     = pending;
+    *p_output_length       = output_index;
+
+    return p_encoder->done ? NRF_SUCCESS : NRF_ERROR_BUSY;
 }
 
 ret_code_t slip_decode_add_byte(slip_t * p_slip, uint8_t c)
@@ -147,4 +301,106 @@ ret_code_t slip_decode_add_byte(slip_t * p_slip, uint8_t c)
 
     return NRF_ERROR_BUSY;
 }
+
+
+ret_code_t slip_decode_buf(slip_t * p_slip, uint8_t const * p_data, uint32_t length, uint32_t * p_consumed)
+{
+    if (p_slip == NULL || p_data == NULL || p_consumed == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    ret_code_t ret_code = NRF_ERROR_BUSY;
+    uint32_t   index    = 0;
+
+    while ((index < length) && (ret_code == NRF_ERROR_BUSY))
+    {
+        if (p_slip->current_index == p_slip->buffer_len)
+        {
+            // drop the byte, as slip_decode_add_byte does
+            index++;
+            ret_code = NRF_ERROR_NO_MEM;
+            break;
+        }
+
+        switch (p_slip->state)
+        {
+            case SLIP_STATE_DECODING:
+            {
+                uint8_t const * p_in = &p_data[index];
+                uint32_t        word;
+
+                if (SLIP_IS_WORD_ALIGNED(p_in) &&
+                    (length - index >= sizeof(word)) &&
+                    (p_slip->buffer_len - p_slip->current_index >= sizeof(word)) &&
+                    plain_word_read(p_in, &word))
+                {
+                    memcpy(&p_slip->p_buffer[p_slip->current_index], &word, sizeof(word));
+                    p_slip->current_index += sizeof(word);
+                    index                 += sizeof(word);
+                    break;
+                }
+
+                index++;
+                switch (*p_in)
+                {
+                    case SLIP_BYTE_END:
+                        // finished reading packet
+                        ret_code = NRF_SUCCESS;
+                        break;
+
+                    case SLIP_BYTE_ESC:
+                        p_slip->state = SLIP_STATE_ESC_RECEIVED;
+                        break;
+
+                    default:
+                        p_slip->p_buffer[p_slip->current_index++] = *p_in;
+                        break;
+                }
+                break;
+            }
+
+            case SLIP_STATE_ESC_RECEIVED:
+                switch (p_data[index++])
+                {
+                    case SLIP_BYTE_ESC_END:
+                        p_slip->p_buffer[p_slip->current_index++] = SLIP_BYTE_END;
+                        p_slip->state = SLIP_STATE_DECODING;
+                        break;
+
+                    case SLIP_BYTE_ESC_ESC:
+                        p_slip->p_buffer[p_slip->current_index++] = SLIP_BYTE_ESC;
+                        p_slip->state = SLIP_STATE_DECODING;
+                        break;
+
+                    default:
+                        // protocol violation
+                        p_slip->state = SLIP_STATE_CLEARING_INVALID_PACKET;
+                        ret_code = NRF_ERROR_INVALID_DATA;
+                        break;
+                }
+                break;
+
+            case SLIP_STATE_CLEARING_INVALID_PACKET:
+            {
+                uint8_t const * p_end = memchr(&p_data[index], SLIP_BYTE_END, length - index);
+
+                if (p_end == NULL)
+                {
+                    index = length;
+                }
+                else
+                {
+                    index = (uint32_t)(p_end - p_data) + 1;
+                    p_slip->state = SLIP_STATE_DECODING;
+                    p_slip->current_index = 0;
+                }
+                break;
+            }
+        }
+    }
+
+    *p_consumed = index;
+    return ret_code;
+}
 #endif //NRF_MODULE_ENABLED(SLIP)
@@ -41,6 +41,7 @@
 #define SLIP_H__
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "sdk_errors.h"
 
 #ifdef __cplusplus
@@ -76,6 +77,16 @@ typedef struct
   uint32_t            buffer_len; //!< Size of the buffer that is available.
 } slip_t;
 
+/** @brief State of an incremental encoding, see @ref slip_encoder_init. */
+typedef struct
+{
+  uint8_t const       * p_input; //!< Data to be encoded.
+  uint32_t            input_length; //!< Length of the data to be encoded.
+  uint32_t            input_index; //!< Index of the next byte to be encoded.
+  uint8_t             pending; //!< Second byte of an escape sequence which did not fit in the output, or 0.
+  bool                done; //!< Whether the END byte has been written.
+} slip_encoder_t;
+
 /**@brief Function for encoding a SLIP packet.
  *
  * The maximum size of the output data is (2*input size + 1) bytes. Ensure that the provided buffer is large enough.
@@ -108,6 +119,52 @@ ret_code_t slip_encode(uint8_t * p_output,  uint8_t * p_input, uint32_t input_le
  */
 ret_code_t slip_decode_add_byte(slip_t * p_slip, uint8_t c);
 
+/**@brief Function for decoding a block of received bytes.
+ *
+ * Decodes the bytes like @ref slip_decode_add_byte called for each of them, and stops at the first byte for which it would not
+ * return NRF_ERROR_BUSY. The bytes between END and ESC bytes are copied to @p p_slip::p_buffer in blocks.
+ *
+ * When the function returns NRF_SUCCESS, the packet can be retrieved from @p p_slip. Call the function again with the rest of the
+ * data after the packet has been handled and @p p_slip has been reset.
+ *
+ * @param[in,out]   p_slip      State of the decoding process.
+ * @param[in]       p_data      Bytes to decode.
+ * @param[in]       length      Number of bytes to decode.
+ * @param[out]      p_consumed  Number of bytes decoded, including the byte that made the function return.
+ *
+ * @retval NRF_SUCCESS              If a packet has been parsed. Its END byte is the last byte consumed.
+ * @retval NRF_ERROR_NULL           If one of the provided parameters is NULL.
+ * @retval NRF_ERROR_NO_MEM         If there is no more room in the buffer provided by @p p_slip. The byte that did not fit is
+ *                                  consumed and dropped.
+ * @retval NRF_ERROR_BUSY           If all bytes have been consumed and the packet has not been parsed completely yet.
+ * @retval NRF_ERROR_INVALID_DATA   If the packet is encoded wrong, see @ref slip_decode_add_byte.
+ */
+ret_code_t slip_decode_buf(slip_t * p_slip, uint8_t const * p_data, uint32_t length, uint32_t * p_consumed);
+
+/**@brief Function for starting an incremental encoding of a SLIP packet.
+ *
+ * The packet is then written by @ref slip_encoder_run, in output windows of any size. The data to be encoded must stay valid
+ * until the encoding is done.
+ *
+ * @param[out]      p_encoder       State of the encoding process.
+ * @param[in]       p_input         The buffer to be encoded.
+ * @param[in]       input_length    The length of the input buffer.
+ */
+void slip_encoder_init(slip_encoder_t * p_encoder, uint8_t const * p_input, uint32_t input_length);
+
+/**@brief Function for writing the next part of a SLIP packet into an output window.
+ *
+ * @param[in,out]   p_encoder       State of the encoding process.
+ * @param[out]      p_output        The window where the next part of the packet is stored.
+ * @param[in]       output_size     Size of the window.
+ * @param[out]      p_output_length Number of bytes written to the window.
+ *
+ * @retval  NRF_SUCCESS         If the packet has been written completely, including its END byte.
+ * @retval  NRF_ERROR_NULL      If one of the provided parameters is NULL.
+ * @retval  NRF_ERROR_BUSY      If the window is full and the rest of the packet must be written to another one.
+ */
+ret_code_t slip_encoder_run(slip_encoder_t * p_encoder, uint8_t * p_output, uint32_t output_size, uint32_t * p_output_length);
+
 #ifdef __cplusplus
 }
 #endif
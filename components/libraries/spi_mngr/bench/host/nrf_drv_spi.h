@@ -0,0 +1,145 @@
+#ifndef NRF_DRV_SPI_H__
+#define NRF_DRV_SPI_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+// SPI master driver of the host build, simulated by nrf_spi_mngr_bench. Only the SPIM registers
+// written by the transaction manager are modelled.
+
+#define SPIM_PRESENT
+
+typedef enum
+{
+    NRF_SPIM_FREQ_125K = 0x02000000UL,
+    NRF_SPIM_FREQ_250K = 0x04000000UL,
+    NRF_SPIM_FREQ_500K = 0x08000000UL,
+    NRF_SPIM_FREQ_1M   = 0x10000000UL,
+    NRF_SPIM_FREQ_2M   = 0x20000000UL,
+    NRF_SPIM_FREQ_4M   = 0x40000000UL,
+    NRF_SPIM_FREQ_8M   = 0x80000000UL
+} nrf_spim_frequency_t;
+
+typedef enum
+{
+    NRF_SPIM_MODE_0,
+    NRF_SPIM_MODE_1,
+    NRF_SPIM_MODE_2,
+    NRF_SPIM_MODE_3
+} nrf_spim_mode_t;
+
+typedef enum
+{
+    NRF_SPIM_BIT_ORDER_MSB_FIRST,
+    NRF_SPIM_BIT_ORDER_LSB_FIRST
+} nrf_spim_bit_order_t;
+
+typedef struct
+{
+    uint32_t FREQUENCY;
+    uint32_t CONFIG;
+} NRF_SPIM_Type;
+
+extern NRF_SPIM_Type g_spim0;
+
+static inline void nrf_spim_frequency_set(NRF_SPIM_Type * p_reg, nrf_spim_frequency_t frequency)
+{
+    p_reg->FREQUENCY = frequency;
+}
+
+static inline void nrf_spim_configure(NRF_SPIM_Type *      p_reg,
+                                      nrf_spim_mode_t      spi_mode,
+                                      nrf_spim_bit_order_t spi_bit_order)
+{
+    p_reg->CONFIG = ((uint32_t)spi_bit_order << 2) | (uint32_t)spi_mode;
+}
+
+typedef struct
+{
+    NRF_SPIM_Type * p_reg;
+    uint8_t         drv_inst_idx;
+} nrfx_spim_t;
+
+typedef struct
+{
+    uint8_t inst_idx;
+    union
+    {
+        nrfx_spim_t spim;
+    } u;
+    bool    use_easy_dma;
+} nrf_drv_spi_t;
+
+#define NRF_DRV_SPI_INSTANCE(id)    { id, { .spim = { &g_spim0, id } }, true }
+
+#define NRF_DRV_SPI_USE_SPIM        true
+#define NRF_DRV_SPI_USE_SPI         false
+
+#define NRF_DRV_SPI_PIN_NOT_USED    0xFF
+
+typedef enum
+{
+    NRF_DRV_SPI_FREQ_125K = NRF_SPIM_FREQ_125K,
+    NRF_DRV_SPI_FREQ_250K = NRF_SPIM_FREQ_250K,
+    NRF_DRV_SPI_FREQ_500K = NRF_SPIM_FREQ_500K,
+    NRF_DRV_SPI_FREQ_1M   = NRF_SPIM_FREQ_1M,
+    NRF_DRV_SPI_FREQ_2M   = NRF_SPIM_FREQ_2M,
+    NRF_DRV_SPI_FREQ_4M   = NRF_SPIM_FREQ_4M,
+    NRF_DRV_SPI_FREQ_8M   = NRF_SPIM_FREQ_8M
+} nrf_drv_spi_frequency_t;
+
+typedef enum
+{
+    NRF_DRV_SPI_MODE_0 = NRF_SPIM_MODE_0,
+    NRF_DRV_SPI_MODE_1 = NRF_SPIM_MODE_1,
+    NRF_DRV_SPI_MODE_2 = NRF_SPIM_MODE_2,
+    NRF_DRV_SPI_MODE_3 = NRF_SPIM_MODE_3
+} nrf_drv_spi_mode_t;
+
+typedef enum
+{
+    NRF_DRV_SPI_BIT_ORDER_MSB_FIRST = NRF_SPIM_BIT_ORDER_MSB_FIRST,
+    NRF_DRV_SPI_BIT_ORDER_LSB_FIRST = NRF_SPIM_BIT_ORDER_LSB_FIRST
+} nrf_drv_spi_bit_order_t;
+
+typedef struct
+{
+    uint8_t sck_pin;
+    uint8_t mosi_pin;
+    uint8_t miso_pin;
+    uint8_t ss_pin;
+    uint8_t irq_priority;
+    uint8_t orc;
+    nrf_drv_spi_frequency_t frequency;
+    nrf_drv_spi_mode_t      mode;
+    nrf_drv_spi_bit_order_t bit_order;
+} nrf_drv_spi_config_t;
+
+typedef enum
+{
+    NRF_DRV_SPI_EVENT_DONE,
+} nrf_drv_spi_evt_type_t;
+
+typedef struct
+{
+    nrf_drv_spi_evt_type_t type;
+} nrf_drv_spi_evt_t;
+
+typedef void (* nrf_drv_spi_evt_handler_t)(nrf_drv_spi_evt_t const * p_event,
+                                           void *                    p_context);
+
+ret_code_t nrf_drv_spi_init(nrf_drv_spi_t const * const  p_instance,
+                            nrf_drv_spi_config_t const * p_config,
+                            nrf_drv_spi_evt_handler_t    handler,
+                            void *                       p_context);
+
+void nrf_drv_spi_uninit(nrf_drv_spi_t const * const p_instance);
+
+ret_code_t nrf_drv_spi_transfer(nrf_drv_spi_t const * const p_instance,
+                                uint8_t const *             p_tx_buffer,
+                                uint8_t                     tx_buffer_length,
+                                uint8_t *                   p_rx_buffer,
+                                uint8_t                     rx_buffer_length);
+
+#endif // NRF_DRV_SPI_H__
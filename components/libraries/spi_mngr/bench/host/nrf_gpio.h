@@ -0,0 +1,19 @@
+#ifndef NRF_GPIO_H__
+#define NRF_GPIO_H__
+
+#include <stdint.h>
+
+// Output levels of the pins, read by nrf_spi_mngr_bench.
+extern uint32_t g_gpio_out;
+
+static inline void nrf_gpio_pin_set(uint32_t pin_number)
+{
+    g_gpio_out |= (1UL << pin_number);
+}
+
+static inline void nrf_gpio_pin_clear(uint32_t pin_number)
+{
+    g_gpio_out &= ~(1UL << pin_number);
+}
+
+#endif // NRF_GPIO_H__
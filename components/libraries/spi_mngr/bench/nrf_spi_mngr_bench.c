@@ -0,0 +1,416 @@
+/**
+ * Copyright (c) 2017 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Test and benchmark of the SPI transaction manager on a simulated SPIM, in the order of scheduling
+ * or with NRF_SPI_MNGR_CONFIG_REORDER.
+ *
+ * Build it on host from this directory, for one mode or the other:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I$L/queue -I$L/util -I$L/atomic -I$L/log -I$L/log/src \
+ *      -I$L/strerror nrf_spi_mngr_bench.c ../nrf_spi_mngr.c $L/queue/nrf_queue.c $L/atomic/nrf_atomic.c \
+ *      $L/bench_host/bench.c -o nrf_spi_mngr_bench
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I$L/queue -I$L/util -I$L/atomic -I$L/log -I$L/log/src \
+ *      -I$L/strerror -DNRF_SPI_MNGR_CONFIG_REORDER=1 \
+ *      nrf_spi_mngr_bench.c ../nrf_spi_mngr.c $L/queue/nrf_queue.c $L/atomic/nrf_atomic.c \
+ *      $L/bench_host/bench.c -o nrf_spi_mngr_reorder_bench
+ *
+ * Usage: nrf_spi_mngr_bench [transactions]
+ *
+ * The SPI driver is replaced by a simulation of the SPIM registers written by the manager, and
+ * the SPI interrupt, which ends the transfer in progress, is called from the main loop. At each
+ * step, the application schedules zero to two transactions of one to three transfers, for two
+ * devices of the bus, with one priority or random priorities. Every transaction must end once, with its own
+ * configuration in the registers and SCK at the idle level of its mode. In the order of
+ * scheduling, no transaction may start before one scheduled earlier. With reordering, none may be
+ * overtaken more than NRF_SPI_MNGR_CONFIG_REORDER_MAX_BYPASS times.
+ *
+ * The devices first share all pins and drive their Slave Select in the transaction callbacks, so
+ * that configuration changes only rewrite registers, then they use their own Slave Select pins,
+ * so that the driver is reinitialized. The statistics of the manager and the time per transaction
+ * are printed for both.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdk_common.h"
+#include "nrf_spi_mngr.h"
+#include "nrf_gpio.h"
+#include "bench.h"
+
+
+#define QUEUE_SIZE          8
+#define SLOTS               (2 * QUEUE_SIZE + 2)
+#define TRANSFERS_MAX       3
+#define PRIORITIES          3
+#define SCK_PIN             3
+#define MOSI_PIN            4
+#define MISO_PIN            5
+#define FLASH_SS_PIN        6
+#define DISPLAY_SS_PIN      7
+
+typedef struct
+{
+    nrf_spi_mngr_transaction_t transaction;
+    nrf_spi_mngr_transfer_t    transfers[TRANSFERS_MAX];
+    uint8_t                    tx_buffer[8];
+    uint8_t                    rx_buffer[8];
+    uint32_t                   seq;         // Order of scheduling.
+    uint32_t                   overtaken;   // Transactions started before this one, though scheduled after it.
+    uint32_t                   step;        // Step when the transaction was scheduled.
+    bool                       scheduled;
+    bool                       started;
+} bench_transaction_t;
+
+NRF_SPI_MNGR_DEF(m_spi_mngr, QUEUE_SIZE, 0);
+
+NRF_SPIM_Type               g_spim0;
+uint32_t                    g_gpio_out;
+
+static bench_transaction_t  m_slots[SLOTS];
+static nrf_drv_spi_config_t m_configs[2];
+static uint32_t             m_seq;
+static uint32_t             m_step;
+static uint32_t             m_ended;
+static uint32_t             m_priorities;
+static uint64_t             m_latency[PRIORITIES];
+static uint32_t             m_latency_count[PRIORITIES];
+
+// Simulated SPIM.
+static nrf_drv_spi_evt_handler_t m_spi_handler;
+static void *                    mp_spi_context;
+static nrf_drv_spi_config_t      m_spi_config;      // Configuration given to the last initialization.
+static bool                      m_spi_initialized;
+static bool                      m_spi_busy;
+static uint32_t                  m_spi_inits;
+
+
+
+ret_code_t nrf_drv_spi_init(nrf_drv_spi_t const * const  p_instance,
+                            nrf_drv_spi_config_t const * p_config,
+                            nrf_drv_spi_evt_handler_t    handler,
+                            void *                       p_context)
+{
+    CHECK(!m_spi_initialized);
+
+    m_spi_handler     = handler;
+    mp_spi_context    = p_context;
+    m_spi_config      = *p_config;
+    m_spi_initialized = true;
+    m_spi_inits++;
+
+    nrf_spim_frequency_set(p_instance->u.spim.p_reg, (nrf_spim_frequency_t)p_config->frequency);
+    nrf_spim_configure(p_instance->u.spim.p_reg,
+                       (nrf_spim_mode_t)p_config->mode,
+                       (nrf_spim_bit_order_t)p_config->bit_order);
+    if (p_config->mode <= NRF_DRV_SPI_MODE_1)
+    {
+        nrf_gpio_pin_clear(p_config->sck_pin);
+    }
+    else
+    {
+        nrf_gpio_pin_set(p_config->sck_pin);
+    }
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_spi_uninit(nrf_drv_spi_t const * const p_instance)
+{
+    CHECK(!m_spi_busy);
+    m_spi_initialized = false;
+}
+
+
+ret_code_t nrf_drv_spi_transfer(nrf_drv_spi_t const * const p_instance,
+                                uint8_t const *             p_tx_buffer,
+                                uint8_t                     tx_buffer_length,
+                                uint8_t *                   p_rx_buffer,
+                                uint8_t                     rx_buffer_length)
+{
+    CHECK(m_spi_initialized);
+    if (m_spi_busy)
+    {
+        bench_error_record("transfer started during another one");
+        return NRF_ERROR_BUSY;
+    }
+    m_spi_busy = true;
+    return NRF_SUCCESS;
+}
+
+
+// SPI interrupt at the end of the transfer in progress.
+static void spi_irq(void)
+{
+    nrf_drv_spi_evt_t const event =
+    {
+        .type = NRF_DRV_SPI_EVENT_DONE
+    };
+
+    if (m_spi_busy)
+    {
+        m_spi_busy = false;
+        m_spi_handler(&event, mp_spi_context);
+    }
+}
+
+
+static void transaction_begin(void * p_user_data)
+{
+    bench_transaction_t *        p_slot   = (bench_transaction_t *)p_user_data;
+    nrf_drv_spi_config_t const * p_config = p_slot->transaction.p_required_spi_cfg;
+
+    CHECK(p_slot->scheduled && !p_slot->started);
+    p_slot->started = true;
+
+    // The transaction runs with its own configuration.
+    CHECK(m_spi_initialized);
+    CHECK(g_spim0.FREQUENCY == (uint32_t)p_config->frequency);
+    CHECK(g_spim0.CONFIG == (((uint32_t)p_config->bit_order << 2) | (uint32_t)p_config->mode));
+    CHECK(((g_gpio_out >> SCK_PIN) & 1) == (p_config->mode >= NRF_DRV_SPI_MODE_2));
+    CHECK(m_spi_config.ss_pin == p_config->ss_pin);
+
+    // Transactions scheduled before this one are overtaken.
+    for (uint32_t i = 0; i < SLOTS; i++)
+    {
+        bench_transaction_t * p_other = &m_slots[i];
+
+        if (p_other->scheduled && !p_other->started && (p_other->seq < p_slot->seq))
+        {
+            p_other->overtaken++;
+#if NRF_SPI_MNGR_CONFIG_REORDER
+            CHECK(p_other->overtaken <= NRF_SPI_MNGR_CONFIG_REORDER_MAX_BYPASS);
+#else
+            CHECK(false);
+#endif
+        }
+    }
+
+    m_latency[p_slot->transaction.priority] += m_step - p_slot->step;
+    m_latency_count[p_slot->transaction.priority]++;
+}
+
+
+static void transaction_end(ret_code_t result, void * p_user_data)
+{
+    bench_transaction_t * p_slot = (bench_transaction_t *)p_user_data;
+
+    CHECK(result == NRF_SUCCESS);
+    CHECK(p_slot->scheduled && p_slot->started);
+    p_slot->scheduled = false;
+    m_ended++;
+}
+
+
+static bool transaction_schedule(void)
+{
+    bench_transaction_t * p_slot = NULL;
+
+    for (uint32_t i = 0; i < SLOTS; i++)
+    {
+        if (!m_slots[i].scheduled)
+        {
+            p_slot = &m_slots[i];
+            break;
+        }
+    }
+    if (p_slot == NULL)
+    {
+        return false;
+    }
+
+    uint8_t count = 1 + bench_random() % TRANSFERS_MAX;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        p_slot->transfers[i] = (nrf_spi_mngr_transfer_t)
+            NRF_SPI_MNGR_TRANSFER(p_slot->tx_buffer, 1 + bench_random() % sizeof(p_slot->tx_buffer),
+                                  p_slot->rx_buffer, bench_random() % sizeof(p_slot->rx_buffer));
+    }
+    p_slot->transaction = (nrf_spi_mngr_transaction_t)
+    {
+        .begin_callback      = transaction_begin,
+        .end_callback        = transaction_end,
+        .p_user_data         = p_slot,
+        .p_transfers         = p_slot->transfers,
+        .number_of_transfers = count,
+        .p_required_spi_cfg  = &m_configs[bench_random() % ARRAY_SIZE(m_configs)],
+        .priority            = bench_random() % m_priorities
+    };
+    p_slot->seq       = m_seq;
+    p_slot->step      = m_step;
+    p_slot->overtaken = 0;
+    p_slot->started   = false;
+    p_slot->scheduled = true;
+
+    if (nrf_spi_mngr_schedule(&m_spi_mngr, &p_slot->transaction) != NRF_SUCCESS)
+    {
+        p_slot->scheduled = false;
+        return false;
+    }
+    m_seq++;
+    return true;
+}
+
+
+static void run(char const * p_name, uint32_t transactions, uint32_t priorities)
+{
+    nrf_spi_mngr_stats_t stats;
+    uint32_t             scheduled = 0;
+    uint64_t             start;
+
+    APP_ERROR_CHECK(nrf_spi_mngr_init(&m_spi_mngr, &m_configs[0]));
+    memset(m_latency, 0, sizeof(m_latency));
+    memset(m_latency_count, 0, sizeof(m_latency_count));
+    m_ended      = 0;
+    m_spi_inits  = 0;
+    m_priorities = priorities;
+
+    start = bench_now_ns();
+    while (m_ended < transactions)
+    {
+        for (uint32_t i = bench_random() % 3; (i > 0) && (scheduled < transactions); i--)
+        {
+            if (!transaction_schedule())
+            {
+                break;
+            }
+            scheduled++;
+        }
+        spi_irq();
+        m_step++;
+    }
+    start = bench_now_ns() - start;
+
+    CHECK(nrf_spi_mngr_is_idle(&m_spi_mngr));
+    CHECK(m_ended == scheduled);
+    nrf_spi_mngr_stats_get(&m_spi_mngr, &stats);
+    CHECK(stats.transactions == transactions);
+    CHECK(stats.reinits == m_spi_inits);
+    printf("%s, %u priorities: %u transactions, %u reinitializations, %u register rewrites, "
+           "%u reordered, %u idle gaps, %.0f ns per transaction\n",
+           p_name, priorities, stats.transactions, stats.reinits, stats.fast_reconfigs, stats.reordered,
+           stats.idle_gaps, (double)start / transactions);
+    printf("%s, %u priorities: latency in steps by priority:", p_name, priorities);
+    for (uint32_t i = 0; i < priorities; i++)
+    {
+        printf(" %u: %.2f", i, m_latency_count[i] ? (double)m_latency[i] / m_latency_count[i] : 0.0);
+    }
+    printf("\n");
+
+    nrf_spi_mngr_uninit(&m_spi_mngr);
+}
+
+
+static void user_function(void)
+{
+    spi_irq();
+}
+
+
+static void test_perform(void)
+{
+    static uint8_t                tx_buffer[4];
+    nrf_spi_mngr_transfer_t const transfers[] =
+    {
+        NRF_SPI_MNGR_TRANSFER(tx_buffer, sizeof(tx_buffer), NULL, 0),
+        NRF_SPI_MNGR_TRANSFER(tx_buffer, sizeof(tx_buffer), NULL, 0)
+    };
+
+    APP_ERROR_CHECK(nrf_spi_mngr_init(&m_spi_mngr, &m_configs[0]));
+    CHECK(nrf_spi_mngr_perform(&m_spi_mngr, &m_configs[1], transfers, ARRAY_SIZE(transfers),
+                               user_function) == NRF_SUCCESS);
+    CHECK(nrf_spi_mngr_is_idle(&m_spi_mngr));
+    CHECK(g_spim0.FREQUENCY == (uint32_t)m_configs[1].frequency);
+    nrf_spi_mngr_uninit(&m_spi_mngr);
+}
+
+
+int main(int argc, char ** argv)
+{
+    uint32_t const transactions = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1000000;
+
+    nrf_drv_spi_config_t const flash_config =
+    {
+        .sck_pin      = SCK_PIN,
+        .mosi_pin     = MOSI_PIN,
+        .miso_pin     = MISO_PIN,
+        .ss_pin       = NRF_DRV_SPI_PIN_NOT_USED,
+        .irq_priority = 6,
+        .orc          = 0xFF,
+        .frequency    = NRF_DRV_SPI_FREQ_8M,
+        .mode         = NRF_DRV_SPI_MODE_0,
+        .bit_order    = NRF_DRV_SPI_BIT_ORDER_MSB_FIRST
+    };
+    nrf_drv_spi_config_t const display_config =
+    {
+        .sck_pin      = SCK_PIN,
+        .mosi_pin     = MOSI_PIN,
+        .miso_pin     = MISO_PIN,
+        .ss_pin       = NRF_DRV_SPI_PIN_NOT_USED,
+        .irq_priority = 6,
+        .orc          = 0xFF,
+        .frequency    = NRF_DRV_SPI_FREQ_4M,
+        .mode         = NRF_DRV_SPI_MODE_3,
+        .bit_order    = NRF_DRV_SPI_BIT_ORDER_MSB_FIRST
+    };
+
+#if NRF_SPI_MNGR_CONFIG_REORDER
+    printf("reorder, at most %u bypasses\n", NRF_SPI_MNGR_CONFIG_REORDER_MAX_BYPASS);
+#else
+    printf("order of scheduling\n");
+#endif
+
+    m_configs[0] = flash_config;
+    m_configs[1] = display_config;
+    test_perform();
+    run("shared pins", transactions, 1);
+    run("shared pins", transactions, PRIORITIES);
+
+    m_configs[0].ss_pin = FLASH_SS_PIN;
+    m_configs[1].ss_pin = DISPLAY_SS_PIN;
+    run("own SS pins", transactions, 1);
+    run("own SS pins", transactions, PRIORITIES);
+
+    if (bench_failed())
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
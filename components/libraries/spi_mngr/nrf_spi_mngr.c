@@ -42,6 +42,7 @@
 #if NRF_MODULE_ENABLED(NRF_SPI_MNGR)
 #include "nrf_spi_mngr.h"
 #include "nrf_assert.h"
+#include "nrf_gpio.h"
 #include "app_util_platform.h"
 
 typedef volatile struct
@@ -102,6 +103,153 @@ static void spi_event_handler(nrf_drv_spi_evt_t const * p_event,
                               void *                    p_context);
 
 
+static nrf_drv_spi_config_t const * transaction_config_get(nrf_spi_mngr_cb_t const *          p_cb,
+                                                           nrf_spi_mngr_transaction_t const * p_transaction)
+{
+    if (p_transaction->p_required_spi_cfg == NULL)
+    {
+        return &p_cb->default_configuration;
+    }
+    return p_transaction->p_required_spi_cfg;
+}
+
+
+static bool config_equal(nrf_drv_spi_config_t const * p_config_a,
+                         nrf_drv_spi_config_t const * p_config_b)
+{
+    return (p_config_a == p_config_b) ||
+           (memcmp(p_config_a, p_config_b, sizeof(*p_config_a)) == 0);
+}
+
+
+// Configurations which differ only in the parameters held by the FREQUENCY and CONFIG registers
+// can be switched without reinitializing the driver.
+static bool config_fast_change_possible(nrf_drv_spi_config_t const * p_config_a,
+                                        nrf_drv_spi_config_t const * p_config_b)
+{
+    return (p_config_a->sck_pin      == p_config_b->sck_pin)      &&
+           (p_config_a->mosi_pin     == p_config_b->mosi_pin)     &&
+           (p_config_a->miso_pin     == p_config_b->miso_pin)     &&
+           (p_config_a->ss_pin       == p_config_b->ss_pin)       &&
+           (p_config_a->irq_priority == p_config_b->irq_priority) &&
+           (p_config_a->orc          == p_config_b->orc);
+}
+
+
+static void config_fast_change(nrf_drv_spi_t const *        p_instance,
+                               nrf_drv_spi_config_t const * p_config)
+{
+    if (NRF_DRV_SPI_USE_SPIM)
+    {
+    #ifdef SPIM_PRESENT
+        NRF_SPIM_Type * p_spim = p_instance->u.spim.p_reg;
+
+        nrf_spim_frequency_set(p_spim, (nrf_spim_frequency_t)p_config->frequency);
+        nrf_spim_configure(p_spim,
+                           (nrf_spim_mode_t)p_config->mode,
+                           (nrf_spim_bit_order_t)p_config->bit_order);
+    #endif
+    }
+    else if (NRF_DRV_SPI_USE_SPI)
+    {
+    #ifdef SPI_PRESENT
+        NRF_SPI_Type * p_spi = p_instance->u.spi.p_reg;
+
+        nrf_spi_frequency_set(p_spi, (nrf_spi_frequency_t)p_config->frequency);
+        nrf_spi_configure(p_spi,
+                          (nrf_spi_mode_t)p_config->mode,
+                          (nrf_spi_bit_order_t)p_config->bit_order);
+    #endif
+    }
+
+    // Idle level of SCK when the pin is not driven by the peripheral, as set by the driver
+    // initialization.
+    if (p_config->mode <= NRF_DRV_SPI_MODE_1)
+    {
+        nrf_gpio_pin_clear(p_config->sck_pin);
+    }
+    else
+    {
+        nrf_gpio_pin_set(p_config->sck_pin);
+    }
+}
+
+
+#if NRF_SPI_MNGR_CONFIG_REORDER
+// This function takes the next transaction out of the pending ones, after refilling them from
+// the queue. It must be called in a critical region.
+static nrf_spi_mngr_transaction_t const * pending_transaction_pop(
+    nrf_spi_mngr_t const * p_nrf_spi_mngr)
+{
+    nrf_spi_mngr_cb_t *      p_cb      = p_nrf_spi_mngr->p_nrf_spi_mngr_cb;
+    nrf_spi_mngr_pending_t * p_pending = p_nrf_spi_mngr->p_pending;
+    uint8_t                  count     = p_cb->pending_count;
+    uint8_t                  selected  = 0;
+    uint8_t                  idx;
+
+    while ((count < p_nrf_spi_mngr->p_queue->size) &&
+           (nrf_queue_pop(p_nrf_spi_mngr->p_queue, (void *)(&p_pending[count].p_transaction))
+            == NRF_SUCCESS))
+    {
+        p_pending[count].bypass_count = 0;
+        count++;
+    }
+
+    if (count == 0)
+    {
+        return NULL;
+    }
+
+    // A transaction is overtaken whenever one of the transactions scheduled after it is, so the
+    // first one is always the most overtaken.
+    if (p_pending[0].bypass_count < NRF_SPI_MNGR_CONFIG_REORDER_MAX_BYPASS)
+    {
+        nrf_spi_mngr_transaction_t const * p_best = p_pending[0].p_transaction;
+        bool best_config_equal =
+            config_equal(transaction_config_get(p_cb, p_best), p_cb->p_current_configuration);
+
+        for (idx = 1; idx < count; idx++)
+        {
+            nrf_spi_mngr_transaction_t const * p_candidate = p_pending[idx].p_transaction;
+
+            if (p_candidate->priority < p_best->priority)
+            {
+                continue;
+            }
+
+            bool candidate_config_equal = config_equal(transaction_config_get(p_cb, p_candidate),
+                                                       p_cb->p_current_configuration);
+
+            if ((p_candidate->priority > p_best->priority) ||
+                (candidate_config_equal && !best_config_equal))
+            {
+                selected          = idx;
+                p_best            = p_candidate;
+                best_config_equal = candidate_config_equal;
+            }
+        }
+    }
+
+    nrf_spi_mngr_transaction_t const * p_transaction = p_pending[selected].p_transaction;
+    if (selected != 0)
+    {
+        p_cb->stats.reordered++;
+    }
+    for (idx = 0; idx < selected; idx++)
+    {
+        p_pending[idx].bypass_count++;
+    }
+    for (idx = selected + 1; idx < count; idx++)
+    {
+        p_pending[idx - 1] = p_pending[idx];
+    }
+    p_cb->pending_count = count - 1;
+
+    return p_transaction;
+}
+#endif
+
+
 // This function starts pending transaction if there is no current one or
 // when 'switch_transaction' parameter is set to true. It is important to
 // switch to new transaction without setting 'p_nrf_spi_mngr->p_curr_transaction'
@@ -120,14 +268,24 @@ static void start_pending_transaction(nrf_spi_mngr_t const * p_nrf_spi_mngr,
         CRITICAL_REGION_ENTER();
         if (switch_transaction || nrf_spi_mngr_is_idle(p_nrf_spi_mngr))
         {
+#if NRF_SPI_MNGR_CONFIG_REORDER
+            p_cb->p_current_transaction = pending_transaction_pop(p_nrf_spi_mngr);
+            if (p_cb->p_current_transaction != NULL)
+#else
             if (nrf_queue_pop(p_nrf_spi_mngr->p_queue,
                               (void *)(&p_cb->p_current_transaction))
                 == NRF_SUCCESS)
+#endif
             {
                 start_transaction = true;
+                p_cb->stats.transactions++;
             }
             else
             {
+                if (switch_transaction)
+                {
+                    p_cb->stats.idle_gaps++;
+                }
                 p_cb->p_current_transaction = NULL;
             }
         }
@@ -138,26 +296,28 @@ static void start_pending_transaction(nrf_spi_mngr_t const * p_nrf_spi_mngr,
             return;
         }
 
-        nrf_drv_spi_config_t const * p_instance_cfg;
-        if (p_cb->p_current_transaction->p_required_spi_cfg == NULL)
-        {
-            p_instance_cfg = &p_cb->default_configuration;
-        }
-        else
-        {
-            p_instance_cfg = p_cb->p_current_transaction->p_required_spi_cfg;
-        }
+        nrf_drv_spi_config_t const * p_instance_cfg =
+            transaction_config_get(p_cb, p_cb->p_current_transaction);
 
         ret_code_t result;
 
-        if (memcmp(p_cb->p_current_configuration, p_instance_cfg, sizeof(*p_instance_cfg)) != 0)
+        if (!config_equal(p_cb->p_current_configuration, p_instance_cfg))
         {
-            nrf_drv_spi_uninit(&p_nrf_spi_mngr->spi);
-            result = nrf_drv_spi_init(&p_nrf_spi_mngr->spi,
-                                      p_instance_cfg,
-                                      spi_event_handler,
-                                      (void *)p_nrf_spi_mngr);
-            ASSERT(result == NRF_SUCCESS);
+            if (config_fast_change_possible(p_cb->p_current_configuration, p_instance_cfg))
+            {
+                config_fast_change(&p_nrf_spi_mngr->spi, p_instance_cfg);
+                p_cb->stats.fast_reconfigs++;
+            }
+            else
+            {
+                nrf_drv_spi_uninit(&p_nrf_spi_mngr->spi);
+                result = nrf_drv_spi_init(&p_nrf_spi_mngr->spi,
+                                          p_instance_cfg,
+                                          spi_event_handler,
+                                          (void *)p_nrf_spi_mngr);
+                ASSERT(result == NRF_SUCCESS);
+                p_cb->stats.reinits++;
+            }
             p_cb->p_current_configuration = p_instance_cfg;
         }
 
@@ -261,6 +421,8 @@ ret_code_t nrf_spi_mngr_init(nrf_spi_mngr_t const *       p_nrf_spi_mngr,
         p_cb->p_current_transaction = NULL;
         p_cb->default_configuration = *p_default_spi_config;
         p_cb->p_current_configuration = &p_cb->default_configuration;
+        p_cb->pending_count = 0;
+        memset(&p_cb->stats, 0, sizeof(p_cb->stats));
     }
 
     return err_code;
@@ -274,6 +436,7 @@ void nrf_spi_mngr_uninit(nrf_spi_mngr_t const * p_nrf_spi_mngr)
     nrf_drv_spi_uninit(&p_nrf_spi_mngr->spi);
 
     p_nrf_spi_mngr->p_nrf_spi_mngr_cb->p_current_transaction = NULL;
+    p_nrf_spi_mngr->p_nrf_spi_mngr_cb->pending_count = 0;
 }
 
 
@@ -327,7 +490,8 @@ ret_code_t nrf_spi_mngr_perform(nrf_spi_mngr_t const *          p_nrf_spi_mngr,
         .p_user_data         = (void *)&cb_data,
         .p_transfers         = p_transfers,
         .number_of_transfers = number_of_transfers,
-        .p_required_spi_cfg  = p_config
+        .p_required_spi_cfg  = p_config,
+        .priority            = 0
     };
 
     ret_code_t result = nrf_spi_mngr_schedule(p_nrf_spi_mngr, &internal_transaction);
@@ -344,5 +508,27 @@ ret_code_t nrf_spi_mngr_perform(nrf_spi_mngr_t const *          p_nrf_spi_mngr,
     return cb_data.transaction_result;
 }
 
+
+void nrf_spi_mngr_stats_get(nrf_spi_mngr_t const * p_nrf_spi_mngr,
+                            nrf_spi_mngr_stats_t * p_stats)
+{
+    ASSERT(p_nrf_spi_mngr != NULL);
+    ASSERT(p_stats != NULL);
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = p_nrf_spi_mngr->p_nrf_spi_mngr_cb->stats;
+    CRITICAL_REGION_EXIT();
+}
+
+
+void nrf_spi_mngr_stats_reset(nrf_spi_mngr_t const * p_nrf_spi_mngr)
+{
+    ASSERT(p_nrf_spi_mngr != NULL);
+
+    CRITICAL_REGION_ENTER();
+    memset(&p_nrf_spi_mngr->p_nrf_spi_mngr_cb->stats, 0, sizeof(nrf_spi_mngr_stats_t));
+    CRITICAL_REGION_EXIT();
+}
+
 #endif //NRF_MODULE_ENABLED(NRF_SPI_MNGR)
 
@@ -61,6 +61,14 @@ extern "C" {
 #endif
 /*lint -restore*/
 
+#ifndef NRF_SPI_MNGR_CONFIG_REORDER
+#define NRF_SPI_MNGR_CONFIG_REORDER 0               ///< Let transactions go ahead of the ones scheduled before them, see @ref nrf_spi_mngr_schedule.
+#endif
+
+#ifndef NRF_SPI_MNGR_CONFIG_REORDER_MAX_BYPASS
+#define NRF_SPI_MNGR_CONFIG_REORDER_MAX_BYPASS 4    ///< Maximum number of transactions that can go ahead of a transaction scheduled before them.
+#endif
+
 /**
  * @defgroup nrf_spi_mngr SPI transaction manager
  * @{
@@ -140,9 +148,39 @@ typedef struct
 
     nrf_drv_spi_config_t const *    p_required_spi_cfg;
     ///< Pointer to instance hardware configuration.
+
+    uint8_t                         priority;
+    ///< Priority of the transaction, the higher value first. Only used if
+    ///< @ref NRF_SPI_MNGR_CONFIG_REORDER is set.
 } nrf_spi_mngr_transaction_t;
 
 
+/**
+ * @brief SPI transaction manager statistics.
+ */
+typedef struct
+{
+    uint32_t transactions;      ///< Number of transactions started.
+    uint32_t reinits;           ///< Number of configuration changes done by reinitializing the driver.
+    uint32_t fast_reconfigs;    ///< Number of configuration changes done by only rewriting registers.
+    uint32_t reordered;         ///< Number of transactions started before others scheduled earlier.
+    uint32_t idle_gaps;         ///< Number of times the bus went idle after a transaction.
+} nrf_spi_mngr_stats_t;
+
+
+/**
+ * @brief Transaction taken out of the queue, waiting to be started.
+ */
+typedef struct
+{
+    nrf_spi_mngr_transaction_t const * p_transaction;
+    ///< Pending transaction.
+
+    uint8_t                            bypass_count;
+    ///< Number of transactions started before this one, though scheduled after it.
+} nrf_spi_mngr_pending_t;
+
+
 /**
  * @brief SPI instance control block.
  */
@@ -159,6 +197,12 @@ typedef struct
 
     uint8_t volatile                            current_transfer_idx;
     ///< Index of currently performed transfer (within current transaction).
+
+    uint8_t                                     pending_count;
+    ///< Number of transactions taken out of the queue and not yet started.
+
+    nrf_spi_mngr_stats_t                        stats;
+    ///< Statistics of the instance.
 } nrf_spi_mngr_cb_t;
 
 
@@ -175,6 +219,11 @@ typedef struct
 
     nrf_drv_spi_t       spi;
     ///< Pointer to SPI master driver instance.
+
+#if NRF_SPI_MNGR_CONFIG_REORDER
+    nrf_spi_mngr_pending_t * p_pending;
+    ///< Transactions taken out of the queue to choose the next one from, as many as the queue size.
+#endif
 } nrf_spi_mngr_t;
 
 
@@ -196,6 +245,23 @@ typedef struct
  *                                  of pending transactions).
  * @param[in]  _spi_idx             Index of hardware SPI instance to be used.
  */
+#if NRF_SPI_MNGR_CONFIG_REORDER
+#define NRF_SPI_MNGR_DEF(_nrf_spi_mngr_name, _queue_size, _spi_idx) \
+    NRF_QUEUE_DEF(nrf_spi_mngr_transaction_t const *,               \
+                 _nrf_spi_mngr_name##_queue,                        \
+                 (_queue_size),                                     \
+                 NRF_QUEUE_MODE_NO_OVERFLOW);                       \
+    static nrf_spi_mngr_pending_t                                   \
+        CONCAT_2(_nrf_spi_mngr_name, _pending)[(_queue_size)];      \
+    static nrf_spi_mngr_cb_t CONCAT_2(_nrf_spi_mngr_name, _cb);     \
+    static const nrf_spi_mngr_t _nrf_spi_mngr_name =                \
+    {                                                               \
+        .p_nrf_spi_mngr_cb = &CONCAT_2(_nrf_spi_mngr_name, _cb),    \
+        .p_queue      = &_nrf_spi_mngr_name##_queue,                \
+        .spi          = NRF_DRV_SPI_INSTANCE(_spi_idx),             \
+        .p_pending    = CONCAT_2(_nrf_spi_mngr_name, _pending)      \
+    }
+#else
 #define NRF_SPI_MNGR_DEF(_nrf_spi_mngr_name, _queue_size, _spi_idx) \
     NRF_QUEUE_DEF(nrf_spi_mngr_transaction_t const *,               \
                  _nrf_spi_mngr_name##_queue,                        \
@@ -208,6 +274,7 @@ typedef struct
         .p_queue      = &_nrf_spi_mngr_name##_queue,                \
         .spi          = NRF_DRV_SPI_INSTANCE(_spi_idx)              \
     }
+#endif
 
 
  /**
@@ -239,12 +306,23 @@ void nrf_spi_mngr_uninit(nrf_spi_mngr_t const * p_nrf_spi_mngr);
  * available, thus when all previously scheduled transactions have been
  * finished (possibly immediately).
  *
+ * If @ref NRF_SPI_MNGR_CONFIG_REORDER is set, the transactions do not start strictly in
+ * the order they were scheduled. The next transaction is the one of highest
+ * @ref nrf_spi_mngr_transaction_t::priority, and among those, the first one which needs
+ * the current configuration, so that transactions with the same configuration run in a
+ * row. A transaction which was overtaken @ref NRF_SPI_MNGR_CONFIG_REORDER_MAX_BYPASS times
+ * is started before any other.
+ *
  * @note If @ref nrf_spi_mngr_transaction_t::p_required_spi_cfg
  *       is set to a non-NULL value the module will compare it with
  *       @ref nrf_spi_mngr_cb_t::p_current_configuration and reinitialize hardware
  *       SPI instance with new parameters if any differences are found.
  *       If @ref nrf_spi_mngr_transaction_t::p_required_spi_cfg is set to NULL then
  *       it will treat it as it would be set to @ref nrf_spi_mngr_cb_t::default_configuration.
+ *       If only the frequency, mode or bit order differ, the registers holding them are
+ *       rewritten instead of reinitializing the instance. Devices sharing the bus should
+ *       therefore use the same pins, and drive their Slave Select pins in the transaction
+ *       callbacks rather than through @ref nrf_drv_spi_config_t::ss_pin.
  *
  * @param[in] p_nrf_spi_mngr    Pointer to the SPI transaction manager instance.
  * @param[in] p_transaction     Pointer to the descriptor of the transaction to be
@@ -298,6 +376,25 @@ __STATIC_INLINE bool nrf_spi_mngr_is_idle(nrf_spi_mngr_t const * p_nrf_spi_mngr)
     return (p_nrf_spi_mngr->p_nrf_spi_mngr_cb->p_current_transaction == NULL);
 }
 
+
+/**
+ * @brief Function for getting the statistics of an SPI transaction manager instance.
+ *
+ * @param[in]  p_nrf_spi_mngr Pointer to the SPI transaction manager instance.
+ * @param[out] p_stats        Statistics since the instance was initialized or the statistics
+ *                            were reset.
+ */
+void nrf_spi_mngr_stats_get(nrf_spi_mngr_t const * p_nrf_spi_mngr,
+                            nrf_spi_mngr_stats_t * p_stats);
+
+
+/**
+ * @brief Function for resetting the statistics of an SPI transaction manager instance.
+ *
+ * @param[in] p_nrf_spi_mngr Pointer to the SPI transaction manager instance.
+ */
+void nrf_spi_mngr_stats_reset(nrf_spi_mngr_t const * p_nrf_spi_mngr);
+
 /**
  *@}
  **/
@@ -139,6 +139,7 @@ typedef struct
     nrf_sortlist_item_t         list_item;     /**< Token used by sortlist. */
     volatile uint32_t           end_val;       /**< RTC counter value when timer expires. */
     uint32_t                    repeat_period; /**< Repeat period (0 if single shot mode). */
+    uint32_t                    slack;         /**< Ticks the timer may expire late to share a wakeup. */
     app_timer_timeout_handler_t handler;       /**< User handler. */
     void *                      p_context;     /**< User context. */
     NRF_LOG_INSTANCE_PTR_DECLARE(p_log)        /**< Pointer to instance of the logger object (Conditionally compiled). */
@@ -162,6 +163,32 @@ typedef app_timer_t * app_timer_id_t;
     };                                                                                        \
     static const app_timer_id_t timer_id = &CONCAT_2(timer_id,_data)
 
+#elif defined(APP_TIMER_WHEEL)
+/**
+ * @brief app_timer control block
+ */
+typedef struct app_timer_s
+{
+    struct app_timer_s *        p_next;        /**< Next timer in the same slot of the timing wheel. */
+    struct app_timer_s *        p_prev;        /**< Previous timer in the same slot of the timing wheel. */
+    volatile uint32_t           end_val;       /**< RTC counter value when timer expires. */
+    uint32_t                    expiry;        /**< Expiration time on the 32 bit time line of the wheel. */
+    uint32_t                    slot_min;      /**< Earliest expiration of this and the next timers in the slot. */
+    uint32_t                    repeat_period; /**< Repeat period (0 if single shot mode). */
+    app_timer_timeout_handler_t handler;       /**< User handler. */
+    void *                      p_context;     /**< User context. */
+    uint8_t                     slot;          /**< Wheel slot holding the timer plus one, 0 if none. */
+    volatile bool               active;        /**< Flag indicating that timer is active. */
+} app_timer_t;
+
+/**@brief Timer ID type.
+ * Never declare a variable of this type, but use the macro @ref APP_TIMER_DEF instead.*/
+typedef app_timer_t * app_timer_id_t;
+
+#define _APP_TIMER_DEF(timer_id)                                      \
+    static app_timer_t CONCAT_2(timer_id,_data) = { .active = false }; \
+    static const app_timer_id_t timer_id = &CONCAT_2(timer_id,_data)
+
 #else //APP_TIMER_V2
 typedef struct app_timer_t { uint32_t data[CEIL_DIV(APP_TIMER_NODE_SIZE, sizeof(uint32_t))]; } app_timer_t;
 
@@ -261,6 +288,33 @@ ret_code_t app_timer_stop(app_timer_id_t timer_id);
  */
 ret_code_t app_timer_stop_all(void);
 
+#ifdef APP_TIMER_V2
+/**@brief Function for setting the slack of a timer.
+ *
+ * A timer with slack may expire up to @p slack_ticks after its timeout. When the tolerance windows
+ * of several timers overlap, they expire together on a single RTC compare event, so that the CPU
+ * wakes up once instead of once per timer. The slack is taken into account from the next time the
+ * timer is scheduled. It is 0 for a new timer.
+ *
+ * @param[in]  timer_id                  Timer identifier.
+ * @param[in]  slack_ticks               Number of ticks the time-out may be delayed.
+ *
+ * @retval     NRF_SUCCESS               If the slack was set.
+ * @retval     NRF_ERROR_INVALID_PARAM   If the slack was longer than the maximum timeout.
+ */
+ret_code_t app_timer_slack_set(app_timer_id_t timer_id, uint32_t slack_ticks);
+
+/**@brief Function for getting the number of RTC wakeups avoided thanks to the slack of timers.
+ *
+ * A wakeup is counted as avoided for each timer which expired on the compare event of another
+ * timer, with an end value before that event and different from the end values of the timers
+ * which expired on the same event before it.
+ *
+ * @return Number of wakeups avoided since the module was initialized.
+ */
+uint32_t app_timer_wakeups_avoided_get(void);
+#endif
+
 /**@brief Function for returning the current value of the RTC1 counter.
  *
  * @return    Current value of the RTC1 counter.
@@ -0,0 +1,631 @@
+/**
+ * Copyright (c) 2018 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Test and benchmark of the application timers on a simulated RTC, for app_timer2.c, which keeps
+ * the timers in a sorted list, or app_timer_wheel.c, which keeps them in a timing wheel.
+ *
+ * Build it on host from this directory, for one backend or the other:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I../experimental -I$L/util -I$L/log -I$L/log/src \
+ *      -I$L/strerror -I$L/sortlist -DAPP_TIMER_V2 app_timer_bench.c ../experimental/app_timer2.c \
+ *      $L/sortlist/nrf_sortlist.c $L/bench_host/bench.c -o app_timer2_bench
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I../experimental -I$L/util -I$L/log -I$L/log/src \
+ *      -I$L/strerror -DAPP_TIMER_WHEEL app_timer_bench.c ../experimental/app_timer_wheel.c \
+ *      $L/bench_host/bench.c -o app_timer_wheel_bench
+ *
+ * Usage: app_timer_bench [expirations]
+ *
+ * The RTC driver is replaced by a simulation of the counter, the overflow event and the compare
+ * channel, and the RTC interrupt is called from the main loop whenever it is pending, after a
+ * random latency. The simulated time jumps from one event to the next, so days of RTC time run in
+ * seconds.
+ *
+ * First, timers of both modes are started and stopped at random, by the thread and by their own
+ * handlers, with timeouts from a few ticks up to the maximum. Every timer must expire once per
+ * start or period, not before its time (give or take the ticks of the compare channel) and not
+ * later than the interrupt latency, and never after it was stopped. A run of long timers then
+ * takes the counter over many overflows, and over the 32 bit time of the wheel. Then all timers
+ * are stopped at once. With app_timer2.c, timers also get random slack, by which they may expire
+ * late, and periodic timers are run with and without slack to count the wakeups it saves.
+ *
+ * Then, for 10, 100 and 1000 running timers, the time spent in the RTC interrupt is measured while
+ * repeated timers expire, and while timers are stopped and started again.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sdk_common.h"
+#include "app_timer.h"
+#include "drv_rtc.h"
+#include "bench.h"
+
+
+#define TIMERS_MAX          1000
+#define LATENCY_MAX         8           // Maximum latency of the RTC interrupt, in ticks.
+#define EARLY_MAX           2           // Ticks before its time a timer can expire, when too close for the compare channel.
+#define TIMEOUT_MAX         (DRV_RTC_MAX_CNT - APP_TIMER_TICKS(APP_TIMER_SAFE_WINDOW_MS))
+#define BENCH_OPERATIONS    100000
+
+typedef struct
+{
+    app_timer_t data;
+    uint64_t    expected;   // Simulated time of the next expiration.
+    uint32_t    period;     // Period in repeated mode, 0 in single shot mode.
+    uint32_t    slack;
+    bool        armed;
+    bool        restart;    // Restart from the handler in single shot mode.
+} bench_timer_t;
+
+static bench_timer_t        m_timers[TIMERS_MAX];
+static uint32_t             m_timer_count;
+
+// Simulated RTC.
+static drv_rtc_handler_t    m_rtc_handler;
+static drv_rtc_t const *    mp_rtc_instance;
+static uint64_t             m_ticks;            // Ticks counted since the start, while running.
+static uint32_t             m_cc;
+static bool                 m_running;
+static bool                 m_compare_irq;
+static bool                 m_compare_evt;
+static bool                 m_overflow_evt;
+static bool                 m_irq_pending;
+static uint32_t             m_latency_max;
+
+static uint64_t             m_irqs;
+static uint64_t             m_irq_ns;
+static uint64_t             m_expirations;
+static bool                 m_measure;
+
+
+
+ret_code_t drv_rtc_init(drv_rtc_t const * const  p_instance,
+                        drv_rtc_config_t const * p_config,
+                        drv_rtc_handler_t        handler)
+{
+    mp_rtc_instance = p_instance;
+    m_rtc_handler   = handler;
+    return NRF_SUCCESS;
+}
+
+
+void drv_rtc_overflow_enable(drv_rtc_t const * const p_instance, bool irq_enable)
+{
+}
+
+
+void drv_rtc_start(drv_rtc_t const * const p_instance)
+{
+    m_running = true;
+}
+
+
+void drv_rtc_stop(drv_rtc_t const * const p_instance)
+{
+    m_running = false;
+}
+
+
+uint32_t drv_rtc_counter_get(drv_rtc_t const * const p_instance)
+{
+    return (uint32_t)m_ticks & DRV_RTC_MAX_CNT;
+}
+
+
+// Same decision as the driver. The compare event is only simulated with its interrupt enabled.
+ret_code_t drv_rtc_windowed_compare_set(drv_rtc_t const * const p_instance,
+                                        uint32_t                cc,
+                                        uint32_t                abs_value,
+                                        uint32_t                safe_window)
+{
+    int32_t diff = (int32_t)(((abs_value - drv_rtc_counter_get(p_instance)) & DRV_RTC_MAX_CNT) << 8) >> 8;
+
+    m_cc          = abs_value & DRV_RTC_MAX_CNT;
+    m_compare_evt = false;
+    m_compare_irq = !((diff > -(int32_t)(safe_window & DRV_RTC_MAX_CNT)) && (diff <= EARLY_MAX));
+    return m_compare_irq ? NRF_SUCCESS : NRF_ERROR_TIMEOUT;
+}
+
+
+bool drv_rtc_compare_pending(drv_rtc_t const * const p_instance, uint32_t cc)
+{
+    bool pending = m_compare_evt;
+    m_compare_evt = false;
+    return pending;
+}
+
+
+bool drv_rtc_overflow_pending(drv_rtc_t const * const p_instance)
+{
+    bool pending = m_overflow_evt;
+    m_overflow_evt = false;
+    return pending;
+}
+
+
+void drv_rtc_irq_trigger(drv_rtc_t const * const p_instance)
+{
+    m_irq_pending = true;
+}
+
+
+/* Runs the counter for the given ticks, at most one period, and raises the events it meets. */
+static void rtc_advance(uint32_t ticks)
+{
+    uint32_t counter = (uint32_t)m_ticks & DRV_RTC_MAX_CNT;
+
+    if (!m_running)
+    {
+        return;
+    }
+    if (m_compare_irq && (((m_cc - counter - 1) & DRV_RTC_MAX_CNT) < ticks))
+    {
+        m_compare_evt = true;
+        m_irq_pending = true;
+    }
+    if (counter + ticks > DRV_RTC_MAX_CNT)
+    {
+        m_overflow_evt = true;
+        m_irq_pending  = true;
+    }
+    m_ticks += ticks;
+}
+
+
+static void rtc_irq_call(void)
+{
+    uint64_t start = 0;
+
+    m_irq_pending = false;
+    if (m_measure)
+    {
+        start = bench_now_ns();
+    }
+    m_rtc_handler(mp_rtc_instance);
+    if (m_measure)
+    {
+        m_irq_ns += bench_now_ns() - start;
+    }
+    m_irqs++;
+}
+
+
+/* Runs the simulation until the given time or until the RTC is stopped. */
+static void rtc_run(uint64_t end)
+{
+    for (;;)
+    {
+        if (m_irq_pending)
+        {
+            if (m_latency_max != 0)
+            {
+                rtc_advance(bench_random() % (m_latency_max + 1));
+            }
+            rtc_irq_call();
+            continue;
+        }
+        if (!m_running || (m_ticks >= end))
+        {
+            return;
+        }
+
+        uint32_t counter = (uint32_t)m_ticks & DRV_RTC_MAX_CNT;
+        uint64_t ticks   = DRV_RTC_MAX_CNT + 1 - counter;
+
+        if (m_compare_irq && (((m_cc - counter - 1) & DRV_RTC_MAX_CNT) + 1 < ticks))
+        {
+            ticks = ((m_cc - counter - 1) & DRV_RTC_MAX_CNT) + 1;
+        }
+        if (end - m_ticks < ticks)
+        {
+            ticks = end - m_ticks;
+        }
+        rtc_advance((uint32_t)ticks);
+    }
+}
+
+
+/* Makes the pending requests processed, without time passing. */
+static void rtc_irq_flush(void)
+{
+    while (m_irq_pending)
+    {
+        rtc_irq_call();
+    }
+}
+
+
+static void timeout_handler(void * p_context)
+{
+    bench_timer_t * p_timer = (bench_timer_t *)p_context;
+    int64_t         late    = (int64_t)(m_ticks - p_timer->expected);
+
+    CHECK(p_timer->armed);
+    CHECK(late >= -EARLY_MAX);
+    CHECK(late <= (int64_t)(m_latency_max + p_timer->slack));
+    m_expirations++;
+
+    if (p_timer->period != 0)
+    {
+        p_timer->expected += p_timer->period;
+    }
+    else
+    {
+        p_timer->armed = false;
+        if (p_timer->restart)
+        {
+            uint32_t timeout = 1 + bench_random() % 1000;
+
+            p_timer->armed    = true;
+            p_timer->expected = m_ticks + timeout;
+            APP_ERROR_CHECK(app_timer_start(&p_timer->data, timeout, p_timer));
+        }
+    }
+}
+
+
+static void bench_timer_create(bench_timer_t * p_timer, bool repeated)
+{
+    app_timer_id_t timer_id = &p_timer->data;
+
+    p_timer->armed = false;
+    p_timer->slack = 0;
+    APP_ERROR_CHECK(app_timer_create(&timer_id,
+                                     repeated ? APP_TIMER_MODE_REPEATED : APP_TIMER_MODE_SINGLE_SHOT,
+                                     timeout_handler));
+#if defined(APP_TIMER_V2)
+    APP_ERROR_CHECK(app_timer_slack_set(timer_id, 0));
+#endif
+}
+
+
+#if defined(APP_TIMER_V2)
+static void bench_timer_slack_set(bench_timer_t * p_timer, uint32_t slack)
+{
+    p_timer->slack = slack;
+    APP_ERROR_CHECK(app_timer_slack_set(&p_timer->data, slack));
+}
+#endif
+
+
+static void bench_timer_start(bench_timer_t * p_timer, uint32_t timeout)
+{
+    p_timer->armed    = true;
+    p_timer->expected = m_ticks + timeout;
+    p_timer->period   = (p_timer->period != 0) ? timeout : 0;
+    APP_ERROR_CHECK(app_timer_start(&p_timer->data, timeout, p_timer));
+    rtc_irq_flush();
+}
+
+
+static void bench_timer_stop(bench_timer_t * p_timer)
+{
+    p_timer->armed = false;
+    APP_ERROR_CHECK(app_timer_stop(&p_timer->data));
+    rtc_irq_flush();
+}
+
+
+static void timers_create(uint32_t count, uint32_t repeated_percent)
+{
+    m_timer_count = count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        bool repeated = (bench_random() % 100) < repeated_percent;
+
+        m_timers[i].period  = repeated ? 1 : 0;
+        m_timers[i].restart = !repeated && (bench_random() & 1);
+        bench_timer_create(&m_timers[i], repeated);
+    }
+}
+
+
+static void timers_stop_all(void)
+{
+    APP_ERROR_CHECK(app_timer_stop_all());
+    for (uint32_t i = 0; i < m_timer_count; i++)
+    {
+        m_timers[i].armed = false;
+    }
+    rtc_irq_flush();
+}
+
+
+/* Checks that no armed timer is overdue, which would mean that it was lost. */
+static void timers_check(void)
+{
+    for (uint32_t i = 0; i < m_timer_count; i++)
+    {
+        CHECK(!m_timers[i].armed || (m_timers[i].expected + m_timers[i].slack >= m_ticks));
+    }
+}
+
+
+static uint32_t timeout_random(void)
+{
+    switch (bench_random() % 8)
+    {
+        case 0:
+            return 1 + bench_random() % TIMEOUT_MAX;
+        case 1:
+            return 1 + bench_random() % 10;
+        default:
+            return 1 + bench_random() % 3000;
+    }
+}
+
+
+static void test_random(uint64_t expirations)
+{
+    uint64_t end = m_expirations + expirations;
+
+    timers_create(100, 50);
+#if defined(APP_TIMER_V2)
+    for (uint32_t i = 0; i < m_timer_count; i++)
+    {
+        bench_timer_slack_set(&m_timers[i], (bench_random() & 1) ? bench_random() % 100 : 0);
+    }
+#endif
+    m_latency_max = LATENCY_MAX;
+    while (m_expirations < end)
+    {
+        bench_timer_t * p_timer = &m_timers[bench_random() % m_timer_count];
+
+        if (p_timer->armed)
+        {
+            bench_timer_stop(p_timer);
+        }
+        else
+        {
+            bench_timer_start(p_timer, timeout_random());
+        }
+        rtc_run(m_ticks + bench_random() % 200);
+    }
+    timers_check();
+    printf("random: %llu expirations in %llu ticks, %llu interrupts\n",
+           (unsigned long long)expirations, (unsigned long long)m_ticks,
+           (unsigned long long)m_irqs);
+    timers_stop_all();
+}
+
+
+static void test_long(void)
+{
+    uint64_t const end    = m_ticks + (1ULL << 33);
+    uint64_t const start  = m_expirations;
+
+    timers_create(20, 50);
+    for (uint32_t i = 0; i < m_timer_count; i++)
+    {
+        m_timers[i].restart = false;
+        bench_timer_start(&m_timers[i], TIMEOUT_MAX / 2 + bench_random() % (TIMEOUT_MAX / 2));
+    }
+    while (m_ticks < end)
+    {
+        if (!m_running)
+        {
+            CHECK(m_running);
+            break;
+        }
+        rtc_run(m_ticks + 1 + bench_random() % (TIMEOUT_MAX / 4));
+        for (uint32_t i = 0; i < m_timer_count; i++)
+        {
+            if (!m_timers[i].armed)
+            {
+                bench_timer_start(&m_timers[i], TIMEOUT_MAX / 2 + bench_random() % (TIMEOUT_MAX / 2));
+            }
+        }
+    }
+    timers_check();
+    printf("long: %llu expirations in %llu ticks\n",
+           (unsigned long long)(m_expirations - start), (unsigned long long)m_ticks);
+    timers_stop_all();
+}
+
+
+static void test_stop_all(void)
+{
+    uint64_t start;
+
+    timers_create(100, 50);
+    for (uint32_t i = 0; i < m_timer_count; i++)
+    {
+        bench_timer_start(&m_timers[i], 1 + bench_random() % 1000);
+    }
+    rtc_run(m_ticks + 500);
+    timers_stop_all();
+
+    start = m_expirations;
+    rtc_run(m_ticks + 2000);
+    CHECK(m_expirations == start);
+
+    // Timers work again after being stopped all at once.
+    bench_timer_start(&m_timers[0], 100);
+    rtc_run(m_ticks + 150);
+    CHECK(m_expirations == start + 1);
+    timers_stop_all();
+}
+
+
+#if defined(APP_TIMER_V2)
+/* Runs two timers with overlapping windows, which must expire on a single compare event, then
+ * periodic timers with unrelated periods, with and without slack, and compares the number of
+ * interrupts. */
+static void test_slack(void)
+{
+    uint32_t const count           = 12;
+    uint64_t       irqs[2];
+    uint64_t       expirations[2];
+    uint32_t       periods[count];
+    uint32_t       avoided         = app_timer_wakeups_avoided_get();
+
+    m_latency_max = 0;
+    timers_create(2, 0);
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        m_timers[i].restart = false;
+    }
+    bench_timer_slack_set(&m_timers[0], 50);
+    bench_timer_slack_set(&m_timers[1], 100);
+    bench_timer_start(&m_timers[0], 100);
+    bench_timer_start(&m_timers[1], 120);
+    irqs[0]        = m_irqs;
+    expirations[0] = m_expirations;
+    rtc_run(m_ticks + 1000);
+    printf("slack: 2 overlapping timers, %llu interrupts for %llu expirations\n",
+           (unsigned long long)(m_irqs - irqs[0]),
+           (unsigned long long)(m_expirations - expirations[0]));
+    CHECK(m_irqs - irqs[0] == 1);
+    CHECK(m_expirations - expirations[0] == 2);
+    CHECK(app_timer_wakeups_avoided_get() - avoided == 1);
+    timers_stop_all();
+    avoided = app_timer_wakeups_avoided_get();
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        periods[i] = 300 + bench_random() % 3000;
+    }
+    for (uint32_t slack = 0; slack < 2; slack++)
+    {
+        uint64_t const irqs_start        = m_irqs;
+        uint64_t const expirations_start = m_expirations;
+
+        timers_create(count, 100);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            bench_timer_slack_set(&m_timers[i], slack ? periods[i] / 8 : 0);
+            bench_timer_start(&m_timers[i], periods[i]);
+        }
+        rtc_run(m_ticks + 10000000);
+        timers_check();
+        timers_stop_all();
+        irqs[slack]        = m_irqs - irqs_start;
+        expirations[slack] = m_expirations - expirations_start;
+    }
+    avoided = app_timer_wakeups_avoided_get() - avoided;
+    printf("slack: %llu interrupts for %llu expirations without slack, "
+           "%llu for %llu with 1/8 of the period, %u wakeups avoided\n",
+           (unsigned long long)irqs[0], (unsigned long long)expirations[0],
+           (unsigned long long)irqs[1], (unsigned long long)expirations[1], avoided);
+    CHECK(irqs[1] < irqs[0]);
+    CHECK(avoided > 0);
+}
+#endif
+
+
+static void bench(uint32_t count)
+{
+    uint64_t irqs;
+    uint64_t expirations;
+    uint64_t start;
+
+    m_latency_max = 0;
+    timers_create(count, 100);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_timers[i].restart = false;
+        bench_timer_start(&m_timers[i], 1000 + bench_random() % 32768);
+    }
+
+    // Repeated timers expire.
+    irqs        = m_irqs;
+    expirations = m_expirations;
+    m_irq_ns    = 0;
+    m_measure   = true;
+    while (m_expirations - expirations < BENCH_OPERATIONS)
+    {
+        rtc_run(m_ticks + 1000);
+    }
+    m_measure = false;
+    printf("%4u timers: expire %6.0f ns per interrupt, %6.0f ns per expiration, "
+           "%.2f interrupts per expiration\n",
+           count,
+           (double)m_irq_ns / (double)(m_irqs - irqs),
+           (double)m_irq_ns / (double)(m_expirations - expirations),
+           (double)(m_irqs - irqs) / (double)(m_expirations - expirations));
+
+    // Running timers are stopped and started again, with the interrupt processing the requests.
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_OPERATIONS; i++)
+    {
+        bench_timer_t * p_timer = &m_timers[bench_random() % count];
+
+        bench_timer_stop(p_timer);
+        bench_timer_start(p_timer, 1000 + bench_random() % 32768);
+    }
+    printf("%4u timers: stop and start %6.0f ns\n",
+           count, (double)(bench_now_ns() - start) / BENCH_OPERATIONS);
+
+    timers_stop_all();
+}
+
+
+int main(int argc, char ** argv)
+{
+    uint64_t const expirations = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1000000;
+
+#if defined(APP_TIMER_WHEEL)
+    printf("timing wheel\n");
+#else
+    printf("sorted list\n");
+#endif
+    APP_ERROR_CHECK(app_timer_init());
+
+    test_random(expirations);
+    test_long();
+    test_stop_all();
+#if defined(APP_TIMER_V2)
+    test_slack();
+#endif
+    if (bench_failed())
+    {
+        return 1;
+    }
+
+    bench(10);
+    bench(100);
+    bench(1000);
+    if (bench_failed())
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,17 @@
+#ifndef NRF_RTC_H__
+#define NRF_RTC_H__
+
+#include "nrf.h"
+
+// The RTC is simulated by app_timer_bench behind the drv_rtc functions, the registers are never
+// accessed.
+typedef struct
+{
+    uint32_t COUNTER;
+} NRF_RTC_Type;
+
+#define NRF_RTC1                        ((NRF_RTC_Type *)0x40011000UL)
+#define NRF_RTC_CC_CHANNEL_COUNT(id)    4
+#define RTC_FREQ_TO_PRESCALER(FREQ)     (uint16_t)(((32768) / (FREQ)) - 1)
+
+#endif // NRF_RTC_H__
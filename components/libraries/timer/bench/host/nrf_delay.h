@@ -0,0 +1,7 @@
+#ifndef NRF_DELAY_H
+#define NRF_DELAY_H
+
+#define nrf_delay_us(us_time)
+#define nrf_delay_ms(ms_time)
+
+#endif // NRF_DELAY_H
@@ -0,0 +1,16 @@
+#ifndef NRFX_H__
+#define NRFX_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf.h"
+#include "sdk_errors.h"
+
+#define NRFX_CONCAT_2(p1, p2)       NRFX_CONCAT_2_(p1, p2)
+#define NRFX_CONCAT_2_(p1, p2)      p1 ## p2
+#define NRFX_CONCAT_3(p1, p2, p3)   NRFX_CONCAT_3_(p1, p2, p3)
+#define NRFX_CONCAT_3_(p1, p2, p3)  p1 ## p2 ## p3
+
+#define NRFX_SUCCESS                NRF_SUCCESS
+
+#endif // NRFX_H__
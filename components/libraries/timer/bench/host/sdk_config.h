@@ -0,0 +1,21 @@
+#ifndef SDK_CONFIG_H
+#define SDK_CONFIG_H
+
+// Configuration of the host build of the application timers used by app_timer_bench.
+
+#define APP_TIMER_ENABLED 1
+#define APP_TIMER_CONFIG_RTC_FREQUENCY 0
+#define APP_TIMER_CONFIG_IRQ_PRIORITY 6
+#define APP_TIMER_CONFIG_OP_QUEUE_SIZE 16
+#define APP_TIMER_CONFIG_USE_SCHEDULER 0
+#define APP_TIMER_KEEPS_RTC_ACTIVE 0
+#define APP_TIMER_SAFE_WINDOW_MS 300000
+#define APP_TIMER_CONFIG_LOG_ENABLED 0
+#define APP_TIMER_V2_RTC1_ENABLED 1
+
+#define NRF_SORTLIST_ENABLED 1
+#define NRF_SORTLIST_CONFIG_LOG_ENABLED 0
+
+#define NRF_LOG_ENABLED 0
+
+#endif // SDK_CONFIG_H
@@ -87,8 +87,12 @@ typedef struct
     app_timer_t *        p_timer; /**< Timer instance. */
 } timer_req_t;
 
-static app_timer_t * volatile mp_active_timer; /**< Timer currently handled by RTC driver. */
-static bool                   m_global_active; /**< Flag used to globally disable all timers. */
+static app_timer_t * volatile mp_active_timer;    /**< Timer currently handled by RTC driver. */
+static uint32_t               m_active_wakeup;    /**< Value set in RTC driver for the active timer. */
+static bool                   m_global_active;    /**< Flag used to globally disable all timers. */
+static bool                   m_wakeup_shared;    /**< Flag indicating that timers expire on a compare event. */
+static uint32_t               m_wakeup_end;       /**< End value of the last timer expired on the compare event. */
+static uint32_t               m_wakeups_avoided;  /**< Number of wakeups avoided by the slack of timers. */
 
 /* Request FIFO instance. */
 NRF_ATFIFO_DEF(m_req_fifo, timer_req_t, APP_TIMER_CONFIG_OP_QUEUE_SIZE);
@@ -120,6 +124,106 @@ static void scheduled_timeout_handler(void * p_event_data, uint16_t event_size)
 }
 #endif
 
+static inline app_timer_t * sortlist_pop(void)
+{
+    nrf_sortlist_item_t * p_next_item = nrf_sortlist_pop(&m_app_timer_sortlist);
+    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
+}
+
+static inline app_timer_t * sortlist_peek(void)
+{
+    nrf_sortlist_item_t const * p_next_item = nrf_sortlist_peek(&m_app_timer_sortlist);
+    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
+}
+
+static inline app_timer_t * sortlist_next(app_timer_t * p_item)
+{
+    nrf_sortlist_item_t const * p_next_item = nrf_sortlist_next(&p_item->list_item);
+    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
+}
+
+/**
+ * @brief Function for putting the active timer back into sorted list.
+ *
+ * The timer is no longer handled by RTC driver, which must be reconfigured by @ref rtc_update.
+ */
+static void active_timer_preempt(void)
+{
+    if (mp_active_timer->active)
+    {
+        NRF_LOG_INST_DEBUG(mp_active_timer->p_log, "Timer preempted.");
+        nrf_sortlist_add(&m_app_timer_sortlist, &mp_active_timer->list_item);
+    }
+    mp_active_timer = NULL;
+}
+
+/**
+ * @brief Function for adding a timer to sorted list.
+ *
+ * If the timer cannot wait for the wakeup set in RTC driver for the active timer, the active timer
+ * is preempted.
+ */
+static void timer_list_add(app_timer_t * p_timer)
+{
+    nrf_sortlist_add(&m_app_timer_sortlist, &p_timer->list_item);
+    if (mp_active_timer && ((p_timer->end_val + p_timer->slack) < m_active_wakeup))
+    {
+        active_timer_preempt();
+    }
+}
+
+/**
+ * @brief Function for computing when RTC should wake up for a timer taken from sorted list.
+ *
+ * The timer can expire at any time from its end value to its end value plus its slack. Timers
+ * which come next in sorted list and end within that window narrow it down to the window they all
+ * share, so that they expire on the same compare event.
+ *
+ * @param p_timer Timer instance.
+ *
+ * @return Value to set in RTC driver.
+ */
+static uint32_t wakeup_compute(app_timer_t const * p_timer)
+{
+    uint32_t      wakeup = p_timer->end_val + p_timer->slack;
+    uint32_t      limit  = drv_rtc_counter_get(&m_rtc_inst) + APP_TIMER_RTC_MAX_VALUE;
+    app_timer_t * p_next = sortlist_peek();
+
+    while (p_next && (p_next->end_val <= wakeup))
+    {
+        if ((p_next->end_val + p_next->slack) < wakeup)
+        {
+            wakeup = p_next->end_val + p_next->slack;
+        }
+        p_next = sortlist_next(p_next);
+    }
+
+    //Slack cannot take the compare value out of the range of RTC driver.
+    if (wakeup > limit)
+    {
+        wakeup = (p_timer->end_val > limit) ? p_timer->end_val : limit;
+    }
+    return wakeup;
+}
+
+/**
+ * @brief Function for counting the wakeups avoided on a compare event.
+ *
+ * Each timer expiring on the compare event with an end value before the compare value and other
+ * than that of the timers expired before would have needed its own wakeup without slack.
+ */
+static void wakeup_shared_count(app_timer_t const * p_timer)
+{
+    uint32_t end_val = p_timer->end_val & RTC_COUNTER_COUNTER_Msk;
+
+    if ((end_val != m_wakeup_end) &&
+        (app_timer_cnt_diff_compute(m_active_wakeup, end_val) <= APP_TIMER_RTC_MAX_VALUE))
+    {
+        m_wakeup_end = end_val;
+        m_wakeups_avoided++;
+    }
+}
+
 /**
  * @brief Function called on timer expiration
  *
@@ -136,6 +240,10 @@ static bool timer_expire(app_timer_t * p_timer)
     bool ret = false;
     if ((m_global_active == true) && (p_timer != NULL) && (p_timer->active))
     {
+        if (m_wakeup_shared)
+        {
+            wakeup_shared_count(p_timer);
+        }
         if (p_timer->repeat_period == 0)
         {
             p_timer->active = false;
@@ -155,7 +263,7 @@ static bool timer_expire(app_timer_t * p_timer)
         if ((p_timer->repeat_period) && (p_timer->active))
         {
             p_timer->end_val += p_timer->repeat_period;
-            nrf_sortlist_add(&m_app_timer_sortlist, &p_timer->list_item);
+            timer_list_add(p_timer);
             ret = true;
         }
     }
@@ -165,8 +273,10 @@ static bool timer_expire(app_timer_t * p_timer)
 /**
  * @brief Function is configuring RTC driver to trigger timeout interrupt for given timer.
  *
- * It is possible that RTC driver will indicate that timeout already occured. In that case timer
- * expires and function indicates that RTC was not configured.
+ * RTC is set to the end value of the timer, delayed within its slack to share the compare event
+ * with the timers which come next (see @ref wakeup_compute). It is possible that RTC driver will
+ * indicate that timeout already occured. In that case timer expires and function indicates that
+ * RTC was not configured.
  *
  * @param          p_timer Timer instance.
  * @param [in,out] p_rerun Flag indicating that sortlist reevaluation is required.
@@ -178,11 +288,13 @@ static bool timer_expire(app_timer_t * p_timer)
 static bool rtc_schedule(app_timer_t * p_timer, bool * p_rerun)
 {
     ret_code_t ret = NRF_SUCCESS;
+    uint32_t   wakeup = wakeup_compute(p_timer);
     *p_rerun = false;
-    ret = drv_rtc_windowed_compare_set(&m_rtc_inst, 0, p_timer->end_val, APP_TIMER_SAFE_WINDOW);
+    ret = drv_rtc_windowed_compare_set(&m_rtc_inst, 0, wakeup, APP_TIMER_SAFE_WINDOW);
 
     if (ret == NRF_SUCCESS)
     {
+        m_active_wakeup = wakeup;
         return true;
     }
     else if (ret == NRF_ERROR_TIMEOUT)
@@ -196,29 +308,19 @@ static bool rtc_schedule(app_timer_t * p_timer, bool * p_rerun)
     return false;
 }
 
-static inline app_timer_t * sortlist_pop(void)
-{
-    nrf_sortlist_item_t * p_next_item = nrf_sortlist_pop(&m_app_timer_sortlist);
-    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
-}
-
-static inline app_timer_t * sortlist_peek(void)
-{
-    nrf_sortlist_item_t const * p_next_item = nrf_sortlist_peek(&m_app_timer_sortlist);
-    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
-}
-
-static inline app_timer_t * sortlist_next(app_timer_t * p_item)
-{
-    nrf_sortlist_item_t const * p_next_item = nrf_sortlist_next(&p_item->list_item);
-    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
-}
 /**
  * @brief Function for deactivating all timers which are in the sorted list (active timers).
  */
 static void sorted_list_stop_all(void)
 {
     app_timer_t * p_next;
+
+    //Timer handled by RTC driver is no longer in the sorted list.
+    if (mp_active_timer)
+    {
+        mp_active_timer->active = false;
+        mp_active_timer = NULL;
+    }
     do
     {
         p_next = sortlist_pop();
@@ -236,26 +338,38 @@ static void sorted_list_stop_all(void)
  */
 static void on_overflow_evt(void)
 {
+    app_timer_t * p_next;
+
     NRF_LOG_DEBUG("Overflow EVT");
     if (mp_active_timer)
     {
-        uint32_t end_val = mp_active_timer->end_val;
-        mp_active_timer->end_val = end_val & RTC_COUNTER_COUNTER_Msk;
-    }
-
-    app_timer_t *     p_next;
-    p_next = sortlist_peek();
-    while (p_next)
-    {
-        if (p_next->end_val <= RTC_COUNTER_COUNTER_Msk)
+        if (mp_active_timer->end_val <= RTC_COUNTER_COUNTER_Msk)
         {
-            //If overflow occurs then all timers with value lower than max value expires immediately.
+            //Active timer waiting within its slack expires immediately, like the timers below.
+            p_next          = mp_active_timer;
+            mp_active_timer = NULL;
             UNUSED_RETURN_VALUE(timer_expire(p_next));
         }
         else
         {
-            p_next->end_val &= RTC_COUNTER_COUNTER_Msk;
+            mp_active_timer->end_val &= RTC_COUNTER_COUNTER_Msk;
+            m_active_wakeup          &= RTC_COUNTER_COUNTER_Msk;
         }
+    }
+
+    //If overflow occurs then all timers with value lower than max value expires immediately. They
+    //are taken out of sorted list first, as repeated timers are put back into it.
+    p_next = sortlist_peek();
+    while (p_next && (p_next->end_val <= RTC_COUNTER_COUNTER_Msk))
+    {
+        p_next = sortlist_pop();
+        UNUSED_RETURN_VALUE(timer_expire(p_next));
+        p_next = sortlist_peek();
+    }
+
+    while (p_next)
+    {
+        p_next->end_val &= RTC_COUNTER_COUNTER_Msk;
         p_next = sortlist_next(p_next);
     }
 }
@@ -267,13 +381,27 @@ static void on_compare_evt(drv_rtc_t const * const  p_instance)
 {
     if (mp_active_timer)
     {
+        app_timer_t * p_timer = mp_active_timer;
+
         //If assert fails it suggests that safe window should be increased.
-        ASSERT(app_timer_cnt_diff_compute(drv_rtc_counter_get(p_instance), 
-                                          mp_active_timer->end_val & RTC_COUNTER_COUNTER_Msk) < APP_TIMER_SAFE_WINDOW);
+        ASSERT(app_timer_cnt_diff_compute(drv_rtc_counter_get(p_instance),
+                                          m_active_wakeup & RTC_COUNTER_COUNTER_Msk) < APP_TIMER_SAFE_WINDOW);
 
-        NRF_LOG_INST_DEBUG(mp_active_timer->p_log, "Compare EVT");
-        UNUSED_RETURN_VALUE(timer_expire(mp_active_timer));
+        NRF_LOG_INST_DEBUG(p_timer->p_log, "Compare EVT");
         mp_active_timer = NULL;
+        m_wakeup_shared = true;
+        m_wakeup_end    = p_timer->end_val & RTC_COUNTER_COUNTER_Msk;
+        UNUSED_RETURN_VALUE(timer_expire(p_timer));
+
+        //Timers which end before the compare value expire on this event, see @ref wakeup_compute.
+        //They are taken out of sorted list first, as repeated timers are put back into it.
+        p_timer = sortlist_peek();
+        while (p_timer && (p_timer->end_val <= m_active_wakeup))
+        {
+            p_timer = sortlist_pop();
+            UNUSED_RETURN_VALUE(timer_expire(p_timer));
+            p_timer = sortlist_peek();
+        }
     }
     else
     {
@@ -297,23 +425,17 @@ static void rtc_update(drv_rtc_t const * const  p_instance)
         if (p_next) //Candidate for active timer
         {
             uint32_t next_end_val   = p_next->end_val;
-            uint32_t active_end_val = mp_active_timer->end_val;
             if (mp_active_timer == NULL)
             {
                 //There is no active timer so candidate will become active timer.
                 rtc_reconf = true;
             }
-            else if (mp_active_timer &&
-                    (active_end_val > next_end_val))
+            else if (m_active_wakeup > next_end_val + p_next->slack)
             {
-                //Candidate has shorter timeout than current active timer. Candidate will replace active timer.
+                //Candidate cannot wait for the wakeup of current active timer. Candidate will replace active timer.
                 //Active timer is put back into sorted list.
                 rtc_reconf = true;
-                if (mp_active_timer->active)
-                {
-                    NRF_LOG_INST_DEBUG(mp_active_timer->p_log, "Timer preempted.");
-                    nrf_sortlist_add(&m_app_timer_sortlist, &mp_active_timer->list_item);
-                }
+                active_timer_preempt();
             }
 
             if (rtc_reconf)
@@ -381,7 +503,7 @@ static void timer_req_process(drv_rtc_t const * const  p_instance)
                         //A little trick to handle case when timer was scheduled just before overflow.
                         p_req->p_timer->end_val &= RTC_COUNTER_COUNTER_Msk;
                     }
-                    nrf_sortlist_add(&m_app_timer_sortlist, &(p_req->p_timer->list_item));
+                    timer_list_add(p_req->p_timer);
                     NRF_LOG_INST_DEBUG(p_req->p_timer->p_log,"Start request (CC:%d).",
                                                                            p_req->p_timer->end_val);
                 }
@@ -419,6 +541,7 @@ static void rtc_irq(drv_rtc_t const * const  p_instance)
     }
     timer_req_process(p_instance);
     rtc_update(p_instance);
+    m_wakeup_shared = false;
 }
 
 /**
@@ -550,6 +673,24 @@ ret_code_t app_timer_stop_all(void)
     return timer_req_schedule(TIMER_REQ_STOP_ALL, NULL);
 }
 
+ret_code_t app_timer_slack_set(app_timer_id_t timer_id, uint32_t slack_ticks)
+{
+    ASSERT(timer_id);
+
+    if (slack_ticks > APP_TIMER_RTC_MAX_VALUE)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    timer_id->slack = slack_ticks;
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_wakeups_avoided_get(void)
+{
+    return m_wakeups_avoided;
+}
+
 uint8_t app_timer_op_queue_utilization_get(void)
 {
     /* Currently not supported by ATFIFO */
@@ -0,0 +1,636 @@
+/**
+ * Copyright (c) 2018 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* Application timer on a hierarchical timing wheel.
+ *
+ * Alternative to app_timer2.c with the same API and the same RTC driver, selected by defining
+ * APP_TIMER_WHEEL instead of APP_TIMER_V2. Starting, stopping and expiring a timer takes a constant
+ * time, whatever the number of running timers, where app_timer2.c keeps them in a sorted list.
+ *
+ * The RTC counter is extended to 32 bits. The wheel has WHEEL_LEVELS levels of WHEEL_SLOTS slots,
+ * level n holding the timers which expire in the same 32^(n+1) ticks as the time already processed
+ * (m_wheel_time), but not in the same 32^n ticks. Each slot is a list of timers and each level has a
+ * bitmap of the non-empty slots, so the next slot to handle is found with a few __CLZ. When the time
+ * of a slot of level 0 comes, its timers expire. When the time of a slot of a higher level comes,
+ * its timers are put again in the wheel, in a lower level. A timer goes down at most
+ * WHEEL_LEVELS - 1 times, usually once or twice. RTC is set to the earliest expiration time known
+ * in the next slots, so that moving timers down does not cost interrupts of its own.
+ */
+#include "app_timer.h"
+#include "nrf_atfifo.h"
+#include "nrf_delay.h"
+#if APP_TIMER_CONFIG_USE_SCHEDULER
+#include "app_scheduler.h"
+#endif
+#include <stddef.h>
+#define NRF_LOG_MODULE_NAME APP_TIMER_LOG_NAME
+#if APP_TIMER_CONFIG_LOG_ENABLED
+#define NRF_LOG_LEVEL       APP_TIMER_CONFIG_LOG_LEVEL
+#define NRF_LOG_INFO_COLOR  APP_TIMER_CONFIG_INFO_COLOR
+#define NRF_LOG_DEBUG_COLOR APP_TIMER_CONFIG_DEBUG_COLOR
+#else //APP_TIMER_CONFIG_LOG_ENABLED
+#define NRF_LOG_LEVEL       0
+#endif //APP_TIMER_CONFIG_LOG_ENABLED
+#include "nrf_log.h"
+NRF_LOG_MODULE_REGISTER();
+
+#include "drv_rtc.h"
+
+/**
+ * Maximum possible relative value is limited by safe window to detect cases when requested
+ * compare event has already occured.
+ */
+#define APP_TIMER_SAFE_WINDOW APP_TIMER_TICKS(APP_TIMER_SAFE_WINDOW_MS)
+
+#define APP_TIMER_RTC_MAX_VALUE   (DRV_RTC_MAX_CNT - APP_TIMER_SAFE_WINDOW)
+
+#define WHEEL_SLOT_BITS     5                               /**< Number of time bits handled by one level. */
+#define WHEEL_SLOTS         (1UL << WHEEL_SLOT_BITS)        /**< Number of slots in one level, one bit each in a 32 bit map. */
+#define WHEEL_LEVELS        CEIL_DIV(32, WHEEL_SLOT_BITS)   /**< Number of levels covering the 32 bit time. */
+
+/**@brief Bit of a slot in the map of its level, the first slot being the most significant bit. */
+#define WHEEL_SLOT_MASK(index)  (0x80000000UL >> (index))
+
+static drv_rtc_t m_rtc_inst = DRV_RTC_INSTANCE(1);
+
+/**
+ * @brief Timer requests types.
+ */
+typedef enum
+{
+    TIMER_REQ_START,
+    TIMER_REQ_STOP,
+    TIMER_REQ_STOP_ALL
+} app_timer_req_type_t;
+
+/**
+ * @brief Operation request structure.
+ */
+typedef struct
+{
+    app_timer_req_type_t type;    /**< Request type. */
+    app_timer_t *        p_timer; /**< Timer instance. */
+} timer_req_t;
+
+static app_timer_t * m_wheel[WHEEL_LEVELS][WHEEL_SLOTS]; /**< Lists of the timers in each slot. */
+static uint32_t      m_wheel_maps[WHEEL_LEVELS];         /**< Maps of the non-empty slots. */
+static uint32_t      m_wheel_time;                       /**< Time processed, the RTC counter extended to 32 bits. */
+static bool          m_rtc_running;                      /**< Flag indicating that RTC was started for the timers. */
+static bool          m_global_active;                    /**< Flag used to globally disable all timers. */
+
+/* Request FIFO instance. */
+NRF_ATFIFO_DEF(m_req_fifo, timer_req_t, APP_TIMER_CONFIG_OP_QUEUE_SIZE);
+
+#if APP_TIMER_CONFIG_USE_SCHEDULER
+static void scheduled_timeout_handler(void * p_event_data, uint16_t event_size)
+{
+    ASSERT(event_size == sizeof(app_timer_event_t));
+    app_timer_event_t const * p_timer_event = (app_timer_event_t *)p_event_data;
+
+    p_timer_event->timeout_handler(p_timer_event->p_context);
+}
+#endif
+
+/**
+ * @brief Function for putting a timer in the slot of the wheel matching its expiration time.
+ *
+ * The level is given by the most significant bit in which the expiration time differs from the
+ * time processed, and the slot by the bits of that level in the expiration time. A timer which
+ * should have already expired goes to the slot of the time processed, but keeps its expiration
+ * time so that a repeated timer keeps its period.
+ *
+ * @param p_timer Timer instance.
+ */
+static void wheel_insert(app_timer_t * p_timer)
+{
+    uint32_t        time    = ((p_timer->expiry - m_wheel_time) > APP_TIMER_RTC_MAX_VALUE) ?
+                              m_wheel_time : p_timer->expiry;
+    uint32_t        diff    = time ^ m_wheel_time;
+    uint32_t        level   = (diff == 0) ? 0 : ((31 - __CLZ(diff)) / WHEEL_SLOT_BITS);
+    uint32_t        index   = (time >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1);
+    app_timer_t  ** pp_head = &m_wheel[level][index];
+
+    p_timer->p_prev   = NULL;
+    p_timer->p_next   = *pp_head;
+    p_timer->slot_min = time;
+    if (*pp_head)
+    {
+        (*pp_head)->p_prev = p_timer;
+        if (((*pp_head)->slot_min - m_wheel_time) < (time - m_wheel_time))
+        {
+            p_timer->slot_min = (*pp_head)->slot_min;
+        }
+    }
+    *pp_head = p_timer;
+
+    m_wheel_maps[level] |= WHEEL_SLOT_MASK(index);
+    p_timer->slot        = (uint8_t)(level * WHEEL_SLOTS + index + 1);
+}
+
+/**
+ * @brief Function for taking a timer out of the wheel. Nothing is done if it is not in the wheel.
+ */
+static void wheel_remove(app_timer_t * p_timer)
+{
+    if (p_timer->slot == 0)
+    {
+        return;
+    }
+
+    uint32_t level = (p_timer->slot - 1) / WHEEL_SLOTS;
+    uint32_t index = (p_timer->slot - 1) % WHEEL_SLOTS;
+
+    if (p_timer->p_next)
+    {
+        p_timer->p_next->p_prev = p_timer->p_prev;
+    }
+    if (p_timer->p_prev)
+    {
+        p_timer->p_prev->p_next = p_timer->p_next;
+    }
+    else
+    {
+        m_wheel[level][index] = p_timer->p_next;
+        if (p_timer->p_next == NULL)
+        {
+            m_wheel_maps[level] &= ~WHEEL_SLOT_MASK(index);
+        }
+    }
+    p_timer->slot = 0;
+}
+
+/**
+ * @brief Function for finding the next slot of the wheel to handle.
+ *
+ * In each level, the first non-empty slot at or after the slot of the time processed is the
+ * candidate. The highest level spans the whole 32 bit time, so its search wraps around. The
+ * candidate which comes first is the next slot.
+ *
+ * Each timer holds the earliest expiration of itself and the timers after it in the slot, so the
+ * first timer holds a time at or before the expiration of all timers of the slot.
+ * Waking up at the earliest of these times rather than at the time of the next slot spares the
+ * interrupts which would only move timers down the wheel.
+ *
+ * @param[out] p_time   Time when the slot is to be handled.
+ * @param[out] p_wakeup Time when RTC is to wake up, at or after the time of the slot.
+ * @param[out] p_level  Level of the slot.
+ * @param[out] p_index  Index of the slot in its level.
+ *
+ * @return True if a slot was found, false if the wheel is empty.
+ */
+static bool wheel_next_get(uint32_t * p_time,
+                           uint32_t * p_wakeup,
+                           uint32_t * p_level,
+                           uint32_t * p_index)
+{
+    bool     found  = false;
+    uint32_t offset = 0;
+    uint32_t wakeup = 0;
+
+    for (uint32_t level = 0; level < WHEEL_LEVELS; level++)
+    {
+        uint32_t shift   = level * WHEEL_SLOT_BITS;
+        uint32_t current = (m_wheel_time >> shift) & (WHEEL_SLOTS - 1);
+        uint32_t map     = m_wheel_maps[level] & (0xFFFFFFFFUL >> current);
+
+        if ((map == 0) && (level == (WHEEL_LEVELS - 1)))
+        {
+            map = m_wheel_maps[level];
+        }
+        if (map == 0)
+        {
+            continue;
+        }
+
+        uint32_t index    = __CLZ(map);
+        uint32_t time     = (uint32_t)index << shift;
+        uint32_t slot_min = m_wheel[level][index]->slot_min;
+
+        if (shift + WHEEL_SLOT_BITS < 32)
+        {
+            time |= m_wheel_time & ~((1UL << (shift + WHEEL_SLOT_BITS)) - 1);
+        }
+        if (!found || ((time - m_wheel_time) < offset))
+        {
+            offset   = time - m_wheel_time;
+            *p_time  = time;
+            *p_level = level;
+            *p_index = index;
+        }
+        if (!found || ((slot_min - m_wheel_time) < (wakeup - m_wheel_time)))
+        {
+            wakeup = slot_min;
+        }
+        found = true;
+    }
+    *p_wakeup = wakeup;
+    return found;
+}
+
+/**
+ * @brief Function called on timer expiration
+ *
+ * Function calls user handler if timer was not stopped before. If timer is in repeated mode then
+ * timer is put back into the wheel.
+ *
+ * @param p_timer Timer instance, already taken out of the wheel.
+ */
+static void timer_expire(app_timer_t * p_timer)
+{
+    ASSERT(p_timer->handler);
+    if ((m_global_active == true) && (p_timer->active))
+    {
+        if (p_timer->repeat_period == 0)
+        {
+            p_timer->active = false;
+        }
+#if APP_TIMER_CONFIG_USE_SCHEDULER
+        app_timer_event_t timer_event;
+
+        timer_event.timeout_handler = p_timer->handler;
+        timer_event.p_context       = p_timer->p_context;
+        uint32_t err_code = app_sched_event_put(&timer_event,
+                                                sizeof(timer_event),
+                                                scheduled_timeout_handler);
+        APP_ERROR_CHECK(err_code);
+#else
+        p_timer->handler(p_timer->p_context);
+#endif
+        if ((p_timer->repeat_period) && (p_timer->active))
+        {
+            p_timer->expiry += p_timer->repeat_period;
+            wheel_insert(p_timer);
+        }
+    }
+}
+
+/**
+ * @brief Function for handling all slots of the wheel up to the given time.
+ *
+ * Timers of a slot of level 0 expire, timers of a slot of a higher level are put again in the
+ * wheel, relative to the time of their slot.
+ *
+ * @param time Time up to which the wheel is handled, not before the time processed.
+ */
+static void wheel_process(uint32_t time)
+{
+    uint32_t slot_time;
+    uint32_t wakeup;
+    uint32_t level;
+    uint32_t index;
+
+    while (wheel_next_get(&slot_time, &wakeup, &level, &index) &&
+           ((slot_time - m_wheel_time) <= (time - m_wheel_time)))
+    {
+        app_timer_t * p_timer;
+
+        m_wheel_time = slot_time;
+        while ((p_timer = m_wheel[level][index]) != NULL)
+        {
+            wheel_remove(p_timer);
+            if (level == 0)
+            {
+                timer_expire(p_timer);
+            }
+            else
+            {
+                wheel_insert(p_timer);
+            }
+        }
+    }
+    m_wheel_time = time;
+}
+
+/**
+ * @brief Function for deactivating all timers which are in the wheel (active timers).
+ */
+static void wheel_stop_all(void)
+{
+    for (uint32_t level = 0; level < WHEEL_LEVELS; level++)
+    {
+        while (m_wheel_maps[level])
+        {
+            uint32_t      index   = __CLZ(m_wheel_maps[level]);
+            app_timer_t * p_timer = m_wheel[level][index];
+
+            while (p_timer)
+            {
+                p_timer->active = false;
+                p_timer->slot   = 0;
+                p_timer         = p_timer->p_next;
+            }
+            m_wheel[level][index] = NULL;
+            m_wheel_maps[level]  &= ~WHEEL_SLOT_MASK(index);
+        }
+    }
+}
+
+/**
+ * @brief Function for getting the current time, the RTC counter extended to 32 bits.
+ *
+ * While the wheel holds timers, RTC is set to a slot at most APP_TIMER_RTC_MAX_VALUE ticks after
+ * the time processed, so the counter cannot run a whole period ahead of it. The time processed can
+ * be a few ticks ahead of the counter when a slot was handled because its compare value was too
+ * close to be set.
+ */
+static uint32_t wheel_time_get(void)
+{
+    uint32_t ticks = (drv_rtc_counter_get(&m_rtc_inst) - m_wheel_time) & DRV_RTC_MAX_CNT;
+
+    return (ticks > (DRV_RTC_MAX_CNT - DRV_RTC_MIN_TICK_HANDLED)) ? m_wheel_time :
+                                                                    (m_wheel_time + ticks);
+}
+
+/**
+ * @brief Function updates RTC.
+ *
+ * Function is called at the end of RTC interrupt when all new user request and/or timer expiration
+ * occured. It configures RTC to wake up for the next slot of the wheel or stops RTC if the wheel is
+ * empty. If RTC driver indicates that the wake up time is too close, the wheel is handled up to
+ * that time immediately and the next slot is taken.
+ */
+static void rtc_update(drv_rtc_t const * const  p_instance)
+{
+    uint32_t time;
+    uint32_t wakeup;
+    uint32_t level;
+    uint32_t index;
+
+    while (wheel_next_get(&time, &wakeup, &level, &index))
+    {
+        ret_code_t ret = drv_rtc_windowed_compare_set(p_instance, 0, wakeup, APP_TIMER_SAFE_WINDOW);
+
+        if (ret == NRF_SUCCESS)
+        {
+            if (!APP_TIMER_KEEPS_RTC_ACTIVE && !m_rtc_running)
+            {
+                drv_rtc_start(p_instance);
+                m_rtc_running = true;
+            }
+            return;
+        }
+        ASSERT(ret == NRF_ERROR_TIMEOUT);
+        NRF_LOG_DEBUG("Wheel handled before scheduled to RTC (CC:%d).", wakeup & DRV_RTC_MAX_CNT);
+        wheel_process(wakeup);
+    }
+
+    if (!APP_TIMER_KEEPS_RTC_ACTIVE && m_rtc_running)
+    {
+        drv_rtc_stop(p_instance);
+        m_rtc_running = false;
+    }
+}
+
+/**
+ * @brief Function for processing user requests.
+ *
+ * Function is called only in the context of RTC interrupt.
+ */
+static void timer_req_process(void)
+{
+    nrf_atfifo_item_get_t fifo_ctx;
+    timer_req_t *         p_req = nrf_atfifo_item_get(m_req_fifo, &fifo_ctx);
+
+    while (p_req)
+    {
+        app_timer_t * p_timer = p_req->p_timer;
+
+        switch (p_req->type)
+        {
+            case TIMER_REQ_START:
+                if (!p_timer->active)
+                {
+                    uint32_t ticks = (p_timer->end_val - m_wheel_time) & DRV_RTC_MAX_CNT;
+
+                    //End value before the time processed means that the timer has already expired.
+                    p_timer->expiry = m_wheel_time + ticks;
+                    if (ticks > APP_TIMER_RTC_MAX_VALUE)
+                    {
+                        p_timer->expiry -= DRV_RTC_MAX_CNT + 1;
+                    }
+                    p_timer->active = true;
+                    wheel_remove(p_timer);
+                    wheel_insert(p_timer);
+                    NRF_LOG_DEBUG("Start request (CC:%d).", p_timer->end_val);
+                }
+                break;
+            case TIMER_REQ_STOP:
+                wheel_remove(p_timer);
+                NRF_LOG_DEBUG("Stop request.");
+                break;
+            case TIMER_REQ_STOP_ALL:
+                wheel_stop_all();
+                m_global_active = true;
+                NRF_LOG_INFO("Stop all request.");
+                break;
+            default:
+                break;
+        }
+        UNUSED_RETURN_VALUE(nrf_atfifo_item_free(m_req_fifo, &fifo_ctx));
+        p_req = nrf_atfifo_item_get(m_req_fifo, &fifo_ctx);
+    }
+}
+
+static void rtc_irq(drv_rtc_t const * const  p_instance)
+{
+    // Events only wake the wheel up, which handles whatever is due at the current time.
+    UNUSED_RETURN_VALUE(drv_rtc_overflow_pending(p_instance));
+    UNUSED_RETURN_VALUE(drv_rtc_compare_pending(p_instance, 0));
+
+    wheel_process(wheel_time_get());
+    timer_req_process();
+    rtc_update(p_instance);
+}
+
+/**
+ * @brief Function for triggering processing user requests.
+ *
+ * @note All user requests are processed in a single context - RTC interrupt.
+ */
+static inline void timer_request_proc_trigger(void)
+{
+    drv_rtc_irq_trigger(&m_rtc_inst);
+}
+
+/**
+ * @brief Function for putting user request into the request queue
+ */
+static ret_code_t timer_req_schedule(app_timer_req_type_t type, app_timer_t * p_timer)
+{
+    nrf_atfifo_item_put_t fifo_ctx;
+    timer_req_t * p_req = nrf_atfifo_item_alloc(m_req_fifo, &fifo_ctx);
+
+    if (p_req)
+    {
+        p_req->type    = type;
+        p_req->p_timer = p_timer;
+        if (nrf_atfifo_item_put(m_req_fifo, &fifo_ctx))
+        {
+            timer_request_proc_trigger();
+        }
+        else
+        {
+            NRF_LOG_WARNING("Scheduling interrupted another scheduling.");
+        }
+        return NRF_SUCCESS;
+    }
+    else
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+}
+
+ret_code_t app_timer_init(void)
+{
+    ret_code_t err_code;
+    drv_rtc_config_t config = {
+        .prescaler          = APP_TIMER_CONFIG_RTC_FREQUENCY,
+        .interrupt_priority = APP_TIMER_CONFIG_IRQ_PRIORITY
+    };
+
+    err_code = NRF_ATFIFO_INIT(m_req_fifo);
+    if (err_code != NRFX_SUCCESS)
+    {
+        return err_code;
+    }
+
+    err_code = drv_rtc_init(&m_rtc_inst, &config, rtc_irq);
+    if (err_code != NRFX_SUCCESS)
+    {
+        return err_code;
+    }
+    drv_rtc_overflow_enable(&m_rtc_inst, true);
+    if (APP_TIMER_KEEPS_RTC_ACTIVE)
+    {
+        drv_rtc_start(&m_rtc_inst);
+    }
+
+    m_wheel_time    = drv_rtc_counter_get(&m_rtc_inst);
+    m_global_active = true;
+    return err_code;
+}
+
+ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                            app_timer_mode_t            mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    ASSERT(p_timer_id);
+    ASSERT(timeout_handler);
+
+    if (timeout_handler == NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    app_timer_t * p_t = (app_timer_t *) *p_timer_id;
+    p_t->handler = timeout_handler;
+    p_t->repeat_period = (mode == APP_TIMER_MODE_REPEATED) ? 1 : 0;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_t * p_timer, uint32_t timeout_ticks, void * p_context)
+{
+    ASSERT(p_timer);
+    app_timer_t * p_t = (app_timer_t *) p_timer;
+
+    if (timeout_ticks > APP_TIMER_RTC_MAX_VALUE)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (p_t->active)
+    {
+        return NRF_SUCCESS;
+    }
+
+    p_t->p_context = p_context;
+    p_t->end_val = drv_rtc_counter_get(&m_rtc_inst) + timeout_ticks;
+
+    if (p_t->repeat_period)
+    {
+        p_t->repeat_period = timeout_ticks;
+    }
+
+    return timer_req_schedule(TIMER_REQ_START, p_t);
+}
+
+
+ret_code_t app_timer_stop(app_timer_t * p_timer)
+{
+    ASSERT(p_timer);
+    app_timer_t * p_t = (app_timer_t *) p_timer;
+    p_t->active = false;
+
+    return timer_req_schedule(TIMER_REQ_STOP, p_t);
+}
+
+ret_code_t app_timer_stop_all(void)
+{
+    //block timer globally
+    m_global_active = false;
+
+    return timer_req_schedule(TIMER_REQ_STOP_ALL, NULL);
+}
+
+uint8_t app_timer_op_queue_utilization_get(void)
+{
+    /* Currently not supported by ATFIFO */
+    return 0;
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t   ticks_to,
+                                    uint32_t   ticks_from)
+{
+    return ((ticks_to - ticks_from) & RTC_COUNTER_COUNTER_Msk);
+}
+
+uint32_t app_timer_cnt_get(void)
+{
+    return drv_rtc_counter_get(&m_rtc_inst);
+}
+
+void app_timer_pause(void)
+{
+    drv_rtc_stop(&m_rtc_inst);
+}
+
+void app_timer_resume(void)
+{
+    drv_rtc_start(&m_rtc_inst);
+}
@@ -0,0 +1,86 @@
+#ifndef NRF_DRV_TWI_H__
+#define NRF_DRV_TWI_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+// TWI master driver of the host build, simulated by nrf_twi_mngr_bench.
+
+#define TWIM_PRESENT
+
+typedef struct
+{
+    uint8_t inst_idx;
+    bool    use_easy_dma;
+} nrf_drv_twi_t;
+
+#define NRF_DRV_TWI_INSTANCE(id)    { id, true }
+
+typedef enum
+{
+    NRF_DRV_TWI_FREQ_100K = 0x01980000UL,
+    NRF_DRV_TWI_FREQ_250K = 0x04000000UL,
+    NRF_DRV_TWI_FREQ_400K = 0x06400000UL
+} nrf_drv_twi_frequency_t;
+
+typedef struct
+{
+    uint32_t                scl;
+    uint32_t                sda;
+    nrf_drv_twi_frequency_t frequency;
+    uint8_t                 interrupt_priority;
+    bool                    clear_bus_init;
+    bool                    hold_bus_uninit;
+} nrf_drv_twi_config_t;
+
+#define NRF_DRV_TWI_FLAG_TX_NO_STOP (1UL << 5)
+
+typedef enum
+{
+    NRF_DRV_TWI_EVT_DONE,
+    NRF_DRV_TWI_EVT_ADDRESS_NACK,
+    NRF_DRV_TWI_EVT_DATA_NACK
+} nrf_drv_twi_evt_type_t;
+
+typedef enum
+{
+    NRF_DRV_TWI_XFER_TX,
+    NRF_DRV_TWI_XFER_RX,
+    NRF_DRV_TWI_XFER_TXRX,
+    NRF_DRV_TWI_XFER_TXTX
+} nrf_drv_twi_xfer_type_t;
+
+typedef struct
+{
+    nrf_drv_twi_xfer_type_t type;
+    uint8_t                 address;
+    uint8_t                 primary_length;
+    uint8_t                 secondary_length;
+    uint8_t *               p_primary_buf;
+    uint8_t *               p_secondary_buf;
+} nrf_drv_twi_xfer_desc_t;
+
+typedef struct
+{
+    nrf_drv_twi_evt_type_t  type;
+    nrf_drv_twi_xfer_desc_t xfer_desc;
+} nrf_drv_twi_evt_t;
+
+typedef void (* nrf_drv_twi_evt_handler_t)(nrf_drv_twi_evt_t const * p_event,
+                                           void *                    p_context);
+
+ret_code_t nrf_drv_twi_init(nrf_drv_twi_t const *        p_instance,
+                            nrf_drv_twi_config_t const * p_config,
+                            nrf_drv_twi_evt_handler_t    event_handler,
+                            void *                       p_context);
+
+void nrf_drv_twi_uninit(nrf_drv_twi_t const * p_instance);
+
+void nrf_drv_twi_enable(nrf_drv_twi_t const * p_instance);
+
+ret_code_t nrf_drv_twi_xfer(nrf_drv_twi_t           const * p_instance,
+                            nrf_drv_twi_xfer_desc_t const * p_xfer_desc,
+                            uint32_t                        flags);
+
+#endif // NRF_DRV_TWI_H__
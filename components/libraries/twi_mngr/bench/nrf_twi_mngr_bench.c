@@ -0,0 +1,547 @@
+/**
+ * Copyright (c) 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Test and benchmark of periodic sensor reads through the TWI transaction manager, on a simulated
+ * TWIM and bus.
+ *
+ * Build it on host from this directory:
+ *   L=../..; cc -O2 -Ihost -I$L/bench_host -I.. -I$L/queue -I$L/util -I$L/atomic -I$L/log -I$L/log/src \
+ *      -I$L/strerror nrf_twi_mngr_bench.c ../nrf_twi_mngr.c ../nrf_twi_mngr_poll.c $L/queue/nrf_queue.c \
+ *      $L/atomic/nrf_atomic.c $L/bench_host/bench.c -o nrf_twi_mngr_bench
+ *
+ * Usage: nrf_twi_mngr_bench [ticks]
+ *
+ * Eight sensors are polled on every tick for 6 data bytes and the 2 status bytes that follow
+ * them, and on every fourth tick for an identification byte. The driver is replaced by a
+ * simulation of the bus at 400 kHz, which counts the bits of each transfer and ends it with an
+ * interrupt, called from the main loop when the simulated time reaches it.
+ *
+ * The reads are done in three ways:
+ * - separate: each read is a transaction of its own, with its own callback,
+ * - batched: the reads due on a tick are one transaction of nrf_twi_mngr_poll,
+ * - burst: as batched, with the data and status reads of a sensor merged into one.
+ * Each way runs with a tick period the bus keeps up with, then with a period too short for it.
+ * The registers change before every tick that starts reads, and each read must return the values
+ * of its tick, on the ticks it is due, with one latency measurement per read.
+ *
+ * For each run, the callbacks, driver transfers (interrupts) and bus time per tick are printed,
+ * with the poll rate the bus time allows, the bus utilization, the latency of the first and last
+ * sensors, and the host time per tick.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdk_common.h"
+#include "nrf_twi_mngr.h"
+#include "nrf_twi_mngr_poll.h"
+#include "bench.h"
+
+
+#define SENSORS             8
+#define SENSOR_ADDRESS(s)   (0x18 + (s))
+#define READS_PER_SENSOR    3
+#define READS               (SENSORS * READS_PER_SENSOR)
+#define DATA_SIZE           128
+#define BIT_NS              2500        // 400 kHz.
+#define TIMESTAMP_MASK      0xFFFFFF    // Time stamps in microseconds.
+
+typedef enum
+{
+    MODE_SEPARATE,
+    MODE_BATCHED,
+    MODE_BURST
+} bench_mode_t;
+
+// Separate transaction of a read.
+typedef struct
+{
+    nrf_twi_mngr_transaction_t transaction;
+    nrf_twi_mngr_transfer_t    transfers[2];
+    uint8_t                    reg_address;
+    uint8_t                    data[8];
+    uint8_t                    idx;
+    bool                       pending;
+} read_transaction_t;
+
+NRF_TWI_MNGR_DEF(m_twi_mngr, READS + 1, 0);
+NRF_TWI_MNGR_POLL_DEF(m_poll, &m_twi_mngr, READS, DATA_SIZE);
+
+static nrf_twi_mngr_poll_desc_t m_descs[READS];
+static read_transaction_t       m_read_transactions[READS];
+static uint8_t                  m_regs[SENSORS][256];   // Registers of the sensors.
+static uint32_t                 m_cycle;                // Ticks which started reads.
+static uint32_t                 m_due_mask;             // Reads started by the last of them.
+static uint32_t                 m_reads_expected[READS];
+static uint32_t                 m_callbacks;
+static uint32_t                 m_pending;              // Reads of the current tick not done.
+static uint64_t                 m_latency_total[READS]; // Latencies of separate reads.
+static uint32_t                 m_latency_max[READS];
+static uint32_t                 m_tick_timestamp;
+
+// Simulated TWIM and bus.
+static nrf_drv_twi_evt_handler_t m_twi_handler;
+static void *                    mp_twi_context;
+static nrf_drv_twi_xfer_desc_t   m_xfer;
+static bool                      m_xfer_busy;
+static uint64_t                  m_xfer_end;
+static uint64_t                  m_now;                 // Simulated time in nanoseconds.
+static uint8_t                   m_reg_pointer[SENSORS];
+
+
+
+static uint32_t timestamp_get(void)
+{
+    return (uint32_t)(m_now / 1000) & TIMESTAMP_MASK;
+}
+
+
+ret_code_t nrf_drv_twi_init(nrf_drv_twi_t const *        p_instance,
+                            nrf_drv_twi_config_t const * p_config,
+                            nrf_drv_twi_evt_handler_t    event_handler,
+                            void *                       p_context)
+{
+    m_twi_handler  = event_handler;
+    mp_twi_context = p_context;
+    return NRF_SUCCESS;
+}
+
+
+void nrf_drv_twi_uninit(nrf_drv_twi_t const * p_instance)
+{
+    CHECK(!m_xfer_busy);
+}
+
+
+void nrf_drv_twi_enable(nrf_drv_twi_t const * p_instance)
+{
+}
+
+
+static uint32_t sensor_get(uint8_t address)
+{
+    CHECK((address >= SENSOR_ADDRESS(0)) && (address < SENSOR_ADDRESS(SENSORS)));
+    return address - SENSOR_ADDRESS(0);
+}
+
+
+// A write sets the register pointer of the sensor, and a read returns registers from it on.
+static uint32_t segment_run(uint32_t sensor, bool read, uint8_t * p_data, uint8_t length)
+{
+    if (read)
+    {
+        for (uint8_t i = 0; i < length; i++)
+        {
+            p_data[i] = m_regs[sensor][m_reg_pointer[sensor]++];
+        }
+    }
+    else
+    {
+        CHECK(length == 1);
+        m_reg_pointer[sensor] = p_data[0];
+    }
+    // Start condition, address and data bytes with their acknowledge bits.
+    return 1 + 9 + 9 * length;
+}
+
+
+ret_code_t nrf_drv_twi_xfer(nrf_drv_twi_t           const * p_instance,
+                            nrf_drv_twi_xfer_desc_t const * p_xfer_desc,
+                            uint32_t                        flags)
+{
+    uint32_t sensor = sensor_get(p_xfer_desc->address);
+    uint32_t bits;
+
+    if (m_xfer_busy)
+    {
+        bench_error_record("transfer started during another one");
+        return NRF_ERROR_BUSY;
+    }
+
+    switch (p_xfer_desc->type)
+    {
+        case NRF_DRV_TWI_XFER_TXRX:
+            bits  = segment_run(sensor, false, p_xfer_desc->p_primary_buf,
+                                p_xfer_desc->primary_length);
+            bits += segment_run(sensor, true, p_xfer_desc->p_secondary_buf,
+                                p_xfer_desc->secondary_length);
+            break;
+
+        case NRF_DRV_TWI_XFER_TX:
+            bits = segment_run(sensor, false, p_xfer_desc->p_primary_buf,
+                               p_xfer_desc->primary_length);
+            break;
+
+        case NRF_DRV_TWI_XFER_RX:
+            bits = segment_run(sensor, true, p_xfer_desc->p_primary_buf,
+                               p_xfer_desc->primary_length);
+            break;
+
+        default:
+            bench_error_record("unexpected transfer type");
+            return NRF_ERROR_NOT_SUPPORTED;
+    }
+    if (!(flags & NRF_DRV_TWI_FLAG_TX_NO_STOP))
+    {
+        bits++;
+    }
+
+    m_xfer      = *p_xfer_desc;
+    m_xfer_busy = true;
+    m_xfer_end  = m_now + (uint64_t)bits * BIT_NS;
+    return NRF_SUCCESS;
+}
+
+
+// TWI interrupt at the end of the transfer in progress.
+static void twi_irq(void)
+{
+    nrf_drv_twi_evt_t const event =
+    {
+        .type      = NRF_DRV_TWI_EVT_DONE,
+        .xfer_desc = m_xfer
+    };
+
+    m_now       = m_xfer_end;
+    m_xfer_busy = false;
+    m_twi_handler(&event, mp_twi_context);
+}
+
+
+static bool read_due(uint32_t idx)
+{
+    return (m_due_mask & (1UL << idx)) != 0;
+}
+
+
+static bool read_data_check(uint32_t idx, uint8_t const * p_data)
+{
+    nrf_twi_mngr_poll_desc_t const * p_desc = &m_descs[idx];
+
+    return memcmp(p_data,
+                  &m_regs[sensor_get(p_desc->dev_address)][p_desc->reg_address],
+                  p_desc->length) == 0;
+}
+
+
+static void poll_callback(ret_code_t result, uint32_t read_mask, void * p_user_data)
+{
+    CHECK(result == NRF_SUCCESS);
+    CHECK(m_pending != 0);
+    CHECK(read_mask == m_due_mask);
+    for (uint32_t i = 0; i < READS; i++)
+    {
+        if (read_due(i))
+        {
+            m_reads_expected[i]++;
+            CHECK(read_data_check(i, nrf_twi_mngr_poll_data_get(&m_poll, i)));
+        }
+    }
+    m_callbacks++;
+    m_pending = 0;
+}
+
+
+static void read_transaction_callback(ret_code_t result, void * p_user_data)
+{
+    read_transaction_t * p_read  = (read_transaction_t *)p_user_data;
+    uint32_t             latency = (timestamp_get() - m_tick_timestamp) & TIMESTAMP_MASK;
+
+    CHECK(result == NRF_SUCCESS);
+    CHECK(p_read->pending);
+    CHECK(read_data_check(p_read->idx, p_read->data));
+    p_read->pending = false;
+    m_reads_expected[p_read->idx]++;
+    m_latency_total[p_read->idx] += latency;
+    m_latency_max[p_read->idx]    = MAX(m_latency_max[p_read->idx], latency);
+    m_callbacks++;
+    m_pending--;
+}
+
+
+static void registers_update(void)
+{
+    for (uint32_t s = 0; s < SENSORS; s++)
+    {
+        for (uint32_t r = 0; r < 256; r++)
+        {
+            m_regs[s][r] = (uint8_t)bench_random();
+        }
+    }
+}
+
+
+static void tick(bench_mode_t mode)
+{
+    if (m_pending != 0)
+    {
+        // The reads of the previous tick are not done, the tick is skipped.
+        if (mode != MODE_SEPARATE)
+        {
+            CHECK(nrf_twi_mngr_poll_tick(&m_poll) == NRF_ERROR_BUSY);
+        }
+        return;
+    }
+
+    registers_update();
+    m_tick_timestamp = timestamp_get();
+    m_due_mask       = 0;
+    for (uint32_t i = 0; i < READS; i++)
+    {
+        if ((m_cycle % m_descs[i].period) == 0)
+        {
+            m_due_mask |= (1UL << i);
+        }
+    }
+    if (mode == MODE_SEPARATE)
+    {
+        for (uint32_t i = 0; i < READS; i++)
+        {
+            read_transaction_t * p_read = &m_read_transactions[i];
+
+            if (!read_due(i))
+            {
+                continue;
+            }
+            p_read->pending = true;
+            m_pending++;
+            CHECK(nrf_twi_mngr_schedule(&m_twi_mngr, &p_read->transaction) == NRF_SUCCESS);
+        }
+    }
+    else
+    {
+        m_pending = 1;
+        CHECK(nrf_twi_mngr_poll_tick(&m_poll) == NRF_SUCCESS);
+    }
+    m_cycle++;
+}
+
+
+static void reads_setup(bench_mode_t mode)
+{
+    static uint8_t const regs[READS_PER_SENSOR]    = { 0x28, 0x2E, 0x0F };
+    static uint8_t const lengths[READS_PER_SENSOR] = { 6, 2, 1 };
+    static uint8_t const periods[READS_PER_SENSOR] = { 1, 1, 4 };
+
+    nrf_twi_mngr_poll_init(&m_poll, poll_callback, NULL);
+    for (uint32_t i = 0; i < READS; i++)
+    {
+        nrf_twi_mngr_poll_desc_t * p_desc = &m_descs[i];
+        read_transaction_t *       p_read = &m_read_transactions[i];
+        uint32_t                   r      = i % READS_PER_SENSOR;
+        uint8_t                    idx;
+
+        p_desc->dev_address = SENSOR_ADDRESS(i / READS_PER_SENSOR);
+        p_desc->reg_address = regs[r];
+        p_desc->length      = lengths[r];
+        p_desc->period      = periods[r];
+        p_desc->flags       = ((mode == MODE_BURST) && (r < 2)) ? NRF_TWI_MNGR_POLL_BURST : 0;
+        if (mode != MODE_SEPARATE)
+        {
+            CHECK(nrf_twi_mngr_poll_add(&m_poll, p_desc, &idx) == NRF_SUCCESS);
+            CHECK(idx == i);
+        }
+
+        p_read->reg_address  = p_desc->reg_address;
+        p_read->idx          = (uint8_t)i;
+        p_read->pending      = false;
+        p_read->transfers[0] = (nrf_twi_mngr_transfer_t)
+            NRF_TWI_MNGR_WRITE(p_desc->dev_address, &p_read->reg_address, 1, NRF_TWI_MNGR_NO_STOP);
+        p_read->transfers[1] = (nrf_twi_mngr_transfer_t)
+            NRF_TWI_MNGR_READ(p_desc->dev_address, p_read->data, p_desc->length, 0);
+        p_read->transaction  = (nrf_twi_mngr_transaction_t)
+        {
+            .callback            = read_transaction_callback,
+            .p_user_data         = p_read,
+            .p_transfers         = p_read->transfers,
+            .number_of_transfers = ARRAY_SIZE(p_read->transfers)
+        };
+    }
+}
+
+
+static void run(bench_mode_t mode, uint32_t tick_us, uint32_t ticks)
+{
+    static char const * const names[] = { "separate", "batched", "burst" };
+
+    nrf_twi_mngr_stats_t      stats;
+    nrf_twi_mngr_poll_stats_t poll_stats;
+    uint64_t                  next_tick = 0;
+    uint64_t                  start;
+    uint32_t                  latency_max[2];
+    double                    latency_avg[2];
+
+    reads_setup(mode);
+    memset(m_reads_expected, 0, sizeof(m_reads_expected));
+    memset(m_latency_total, 0, sizeof(m_latency_total));
+    memset(m_latency_max, 0, sizeof(m_latency_max));
+    m_cycle     = 0;
+    m_callbacks = 0;
+    m_pending   = 0;
+    m_now       = 0;
+    nrf_twi_mngr_stats_reset(&m_twi_mngr);
+
+    start = bench_now_ns();
+    for (uint32_t t = 0; t < ticks; )
+    {
+        if (m_xfer_busy && (m_xfer_end <= next_tick))
+        {
+            twi_irq();
+            continue;
+        }
+        m_now = next_tick;
+        tick(mode);
+        next_tick += (uint64_t)tick_us * 1000;
+        t++;
+    }
+    while (m_xfer_busy)
+    {
+        twi_irq();
+    }
+    start = bench_now_ns() - start;
+
+    CHECK(m_pending == 0);
+    CHECK(nrf_twi_mngr_is_idle(&m_twi_mngr));
+    nrf_twi_mngr_stats_get(&m_twi_mngr, &stats);
+    nrf_twi_mngr_poll_stats_get(&m_poll, &poll_stats);
+
+    // Every due read was done once, with one latency measurement.
+    for (uint32_t i = 0; i < READS; i++)
+    {
+        uint32_t expected = (m_cycle + m_descs[i].period - 1) / m_descs[i].period;
+
+        CHECK(m_reads_expected[i] == expected);
+        if (mode != MODE_SEPARATE)
+        {
+            nrf_twi_mngr_poll_latency_t latency;
+
+            nrf_twi_mngr_poll_latency_get(&m_poll, (uint8_t)i, &latency);
+            CHECK(latency.reads == expected);
+            m_latency_total[i] = latency.latency_total;
+            m_latency_max[i]   = latency.latency_max;
+        }
+    }
+    if (mode != MODE_SEPARATE)
+    {
+        CHECK(poll_stats.cycles == m_cycle);
+        CHECK(poll_stats.overruns == ticks - m_cycle);
+        CHECK(poll_stats.merged == ((mode == MODE_BURST) ? m_cycle * SENSORS : 0));
+    }
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        uint32_t idx = i * (SENSORS - 1) * READS_PER_SENSOR;
+
+        latency_avg[i] = (double)m_latency_total[idx] / m_cycle;
+        latency_max[i] = m_latency_max[idx];
+    }
+
+    printf("%-8s tick %5u us: %5.2f callbacks, %5.2f interrupts, %4.0f us of bus per tick, "
+           "%4.0f Hz max, %3.0f%% busy, %4u of %u ticks skipped\n",
+           names[mode], tick_us,
+           (double)m_callbacks / m_cycle,
+           (double)stats.transfers / m_cycle,
+           (double)stats.busy_time / m_cycle,
+           1e6 * m_cycle / (double)stats.busy_time,
+           100.0 * (double)stats.busy_time / (double)stats.elapsed_time,
+           ticks - m_cycle, ticks);
+    printf("%-8s tick %5u us: data latency of first sensor %4.0f us (max %4u), "
+           "of last sensor %4.0f us (max %4u), %5.0f ns of host time per tick\n",
+           names[mode], tick_us, latency_avg[0], latency_max[0], latency_avg[1], latency_max[1],
+           (double)start / ticks);
+}
+
+
+static void test_poll_add(void)
+{
+    nrf_twi_mngr_poll_desc_t desc =
+    {
+        .dev_address = SENSOR_ADDRESS(0),
+        .reg_address = 0,
+        .length      = DATA_SIZE / 2,
+        .period      = 1
+    };
+
+    nrf_twi_mngr_poll_init(&m_poll, poll_callback, NULL);
+    CHECK(nrf_twi_mngr_poll_add(&m_poll, &desc, NULL) == NRF_SUCCESS);
+    CHECK(nrf_twi_mngr_poll_add(&m_poll, &desc, NULL) == NRF_SUCCESS);
+    CHECK(nrf_twi_mngr_poll_add(&m_poll, &desc, NULL) == NRF_ERROR_NO_MEM);
+    desc.length = 0;
+    CHECK(nrf_twi_mngr_poll_add(&m_poll, &desc, NULL) == NRF_ERROR_INVALID_PARAM);
+    desc.length = 1;
+    desc.period = 0;
+    CHECK(nrf_twi_mngr_poll_add(&m_poll, &desc, NULL) == NRF_ERROR_INVALID_PARAM);
+
+    nrf_twi_mngr_poll_init(&m_poll, poll_callback, NULL);
+    desc.period = 1;
+    for (uint32_t i = 0; i < READS; i++)
+    {
+        CHECK(nrf_twi_mngr_poll_add(&m_poll, &desc, NULL) == NRF_SUCCESS);
+    }
+    CHECK(nrf_twi_mngr_poll_add(&m_poll, &desc, NULL) == NRF_ERROR_NO_MEM);
+}
+
+
+int main(int argc, char ** argv)
+{
+    uint32_t const             ticks  = (argc > 1) ? strtoul(argv[1], NULL, 0) : 100000;
+    nrf_drv_twi_config_t const config =
+    {
+        .scl       = 27,
+        .sda       = 26,
+        .frequency = NRF_DRV_TWI_FREQ_400K
+    };
+
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_twi_mngr, &config));
+    nrf_twi_mngr_timestamp_func_set(&m_twi_mngr, timestamp_get, TIMESTAMP_MASK);
+
+    test_poll_add();
+    for (bench_mode_t mode = MODE_SEPARATE; mode <= MODE_BURST; mode++)
+    {
+        run(mode, 5000, ticks);
+        run(mode, 1000, ticks);
+    }
+
+    if (bench_failed())
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
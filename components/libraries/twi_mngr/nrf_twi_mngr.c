@@ -103,7 +103,26 @@ static ret_code_t start_transfer(nrf_twi_mngr_t const * p_nrf_twi_mngr)
         flags = (p_transfer->flags & NRF_TWI_MNGR_NO_STOP) ? NRF_DRV_TWI_FLAG_TX_NO_STOP : 0;
     }
 
-    return nrf_drv_twi_xfer(&p_nrf_twi_mngr->twi, &xfer_desc, flags);
+    ret_code_t result = nrf_drv_twi_xfer(&p_nrf_twi_mngr->twi, &xfer_desc, flags);
+    if (result == NRF_SUCCESS)
+    {
+        p_cb->stats.transfers++;
+    }
+    return result;
+}
+
+
+static uint32_t timestamp_get(nrf_twi_mngr_cb_t const * p_cb)
+{
+    return (p_cb->timestamp_func != NULL) ? p_cb->timestamp_func() : 0;
+}
+
+
+// Accumulates the time elapsed since the last call, so that the counter can wrap.
+static void elapsed_time_update(nrf_twi_mngr_cb_t * p_cb, uint32_t timestamp)
+{
+    p_cb->stats.elapsed_time += (timestamp - p_cb->elapsed_timestamp) & p_cb->timestamp_mask;
+    p_cb->elapsed_timestamp   = timestamp;
 }
 
 
@@ -112,6 +131,14 @@ static void transaction_end_signal(nrf_twi_mngr_t const * p_nrf_twi_mngr,
 {
     ASSERT(p_nrf_twi_mngr != NULL);
 
+    // Pointer for cleaner code.
+    nrf_twi_mngr_cb_t * p_cb      = p_nrf_twi_mngr->p_nrf_twi_mngr_cb;
+    uint32_t            timestamp = timestamp_get(p_cb);
+
+    p_cb->stats.transactions++;
+    p_cb->stats.busy_time += (timestamp - p_cb->transaction_timestamp) & p_cb->timestamp_mask;
+    elapsed_time_update(p_cb, timestamp);
+
     if (p_nrf_twi_mngr->p_nrf_twi_mngr_cb->p_current_transaction->callback)
     {
         // [use a local variable to avoid using two volatile variables in one
@@ -184,7 +211,8 @@ static void start_pending_transaction(nrf_twi_mngr_t const * p_nrf_twi_mngr,
             }
 
             // Try to start first transfer for this new transaction.
-            p_cb->current_transfer_idx = 0;
+            p_cb->current_transfer_idx  = 0;
+            p_cb->transaction_timestamp = timestamp_get(p_cb);
             result = start_transfer(p_nrf_twi_mngr);
 
             // If transaction started successfully there is nothing more to do here now.
@@ -224,6 +252,14 @@ static void twi_event_handler(nrf_drv_twi_evt_t const * p_event,
         // [use a local variable to avoid using two volatile variables in one
         //  expression]
         uint8_t current_transfer_idx = p_nrf_twi_mngr->p_nrf_twi_mngr_cb->current_transfer_idx;
+        nrf_twi_mngr_transaction_t const * p_current_transaction =
+            p_nrf_twi_mngr->p_nrf_twi_mngr_cb->p_current_transaction;
+
+        if (p_current_transaction->transfer_callback)
+        {
+            p_current_transaction->transfer_callback(current_transfer_idx,
+                                                     p_current_transaction->p_user_data);
+        }
         ++current_transfer_idx;
         if (current_transfer_idx <
                 p_nrf_twi_mngr->p_nrf_twi_mngr_cb->p_current_transaction->number_of_transfers)
@@ -280,6 +316,7 @@ ret_code_t nrf_twi_mngr_init(nrf_twi_mngr_t const *        p_nrf_twi_mngr,
     p_nrf_twi_mngr->p_nrf_twi_mngr_cb->default_configuration   = *p_default_twi_config;
     p_nrf_twi_mngr->p_nrf_twi_mngr_cb->p_current_configuration =
         &p_nrf_twi_mngr->p_nrf_twi_mngr_cb->default_configuration;
+    nrf_twi_mngr_stats_reset(p_nrf_twi_mngr);
 
     return NRF_SUCCESS;
 }
@@ -347,7 +384,8 @@ ret_code_t nrf_twi_mngr_perform(nrf_twi_mngr_t const *          p_nrf_twi_mngr,
         .p_user_data         = (void *)&cb_data,
         .p_transfers         = p_transfers,
         .number_of_transfers = number_of_transfers,
-        .p_required_twi_cfg  = p_config
+        .p_required_twi_cfg  = p_config,
+        .transfer_callback   = NULL
     };
 
     ret_code_t result = nrf_twi_mngr_schedule(p_nrf_twi_mngr, &internal_transaction);
@@ -363,4 +401,49 @@ ret_code_t nrf_twi_mngr_perform(nrf_twi_mngr_t const *          p_nrf_twi_mngr,
 
     return cb_data.transaction_result;
 }
+
+
+void nrf_twi_mngr_timestamp_func_set(nrf_twi_mngr_t const *        p_nrf_twi_mngr,
+                                     nrf_twi_mngr_timestamp_func_t timestamp_func,
+                                     uint32_t                      timestamp_mask)
+{
+    ASSERT(p_nrf_twi_mngr != NULL);
+    ASSERT((timestamp_mask & (timestamp_mask + 1)) == 0);
+
+    nrf_twi_mngr_cb_t * p_cb = p_nrf_twi_mngr->p_nrf_twi_mngr_cb;
+
+    CRITICAL_REGION_ENTER();
+    p_cb->timestamp_func = timestamp_func;
+    p_cb->timestamp_mask = (timestamp_func != NULL) ? timestamp_mask : 0;
+    CRITICAL_REGION_EXIT();
+    nrf_twi_mngr_stats_reset(p_nrf_twi_mngr);
+}
+
+
+void nrf_twi_mngr_stats_get(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                            nrf_twi_mngr_stats_t * p_stats)
+{
+    ASSERT(p_nrf_twi_mngr != NULL);
+    ASSERT(p_stats != NULL);
+
+    nrf_twi_mngr_cb_t * p_cb = p_nrf_twi_mngr->p_nrf_twi_mngr_cb;
+
+    CRITICAL_REGION_ENTER();
+    elapsed_time_update(p_cb, timestamp_get(p_cb));
+    *p_stats = p_cb->stats;
+    CRITICAL_REGION_EXIT();
+}
+
+
+void nrf_twi_mngr_stats_reset(nrf_twi_mngr_t const * p_nrf_twi_mngr)
+{
+    ASSERT(p_nrf_twi_mngr != NULL);
+
+    nrf_twi_mngr_cb_t * p_cb = p_nrf_twi_mngr->p_nrf_twi_mngr_cb;
+
+    CRITICAL_REGION_ENTER();
+    memset(&p_cb->stats, 0, sizeof(p_cb->stats));
+    p_cb->elapsed_timestamp = timestamp_get(p_cb);
+    CRITICAL_REGION_EXIT();
+}
 #endif //NRF_MODULE_ENABLED(NRF_TWI_MNGR)
@@ -151,6 +151,21 @@ extern "C" {
  */
 typedef void (* nrf_twi_mngr_callback_t)(ret_code_t result, void * p_user_data);
 
+/**
+ * @brief TWI transfer callback prototype.
+ *
+ * @param     transfer_idx Index of the last transfer done, within the transaction. A write
+ *                         transfer combined with the next one is done with it.
+ * @param[in] p_user_data  Pointer to user data defined in transaction
+ *                         descriptor.
+ */
+typedef void (* nrf_twi_mngr_transfer_callback_t)(uint8_t transfer_idx, void * p_user_data);
+
+/**
+ * @brief Time stamp function prototype, see @ref nrf_twi_mngr_timestamp_func_set.
+ */
+typedef uint32_t (* nrf_twi_mngr_timestamp_func_t)(void);
+
 /**
  * @brief TWI transfer descriptor.
  */
@@ -179,8 +194,23 @@ typedef struct {
 
     nrf_drv_twi_config_t const *    p_required_twi_cfg;
     ///< Pointer to instance hardware configuration.
+
+    nrf_twi_mngr_transfer_callback_t transfer_callback;
+    ///< User-specified function to be called after each successful transfer, from the
+    ///< TWI interrupt. NULL if such functionality is not needed.
 } nrf_twi_mngr_transaction_t;
 
+/**
+ * @brief TWI transaction manager statistics. Times are in units of the time stamp function,
+ *        see @ref nrf_twi_mngr_timestamp_func_set.
+ */
+typedef struct {
+    uint32_t transactions;  ///< Number of transactions finished.
+    uint32_t transfers;     ///< Number of transfers started on the driver, each ending with an interrupt.
+    uint64_t busy_time;     ///< Time spent in transactions, from their start to their end.
+    uint64_t elapsed_time;  ///< Time since the statistics were reset.
+} nrf_twi_mngr_stats_t;
+
 /**
  * @brief TWI instance control block.
  */
@@ -196,6 +226,21 @@ typedef struct {
 
     uint8_t volatile current_transfer_idx;
     ///< Index of currently performed transfer (within current transaction).
+
+    nrf_twi_mngr_timestamp_func_t timestamp_func;
+    ///< Time stamp function of the statistics, NULL if not set.
+
+    uint32_t timestamp_mask;
+    ///< Mask of the time stamp counter bits.
+
+    uint32_t transaction_timestamp;
+    ///< Time stamp of the start of the current transaction.
+
+    uint32_t elapsed_timestamp;
+    ///< Time stamp up to which @ref nrf_twi_mngr_stats_t::elapsed_time is counted.
+
+    nrf_twi_mngr_stats_t stats;
+    ///< Statistics of the instance.
 } nrf_twi_mngr_cb_t;
 
 /**
@@ -313,6 +358,42 @@ ret_code_t nrf_twi_mngr_perform(nrf_twi_mngr_t const *          p_nrf_twi_mngr,
                                 uint8_t                         number_of_transfers,
                                 void                            (* user_function)(void));
 
+/**
+ * @brief Function for setting the time stamp function used for the time statistics.
+ *
+ * Without it, the statistics only count transactions and transfers. The elapsed time is
+ * accumulated whenever a transaction ends or the statistics are read, which must happen at least
+ * once per period of the counter.
+ *
+ * @param[in] p_nrf_twi_mngr Pointer to the TWI transaction manager instance.
+ * @param[in] timestamp_func Function returning a free-running counter, e.g. app_timer_cnt_get.
+ * @param[in] timestamp_mask Mask of the counter bits, e.g. 0xFFFFFF for the 24 bit RTC counter.
+ *                           It must be a power of two minus one.
+ */
+void nrf_twi_mngr_timestamp_func_set(nrf_twi_mngr_t const *        p_nrf_twi_mngr,
+                                     nrf_twi_mngr_timestamp_func_t timestamp_func,
+                                     uint32_t                      timestamp_mask);
+
+/**
+ * @brief Function for getting the statistics of a TWI transaction manager instance.
+ *
+ * The bus utilization is @ref nrf_twi_mngr_stats_t::busy_time divided by
+ * @ref nrf_twi_mngr_stats_t::elapsed_time.
+ *
+ * @param[in]  p_nrf_twi_mngr Pointer to the TWI transaction manager instance.
+ * @param[out] p_stats        Statistics since the instance was initialized or the statistics
+ *                            were reset.
+ */
+void nrf_twi_mngr_stats_get(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                            nrf_twi_mngr_stats_t * p_stats);
+
+/**
+ * @brief Function for resetting the statistics of a TWI transaction manager instance.
+ *
+ * @param[in] p_nrf_twi_mngr Pointer to the TWI transaction manager instance.
+ */
+void nrf_twi_mngr_stats_reset(nrf_twi_mngr_t const * p_nrf_twi_mngr);
+
 /**
  * @brief Function for getting the current state of a TWI transaction manager
  *        instance.
@@ -0,0 +1,296 @@
+/**
+ * Copyright (c) 2015 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_TWI_MNGR)
+#include "nrf_twi_mngr_poll.h"
+#include "nrf_assert.h"
+#include "app_util_platform.h"
+
+
+static uint32_t timestamp_get(nrf_twi_mngr_poll_t const * p_poll)
+{
+    nrf_twi_mngr_cb_t const * p_mngr_cb = p_poll->p_nrf_twi_mngr->p_nrf_twi_mngr_cb;
+
+    return (p_mngr_cb->timestamp_func != NULL) ? p_mngr_cb->timestamp_func() : 0;
+}
+
+
+// Two reads can be merged if the second one continues the first one on the same device, so that
+// the device reads the registers of both in a row into consecutive bytes of the data buffer.
+static bool burst_merge_possible(nrf_twi_mngr_poll_entry_t const * p_prev,
+                                 nrf_twi_mngr_poll_entry_t const * p_entry,
+                                 nrf_twi_mngr_transfer_t const *   p_prev_read)
+{
+    return (p_prev->desc.flags & NRF_TWI_MNGR_POLL_BURST) &&
+           (p_entry->desc.flags & NRF_TWI_MNGR_POLL_BURST) &&
+           (p_prev->desc.dev_address == p_entry->desc.dev_address) &&
+           ((uint8_t)(p_prev->desc.reg_address + p_prev->desc.length) ==
+            p_entry->desc.reg_address) &&
+           (p_prev->data_offset + p_prev->desc.length == p_entry->data_offset) &&
+           (p_prev_read->length + p_entry->desc.length <= UINT8_MAX);
+}
+
+
+// Called after each transfer of a tick, from the TWI interrupt.
+static void poll_transfer_cb(uint8_t transfer_idx, void * p_user_data)
+{
+    nrf_twi_mngr_poll_t const * p_poll = (nrf_twi_mngr_poll_t const *)p_user_data;
+    nrf_twi_mngr_poll_cb_t *    p_cb   = p_poll->p_cb;
+    uint32_t                    timestamp_mask =
+        p_poll->p_nrf_twi_mngr->p_nrf_twi_mngr_cb->timestamp_mask;
+    uint32_t                    latency =
+        (timestamp_get(p_poll) - p_cb->tick_timestamp) & timestamp_mask;
+    uint8_t                     idx;
+
+    // Reads are done in the order of their indexes, so the first ones not measured yet are the
+    // ones just done.
+    for (idx = p_cb->latency_idx; idx < p_cb->count; idx++)
+    {
+        nrf_twi_mngr_poll_entry_t * p_entry = &p_poll->p_entries[idx];
+
+        if (!(p_cb->read_mask & (1UL << idx)))
+        {
+            continue;
+        }
+        if (p_entry->transfer_idx > transfer_idx)
+        {
+            break;
+        }
+        p_entry->latency.reads++;
+        p_entry->latency.latency_total += latency;
+        if (latency > p_entry->latency.latency_max)
+        {
+            p_entry->latency.latency_max = latency;
+        }
+    }
+    p_cb->latency_idx = idx;
+}
+
+
+static void poll_transaction_cb(ret_code_t result, void * p_user_data)
+{
+    nrf_twi_mngr_poll_t const * p_poll = (nrf_twi_mngr_poll_t const *)p_user_data;
+    nrf_twi_mngr_poll_cb_t *    p_cb   = p_poll->p_cb;
+
+    if (p_cb->callback != NULL)
+    {
+        p_cb->callback(result, p_cb->read_mask, p_cb->p_user_data);
+    }
+    // The data stays untouched until the callback returns.
+    p_cb->busy = false;
+}
+
+
+void nrf_twi_mngr_poll_init(nrf_twi_mngr_poll_t const *  p_poll,
+                            nrf_twi_mngr_poll_callback_t callback,
+                            void *                       p_user_data)
+{
+    ASSERT(p_poll != NULL);
+
+    nrf_twi_mngr_poll_cb_t * p_cb = p_poll->p_cb;
+
+    memset(p_cb, 0, sizeof(*p_cb));
+    p_cb->callback    = callback;
+    p_cb->p_user_data = p_user_data;
+}
+
+
+ret_code_t nrf_twi_mngr_poll_add(nrf_twi_mngr_poll_t const *      p_poll,
+                                 nrf_twi_mngr_poll_desc_t const * p_desc,
+                                 uint8_t *                        p_idx)
+{
+    ASSERT(p_poll != NULL);
+    ASSERT(p_desc != NULL);
+
+    nrf_twi_mngr_poll_cb_t * p_cb = p_poll->p_cb;
+
+    if ((p_desc->length == 0) || (p_desc->period == 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (p_cb->busy)
+    {
+        return NRF_ERROR_BUSY;
+    }
+    if ((p_cb->count >= p_poll->max_reads) ||
+        (p_cb->data_used + p_desc->length > p_poll->data_size))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    nrf_twi_mngr_poll_entry_t * p_entry = &p_poll->p_entries[p_cb->count];
+
+    memset(p_entry, 0, sizeof(*p_entry));
+    p_entry->desc        = *p_desc;
+    p_entry->data_offset = p_cb->data_used;
+    p_cb->data_used     += p_desc->length;
+
+    if (p_idx != NULL)
+    {
+        *p_idx = p_cb->count;
+    }
+    p_cb->count++;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_twi_mngr_poll_tick(nrf_twi_mngr_poll_t const * p_poll)
+{
+    ASSERT(p_poll != NULL);
+
+    nrf_twi_mngr_poll_cb_t *    p_cb           = p_poll->p_cb;
+    nrf_twi_mngr_transfer_t *   p_transfers    = p_poll->p_transfers;
+    nrf_twi_mngr_poll_entry_t * p_prev         = NULL;
+    uint8_t                     transfer_count = 0;
+    uint32_t                    read_mask      = 0;
+    bool                        busy;
+    uint8_t                     idx;
+
+    CRITICAL_REGION_ENTER();
+    busy = p_cb->busy;
+    p_cb->busy = true;
+    CRITICAL_REGION_EXIT();
+
+    if (busy)
+    {
+        p_cb->stats.overruns++;
+        return NRF_ERROR_BUSY;
+    }
+
+    for (idx = 0; idx < p_cb->count; idx++)
+    {
+        nrf_twi_mngr_poll_entry_t * p_entry = &p_poll->p_entries[idx];
+
+        if (p_entry->ticks_left != 0)
+        {
+            p_entry->ticks_left--;
+            p_prev = NULL;
+            continue;
+        }
+        p_entry->ticks_left = p_entry->desc.period - 1;
+        read_mask |= (1UL << idx);
+
+        if ((p_prev != NULL) &&
+            burst_merge_possible(p_prev, p_entry, &p_transfers[transfer_count - 1]))
+        {
+            p_transfers[transfer_count - 1].length += p_entry->desc.length;
+            p_cb->stats.merged++;
+        }
+        else
+        {
+            p_transfers[transfer_count++] = (nrf_twi_mngr_transfer_t)
+                NRF_TWI_MNGR_WRITE(p_entry->desc.dev_address,
+                                   &p_entry->desc.reg_address,
+                                   1,
+                                   NRF_TWI_MNGR_NO_STOP);
+            p_transfers[transfer_count++] = (nrf_twi_mngr_transfer_t)
+                NRF_TWI_MNGR_READ(p_entry->desc.dev_address,
+                                  &p_poll->p_data[p_entry->data_offset],
+                                  p_entry->desc.length,
+                                  0);
+        }
+        p_entry->transfer_idx = transfer_count - 1;
+        p_prev = p_entry;
+    }
+
+    if (read_mask == 0)
+    {
+        p_cb->busy = false;
+        return NRF_SUCCESS;
+    }
+
+    p_cb->stats.cycles++;
+    p_cb->read_mask      = read_mask;
+    p_cb->latency_idx    = 0;
+    p_cb->tick_timestamp = timestamp_get(p_poll);
+    p_cb->transaction    = (nrf_twi_mngr_transaction_t)
+    {
+        .callback            = poll_transaction_cb,
+        .p_user_data         = (void *)p_poll,
+        .p_transfers         = p_transfers,
+        .number_of_transfers = transfer_count,
+        .p_required_twi_cfg  = NULL,
+        .transfer_callback   = poll_transfer_cb
+    };
+
+    ret_code_t result = nrf_twi_mngr_schedule(p_poll->p_nrf_twi_mngr, &p_cb->transaction);
+    if (result != NRF_SUCCESS)
+    {
+        p_cb->busy = false;
+    }
+    return result;
+}
+
+
+uint8_t const * nrf_twi_mngr_poll_data_get(nrf_twi_mngr_poll_t const * p_poll, uint8_t idx)
+{
+    ASSERT(p_poll != NULL);
+    ASSERT(idx < p_poll->p_cb->count);
+
+    return &p_poll->p_data[p_poll->p_entries[idx].data_offset];
+}
+
+
+void nrf_twi_mngr_poll_latency_get(nrf_twi_mngr_poll_t const *   p_poll,
+                                   uint8_t                       idx,
+                                   nrf_twi_mngr_poll_latency_t * p_latency)
+{
+    ASSERT(p_poll != NULL);
+    ASSERT(idx < p_poll->p_cb->count);
+    ASSERT(p_latency != NULL);
+
+    CRITICAL_REGION_ENTER();
+    *p_latency = p_poll->p_entries[idx].latency;
+    CRITICAL_REGION_EXIT();
+}
+
+
+void nrf_twi_mngr_poll_stats_get(nrf_twi_mngr_poll_t const * p_poll,
+                                 nrf_twi_mngr_poll_stats_t * p_stats)
+{
+    ASSERT(p_poll != NULL);
+    ASSERT(p_stats != NULL);
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = p_poll->p_cb->stats;
+    CRITICAL_REGION_EXIT();
+}
+#endif //NRF_MODULE_ENABLED(NRF_TWI_MNGR)
@@ -0,0 +1,274 @@
+/**
+ * Copyright (c) 2015 - 2019, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef NRF_TWI_MNGR_POLL_H__
+#define NRF_TWI_MNGR_POLL_H__
+
+#include <stdint.h>
+#include "nrf_twi_mngr.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup nrf_twi_mngr_poll TWI periodic read batching
+ * @{
+ * @ingroup nrf_twi_mngr
+ *
+ * @brief Module for reading registers of TWI devices periodically, in one transaction per tick.
+ *
+ * Periodic reads are registered once. On each tick, the reads which are due are put in a single
+ * TWI manager transaction, each as a register address write followed by a data read with
+ * repeated start, and one callback reports the end of all of them. Reads of consecutive
+ * registers of the same device can be merged into a single burst read.
+ */
+
+/**
+ * @brief Flag indicating that the device increments the register address while reading, so
+ *        that this read can be merged with the read registered just before it when it continues
+ *        it on the same device (both reads must have the flag).
+ */
+#define NRF_TWI_MNGR_POLL_BURST     0x01
+
+/**
+ * @brief Maximum number of periodic reads of an instance.
+ */
+#define NRF_TWI_MNGR_POLL_MAX       32
+
+/**
+ * @brief Periodic read descriptor.
+ */
+typedef struct {
+    uint8_t dev_address;    ///< Slave address.
+    uint8_t reg_address;    ///< Address of the first register to read.
+    uint8_t length;         ///< Number of bytes to read.
+    uint8_t period;         ///< Number of ticks between two reads.
+    uint8_t flags;          ///< Read flags (see @ref NRF_TWI_MNGR_POLL_BURST).
+} nrf_twi_mngr_poll_desc_t;
+
+/**
+ * @brief Latency of a periodic read, in units of the time stamp function of the TWI transaction
+ *        manager (see @ref nrf_twi_mngr_timestamp_func_set), from the tick to the end of the
+ *        read.
+ */
+typedef struct {
+    uint32_t reads;         ///< Number of reads done.
+    uint32_t latency_max;   ///< Longest latency.
+    uint64_t latency_total; ///< Sum of the latencies.
+} nrf_twi_mngr_poll_latency_t;
+
+/**
+ * @brief Statistics of a periodic read instance.
+ */
+typedef struct {
+    uint32_t cycles;        ///< Number of ticks with at least one read.
+    uint32_t overruns;      ///< Number of ticks skipped because the reads of a previous tick were not done.
+    uint32_t merged;        ///< Number of reads merged into the read registered before them.
+} nrf_twi_mngr_poll_stats_t;
+
+/**
+ * @brief Callback prototype, called when the reads of a tick are done.
+ *
+ * @param     result      Result of the transaction (NRF_SUCCESS on success,
+ *                        otherwise a relevant error code).
+ * @param     read_mask   Bit mask of the reads done in this tick, by index
+ *                        (see @ref nrf_twi_mngr_poll_add).
+ * @param[in] p_user_data Pointer to user data given to @ref nrf_twi_mngr_poll_init.
+ */
+typedef void (* nrf_twi_mngr_poll_callback_t)(ret_code_t result,
+                                              uint32_t   read_mask,
+                                              void *     p_user_data);
+
+/**
+ * @brief Periodic read entry.
+ *
+ * @note For internal use only.
+ */
+typedef struct {
+    nrf_twi_mngr_poll_desc_t    desc;           ///< Copy of the descriptor, holding the register address to write.
+    uint16_t                    data_offset;    ///< Offset of the read data in the data buffer.
+    uint8_t                     ticks_left;     ///< Number of ticks until the next read.
+    uint8_t                     transfer_idx;   ///< Index of the read transfer in the current tick.
+    nrf_twi_mngr_poll_latency_t latency;        ///< Latency of the read.
+} nrf_twi_mngr_poll_entry_t;
+
+/**
+ * @brief Periodic read instance control block.
+ *
+ * @note For internal use only.
+ */
+typedef struct {
+    nrf_twi_mngr_transaction_t   transaction;       ///< Transaction of the current tick.
+    nrf_twi_mngr_poll_callback_t callback;          ///< User callback.
+    void *                       p_user_data;       ///< User data of the callback.
+    uint32_t                     tick_timestamp;    ///< Time stamp of the current tick.
+    uint32_t                     read_mask;         ///< Reads of the current tick.
+    uint16_t                     data_used;         ///< Bytes of the data buffer used by the reads.
+    uint8_t                      count;             ///< Number of periodic reads.
+    uint8_t                      latency_idx;       ///< Index of the first read of the current tick whose latency is not measured yet.
+    bool volatile                busy;              ///< Flag indicating that the reads of a tick are not done.
+    nrf_twi_mngr_poll_stats_t    stats;             ///< Statistics of the instance.
+} nrf_twi_mngr_poll_cb_t;
+
+/**
+ * @brief Periodic read instance.
+ */
+typedef struct {
+    nrf_twi_mngr_poll_cb_t *    p_cb;           ///< Control block of instance.
+    nrf_twi_mngr_t const *      p_nrf_twi_mngr; ///< TWI transaction manager used for the reads.
+    nrf_twi_mngr_poll_entry_t * p_entries;      ///< Periodic reads.
+    nrf_twi_mngr_transfer_t *   p_transfers;    ///< Transfers of a tick, two per read.
+    uint8_t *                   p_data;         ///< Buffer of the read data.
+    uint16_t                    data_size;      ///< Size of the data buffer.
+    uint8_t                     max_reads;      ///< Maximum number of periodic reads.
+} nrf_twi_mngr_poll_t;
+
+/**
+ * @brief Macro for defining a periodic read instance.
+ *
+ * @param[in] _name         Name of instance to be created.
+ * @param[in] _p_twi_mngr   Pointer to the TWI transaction manager instance.
+ * @param[in] _max_reads    Maximum number of periodic reads, up to @ref NRF_TWI_MNGR_POLL_MAX.
+ * @param[in] _data_size    Size of the buffer holding the data of all reads.
+ */
+#define NRF_TWI_MNGR_POLL_DEF(_name, _p_twi_mngr, _max_reads, _data_size)                     \
+    STATIC_ASSERT((_max_reads) <= NRF_TWI_MNGR_POLL_MAX);                                     \
+    static nrf_twi_mngr_poll_entry_t CONCAT_2(_name, _entries)[(_max_reads)];                 \
+    static nrf_twi_mngr_transfer_t   CONCAT_2(_name, _transfers)[2 * (_max_reads)];           \
+    static uint8_t                   CONCAT_2(_name, _data)[(_data_size)];                    \
+    static nrf_twi_mngr_poll_cb_t    CONCAT_2(_name, _cb);                                    \
+    static const nrf_twi_mngr_poll_t _name =                                                  \
+    {                                                                                         \
+        .p_cb           = &CONCAT_2(_name, _cb),                                              \
+        .p_nrf_twi_mngr = (_p_twi_mngr),                                                      \
+        .p_entries      = CONCAT_2(_name, _entries),                                          \
+        .p_transfers    = CONCAT_2(_name, _transfers),                                        \
+        .p_data         = CONCAT_2(_name, _data),                                             \
+        .data_size      = (_data_size),                                                       \
+        .max_reads      = (_max_reads)                                                        \
+    }
+
+/**
+ * @brief Function for initializing a periodic read instance.
+ *
+ * @param[in] p_poll      Pointer to the instance to be initialized.
+ * @param[in] callback    Function to be called when the reads of a tick are done.
+ * @param[in] p_user_data Pointer to user data to be passed to the callback.
+ */
+void nrf_twi_mngr_poll_init(nrf_twi_mngr_poll_t const *  p_poll,
+                            nrf_twi_mngr_poll_callback_t callback,
+                            void *                       p_user_data);
+
+/**
+ * @brief Function for registering a periodic read.
+ *
+ * The first read is done on the next tick. Reads are done in the order of registration.
+ *
+ * @param[in]  p_poll Pointer to the periodic read instance.
+ * @param[in]  p_desc Pointer to the read descriptor. It is copied.
+ * @param[out] p_idx  Index of the read, used in the read mask of the callback and to get the
+ *                    data. Can be NULL.
+ *
+ * @retval NRF_SUCCESS             If the read has been registered.
+ * @retval NRF_ERROR_INVALID_PARAM If the length or the period is 0.
+ * @retval NRF_ERROR_NO_MEM        If there is no room for another read or its data.
+ * @retval NRF_ERROR_BUSY          If the reads of a tick are in progress.
+ */
+ret_code_t nrf_twi_mngr_poll_add(nrf_twi_mngr_poll_t const *      p_poll,
+                                 nrf_twi_mngr_poll_desc_t const * p_desc,
+                                 uint8_t *                        p_idx);
+
+/**
+ * @brief Function for starting the reads which are due on a tick.
+ *
+ * It is meant to be called from a periodic timer handler. The reads are scheduled as one
+ * transaction of the TWI transaction manager.
+ *
+ * @param[in] p_poll Pointer to the periodic read instance.
+ *
+ * @retval NRF_SUCCESS      If the reads have been scheduled, or none was due.
+ * @retval NRF_ERROR_BUSY   If the reads of a previous tick are not done. The tick is skipped.
+ * @retval NRF_ERROR_NO_MEM If the queue of the TWI transaction manager is full.
+ */
+ret_code_t nrf_twi_mngr_poll_tick(nrf_twi_mngr_poll_t const * p_poll);
+
+/**
+ * @brief Function for getting the data of a periodic read.
+ *
+ * The data is valid in the callback of a tick whose read mask contains the read, and until the
+ * next tick.
+ *
+ * @param[in] p_poll Pointer to the periodic read instance.
+ * @param[in] idx    Index of the read.
+ *
+ * @return Pointer to the data.
+ */
+uint8_t const * nrf_twi_mngr_poll_data_get(nrf_twi_mngr_poll_t const * p_poll, uint8_t idx);
+
+/**
+ * @brief Function for getting the latency of a periodic read.
+ *
+ * @param[in]  p_poll    Pointer to the periodic read instance.
+ * @param[in]  idx       Index of the read.
+ * @param[out] p_latency Latency of the read.
+ */
+void nrf_twi_mngr_poll_latency_get(nrf_twi_mngr_poll_t const *   p_poll,
+                                   uint8_t                       idx,
+                                   nrf_twi_mngr_poll_latency_t * p_latency);
+
+/**
+ * @brief Function for getting the statistics of a periodic read instance.
+ *
+ * @param[in]  p_poll  Pointer to the periodic read instance.
+ * @param[out] p_stats Statistics of the instance.
+ */
+void nrf_twi_mngr_poll_stats_get(nrf_twi_mngr_poll_t const * p_poll,
+                                 nrf_twi_mngr_poll_stats_t * p_stats);
+
+/**
+ *@}
+ **/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_TWI_MNGR_POLL_H__
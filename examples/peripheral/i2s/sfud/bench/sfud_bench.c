@@ -0,0 +1,336 @@
+/*
+ * This file is part of the Serial Flash Universal Driver Library.
+ *
+ * Copyright (c) 2016-2018, Armink, <armink.ztl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Throughput and latency benchmark of SFUD on the host simulated flash.
+ *
+ *           Build it on host from the sfud directory:
+ *           cc -O2 -DSFUD_USING_HOST_SIM -Iinc -Iport src/sfud.c src/sfud_sfdp.c port/sfud_port_sim.c
+ *              bench/sfud_bench.c -o sfud_bench
+ *
+ *           Usage: sfud_bench [gd25q16|mx25l64] [op size in bytes] [op count] [read data lines, 1 2 or 4]
+ *
+ *           The erase-read patterns read 256 bytes every 500 us while 256 KB is erased by the erase scheduler, with
+ *           and without erase suspend, they show the read latency during background erase.
+ *
+ *           Throughput and latency are measured on the simulated flash clock, so they show the time which the
+ *           same SFUD code spends on the hardware port. The CPU column is the host time spent in SFUD and the
+ *           simulator per operation, it shows the software overhead only.
+ * Created on: 2026-10-17
+ */
+
+#include <sfud.h>
+#include <string.h>
+#include <time.h>
+#include "sfud_port_sim.h"
+
+#define BENCH_DEFAULT_OP_SIZE                    4096
+#define BENCH_DEFAULT_OP_COUNT                   256
+#define BENCH_MAX_OP_SIZE                        (64L * 1024L)
+#define BENCH_MAX_OP_COUNT                       (64L * 1024L)
+#define BENCH_ERASE_SIZE                         (256L * 1024L)
+#define BENCH_ERASE_READ_SIZE                    256
+#define BENCH_ERASE_READ_GAP_NS                  500000
+
+typedef enum {
+    BENCH_SEQ_READ,
+    BENCH_RAND_READ,
+    BENCH_SEQ_WRITE,
+    BENCH_RAND_WRITE,
+    BENCH_SEQ_ERASE_WRITE,
+    BENCH_RAND_ERASE_WRITE,
+} bench_pattern;
+
+static const char * const pattern_name[] = {
+    [BENCH_SEQ_READ]         = "seq read",
+    [BENCH_RAND_READ]        = "rand read",
+    [BENCH_SEQ_WRITE]        = "seq write",
+    [BENCH_RAND_WRITE]       = "rand write",
+    [BENCH_SEQ_ERASE_WRITE]  = "seq erase-write",
+    [BENCH_RAND_ERASE_WRITE] = "rand erase-write",
+};
+
+static uint8_t op_buf[BENCH_MAX_OP_SIZE];
+static uint64_t latency_ns[BENCH_MAX_OP_COUNT];
+static uint32_t rand_state = 0x12345678;
+
+static uint32_t bench_rand(void) {
+    /* xorshift32, the same sequence on each run */
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+static uint64_t host_time_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static size_t gcd(size_t a, size_t b) {
+    while (b) {
+        size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t *sorted, size_t count, unsigned int pct) {
+    size_t index = (count * pct + 99) / 100;
+
+    return sorted[index ? index - 1 : 0];
+}
+
+/**
+ * run one access pattern and print its result
+ *
+ * @param flash flash device
+ * @param pattern access pattern
+ * @param op_size bytes of each operation, aligned to the flash erase granularity for erase-write patterns
+ * @param op_count operation counts
+ *
+ * @return result
+ */
+static sfud_err bench_run(const sfud_flash *flash, bench_pattern pattern, size_t op_size, size_t op_count) {
+    sfud_err result = SFUD_SUCCESS;
+    size_t slots = flash->chip.capacity / op_size, i, stride, offset;
+    uint64_t sim_start, sim_total, cpu_start, cpu_total;
+    bool is_write = pattern != BENCH_SEQ_READ && pattern != BENCH_RAND_READ;
+
+    if (op_count > slots) {
+        op_count = slots;
+    }
+    /* plain write patterns need an erased area, it is not accounted */
+    if (pattern == BENCH_SEQ_WRITE || pattern == BENCH_RAND_WRITE) {
+        result = sfud_chip_erase(flash);
+        if (result != SFUD_SUCCESS) {
+            return result;
+        }
+    }
+    /* random write walks all of slots by a stride which is coprime to the slot count, so no slot is written twice */
+    offset = bench_rand() % slots;
+    stride = bench_rand() % slots | 1;
+    while (gcd(stride, slots) != 1) {
+        stride += 2;
+    }
+    sfud_sim_clear_stat();
+
+    sim_start = sfud_sim_get_time_ns();
+    cpu_start = host_time_ns();
+    for (i = 0; i < op_count && result == SFUD_SUCCESS; i++) {
+        uint32_t addr;
+        uint64_t op_start = sfud_sim_get_time_ns();
+
+        switch (pattern) {
+        case BENCH_SEQ_READ:
+        case BENCH_SEQ_WRITE:
+        case BENCH_SEQ_ERASE_WRITE:
+            addr = i * op_size;
+            break;
+        default:
+            addr = (is_write ? (offset + i * stride) % slots : bench_rand() % slots) * op_size;
+            break;
+        }
+        if (is_write) {
+            memset(op_buf, (uint8_t)i, op_size);
+        }
+
+        switch (pattern) {
+        case BENCH_SEQ_READ:
+        case BENCH_RAND_READ:
+            result = sfud_read(flash, addr, op_size, op_buf);
+            break;
+        case BENCH_SEQ_WRITE:
+        case BENCH_RAND_WRITE:
+            result = sfud_write(flash, addr, op_size, op_buf);
+            break;
+        case BENCH_SEQ_ERASE_WRITE:
+        case BENCH_RAND_ERASE_WRITE:
+            result = sfud_erase_write(flash, addr, op_size, op_buf);
+            break;
+        }
+        latency_ns[i] = sfud_sim_get_time_ns() - op_start;
+    }
+    cpu_total = host_time_ns() - cpu_start;
+    sim_total = sfud_sim_get_time_ns() - sim_start;
+
+    if (result != SFUD_SUCCESS) {
+        printf("%-18s failed at operation %zu, error %d\n", pattern_name[pattern], i - 1, result);
+        return result;
+    }
+
+    qsort(latency_ns, op_count, sizeof(latency_ns[0]), compare_u64);
+    printf("%-18s %9.3f %10.1f %10.1f %10.1f %10.1f %8.2f %10.1f\n", pattern_name[pattern],
+            (double)op_count * op_size / 1048576.0 / ((double)sim_total / 1e9),
+            latency_ns[0] / 1000.0,
+            percentile(latency_ns, op_count, 50) / 1000.0,
+            percentile(latency_ns, op_count, 99) / 1000.0,
+            latency_ns[op_count - 1] / 1000.0,
+            (double)sfud_sim_get_stat()->status_polls / op_count,
+            (double)cpu_total / op_count / 1000.0);
+
+    return result;
+}
+
+#ifdef SFUD_USING_ERASE_SCHED
+/**
+ * read randomly out of the erasing area while it is erased by the erase scheduler, and print the read latency
+ *
+ * @param flash flash device
+ * @param suspend false: the erase scheduler can't suspend erase
+ *
+ * @return result
+ */
+static sfud_err bench_erase_read(sfud_flash *flash, bool suspend) {
+    sfud_err result = SFUD_SUCCESS;
+    sfud_erase_suspend saved = flash->erase_sched.suspend;
+    const sfud_erase_sched_stat *stat = sfud_erase_sched_get_stat(flash);
+    size_t count = 0;
+    uint64_t sim_start, erase_time;
+
+    if (!suspend) {
+        flash->erase_sched.suspend.suspend_cmd = 0;
+    }
+    sfud_erase_sched_clear_stat(flash);
+    sfud_sim_clear_stat();
+
+    sim_start = sfud_sim_get_time_ns();
+    result = sfud_erase_sched_submit(flash, 0, BENCH_ERASE_SIZE);
+    while (result == SFUD_SUCCESS && sfud_erase_sched_is_busy(flash) && count < BENCH_MAX_OP_COUNT) {
+        uint32_t addr = BENCH_ERASE_SIZE + bench_rand() % (flash->chip.capacity - BENCH_ERASE_SIZE
+                - BENCH_ERASE_READ_SIZE);
+        uint64_t op_start = sfud_sim_get_time_ns();
+
+        result = sfud_read(flash, addr, BENCH_ERASE_READ_SIZE, op_buf);
+        latency_ns[count++] = sfud_sim_get_time_ns() - op_start;
+        /* the application work between the reads */
+        sfud_sim_advance_time_ns(BENCH_ERASE_READ_GAP_NS);
+        if (result == SFUD_SUCCESS) {
+            result = sfud_erase_sched_poll(flash);
+        }
+    }
+    if (result == SFUD_SUCCESS) {
+        result = sfud_erase_sched_flush(flash);
+    }
+    erase_time = sfud_sim_get_time_ns() - sim_start;
+    flash->erase_sched.suspend = saved;
+
+    if (result != SFUD_SUCCESS) {
+        printf("%-18s failed at read %zu, error %d\n", suspend ? "erase-read suspend" : "erase-read wait", count,
+                result);
+        return result;
+    }
+
+    qsort(latency_ns, count, sizeof(latency_ns[0]), compare_u64);
+    printf("%-18s %9.3f %10.1f %10.1f %10.1f %10.1f %8.2f %10s  erase %.1f ms, %zu reads, %lu suspends, "
+            "max read %lu us\n", suspend ? "erase-read suspend" : "erase-read wait",
+            (double)count * BENCH_ERASE_READ_SIZE / 1048576.0 / ((double)erase_time / 1e9),
+            latency_ns[0] / 1000.0,
+            percentile(latency_ns, count, 50) / 1000.0,
+            percentile(latency_ns, count, 99) / 1000.0,
+            latency_ns[count - 1] / 1000.0,
+            (double)sfud_sim_get_stat()->status_polls / count, "-", erase_time / 1e6, count,
+            (unsigned long)stat->suspends, (unsigned long)stat->max_read_latency_us);
+
+    return result;
+}
+#endif /* SFUD_USING_ERASE_SCHED */
+
+int main(int argc, char *argv[]) {
+    sfud_sim_chip chip = SFUD_SIM_CHIP_GD25Q16;
+    size_t op_size = BENCH_DEFAULT_OP_SIZE, op_count = BENCH_DEFAULT_OP_COUNT;
+    uint8_t read_lines = 1;
+    const sfud_flash *flash;
+    const sfud_sim_timing *timing;
+    int pattern;
+
+    if (argc > 1 && strcmp(argv[1], "mx25l64") == 0) {
+        chip = SFUD_SIM_CHIP_MX25L64;
+    }
+    if (argc > 2) {
+        op_size = strtoul(argv[2], NULL, 0);
+    }
+    if (argc > 3) {
+        op_count = strtoul(argv[3], NULL, 0);
+    }
+    if (argc > 4) {
+        read_lines = (uint8_t)strtoul(argv[4], NULL, 0);
+    }
+    if (op_size == 0 || op_size > BENCH_MAX_OP_SIZE || op_count == 0 || op_count > BENCH_MAX_OP_COUNT
+            || (read_lines != 1 && read_lines != 2 && read_lines != 4)) {
+        printf("Usage: %s [gd25q16|mx25l64] [op size, 1 ~ %ld] [op count, 1 ~ %ld] [read data lines, 1 2 or 4]\n",
+                argv[0], BENCH_MAX_OP_SIZE, BENCH_MAX_OP_COUNT);
+        return 1;
+    }
+
+    sfud_sim_select_chip(chip);
+    if (sfud_init() != SFUD_SUCCESS) {
+        printf("SFUD initialize failed.\n");
+        return 1;
+    }
+    flash = sfud_get_device(SFUD_GD25_DEVICE_INDEX);
+    timing = sfud_sim_get_timing();
+#ifdef SFUD_USING_QSPI
+    sfud_qspi_fast_read_enable(sfud_get_device(SFUD_GD25_DEVICE_INDEX), read_lines);
+#endif
+    if (op_size % flash->chip.erase_gran != 0) {
+        printf("Note: op size is not aligned to %ld bytes erase granularity, erase-write touches neighbour data.\n",
+                (long)flash->chip.erase_gran);
+    }
+
+    printf("chip %s, %ld bytes, SPI %lu Hz, tPP %lu us, tSE %lu us, retry delay %lu us\n",
+            chip == SFUD_SIM_CHIP_GD25Q16 ? "GD25Q16" : "MX25L64", (long)flash->chip.capacity,
+            (unsigned long)timing->spi_clock_hz, (unsigned long)timing->page_program_ns / 1000,
+            (unsigned long)timing->erase_4k_ns / 1000, (unsigned long)timing->poll_delay_ns / 1000);
+#ifdef SFUD_USING_QSPI
+    printf("op size %zu bytes, %zu ops, read command 0x%02X, %d data lines\n", op_size, op_count,
+            flash->read_cmd_format.instruction, flash->read_cmd_format.data_lines);
+#else
+    printf("op size %zu bytes, %zu ops\n", op_size, op_count);
+#endif
+    printf("%-18s %9s %10s %10s %10s %10s %8s %10s\n", "pattern", "MB/s", "min(us)", "p50(us)", "p99(us)", "max(us)",
+            "polls/op", "cpu(us)/op");
+
+    for (pattern = BENCH_SEQ_READ; pattern <= BENCH_RAND_ERASE_WRITE; pattern++) {
+        if (bench_run(flash, (bench_pattern)pattern, op_size, op_count) != SFUD_SUCCESS) {
+            return 1;
+        }
+    }
+#ifdef SFUD_USING_ERASE_SCHED
+    if (bench_erase_read(sfud_get_device(SFUD_GD25_DEVICE_INDEX), false) != SFUD_SUCCESS
+            || bench_erase_read(sfud_get_device(SFUD_GD25_DEVICE_INDEX), true) != SFUD_SUCCESS) {
+        return 1;
+    }
+#endif
+
+    return 0;
+}
@@ -104,6 +104,117 @@ sfud_err sfud_qspi_fast_read_enable(sfud_flash *flash, uint8_t data_line_width);
  */
 sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t *data);
 
+#ifdef SFUD_USING_ASYNC
+/**
+ * read flash data asynchronously. It returns after the first SPI transfer has been started, then the operation goes on
+ * by SPI events, CPU and interrupts are not blocked.
+ *
+ * @note The data buffer must be valid until the done callback. The SPI bus is locked until done, synchronous API
+ *       waits for it, so don't call it on interrupt context before done.
+ *
+ * @param flash flash device
+ * @param addr start address
+ * @param size read size
+ * @param data read data pointer
+ * @param done done callback, it will be called on SPI event context
+ * @param context user context of done callback
+ *
+ * @return result of operation start, SFUD_ERR_BUSY: another operation holds the SPI bus, the operation result is
+ *         passed to done callback
+ */
+sfud_err sfud_read_async(sfud_flash *flash, uint32_t addr, size_t size, uint8_t *data, sfud_async_done_cb done,
+        void *context);
+
+/**
+ * write flash data (no erase operate) asynchronously. Write enable, page program and status register poll of each
+ * page are chained by SPI events, CPU and interrupts are not blocked.
+ *
+ * @note Only support 256 bytes page write mode flash. The data buffer must be valid until the done callback.
+ *       The SPI bus is locked until done, synchronous API waits for it, so don't call it on interrupt context
+ *       before done.
+ *
+ * @param flash flash device
+ * @param addr start address
+ * @param size write size
+ * @param data write data
+ * @param done done callback, it will be called on SPI event context
+ * @param context user context of done callback
+ *
+ * @return result of operation start, SFUD_ERR_BUSY: another operation holds the SPI bus, the operation result is
+ *         passed to done callback
+ */
+sfud_err sfud_write_async(sfud_flash *flash, uint32_t addr, size_t size, const uint8_t *data,
+        sfud_async_done_cb done, void *context);
+
+/**
+ * check whether there is an asynchronous operation in progress on the flash device
+ *
+ * @param flash flash device
+ *
+ * @return true: in progress
+ */
+bool sfud_async_is_busy(const sfud_flash *flash);
+#endif /* SFUD_USING_ASYNC */
+
+#ifdef SFUD_USING_ERASE_SCHED
+/**
+ * queue an erase on the background erase scheduler, it is erased by sfud_erase_sched_poll()
+ *
+ * @note It will erase align by erase granularity. sfud_read() suspends the erase in progress when the flash supports
+ *       erase suspend, sfud_write() and sfud_erase() wait for all of the queued erases.
+ *
+ * @param flash flash device
+ * @param addr start address
+ * @param size erase size
+ *
+ * @return result, SFUD_ERR_BUSY: the queue is full
+ */
+sfud_err sfud_erase_sched_submit(sfud_flash *flash, uint32_t addr, size_t size);
+
+/**
+ * run the erase scheduler without waiting, it should be called periodically, e.g. on main loop
+ *
+ * @param flash flash device
+ *
+ * @return result
+ */
+sfud_err sfud_erase_sched_poll(sfud_flash *flash);
+
+/**
+ * wait for all of the queued erases to finish
+ *
+ * @param flash flash device
+ *
+ * @return result
+ */
+sfud_err sfud_erase_sched_flush(sfud_flash *flash);
+
+/**
+ * check whether there is a queued erase on the flash device
+ *
+ * @param flash flash device
+ *
+ * @return true: erase is queued or in progress
+ */
+bool sfud_erase_sched_is_busy(const sfud_flash *flash);
+
+/**
+ * get the erase scheduler statistics
+ *
+ * @param flash flash device
+ *
+ * @return statistics
+ */
+const sfud_erase_sched_stat *sfud_erase_sched_get_stat(const sfud_flash *flash);
+
+/**
+ * clear the erase scheduler statistics
+ *
+ * @param flash flash device
+ */
+void sfud_erase_sched_clear_stat(sfud_flash *flash);
+#endif /* SFUD_USING_ERASE_SCHED */
+
 /**
  * erase flash data
  *
@@ -29,10 +29,22 @@
 #ifndef _SFUD_CFG_H_
 #define _SFUD_CFG_H_
 
+/* host build against the simulated flash in port/sfud_port_sim.c, usually given as -DSFUD_USING_HOST_SIM */
+//#define SFUD_USING_HOST_SIM
+
+#ifndef SFUD_USING_HOST_SIM
 #define SFUD_DEBUG_MODE
+#endif
 
 #define SFUD_USING_SFDP
 
+/* sfud_read_async and sfud_write_async, port must support spi.wr_async */
+#define SFUD_USING_ASYNC
+
+/* sfud_erase_sched_submit queues background erases, sfud_read suspends the erase in progress.
+ * Port must set erase_sched.get_time_us. */
+#define SFUD_USING_ERASE_SCHED
+
 #define SFUD_USING_FLASH_INFO_TABLE
 
 enum {
@@ -44,6 +56,7 @@ enum {
     [SFUD_GD25_DEVICE_INDEX] = {.name = "GD25Q16", .spi.name = "SPIX"},           \
 }
 
-//#define SFUD_USING_QSPI
+/* fast read by QSPI, port must support spi.qspi_read. Otherwise it reads by normal SPI. */
+#define SFUD_USING_QSPI
 
 #endif /* _SFUD_CFG_H_ */
@@ -36,7 +36,9 @@
 #include <sfud_cfg.h>
 #include "sfud_flash_def.h"
 
+#ifndef SFUD_USING_HOST_SIM
 #include "nrf_log.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -45,17 +47,23 @@ extern "C" {
 /* debug print function. Must be implement by user. */
 #ifdef SFUD_DEBUG_MODE
 #ifndef SFUD_DEBUG
-//#define SFUD_DEBUG(...) sfud_log_debug(__FILE__, __LINE__, __VA_ARGS__)
+#ifdef SFUD_USING_HOST_SIM
+#define SFUD_DEBUG(...) sfud_log_debug(__FILE__, __LINE__, __VA_ARGS__)
+#else
 #define SFUD_DEBUG(...) NRF_LOG_DEBUG(__VA_ARGS__)
+#endif
 #endif /* SFUD_DEBUG */
 #else
 #define SFUD_DEBUG(...)
 #endif /* SFUD_DEBUG_MODE */
 
 #ifndef SFUD_INFO
-//#define SFUD_INFO(...)  sfud_log_info(__VA_ARGS__)
+#ifdef SFUD_USING_HOST_SIM
+#define SFUD_INFO(...)  sfud_log_info(__VA_ARGS__)
+#else
 #define SFUD_INFO(...) NRF_LOG_INFO(__VA_ARGS__)
 #endif
+#endif
 
 /* assert for developer. */
 #ifdef SFUD_DEBUG_MODE
@@ -174,6 +182,26 @@ if (!(EXPR))                                                                   \
 #define SFUD_WRITE_MAX_PAGE_SIZE                        256
 #endif
 
+#ifdef SFUD_USING_ASYNC
+/* bytes of each status register poll. The status register is output repeatedly while the chip select is held, so
+ * one long poll transfer replaces many short polls and their interrupts. */
+#ifndef SFUD_ASYNC_POLL_SIZE
+#define SFUD_ASYNC_POLL_SIZE                           64
+#endif
+
+/* maximum poll transfer times for wait busy on asynchronous operation */
+#ifndef SFUD_ASYNC_POLL_TIMES
+#define SFUD_ASYNC_POLL_TIMES                          100000
+#endif
+#endif /* SFUD_USING_ASYNC */
+
+#ifdef SFUD_USING_ERASE_SCHED
+/* maximum queued erase requests of the erase scheduler */
+#ifndef SFUD_ERASE_SCHED_QUEUE_SIZE
+#define SFUD_ERASE_SCHED_QUEUE_SIZE                    8
+#endif
+#endif /* SFUD_USING_ERASE_SCHED */
+
 /* send dummy data for read data */
 #ifndef SFUD_DUMMY_DATA
 #define SFUD_DUMMY_DATA                                0xFF
@@ -182,6 +210,17 @@ if (!(EXPR))                                                                   \
 /* maximum number of erase type support on JESD216 (V1.0) */
 #define SFUD_SFDP_ERASE_TYPE_MAX_NUM                      4
 
+/**
+ * fast read modes on JESD216 (V1.0), (instruction lines)-(address lines)-(data lines)
+ */
+enum {
+    SFUD_SFDP_FAST_READ_1_1_2 = 0,
+    SFUD_SFDP_FAST_READ_1_2_2 = 1,
+    SFUD_SFDP_FAST_READ_1_1_4 = 2,
+    SFUD_SFDP_FAST_READ_1_4_4 = 3,
+    SFUD_SFDP_FAST_READ_MAX_NUM = 4,
+};
+
 /**
  * status register bits
  */
@@ -201,6 +240,7 @@ typedef enum {
     SFUD_ERR_READ = 3,                                     /**< read error */
     SFUD_ERR_TIMEOUT = 4,                                  /**< timeout error */
     SFUD_ERR_ADDR_OUT_OF_BOUND = 5,                        /**< address is out of flash bound */
+    SFUD_ERR_BUSY = 6,                                     /**< another operation or scheduled erase is in progress */
 } sfud_err;
 
 #ifdef SFUD_USING_QSPI
@@ -218,6 +258,77 @@ typedef struct {
 } sfud_qspi_read_cmd_format;
 #endif /* SFUD_USING_QSPI */
 
+#ifdef SFUD_USING_ASYNC
+/* SPI bus asynchronous transfer done callback, it will be called on SPI event context */
+typedef void (*sfud_spi_done_cb)(void *context, sfud_err result);
+
+/* asynchronous read or write done callback, it will be called on SPI event context */
+typedef void (*sfud_async_done_cb)(void *flash, sfud_err result, void *context);
+
+/**
+ * asynchronous operation state which is saved on flash device
+ */
+typedef struct {
+    volatile uint8_t state;                      /**< current state of operation state machine */
+    uint32_t addr;                               /**< next read or write address */
+    size_t size;                                 /**< remain read or write size */
+    uint8_t *read_buf;                           /**< read data pointer */
+    const uint8_t *write_buf;                    /**< remain write data pointer */
+    size_t data_size;                            /**< data size of current page program */
+    size_t poll_times;                           /**< remain status register poll times */
+    sfud_async_done_cb done;                     /**< operation done callback */
+    void *context;                               /**< user context of done callback */
+    uint8_t cmd_data[5];                         /**< command buffer */
+    uint8_t status[SFUD_ASYNC_POLL_SIZE];        /**< status register poll buffer */
+} sfud_async;
+#endif /* SFUD_USING_ASYNC */
+
+/**
+ * erase suspend and resume parameters
+ */
+typedef struct {
+    uint8_t suspend_cmd;                         /**< erase suspend command. 0x00: not supported */
+    uint8_t resume_cmd;                          /**< erase resume command */
+    uint16_t suspend_latency_us;                 /**< maximum time from suspend command to ready */
+    uint16_t resume_interval_us;                 /**< minimum time from resume to next suspend */
+} sfud_erase_suspend;
+
+#ifdef SFUD_USING_ERASE_SCHED
+/**
+ * erase scheduler statistics, the latencies are measured by the port's microsecond clock
+ */
+typedef struct {
+    uint32_t erases;                             /**< finished sector or block erase commands */
+    uint32_t reads;                              /**< reads while an erase is scheduled */
+    uint32_t suspends;                           /**< erase suspends for the read */
+    uint32_t flushes;                            /**< reads, writes or erases which waited for all scheduled erases */
+    uint32_t max_read_latency_us;                /**< worst case read latency while an erase is scheduled */
+    uint64_t total_read_latency_us;              /**< total read latency while an erase is scheduled */
+    uint32_t max_suspend_latency_us;             /**< worst case time from suspend command to ready */
+} sfud_erase_sched_stat;
+
+/**
+ * erase scheduler state which is saved on flash device
+ */
+typedef struct {
+    volatile uint8_t state;                      /**< idle, erasing or suspended */
+    struct {
+        uint32_t addr;                           /**< erase start address */
+        uint32_t size;                           /**< erase size */
+    } queue[SFUD_ERASE_SCHED_QUEUE_SIZE];        /**< queued erase requests, the first one is in progress */
+    uint8_t head;                                /**< index of the first request */
+    uint8_t count;                               /**< number of queued requests */
+    uint32_t erase_addr;                         /**< address of the sector or block which is erasing */
+    uint32_t erase_size;                         /**< size of the sector or block which is erasing */
+    uint32_t resume_time_us;                     /**< time of last resume or erase start */
+    uint32_t read_start_us;                      /**< start time of the read in progress */
+    bool read_timed;                             /**< the read in progress is counted on statistics */
+    sfud_erase_suspend suspend;                  /**< found by SFDP or SFUD_FLASH_SUSPEND_INFO_TABLE */
+    uint32_t (*get_time_us)(void);               /**< microsecond clock, it must be set by port */
+    sfud_erase_sched_stat stat;                  /**< statistics */
+} sfud_erase_sched;
+#endif /* SFUD_USING_ERASE_SCHED */
+
 /* SPI bus write read data function type */
 typedef sfud_err (*spi_write_read_func)(const uint8_t *write_buf, size_t write_size, uint8_t *read_buf, size_t read_size);
 
@@ -241,7 +352,11 @@ typedef struct {
         uint32_t size;                           /**< erase sector size (bytes). 0x00: not available */
         uint8_t cmd;                             /**< erase command */
     } eraser[SFUD_SFDP_ERASE_TYPE_MAX_NUM];      /**< supported eraser types table */
-    //TODO lots of fast read-related stuff (like modes supported and number of wait states/dummy cycles needed in each)
+    struct {
+        uint8_t cmd;                             /**< fast read command. 0x00: not supported */
+        uint8_t dummy_cycles;                    /**< wait states plus mode clocks */
+    } fast_read[SFUD_SFDP_FAST_READ_MAX_NUM];    /**< supported fast read modes table */
+    sfud_erase_suspend erase_suspend;            /**< erase suspend and resume on JESD216A (V1.5) */
 } sfud_sfdp, *sfud_sfdp_t;
 #endif
 
@@ -259,7 +374,21 @@ typedef struct __sfud_spi {
     sfud_err (*qspi_read)(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi_read_cmd_format *qspi_read_cmd_format,
                           uint8_t *read_buf, size_t read_size);
 #endif
-    /* lock SPI bus */
+    /* SPI bus write command header then payload data under one chip select, NULL will copy them for wr */
+    sfud_err (*wr_sg)(const struct __sfud_spi *spi, const uint8_t *header, size_t header_size, const uint8_t *data,
+                      size_t data_size);
+#ifdef SFUD_USING_ASYNC
+    /* SPI bus asynchronous write then read data function under one chip select, done is called when finished */
+    sfud_err (*wr_async)(const struct __sfud_spi *spi, const uint8_t *write_buf, size_t write_size, uint8_t *read_buf,
+                         size_t read_size, sfud_spi_done_cb done, void *context);
+    /* SPI bus asynchronous write command header then payload data under one chip select */
+    sfud_err (*wr_sg_async)(const struct __sfud_spi *spi, const uint8_t *header, size_t header_size,
+                            const uint8_t *data, size_t data_size, sfud_spi_done_cb done, void *context);
+    /* lock SPI bus for an asynchronous operation without waiting, return false when it is locked, it may be called
+     * on interrupt context */
+    bool (*try_lock)(const struct __sfud_spi *spi);
+#endif
+    /* lock SPI bus for a whole operation */
     void (*lock)(const struct __sfud_spi *spi);
     /* unlock SPI bus */
     void (*unlock)(const struct __sfud_spi *spi);
@@ -291,6 +420,14 @@ typedef struct {
     sfud_sfdp sfdp;                              /**< serial flash discoverable parameters by JEDEC standard */
 #endif
 
+#ifdef SFUD_USING_ASYNC
+    sfud_async async;                            /**< asynchronous read and write operation */
+#endif
+
+#ifdef SFUD_USING_ERASE_SCHED
+    sfud_erase_sched erase_sched;                /**< background erase scheduler */
+#endif
+
 } sfud_flash, *sfud_flash_t;
 
 #ifdef __cplusplus
@@ -74,6 +74,19 @@ typedef struct {
 } sfud_qspi_flash_ext_info;
 #endif
 
+#ifdef SFUD_USING_ERASE_SCHED
+/* flash chip's erase suspend and resume information, it's used when SFDP has no suspend parameter */
+typedef struct {
+    uint8_t mf_id;                               /**< manufacturer ID */
+    uint8_t type_id;                             /**< memory type ID */
+    uint8_t capacity_id;                         /**< capacity ID */
+    uint8_t suspend_cmd;                         /**< erase suspend command */
+    uint8_t resume_cmd;                          /**< erase resume command */
+    uint16_t suspend_latency_us;                 /**< maximum time from suspend command to ready (tSUS) */
+    uint16_t resume_interval_us;                 /**< minimum time from resume to next suspend (tRS) */
+} sfud_flash_suspend_info;
+#endif
+
 /* SFUD support manufacturer JEDEC ID */
 #define SFUD_MF_ID_CYPRESS                             0x01
 #define SFUD_MF_ID_FUJITSU                             0x04
@@ -177,9 +190,35 @@ typedef struct {
     {SFUD_MF_ID_MICRONIX, 0x20, 0x16, NORMAL_SPI_READ|DUAL_OUTPUT},                                \
     /* GD25Q64B */                                                                                 \
     {SFUD_MF_ID_GIGADEVICE, 0x40, 0x17, NORMAL_SPI_READ|DUAL_OUTPUT},                              \
+    /* GD25Q16C */                                                                                 \
+    {SFUD_MF_ID_GIGADEVICE, 0x40, 0x15, NORMAL_SPI_READ|DUAL_OUTPUT|DUAL_IO|QUAD_OUTPUT|QUAD_IO},  \
 }
 #endif /* SFUD_USING_QSPI */
 
+#ifdef SFUD_USING_ERASE_SCHED
+/* This table saves erase suspend and resume commands of the flash which has no suspend parameter on SFDP.
+ * The erase scheduler can suspend an erase in progress by this table to let the read go first.
+ * | mf_id | type_id | capacity_id | suspend_cmd | resume_cmd | suspend_latency_us | resume_interval_us |
+ */
+#define SFUD_FLASH_SUSPEND_INFO_TABLE                                                              \
+{                                                                                                  \
+    /* W25Q16BV */                                                                                 \
+    {SFUD_MF_ID_WINBOND, 0x40, 0x15, 0x75, 0x7A, 20, 100},                                         \
+    /* W25Q32BV */                                                                                 \
+    {SFUD_MF_ID_WINBOND, 0x40, 0x16, 0x75, 0x7A, 20, 100},                                         \
+    /* W25Q64JV */                                                                                 \
+    {SFUD_MF_ID_WINBOND, 0x40, 0x17, 0x75, 0x7A, 20, 100},                                         \
+    /* W25Q128JV */                                                                                \
+    {SFUD_MF_ID_WINBOND, 0x40, 0x18, 0x75, 0x7A, 20, 100},                                         \
+    /* GD25Q64B */                                                                                 \
+    {SFUD_MF_ID_GIGADEVICE, 0x40, 0x17, 0x75, 0x7A, 20, 100},                                      \
+    /* GD25Q16C */                                                                                 \
+    {SFUD_MF_ID_GIGADEVICE, 0x40, 0x15, 0x75, 0x7A, 20, 100},                                      \
+    /* MX25L6433F */                                                                               \
+    {SFUD_MF_ID_MICRONIX, 0x20, 0x17, 0xB0, 0x30, 20, 100},                                        \
+}
+#endif /* SFUD_USING_ERASE_SCHED */
+
 #ifdef __cplusplus
 }
 #endif
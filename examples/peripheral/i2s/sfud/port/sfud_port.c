@@ -31,6 +31,10 @@
 #include "nrf_drv_spi.h"
 #include "nrf_gpio.h"
 #include "nrf_delay.h"
+#include "app_util_platform.h"
+#ifdef QSPI_PRESENT
+#include "nrf_drv_qspi.h"
+#endif
 
 //static char log_buf[256];
 
@@ -38,8 +42,36 @@
 
 /* NORDIC SPI begin */
 #define SPI_INSTANCE  0 /**< SPI instance index. */
+/* maximum bytes of one EasyDMA transfer, the legacy driver length is 8-bit */
+#define SPI_MAX_XFER_SIZE  255
 static const nrf_drv_spi_t spi = NRF_DRV_SPI_INSTANCE(SPI_INSTANCE);  /**< SPI instance. */
-static volatile bool spi_xfer_done;  /**< Flag used to indicate that SPI instance completed the transfer. */
+static volatile bool spi_xfer_done = true;  /**< Flag used to indicate that SPI instance completed the transfer. */
+
+/* owner of SPI bus, it is held by an operation from lock to unlock */
+enum {
+    SPI_OWNER_NONE,
+    SPI_OWNER_SYNC,                              /**< blocking operation, locked by spi_lock */
+    SPI_OWNER_ASYNC,                             /**< asynchronous operation, locked by spi_try_lock */
+};
+static volatile uint8_t spi_owner = SPI_OWNER_NONE;
+static uint8_t spi_bounce_buf[SPI_MAX_XFER_SIZE];  /**< RAM copy of payload data which is not in RAM. */
+
+/**
+ * Transfer under one chip select. It is split to EasyDMA transfers which are started back-to-back by SPI event,
+ * write phase (header then payload data) first and then read phase. The chip select is driven by GPIO, so it is
+ * held between them.
+ */
+static struct {
+    const uint8_t *write_buf;
+    size_t write_size;
+    const uint8_t *data;
+    size_t data_size;
+    uint8_t *read_buf;
+    size_t read_size;
+    /* asynchronous transfer done callback, NULL for blocking transfer */
+    void (*done)(void *context, sfud_err result);
+    void *context;
+} spi_xfer;
 
 #if 0
 #define TEST_STRING "Nordic"
@@ -48,6 +80,66 @@ static uint8_t       m_rx_buf[sizeof(TEST_STRING) + 1];    /**< RX buffer. */
 static const uint8_t m_length = sizeof(m_tx_buf);        /**< Transfer length. */
 #endif
 
+/**
+ * start next EasyDMA transfer, or release chip select and finish when nothing remains
+ */
+static sfud_err spi_xfer_next(void)
+{
+    size_t size;
+    ret_code_t err_code;
+
+    if (spi_xfer.write_size)
+    {
+        size = MIN(spi_xfer.write_size, SPI_MAX_XFER_SIZE);
+        err_code = nrf_drv_spi_transfer(&spi, spi_xfer.write_buf, size, NULL, 0);
+        spi_xfer.write_buf += size;
+        spi_xfer.write_size -= size;
+    }
+    else if (spi_xfer.data_size)
+    {
+        /* payload is sent from user buffer, only the data in flash is copied because EasyDMA can't read it */
+        size = MIN(spi_xfer.data_size, SPI_MAX_XFER_SIZE);
+        if (nrfx_is_in_ram(spi_xfer.data))
+        {
+            err_code = nrf_drv_spi_transfer(&spi, spi_xfer.data, size, NULL, 0);
+        }
+        else
+        {
+            memcpy(spi_bounce_buf, spi_xfer.data, size);
+            err_code = nrf_drv_spi_transfer(&spi, spi_bounce_buf, size, NULL, 0);
+        }
+        spi_xfer.data += size;
+        spi_xfer.data_size -= size;
+    }
+    else if (spi_xfer.read_size)
+    {
+        /* ORC (0xFF) is clocked out as dummy data */
+        size = MIN(spi_xfer.read_size, SPI_MAX_XFER_SIZE);
+        err_code = nrf_drv_spi_transfer(&spi, NULL, 0, spi_xfer.read_buf, size);
+        spi_xfer.read_buf += size;
+        spi_xfer.read_size -= size;
+    }
+    else
+    {
+        nrf_gpio_pin_set(SPI_SS_PIN);
+        spi_xfer_done = true;
+        if (spi_xfer.done)
+        {
+            spi_xfer.done(spi_xfer.context, SFUD_SUCCESS);
+        }
+        return SFUD_SUCCESS;
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_gpio_pin_set(SPI_SS_PIN);
+        spi_xfer_done = true;
+        return SFUD_ERR_WRITE;
+    }
+
+    return SFUD_SUCCESS;
+}
+
 /**
  * @brief SPI user event handler.
  * @param event
@@ -55,94 +147,316 @@ static const uint8_t m_length = sizeof(m_tx_buf);        /**< Transfer length. *
 void spi_event_handler(nrf_drv_spi_evt_t const * p_event,
                        void *                    p_context)
 {
-    spi_xfer_done = true;
-    NRF_LOG_INFO("Transfer completed.");
-#if 0
-    if (m_rx_buf[0] != 0)
+    sfud_err result = spi_xfer_next();
+
+    if (result != SFUD_SUCCESS && spi_xfer.done)
     {
-        NRF_LOG_INFO(" Received:");
-        NRF_LOG_HEXDUMP_INFO(m_rx_buf, strlen((const char *)m_rx_buf));
+        spi_xfer.done(spi_xfer.context, result);
     }
-#endif
 }
 
 static void spi_init(void)
 {
     nrf_drv_spi_config_t spi_config = NRF_DRV_SPI_DEFAULT_CONFIG;
-    spi_config.ss_pin   = SPI_SS_PIN;
+    /* chip select is held by GPIO for all of EasyDMA transfers of one command */
+    spi_config.ss_pin   = NRF_DRV_SPI_PIN_NOT_USED;
     spi_config.miso_pin = SPI_MISO_PIN;
     spi_config.mosi_pin = SPI_MOSI_PIN;
     spi_config.sck_pin  = SPI_SCK_PIN;
     /* flash support mode0 and mode3 */
     spi_config.mode = NRF_DRV_SPI_MODE_3;
     APP_ERROR_CHECK(nrf_drv_spi_init(&spi, &spi_config, spi_event_handler, NULL));
+
+    nrf_gpio_pin_set(SPI_SS_PIN);
+    nrf_gpio_cfg_output(SPI_SS_PIN);
     
     NRF_LOG_INFO("SPI example started.");
 }
 
+#if defined(SFUD_USING_QSPI) && defined(QSPI_PRESENT)
+/* release the flash pins to QSPI peripheral */
+static void spi_uninit(void)
+{
+    nrf_drv_spi_uninit(&spi);
+}
+#endif
+
 static void spi_delay(void)
 {
     nrf_delay_ms(1);
     return;
 }
 
+#ifdef SFUD_USING_ERASE_SCHED
+/**
+ * microsecond clock by DWT cycle counter, it must be called at least once per CYCCNT wrap (about 67 s at 64 MHz)
+ */
+static uint32_t get_time_us(void)
+{
+    static bool started;
+    static uint32_t last_cycles, rest_cycles, time_us;
+    uint32_t cycles, cycles_per_us = SystemCoreClock / 1000000;
+
+    if (!started)
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        started = true;
+    }
+    cycles = DWT->CYCCNT;
+    rest_cycles += cycles - last_cycles;
+    last_cycles = cycles;
+    time_us += rest_cycles / cycles_per_us;
+    rest_cycles %= cycles_per_us;
+
+    return time_us;
+}
+#endif
+
+/**
+ * take SPI bus for the owner if nobody holds it
+ */
+static bool spi_take(uint8_t owner) {
+    bool taken;
+
+    CRITICAL_REGION_ENTER();
+    taken = (spi_owner == SPI_OWNER_NONE);
+    if (taken)
+    {
+        spi_owner = owner;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return taken;
+}
+
+/**
+ * Lock SPI bus for a whole blocking operation, wait for the asynchronous operation which holds it. Interrupts are kept
+ * enabled, the SPI event handler drives the asynchronous operation to its end.
+ */
 static void spi_lock(const sfud_spi *spi) {
-    __disable_irq();
+    while (!spi_take(SPI_OWNER_SYNC))
+    {
+        __WFE();
+    }
 }
 
 static void spi_unlock(const sfud_spi *spi) {
-    __enable_irq();
+    spi_owner = SPI_OWNER_NONE;
+}
+
+#ifdef SFUD_USING_ASYNC
+/**
+ * lock SPI bus for a whole asynchronous operation, it may be called on interrupt context so it doesn't wait
+ */
+static bool spi_try_lock(const sfud_spi *spi) {
+    return spi_take(SPI_OWNER_ASYNC);
 }
+#endif
 
 /* NORDIC SPI end */
 
+/**
+ * start write header, write payload data then read transfer under one chip select
+ */
+static sfud_err spi_xfer_start(const uint8_t *write_buf, size_t write_size, const uint8_t *data, size_t data_size,
+        uint8_t *read_buf, size_t read_size, void (*done)(void *context, sfud_err result), void *context)
+{
+    sfud_err result;
+    uint8_t owner = done ? SPI_OWNER_ASYNC : SPI_OWNER_SYNC;
+    bool busy;
+
+    /* the transfer of an operation which doesn't hold the locked bus would be sent between the other's commands */
+    CRITICAL_REGION_ENTER();
+    busy = !spi_xfer_done || (spi_owner != SPI_OWNER_NONE && spi_owner != owner);
+    if (!busy)
+    {
+        spi_xfer_done = false;
+    }
+    CRITICAL_REGION_EXIT();
+    if (busy)
+    {
+        return SFUD_ERR_BUSY;
+    }
+    spi_xfer.done = done;
+    spi_xfer.context = context;
+    spi_xfer.write_buf = write_buf;
+    spi_xfer.write_size = write_size;
+    spi_xfer.data = data;
+    spi_xfer.data_size = data_size;
+    spi_xfer.read_buf = read_buf;
+    spi_xfer.read_size = read_size;
+
+    nrf_gpio_pin_clear(SPI_SS_PIN);
+    result = spi_xfer_next();
+
+    return result;
+}
+
 /**
  * SPI write data then read data
  */
 static sfud_err spi_write_read(const sfud_spi *spi, const uint8_t *write_buf, size_t write_size, uint8_t *read_buf,
         size_t read_size) {
     sfud_err result = SFUD_SUCCESS;
-    //uint8_t send_data, read_data;
 
     /**
      * add your spi write and read code
      */
-    // Reset rx buffer and transfer done flag
-    memset(read_buf, 0, read_size);
-    spi_xfer_done = false;
-    
-    APP_ERROR_CHECK(nrf_drv_spi_transfer(spi->user_data, write_buf, write_size, read_buf, read_size));
-    
-    while (!spi_xfer_done)
+    result = spi_xfer_start(write_buf, write_size, NULL, 0, read_buf, read_size, NULL, NULL);
+
+    while (result == SFUD_SUCCESS && !spi_xfer_done)
     {
         __WFE();
     }
 
-    /* RX debug. TODO: disable it */
-    //if (read_buf[0] != 0)
+    return result;
+}
+
+/**
+ * SPI write command header then payload data, no copy is needed
+ */
+static sfud_err spi_write_sg(const sfud_spi *spi, const uint8_t *header, size_t header_size, const uint8_t *data,
+        size_t data_size) {
+    sfud_err result = SFUD_SUCCESS;
+
+    result = spi_xfer_start(header, header_size, data, data_size, NULL, 0, NULL, NULL);
+
+    while (result == SFUD_SUCCESS && !spi_xfer_done)
     {
-        NRF_LOG_INFO(" Received:");
-        NRF_LOG_HEXDUMP_INFO(read_buf, read_size);
+        __WFE();
     }
 
     return result;
 }
 
-#ifdef SFUD_USING_QSPI
+#ifdef SFUD_USING_ASYNC
+/**
+ * SPI write data then read data asynchronously, done is called on SPI event handler
+ */
+static sfud_err spi_write_read_async(const sfud_spi *spi, const uint8_t *write_buf, size_t write_size,
+        uint8_t *read_buf, size_t read_size, sfud_spi_done_cb done, void *context) {
+    return spi_xfer_start(write_buf, write_size, NULL, 0, read_buf, read_size, done, context);
+}
+
+/**
+ * SPI write command header then payload data asynchronously, done is called on SPI event handler
+ */
+static sfud_err spi_write_sg_async(const sfud_spi *spi, const uint8_t *header, size_t header_size,
+        const uint8_t *data, size_t data_size, sfud_spi_done_cb done, void *context) {
+    return spi_xfer_start(header, header_size, data, data_size, NULL, 0, done, context);
+}
+#endif /* SFUD_USING_ASYNC */
+
+#if defined(SFUD_USING_QSPI) && defined(QSPI_PRESENT)
+/* QSPI EasyDMA needs word aligned address, length and RAM buffer, the rest is read by this buffer */
+#define QSPI_BOUNCE_SIZE  64
+static uint32_t qspi_bounce_buf[QSPI_BOUNCE_SIZE / 4];
+static volatile bool qspi_xfer_done;
+
+static void qspi_handler(nrf_drv_qspi_evt_t event, void * p_context)
+{
+    qspi_xfer_done = true;
+}
+
+/**
+ * QSPI peripheral selects the fast read command, address lines, data lines and dummy cycles by READOC itself
+ */
+static bool qspi_get_readoc(uint8_t instruction, nrf_qspi_readoc_t *readoc)
+{
+    switch (instruction)
+    {
+        case SFUD_CMD_DUAL_OUTPUT_READ_DATA:
+            *readoc = NRF_QSPI_READOC_READ2O;
+            return true;
+        case SFUD_CMD_DUAL_IO_READ_DATA:
+            *readoc = NRF_QSPI_READOC_READ2IO;
+            return true;
+        case SFUD_CMD_QUAD_OUTPUT_READ_DATA:
+            *readoc = NRF_QSPI_READOC_READ4O;
+            return true;
+        case SFUD_CMD_QUAD_IO_READ_DATA:
+            *readoc = NRF_QSPI_READOC_READ4IO;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static sfud_err qspi_xfer(void *read_buf, size_t read_size, uint32_t addr)
+{
+    qspi_xfer_done = false;
+    if (nrf_drv_qspi_read(read_buf, read_size, addr) != NRF_SUCCESS)
+    {
+        return SFUD_ERR_READ;
+    }
+    while (!qspi_xfer_done)
+    {
+        __WFE();
+    }
+
+    return SFUD_SUCCESS;
+}
+
 /**
  * read flash data by QSPI
+ *
+ * The flash pins are shared with SPIM, so SPIM is released while QSPI peripheral reads, then it is initialized
+ * again for the other commands.
  */
 static sfud_err qspi_read(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi_read_cmd_format *qspi_read_cmd_format,
         uint8_t *read_buf, size_t read_size) {
     sfud_err result = SFUD_SUCCESS;
+    nrf_drv_qspi_config_t config = NRF_DRV_QSPI_DEFAULT_CONFIG;
+    size_t size;
 
     /**
      * add your qspi read flash data code
      */
+    if (!qspi_get_readoc(qspi_read_cmd_format->instruction, &config.prot_if.readoc))
+    {
+        return SFUD_ERR_NOT_FOUND;
+    }
+    config.prot_if.addrmode = qspi_read_cmd_format->address_size == 32 ? NRF_QSPI_ADDRMODE_32BIT
+                                                                       : NRF_QSPI_ADDRMODE_24BIT;
+    config.phy_if.spi_mode = NRF_QSPI_MODE_1;
+
+    /* SPI bus is locked by sfud_read, so no SPI transfer is in progress */
+    spi_uninit();
+    if (nrf_drv_qspi_init(&config, qspi_handler, NULL) != NRF_SUCCESS)
+    {
+        spi_init();
+        return SFUD_ERR_READ;
+    }
+
+    while (read_size && result == SFUD_SUCCESS)
+    {
+        if (addr % 4 == 0 && (uint32_t)read_buf % 4 == 0 && read_size >= 4 && nrfx_is_in_ram(read_buf))
+        {
+            /* aligned body is read into user buffer directly */
+            size = read_size & ~3UL;
+            result = qspi_xfer(read_buf, size, addr);
+        }
+        else
+        {
+            /* unaligned head or tail is read by word aligned bounce buffer */
+            uint32_t offset = addr % 4;
+            size = MIN(read_size, QSPI_BOUNCE_SIZE - offset);
+            result = qspi_xfer(qspi_bounce_buf, (offset + size + 3) & ~3UL, addr - offset);
+            memcpy(read_buf, (uint8_t *)qspi_bounce_buf + offset, size);
+        }
+        addr += size;
+        read_buf += size;
+        read_size -= size;
+    }
+
+    nrf_drv_qspi_uninit();
+    spi_init();
 
     return result;
 }
-#endif /* SFUD_USING_QSPI */
+#endif /* defined(SFUD_USING_QSPI) && defined(QSPI_PRESENT) */
 
 sfud_err sfud_spi_port_init(sfud_flash *flash) {
     sfud_err result = SFUD_SUCCESS;
@@ -167,8 +481,19 @@ sfud_err sfud_spi_port_init(sfud_flash *flash) {
             spi_init();
 
             flash->spi.wr = spi_write_read;
+            flash->spi.wr_sg = spi_write_sg;
+#ifdef SFUD_USING_ASYNC
+            flash->spi.wr_async = spi_write_read_async;
+            flash->spi.wr_sg_async = spi_write_sg_async;
+            flash->spi.try_lock = spi_try_lock;
+#endif
 #ifdef SFUD_USING_QSPI
+#ifdef QSPI_PRESENT
             flash->spi.qspi_read = qspi_read;
+#else
+            /* no QSPI peripheral on this chip, sfud_qspi_fast_read_enable() keeps normal SPI read */
+            flash->spi.qspi_read = NULL;
+#endif
 #endif
             flash->spi.lock = spi_lock;
             flash->spi.unlock = spi_unlock;
@@ -176,6 +501,9 @@ sfud_err sfud_spi_port_init(sfud_flash *flash) {
             flash->spi.user_data = (void *)&spi;
             flash->retry.delay = spi_delay;
             flash->retry.times = 10000;
+#ifdef SFUD_USING_ERASE_SCHED
+            flash->erase_sched.get_time_us = get_time_us;
+#endif
 
             break;
         }
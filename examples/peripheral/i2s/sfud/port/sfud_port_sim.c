@@ -0,0 +1,629 @@
+/*
+ * This file is part of the Serial Flash Universal Driver Library.
+ *
+ * Copyright (c) 2016-2018, Armink, <armink.ztl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Host-side simulated SPI NOR flash port. It replaces sfud_port.c when SFUD is built on a
+ *           host with SFUD_USING_HOST_SIM. Every sfud_spi transaction is decoded as one chip select cycle
+ *           of a JEDEC NOR flash, and a simulated clock is advanced by the bus transfer time and by the
+ *           retry delay while the chip is busy, so the latency which SFUD sees is the latency on hardware.
+ * Created on: 2026-10-17
+ */
+
+#include <sfud.h>
+#include <stdarg.h>
+#include <string.h>
+#include "sfud_port_sim.h"
+
+#define SIM_PAGE_SIZE                            256
+#define SIM_MAX_CAPACITY                         (8L * 1024L * 1024L)
+#define SIM_SFDP_SIZE                            0x70
+#define SIM_FAST_READ_MAX_NUM                    4
+
+/* simulated fast read mode */
+typedef struct {
+    uint8_t cmd;
+    uint8_t addr_lines;
+    uint8_t data_lines;
+    uint8_t dummy_cycles;
+} sim_fast_read;
+
+/* simulated chip information */
+typedef struct {
+    const char *name;
+    uint8_t mf_id;
+    uint8_t type_id;
+    uint8_t capacity_id;
+    uint32_t capacity;
+    const uint8_t *sfdp;
+    sfud_sim_timing timing;
+    sim_fast_read fast_read[SIM_FAST_READ_MAX_NUM];
+} sim_chip_info;
+
+/* JESD216A SFDP header, basic parameter header and 16 DWORDs basic flash parameter table of GD25Q16 */
+static const uint8_t gd25q16_sfdp[SIM_SFDP_SIZE] = {
+    /* 0x00: SFDP header, 'S' 'F' 'D' 'P', V1.5, 1 parameter header */
+    'S', 'F', 'D', 'P', 0x05, 0x01, 0x00, 0xFF,
+    /* 0x08: JEDEC basic flash parameter header, V1.5, 16 DWORDs, table at 0x30 */
+    0x00, 0x05, 0x01, 0x10, 0x30, 0x00, 0x00, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    /* 0x30: DWORD1, uniform 4 KB erase by 0x20, write granularity 64 bytes or larger, 3-Byte address,
+     *       1-1-2, 1-2-2, 1-4-4 and 1-1-4 fast read supported */
+    0xE5, 0x20, 0x71, 0xFF,
+    /* DWORD2: density is 16M bits */
+    0xFF, 0xFF, 0xFF, 0x00,
+    /* DWORD3: 1-4-4 read 0xEB with 4 dummy and 2 mode clocks, 1-1-4 read 0x6B with 8 dummy clocks */
+    0x44, 0xEB, 0x08, 0x6B,
+    /* DWORD4: 1-1-2 read 0x3B with 8 dummy clocks, 1-2-2 read 0xBB with 4 mode clocks */
+    0x08, 0x3B, 0x80, 0xBB,
+    /* DWORD5 ~ DWORD7: 2-2-2 and 4-4-4 fast read not supported */
+    0xEE, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0x00, 0xFF,
+    0xFF, 0xFF, 0x00, 0xFF,
+    /* DWORD8 ~ DWORD9: 4 KB erase by 0x20, 32 KB erase by 0x52, 64 KB erase by 0xD8 */
+    0x0C, 0x20, 0x0F, 0x52,
+    0x10, 0xD8, 0x00, 0xFF,
+    /* DWORD10 ~ DWORD11: erase and program times, not used by SFUD */
+    0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF,
+    /* DWORD12: suspend supported, erase suspend latency 20 us, erase resume to suspend interval 128 us */
+    0x00, 0x63, 0x16, 0x33,
+    /* DWORD13: erase suspend 0x75, erase resume 0x7A, program suspend 0x75, program resume 0x7A */
+    0x7A, 0x75, 0x7A, 0x75,
+    /* DWORD14 ~ DWORD16: status polling, power down, 4-Byte addressing and reset, not used by SFUD */
+    0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+/* the typical timings on datasheet, SPI clock and retry delay are the same as port/sfud_port.c */
+static const sim_chip_info chip_info_table[] = {
+    [SFUD_SIM_CHIP_GD25Q16] = {
+        "GD25Q16", SFUD_MF_ID_GIGADEVICE, 0x40, 0x15, 2L * 1024L * 1024L, gd25q16_sfdp,
+        { 4000000, 2000, 1000000, 700000, 30000, 50000000, 160000000, 250000000, 8000, 20000, 100000, 20 },
+        /* same as SFDP */
+        { {0x3B, 1, 2, 8}, {0xBB, 2, 2, 4}, {0x6B, 1, 4, 8}, {0xEB, 4, 4, 6} },
+    },
+    [SFUD_SIM_CHIP_MX25L64] = {
+        "MX25L64", SFUD_MF_ID_MICRON, 0x20, 0x17, 8L * 1024L * 1024L, NULL,
+        { 4000000, 2000, 1000000, 1400000, 30000, 60000000, 500000000, 700000000, 50000, 0, 0, 20 },
+    },
+};
+
+/* simulated flash device object */
+static struct {
+    const sim_chip_info *info;
+    sfud_sim_timing timing;
+    sfud_sim_stat stat;
+    uint64_t now_ns;
+    uint64_t busy_until_ns;
+    uint64_t suspended_ns;
+    uint64_t resume_ns;
+    bool erasing;
+    bool suspended;
+    uint32_t rand_state;
+    uint8_t status;
+    bool addr_4_byte;
+    bool verbose;
+    bool locked;
+#ifdef SFUD_USING_ASYNC
+    bool dispatching;
+    sfud_spi_done_cb pending_done;
+    void *pending_context;
+#endif
+    uint8_t array[SIM_MAX_CAPACITY];
+} sim = { .info = &chip_info_table[SFUD_SIM_CHIP_GD25Q16] };
+
+static char log_buf[256];
+
+void sfud_log_debug(const char *file, const long line, const char *format, ...);
+void sfud_log_info(const char *format, ...);
+
+void sfud_sim_select_chip(sfud_sim_chip chip) {
+    SFUD_ASSERT(chip < sizeof(chip_info_table) / sizeof(sim_chip_info));
+
+    sim.info = &chip_info_table[chip];
+    sim.timing = sim.info->timing;
+    memset(&sim.stat, 0, sizeof(sim.stat));
+    sim.now_ns = 0;
+    sim.busy_until_ns = 0;
+    sim.suspended_ns = 0;
+    sim.resume_ns = 0;
+    sim.erasing = false;
+    sim.suspended = false;
+    sim.rand_state = 0x2545F491;
+    sim.status = 0;
+    sim.addr_4_byte = false;
+    /* a new chip is shipped in erased state */
+    memset(sim.array, 0xFF, sim.info->capacity);
+}
+
+sfud_sim_timing *sfud_sim_get_timing(void) {
+    return &sim.timing;
+}
+
+uint64_t sfud_sim_get_time_ns(void) {
+    return sim.now_ns;
+}
+
+void sfud_sim_advance_time_ns(uint64_t ns) {
+    sim.now_ns += ns;
+}
+
+const sfud_sim_stat *sfud_sim_get_stat(void) {
+    return &sim.stat;
+}
+
+void sfud_sim_clear_stat(void) {
+    memset(&sim.stat, 0, sizeof(sim.stat));
+}
+
+void sfud_sim_set_verbose(bool enabled) {
+    sim.verbose = enabled;
+}
+
+static bool sim_is_busy(void) {
+    return sim.now_ns < sim.busy_until_ns;
+}
+
+static void sim_start_busy(uint64_t duration_ns) {
+    if (sim.timing.jitter_pct) {
+        /* xorshift32, spread the duration in [-jitter, +jitter] percent */
+        int32_t deviation;
+        sim.rand_state ^= sim.rand_state << 13;
+        sim.rand_state ^= sim.rand_state >> 17;
+        sim.rand_state ^= sim.rand_state << 5;
+        deviation = (int32_t)(sim.rand_state % (2U * sim.timing.jitter_pct + 1)) - sim.timing.jitter_pct;
+        duration_ns = duration_ns * (100 + deviation) / 100;
+    }
+    sim.busy_until_ns = sim.now_ns + duration_ns;
+    sim.erasing = false;
+    /* WEL is cleared on the completion of program or erase, nobody can see it before BUSY is cleared */
+    sim.status &= ~SFUD_STATUS_REGISTER_WEL;
+}
+
+static uint32_t sim_get_addr(const uint8_t *buf) {
+    if (sim.addr_4_byte) {
+        return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3];
+    } else {
+        return ((uint32_t)buf[0] << 16) | ((uint32_t)buf[1] << 8) | buf[2];
+    }
+}
+
+static void sim_page_program(uint32_t addr, const uint8_t *data, size_t size) {
+    uint32_t page = addr & ~(SIM_PAGE_SIZE - 1);
+    size_t i;
+
+    /* NOR program can only clear bits, the address wraps inside one page */
+    for (i = 0; i < size; i++) {
+        uint32_t cur = page + ((addr + i) & (SIM_PAGE_SIZE - 1));
+        sim.array[cur % sim.info->capacity] &= data[i];
+    }
+    sim.stat.page_programs++;
+    if (size > SIM_PAGE_SIZE) {
+        size = SIM_PAGE_SIZE;
+    }
+    sim_start_busy(sim.timing.byte_program_ns
+            + (uint64_t)(sim.timing.page_program_ns - sim.timing.byte_program_ns) * size / SIM_PAGE_SIZE);
+}
+
+static void sim_erase(uint32_t addr, uint32_t size, uint64_t duration_ns) {
+    addr &= ~(size - 1);
+    if (addr < sim.info->capacity) {
+        memset(&sim.array[addr], 0xFF, size);
+    }
+    sim.stat.erases++;
+    sim_start_busy(duration_ns);
+    /* only the sector and block erase can be suspended */
+    sim.erasing = true;
+}
+
+/**
+ * Suspend the sector or block erase in progress, the chip is ready after the suspend latency. The erase makes no
+ * progress when it is suspended again in resume interval, so this suspend is ignored.
+ */
+static void sim_erase_suspend(void) {
+    if (!sim.erasing || !sim_is_busy() || sim.suspended || sim.timing.suspend_ns == 0
+            || sim.busy_until_ns - sim.now_ns <= sim.timing.suspend_ns) {
+        return;
+    }
+    if (sim.now_ns - sim.resume_ns < sim.timing.resume_interval_ns) {
+        sim.stat.bad_commands++;
+        SFUD_INFO("Warning: simulated flash ignored erase suspend in resume interval.");
+        return;
+    }
+    sim.suspended_ns = sim.busy_until_ns - sim.now_ns - sim.timing.suspend_ns;
+    sim.busy_until_ns = sim.now_ns + sim.timing.suspend_ns;
+    sim.suspended = true;
+    sim.stat.suspends++;
+}
+
+static void sim_erase_resume(void) {
+    if (sim.suspended) {
+        sim.busy_until_ns = sim.now_ns + sim.suspended_ns;
+        sim.resume_ns = sim.now_ns;
+        sim.suspended = false;
+    }
+}
+
+static void sim_read(uint32_t addr, uint8_t *read_buf, size_t read_size) {
+    size_t i;
+
+    for (i = 0; i < read_size; i++) {
+        read_buf[i] = sim.array[(addr + i) % sim.info->capacity];
+    }
+}
+
+/**
+ * decode one chip select cycle of the simulated flash, the payload data follows the written command
+ */
+static void sim_transaction(const uint8_t *write_buf, size_t write_size, const uint8_t *data, size_t data_size,
+        uint8_t *read_buf, size_t read_size) {
+    size_t addr_size = sim.addr_4_byte ? 4 : 3;
+    uint8_t cmd = write_buf[0];
+    size_t i;
+
+    if (read_size) {
+        /* floating MISO while nothing is driven */
+        memset(read_buf, 0xFF, read_size);
+    }
+
+    /* only the status register can be read and the erase can be suspended when program or erase is in progress */
+    if (sim_is_busy() && cmd != SFUD_CMD_READ_STATUS_REGISTER && cmd != 0x75) {
+        sim.stat.bad_commands++;
+        SFUD_INFO("Warning: simulated flash ignored command 0x%02X when it's busy.", cmd);
+        return;
+    }
+
+    switch (cmd) {
+    case SFUD_CMD_READ_STATUS_REGISTER:
+        sim.stat.status_polls++;
+        for (i = 0; i < read_size; i++) {
+            read_buf[i] = sim.status | (sim_is_busy() ? SFUD_STATUS_REGISTER_BUSY : 0);
+        }
+        break;
+    case SFUD_CMD_WRITE_ENABLE:
+        sim.status |= SFUD_STATUS_REGISTER_WEL;
+        break;
+    case SFUD_CMD_WRITE_DISABLE:
+        sim.status &= ~SFUD_STATUS_REGISTER_WEL;
+        break;
+    case SFUD_VOLATILE_SR_WRITE_ENABLE:
+        break;
+    case SFUD_CMD_WRITE_STATUS_REGISTER:
+        if (write_size > 1) {
+            sim.status = write_buf[1] & ~(SFUD_STATUS_REGISTER_BUSY | SFUD_STATUS_REGISTER_WEL);
+        }
+        break;
+    case SFUD_CMD_JEDEC_ID:
+        if (read_size >= 3) {
+            read_buf[0] = sim.info->mf_id;
+            read_buf[1] = sim.info->type_id;
+            read_buf[2] = sim.info->capacity_id;
+        }
+        break;
+    case SFUD_CMD_READ_SFDP_REGISTER:
+        if (sim.info->sfdp && write_size >= 5) {
+            uint32_t addr = ((uint32_t)write_buf[1] << 16) | ((uint32_t)write_buf[2] << 8) | write_buf[3];
+            for (i = 0; i < read_size && addr + i < SIM_SFDP_SIZE; i++) {
+                read_buf[i] = sim.info->sfdp[addr + i];
+            }
+        }
+        break;
+    case SFUD_CMD_READ_DATA:
+        if (write_size >= 1 + addr_size) {
+            sim_read(sim_get_addr(&write_buf[1]), read_buf, read_size);
+        }
+        break;
+    case 0x75:
+        sim_erase_suspend();
+        break;
+    case 0x7A:
+        sim_erase_resume();
+        break;
+    case SFUD_CMD_PAGE_PROGRAM:
+        if (sim.suspended) {
+            /* program and erase are not emulated in erase suspend */
+            sim.stat.bad_commands++;
+        } else if ((sim.status & SFUD_STATUS_REGISTER_WEL) && data_size) {
+            sim_page_program(sim_get_addr(&write_buf[1]), data, data_size);
+        } else if ((sim.status & SFUD_STATUS_REGISTER_WEL) && write_size > 1 + addr_size) {
+            sim_page_program(sim_get_addr(&write_buf[1]), &write_buf[1 + addr_size], write_size - 1 - addr_size);
+        }
+        break;
+    case 0x20:
+        if (!sim.suspended && (sim.status & SFUD_STATUS_REGISTER_WEL) && write_size >= 1 + addr_size) {
+            sim_erase(sim_get_addr(&write_buf[1]), 4096, sim.timing.erase_4k_ns);
+        }
+        break;
+    case 0x52:
+        if (!sim.suspended && (sim.status & SFUD_STATUS_REGISTER_WEL) && write_size >= 1 + addr_size) {
+            sim_erase(sim_get_addr(&write_buf[1]), 32768, sim.timing.erase_32k_ns);
+        }
+        break;
+    case 0xD8:
+        if (!sim.suspended && (sim.status & SFUD_STATUS_REGISTER_WEL) && write_size >= 1 + addr_size) {
+            sim_erase(sim_get_addr(&write_buf[1]), 65536, sim.timing.erase_64k_ns);
+        }
+        break;
+    case SFUD_CMD_ERASE_CHIP:
+    case 0x60:
+        if (!sim.suspended && (sim.status & SFUD_STATUS_REGISTER_WEL)) {
+            memset(sim.array, 0xFF, sim.info->capacity);
+            sim.stat.erases++;
+            sim_start_busy((uint64_t)sim.timing.chip_erase_ms * 1000000);
+        }
+        break;
+    case SFUD_CMD_ENTER_4B_ADDRESS_MODE:
+        sim.addr_4_byte = true;
+        break;
+    case SFUD_CMD_EXIT_4B_ADDRESS_MODE:
+        sim.addr_4_byte = false;
+        break;
+    case SFUD_CMD_ENABLE_RESET:
+        break;
+    case SFUD_CMD_RESET:
+        sim.status &= ~SFUD_STATUS_REGISTER_WEL;
+        sim.addr_4_byte = false;
+        break;
+    default:
+        sim.stat.bad_commands++;
+        SFUD_INFO("Warning: simulated flash is not support command 0x%02X.", cmd);
+        break;
+    }
+}
+
+static void spi_delay(void) {
+    sim.now_ns += sim.timing.poll_delay_ns;
+}
+
+#ifdef SFUD_USING_ERASE_SCHED
+static uint32_t get_time_us(void) {
+    return (uint32_t)(sim.now_ns / 1000);
+}
+#endif
+
+/**
+ * The simulated asynchronous operation is finished before it returns, unless it is started by a done callback, then
+ * nothing can finish it while the blocking operation waits for the bus.
+ */
+static void spi_lock(const sfud_spi *spi) {
+    (void)spi;
+    SFUD_ASSERT(!sim.locked);
+    sim.locked = true;
+}
+
+static void spi_unlock(const sfud_spi *spi) {
+    (void)spi;
+    sim.locked = false;
+}
+
+#ifdef SFUD_USING_ASYNC
+static bool spi_try_lock(const sfud_spi *spi) {
+    (void)spi;
+    if (sim.locked) {
+        return false;
+    }
+    sim.locked = true;
+    return true;
+}
+#endif
+
+/**
+ * SPI write header, payload data then read data
+ */
+static sfud_err spi_xfer(const uint8_t *write_buf, size_t write_size, const uint8_t *data, size_t data_size,
+        uint8_t *read_buf, size_t read_size) {
+    sfud_err result = SFUD_SUCCESS;
+    uint64_t bytes = write_size + data_size + read_size;
+
+    if (write_size == 0) {
+        return SFUD_ERR_WRITE;
+    }
+
+    sim_transaction(write_buf, write_size, data, data_size, read_buf, read_size);
+
+    /* the command is decoded when chip select is released, so the bus time is accounted after that */
+    sim.stat.transactions++;
+    sim.stat.bytes_clocked += bytes;
+    sim.now_ns += sim.timing.cs_overhead_ns + bytes * 8 * 1000000000ULL / sim.timing.spi_clock_hz;
+
+    return result;
+}
+
+/**
+ * SPI write data then read data
+ */
+static sfud_err spi_write_read(const sfud_spi *spi, const uint8_t *write_buf, size_t write_size, uint8_t *read_buf,
+        size_t read_size) {
+    (void)spi;
+    return spi_xfer(write_buf, write_size, NULL, 0, read_buf, read_size);
+}
+
+/**
+ * SPI write command header then payload data
+ */
+static sfud_err spi_write_sg(const sfud_spi *spi, const uint8_t *header, size_t header_size, const uint8_t *data,
+        size_t data_size) {
+    (void)spi;
+    return spi_xfer(header, header_size, data, data_size, NULL, 0);
+}
+
+#ifdef SFUD_USING_QSPI
+/**
+ * read flash data by QSPI, the command format must be the same as one of fast read modes on simulated chip
+ */
+static sfud_err qspi_read(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi_read_cmd_format *qspi_read_cmd_format,
+        uint8_t *read_buf, size_t read_size) {
+    const sfud_qspi_read_cmd_format *fmt = qspi_read_cmd_format;
+    const sim_fast_read *mode = NULL;
+    uint64_t clocks;
+    size_t i;
+
+    (void)spi;
+
+    for (i = 0; i < SIM_FAST_READ_MAX_NUM; i++) {
+        if (sim.info->fast_read[i].cmd && sim.info->fast_read[i].cmd == fmt->instruction) {
+            mode = &sim.info->fast_read[i];
+            break;
+        }
+    }
+    if (mode == NULL || fmt->instruction_lines != 1 || fmt->address_lines != mode->addr_lines
+            || fmt->data_lines != mode->data_lines || fmt->dummy_cycles != mode->dummy_cycles
+            || fmt->address_size != (sim.addr_4_byte ? 32 : 24) || sim_is_busy()) {
+        sim.stat.bad_commands++;
+        SFUD_INFO("Warning: simulated flash got bad fast read command 0x%02X.", fmt->instruction);
+        memset(read_buf, 0xFF, read_size);
+    } else {
+        sim_read(addr, read_buf, read_size);
+    }
+
+    clocks = 8 / fmt->instruction_lines + fmt->address_size / fmt->address_lines + fmt->dummy_cycles
+            + (uint64_t)read_size * 8 / fmt->data_lines;
+    sim.stat.transactions++;
+    sim.stat.qspi_reads++;
+    sim.stat.bytes_clocked += 1 + fmt->address_size / 8 + read_size;
+    sim.now_ns += sim.timing.cs_overhead_ns + clocks * 1000000000ULL / sim.timing.spi_clock_hz;
+
+    return SFUD_SUCCESS;
+}
+#endif /* SFUD_USING_QSPI */
+
+#ifdef SFUD_USING_ASYNC
+/**
+ * The simulated transfer is done at once, and the done callbacks are dispatched in a loop instead of recursion, so
+ * the whole asynchronous operation is finished before the first asynchronous transfer returns.
+ */
+static sfud_err spi_dispatch_async(sfud_err result, sfud_spi_done_cb done, void *context) {
+    if (result != SFUD_SUCCESS) {
+        return result;
+    }
+    sim.pending_done = done;
+    sim.pending_context = context;
+    if (!sim.dispatching) {
+        sim.dispatching = true;
+        while (sim.pending_done) {
+            done = sim.pending_done;
+            sim.pending_done = NULL;
+            done(sim.pending_context, SFUD_SUCCESS);
+        }
+        sim.dispatching = false;
+    }
+
+    return result;
+}
+
+/**
+ * SPI write data then read data asynchronously
+ */
+static sfud_err spi_write_read_async(const sfud_spi *spi, const uint8_t *write_buf, size_t write_size,
+        uint8_t *read_buf, size_t read_size, sfud_spi_done_cb done, void *context) {
+    (void)spi;
+    return spi_dispatch_async(spi_xfer(write_buf, write_size, NULL, 0, read_buf, read_size), done, context);
+}
+
+/**
+ * SPI write command header then payload data asynchronously
+ */
+static sfud_err spi_write_sg_async(const sfud_spi *spi, const uint8_t *header, size_t header_size,
+        const uint8_t *data, size_t data_size, sfud_spi_done_cb done, void *context) {
+    (void)spi;
+    return spi_dispatch_async(spi_xfer(header, header_size, data, data_size, NULL, 0), done, context);
+}
+#endif /* SFUD_USING_ASYNC */
+
+sfud_err sfud_spi_port_init(sfud_flash *flash) {
+    sfud_err result = SFUD_SUCCESS;
+
+    if (sim.timing.spi_clock_hz == 0) {
+        sfud_sim_select_chip(SFUD_SIM_CHIP_GD25Q16);
+    }
+
+    flash->spi.wr = spi_write_read;
+    flash->spi.wr_sg = spi_write_sg;
+#ifdef SFUD_USING_QSPI
+    flash->spi.qspi_read = qspi_read;
+#endif
+#ifdef SFUD_USING_ASYNC
+    flash->spi.wr_async = spi_write_read_async;
+    flash->spi.wr_sg_async = spi_write_sg_async;
+    flash->spi.try_lock = spi_try_lock;
+#endif
+    flash->spi.lock = spi_lock;
+    flash->spi.unlock = spi_unlock;
+    flash->spi.user_data = &sim;
+    flash->retry.delay = spi_delay;
+#ifdef SFUD_USING_ERASE_SCHED
+    flash->erase_sched.get_time_us = get_time_us;
+#endif
+    /* same as the hardware port, plus the chip erase time in simulated retry delay */
+    flash->retry.times = 10000 + (size_t)sim.timing.chip_erase_ms * 1000000 / sim.timing.poll_delay_ns;
+
+    return result;
+}
+
+/**
+ * This function is print debug info.
+ *
+ * @param file the file which has call this function
+ * @param line the line number which has call this function
+ * @param format output format
+ * @param ... args
+ */
+void sfud_log_debug(const char *file, const long line, const char *format, ...) {
+    va_list args;
+
+    if (!sim.verbose) {
+        return;
+    }
+    /* args point to the first variable parameter */
+    va_start(args, format);
+    printf("[SFUD](%s:%ld) ", file, line);
+    /* must use vprintf to print */
+    vsnprintf(log_buf, sizeof(log_buf), format, args);
+    printf("%s\n", log_buf);
+    va_end(args);
+}
+
+/**
+ * This function is print routine info.
+ *
+ * @param format output format
+ * @param ... args
+ */
+void sfud_log_info(const char *format, ...) {
+    va_list args;
+
+    if (!sim.verbose) {
+        return;
+    }
+    /* args point to the first variable parameter */
+    va_start(args, format);
+    printf("[SFUD]");
+    /* must use vprintf to print */
+    vsnprintf(log_buf, sizeof(log_buf), format, args);
+    printf("%s\n", log_buf);
+    va_end(args);
+}
@@ -0,0 +1,130 @@
+/*
+ * This file is part of the Serial Flash Universal Driver Library.
+ *
+ * Copyright (c) 2016-2018, Armink, <armink.ztl@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Host-side simulated SPI NOR flash port.
+ * Created on: 2026-10-17
+ */
+
+#ifndef _SFUD_PORT_SIM_H_
+#define _SFUD_PORT_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * emulated flash chip
+ */
+typedef enum {
+    SFUD_SIM_CHIP_GD25Q16 = 0,                   /**< GigaDevice 16Mb, JEDEC SFDP available */
+    SFUD_SIM_CHIP_MX25L64 = 1,                   /**< 64Mb, no SFDP, found by SFUD_FLASH_CHIP_TABLE */
+} sfud_sim_chip;
+
+/**
+ * simulated flash timings, all of time values are in nanoseconds
+ */
+typedef struct {
+    uint32_t spi_clock_hz;                       /**< SPI SCK frequency */
+    uint32_t cs_overhead_ns;                     /**< chip select and driver setup cost per transaction */
+    uint32_t poll_delay_ns;                      /**< time passed by each retry.delay while polling busy */
+    uint32_t page_program_ns;                    /**< page program time (tPP) */
+    uint32_t byte_program_ns;                    /**< byte program time (tBP), used by AAI and 1 byte write */
+    uint32_t erase_4k_ns;                        /**< 4 KB sector erase time (tSE) */
+    uint32_t erase_32k_ns;                       /**< 32 KB block erase time (tBE1) */
+    uint32_t erase_64k_ns;                       /**< 64 KB block erase time (tBE2) */
+    uint32_t chip_erase_ms;                      /**< chip erase time (tCE), in milliseconds */
+    uint32_t suspend_ns;                         /**< erase suspend latency (tSUS), 0: erase suspend not supported */
+    uint32_t resume_interval_ns;                 /**< minimum time from erase resume to next suspend (tRS) */
+    uint8_t jitter_pct;                          /**< random deviation of program and erase time, in percent */
+} sfud_sim_timing;
+
+/**
+ * simulated flash statistics
+ */
+typedef struct {
+    uint32_t transactions;                       /**< chip select assertions */
+    uint32_t status_polls;                       /**< read status register commands */
+    uint32_t page_programs;                      /**< page program commands */
+    uint32_t erases;                             /**< sector/block erase commands */
+    uint32_t qspi_reads;                         /**< dual or quad fast read commands */
+    uint32_t suspends;                           /**< accepted erase suspend commands */
+    uint32_t bad_commands;                       /**< commands ignored by busy, unknown or wrong format */
+    uint64_t bytes_clocked;                      /**< bytes shifted over the bus */
+} sfud_sim_stat;
+
+/**
+ * Select the emulated chip and its default timings. Must be called before sfud_init().
+ *
+ * @param chip emulated chip
+ */
+void sfud_sim_select_chip(sfud_sim_chip chip);
+
+/**
+ * Get the timings which used by the emulated chip, they can be changed at any time.
+ *
+ * @return timing configuration
+ */
+sfud_sim_timing *sfud_sim_get_timing(void);
+
+/**
+ * Get the simulated time since sfud_sim_select_chip().
+ *
+ * @return simulated time in nanoseconds
+ */
+uint64_t sfud_sim_get_time_ns(void);
+
+/**
+ * Advance the simulated time, e.g. for the application work between flash operations.
+ *
+ * @param ns time in nanoseconds
+ */
+void sfud_sim_advance_time_ns(uint64_t ns);
+
+/**
+ * Get the simulated bus and flash statistics.
+ *
+ * @return statistics
+ */
+const sfud_sim_stat *sfud_sim_get_stat(void);
+
+/**
+ * Clear the simulated bus and flash statistics.
+ */
+void sfud_sim_clear_stat(void);
+
+/**
+ * Enable or disable printing of SFUD debug and info logs.
+ *
+ * @param enabled true: print logs
+ */
+void sfud_sim_set_verbose(bool enabled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SFUD_PORT_SIM_H_ */
@@ -62,6 +62,11 @@ enum sfud_qspi_read_mode {
 static const sfud_qspi_flash_ext_info qspi_flash_ext_info_table[] = SFUD_FLASH_EXT_INFO_TABLE;
 #endif /* SFUD_USING_QSPI */
 
+#ifdef SFUD_USING_ERASE_SCHED
+/* erase suspend information table */
+static const sfud_flash_suspend_info flash_suspend_info_table[] = SFUD_FLASH_SUSPEND_INFO_TABLE;
+#endif
+
 static sfud_err software_init(const sfud_flash *flash);
 static sfud_err hardware_init(sfud_flash *flash);
 static sfud_err page256_or_1_byte_write(const sfud_flash *flash, uint32_t addr, size_t size, uint16_t write_gran,
@@ -73,6 +78,12 @@ static sfud_err read_jedec_id(sfud_flash *flash);
 static sfud_err set_write_enabled(const sfud_flash *flash, bool enabled);
 static sfud_err set_4_byte_address_mode(sfud_flash *flash, bool enabled);
 static void make_adress_byte_array(const sfud_flash *flash, uint32_t addr, uint8_t *array);
+#ifdef SFUD_USING_ERASE_SCHED
+static void erase_sched_init(sfud_flash *flash);
+static sfud_err erase_sched_sync(const sfud_flash *flash);
+static sfud_err erase_sched_read_begin(const sfud_flash *flash, uint32_t addr, size_t size);
+static sfud_err erase_sched_read_end(const sfud_flash *flash);
+#endif
 
 /* ../port/sfup_port.c */
 extern void sfud_log_debug(const char *file, const long line, const char *format, ...);
@@ -181,6 +192,40 @@ static void qspi_set_read_cmd_format(sfud_flash *flash, uint8_t ins, uint8_t ins
     flash->read_cmd_format.data_lines = data_lines;
 }
 
+#ifdef SFUD_USING_SFDP
+/**
+ * select the widest fast read mode by SFDP parameter
+ *
+ * @param flash flash device
+ * @param data_line_width the data lines max width which QSPI bus supported, such as 1, 2, 4
+ *
+ * @return true: a fast read mode is selected
+ */
+static bool qspi_sfdp_fast_read_enable(sfud_flash *flash, uint8_t data_line_width) {
+    /* from the fastest to the slowest, | mode | address lines | data lines | */
+    static const uint8_t mode_table[][3] = {
+        {SFUD_SFDP_FAST_READ_1_4_4, 4, 4},
+        {SFUD_SFDP_FAST_READ_1_1_4, 1, 4},
+        {SFUD_SFDP_FAST_READ_1_2_2, 2, 2},
+        {SFUD_SFDP_FAST_READ_1_1_2, 1, 2},
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof(mode_table) / sizeof(mode_table[0]); i++) {
+        uint8_t mode = mode_table[i][0];
+        if (mode_table[i][2] <= data_line_width && flash->sfdp.fast_read[mode].cmd) {
+            qspi_set_read_cmd_format(flash, flash->sfdp.fast_read[mode].cmd, 1, mode_table[i][1],
+                    flash->sfdp.fast_read[mode].dummy_cycles, mode_table[i][2]);
+            SFUD_DEBUG("Fast read is enabled by SFDP. Command is 0x%02X, dummy cycles is %d.",
+                    flash->read_cmd_format.instruction, flash->read_cmd_format.dummy_cycles);
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif /* SFUD_USING_SFDP */
+
 /**
  * Enbale the fast read mode in QSPI flash mode. Default read mode is normal SPI mode.
  *
@@ -202,6 +247,20 @@ sfud_err sfud_qspi_fast_read_enable(sfud_flash *flash, uint8_t data_line_width)
     SFUD_ASSERT(flash);
     SFUD_ASSERT(data_line_width == 1 || data_line_width == 2 || data_line_width == 4);
 
+    /* the port has no QSPI bus, keep normal SPI read */
+    if (flash->spi.qspi_read == NULL) {
+        SFUD_INFO("Warning: QSPI read is not supported by port, fast read is not enabled.");
+        qspi_set_read_cmd_format(flash, SFUD_CMD_READ_DATA, 1, 1, 0, 1);
+        return SFUD_ERR_NOT_FOUND;
+    }
+
+#ifdef SFUD_USING_SFDP
+    /* the fast read modes which are discovered by SFDP have higher priority than the table */
+    if (flash->sfdp.available && qspi_sfdp_fast_read_enable(flash, data_line_width)) {
+        return result;
+    }
+#endif
+
     /* get read_mode, If don't found, the default is SFUD_QSPI_NORMAL_SPI_READ */
     for (i = 0; i < sizeof(qspi_flash_ext_info_table) / sizeof(sfud_qspi_flash_ext_info); i++) {
         if ((qspi_flash_ext_info_table[i].mf_id == flash->chip.mf_id)
@@ -364,6 +423,10 @@ static sfud_err hardware_init(sfud_flash *flash) {
         flash->addr_in_4_byte = false;
     }
 
+#ifdef SFUD_USING_ERASE_SCHED
+    erase_sched_init(flash);
+#endif
+
     return result;
 }
 
@@ -396,6 +459,9 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
     sfud_err result = SFUD_SUCCESS;
     const sfud_spi *spi = &flash->spi;
     uint8_t cmd_data[5], cmd_size;
+#ifdef SFUD_USING_ERASE_SCHED
+    sfud_err end_result;
+#endif
 
     SFUD_ASSERT(flash);
     SFUD_ASSERT(data);
@@ -411,7 +477,11 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
         spi->lock(spi);
     }
 
+#ifdef SFUD_USING_ERASE_SCHED
+    result = erase_sched_read_begin(flash, addr, size);
+#else
     result = wait_busy(flash);
+#endif
 
     if (result == SFUD_SUCCESS) {
 #ifdef SFUD_USING_QSPI
@@ -426,6 +496,13 @@ sfud_err sfud_read(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t
             result = spi->wr(spi, cmd_data, cmd_size, data, size);
         }
     }
+#ifdef SFUD_USING_ERASE_SCHED
+    /* resume the erase even the read is failed */
+    end_result = erase_sched_read_end(flash);
+    if (result == SFUD_SUCCESS) {
+        result = end_result;
+    }
+#endif
     /* unlock SPI */
     if (spi->unlock) {
         spi->unlock(spi);
@@ -449,6 +526,13 @@ sfud_err sfud_chip_erase(const sfud_flash *flash) {
     SFUD_ASSERT(flash);
     /* must be call this function after initialize OK */
     SFUD_ASSERT(flash->init_ok);
+#ifdef SFUD_USING_ERASE_SCHED
+    /* the queued erases go first */
+    result = erase_sched_sync(flash);
+    if (result != SFUD_SUCCESS) {
+        return result;
+    }
+#endif
     /* lock SPI */
     if (spi->lock) {
         spi->lock(spi);
@@ -487,6 +571,33 @@ __exit:
     return result;
 }
 
+/**
+ * get the eraser for erase process
+ *
+ * @param flash flash device
+ * @param addr erase address
+ * @param size remain erase size
+ * @param cmd erase command
+ * @param erase_size erase sector or block size of the command
+ */
+static void get_eraser(const sfud_flash *flash, uint32_t addr, size_t size, uint8_t *cmd, size_t *erase_size) {
+    /* if this flash is support SFDP parameter, then used SFDP parameter supplies eraser */
+#ifdef SFUD_USING_SFDP
+    extern size_t sfud_sfdp_get_suitable_eraser(const sfud_flash *flash, uint32_t addr, size_t erase_size);
+
+    size_t eraser_index;
+    if (flash->sfdp.available) {
+        /* get the suitable eraser for erase process from SFDP parameter */
+        eraser_index = sfud_sfdp_get_suitable_eraser(flash, addr, size);
+        *cmd = flash->sfdp.eraser[eraser_index].cmd;
+        *erase_size = flash->sfdp.eraser[eraser_index].size;
+        return;
+    }
+#endif
+    *cmd = flash->chip.erase_gran_cmd;
+    *erase_size = flash->chip.erase_gran;
+}
+
 /**
  * erase flash data
  *
@@ -499,8 +610,6 @@ __exit:
  * @return result
  */
 sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size) {
-    extern size_t sfud_sfdp_get_suitable_eraser(const sfud_flash *flash, uint32_t addr, size_t erase_size);
-
     sfud_err result = SFUD_SUCCESS;
     const sfud_spi *spi = &flash->spi;
     uint8_t cmd_data[5], cmd_size, cur_erase_cmd;
@@ -519,6 +628,14 @@ sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size) {
         return sfud_chip_erase(flash);
     }
 
+#ifdef SFUD_USING_ERASE_SCHED
+    /* the queued erases go first */
+    result = erase_sched_sync(flash);
+    if (result != SFUD_SUCCESS) {
+        return result;
+    }
+#endif
+
     /* lock SPI */
     if (spi->lock) {
         spi->lock(spi);
@@ -526,21 +643,7 @@ sfud_err sfud_erase(const sfud_flash *flash, uint32_t addr, size_t size) {
 
     /* loop erase operate. erase unit is erase granularity */
     while (size) {
-        /* if this flash is support SFDP parameter, then used SFDP parameter supplies eraser */
-#ifdef SFUD_USING_SFDP
-        size_t eraser_index;
-        if (flash->sfdp.available) {
-            /* get the suitable eraser for erase process from SFDP parameter */
-            eraser_index = sfud_sfdp_get_suitable_eraser(flash, addr, size);
-            cur_erase_cmd = flash->sfdp.eraser[eraser_index].cmd;
-            cur_erase_size = flash->sfdp.eraser[eraser_index].size;
-        } else {
-#else
-        {
-#endif
-            cur_erase_cmd = flash->chip.erase_gran_cmd;
-            cur_erase_size = flash->chip.erase_gran;
-        }
+        get_eraser(flash, addr, size, &cur_erase_cmd, &cur_erase_size);
         /* set the flash write enable */
         result = set_write_enabled(flash, true);
         if (result != SFUD_SUCCESS) {
@@ -588,6 +691,33 @@ __exit:
     return result;
 }
 
+/**
+ * send page program command by copying command and data into one buffer, for the port which has no wr_sg
+ */
+static sfud_err page_program_copy(const sfud_spi *spi, const uint8_t *cmd_data, uint8_t cmd_size,
+        const uint8_t *data, size_t data_size) {
+    uint8_t buf[5 + SFUD_WRITE_MAX_PAGE_SIZE];
+
+    SFUD_ASSERT(data_size <= SFUD_WRITE_MAX_PAGE_SIZE);
+
+    memcpy(buf, cmd_data, cmd_size);
+    memcpy(&buf[cmd_size], data, data_size);
+
+    return spi->wr(spi, buf, cmd_size + data_size, NULL, 0);
+}
+
+/**
+ * send page program command, the page data is sent from user buffer directly when port supports wr_sg
+ */
+static sfud_err page_program(const sfud_spi *spi, const uint8_t *cmd_data, uint8_t cmd_size,
+        const uint8_t *data, size_t data_size) {
+    if (spi->wr_sg) {
+        return spi->wr_sg(spi, cmd_data, cmd_size, data, data_size);
+    } else {
+        return page_program_copy(spi, cmd_data, cmd_size, data, data_size);
+    }
+}
+
 /**
  * write flash data (no erase operate) for write 1 to 256 bytes per page mode or byte write mode
  *
@@ -603,8 +733,7 @@ static sfud_err page256_or_1_byte_write(const sfud_flash *flash, uint32_t addr,
         const uint8_t *data) {
     sfud_err result = SFUD_SUCCESS;
     const sfud_spi *spi = &flash->spi;
-    static uint8_t cmd_data[5 + SFUD_WRITE_MAX_PAGE_SIZE];
-    uint8_t cmd_size;
+    uint8_t cmd_data[5], cmd_size;
     size_t data_size;
 
     SFUD_ASSERT(flash);
@@ -650,9 +779,7 @@ static sfud_err page256_or_1_byte_write(const sfud_flash *flash, uint32_t addr,
         size -= data_size;
         addr += data_size;
 
-        memcpy(&cmd_data[cmd_size], data, data_size);
-
-        result = spi->wr(spi, cmd_data, cmd_size + data_size, NULL, 0);
+        result = page_program(spi, cmd_data, cmd_size, data, data_size);
         if (result != SFUD_SUCCESS) {
             SFUD_INFO("Error: Flash write SPI communicate error.");
             goto __exit;
@@ -780,6 +907,14 @@ __exit:
 sfud_err sfud_write(const sfud_flash *flash, uint32_t addr, size_t size, const uint8_t *data) {
     sfud_err result = SFUD_SUCCESS;
 
+#ifdef SFUD_USING_ERASE_SCHED
+    /* the queued erases go first */
+    result = erase_sched_sync(flash);
+    if (result != SFUD_SUCCESS) {
+        return result;
+    }
+#endif
+
     if (flash->chip.write_mode & SFUD_WM_PAGE_256B) {
         result = page256_or_1_byte_write(flash, addr, size, 256, data);
     } else if (flash->chip.write_mode & SFUD_WM_AAI) {
@@ -813,6 +948,674 @@ sfud_err sfud_erase_write(const sfud_flash *flash, uint32_t addr, size_t size, c
     return result;
 }
 
+#ifdef SFUD_USING_ASYNC
+/**
+ * asynchronous operation state
+ */
+enum {
+    ASYNC_IDLE = 0,                              /**< no operation */
+    ASYNC_READ_WAIT_READY,                       /**< polling status register before read */
+    ASYNC_READ_DATA,                             /**< reading data */
+    ASYNC_WRITE_WAIT_READY,                      /**< polling status register before first page program */
+    ASYNC_WRITE_ENABLE,                          /**< sending write enable */
+    ASYNC_WRITE_PROGRAM,                         /**< sending page program */
+    ASYNC_WRITE_WAIT_BUSY,                       /**< polling status register after page program */
+    ASYNC_WRITE_DISABLE,                         /**< sending write disable */
+};
+
+static void async_event(void *context, sfud_err result);
+
+static sfud_err async_start(sfud_flash *flash, uint8_t state, const uint8_t *write_buf, size_t write_size,
+        uint8_t *read_buf, size_t read_size) {
+    flash->async.state = state;
+    return flash->spi.wr_async(&flash->spi, write_buf, write_size, read_buf, read_size, async_event, flash);
+}
+
+static sfud_err async_poll_status(sfud_flash *flash, uint8_t state) {
+    flash->async.cmd_data[0] = SFUD_CMD_READ_STATUS_REGISTER;
+    return async_start(flash, state, flash->async.cmd_data, 1, flash->async.status, sizeof(flash->async.status));
+}
+
+static void async_finish(sfud_flash *flash, sfud_err result) {
+    sfud_async_done_cb done = flash->async.done;
+
+    /* set idle and unlock SPI before callback, so the callback can start next operation */
+    flash->async.state = ASYNC_IDLE;
+    flash->spi.unlock(&flash->spi);
+    if (result != SFUD_SUCCESS) {
+        SFUD_INFO("Error: Flash asynchronous operation failed (%d).", result);
+    }
+    if (done) {
+        done(flash, result, flash->async.context);
+    }
+}
+
+/**
+ * send next page program of asynchronous write, the page data is sent from user buffer directly
+ */
+static sfud_err async_page_program(sfud_flash *flash) {
+    sfud_async *async = &flash->async;
+    uint8_t cmd_size = flash->addr_in_4_byte ? 5 : 4;
+
+    /* make write align by page */
+    async->data_size = SFUD_WRITE_MAX_PAGE_SIZE - (async->addr % SFUD_WRITE_MAX_PAGE_SIZE);
+    if (async->data_size > async->size) {
+        async->data_size = async->size;
+    }
+    async->cmd_data[0] = SFUD_CMD_PAGE_PROGRAM;
+    make_adress_byte_array(flash, async->addr, &async->cmd_data[1]);
+
+    async->state = ASYNC_WRITE_PROGRAM;
+    return flash->spi.wr_sg_async(&flash->spi, async->cmd_data, cmd_size, async->write_buf, async->data_size,
+            async_event, flash);
+}
+
+/**
+ * asynchronous operation state machine, it runs on SPI event context when each SPI transfer is done
+ */
+static void async_event(void *context, sfud_err result) {
+    sfud_flash *flash = (sfud_flash *)context;
+    sfud_async *async = &flash->async;
+    uint8_t cmd_size;
+
+    if (result != SFUD_SUCCESS) {
+        async_finish(flash, result);
+        return;
+    }
+
+    switch (async->state) {
+    case ASYNC_READ_WAIT_READY:
+    case ASYNC_WRITE_WAIT_READY:
+    case ASYNC_WRITE_WAIT_BUSY:
+        /* the last status byte is the newest */
+        if (async->status[sizeof(async->status) - 1] & SFUD_STATUS_REGISTER_BUSY) {
+            if (async->poll_times == 0) {
+                result = SFUD_ERR_TIMEOUT;
+            } else {
+                async->poll_times--;
+                result = async_poll_status(flash, async->state);
+            }
+        } else if (async->state == ASYNC_READ_WAIT_READY) {
+            async->cmd_data[0] = SFUD_CMD_READ_DATA;
+            make_adress_byte_array(flash, async->addr, &async->cmd_data[1]);
+            cmd_size = flash->addr_in_4_byte ? 5 : 4;
+            result = async_start(flash, ASYNC_READ_DATA, async->cmd_data, cmd_size, async->read_buf, async->size);
+        } else if (async->size == 0) {
+            async->cmd_data[0] = SFUD_CMD_WRITE_DISABLE;
+            result = async_start(flash, ASYNC_WRITE_DISABLE, async->cmd_data, 1, NULL, 0);
+        } else {
+            async->cmd_data[0] = SFUD_CMD_WRITE_ENABLE;
+            result = async_start(flash, ASYNC_WRITE_ENABLE, async->cmd_data, 1, NULL, 0);
+        }
+        break;
+    case ASYNC_WRITE_ENABLE:
+        result = async_page_program(flash);
+        break;
+    case ASYNC_WRITE_PROGRAM:
+        async->size -= async->data_size;
+        async->addr += async->data_size;
+        async->write_buf += async->data_size;
+        async->poll_times = SFUD_ASYNC_POLL_TIMES;
+        result = async_poll_status(flash, ASYNC_WRITE_WAIT_BUSY);
+        break;
+    case ASYNC_READ_DATA:
+    case ASYNC_WRITE_DISABLE:
+        async_finish(flash, SFUD_SUCCESS);
+        break;
+    default:
+        break;
+    }
+
+    if (result != SFUD_SUCCESS) {
+        async_finish(flash, result);
+    }
+}
+
+/**
+ * check and prepare the asynchronous operation
+ */
+static sfud_err async_prepare(sfud_flash *flash, uint32_t addr, size_t size, sfud_async_done_cb done,
+        void *context) {
+    SFUD_ASSERT(flash);
+    /* must be call this function after initialize OK */
+    SFUD_ASSERT(flash->init_ok);
+    /* port must support asynchronous transfer and SPI lock */
+    SFUD_ASSERT(flash->spi.wr_async);
+    SFUD_ASSERT(flash->spi.try_lock);
+    SFUD_ASSERT(flash->spi.unlock);
+    /* check the flash address bound */
+    if (addr + size > flash->chip.capacity) {
+        SFUD_INFO("Error: Flash address is out of bound.");
+        return SFUD_ERR_ADDR_OUT_OF_BOUND;
+    }
+    /* SPI is locked until the operation is finished, so the commands of other operations can't be sent between its
+     * commands, and the operation can't be started twice */
+    if (!flash->spi.try_lock(&flash->spi)) {
+        return SFUD_ERR_BUSY;
+    }
+    SFUD_ASSERT(flash->async.state == ASYNC_IDLE);
+#ifdef SFUD_USING_ERASE_SCHED
+    /* the asynchronous operation can't wait for the queued erases */
+    if (sfud_erase_sched_is_busy(flash)) {
+        flash->spi.unlock(&flash->spi);
+        return SFUD_ERR_BUSY;
+    }
+#endif
+
+    flash->async.addr = addr;
+    flash->async.size = size;
+    flash->async.done = done;
+    flash->async.context = context;
+    flash->async.poll_times = SFUD_ASYNC_POLL_TIMES;
+
+    return SFUD_SUCCESS;
+}
+
+/**
+ * read flash data asynchronously
+ *
+ * @param flash flash device
+ * @param addr start address
+ * @param size read size
+ * @param data read data pointer
+ * @param done done callback, it will be called on SPI event context
+ * @param context user context of done callback
+ *
+ * @return result of operation start
+ */
+sfud_err sfud_read_async(sfud_flash *flash, uint32_t addr, size_t size, uint8_t *data, sfud_async_done_cb done,
+        void *context) {
+    sfud_err result = SFUD_SUCCESS;
+
+    SFUD_ASSERT(data);
+
+    result = async_prepare(flash, addr, size, done, context);
+    if (result == SFUD_SUCCESS) {
+        flash->async.read_buf = data;
+        result = async_poll_status(flash, ASYNC_READ_WAIT_READY);
+        if (result != SFUD_SUCCESS) {
+            flash->async.state = ASYNC_IDLE;
+            flash->spi.unlock(&flash->spi);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * write flash data (no erase operate) asynchronously
+ *
+ * @param flash flash device
+ * @param addr start address
+ * @param size write size
+ * @param data write data
+ * @param done done callback, it will be called on SPI event context
+ * @param context user context of done callback
+ *
+ * @return result of operation start
+ */
+sfud_err sfud_write_async(sfud_flash *flash, uint32_t addr, size_t size, const uint8_t *data,
+        sfud_async_done_cb done, void *context) {
+    sfud_err result = SFUD_SUCCESS;
+
+    SFUD_ASSERT(data);
+
+    /* port must support asynchronous header and payload transfer */
+    SFUD_ASSERT(flash->spi.wr_sg_async);
+    if (!(flash->chip.write_mode & SFUD_WM_PAGE_256B)) {
+        SFUD_INFO("Error: Flash asynchronous write only support 256 bytes page write mode.");
+        return SFUD_ERR_NOT_FOUND;
+    }
+
+    result = async_prepare(flash, addr, size, done, context);
+    if (result == SFUD_SUCCESS) {
+        flash->async.write_buf = data;
+        result = async_poll_status(flash, ASYNC_WRITE_WAIT_READY);
+        if (result != SFUD_SUCCESS) {
+            flash->async.state = ASYNC_IDLE;
+            flash->spi.unlock(&flash->spi);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * check whether there is an asynchronous operation in progress on the flash device
+ *
+ * @param flash flash device
+ *
+ * @return true: in progress
+ */
+bool sfud_async_is_busy(const sfud_flash *flash) {
+    SFUD_ASSERT(flash);
+
+    return flash->async.state != ASYNC_IDLE;
+}
+#endif /* SFUD_USING_ASYNC */
+
+#ifdef SFUD_USING_ERASE_SCHED
+/**
+ * erase scheduler state
+ */
+enum {
+    ERASE_SCHED_IDLE = 0,                        /**< no queued erase */
+    ERASE_SCHED_ERASING,                         /**< erase is queued or in progress */
+    ERASE_SCHED_SUSPENDED,                       /**< erase in progress is suspended for the read */
+};
+
+/**
+ * the scheduler state is run time data of the flash device, it is changed by the const flash operations too
+ */
+static sfud_erase_sched *get_erase_sched(const sfud_flash *flash) {
+    return (sfud_erase_sched *)&flash->erase_sched;
+}
+
+/**
+ * find the erase suspend and resume commands by SFDP, then by SFUD_FLASH_SUSPEND_INFO_TABLE
+ */
+static void erase_sched_init(sfud_flash *flash) {
+    sfud_erase_sched *sched = &flash->erase_sched;
+    size_t i;
+
+    sched->state = ERASE_SCHED_IDLE;
+    sched->head = 0;
+    sched->count = 0;
+    sched->erase_size = 0;
+    memset(&sched->suspend, 0, sizeof(sched->suspend));
+    memset(&sched->stat, 0, sizeof(sched->stat));
+
+#ifdef SFUD_USING_SFDP
+    if (flash->sfdp.available && flash->sfdp.erase_suspend.suspend_cmd) {
+        sched->suspend = flash->sfdp.erase_suspend;
+    } else
+#endif
+    {
+        for (i = 0; i < sizeof(flash_suspend_info_table) / sizeof(sfud_flash_suspend_info); i++) {
+            if ((flash_suspend_info_table[i].mf_id == flash->chip.mf_id)
+                    && (flash_suspend_info_table[i].type_id == flash->chip.type_id)
+                    && (flash_suspend_info_table[i].capacity_id == flash->chip.capacity_id)) {
+                sched->suspend.suspend_cmd = flash_suspend_info_table[i].suspend_cmd;
+                sched->suspend.resume_cmd = flash_suspend_info_table[i].resume_cmd;
+                sched->suspend.suspend_latency_us = flash_suspend_info_table[i].suspend_latency_us;
+                sched->suspend.resume_interval_us = flash_suspend_info_table[i].resume_interval_us;
+                break;
+            }
+        }
+    }
+
+    if (sched->suspend.suspend_cmd) {
+        SFUD_DEBUG("Erase scheduler suspends erase by 0x%02X and resumes by 0x%02X.", sched->suspend.suspend_cmd,
+                sched->suspend.resume_cmd);
+    } else {
+        SFUD_DEBUG("Erase scheduler can't suspend erase, the read will wait for the sector erase in progress.");
+    }
+}
+
+/**
+ * send erase command of the first queued request
+ */
+static sfud_err erase_sched_start(const sfud_flash *flash) {
+    sfud_err result = SFUD_SUCCESS;
+    sfud_erase_sched *sched = get_erase_sched(flash);
+    uint32_t addr = sched->queue[sched->head].addr;
+    size_t size = sched->queue[sched->head].size, erase_size;
+    uint8_t cmd_data[5], cmd_size, cmd;
+
+    if (sched->suspend.suspend_cmd) {
+        get_eraser(flash, addr, size, &cmd, &erase_size);
+    } else {
+        /* the read waits for the whole erase when it can't be suspended, so erase by the smallest granularity */
+        cmd = flash->chip.erase_gran_cmd;
+        erase_size = flash->chip.erase_gran;
+    }
+
+    result = set_write_enabled(flash, true);
+    if (result != SFUD_SUCCESS) {
+        return result;
+    }
+    cmd_data[0] = cmd;
+    make_adress_byte_array(flash, addr, &cmd_data[1]);
+    cmd_size = flash->addr_in_4_byte ? 5 : 4;
+    result = flash->spi.wr(&flash->spi, cmd_data, cmd_size, NULL, 0);
+    if (result != SFUD_SUCCESS) {
+        SFUD_INFO("Error: Flash erase SPI communicate error.");
+        set_write_enabled(flash, false);
+        return result;
+    }
+
+    sched->erase_addr = addr - addr % erase_size;
+    sched->erase_size = erase_size;
+    /* the erase must progress for the resume interval before it can be suspended, as the same as resume */
+    sched->resume_time_us = sched->get_time_us();
+
+    return result;
+}
+
+/**
+ * remove the finished sector or block from the first queued request
+ */
+static void erase_sched_advance(const sfud_flash *flash) {
+    sfud_erase_sched *sched = get_erase_sched(flash);
+    uint32_t *addr = &sched->queue[sched->head].addr, *size = &sched->queue[sched->head].size;
+    uint32_t erased = sched->erase_addr + sched->erase_size - *addr;
+
+    if (*size > erased) {
+        *size -= erased;
+        *addr += erased;
+    } else {
+        sched->head = (sched->head + 1) % SFUD_ERASE_SCHED_QUEUE_SIZE;
+        sched->count--;
+    }
+    sched->erase_size = 0;
+    sched->stat.erases++;
+    if (sched->count == 0) {
+        sched->state = ERASE_SCHED_IDLE;
+    }
+}
+
+/**
+ * run the erase scheduler once without waiting, the SPI must be locked
+ */
+static sfud_err erase_sched_run(const sfud_flash *flash) {
+    sfud_err result = SFUD_SUCCESS;
+    sfud_erase_sched *sched = get_erase_sched(flash);
+    uint8_t status;
+
+    if (sched->state == ERASE_SCHED_IDLE) {
+        return result;
+    }
+    if (sched->erase_size) {
+        result = sfud_read_status(flash, &status);
+        if (result != SFUD_SUCCESS || (status & SFUD_STATUS_REGISTER_BUSY)) {
+            return result;
+        }
+        erase_sched_advance(flash);
+    }
+    if (sched->count) {
+        result = erase_sched_start(flash);
+    }
+
+    return result;
+}
+
+/**
+ * wait for all of the queued erases, the SPI must be locked
+ */
+static sfud_err erase_sched_wait(const sfud_flash *flash) {
+    sfud_err result = SFUD_SUCCESS;
+    sfud_erase_sched *sched = get_erase_sched(flash);
+
+    if (sched->state != ERASE_SCHED_IDLE) {
+        sched->stat.flushes++;
+    }
+    while (sched->state != ERASE_SCHED_IDLE && result == SFUD_SUCCESS) {
+        if (sched->erase_size) {
+            result = wait_busy(flash);
+        }
+        if (result == SFUD_SUCCESS) {
+            result = erase_sched_run(flash);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * wait for all of the queued erases before the other write or erase, so they are done in order
+ */
+static sfud_err erase_sched_sync(const sfud_flash *flash) {
+    sfud_err result = SFUD_SUCCESS;
+    const sfud_spi *spi = &flash->spi;
+
+    if (get_erase_sched(flash)->state == ERASE_SCHED_IDLE) {
+        return result;
+    }
+    /* lock SPI */
+    if (spi->lock) {
+        spi->lock(spi);
+    }
+    result = erase_sched_wait(flash);
+    /* unlock SPI */
+    if (spi->unlock) {
+        spi->unlock(spi);
+    }
+
+    return result;
+}
+
+/**
+ * check whether the read range is queued or in progress to erase
+ */
+static bool erase_sched_is_pending(const sfud_flash *flash, uint32_t addr, size_t size) {
+    sfud_erase_sched *sched = get_erase_sched(flash);
+    uint8_t i, index;
+
+    if (sched->erase_size && addr < sched->erase_addr + sched->erase_size && sched->erase_addr < addr + size) {
+        return true;
+    }
+    for (i = 0; i < sched->count; i++) {
+        index = (sched->head + i) % SFUD_ERASE_SCHED_QUEUE_SIZE;
+        if (addr < sched->queue[index].addr + sched->queue[index].size && sched->queue[index].addr < addr + size) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Prepare the read while an erase is queued, the SPI must be locked. The erase in progress is suspended when the flash
+ * supports it, otherwise the read waits for it. The read of an erasing range waits for all of the queued erases.
+ */
+static sfud_err erase_sched_read_begin(const sfud_flash *flash, uint32_t addr, size_t size) {
+    sfud_err result = SFUD_SUCCESS;
+    sfud_erase_sched *sched = get_erase_sched(flash);
+    uint32_t suspend_time;
+    uint8_t status, cmd;
+
+    sched->read_timed = sched->state != ERASE_SCHED_IDLE;
+    if (!sched->read_timed) {
+        return wait_busy(flash);
+    }
+    sched->read_start_us = sched->get_time_us();
+
+    if (erase_sched_is_pending(flash, addr, size)) {
+        return erase_sched_wait(flash);
+    }
+    if (sched->erase_size == 0 || sched->suspend.suspend_cmd == 0) {
+        return wait_busy(flash);
+    }
+
+    /* keep the erase running for the resume interval, no suspend is needed if it is finished during this time */
+    do {
+        result = sfud_read_status(flash, &status);
+        if (result != SFUD_SUCCESS || (status & SFUD_STATUS_REGISTER_BUSY) == 0) {
+            return result;
+        }
+    } while (sched->get_time_us() - sched->resume_time_us < sched->suspend.resume_interval_us);
+
+    cmd = sched->suspend.suspend_cmd;
+    result = flash->spi.wr(&flash->spi, &cmd, 1, NULL, 0);
+    if (result != SFUD_SUCCESS) {
+        return result;
+    }
+    sched->state = ERASE_SCHED_SUSPENDED;
+    sched->stat.suspends++;
+    /* the suspend latency is tens of microseconds, so poll without retry delay */
+    suspend_time = sched->get_time_us();
+    do {
+        result = sfud_read_status(flash, &status);
+        if (result == SFUD_SUCCESS && (status & SFUD_STATUS_REGISTER_BUSY) == 0) {
+            break;
+        }
+    } while (sched->get_time_us() - suspend_time <= sched->suspend.suspend_latency_us);
+    suspend_time = sched->get_time_us() - suspend_time;
+    if (suspend_time > sched->stat.max_suspend_latency_us) {
+        sched->stat.max_suspend_latency_us = suspend_time;
+    }
+    if (result != SFUD_SUCCESS || (status & SFUD_STATUS_REGISTER_BUSY)) {
+        SFUD_INFO("Warning: Flash erase suspend is timeout, wait for the erase.");
+        result = wait_busy(flash);
+    }
+
+    return result;
+}
+
+/**
+ * resume the erase which is suspended by the read, and count the read latency, the SPI must be locked
+ */
+static sfud_err erase_sched_read_end(const sfud_flash *flash) {
+    sfud_err result = SFUD_SUCCESS;
+    sfud_erase_sched *sched = get_erase_sched(flash);
+    uint32_t latency;
+    uint8_t cmd;
+
+    if (sched->state == ERASE_SCHED_SUSPENDED) {
+        cmd = sched->suspend.resume_cmd;
+        result = flash->spi.wr(&flash->spi, &cmd, 1, NULL, 0);
+        sched->resume_time_us = sched->get_time_us();
+        sched->state = ERASE_SCHED_ERASING;
+    }
+    if (sched->read_timed) {
+        latency = sched->get_time_us() - sched->read_start_us;
+        sched->stat.reads++;
+        sched->stat.total_read_latency_us += latency;
+        if (latency > sched->stat.max_read_latency_us) {
+            sched->stat.max_read_latency_us = latency;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * queue an erase on the background erase scheduler, it is erased by sfud_erase_sched_poll()
+ *
+ * @note It will erase align by erase granularity. sfud_read() suspends the erase in progress when the flash supports
+ *       erase suspend, sfud_write() and sfud_erase() wait for all of the queued erases.
+ *
+ * @param flash flash device
+ * @param addr start address
+ * @param size erase size
+ *
+ * @return result, SFUD_ERR_BUSY: the queue is full
+ */
+sfud_err sfud_erase_sched_submit(sfud_flash *flash, uint32_t addr, size_t size) {
+    sfud_erase_sched *sched = &flash->erase_sched;
+    uint8_t index;
+
+    SFUD_ASSERT(flash);
+    /* must be call this function after initialize OK */
+    SFUD_ASSERT(flash->init_ok);
+    /* port must support microsecond clock */
+    SFUD_ASSERT(sched->get_time_us);
+    /* check the flash address bound */
+    if (addr + size > flash->chip.capacity) {
+        SFUD_INFO("Error: Flash address is out of bound.");
+        return SFUD_ERR_ADDR_OUT_OF_BOUND;
+    }
+    if (size == 0) {
+        return SFUD_SUCCESS;
+    }
+    if (sched->count >= SFUD_ERASE_SCHED_QUEUE_SIZE) {
+        return SFUD_ERR_BUSY;
+    }
+
+    index = (sched->head + sched->count) % SFUD_ERASE_SCHED_QUEUE_SIZE;
+    sched->queue[index].addr = addr;
+    sched->queue[index].size = size;
+    sched->count++;
+    if (sched->state == ERASE_SCHED_IDLE) {
+        sched->state = ERASE_SCHED_ERASING;
+    }
+
+    return sfud_erase_sched_poll(flash);
+}
+
+/**
+ * run the erase scheduler without waiting, it should be called periodically, e.g. on main loop
+ *
+ * @param flash flash device
+ *
+ * @return result
+ */
+sfud_err sfud_erase_sched_poll(sfud_flash *flash) {
+    sfud_err result = SFUD_SUCCESS;
+    const sfud_spi *spi = &flash->spi;
+
+    SFUD_ASSERT(flash);
+
+#ifdef SFUD_USING_ASYNC
+    /* the asynchronous operation owns the flash until it is done */
+    if (sfud_async_is_busy(flash)) {
+        return result;
+    }
+#endif
+    /* lock SPI */
+    if (spi->lock) {
+        spi->lock(spi);
+    }
+    result = erase_sched_run(flash);
+    /* unlock SPI */
+    if (spi->unlock) {
+        spi->unlock(spi);
+    }
+
+    return result;
+}
+
+/**
+ * wait for all of the queued erases to finish
+ *
+ * @param flash flash device
+ *
+ * @return result
+ */
+sfud_err sfud_erase_sched_flush(sfud_flash *flash) {
+    SFUD_ASSERT(flash);
+
+    return erase_sched_sync(flash);
+}
+
+/**
+ * check whether there is a queued erase on the flash device
+ *
+ * @param flash flash device
+ *
+ * @return true: erase is queued or in progress
+ */
+bool sfud_erase_sched_is_busy(const sfud_flash *flash) {
+    SFUD_ASSERT(flash);
+
+    return flash->erase_sched.state != ERASE_SCHED_IDLE;
+}
+
+/**
+ * get the erase scheduler statistics
+ *
+ * @param flash flash device
+ *
+ * @return statistics
+ */
+const sfud_erase_sched_stat *sfud_erase_sched_get_stat(const sfud_flash *flash) {
+    SFUD_ASSERT(flash);
+
+    return &flash->erase_sched.stat;
+}
+
+/**
+ * clear the erase scheduler statistics
+ *
+ * @param flash flash device
+ */
+void sfud_erase_sched_clear_stat(sfud_flash *flash) {
+    SFUD_ASSERT(flash);
+
+    memset(&flash->erase_sched.stat, 0, sizeof(flash->erase_sched.stat));
+}
+#endif /* SFUD_USING_ERASE_SCHED */
+
 static sfud_err reset(const sfud_flash *flash) {
     sfud_err result = SFUD_SUCCESS;
     const sfud_spi *spi = &flash->spi;
@@ -31,6 +31,7 @@
  */
 
 #include "sfud.h"
+#include <string.h>
 
 /**
  * JEDEC Standard JESD216 Terms and definitions:
@@ -48,6 +49,8 @@
 #define SUPPORT_MAX_SFDP_MAJOR_REV                  1
 /* the JEDEC basic flash parameter table length is 9 DWORDs (288-bit) on JESD216 (V1.0) initial release standard */
 #define BASIC_TABLE_LEN                             9
+/* the JEDEC basic flash parameter table length is 16 DWORDs on JESD216A (V1.5) and later */
+#define BASIC_TABLE_MAX_LEN                         16
 /* the smallest eraser in SFDP eraser table */
 #define SMALLEST_ERASER_INDEX                       0
 /**
@@ -190,20 +193,22 @@ static bool read_basic_table(sfud_flash *flash, sfdp_para_header *basic_header)
     /* parameter table address */
     uint32_t table_addr = basic_header->ptp;
     /* parameter table */
-    uint8_t table[BASIC_TABLE_LEN * 4] = { 0 }, i, j;
+    uint8_t table[BASIC_TABLE_MAX_LEN * 4] = { 0 }, i, j;
+    /* the DWORDs after the table length are kept 0x00 */
+    uint8_t table_len = basic_header->len < BASIC_TABLE_MAX_LEN ? basic_header->len : BASIC_TABLE_MAX_LEN;
 
     SFUD_ASSERT(flash);
     SFUD_ASSERT(basic_header);
 
     /* read JEDEC basic flash parameter table */
-    if (read_sfdp_data(flash, table_addr, table, sizeof(table)) != SFUD_SUCCESS) {
+    if (read_sfdp_data(flash, table_addr, table, table_len * 4) != SFUD_SUCCESS) {
         SFUD_INFO("Warning: Can't read JEDEC basic flash parameter table.");
         return false;
     }
     /* print JEDEC basic flash parameter table info */
     SFUD_DEBUG("JEDEC basic flash parameter table info:");
     SFUD_DEBUG("MSB-LSB  3    2    1    0");
-    for (i = 0; i < BASIC_TABLE_LEN; i++) {
+    for (i = 0; i < table_len; i++) {
         SFUD_DEBUG("[%04d] 0x%02X 0x%02X 0x%02X 0x%02X", i + 1, table[i * 4 + 3], table[i * 4 + 2], table[i * 4 + 1],
                 table[i * 4]);
     }
@@ -287,6 +292,27 @@ static bool read_basic_table(sfud_flash *flash, sfdp_para_header *basic_header)
         SFUD_INFO("Error: Read address bytes error!");
         return false;
     }
+    /* get fast read modes which are supported, wait states and mode clocks are counted as dummy cycles */
+    memset(sfdp->fast_read, 0, sizeof(sfdp->fast_read));
+    if (table[2] & (0x01 << 0)) {
+        sfdp->fast_read[SFUD_SFDP_FAST_READ_1_1_2].cmd = table[13];
+        sfdp->fast_read[SFUD_SFDP_FAST_READ_1_1_2].dummy_cycles = (table[12] & 0x1F) + (table[12] >> 5);
+    }
+    if (table[2] & (0x01 << 4)) {
+        sfdp->fast_read[SFUD_SFDP_FAST_READ_1_2_2].cmd = table[15];
+        sfdp->fast_read[SFUD_SFDP_FAST_READ_1_2_2].dummy_cycles = (table[14] & 0x1F) + (table[14] >> 5);
+    }
+    if (table[2] & (0x01 << 6)) {
+        sfdp->fast_read[SFUD_SFDP_FAST_READ_1_1_4].cmd = table[11];
+        sfdp->fast_read[SFUD_SFDP_FAST_READ_1_1_4].dummy_cycles = (table[10] & 0x1F) + (table[10] >> 5);
+    }
+    if (table[2] & (0x01 << 5)) {
+        sfdp->fast_read[SFUD_SFDP_FAST_READ_1_4_4].cmd = table[9];
+        sfdp->fast_read[SFUD_SFDP_FAST_READ_1_4_4].dummy_cycles = (table[8] & 0x1F) + (table[8] >> 5);
+    }
+    SFUD_DEBUG("Fast read 1-1-2: 0x%02X, 1-2-2: 0x%02X, 1-1-4: 0x%02X, 1-4-4: 0x%02X. 0x00 is not supported.",
+            sfdp->fast_read[SFUD_SFDP_FAST_READ_1_1_2].cmd, sfdp->fast_read[SFUD_SFDP_FAST_READ_1_2_2].cmd,
+            sfdp->fast_read[SFUD_SFDP_FAST_READ_1_1_4].cmd, sfdp->fast_read[SFUD_SFDP_FAST_READ_1_4_4].cmd);
     /* get flash memory capacity */
     uint32_t table2_temp = ((long)table[7] << 24) | ((long)table[6] << 16) | ((long)table[5] << 8) | (long)table[4];
     switch ((table[7] & (0x01 << 7)) >> 7) {
@@ -330,6 +356,19 @@ static bool read_basic_table(sfud_flash *flash, sfdp_para_header *basic_header)
             }
         }
     }
+    /* get erase suspend and resume from DWORD12 and DWORD13, bit 31 of DWORD12 is 0 when they are supported */
+    memset(&sfdp->erase_suspend, 0, sizeof(sfdp->erase_suspend));
+    if (table_len >= 13 && !(table[47] & (0x01 << 7))) {
+        /* suspend latency units are 128 ns, 1 us, 8 us and 64 us */
+        static const uint8_t latency_unit_shift[] = { 0, 0, 3, 6 };
+        sfdp->erase_suspend.suspend_cmd = table[51];
+        sfdp->erase_suspend.resume_cmd = table[50];
+        sfdp->erase_suspend.suspend_latency_us = ((table[47] & 0x1F) + 1) << latency_unit_shift[(table[47] >> 5) & 0x03];
+        sfdp->erase_suspend.resume_interval_us = ((table[46] >> 4) + 1) * 64;
+        SFUD_DEBUG("Erase suspend command is 0x%02X, resume command is 0x%02X. Latency is %dus, interval is %dus.",
+                sfdp->erase_suspend.suspend_cmd, sfdp->erase_suspend.resume_cmd,
+                sfdp->erase_suspend.suspend_latency_us, sfdp->erase_suspend.resume_interval_us);
+    }
 
     sfdp->available = true;
     return true;